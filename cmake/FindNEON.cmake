@@ -0,0 +1,14 @@
+# Autodetect if NEON can be used. It is only used on AArch64, where every CPU
+# has it, so the blitters using it need no runtime detection.
+
+include(CheckCXXSourceCompiles)
+set(CMAKE_REQUIRED_FLAGS "")
+
+check_cxx_source_compiles("
+    #include <arm_neon.h>
+    #if !defined(__aarch64__) && !defined(_M_ARM64)
+    #error NEON is only used on AArch64
+    #endif
+    int main() { return vmaxvq_u16(vdupq_n_u16(0)); }"
+    NEON_FOUND
+)
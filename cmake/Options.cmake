@@ -66,6 +66,10 @@ function(set_options)
         set(OPTION_TOOLS_ONLY ON PARENT_SCOPE)
     endif()
 
+    set(OPTION_TILE_LAYOUT "LINEAR" CACHE STRING "Memory layout of the map array: LINEAR, BLOCKED (64x64 blocks) or MORTON (Z-order)")
+    set_property(CACHE OPTION_TILE_LAYOUT PROPERTY STRINGS LINEAR BLOCKED MORTON)
+    option(OPTION_MERGED_TILE_STORAGE "Store the base and extended data of a tile next to each other in one array" OFF)
+
     option(OPTION_SURVEY_KEY "Survey-key to use for the opt-in survey (empty if you have none)" "")
 endfunction()
 
@@ -79,6 +83,8 @@ function(show_options)
     message(STATUS "Option Install FHS - ${OPTION_INSTALL_FHS}")
     message(STATUS "Option Use assert - ${OPTION_USE_ASSERTS}")
     message(STATUS "Option Use NSIS - ${OPTION_USE_NSIS}")
+    message(STATUS "Option Tile Layout - ${OPTION_TILE_LAYOUT}")
+    message(STATUS "Option Merged Tile Storage - ${OPTION_MERGED_TILE_STORAGE}")
 
     if(OPTION_SURVEY_KEY)
         message(STATUS "Option Survey Key - USED")
@@ -107,6 +113,18 @@ function(add_definitions_based_on_options)
         add_definitions(-DNDEBUG)
     endif()
 
+    if(OPTION_TILE_LAYOUT STREQUAL "BLOCKED")
+        add_definitions(-DWITH_TILE_LAYOUT_BLOCKED)
+    elseif(OPTION_TILE_LAYOUT STREQUAL "MORTON")
+        add_definitions(-DWITH_TILE_LAYOUT_MORTON)
+    elseif(NOT OPTION_TILE_LAYOUT STREQUAL "LINEAR")
+        message(FATAL_ERROR "Unknown OPTION_TILE_LAYOUT '${OPTION_TILE_LAYOUT}'; use LINEAR, BLOCKED or MORTON")
+    endif()
+
+    if(OPTION_MERGED_TILE_STORAGE)
+        add_definitions(-DWITH_MERGED_TILE_STORAGE)
+    endif()
+
     if(OPTION_SURVEY_KEY)
         add_definitions(-DSURVEY_KEY="${OPTION_SURVEY_KEY}")
     endif()
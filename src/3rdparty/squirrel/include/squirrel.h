@@ -170,6 +170,7 @@ typedef struct tagSQStackInfos{
 }SQStackInfos;
 
 typedef struct SQVM* HSQUIRRELVM;
+typedef void (*SQPROFILEHOOK)(HSQUIRRELVM);
 typedef SQObject HSQOBJECT;
 typedef SQInteger (*SQFUNCTION)(HSQUIRRELVM);
 typedef SQInteger (*SQRELEASEHOOK)(SQUserPointer,SQInteger size);
@@ -211,6 +212,7 @@ bool sq_resumeerror(HSQUIRRELVM v);
 SQRESULT sq_wakeupvm(HSQUIRRELVM v,SQBool resumedret,SQBool retval,SQBool raiseerror,SQBool throwerror);
 SQInteger sq_getvmstate(HSQUIRRELVM v);
 void sq_decreaseops(HSQUIRRELVM v, int amount);
+void sq_setprofilehook(HSQUIRRELVM v, SQPROFILEHOOK hook, SQInteger interval);
 
 /*compiler*/
 SQRESULT sq_compile(HSQUIRRELVM v,SQLEXREADFUNC read,SQUserPointer p,const SQChar *sourcename,SQBool raiseerror);
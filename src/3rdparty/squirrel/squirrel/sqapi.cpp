@@ -101,6 +101,14 @@ void sq_decreaseops(HSQUIRRELVM v, int amount)
 	v->DecreaseOps(amount);
 }
 
+/* Call hook every interval executed instructions; a nullptr hook stops calling it. */
+void sq_setprofilehook(HSQUIRRELVM v, SQPROFILEHOOK hook, SQInteger interval)
+{
+	v->_profile_hook = hook;
+	v->_profile_interval = interval;
+	v->_profile_countdown = interval;
+}
+
 bool sq_can_suspend(HSQUIRRELVM v)
 {
 	return v->_nnativecalls <= 2;
@@ -118,6 +118,9 @@ SQVM::SQVM(SQSharedState *ss)
 	_ops_till_suspend = 0;
 	_ops_till_suspend_error_threshold = INT64_MIN;
 	_ops_till_suspend_error_label = nullptr;
+	_profile_hook = nullptr;
+	_profile_interval = 0;
+	_profile_countdown = 0;
 	_callsstack = nullptr;
 	_callsstacksize = 0;
 	_alloccallsstacksize = 0;
@@ -745,6 +748,10 @@ exception_restore:
 		for(;;)
 		{
 			DecreaseOps(1);
+			if (_profile_hook != nullptr && --_profile_countdown <= 0) {
+				_profile_countdown = _profile_interval;
+				_profile_hook(this);
+			}
 			if (ShouldSuspend()) { _suspended = SQTrue; _suspended_traps = traps; return true; }
 			if (IsOpsTillSuspendError()) {
 				Raise_Error(fmt::format("excessive CPU usage in {}", _ops_till_suspend_error_label));
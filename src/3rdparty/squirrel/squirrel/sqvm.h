@@ -172,6 +172,10 @@ public:
 	const char *_ops_till_suspend_error_label;
 	SQBool _in_stackoverflow;
 
+	SQPROFILEHOOK _profile_hook;
+	SQInteger _profile_interval;
+	SQInteger _profile_countdown;
+
 	bool ShouldSuspend()
 	{
 		return _can_suspend && _ops_till_suspend <= 0;
@@ -105,6 +105,11 @@ public:
 	 */
 	static void BroadcastNewEvent(ScriptEvent *event, CompanyID skip_company = MAX_COMPANIES);
 
+	/**
+	 * Call the Save function of an AI, before saving the game.
+	 */
+	static void PrepareSave(CompanyID company);
+
 	/**
 	 * Save data from an AI to a savegame.
 	 */
@@ -62,8 +62,7 @@
 	assert(c->ai_instance == nullptr);
 	c->ai_instance = new AIInstance();
 	c->ai_instance->Initialize(info);
-	c->ai_instance->LoadOnStack(config->GetToLoadData());
-	config->SetToLoadData(nullptr);
+	c->ai_instance->SetLoadData(config->TakeToLoadData());
 
 	cur_company.Restore();
 
@@ -76,20 +75,25 @@
 	/* If we are in networking, only servers run this function, and that only if it is allowed */
 	if (_networking && (!_network_server || !_settings_game.ai.ai_in_multiplayer)) return;
 
-	/* The speed with which AIs go, is limited by the 'competitor_speed' */
+	/* The speed with which AIs go, is limited by the 'competitor_speed'.
+	 * Every AI gets its own tick within that interval, so with many AIs
+	 * they do not all run in the same tick. */
 	AI::frame_counter++;
 	assert(_settings_game.difficulty.competitor_speed <= 4);
-	if ((AI::frame_counter & ((1 << (4 - _settings_game.difficulty.competitor_speed)) - 1)) != 0) return;
+	uint interval_mask = (1 << (4 - _settings_game.difficulty.competitor_speed)) - 1;
 
 	Backup<CompanyID> cur_company(_current_company);
 	for (const Company *c : Company::Iterate()) {
 		if (c->is_ai) {
+			uint frame = AI::frame_counter + c->index;
+			if ((frame & interval_mask) != 0) continue;
+
 			PerformanceMeasurer framerate((PerformanceElement)(PFE_AI0 + c->index));
 			cur_company.Change(c->index);
 			c->ai_instance->GameLoop();
 			/* Occasionally collect garbage; every 255 ticks do one company.
 			 * Effectively collecting garbage once every two months per AI. */
-			if ((AI::frame_counter & 255) == 0 && (CompanyID)GB(AI::frame_counter, 8, 4) == c->index) {
+			if ((frame & 255) == 0 && (CompanyID)GB(frame, 8, 4) == c->index) {
 				c->ai_instance->CollectGarbage();
 			}
 		} else {
@@ -285,6 +289,21 @@
 	event->Release();
 }
 
+/* static */ void AI::PrepareSave(CompanyID company)
+{
+	if (_networking && !_network_server) return;
+
+	Company *c = Company::GetIfValid(company);
+	assert(c != nullptr);
+
+	/* When doing emergency saving, an AI can be not fully initialised. */
+	if (c->ai_instance == nullptr) return;
+
+	Backup<CompanyID> cur_company(_current_company, company);
+	c->ai_instance->PrepareSave();
+	cur_company.Restore();
+}
+
 /* static */ void AI::Save(CompanyID company)
 {
 	if (!_networking || _network_server) {
@@ -293,9 +312,7 @@
 
 		/* When doing emergency saving, an AI can be not fully initialised. */
 		if (c->ai_instance != nullptr) {
-			Backup<CompanyID> cur_company(_current_company, company);
 			c->ai_instance->Save();
-			cur_company.Restore();
 			return;
 		}
 	}
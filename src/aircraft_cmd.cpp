@@ -39,6 +39,7 @@
 #include "disaster_vehicle.h"
 #include "newgrf_airporttiles.h"
 #include "framerate_type.h"
+#include "trace.h"
 #include "aircraft_cmd.h"
 #include "vehicle_cmd.h"
 
@@ -1823,8 +1824,9 @@ static bool AirportMove(Aircraft *v, const AirportFTAClass *apc)
 
 	v->previous_pos = v->pos; // save previous location
 
-	/* there is only one choice to move to */
-	if (current->next == nullptr) {
+	/* the only choice, or the choice that matches our heading, is precomputed */
+	current = apc->FindTransition(v->pos, v->state);
+	if (current != nullptr) {
 		if (AirportSetBlocks(v, current, apc)) {
 			v->pos = current->next_position;
 			UpdateAircraftCache(v);
@@ -1832,19 +1834,6 @@ static bool AirportMove(Aircraft *v, const AirportFTAClass *apc)
 		return false;
 	}
 
-	/* there are more choices to choose from, choose the one that
-	 * matches our heading */
-	do {
-		if (v->state == current->heading || current->heading == TO_ALL) {
-			if (AirportSetBlocks(v, current, apc)) {
-				v->pos = current->next_position;
-				UpdateAircraftCache(v);
-			} // move to next position
-			return false;
-		}
-		current = current->next;
-	} while (current != nullptr);
-
 	Debug(misc, 0, "[Ap] cannot move further on Airport! (pos {} state {}) for vehicle {}", v->pos, v->state, v->index);
 	NOT_REACHED();
 }
@@ -1884,22 +1873,12 @@ static bool AirportHasBlock(Aircraft *v, const AirportFTA *current_pos, const Ai
 static bool AirportSetBlocks(Aircraft *v, const AirportFTA *current_pos, const AirportFTAClass *apc)
 {
 	const AirportFTA *next = &apc->layout[current_pos->next_position];
-	const AirportFTA *reference = &apc->layout[v->pos];
 
 	/* if the next position is in another block, check it and wait until it is free */
 	if ((apc->layout[current_pos->position].block & next->block) != next->block) {
-		uint64_t airport_flags = next->block;
-		/* search for all all elements in the list with the same state, and blocks != N
-		 * this means more blocks should be checked/set */
-		const AirportFTA *current = current_pos;
-		if (current == reference) current = current->next;
-		while (current != nullptr) {
-			if (current->heading == current_pos->heading && current->block != 0) {
-				airport_flags |= current->block;
-				break;
-			}
-			current = current->next;
-		}
+		/* the first element in the list with the same state, and blocks != N,
+		 * means more blocks should be checked/set */
+		uint64_t airport_flags = next->block | current_pos->extra_block;
 
 		/* if the block to be checked is in the next position, then exclude that from
 		 * checking, because it has been set by the airplane before */
@@ -2118,6 +2097,8 @@ bool Aircraft::Tick()
 	if (!this->IsNormalAircraft()) return true;
 
 	PerformanceAccumulator framerate(PFE_GL_AIRCRAFT);
+	TraceScope trace("Aircraft tick", this->index);
+	CompanyPerformanceMeasurer company_framerate(CPE_VEHICLES, this->owner);
 
 	this->tick_counter++;
 
@@ -127,6 +127,57 @@ AirportFTAClass::AirportFTAClass(
 {
 	/* Build the state machine itself */
 	this->layout = AirportBuildAutomata(this->nofelements, apFA);
+
+	/* Determine the movement for every position and state once, instead of walking the list of movements each time. */
+	this->transitions.resize(this->nofelements * (MAX_HEADINGS + 1));
+	for (uint i = 0; i < this->nofelements; i++) {
+		AirportFTA *head = &this->layout[i];
+		for (uint state = 0; state <= MAX_HEADINGS; state++) {
+			const AirportFTA *transition = nullptr;
+			if (head->next == nullptr) {
+				/* There is only one choice to move to. */
+				transition = head;
+			} else {
+				for (const AirportFTA *current = head; current != nullptr; current = current->next) {
+					if (current->heading == state || current->heading == TO_ALL) {
+						transition = current;
+						break;
+					}
+				}
+			}
+			this->transitions[i * (MAX_HEADINGS + 1) + state] = transition;
+		}
+
+		/* Search for the first movement with the same heading and a block, not counting the first movement itself. */
+		for (AirportFTA *current = head; current != nullptr; current = current->next) {
+			current->extra_block = 0;
+			for (const AirportFTA *other = (current == head) ? current->next : current; other != nullptr; other = other->next) {
+				if (other->heading == current->heading && other->block != 0) {
+					current->extra_block = other->block;
+					break;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Get the movement an aircraft takes from a position, given the state it is in.
+ * @param position The position of the aircraft.
+ * @param state The state of the aircraft.
+ * @return The movement, or \c nullptr when the aircraft cannot move further.
+ */
+const AirportFTA *AirportFTAClass::FindTransition(uint8_t position, uint8_t state) const
+{
+	assert(position < this->nofelements);
+	if (state <= MAX_HEADINGS) return this->transitions[position * (MAX_HEADINGS + 1) + state];
+
+	const AirportFTA *head = &this->layout[position];
+	if (head->next == nullptr) return head;
+	for (const AirportFTA *current = head; current != nullptr; current = current->next) {
+		if (current->heading == state || current->heading == TO_ALL) return current;
+	}
+	return nullptr;
 }
 
 AirportFTAClass::~AirportFTAClass()
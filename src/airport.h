@@ -173,8 +173,11 @@ public:
 		return &moving_data[position];
 	}
 
+	const struct AirportFTA *FindTransition(uint8_t position, uint8_t state) const;
+
 	const AirportMovingData *moving_data; ///< Movement data.
 	struct AirportFTA *layout;            ///< state machine for airport
+	std::vector<const struct AirportFTA *> transitions; ///< For every position and every state up to #MAX_HEADINGS, the movement to take, or \c nullptr when there is none.
 	const uint8_t *terminals;                ///< %Array with the number of terminal groups, followed by the number of terminals in each group.
 	const uint8_t num_helipads;              ///< Number of helipads on this airport. When 0 helicopters will go to normal terminals.
 	Flags flags;                          ///< Flags for this airport type.
@@ -190,6 +193,7 @@ DECLARE_ENUM_AS_BIT_SET(AirportFTAClass::Flags)
 struct AirportFTA {
 	AirportFTA *next;        ///< possible extra movement choices from this position
 	uint64_t block;            ///< 64 bit blocks (st->airport.flags), should be enough for the most complex airports
+	uint64_t extra_block;      ///< Additional block to reserve when moving along this movement, from a later movement of the same position with the same heading.
 	uint8_t position;           ///< the position that an airplane is at
 	uint8_t next_position;      ///< next position from this position
 	uint8_t heading;            ///< heading (current orders), guiding an airplane to its target on an airport
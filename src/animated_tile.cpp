@@ -18,12 +18,26 @@
 /** The table/list with animated tiles. */
 std::vector<TileIndex> _animated_tiles;
 
+static bool _animating_tiles = false;  ///< Whether #AnimateAnimatedTiles is going through the animated tiles.
+static size_t _animated_tile_current; ///< Position in #_animated_tiles of the tile being animated, when #_animating_tiles.
+
 /**
  * Removes the given tile from the animated tile table.
  * @param tile the tile to remove
  */
 void DeleteAnimatedTile(TileIndex tile)
 {
+	if (_animating_tiles) {
+		/* Usually a tile stops its own animation, so look at the tile being animated first. While animating,
+		 * a removed tile leaves a hole, so the positions of the other tiles do not change during the loop. */
+		auto to_remove = _animated_tiles[_animated_tile_current] == tile ? _animated_tiles.begin() + _animated_tile_current : std::find(_animated_tiles.begin(), _animated_tiles.end(), tile);
+		if (to_remove != _animated_tiles.end()) {
+			*to_remove = INVALID_TILE;
+			MarkTileDirtyByTile(tile);
+		}
+		return;
+	}
+
 	auto to_remove = std::find(_animated_tiles.begin(), _animated_tiles.end(), tile);
 	if (to_remove != _animated_tiles.end()) {
 		/* The order of the remaining elements must stay the same, otherwise the animation loop may miss a tile. */
@@ -50,21 +64,16 @@ void AnimateAnimatedTiles()
 {
 	PerformanceAccumulator framerate(PFE_GL_LANDSCAPE);
 
-	const TileIndex *ti = _animated_tiles.data();
-	while (ti < _animated_tiles.data() + _animated_tiles.size()) {
-		const TileIndex curr = *ti;
-		AnimateTile(curr);
-		/* During the AnimateTile call, DeleteAnimatedTile could have been called,
-		 * deleting an element we've already processed and pushing the rest one
-		 * slot to the left. We can detect this by checking whether the index
-		 * in the current slot has changed - if it has, an element has been deleted,
-		 * and we should process the current slot again instead of going forward.
-		 * NOTE: this will still break if more than one animated tile is being
-		 *       deleted during the same AnimateTile call, but no code seems to
-		 *       be doing this anyway.
-		 */
-		if (*ti == curr) ++ti;
+	/* Tiles added during the loop are animated in this tick as well, tiles removed during the loop leave a hole. */
+	_animating_tiles = true;
+	for (_animated_tile_current = 0; _animated_tile_current < _animated_tiles.size(); _animated_tile_current++) {
+		const TileIndex curr = _animated_tiles[_animated_tile_current];
+		if (curr != INVALID_TILE) AnimateTile(curr);
 	}
+	_animating_tiles = false;
+
+	/* Close the holes, keeping the order of the remaining tiles. */
+	_animated_tiles.erase(std::remove(_animated_tiles.begin(), _animated_tiles.end(), INVALID_TILE), _animated_tiles.end());
 }
 
 /**
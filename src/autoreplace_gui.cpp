@@ -113,27 +113,6 @@ class ReplaceVehicleWindow : public Window {
 		return true;
 	}
 
-	void AddChildren(const GUIEngineList &source, GUIEngineList &target, EngineID parent, int indent, int side)
-	{
-		for (const auto &item : source) {
-			if (item.variant_id != parent || item.engine_id == parent) continue;
-
-			const Engine *e = Engine::Get(item.engine_id);
-			EngineDisplayFlags flags = item.flags;
-			if (e->display_last_variant != INVALID_ENGINE) flags &= ~EngineDisplayFlags::Shaded;
-			target.emplace_back(e->display_last_variant == INVALID_ENGINE ? item.engine_id : e->display_last_variant, item.engine_id, flags, indent);
-
-			/* Add variants if not folded */
-			if ((item.flags & (EngineDisplayFlags::HasVariants | EngineDisplayFlags::IsFolded)) == EngineDisplayFlags::HasVariants) {
-				/* Add this engine again as a child */
-				if ((item.flags & EngineDisplayFlags::Shaded) == EngineDisplayFlags::None) {
-					target.emplace_back(item.engine_id, item.engine_id, EngineDisplayFlags::None, indent + 1);
-				}
-				AddChildren(source, target, item.engine_id, indent + 1, side);
-			}
-		}
-	}
-
 	/**
 	 * Generate an engines list
 	 * @param draw_left true if generating the left list, otherwise false
@@ -189,12 +168,7 @@ class ReplaceVehicleWindow : public Window {
 
 		if (side == 1) {
 			/* ensure primary engine of variant group is in list */
-			for (const auto &variant : variants) {
-				if (std::find(list.begin(), list.end(), variant) == list.end()) {
-					const Engine *e = Engine::Get(variant);
-					list.emplace_back(variant, e->info.variant_id, e->display_flags | EngineDisplayFlags::Shaded, 0);
-				}
-			}
+			EngList_AddMissingVariantParents(list, variants);
 		}
 
 		this->sel_engine[side] = selected_engine; // update which engine we selected (the same or none, if it's not in the list anymore)
@@ -207,7 +181,7 @@ class ReplaceVehicleWindow : public Window {
 
 		this->engines[side].clear();
 		if (side == 1) {
-			AddChildren(list, this->engines[side], INVALID_ENGINE, 0, side);
+			EngList_AddChildren(list, this->engines[side]);
 		} else {
 			this->engines[side].swap(list);
 		}
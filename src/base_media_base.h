@@ -97,6 +97,7 @@ struct BaseSet {
 	}
 
 	bool FillSetDetails(const IniFile &ini, const std::string &path, const std::string &full_filename, bool allow_empty_filename = true);
+	bool ValidateFiles();
 	void CopyCompatibleConfig([[maybe_unused]] const T &src) {}
 
 	/**
@@ -186,6 +187,20 @@ protected:
 	 * @return the extension
 	 */
 	static const char *GetExtension();
+
+	/**
+	 * Check the checksums of the files of a set, before it is used.
+	 * @param set The set to check.
+	 * @return True iff none of the files turned out to be invalid.
+	 */
+	static bool ValidateSet(const Tbase_set *set)
+	{
+		/* All sets are owned by the non-const lists of BaseMedia. */
+		return const_cast<Tbase_set *>(set)->ValidateFiles();
+	}
+
+	template <class Tprefer>
+	static const Tbase_set *FindBestSet(Tprefer prefer);
 public:
 	/**
 	 * Determine the graphics pack that has to be used.
@@ -208,6 +223,7 @@ public:
 	static bool SetSet(const Tbase_set *set);
 	static bool SetSetByName(const std::string &name);
 	static bool SetSetByShortname(uint32_t shortname);
+	static bool SetEmptySet();
 	static void GetSetsList(std::back_insert_iterator<std::string> &output_iterator);
 	static int GetNumSets();
 	static int GetIndexOfUsedSet();
@@ -92,6 +92,7 @@ bool BaseSet<T, Tnum_files, Tsearch_in_tars>::FillSetDetails(const IniFile &ini,
 		if (!item->value.has_value()) {
 			file->filename.clear();
 			/* If we list no file, that file must be valid */
+			file->check_result = MD5File::CR_MATCH;
 			this->valid_files++;
 			this->found_files++;
 			continue;
@@ -136,28 +137,84 @@ bool BaseSet<T, Tnum_files, Tsearch_in_tars>::FillSetDetails(const IniFile &ini,
 			file->missing_warning = item->value.value();
 		}
 
-		file->check_result = T::CheckMD5(file, BASESET_DIR);
-		switch (file->check_result) {
-			case MD5File::CR_UNKNOWN:
-				break;
+		/* Reading the files for their checksums waits until the set is about to be used, see ValidateFiles. */
+		if (FioCheckFileExists(file->filename, BASESET_DIR)) {
+			file->check_result = MD5File::CR_UNKNOWN;
+			this->valid_files++;
+			this->found_files++;
+		} else {
+			file->check_result = MD5File::CR_NO_FILE;
+			Debug(grf, 1, "The file {} specified in {} is missing", filename, full_filename);
+		}
+	}
+
+	return true;
+}
 
+/**
+ * Check the MD5 checksums of the files of this set that have not been checked yet.
+ * Until then, a file counts as valid when it exists.
+ * @return True iff none of the files turned out to be invalid.
+ */
+template <class T, size_t Tnum_files, bool Tsearch_in_tars>
+bool BaseSet<T, Tnum_files, Tsearch_in_tars>::ValidateFiles()
+{
+	bool all_valid = true;
+	for (MD5File &file : this->files) {
+		if (file.check_result != MD5File::CR_UNKNOWN) continue;
+
+		file.check_result = T::CheckMD5(&file, BASESET_DIR);
+		switch (file.check_result) {
+			case MD5File::CR_UNKNOWN:
 			case MD5File::CR_MATCH:
-				this->valid_files++;
-				this->found_files++;
 				break;
 
 			case MD5File::CR_MISMATCH:
-				Debug(grf, 1, "MD5 checksum mismatch for: {} (in {})", filename, full_filename);
-				this->found_files++;
+				Debug(grf, 1, "MD5 checksum mismatch for: {} (in {})", file.filename, this->name);
+				this->valid_files--;
+				all_valid = false;
 				break;
 
 			case MD5File::CR_NO_FILE:
-				Debug(grf, 1, "The file {} specified in {} is missing", filename, full_filename);
+				Debug(grf, 1, "The file {} of {} is missing", file.filename, this->name);
+				this->valid_files--;
+				this->found_files--;
+				all_valid = false;
 				break;
 		}
 	}
 
-	return true;
+	return all_valid;
+}
+
+/**
+ * Find the usable set with the most valid files. Only the checksums of the
+ * found set are checked, as checking all sets reads every file of every set.
+ * When the checksums turn out worse than assumed, the search is done again.
+ * @param prefer Whether the second set is preferred over the first, when both have the same number of valid files.
+ * @return The best set, or nullptr if there is no usable set.
+ */
+template <class Tbase_set>
+template <class Tprefer>
+/* static */ const Tbase_set *BaseMedia<Tbase_set>::FindBestSet(Tprefer prefer)
+{
+	const Tbase_set *best;
+	do {
+		best = nullptr;
+		for (const Tbase_set *c = BaseMedia<Tbase_set>::available_sets; c != nullptr; c = c->next) {
+			/* Skip unusable sets */
+			if (c->GetNumMissing() != 0) continue;
+
+			if (best == nullptr ||
+					(best->fallback && !c->fallback) ||
+					best->valid_files < c->valid_files ||
+					(best->valid_files == c->valid_files && prefer(best, c))) {
+				best = c;
+			}
+		}
+	} while (best != nullptr && !ValidateSet(best));
+
+	return best;
 }
 
 template <class Tbase_set>
@@ -187,6 +244,10 @@ bool BaseMedia<Tbase_set>::AddFile(const std::string &filename, size_t basepath_
 			}
 		}
 		if (duplicate != nullptr) {
+			/* Which one is more complete depends on the checksums. */
+			ValidateSet(duplicate);
+			ValidateSet(set);
+
 			/* The more complete set takes precedence over the version number. */
 			if ((duplicate->valid_files == set->valid_files && duplicate->version >= set->version) ||
 					duplicate->valid_files > set->valid_files) {
@@ -243,6 +304,7 @@ template <class Tbase_set>
 	if (set == nullptr) {
 		if (!BaseMedia<Tbase_set>::DetermineBestSet()) return false;
 	} else {
+		ValidateSet(set);
 		BaseMedia<Tbase_set>::used_set = set;
 	}
 	CheckExternalFiles();
@@ -289,6 +351,22 @@ template <class Tbase_set>
 	return false;
 }
 
+/**
+ * Use a fallback set that has no files at all, like the NoSound set.
+ * @return true if there is such a set.
+ */
+template <class Tbase_set>
+/* static */ bool BaseMedia<Tbase_set>::SetEmptySet()
+{
+	for (const Tbase_set *s = BaseMedia<Tbase_set>::available_sets; s != nullptr; s = s->next) {
+		if (s->fallback && std::all_of(std::begin(s->files), std::end(s->files), [](const MD5File &file) { return file.filename.empty(); })) {
+			BaseMedia<Tbase_set>::used_set = s;
+			return true;
+		}
+	}
+	return false;
+}
+
 /**
  * Returns a list with the sets.
  * @param output_iterator The iterator to write the string to.
@@ -418,6 +496,7 @@ template <class Tbase_set>
 	template bool repl_type::SetSet(const set_type *set); \
 	template bool repl_type::SetSetByName(const std::string &name); \
 	template bool repl_type::SetSetByShortname(uint32_t shortname); \
+	template bool repl_type::SetEmptySet(); \
 	template void repl_type::GetSetsList(std::back_insert_iterator<std::string> &output_iterator); \
 	template int repl_type::GetNumSets(); \
 	template int repl_type::GetIndexOfUsedSet(); \
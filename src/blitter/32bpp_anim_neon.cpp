@@ -0,0 +1,319 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file 32bpp_anim_neon.cpp Implementation of the NEON 32 bpp blitter with animation support. */
+
+#ifdef WITH_NEON
+
+#include "../stdafx.h"
+#include "../video/video_driver.hpp"
+#include "../palette_func.h"
+#include "32bpp_anim_neon.hpp"
+#include "32bpp_neon_func.hpp"
+
+#include "../safeguards.h"
+
+/** Instantiation of the NEON 32bpp blitter factory. */
+static FBlitter_32bppNEON_Anim iFBlitter_32bppNEON_Anim;
+
+/**
+ * Draws a sprite to a (screen) buffer. It is templated to allow faster operation.
+ * This is the same as Blitter_32bppAnim::Draw, but with the runs of pixels drawn by NEON.
+ *
+ * @tparam mode blitter mode
+ * @param bp further blitting parameters
+ * @param zoom zoom level at which we are drawing
+ */
+template <BlitterMode mode>
+inline void Blitter_32bppNEON_Anim::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
+{
+	const SpriteData *src = (const SpriteData *)bp->sprite;
+
+	const Colour *src_px = (const Colour *)(src->data + src->offset[zoom][0]);
+	const uint16_t *src_n  = (const uint16_t *)(src->data + src->offset[zoom][1]);
+
+	for (uint i = bp->skip_top; i != 0; i--) {
+		src_px = (const Colour *)((const uint8_t *)src_px + *(const uint32_t *)src_px);
+		src_n  = (const uint16_t *)((const uint8_t *)src_n  + *(const uint32_t *)src_n);
+	}
+
+	Colour *dst = (Colour *)bp->dst + bp->top * bp->pitch + bp->left;
+	uint16_t *anim = this->anim_buf + this->ScreenToAnimOffset((uint32_t *)bp->dst) + bp->top * this->anim_buf_pitch + bp->left;
+
+	const uint8_t *remap = bp->remap; // store so we don't have to access it via bp every time
+
+	for (int y = 0; y < bp->height; y++) {
+		Colour *dst_ln = dst + bp->pitch;
+		uint16_t *anim_ln = anim + this->anim_buf_pitch;
+
+		const Colour *src_px_ln = (const Colour *)((const uint8_t *)src_px + *(const uint32_t *)src_px);
+		src_px++;
+
+		const uint16_t *src_n_ln = (const uint16_t *)((const uint8_t *)src_n + *(const uint32_t *)src_n);
+		src_n += 2;
+
+		Colour *dst_end = dst + bp->skip_left;
+
+		uint n;
+
+		while (dst < dst_end) {
+			n = *src_n++;
+
+			if (src_px->a == 0) {
+				dst += n;
+				src_px ++;
+				src_n++;
+
+				if (dst > dst_end) anim += dst - dst_end;
+			} else {
+				if (dst + n > dst_end) {
+					uint d = dst_end - dst;
+					src_px += d;
+					src_n += d;
+
+					dst = dst_end - bp->skip_left;
+					dst_end = dst + bp->width;
+
+					n = std::min(n - d, (uint)bp->width);
+					goto draw;
+				}
+				dst += n;
+				src_px += n;
+				src_n += n;
+			}
+		}
+
+		dst -= bp->skip_left;
+		dst_end -= bp->skip_left;
+
+		dst_end += bp->width;
+
+		while (dst < dst_end) {
+			n = std::min<uint>(*src_n++, dst_end - dst);
+
+			if (src_px->a == 0) {
+				anim += n;
+				dst += n;
+				src_px++;
+				src_n++;
+				continue;
+			}
+
+			draw:;
+
+			switch (mode) {
+				case BM_COLOUR_REMAP: {
+					const bool opaque = src_px->a == 255;
+					while (n != 0) {
+						/* Blocks without remapped pixels are drawn like BM_NORMAL, and are not animated. */
+						if (n >= 8 && HasNoRemap(src_n)) {
+							if (opaque) {
+								CopyPixels(src_px, dst, 8);
+							} else {
+								AlphaBlendPixels(src_px, dst, 8);
+							}
+							std::fill_n(anim, 8, 0);
+							anim += 8;
+							dst += 8;
+							src_px += 8;
+							src_n += 8;
+							n -= 8;
+							continue;
+						}
+
+						uint count = std::min(n, 8U);
+						n -= count;
+						do {
+							uint m = *src_n;
+							if (m == 0) {
+								*dst = opaque ? src_px->data : ComposeColourRGBANoCheck(src_px->r, src_px->g, src_px->b, src_px->a, *dst);
+								*anim = 0;
+							} else {
+								uint r = remap[GB(m, 0, 8)];
+								if (opaque) {
+									*anim = r | (m & 0xFF00);
+									if (r != 0) *dst = this->AdjustBrightness(this->LookupColourInPalette(r), GB(m, 8, 8));
+								} else {
+									*anim = 0;
+									if (r != 0) *dst = ComposeColourPANoCheck(this->AdjustBrightness(this->LookupColourInPalette(r), GB(m, 8, 8)), src_px->a, *dst);
+								}
+							}
+							anim++;
+							dst++;
+							src_px++;
+							src_n++;
+						} while (--count != 0);
+					}
+					break;
+				}
+
+				case BM_CRASH_REMAP:
+					if (src_px->a == 255) {
+						do {
+							uint m = *src_n;
+							if (m == 0) {
+								uint8_t g = MakeDark(src_px->r, src_px->g, src_px->b);
+								*dst = ComposeColourRGBA(g, g, g, src_px->a, *dst);
+								*anim = 0;
+							} else {
+								uint r = remap[GB(m, 0, 8)];
+								*anim = r | (m & 0xFF00);
+								if (r != 0) *dst = this->AdjustBrightness(this->LookupColourInPalette(r), GB(m, 8, 8));
+							}
+							anim++;
+							dst++;
+							src_px++;
+							src_n++;
+						} while (--n != 0);
+					} else {
+						do {
+							uint m = *src_n;
+							if (m == 0) {
+								if (src_px->a != 0) {
+									uint8_t g = MakeDark(src_px->r, src_px->g, src_px->b);
+									*dst = ComposeColourRGBA(g, g, g, src_px->a, *dst);
+									*anim = 0;
+								}
+							} else {
+								uint r = remap[GB(m, 0, 8)];
+								*anim = 0;
+								if (r != 0) *dst = ComposeColourPANoCheck(this->AdjustBrightness(this->LookupColourInPalette(r), GB(m, 8, 8)), src_px->a, *dst);
+							}
+							anim++;
+							dst++;
+							src_px++;
+							src_n++;
+						} while (--n != 0);
+					}
+					break;
+
+				case BM_BLACK_REMAP:
+					std::fill_n(dst, n, Colour(0, 0, 0));
+					std::fill_n(anim, n, 0);
+					anim += n;
+					dst += n;
+					src_px += n;
+					src_n += n;
+					break;
+
+				case BM_TRANSPARENT:
+					/* Make the current colour a bit more black, so it looks like this image is transparent */
+					if (src_px->a == 255) {
+						DarkenPixels(dst, n);
+					} else {
+						DarkenPixels(src_px, dst, n);
+					}
+					std::fill_n(anim, n, 0);
+					anim += n;
+					dst += n;
+					src_px += n;
+					src_n += n;
+					break;
+
+				case BM_TRANSPARENT_REMAP:
+					/* Apply custom transparency remap. */
+					src_n += n;
+					src_px += n;
+					do {
+						*dst = this->LookupColourInPalette(remap[GetNearestColourIndex(*dst)]);
+						*anim = 0;
+						anim++;
+						dst++;
+					} while (--n != 0);
+					break;
+
+				default:
+					if (src_px->a == 255) {
+						/* The animation buffer gets the remap values, whether the colours are animated or not. */
+						std::copy_n(src_n, n, anim);
+						anim += n;
+						while (n != 0) {
+							if (n >= 8 && HasNoAnimation(src_n)) {
+								CopyPixels(src_px, dst, 8);
+								dst += 8;
+								src_px += 8;
+								src_n += 8;
+								n -= 8;
+								continue;
+							}
+
+							uint count = std::min(n, 8U);
+							n -= count;
+							do {
+								uint m = GB(*src_n, 0, 8);
+								/* Above PALETTE_ANIM_START is palette animation */
+								*dst++ = (m >= PALETTE_ANIM_START) ? this->AdjustBrightness(this->LookupColourInPalette(m), GB(*src_n, 8, 8)) : src_px->data;
+								src_px++;
+								src_n++;
+							} while (--count != 0);
+						}
+					} else {
+						std::fill_n(anim, n, 0);
+						anim += n;
+						while (n != 0) {
+							if (n >= 8 && HasNoAnimation(src_n)) {
+								AlphaBlendPixels(src_px, dst, 8);
+								dst += 8;
+								src_px += 8;
+								src_n += 8;
+								n -= 8;
+								continue;
+							}
+
+							uint count = std::min(n, 8U);
+							n -= count;
+							do {
+								uint m = GB(*src_n, 0, 8);
+								if (m >= PALETTE_ANIM_START) {
+									*dst = ComposeColourPANoCheck(this->AdjustBrightness(this->LookupColourInPalette(m), GB(*src_n, 8, 8)), src_px->a, *dst);
+								} else {
+									*dst = ComposeColourRGBANoCheck(src_px->r, src_px->g, src_px->b, src_px->a, *dst);
+								}
+								dst++;
+								src_px++;
+								src_n++;
+							} while (--count != 0);
+						}
+					}
+					break;
+			}
+		}
+
+		anim = anim_ln;
+		dst = dst_ln;
+		src_px = src_px_ln;
+		src_n  = src_n_ln;
+	}
+}
+
+/**
+ * Draws a sprite to a (screen) buffer. Calls adequate templated function.
+ *
+ * @param bp further blitting parameters
+ * @param mode blitter mode
+ * @param zoom zoom level at which we are drawing
+ */
+void Blitter_32bppNEON_Anim::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
+{
+	if (_screen_disable_anim) {
+		/* This means our output is not to the screen, so we can't be doing any animation stuff, so use our parent Draw() */
+		Blitter_32bppNEON::Draw(bp, mode, zoom);
+		return;
+	}
+
+	switch (mode) {
+		default: NOT_REACHED();
+		case BM_NORMAL:       Draw<BM_NORMAL>      (bp, zoom); return;
+		case BM_COLOUR_REMAP: Draw<BM_COLOUR_REMAP>(bp, zoom); return;
+		case BM_TRANSPARENT:  Draw<BM_TRANSPARENT> (bp, zoom); return;
+		case BM_TRANSPARENT_REMAP: Draw<BM_TRANSPARENT_REMAP>(bp, zoom); return;
+		case BM_CRASH_REMAP:  Draw<BM_CRASH_REMAP> (bp, zoom); return;
+		case BM_BLACK_REMAP:  Draw<BM_BLACK_REMAP> (bp, zoom); return;
+	}
+}
+
+#endif /* WITH_NEON */
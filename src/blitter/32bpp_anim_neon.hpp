@@ -0,0 +1,38 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file 32bpp_anim_neon.hpp NEON 32 bpp blitter with animation support. */
+
+#ifndef BLITTER_32BPP_ANIM_NEON_HPP
+#define BLITTER_32BPP_ANIM_NEON_HPP
+
+#ifdef WITH_NEON
+
+#include "32bpp_anim.hpp"
+#include "32bpp_neon.hpp"
+
+/** The NEON 32 bpp blitter with palette animation. */
+class Blitter_32bppNEON_Anim final : public Blitter_32bppAnim, public Blitter_32bppNEON {
+public:
+	template <BlitterMode mode> void Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom);
+	void Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom) override;
+	Sprite *Encode(const SpriteLoader::SpriteCollection &sprite, AllocatorProc *allocator) override {
+		return Blitter_32bppAnim::Encode(sprite, allocator);
+	}
+	const char *GetName() override { return "32bpp-neon-anim"; }
+	using Blitter_32bppAnim::LookupColourInPalette;
+};
+
+/** Factory for the NEON 32 bpp blitter (with palette animation). */
+class FBlitter_32bppNEON_Anim : public BlitterFactory {
+public:
+	FBlitter_32bppNEON_Anim() : BlitterFactory("32bpp-neon-anim", "32bpp NEON Blitter (palette animation)") {}
+	Blitter *CreateInstance() override { return static_cast<Blitter_32bppAnim *>(new Blitter_32bppNEON_Anim()); }
+};
+
+#endif /* WITH_NEON */
+#endif /* BLITTER_32BPP_ANIM_NEON_HPP */
@@ -0,0 +1,37 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file 32bpp_neon.hpp NEON 32 bpp blitter. */
+
+#ifndef BLITTER_32BPP_NEON_HPP
+#define BLITTER_32BPP_NEON_HPP
+
+#ifdef WITH_NEON
+
+#include "32bpp_optimized.hpp"
+
+/**
+ * The NEON 32 bpp blitter (without palette animation). It uses the sprites
+ * as encoded by the optimized blitter and draws the runs of pixels of those
+ * eight at a time.
+ */
+class Blitter_32bppNEON : public Blitter_32bppOptimized {
+public:
+	void Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom) override;
+	template <BlitterMode mode> void Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom);
+	const char *GetName() override { return "32bpp-neon"; }
+};
+
+/** Factory for the NEON 32 bpp blitter (without palette animation). */
+class FBlitter_32bppNEON : public BlitterFactory {
+public:
+	FBlitter_32bppNEON() : BlitterFactory("32bpp-neon", "32bpp NEON Blitter (no palette animation)") {}
+	Blitter *CreateInstance() override { return new Blitter_32bppNEON(); }
+};
+
+#endif /* WITH_NEON */
+#endif /* BLITTER_32BPP_NEON_HPP */
@@ -0,0 +1,174 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file 32bpp_neon_func.hpp Functions related to the NEON 32 bpp blitters. */
+
+#ifndef BLITTER_32BPP_NEON_FUNC_HPP
+#define BLITTER_32BPP_NEON_FUNC_HPP
+
+#ifdef WITH_NEON
+
+#include "32bpp_base.hpp"
+#include <arm_neon.h>
+
+/* The functions below work on runs of pixels of the same alpha class, as stored
+ * by the optimized blitter. Eight pixels at a time are split into their channels,
+ * the remainder is done with the generic functions. The vector code rounds the
+ * same way as the generic functions, so the output is exactly the same as that
+ * of the optimized blitter. */
+
+/**
+ * Alpha blend one channel of eight pixels; see Blitter_32bppBase::ComposeColourRGBANoCheck.
+ * @param src Channel of the sprite.
+ * @param dst Channel of the screen.
+ * @param alpha Alpha of the sprite.
+ * @return The blended channel.
+ */
+static inline uint8x8_t AlphaBlendChannel(uint8x8_t src, uint8x8_t dst, uint8x8_t alpha)
+{
+	/* Scale the absolute difference, so the result is truncated towards the screen colour. */
+	uint8x8_t delta = vshrn_n_u16(vmull_u8(vabd_u8(src, dst), alpha), 8);
+	return vbsl_u8(vcge_u8(src, dst), vadd_u8(dst, delta), vsub_u8(dst, delta));
+}
+
+/**
+ * Alpha blend eight pixels onto the screen.
+ * @param src The pixels of the sprite.
+ * @param dst The pixels of the screen.
+ */
+static inline void AlphaBlendEightPixels(const Colour *src, Colour *dst)
+{
+	uint8x8x4_t s = vld4_u8((const uint8_t *)src);
+	uint8x8x4_t d = vld4_u8((const uint8_t *)dst);
+	d.val[0] = AlphaBlendChannel(s.val[0], d.val[0], s.val[3]);
+	d.val[1] = AlphaBlendChannel(s.val[1], d.val[1], s.val[3]);
+	d.val[2] = AlphaBlendChannel(s.val[2], d.val[2], s.val[3]);
+	d.val[3] = vdup_n_u8(255);
+	vst4_u8((uint8_t *)dst, d);
+}
+
+/**
+ * Alpha blend a run of translucent pixels onto the screen.
+ * @param src The pixels of the sprite.
+ * @param dst The pixels of the screen.
+ * @param n The number of pixels.
+ */
+static inline void AlphaBlendPixels(const Colour *src, Colour *dst, uint n)
+{
+	for (; n >= 8; n -= 8) {
+		AlphaBlendEightPixels(src, dst);
+		src += 8;
+		dst += 8;
+	}
+	for (; n > 0; n--) {
+		*dst = Blitter_32bppBase::ComposeColourRGBANoCheck(src->r, src->g, src->b, src->a, *dst);
+		src++;
+		dst++;
+	}
+}
+
+/**
+ * Copy a run of opaque pixels to the screen.
+ * @param src The pixels of the sprite.
+ * @param dst The pixels of the screen.
+ * @param n The number of pixels.
+ */
+static inline void CopyPixels(const Colour *src, Colour *dst, uint n)
+{
+	for (; n >= 4; n -= 4) {
+		vst1q_u32(&dst->data, vld1q_u32(&src->data));
+		src += 4;
+		dst += 4;
+	}
+	for (; n > 0; n--) *dst++ = *src++;
+}
+
+/**
+ * Darken a run of the screen below opaque pixels; see Blitter_32bppBase::MakeTransparent with 3 / 4.
+ * @param dst The pixels of the screen.
+ * @param n The number of pixels.
+ */
+static inline void DarkenPixels(Colour *dst, uint n)
+{
+	const uint8x8_t three = vdup_n_u8(3);
+	for (; n >= 8; n -= 8) {
+		uint8x8x4_t d = vld4_u8((const uint8_t *)dst);
+		d.val[0] = vshrn_n_u16(vmull_u8(d.val[0], three), 2);
+		d.val[1] = vshrn_n_u16(vmull_u8(d.val[1], three), 2);
+		d.val[2] = vshrn_n_u16(vmull_u8(d.val[2], three), 2);
+		d.val[3] = vdup_n_u8(255);
+		vst4_u8((uint8_t *)dst, d);
+		dst += 8;
+	}
+	for (; n > 0; n--) {
+		*dst = Blitter_32bppBase::MakeTransparent(*dst, 3, 4);
+		dst++;
+	}
+}
+
+/**
+ * Darken one channel of eight pixels by c * (1024 - alpha) / 1024.
+ * @param c Channel of the screen.
+ * @param alpha Alpha of the sprite.
+ * @return The darkened channel.
+ */
+static inline uint8x8_t DarkenChannel(uint8x8_t c, uint8x8_t alpha)
+{
+	/* That is c minus c * alpha / 1024 rounded up, which fits in 16 bits. */
+	uint16x8_t x = vmull_u8(c, alpha);
+	uint16x8_t darken = vsubq_u16(vshrq_n_u16(x, 10), vtstq_u16(x, vdupq_n_u16(1023)));
+	return vsub_u8(c, vmovn_u16(darken));
+}
+
+/**
+ * Darken a run of the screen below translucent pixels; see Blitter_32bppBase::MakeTransparent with (1024 - alpha) / 1024.
+ * @param src The pixels of the sprite.
+ * @param dst The pixels of the screen.
+ * @param n The number of pixels.
+ */
+static inline void DarkenPixels(const Colour *src, Colour *dst, uint n)
+{
+	for (; n >= 8; n -= 8) {
+		uint8x8_t alpha = vld4_u8((const uint8_t *)src).val[3];
+		uint8x8x4_t d = vld4_u8((const uint8_t *)dst);
+		d.val[0] = DarkenChannel(d.val[0], alpha);
+		d.val[1] = DarkenChannel(d.val[1], alpha);
+		d.val[2] = DarkenChannel(d.val[2], alpha);
+		d.val[3] = vdup_n_u8(255);
+		vst4_u8((uint8_t *)dst, d);
+		src += 8;
+		dst += 8;
+	}
+	for (; n > 0; n--) {
+		*dst = Blitter_32bppBase::MakeTransparent(*dst, (256 * 4 - src->a), 256 * 4);
+		src++;
+		dst++;
+	}
+}
+
+/**
+ * Check whether none of eight pixels is remapped.
+ * @param src_n The remap values of the pixels.
+ * @return True if all remap values are zero.
+ */
+static inline bool HasNoRemap(const uint16_t *src_n)
+{
+	return vmaxvq_u16(vld1q_u16(src_n)) == 0;
+}
+
+/**
+ * Check whether none of eight pixels is drawn in an animated colour.
+ * @param src_n The remap values of the pixels.
+ * @return True if all remapped colours are below PALETTE_ANIM_START.
+ */
+static inline bool HasNoAnimation(const uint16_t *src_n)
+{
+	return vmaxvq_u16(vandq_u16(vld1q_u16(src_n), vdupq_n_u16(0xFF))) < PALETTE_ANIM_START;
+}
+
+#endif /* WITH_NEON */
+#endif /* BLITTER_32BPP_NEON_FUNC_HPP */
@@ -116,6 +116,78 @@ INTERNAL_LINKAGE inline __m128i DarkenTwoPixels(__m128i src, __m128i dst, const
 	return _mm_packus_epi16(dstAB, dstAB);
 }
 
+#if (SSE_VERSION >= 5)
+/* AVX2 works on two lanes of 128 bits, so unpacking and packing eight pixels
+ * gives pixels 0, 1, 4, 5 in the low half and 2, 3, 6, 7 in the high half,
+ * which are packed back in the right order again. The masks for the SSE
+ * functions are used for both lanes. */
+
+/**
+ * Alpha blend four unpacked pixels; the same as a pair of #AlphaBlendTwoPixels.
+ * @return The blended pixels, still unpacked.
+ */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m256i AlphaBlendUnpackedPixels(__m256i srcAB, __m256i dstAB, const __m256i &distribution_mask, const __m256i &alpha_mask)
+{
+	__m256i alphaMaskAB = _mm256_cmpgt_epi16(srcAB, _mm256_setzero_si256()); // VPCMPGTW (alpha > 0) ? 0xFFFF : 0
+	__m256i alphaAB = _mm256_sub_epi16(srcAB, alphaMaskAB);                  // if (alpha > 0) a++;
+	alphaAB = _mm256_shuffle_epi8(alphaAB, distribution_mask);
+
+	srcAB = _mm256_sub_epi16(srcAB, dstAB);     // VPSUBW,    (r - Cr)
+	srcAB = _mm256_mullo_epi16(srcAB, alphaAB); // VPMULLW, a*(r - Cr)
+	srcAB = _mm256_srli_epi16(srcAB, 8);        // VPSRLW,  a*(r - Cr)/256
+	srcAB = _mm256_add_epi16(srcAB, dstAB);     // VPADDW,  a*(r - Cr)/256 + Cr
+
+	alphaMaskAB = _mm256_and_si256(alphaMaskAB, alpha_mask); // VPAND, set non alpha fields to 0
+	srcAB = _mm256_or_si256(srcAB, alphaMaskAB);             // VPOR, set alpha fields to 0xFFFF is src alpha was > 0
+
+	/* Keep only the low bytes, so packing them does not saturate. */
+	return _mm256_and_si256(srcAB, _mm256_set1_epi16(0x00FF));
+}
+
+/** Alpha blend eight pixels; the same as four times #AlphaBlendTwoPixels. */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m256i AlphaBlendEightPixels(__m256i src, __m256i dst, const __m256i &distribution_mask, const __m256i &alpha_mask)
+{
+	__m256i lo = AlphaBlendUnpackedPixels(_mm256_unpacklo_epi8(src, _mm256_setzero_si256()), _mm256_unpacklo_epi8(dst, _mm256_setzero_si256()), distribution_mask, alpha_mask);
+	__m256i hi = AlphaBlendUnpackedPixels(_mm256_unpackhi_epi8(src, _mm256_setzero_si256()), _mm256_unpackhi_epi8(dst, _mm256_setzero_si256()), distribution_mask, alpha_mask);
+	return _mm256_packus_epi16(lo, hi);
+}
+
+/**
+ * Darken four unpacked pixels; the same as a pair of #DarkenTwoPixels.
+ * @return The darkened pixels, still unpacked.
+ */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m256i DarkenUnpackedPixels(__m256i srcAB, __m256i dstAB, const __m256i &distribution_mask, const __m256i &tr_nom_base)
+{
+	__m256i alphaAB = _mm256_shuffle_epi8(srcAB, distribution_mask);
+	alphaAB = _mm256_srli_epi16(alphaAB, 2); // Reduce to 64 levels of shades so the max value fits in 16 bits.
+	__m256i nom = _mm256_sub_epi16(tr_nom_base, alphaAB);
+	dstAB = _mm256_mullo_epi16(dstAB, nom);
+	return _mm256_srli_epi16(dstAB, 8);
+}
+
+/** Darken eight pixels; the same as four times #DarkenTwoPixels. */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m256i DarkenEightPixels(__m256i src, __m256i dst, const __m256i &distribution_mask, const __m256i &tr_nom_base)
+{
+	__m256i lo = DarkenUnpackedPixels(_mm256_unpacklo_epi8(src, _mm256_setzero_si256()), _mm256_unpacklo_epi8(dst, _mm256_setzero_si256()), distribution_mask, tr_nom_base);
+	__m256i hi = DarkenUnpackedPixels(_mm256_unpackhi_epi8(src, _mm256_setzero_si256()), _mm256_unpackhi_epi8(dst, _mm256_setzero_si256()), distribution_mask, tr_nom_base);
+	return _mm256_packus_epi16(lo, hi);
+}
+
+/** Copy the eight pixels that are not fully transparent. */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline void CopyEightPixels(const Colour *src, Colour *dst)
+{
+	__m256i srcABCD = _mm256_loadu_si256((const __m256i *) src);
+	__m256i dstABCD = _mm256_loadu_si256((const __m256i *) dst);
+	__m256i transparent = _mm256_cmpeq_epi32(_mm256_srli_epi32(srcABCD, 24), _mm256_setzero_si256());
+	_mm256_storeu_si256((__m256i *) dst, _mm256_blendv_epi8(srcABCD, dstABCD, transparent));
+}
+#endif /* SSE_VERSION >= 5 */
+
 IGNORE_UNINITIALIZED_WARNING_START
 GNU_TARGET(SSE_TARGET)
 INTERNAL_LINKAGE Colour ReallyAdjustBrightness(Colour colour, uint8_t brightness)
@@ -219,6 +291,8 @@ inline void Blitter_32bppSSE2::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 inline void Blitter_32bppSSSE3::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+inline void Blitter_32bppAVX2::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #endif
 {
 	const uint8_t * const remap = bp->remap;
@@ -255,6 +329,11 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 	#define DARKEN_PARAM_2      tr_nom_base
 #endif
 	const __m128i tr_nom_base = TRANSPARENT_NOM_BASE;
+#if (SSE_VERSION >= 5)
+	const __m256i a_cm_256        = _mm256_broadcastsi128_si256(a_cm);
+	const __m256i alpha_and_256   = _mm256_broadcastsi128_si256(alpha_and);
+	const __m256i tr_nom_base_256 = _mm256_broadcastsi128_si256(tr_nom_base);
+#endif
 
 	for (int y = bp->height; y != 0; y--) {
 		Colour *dst = dst_line;
@@ -277,7 +356,15 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 		switch (mode) {
 			default:
 				if (!translucent) {
-					for (uint x = (uint) effective_width; x > 0; x--) {
+					uint x = (uint) effective_width;
+#if (SSE_VERSION >= 5)
+					for (; x >= 8; x -= 8) {
+						CopyEightPixels(src, dst);
+						src += 8;
+						dst += 8;
+					}
+#endif
+					for (; x > 0; x--) {
 						if (src->a) *dst = *src;
 						src++;
 						dst++;
@@ -285,13 +372,25 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 					break;
 				}
 
-				for (uint x = (uint) effective_width / 2; x > 0; x--) {
+				{
+				uint x = (uint) effective_width / 2;
+#if (SSE_VERSION >= 5)
+				for (; x >= 4; x -= 4) {
+					__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+					__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+					_mm256_storeu_si256((__m256i*) dst, AlphaBlendEightPixels(srcABCD, dstABCD, a_cm_256, alpha_and_256));
+					src += 8;
+					dst += 8;
+				}
+#endif
+				for (; x > 0; x--) {
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					_mm_storel_epi64((__m128i*) dst, AlphaBlendTwoPixels(srcABCD, dstABCD, ALPHA_BLEND_PARAM_1, ALPHA_BLEND_PARAM_2, ALPHA_BLEND_PARAM_3));
 					src += 2;
 					dst += 2;
 				}
+				}
 
 				if ((bt_last == BT_NONE && effective_width & 1) || bt_last == BT_ODD) {
 					__m128i srcABCD = _mm_cvtsi32_si128(src->data);
@@ -303,6 +402,19 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 			case BM_COLOUR_REMAP:
 #if (SSE_VERSION >= 3)
 				for (uint x = (uint) effective_width / 2; x > 0; x--) {
+#if (SSE_VERSION >= 5)
+					/* Blend eight pixels at once when none of them has to be remapped. */
+					if (x >= 4 && _mm_testz_si128(_mm_loadu_si128((const __m128i*) src_mv), _mm_set1_epi16(0x00FF))) {
+						__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+						__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+						_mm256_storeu_si256((__m256i*) dst, AlphaBlendEightPixels(srcABCD, dstABCD, a_cm_256, alpha_and_256));
+						dst += 8;
+						src += 8;
+						src_mv += 8;
+						x -= 3;
+						continue;
+					}
+#endif
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					uint32_t mvX2 = *((uint32_t *) const_cast<MapValue *>(src_mv));
@@ -384,13 +496,25 @@ bmcr_alpha_blend_single:
 
 			case BM_TRANSPARENT:
 				/* Make the current colour a bit more black, so it looks like this image is transparent. */
-				for (uint x = (uint) bp->width / 2; x > 0; x--) {
+				{
+				uint x = (uint) bp->width / 2;
+#if (SSE_VERSION >= 5)
+				for (; x >= 4; x -= 4) {
+					__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+					__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+					_mm256_storeu_si256((__m256i *) dst, DarkenEightPixels(srcABCD, dstABCD, a_cm_256, tr_nom_base_256));
+					src += 8;
+					dst += 8;
+				}
+#endif
+				for (; x > 0; x--) {
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					_mm_storel_epi64((__m128i *) dst, DarkenTwoPixels(srcABCD, dstABCD, DARKEN_PARAM_1, DARKEN_PARAM_2));
 					src += 2;
 					dst += 2;
 				}
+				}
 
 				if ((bt_last == BT_NONE && bp->width & 1) || bt_last == BT_ODD) {
 					__m128i srcABCD = _mm_cvtsi32_si128(src->data);
@@ -461,6 +585,8 @@ void Blitter_32bppSSE2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomL
 void Blitter_32bppSSSE3::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 void Blitter_32bppSSE4::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+void Blitter_32bppAVX2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #endif
 {
 	switch (mode) {
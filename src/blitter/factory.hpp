@@ -115,6 +115,8 @@ public:
 	{
 #if defined(DEDICATED)
 		const char *default_blitter = "null";
+#elif defined(WITH_COCOA) && defined(WITH_NEON)
+		const char *default_blitter = "32bpp-neon-anim";
 #elif defined(WITH_COCOA)
 		const char *default_blitter = "32bpp-anim";
 #else
@@ -1156,27 +1156,6 @@ struct BuildVehicleWindow : Window {
 		}
 	}
 
-	void AddChildren(const GUIEngineList &source, EngineID parent, int indent)
-	{
-		for (const auto &item : source) {
-			if (item.variant_id != parent || item.engine_id == parent) continue;
-
-			const Engine *e = Engine::Get(item.engine_id);
-			EngineDisplayFlags flags = item.flags;
-			if (e->display_last_variant != INVALID_ENGINE) flags &= ~EngineDisplayFlags::Shaded;
-			this->eng_list.emplace_back(e->display_last_variant == INVALID_ENGINE ? item.engine_id : e->display_last_variant, item.engine_id, flags, indent);
-
-			/* Add variants if not folded */
-			if ((item.flags & (EngineDisplayFlags::HasVariants | EngineDisplayFlags::IsFolded)) == EngineDisplayFlags::HasVariants) {
-				/* Add this engine again as a child */
-				if ((item.flags & EngineDisplayFlags::Shaded) == EngineDisplayFlags::None) {
-					this->eng_list.emplace_back(item.engine_id, item.engine_id, EngineDisplayFlags::None, indent + 1);
-				}
-				AddChildren(source, item.engine_id, indent + 1);
-			}
-		}
-	}
-
 	BuildVehicleWindow(WindowDesc *desc, TileIndex tile, VehicleType type) : Window(desc), vehicle_editbox(MAX_LENGTH_VEHICLE_NAME_CHARS * MAX_CHAR_LENGTH, MAX_LENGTH_VEHICLE_NAME_CHARS)
 	{
 		this->vehicle_type = type;
@@ -1401,13 +1380,9 @@ struct BuildVehicleWindow : Window {
 		}
 
 		/* ensure primary engine of variant group is in list */
-		for (const auto &variant : variants) {
-			if (std::find(list.begin(), list.end(), variant) == list.end()) {
-				const Engine *e = Engine::Get(variant);
-				list.emplace_back(variant, e->info.variant_id, e->display_flags | EngineDisplayFlags::Shaded, 0);
-				if (e->u.rail.railveh_type != RAILVEH_WAGON) num_engines++;
-			}
-		}
+		EngList_AddMissingVariantParents(list, variants, [&num_engines](const Engine *e) {
+			if (e->u.rail.railveh_type != RAILVEH_WAGON) num_engines++;
+		});
 
 		this->SelectEngine(sel_id);
 
@@ -1517,7 +1492,7 @@ struct BuildVehicleWindow : Window {
 			default: NOT_REACHED();
 			case VEH_TRAIN:
 				this->GenerateBuildTrainList(list);
-				AddChildren(list, INVALID_ENGINE, 0);
+				EngList_AddChildren(list, this->eng_list);
 				this->eng_list.shrink_to_fit();
 				this->eng_list.RebuildDone();
 				return;
@@ -1544,18 +1519,13 @@ struct BuildVehicleWindow : Window {
 			}
 		}
 
-		for (const auto &variant : variants) {
-			if (std::find(this->eng_list.begin(), this->eng_list.end(), variant) == this->eng_list.end()) {
-				const Engine *e = Engine::Get(variant);
-				this->eng_list.emplace_back(variant, e->info.variant_id, e->display_flags | EngineDisplayFlags::Shaded, 0);
-			}
-		}
+		EngList_AddMissingVariantParents(this->eng_list, variants);
 
 		_engine_sort_direction = this->descending_sort_order;
 		EngList_Sort(this->eng_list, _engine_sort_functions[this->vehicle_type][this->sort_criteria]);
 
 		this->eng_list.swap(list);
-		AddChildren(list, INVALID_ENGINE, 0);
+		EngList_AddChildren(list, this->eng_list);
 		this->eng_list.shrink_to_fit();
 		this->eng_list.RebuildDone();
 	}
@@ -70,10 +70,7 @@ static int32_t GetAmount(CargoMonitorMap &monitor_map, CargoMonitorID monitor, b
 {
 	CargoMonitorMap::iterator iter = monitor_map.find(monitor);
 	if (iter == monitor_map.end()) {
-		if (keep_monitoring) {
-			std::pair<CargoMonitorID, uint32_t> p(monitor, 0);
-			monitor_map.insert(p);
-		}
+		if (keep_monitoring) monitor_map.try_emplace(monitor, 0);
 		return 0;
 	} else {
 		int32_t result = iter->second;
@@ -119,6 +116,8 @@ int32_t GetPickupAmount(CargoMonitorID monitor, bool keep_monitoring)
 void AddCargoDelivery(CargoID cargo_type, CompanyID company, uint32_t amount, SourceType src_type, SourceID src, const Station *st, IndustryID dest)
 {
 	if (amount == 0) return;
+	/* Usually no script monitors anything, then there is nothing to look up. */
+	if (_cargo_pickups.empty() && _cargo_deliveries.empty()) return;
 
 	if (src != INVALID_SOURCE) {
 		/* Handle pickup update. */
@@ -15,6 +15,7 @@
 #include "industry.h"
 #include "town.h"
 #include "core/overflowsafe_type.hpp"
+#include "core/flathashmap_type.hpp"
 
 struct Station;
 
@@ -28,8 +29,8 @@ struct Station;
  */
 typedef uint32_t CargoMonitorID; ///< Type of the cargo monitor number.
 
-/** Map type for storing and updating active cargo monitor numbers and their amounts. */
-typedef std::map<CargoMonitorID, OverflowSafeInt32> CargoMonitorMap;
+/** Map type for storing and updating active cargo monitor numbers and their amounts; it is searched for every delivery. */
+typedef FlatHashMap<CargoMonitorID, OverflowSafeInt32> CargoMonitorMap;
 
 extern CargoMonitorMap _cargo_pickups;
 extern CargoMonitorMap _cargo_deliveries;
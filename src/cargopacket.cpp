@@ -118,6 +118,19 @@ void CargoPacket::Merge(CargoPacket *cp)
 	delete cp;
 }
 
+/**
+ * Merge another packet of a slightly different age into this one. The age
+ * of the result is the average of both, weighted by their amounts.
+ * @param cp Packet to be merged in.
+ */
+void CargoPacket::Coalesce(CargoPacket *cp)
+{
+	uint total = this->count + cp->count;
+	uint64_t periods = static_cast<uint64_t>(this->periods_in_transit) * this->count + static_cast<uint64_t>(cp->periods_in_transit) * cp->count;
+	this->periods_in_transit = static_cast<uint16_t>((periods + total / 2) / total);
+	this->Merge(cp);
+}
+
 /**
  * Reduce the packet by the given amount and remove the feeder share.
  * @param count Amount to be removed.
@@ -692,10 +705,37 @@ void StationCargoList::Append(CargoPacket *cp, StationID next)
 		if (StationCargoList::TryMerge(*it, cp)) return;
 	}
 
+	/* Stations with a lot of different cargo would otherwise collect tens of
+	 * thousands of packets that only differ in age. */
+	if (list.size() >= COALESCE_THRESHOLD) {
+		for (StationCargoPacketMap::List::reverse_iterator it(list.rbegin());
+				it != list.rend(); it++) {
+			if (this->TryCoalesce(*it, cp)) return;
+		}
+	}
+
 	/* The packet could not be merged with another one */
 	list.push_back(cp);
 }
 
+/**
+ * Tries to coalesce the second packet into the first and return if that was
+ * successful. The packet to be eliminated must already be in the cache.
+ * @param icp Packet to be merged into.
+ * @param cp Packet to be eliminated.
+ * @return If the packets could be coalesced.
+ */
+bool StationCargoList::TryCoalesce(CargoPacket *icp, CargoPacket *cp)
+{
+	if (!StationCargoList::AreCoalescable(icp, cp) || icp->count + cp->count > CargoPacket::MAX_COUNT) return false;
+
+	/* The age of the coalesced packet is rounded, so update the cache with the exact difference. */
+	this->cargo_periods_in_transit -= static_cast<uint64_t>(icp->periods_in_transit) * icp->count + static_cast<uint64_t>(cp->periods_in_transit) * cp->count;
+	icp->Coalesce(cp);
+	this->cargo_periods_in_transit += static_cast<uint64_t>(icp->periods_in_transit) * icp->count;
+	return true;
+}
+
 /**
  * Shifts cargo from the front of the packet list for a specific station and
  * applies some action to it.
@@ -711,17 +751,19 @@ void StationCargoList::Append(CargoPacket *cp, StationID next)
 template <class Taction>
 bool StationCargoList::ShiftCargo(Taction &action, StationID next)
 {
-	std::pair<Iterator, Iterator> range(this->packets.equal_range(next));
-	for (Iterator it(range.first); it != range.second && it.GetKey() == next;) {
-		if (action.MaxMove() == 0) return false;
-		CargoPacket *cp = *it;
-		if (action(cp)) {
-			it = this->packets.erase(it);
-		} else {
-			return false;
-		}
-	}
-	return true;
+	StationCargoPacketMap::MapIterator map_it = this->packets.find(next);
+	if (map_it == this->packets.end()) return true;
+
+	/* None of the actions adds packets for the next hop we take packets from,
+	 * so the list stays valid while the actions are applied. */
+	StationCargoPacketMap::List &list = map_it->second;
+	StationCargoPacketMap::ListIterator it = list.begin();
+	while (it != list.end() && action.MaxMove() > 0 && action(*it)) ++it;
+
+	bool all_removed = (it == list.end());
+	list.erase(list.begin(), it);
+	if (list.empty()) this->packets.Map::erase(map_it);
+	return all_removed;
 }
 
 /**
@@ -768,38 +810,53 @@ uint StationCargoList::Truncate(uint max_move, StationCargoAmountMap *cargo_per_
 	uint loop = 0;
 	bool do_count = cargo_per_source != nullptr;
 	while (max_move > moved) {
-		for (Iterator it(this->packets.begin()); it != this->packets.end();) {
-			CargoPacket *cp = *it;
-			if (prev_count > max_move && RandomRange(prev_count) < prev_count - max_move) {
-				if (do_count && loop == 0) {
-					(*cargo_per_source)[cp->first_station] += cp->count;
+		for (StationCargoPacketMap::MapIterator map_it = this->packets.begin(); map_it != this->packets.end();) {
+			/* Compact the list while walking over it, instead of erasing the packets one by one. */
+			StationCargoPacketMap::List &list = map_it->second;
+			StationCargoPacketMap::ListIterator keep = list.begin();
+			bool done = false;
+			for (CargoPacket *cp : list) {
+				if (done) {
+					*keep++ = cp;
+					continue;
 				}
-				++it;
-				continue;
-			}
-			uint diff = max_move - moved;
-			if (cp->count > diff) {
-				if (diff > 0) {
-					this->RemoveFromCache(cp, diff);
-					cp->Reduce(diff);
-					moved += diff;
+				if (prev_count > max_move && RandomRange(prev_count) < prev_count - max_move) {
+					if (do_count && loop == 0) {
+						(*cargo_per_source)[cp->first_station] += cp->count;
+					}
+					*keep++ = cp;
+					continue;
 				}
-				if (loop > 0) {
-					if (do_count) (*cargo_per_source)[cp->first_station] -= diff;
-					return moved;
+				uint diff = max_move - moved;
+				if (cp->count > diff) {
+					if (diff > 0) {
+						this->RemoveFromCache(cp, diff);
+						cp->Reduce(diff);
+						moved += diff;
+					}
+					if (loop > 0) {
+						if (do_count) (*cargo_per_source)[cp->first_station] -= diff;
+						done = true;
+					} else {
+						if (do_count) (*cargo_per_source)[cp->first_station] += cp->count;
+					}
+					*keep++ = cp;
 				} else {
-					if (do_count) (*cargo_per_source)[cp->first_station] += cp->count;
-					++it;
+					if (do_count && loop > 0) {
+						(*cargo_per_source)[cp->first_station] -= cp->count;
+					}
+					moved += cp->count;
+					this->RemoveFromCache(cp, cp->count);
+					delete cp;
 				}
+			}
+			list.erase(keep, list.end());
+			if (list.empty()) {
+				map_it = this->packets.Map::erase(map_it);
 			} else {
-				it = this->packets.erase(it);
-				if (do_count && loop > 0) {
-					(*cargo_per_source)[cp->first_station] -= cp->count;
-				}
-				moved += cp->count;
-				this->RemoveFromCache(cp, cp->count);
-				delete cp;
+				++map_it;
 			}
+			if (done) return moved;
 		}
 		loop++;
 	}
@@ -83,6 +83,7 @@ public:
 
 	CargoPacket *Split(uint new_size);
 	void Merge(CargoPacket *cp);
+	void Coalesce(CargoPacket *cp);
 	void Reduce(uint count);
 
 	/**
@@ -533,7 +534,14 @@ protected:
 
 	uint reserved_count; ///< Amount of cargo being reserved for loading.
 
+	bool TryCoalesce(CargoPacket *icp, CargoPacket *cp);
+
 public:
+	/** Number of packets for a next hop above which packets of different ages are coalesced. */
+	static const size_t COALESCE_THRESHOLD = 32;
+	/** Maximum difference in cargo aging periods of packets that are coalesced. */
+	static const uint16_t COALESCE_MAX_PERIODS = 4;
+
 	/** The super class ought to know what it's doing. */
 	friend class CargoList<StationCargoList, StationCargoPacketMap>;
 	/* So we can use private/protected variables in the saveload code */
@@ -633,6 +641,23 @@ public:
 				cp1->first_station == cp2->first_station &&
 				cp1->source_id == cp2->source_id;
 	}
+
+	/**
+	 * Can the two CargoPackets be coalesced in the context of a long list of
+	 * CargoPackets for a Station? Unlike for merging their ages may differ a
+	 * little, as a few aging periods more or less hardly change the income.
+	 * @param cp1 First CargoPacket.
+	 * @param cp2 Second CargoPacket.
+	 * @return True if they can be coalesced.
+	 */
+	static bool AreCoalescable(const CargoPacket *cp1, const CargoPacket *cp2)
+	{
+		return cp1->source_xy == cp2->source_xy &&
+				Delta(cp1->periods_in_transit, cp2->periods_in_transit) <= COALESCE_MAX_PERIODS &&
+				cp1->source_type == cp2->source_type &&
+				cp1->first_station == cp2->first_station &&
+				cp1->source_id == cp2->source_id;
+	}
 };
 
 #endif /* CARGOPACKET_H */
@@ -11,6 +11,7 @@
 #include "landscape.h"
 #include "error.h"
 #include "gui.h"
+#include "window_func.h"
 #include "command_func.h"
 #include "network/network_type.h"
 #include "network/network.h"
@@ -23,6 +24,7 @@
 #include "company_base.h"
 #include "signal_func.h"
 #include "core/backup_type.hpp"
+#include "framerate_type.h"
 #include "object_base.h"
 #include "autoreplace_cmd.h"
 #include "company_cmd.h"
@@ -169,7 +171,12 @@ bool IsCommandAllowedWhilePaused(Commands cmd)
 void CommandHelperBase::InternalDoBefore(bool top_level, bool test)
 {
 	if (top_level) _cleared_object_areas.clear();
-	if (test) SetTownRatingTestMode(true);
+	if (test) {
+		SetTownRatingTestMode(true);
+	} else {
+		/* The command might change the tracks or signals reservations are followed over. */
+		_track_reservation_generation++;
+	}
 }
 
 /**
@@ -225,6 +232,24 @@ std::tuple<bool, bool, bool> CommandHelperBase::InternalPostBefore(Commands cmd,
 	}
 }
 
+/** The time measurement of the top level command being executed; those are only executed from the game loop. */
+static std::optional<CompanyPerformanceMeasurer> _command_performance_measurer;
+
+/**
+ * Start attributing the time of a top level command to a company.
+ * @param company The company executing the command.
+ */
+CommandHelperBase::ExecutionMeasurer::ExecutionMeasurer(CompanyID company)
+{
+	_command_performance_measurer.emplace(CPE_COMMANDS, company);
+}
+
+/** Finish attributing the time of the top level command. */
+CommandHelperBase::ExecutionMeasurer::~ExecutionMeasurer()
+{
+	_command_performance_measurer.reset();
+}
+
 /**
  * Process result of executing a command, possibly displaying any error to the player.
  * @param res Command result.
@@ -289,6 +314,18 @@ bool CommandHelperBase::InternalExecutePrepTest(CommandFlags cmd_flags, TileInde
 	return true;
 }
 
+/**
+ * Check whether a command will be executed right after its test run,
+ * instead of only being estimated or sent to the server.
+ * @param estimate_only Is this just cost estimation?
+ * @param network_command Does this command come from the network?
+ * @return True if the command will be executed right away.
+ */
+bool CommandHelperBase::InternalExecuteIsImmediate(bool estimate_only, bool network_command)
+{
+	return !estimate_only && (!_networking || _generating_world || network_command);
+}
+
 /**
  * Validate result of test run and prepare for real execution.
  * @param cmd_flags Command flags.
@@ -342,6 +379,10 @@ CommandCost CommandHelperBase::InternalExecuteProcessResult(Commands cmd, Comman
 {
 	BasePersistentStorageArray::SwitchMode(PSM_LEAVE_COMMAND);
 
+	/* Let the windows catch up with what the command changed, which might include names. */
+	ClearFormattedStringCache();
+	ProcessPendingWindowInvalidations();
+
 	if (cmd == CMD_COMPANY_CTRL) {
 		cur_company.Trash();
 		/* We are a new company                  -> Switch to new local company.
@@ -99,9 +99,16 @@ protected:
 	static std::tuple<bool, bool, bool> InternalPostBefore(Commands cmd, CommandFlags flags, TileIndex tile, StringID err_message, bool network_command);
 	static void InternalPostResult(const CommandCost &res, TileIndex tile, bool estimate_only, bool only_sending, StringID err_message, bool my_cmd);
 	static bool InternalExecutePrepTest(CommandFlags cmd_flags, TileIndex tile, Backup<CompanyID> &cur_company);
+	static bool InternalExecuteIsImmediate(bool estimate_only, bool network_command);
 	static std::tuple<bool, bool, bool> InternalExecuteValidateTestAndPrepExec(CommandCost &res, CommandFlags cmd_flags, bool estimate_only, bool network_command, Backup<CompanyID> &cur_company);
 	static CommandCost InternalExecuteProcessResult(Commands cmd, CommandFlags cmd_flags, const CommandCost &res_test, const CommandCost &res_exec, Money extra_cash, TileIndex tile, Backup<CompanyID> &cur_company);
 	static void LogCommandExecution(Commands cmd, StringID err_message, const CommandDataBuffer &args, bool failed);
+
+	/** Attribute the time spent executing a top level command to the company executing it. */
+	struct ExecutionMeasurer {
+		ExecutionMeasurer(CompanyID company);
+		~ExecutionMeasurer();
+	};
 };
 
 /**
@@ -156,8 +163,10 @@ public:
 
 		RecursiveCommandCounter counter{};
 
-		/* Only execute the test call if it's toplevel, or we're not execing. */
-		if (counter.IsTopLevel() || !(flags & DC_EXEC)) {
+		/* Only execute the test call if it's toplevel, or we're not execing.
+		 * Commands that check everything while executing need no test call at all. */
+		constexpr bool exec_only = (GetCommandFlags<Tcmd>() & CMD_EXEC_ONLY) != 0;
+		if ((counter.IsTopLevel() && !exec_only) || !(flags & DC_EXEC)) {
 			InternalDoBefore(counter.IsTopLevel(), true);
 			Tret res = CommandTraits<Tcmd>::proc(flags & ~DC_EXEC, args...);
 			InternalDoAfter(ExtractCommandCost(res), flags, counter.IsTopLevel(), true); // Can modify res.
@@ -366,6 +375,7 @@ protected:
 
 		/* Command flags are used internally */
 		constexpr CommandFlags cmd_flags = GetCommandFlags<Tcmd>();
+		static_assert((cmd_flags & CMD_EXEC_ONLY) == 0 || (cmd_flags & CMD_NO_TEST) != 0, "Without a test run there is no test result to compare with");
 
 		if constexpr ((cmd_flags & CMD_CLIENT_ID) != 0) {
 			/* Make sure arguments are properly set to a ClientID also when processing external commands. */
@@ -378,9 +388,12 @@ protected:
 			return MakeResult(CMD_ERROR);
 		}
 
-		/* Test the command. */
+		ExecutionMeasurer company_framerate(_current_company);
+
+		/* Test the command, unless it checks everything itself and is executed right away. */
 		DoCommandFlag flags = CommandFlagsToDCFlags(cmd_flags);
-		Tret res = std::apply(CommandTraits<Tcmd>::proc, std::tuple_cat(std::make_tuple(flags), args));
+		bool skip_test = (cmd_flags & CMD_EXEC_ONLY) != 0 && InternalExecuteIsImmediate(estimate_only, network_command);
+		Tret res = skip_test ? Tret{} : std::apply(CommandTraits<Tcmd>::proc, std::tuple_cat(std::make_tuple(flags), args));
 
 		auto [exit_test, desync_log, send_net] = InternalExecuteValidateTestAndPrepExec(ExtractCommandCost(res), cmd_flags, estimate_only, network_command, cur_company);
 		if (exit_test) {
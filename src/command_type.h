@@ -271,6 +271,7 @@ enum Commands : uint16_t {
 	CMD_TURN_ROADVEH,                 ///< turn a road vehicle around
 
 	CMD_PAUSE,                        ///< pause the game
+	CMD_POSTPONE_LINK_GRAPH_JOB,      ///< postpone the join of an overdue link graph job
 
 	CMD_BUY_COMPANY,                  ///< buy a company which is bankrupt
 
@@ -401,6 +402,7 @@ enum CommandFlags {
 	CMD_STR_CTRL  = 0x200, ///< the command's string may contain control strings
 	CMD_NO_EST    = 0x400, ///< the command is never estimated.
 	CMD_LOCATION  = 0x800, ///< the command has implicit location argument.
+	CMD_EXEC_ONLY = 0x1000, ///< the command checks every tile and the money itself while executing and changes nothing when it fails, so it needs no test run before executing.
 };
 DECLARE_ENUM_AS_BIT_SET(CommandFlags)
 
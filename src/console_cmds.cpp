@@ -34,6 +34,7 @@
 #include "gamelog.h"
 #include "ai/ai.hpp"
 #include "ai/ai_config.hpp"
+#include "ai/ai_instance.hpp"
 #include "newgrf.h"
 #include "newgrf_profiling.h"
 #include "console_func.h"
@@ -41,10 +42,18 @@
 #include "road.h"
 #include "rail.h"
 #include "game/game.hpp"
+#include "game/game_instance.hpp"
 #include "table/strings.h"
 #include "3rdparty/fmt/chrono.h"
 #include "company_cmd.h"
 #include "misc_cmd.h"
+#include "vehicle_func.h"
+#include "trace.h"
+#include "pathfinder/yapf/yapf_stats.h"
+#include "core/pool_type.hpp"
+#include "spritecache.h"
+#include "gfx_layout.h"
+#include "linkgraph/linkgraphjob.h"
 
 #include <sstream>
 
@@ -1487,6 +1496,63 @@ DEF_CONSOLE_CMD(ConStopAI)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConScriptProfile)
+{
+	if (argc < 3 || argc > 4) {
+		IConsolePrint(CC_HELP, "Profile an AI or the game script. Usage: 'script_profile <company-id>|gs start [<interval>]|stop|ops|time'.");
+		IConsolePrint(CC_HELP, "'start' samples the call stack every <interval> opcodes, default 100. 'ops' and 'time' print the opcodes or microseconds per call stack, in the folded stack format of flame graph tools.");
+		IConsolePrint(CC_HELP, "For company-id's, see the list of companies from the dropdown menu. Company 1 is 1, etc. Use 'script' to write the profile to a file.");
+		return true;
+	}
+
+	if (_game_mode != GM_NORMAL) {
+		IConsolePrint(CC_ERROR, "Scripts can only be profiled in a game.");
+		return true;
+	}
+
+	if (_networking && !_network_server) {
+		IConsolePrint(CC_ERROR, "Only the server can profile a script.");
+		return true;
+	}
+
+	ScriptInstance *instance = nullptr;
+	if (StrEqualsIgnoreCase(argv[1], "gs")) {
+		instance = Game::GetInstance();
+		if (instance == nullptr) {
+			IConsolePrint(CC_ERROR, "No game script is running.");
+			return true;
+		}
+	} else {
+		CompanyID company_id = (CompanyID)(atoi(argv[1]) - 1);
+		if (!Company::IsValidAiID(company_id)) {
+			IConsolePrint(CC_ERROR, "Company is not controlled by an AI.");
+			return true;
+		}
+		instance = Company::Get(company_id)->ai_instance;
+	}
+
+	if (StrEqualsIgnoreCase(argv[2], "start")) {
+		int interval = argc == 4 ? atoi(argv[3]) : 100;
+		if (interval <= 0) {
+			IConsolePrint(CC_ERROR, "The interval has to be at least 1 opcode.");
+			return true;
+		}
+		instance->SetProfiling(interval);
+		IConsolePrint(CC_DEFAULT, "Profiling started.");
+	} else if (StrEqualsIgnoreCase(argv[2], "stop")) {
+		instance->SetProfiling(0);
+		IConsolePrint(CC_DEFAULT, "Profiling stopped.");
+	} else if (StrEqualsIgnoreCase(argv[2], "ops") || StrEqualsIgnoreCase(argv[2], "time")) {
+		for (const std::string &line : instance->GetProfile(StrEqualsIgnoreCase(argv[2], "time"))) {
+			IConsolePrint(CC_DEFAULT, line);
+		}
+	} else {
+		IConsolePrint(CC_ERROR, "Unknown action '{}'.", argv[2]);
+	}
+
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConRescanAI)
 {
 	if (argc == 0) {
@@ -2347,6 +2413,7 @@ DEF_CONSOLE_CMD(ConListDirs)
 		{ AUTOSAVE_DIR,     "autosave",   true  },
 		{ SCREENSHOT_DIR,   "screenshot", true  },
 		{ SOCIAL_INTEGRATION_DIR, "social_integration", true },
+		{ CACHE_DIR,        "cache",      true  },
 	};
 
 	if (argc != 2) {
@@ -2403,6 +2470,10 @@ DEF_CONSOLE_CMD(ConNewGRFProfile)
 		IConsolePrint(CC_HELP, "  Unselect one or more GRFs from profiling. Use the keyword \"all\" instead of a GRF number to unselect all. Removing an active profiler aborts data collection.");
 		IConsolePrint(CC_HELP, "Usage: 'newgrf_profile start [<num-ticks>]':");
 		IConsolePrint(CC_HELP, "  Begin profiling all selected GRFs. If a number of ticks is provided, profiling stops after that many game ticks. There are 74 ticks in a calendar day.");
+		IConsolePrint(CC_HELP, "Usage: 'newgrf_profile aggregate [<num-ticks>]':");
+		IConsolePrint(CC_HELP, "  Like 'start', but only collect statistics per feature and callback. This is cheap enough to leave running.");
+		IConsolePrint(CC_HELP, "Usage: 'newgrf_profile summary':");
+		IConsolePrint(CC_HELP, "  Show the statistics collected so far by the GRFs profiled with 'aggregate'.");
 		IConsolePrint(CC_HELP, "Usage: 'newgrf_profile stop':");
 		IConsolePrint(CC_HELP, "  End profiling and write the collected data to CSV files.");
 		IConsolePrint(CC_HELP, "Usage: 'newgrf_profile abort':");
@@ -2465,13 +2536,14 @@ DEF_CONSOLE_CMD(ConNewGRFProfile)
 		return true;
 	}
 
-	/* "start" sub-command */
-	if (StrStartsWithIgnoreCase(argv[1], "sta")) {
+	/* "start" and "aggregate" sub-commands */
+	if (StrStartsWithIgnoreCase(argv[1], "sta") || StrStartsWithIgnoreCase(argv[1], "agg")) {
+		bool aggregate = StrStartsWithIgnoreCase(argv[1], "agg");
 		std::string grfids;
 		size_t started = 0;
 		for (NewGRFProfiler &pr : _newgrf_profilers) {
 			if (!pr.active) {
-				pr.Start();
+				pr.Start(aggregate);
 				started++;
 
 				if (!grfids.empty()) grfids += ", ";
@@ -2494,6 +2566,18 @@ DEF_CONSOLE_CMD(ConNewGRFProfile)
 		return true;
 	}
 
+	/* "summary" sub-command */
+	if (StrStartsWithIgnoreCase(argv[1], "sum")) {
+		bool any = false;
+		for (const NewGRFProfiler &pr : _newgrf_profilers) {
+			if (!pr.active || !pr.aggregate) continue;
+			pr.PrintStats();
+			any = true;
+		}
+		if (!any) IConsolePrint(CC_ERROR, "No GRFs are being profiled with 'aggregate'.");
+		return true;
+	}
+
 	/* "stop" sub-command */
 	if (StrStartsWithIgnoreCase(argv[1], "sto")) {
 		NewGRFProfiler::FinishAll();
@@ -2536,6 +2620,170 @@ DEF_CONSOLE_CMD(ConFramerate)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConTrace)
+{
+	if (argc != 2) {
+		IConsolePrint(CC_HELP, "Record where the time goes in the game loop, pathfinders, window drawing and saving. Sub-commands can be abbreviated.");
+		IConsolePrint(CC_HELP, "Usage: 'trace start':");
+		IConsolePrint(CC_HELP, "  Begin recording. Every thread keeps its most recent events.");
+		IConsolePrint(CC_HELP, "Usage: 'trace stop':");
+		IConsolePrint(CC_HELP, "  End recording and write the events to a JSON file, to be opened with chrome://tracing or ui.perfetto.dev.");
+		IConsolePrint(CC_HELP, "Usage: 'trace abort':");
+		IConsolePrint(CC_HELP, "  End recording and discard the events.");
+		return true;
+	}
+
+	if (StrStartsWithIgnoreCase(argv[1], "sta")) {
+		StartTrace();
+		IConsolePrint(CC_DEBUG, "Started recording trace events.");
+		return true;
+	}
+
+	if (StrStartsWithIgnoreCase(argv[1], "sto")) {
+		if (!_trace_active) {
+			IConsolePrint(CC_ERROR, "No trace is being recorded.");
+			return true;
+		}
+		std::string filename = StopTrace();
+		if (filename.empty()) {
+			IConsolePrint(CC_ERROR, "Could not write the trace events.");
+		} else {
+			IConsolePrint(CC_DEBUG, "Wrote the trace events to '{}'.", filename);
+		}
+		return true;
+	}
+
+	if (StrStartsWithIgnoreCase(argv[1], "abo")) {
+		AbortTrace();
+		return true;
+	}
+
+	return false;
+}
+
+DEF_CONSOLE_CMD(ConPathfinderStats)
+{
+	if (argc == 0 || argc > 2) {
+		IConsolePrint(CC_HELP, "Show how much the pathfinder searched since the start or the last reset, and the slowest searches.");
+		IConsolePrint(CC_HELP, "Usage: 'pathfinder_stats [reset]'.");
+		IConsolePrint(CC_HELP, "Searches are only counted while the yapf debug level is at least {}, see 'debug_level'.", YAPF_STATS_DEBUG_LEVEL);
+		return true;
+	}
+
+	if (argc == 2) {
+		if (!StrEqualsIgnoreCase(argv[1], "reset")) return false;
+		ResetYapfSearchStats();
+		IConsolePrint(CC_DEBUG, "Pathfinder statistics reset.");
+		return true;
+	}
+
+	static const char * const type_names[] = { "Trains", "Road vehicles", "Ships" };
+	static_assert(std::size(type_names) == YAPF_STATS_TYPES);
+
+	if (_debug_yapf_level < YAPF_STATS_DEBUG_LEVEL) {
+		IConsolePrint(CC_WARNING, "Searches are not being counted; set the yapf debug level to at least {} to count them.", YAPF_STATS_DEBUG_LEVEL);
+	}
+
+	for (uint type = 0; type < YAPF_STATS_TYPES; type++) {
+		YapfSearchStats stats = GetYapfSearchStats(static_cast<VehicleType>(type));
+		if (stats.searches == 0) {
+			IConsolePrint(CC_DEFAULT, "{}: no searches", type_names[type]);
+			continue;
+		}
+		uint64_t lookups = stats.cache_hits + stats.cache_misses;
+		IConsolePrint(CC_DEFAULT, "{}: {} searches, {} nodes, {:.1f}% cache hits, {} us average, {} us maximum",
+			type_names[type], stats.searches, stats.nodes, lookups == 0 ? 0.0 : 100.0 * stats.cache_hits / lookups,
+			stats.total_us / stats.searches, stats.max_us);
+	}
+
+	std::vector<YapfSlowSearch> slow_searches = GetYapfSlowSearches();
+	if (slow_searches.empty()) return true;
+
+	IConsolePrint(CC_DEFAULT, "Slowest searches:");
+	for (const YapfSlowSearch &search : slow_searches) {
+		auto tile = [](TileIndex t) { return IsValidTile(t) ? fmt::format("{}x{}", TileX(t), TileY(t)) : std::string("-"); };
+		IConsolePrint(CC_DEFAULT, "  {} us, {} nodes: vehicle {} from {} to {}",
+			search.us, search.nodes, search.vehicle, tile(search.origin), tile(search.destination));
+	}
+	return true;
+}
+
+DEF_CONSOLE_CMD(ConPoolStats)
+{
+	if (argc != 1) {
+		IConsolePrint(CC_HELP, "Show how many items each pool holds and how many it allocated and freed since the start.");
+		IConsolePrint(CC_HELP, "Usage: 'pool_stats'.");
+		return true;
+	}
+
+	for (const PoolBase *pool : *PoolBase::GetPools()) {
+		PoolStats stats = pool->GetStats();
+		IConsolePrint(CC_DEFAULT, "{}: {} items, {} indices used, room for {}; {} allocated, {} freed",
+			stats.name, stats.items, stats.first_unused, stats.size, stats.allocated, stats.freed);
+		if (stats.chunks != 0) {
+			IConsolePrint(CC_DEFAULT, "  stored in place in {} chunks of {} KiB in total", stats.chunks, stats.chunk_bytes / 1024);
+		}
+	}
+	return true;
+}
+
+DEF_CONSOLE_CMD(ConMemoryUsage)
+{
+	if (argc != 1) {
+		IConsolePrint(CC_HELP, "Show an estimate of the memory used by the map, the pools, the caches, the link graph jobs and the scripts.");
+		IConsolePrint(CC_HELP, "Usage: 'memory_usage'.");
+		return true;
+	}
+
+	auto kib = [](size_t bytes) { return (bytes + 1023) / 1024; };
+	size_t total = 0;
+
+	size_t map = Map::MemoryUsage();
+	IConsolePrint(CC_DEFAULT, "Map: {} KiB for {} tiles", kib(map), Map::Size());
+	total += map;
+
+	IConsolePrint(CC_DEFAULT, "Pools:");
+	for (const PoolBase *pool : *PoolBase::GetPools()) {
+		PoolStats stats = pool->GetStats();
+		/* Pools storing their items in place allocate whole chunks, other pools allocate every item separately. */
+		size_t items = stats.chunks != 0 ? stats.chunk_bytes : stats.items * stats.item_size;
+		size_t bytes = items + stats.size * sizeof(void *) + stats.size / CHAR_BIT;
+		if (bytes == 0) continue;
+		IConsolePrint(CC_DEFAULT, "  {}: {} KiB for {} items of {} bytes", stats.name, kib(bytes), stats.items, stats.item_size);
+		total += bytes;
+	}
+
+	size_t jobs = 0;
+	for (const LinkGraphJob *job : LinkGraphJob::Iterate()) jobs += job->MemoryUsage();
+	IConsolePrint(CC_DEFAULT, "Link graph jobs: {} KiB for {} jobs", kib(jobs), LinkGraphJob::GetNumItems());
+	total += jobs;
+
+	const SpriteCacheStatistics &sprites = GetSpriteCacheStatistics();
+	IConsolePrint(CC_DEFAULT, "Sprite cache: {} KiB of {} KiB", kib(sprites.usage), kib(sprites.budget));
+	total += sprites.usage;
+
+	size_t lines = Layouter::GetLineCacheStatistics().size;
+	IConsolePrint(CC_DEFAULT, "Text layout cache: {} KiB", kib(lines));
+	total += lines;
+
+	size_t scripts = 0;
+	if (Game::GetInstance() != nullptr) {
+		size_t bytes = Game::GetInstance()->GetAllocatedMemory();
+		IConsolePrint(CC_DEFAULT, "Game script: {} KiB", kib(bytes));
+		scripts += bytes;
+	}
+	for (const Company *c : Company::Iterate()) {
+		if (!c->is_ai || c->ai_instance == nullptr) continue;
+		size_t bytes = c->ai_instance->GetAllocatedMemory();
+		IConsolePrint(CC_DEFAULT, "AI of company {}: {} KiB", c->index + 1, kib(bytes));
+		scripts += bytes;
+	}
+	total += scripts;
+
+	IConsolePrint(CC_DEFAULT, "Total: {} KiB; memory owned by pool items, such as orders lists and cargo lists, is not included", kib(total));
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConFramerateWindow)
 {
 	if (argc == 0) {
@@ -2677,12 +2925,49 @@ static void ConDumpCargoTypes()
 }
 
 
+/**
+ * Print the distribution of the chain lengths of the vehicle tile hash.
+ */
+static void ConDumpVehicleHash()
+{
+	uint bits;
+	std::vector<size_t> lengths = GetVehicleTileHashChainLengths(bits);
+
+	size_t buckets = 0;
+	size_t vehicles = 0;
+	for (size_t length = 0; length < lengths.size(); length++) {
+		buckets += lengths[length];
+		vehicles += lengths[length] * length;
+	}
+	IConsolePrint(CC_DEFAULT, "Vehicle tile hash: {} x {} buckets, {} vehicles, longest chain {}", 1 << bits, 1 << bits, vehicles, lengths.empty() ? 0 : lengths.size() - 1);
+
+	/* Group the lengths by powers of two: 0, 1, 2-3, 4-7, ... */
+	for (size_t first = 0; first < lengths.size(); first = std::max<size_t>(first * 2, first + 1)) {
+		size_t last = std::min(std::max<size_t>(first * 2, first + 1), lengths.size()) - 1;
+		size_t count = 0;
+		for (size_t length = first; length <= last; length++) count += lengths[length];
+		if (count == 0) continue;
+
+		if (first == last) {
+			IConsolePrint(CC_DEFAULT, "  length {:>5}: {:>8} buckets ({:.1f}%)", first, count, 100.0 * count / buckets);
+		} else {
+			IConsolePrint(CC_DEFAULT, "  length {:>2}-{:<5}: {:>8} buckets ({:.1f}%)", first, last, count, 100.0 * count / buckets);
+		}
+	}
+}
+
 DEF_CONSOLE_CMD(ConDumpInfo)
 {
 	if (argc != 2) {
 		IConsolePrint(CC_HELP, "Dump debugging information.");
-		IConsolePrint(CC_HELP, "Usage: 'dump_info roadtypes|railtypes|cargotypes'.");
-		IConsolePrint(CC_HELP, "  Show information about road/tram types, rail types or cargo types.");
+		IConsolePrint(CC_HELP, "Usage: 'dump_info roadtypes|railtypes|cargotypes|vehiclehash'.");
+		IConsolePrint(CC_HELP, "  Show information about road/tram types, rail types or cargo types,");
+		IConsolePrint(CC_HELP, "  or the distribution of the chain lengths of the vehicle tile hash.");
+		return true;
+	}
+
+	if (StrEqualsIgnoreCase(argv[1], "vehiclehash")) {
+		ConDumpVehicleHash();
 		return true;
 	}
 
@@ -2772,6 +3057,7 @@ void IConsoleStdLibRegister()
 	IConsole::CmdRegister("rescan_ai",               ConRescanAI);
 	IConsole::CmdRegister("start_ai",                ConStartAI);
 	IConsole::CmdRegister("stop_ai",                 ConStopAI);
+	IConsole::CmdRegister("script_profile",          ConScriptProfile);
 
 	IConsole::CmdRegister("list_game",               ConListGame);
 	IConsole::CmdRegister("list_game_libs",          ConListGameLibs);
@@ -2847,6 +3133,10 @@ void IConsoleStdLibRegister()
 #endif
 	IConsole::CmdRegister("fps",                     ConFramerate);
 	IConsole::CmdRegister("fps_wnd",                 ConFramerateWindow);
+	IConsole::CmdRegister("trace",                   ConTrace);
+	IConsole::CmdRegister("pathfinder_stats",        ConPathfinderStats);
+	IConsole::CmdRegister("pool_stats",              ConPoolStats);
+	IConsole::CmdRegister("memory_usage",            ConMemoryUsage);
 
 	/* NewGRF development stuff */
 	IConsole::CmdRegister("reload_newgrfs",          ConNewGRFReload,     ConHookNewGRFDeveloperTool);
@@ -0,0 +1,503 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file flathashmap_type.hpp Unordered map with open addressing in one flat table. */
+
+#ifndef FLATHASHMAP_TYPE_HPP
+#define FLATHASHMAP_TYPE_HPP
+
+#include "bitmath_func.hpp"
+
+/**
+ * Default hash of #FlatHashMap. Integers and enums are mixed with a fixed
+ * function, so the hash, and with it the iteration order of the map, is the
+ * same on every platform and compiler. Other types use std::hash, whose
+ * result may differ between standard libraries.
+ * @tparam T Key type.
+ */
+template <typename T>
+struct FlatHashMapHash {
+	/**
+	 * Hash a key.
+	 * @param key The key.
+	 * @return The hash.
+	 */
+	inline uint64_t operator()(const T &key) const
+	{
+		uint64_t h;
+		if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+			h = static_cast<uint64_t>(key);
+		} else {
+			h = std::hash<T>{}(key);
+		}
+		/* Finalizer of MurmurHash3, so all bits of the key affect the low and the high bits. */
+		h ^= h >> 33;
+		h *= 0xFF51AFD7ED558CCD;
+		h ^= h >> 33;
+		h *= 0xC4CEB9FE1A85EC53;
+		h ^= h >> 33;
+		return h;
+	}
+};
+
+/**
+ * Unordered map that keeps its items in one flat table with open addressing.
+ * Next to the table there is one control byte per slot, holding 7 bits of the
+ * hash of the item in it, or whether the slot is empty or deleted. A lookup
+ * checks the control bytes of a group of 8 slots at once with bit operations
+ * on a 64 bit word, and only compares the keys of the slots whose 7 bits match.
+ * Groups are probed quadratically until a group with an empty slot is found.
+ *
+ * The iteration order is the order of the slots. It only depends on the hash
+ * of the keys and the sequence of insertions and erasures, not on addresses
+ * or on a random seed, so with #FlatHashMapHash it is the same on all clients.
+ * Still, it is unrelated to the order of the keys; use std::map or #FlatMap
+ * when the game state depends on iterating in key order.
+ *
+ * Inserting may rehash the table, which invalidates iterators and pointers to
+ * the items. Erasing only invalidates iterators to the erased item.
+ * @tparam Tkey Key type; must be comparable with operator==.
+ * @tparam Tvalue Value type.
+ * @tparam Thash Hash of the keys.
+ */
+template <typename Tkey, typename Tvalue, typename Thash = FlatHashMapHash<Tkey>>
+class FlatHashMap {
+public:
+	typedef std::pair<const Tkey, Tvalue> value_type;
+
+private:
+	static constexpr size_t GROUP_WIDTH = 8;  ///< Number of slots whose control bytes are checked at once.
+	static constexpr uint8_t CTRL_EMPTY = 0x80;   ///< Control byte of a slot that was never used since the last rehash.
+	static constexpr uint8_t CTRL_DELETED = 0xFE; ///< Control byte of a slot whose item was erased.
+	static constexpr uint64_t LSBS = 0x0101010101010101; ///< Lowest bit of every control byte in a group.
+	static constexpr uint64_t MSBS = 0x8080808080808080; ///< Highest bit of every control byte in a group.
+
+	/** Storage for one item, which is only constructed while the slot is in use. */
+	union Slot {
+		value_type item; ///< The item.
+
+		Slot() {}
+		~Slot() {}
+	};
+
+	std::unique_ptr<uint8_t[]> ctrl; ///< Control byte of every slot.
+	std::unique_ptr<Slot[]> slots;   ///< The slots.
+	size_t capacity = 0;             ///< Number of slots; zero or a power of two of at least #GROUP_WIDTH.
+	size_t num_items = 0;            ///< Number of items.
+	size_t growth_left = 0;          ///< Number of empty slots that may still be filled before rehashing.
+	[[no_unique_address]] Thash hasher; ///< The hash function.
+
+	/**
+	 * Get the part of the hash that selects the group to start probing at.
+	 * @param hash The hash.
+	 * @return The first part of the hash.
+	 */
+	static inline size_t H1(uint64_t hash) { return static_cast<size_t>(hash >> 7); }
+
+	/**
+	 * Get the part of the hash that is stored in the control byte.
+	 * @param hash The hash.
+	 * @return The 7 bits of the hash for the control byte.
+	 */
+	static inline uint8_t H2(uint64_t hash) { return static_cast<uint8_t>(hash & 0x7F); }
+
+	/**
+	 * Load the control bytes of a group into one word, first slot in the lowest byte.
+	 * Compilers turn this into a single load on little endian machines.
+	 * @param pos First slot of the group.
+	 * @return The control bytes.
+	 */
+	inline uint64_t LoadGroup(size_t pos) const
+	{
+		const uint8_t *c = this->ctrl.get() + pos;
+		return static_cast<uint64_t>(c[0]) | static_cast<uint64_t>(c[1]) << 8 | static_cast<uint64_t>(c[2]) << 16 | static_cast<uint64_t>(c[3]) << 24 |
+				static_cast<uint64_t>(c[4]) << 32 | static_cast<uint64_t>(c[5]) << 40 | static_cast<uint64_t>(c[6]) << 48 | static_cast<uint64_t>(c[7]) << 56;
+	}
+
+	/**
+	 * Find the slots of a group whose control byte equals the given 7 bits of a hash.
+	 * This can report a few slots that do not match, but never misses one.
+	 * @param group The control bytes of the group.
+	 * @param h2 The 7 bits.
+	 * @return The highest bit of the control byte of every matching slot.
+	 */
+	static inline uint64_t MatchH2(uint64_t group, uint8_t h2)
+	{
+		uint64_t x = group ^ (LSBS * h2);
+		return (x - LSBS) & ~x & MSBS;
+	}
+
+	/**
+	 * Find the empty slots of a group.
+	 * @param group The control bytes of the group.
+	 * @return The highest bit of the control byte of every empty slot.
+	 */
+	static inline uint64_t MatchEmpty(uint64_t group)
+	{
+		/* Empty is the only control byte with the highest bit set and the second lowest bit cleared. */
+		return group & (~group << 6) & MSBS;
+	}
+
+	/**
+	 * Find the empty and deleted slots of a group.
+	 * @param group The control bytes of the group.
+	 * @return The highest bit of the control byte of every empty or deleted slot.
+	 */
+	static inline uint64_t MatchEmptyOrDeleted(uint64_t group)
+	{
+		return group & MSBS;
+	}
+
+	/**
+	 * Get the slot of the lowest match in a group.
+	 * @param match The matches, see #MatchH2.
+	 * @return Offset of the slot in the group.
+	 */
+	static inline size_t LowestMatch(uint64_t match)
+	{
+		return FindFirstBit(match) / 8;
+	}
+
+	/**
+	 * Find the slot of a key.
+	 * @param key The key.
+	 * @param hash The hash of the key.
+	 * @return The slot, or #capacity if the key is not in the map.
+	 */
+	size_t FindSlot(const Tkey &key, uint64_t hash) const
+	{
+		if (this->capacity == 0) return 0;
+
+		size_t mask = this->capacity - 1;
+		size_t pos = (H1(hash) * GROUP_WIDTH) & mask;
+		for (size_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+			uint64_t group = this->LoadGroup(pos);
+			for (uint64_t match = MatchH2(group, H2(hash)); match != 0; match &= match - 1) {
+				size_t slot = pos + LowestMatch(match);
+				if (this->ctrl[slot] == H2(hash) && this->slots[slot].item.first == key) return slot;
+			}
+			if (MatchEmpty(group) != 0) return this->capacity;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	/**
+	 * Find the first empty or deleted slot on the probe sequence of a hash.
+	 * @param hash The hash.
+	 * @return The slot.
+	 */
+	size_t FindFreeSlot(uint64_t hash) const
+	{
+		size_t mask = this->capacity - 1;
+		size_t pos = (H1(hash) * GROUP_WIDTH) & mask;
+		for (size_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+			uint64_t match = MatchEmptyOrDeleted(this->LoadGroup(pos));
+			if (match != 0) return pos + LowestMatch(match);
+			pos = (pos + step) & mask;
+		}
+	}
+
+	/**
+	 * Get the number of items a table of the given size may hold before it is rehashed.
+	 * @param capacity Number of slots.
+	 * @return Maximum number of items, 7/8 of the slots.
+	 */
+	static inline size_t MaxLoad(size_t capacity)
+	{
+		return capacity - capacity / 8;
+	}
+
+	/**
+	 * Move all items to a new table.
+	 * @param new_capacity Number of slots of the new table.
+	 */
+	void Rehash(size_t new_capacity)
+	{
+		std::unique_ptr<uint8_t[]> old_ctrl = std::move(this->ctrl);
+		std::unique_ptr<Slot[]> old_slots = std::move(this->slots);
+		size_t old_capacity = this->capacity;
+
+		this->ctrl = std::make_unique<uint8_t[]>(new_capacity);
+		std::fill_n(this->ctrl.get(), new_capacity, CTRL_EMPTY);
+		this->slots = std::make_unique<Slot[]>(new_capacity);
+		this->capacity = new_capacity;
+		this->growth_left = MaxLoad(new_capacity) - this->num_items;
+
+		for (size_t i = 0; i < old_capacity; i++) {
+			if ((old_ctrl[i] & CTRL_EMPTY) != 0) continue;
+			uint64_t hash = this->hasher(old_slots[i].item.first);
+			size_t slot = this->FindFreeSlot(hash);
+			this->ctrl[slot] = H2(hash);
+			new (&this->slots[slot].item) value_type(std::move(old_slots[i].item));
+			old_slots[i].item.~value_type();
+		}
+	}
+
+	/**
+	 * Find the slot of a key, or claim a free slot for it.
+	 * @param key The key.
+	 * @return The slot, and whether it is newly claimed; then the caller must construct the item in it.
+	 */
+	std::pair<size_t, bool> FindOrPrepareInsert(const Tkey &key)
+	{
+		uint64_t hash = this->hasher(key);
+		size_t slot = this->FindSlot(key, hash);
+		if (slot < this->capacity) return { slot, false };
+
+		if (this->growth_left == 0) {
+			/* When many slots are deleted, rehashing at the same size is enough to free them. */
+			size_t new_capacity = std::max(this->capacity, GROUP_WIDTH);
+			if (this->num_items + 1 > MaxLoad(new_capacity) / 2) new_capacity *= 2;
+			this->Rehash(new_capacity);
+		}
+
+		slot = this->FindFreeSlot(hash);
+		if (this->ctrl[slot] == CTRL_EMPTY) this->growth_left--;
+		this->ctrl[slot] = H2(hash);
+		this->num_items++;
+		return { slot, true };
+	}
+
+	/**
+	 * Destroy the item in a slot and mark the slot free.
+	 * @param slot The slot.
+	 */
+	void EraseSlot(size_t slot)
+	{
+		this->slots[slot].item.~value_type();
+		this->num_items--;
+
+		/* A slot in a group that has never been full can become empty again, as no probe sequence continues past that group. */
+		size_t group = slot & ~(GROUP_WIDTH - 1);
+		if (MatchEmpty(this->LoadGroup(group)) != 0) {
+			this->ctrl[slot] = CTRL_EMPTY;
+			this->growth_left++;
+		} else {
+			this->ctrl[slot] = CTRL_DELETED;
+		}
+	}
+
+public:
+	/** Iterator over the items, in the order of the slots. */
+	template <bool Tconst>
+	class Iterator {
+		friend class FlatHashMap;
+		using Map = std::conditional_t<Tconst, const FlatHashMap, FlatHashMap>;
+
+		Map *map;    ///< The map.
+		size_t slot; ///< The slot of the item; the capacity of the map at the end.
+
+		/** Move to the first used slot from the current slot on. */
+		inline void SkipFree()
+		{
+			while (this->slot < this->map->capacity && (this->map->ctrl[this->slot] & CTRL_EMPTY) != 0) this->slot++;
+		}
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using value_type = FlatHashMap::value_type;
+		using pointer = std::conditional_t<Tconst, const value_type *, value_type *>;
+		using reference = std::conditional_t<Tconst, const value_type &, value_type &>;
+
+		Iterator(Map *map, size_t slot) : map(map), slot(slot) {}
+		/** Conversion of a mutable iterator to a const iterator. */
+		template <bool Tother, typename = std::enable_if_t<Tconst && !Tother>>
+		Iterator(const Iterator<Tother> &other) : map(other.map), slot(other.slot) {}
+
+		inline reference operator*() const { return this->map->slots[this->slot].item; }
+		inline pointer operator->() const { return &this->map->slots[this->slot].item; }
+		inline bool operator==(const Iterator &other) const { return this->slot == other.slot; }
+		inline bool operator!=(const Iterator &other) const { return this->slot != other.slot; }
+
+		inline Iterator &operator++()
+		{
+			this->slot++;
+			this->SkipFree();
+			return *this;
+		}
+
+		inline Iterator operator++(int)
+		{
+			Iterator result = *this;
+			++*this;
+			return result;
+		}
+
+		template <bool> friend class Iterator;
+	};
+
+	typedef Iterator<false> iterator;
+	typedef Iterator<true> const_iterator;
+
+	FlatHashMap() = default;
+
+	FlatHashMap(const FlatHashMap &other)
+	{
+		this->reserve(other.num_items);
+		for (const value_type &item : other) this->insert(item);
+	}
+
+	FlatHashMap(FlatHashMap &&other) noexcept
+	{
+		this->swap(other);
+	}
+
+	FlatHashMap &operator=(FlatHashMap other)
+	{
+		this->swap(other);
+		return *this;
+	}
+
+	~FlatHashMap()
+	{
+		this->clear();
+	}
+
+	inline iterator begin() { iterator it(this, 0); it.SkipFree(); return it; }
+	inline iterator end() { return iterator(this, this->capacity); }
+	inline const_iterator begin() const { const_iterator it(this, 0); it.SkipFree(); return it; }
+	inline const_iterator end() const { return const_iterator(this, this->capacity); }
+
+	inline bool empty() const { return this->num_items == 0; }
+	inline size_t size() const { return this->num_items; }
+
+	/** Remove all items, but keep the table. */
+	void clear()
+	{
+		if (this->num_items == 0 && this->growth_left == MaxLoad(this->capacity)) return;
+		for (size_t i = 0; i < this->capacity; i++) {
+			if ((this->ctrl[i] & CTRL_EMPTY) == 0) this->slots[i].item.~value_type();
+		}
+		if (this->capacity != 0) std::fill_n(this->ctrl.get(), this->capacity, CTRL_EMPTY);
+		this->num_items = 0;
+		this->growth_left = MaxLoad(this->capacity);
+	}
+
+	/**
+	 * Swap the contents with another map.
+	 * @param other The other map.
+	 */
+	void swap(FlatHashMap &other) noexcept
+	{
+		std::swap(this->ctrl, other.ctrl);
+		std::swap(this->slots, other.slots);
+		std::swap(this->capacity, other.capacity);
+		std::swap(this->num_items, other.num_items);
+		std::swap(this->growth_left, other.growth_left);
+		std::swap(this->hasher, other.hasher);
+	}
+
+	/**
+	 * Make room for the given number of items without rehashing.
+	 * @param n Number of items.
+	 */
+	void reserve(size_t n)
+	{
+		size_t new_capacity = GROUP_WIDTH;
+		while (MaxLoad(new_capacity) < n) new_capacity *= 2;
+		if (new_capacity > this->capacity) this->Rehash(new_capacity);
+	}
+
+	/**
+	 * Find the item with the given key.
+	 * @param key Key to look for.
+	 * @return Iterator to the item, or end() if there is none.
+	 */
+	inline iterator find(const Tkey &key)
+	{
+		return iterator(this, this->FindSlot(key, this->hasher(key)));
+	}
+
+	/** @copydoc find(const Tkey &) */
+	inline const_iterator find(const Tkey &key) const
+	{
+		return const_iterator(this, this->FindSlot(key, this->hasher(key)));
+	}
+
+	/**
+	 * Check whether there is an item with the given key.
+	 * @param key Key to look for.
+	 * @return True if there is such an item.
+	 */
+	inline bool contains(const Tkey &key) const
+	{
+		return this->FindSlot(key, this->hasher(key)) < this->capacity;
+	}
+
+	/**
+	 * Count the items with the given key.
+	 * @param key Key to look for.
+	 * @return 1 if there is such an item, else 0.
+	 */
+	inline size_t count(const Tkey &key) const
+	{
+		return this->contains(key) ? 1 : 0;
+	}
+
+	/**
+	 * Insert an item unless an item with the same key exists already.
+	 * @param key Key of the item.
+	 * @param args Arguments to construct the value with.
+	 * @return Iterator to the item with the key, and whether the item was inserted.
+	 */
+	template <typename... Targs>
+	std::pair<iterator, bool> try_emplace(const Tkey &key, Targs &&... args)
+	{
+		auto [slot, inserted] = this->FindOrPrepareInsert(key);
+		if (inserted) new (&this->slots[slot].item) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Targs>(args)...));
+		return { iterator(this, slot), inserted };
+	}
+
+	/**
+	 * Insert an item unless an item with the same key exists already.
+	 * @param item Item to insert.
+	 * @return Iterator to the item with the key, and whether the item was inserted.
+	 */
+	inline std::pair<iterator, bool> insert(const value_type &item)
+	{
+		return this->try_emplace(item.first, item.second);
+	}
+
+	/**
+	 * Get the value of the item with the given key, inserting a default constructed one if needed.
+	 * @param key Key of the item.
+	 * @return Value of the item.
+	 */
+	inline Tvalue &operator[](const Tkey &key)
+	{
+		return this->try_emplace(key).first->second;
+	}
+
+	/**
+	 * Erase an item.
+	 * @param it Iterator to the item.
+	 * @return Iterator to the item following the erased one.
+	 */
+	iterator erase(const_iterator it)
+	{
+		this->EraseSlot(it.slot);
+		iterator next(this, it.slot);
+		next.SkipFree();
+		return next;
+	}
+
+	/**
+	 * Erase the item with the given key, if there is one.
+	 * @param key Key of the item.
+	 * @return Number of erased items.
+	 */
+	size_t erase(const Tkey &key)
+	{
+		size_t slot = this->FindSlot(key, this->hasher(key));
+		if (slot >= this->capacity) return 0;
+		this->EraseSlot(slot);
+		return 1;
+	}
+};
+
+#endif /* FLATHASHMAP_TYPE_HPP */
@@ -0,0 +1,168 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file flatmap_type.hpp Ordered map stored in a sorted vector. */
+
+#ifndef FLATMAP_TYPE_HPP
+#define FLATMAP_TYPE_HPP
+
+/**
+ * Ordered map that keeps its items sorted by key in one contiguous vector.
+ * Lookups are binary searches and iterating is a linear walk over memory,
+ * which is a lot cheaper than chasing the nodes of a std::map for the small
+ * maps this is meant for. Inserting or erasing in the middle moves the items
+ * behind it, and like with std::vector this invalidates iterators and
+ * pointers to the items; appending a key larger than all others is cheap.
+ * @tparam Tkey Key type; must be ordered by operator<.
+ * @tparam Tvalue Value type.
+ */
+template <typename Tkey, typename Tvalue>
+class FlatMap {
+public:
+	typedef std::pair<Tkey, Tvalue> value_type;
+	typedef typename std::vector<value_type>::iterator iterator;
+	typedef typename std::vector<value_type>::const_iterator const_iterator;
+	typedef typename std::vector<value_type>::reverse_iterator reverse_iterator;
+	typedef typename std::vector<value_type>::const_reverse_iterator const_reverse_iterator;
+
+	inline iterator begin() { return this->items.begin(); }
+	inline iterator end() { return this->items.end(); }
+	inline const_iterator begin() const { return this->items.begin(); }
+	inline const_iterator end() const { return this->items.end(); }
+	inline reverse_iterator rbegin() { return this->items.rbegin(); }
+	inline reverse_iterator rend() { return this->items.rend(); }
+	inline const_reverse_iterator rbegin() const { return this->items.rbegin(); }
+	inline const_reverse_iterator rend() const { return this->items.rend(); }
+
+	inline bool empty() const { return this->items.empty(); }
+	inline size_t size() const { return this->items.size(); }
+	inline void clear() { this->items.clear(); }
+	inline void swap(FlatMap &other) { this->items.swap(other.items); }
+
+	/**
+	 * Find the first item with a key not less than the given one.
+	 * @param key Key to look for.
+	 * @return Iterator to the item, or end().
+	 */
+	inline iterator lower_bound(const Tkey &key)
+	{
+		return std::lower_bound(this->items.begin(), this->items.end(), key, [](const value_type &item, const Tkey &key) { return item.first < key; });
+	}
+
+	/** @copydoc lower_bound(const Tkey &) */
+	inline const_iterator lower_bound(const Tkey &key) const
+	{
+		return std::lower_bound(this->items.begin(), this->items.end(), key, [](const value_type &item, const Tkey &key) { return item.first < key; });
+	}
+
+	/**
+	 * Find the first item with a key greater than the given one.
+	 * @param key Key to look for.
+	 * @return Iterator to the item, or end().
+	 */
+	inline iterator upper_bound(const Tkey &key)
+	{
+		return std::upper_bound(this->items.begin(), this->items.end(), key, [](const Tkey &key, const value_type &item) { return key < item.first; });
+	}
+
+	/** @copydoc upper_bound(const Tkey &) */
+	inline const_iterator upper_bound(const Tkey &key) const
+	{
+		return std::upper_bound(this->items.begin(), this->items.end(), key, [](const Tkey &key, const value_type &item) { return key < item.first; });
+	}
+
+	/**
+	 * Find the item with the given key.
+	 * @param key Key to look for.
+	 * @return Iterator to the item, or end() if there is none.
+	 */
+	inline iterator find(const Tkey &key)
+	{
+		iterator it = this->lower_bound(key);
+		return (it != this->items.end() && !(key < it->first)) ? it : this->items.end();
+	}
+
+	/** @copydoc find(const Tkey &) */
+	inline const_iterator find(const Tkey &key) const
+	{
+		const_iterator it = this->lower_bound(key);
+		return (it != this->items.end() && !(key < it->first)) ? it : this->items.end();
+	}
+
+	/**
+	 * Insert an item unless an item with the same key exists already.
+	 * @param item Item to insert.
+	 * @return Iterator to the item with the key, and whether the item was inserted.
+	 */
+	std::pair<iterator, bool> insert(const value_type &item)
+	{
+		if (this->items.empty() || this->items.back().first < item.first) {
+			this->items.push_back(item);
+			return { std::prev(this->items.end()), true };
+		}
+		iterator it = this->lower_bound(item.first);
+		if (!(item.first < it->first)) return { it, false };
+		return { this->items.insert(it, item), true };
+	}
+
+	/**
+	 * Insert a range of items, skipping the ones whose key exists already.
+	 * @param first Begin of the range.
+	 * @param last End of the range.
+	 */
+	template <class Titer>
+	void insert(Titer first, Titer last)
+	{
+		size_t old_size = this->items.size();
+		this->items.insert(this->items.end(), first, last);
+		auto less = [](const value_type &a, const value_type &b) { return a.first < b.first; };
+		std::stable_sort(this->items.begin() + old_size, this->items.end(), less);
+		std::inplace_merge(this->items.begin(), this->items.begin() + old_size, this->items.end(), less);
+		/* The merge is stable, so of items with equal keys the one that was there first is kept. */
+		this->items.erase(std::unique(this->items.begin(), this->items.end(), [](const value_type &a, const value_type &b) { return !(a.first < b.first) && !(b.first < a.first); }), this->items.end());
+	}
+
+	/**
+	 * Get the value of the item with the given key, inserting a default constructed one if needed.
+	 * @param key Key of the item.
+	 * @return Value of the item.
+	 */
+	Tvalue &operator[](const Tkey &key)
+	{
+		if (this->items.empty() || this->items.back().first < key) {
+			return this->items.emplace_back(key, Tvalue{}).second;
+		}
+		iterator it = this->lower_bound(key);
+		if (key < it->first) it = this->items.emplace(it, key, Tvalue{});
+		return it->second;
+	}
+
+	/**
+	 * Erase an item.
+	 * @param it Iterator to the item.
+	 * @return Iterator to the item following the erased one.
+	 */
+	inline iterator erase(const_iterator it) { return this->items.erase(it); }
+
+	/**
+	 * Erase the item with the given key, if there is one.
+	 * @param key Key of the item.
+	 * @return Number of erased items.
+	 */
+	size_t erase(const Tkey &key)
+	{
+		iterator it = this->find(key);
+		if (it == this->items.end()) return 0;
+		this->items.erase(it);
+		return 1;
+	}
+
+private:
+	std::vector<value_type> items; ///< The items, sorted by key.
+};
+
+#endif /* FLATMAP_TYPE_HPP */
@@ -11,6 +11,7 @@
 #define KDTREE_HPP
 
 #include "../stdafx.h"
+#include "bitmath_func.hpp"
 
 /**
  * K-dimensional tree, specialised for 2-dimensional space.
@@ -86,6 +87,8 @@ class Kdtree {
 		} else if (count > 1) {
 			CoordT split_coord = SelectSplitCoord(begin, end, level);
 			It split = std::partition(begin, end, [&](T v) { return this->xyfunc(v, level % 2) < split_coord; });
+			/* The splitting element must be the smallest one on the right side, or the right sub-tree would contain elements below the split. */
+			std::iter_swap(split, std::min_element(split, end, [&](T a, T b) { return this->xyfunc(a, level % 2) < this->xyfunc(b, level % 2); }));
 			size_t newidx = this->AddNode(*split);
 			this->nodes[newidx].left = this->BuildSubtree(begin, split, level + 1);
 			this->nodes[newidx].right = this->BuildSubtree(split + 1, end, level + 1);
@@ -120,29 +123,80 @@ class Kdtree {
 		return true;
 	}
 
-	/** Insert one element in the tree somewhere below node_idx */
-	void InsertRecursive(const T &element, size_t node_idx, int level)
+	/** Count the number of nodes in the sub-tree starting at node_idx */
+	size_t CountNodes(size_t node_idx) const
 	{
-		/* Dimension index of current level */
-		int dim = level % 2;
-		/* Node reference */
-		node &n = this->nodes[node_idx];
+		if (node_idx == INVALID_NODE) return 0;
+		const node &n = this->nodes[node_idx];
+		return 1 + this->CountNodes(n.left) + this->CountNodes(n.right);
+	}
 
-		/* Coordinate of element splitting at this node */
-		CoordT nc = this->xyfunc(n.element, dim);
-		/* Coordinate of the new element */
-		CoordT ec = this->xyfunc(element, dim);
-		/* Which side to insert on */
-		size_t &next = (ec < nc) ? n.left : n.right;
-
-		if (next == INVALID_NODE) {
-			/* New leaf */
-			size_t newidx = this->AddNode(element);
-			/* Vector may have been reallocated at this point, n and next are invalid */
-			node &nn = this->nodes[node_idx];
-			if (ec < nc) nn.left = newidx; else nn.right = newidx;
-		} else {
-			this->InsertRecursive(element, next, level + 1);
+	/** Get the depth a tree with the given number of elements may grow to before a part of it gets rebuilt */
+	static size_t MaxBalancedDepth(size_t count)
+	{
+		/* Roughly log1.5(count), the depth at which a sub-tree with one side twice as big as the other must exist. */
+		return (FindLastBit(count) + 1) * 7 / 4;
+	}
+
+	/**
+	 * Rebuild a sub-tree so it is fully balanced.
+	 * @param node_idx Root of the sub-tree.
+	 * @param level    Depth of the sub-tree's root in the tree.
+	 * @return New root node index of the sub-tree.
+	 */
+	size_t RebuildSubtree(size_t node_idx, int level)
+	{
+		T element = this->nodes[node_idx].element;
+		std::vector<T> elements = this->FreeSubtree(node_idx);
+		elements.push_back(element);
+		this->free_list.push_back(node_idx);
+		return this->BuildSubtree(elements.begin(), elements.end(), level);
+	}
+
+	/**
+	 * Insert one element in the tree as a new leaf.
+	 * When the leaf ends up too deep, the smallest sub-tree on its path where one side
+	 * holds more than two thirds of the elements is rebuilt. This keeps the tree balanced
+	 * with only partial rebuilds, at an amortised cost of O(log n) per insert.
+	 */
+	void InsertRecursive(const T &element)
+	{
+		/* Nodes from the root to the parent of the new leaf */
+		std::vector<size_t> path;
+		bool left = false;
+		for (size_t node_idx = this->root; node_idx != INVALID_NODE;) {
+			path.push_back(node_idx);
+			const node &n = this->nodes[node_idx];
+			int dim = (path.size() - 1) % 2;
+			left = this->xyfunc(element, dim) < this->xyfunc(n.element, dim);
+			node_idx = left ? n.left : n.right;
+		}
+
+		size_t newidx = this->AddNode(element);
+		/* Vector may have been reallocated at this point, take the reference afterwards */
+		node &parent = this->nodes[path.back()];
+		if (left) parent.left = newidx; else parent.right = newidx;
+
+		if (path.size() <= MaxBalancedDepth(this->Count())) return;
+
+		/* Walk back up to find the node to rebuild */
+		size_t child = newidx;
+		size_t child_size = 1;
+		for (size_t i = path.size(); i-- > 0;) {
+			const node &n = this->nodes[path[i]];
+			size_t size = 1 + child_size + this->CountNodes(n.left == child ? n.right : n.left);
+			if (child_size * 3 > size * 2) {
+				size_t new_branch = this->RebuildSubtree(path[i], (int)i);
+				if (i == 0) {
+					this->root = new_branch;
+				} else {
+					node &pn = this->nodes[path[i - 1]];
+					if (pn.left == path[i]) pn.left = new_branch; else pn.right = new_branch;
+				}
+				return;
+			}
+			child = path[i];
+			child_size = size;
 		}
 	}
 
@@ -228,16 +282,20 @@ class Kdtree {
 	/** A data element and its distance to a searched-for point */
 	using node_distance = std::pair<T, DistT>;
 	/** Ordering function for node_distance objects, elements with equal distance are ordered by less-than comparison */
-	static node_distance SelectNearestNodeDistance(const node_distance &a, const node_distance &b)
+	static bool IsNearer(const node_distance &a, const node_distance &b)
 	{
-		if (a.second < b.second) return a;
-		if (b.second < a.second) return b;
-		if (a.first < b.first) return a;
-		if (b.first < a.first) return b;
-		NOT_REACHED(); // a.first == b.first: same element must not be inserted twice
+		if (a.second != b.second) return a.second < b.second;
+		return a.first < b.first;
 	}
-	/** Search a sub-tree for the element nearest to a given point */
-	node_distance FindNearestRecursive(CoordT xy[2], size_t node_idx, int level, DistT limit = std::numeric_limits<DistT>::max()) const
+
+	/**
+	 * Search a sub-tree for an element nearer to a given point than the best one found so far.
+	 * @param xy       Point to search from.
+	 * @param node_idx Sub-tree to search in.
+	 * @param level    Current depth in the tree.
+	 * @param[in,out] best Nearest element found so far, any element of the tree may be used to start.
+	 */
+	void FindNearestRecursive(const CoordT xy[2], size_t node_idx, int level, node_distance &best) const
 	{
 		/* Dimension index of current level */
 		int dim = level % 2;
@@ -246,29 +304,50 @@ class Kdtree {
 
 		/* Coordinate of element splitting at this node */
 		CoordT c = this->xyfunc(n.element, dim);
-		/* This node's distance to target */
-		DistT thisdist = ManhattanDistance(n.element, xy[0], xy[1]);
-		/* Assume this node is the best choice for now */
-		node_distance best = std::make_pair(n.element, thisdist);
+		node_distance here = std::make_pair(n.element, ManhattanDistance(n.element, xy[0], xy[1]));
+		if (IsNearer(here, best)) best = here;
 
-		/* Next node to visit */
+		/* Search the side of the split the point is on first, it is the most likely to hold a better element */
 		size_t next = (xy[dim] < c) ? n.left : n.right;
-		if (next != INVALID_NODE) {
-			/* Check if there is a better node down the tree */
-			best = SelectNearestNodeDistance(best, this->FindNearestRecursive(xy, next, level + 1));
-		}
-
-		limit = std::min(best.second, limit);
+		if (next != INVALID_NODE) this->FindNearestRecursive(xy, next, level + 1, best);
 
-		/* Check if the distance from current best is worse than distance from target to splitting line,
-		 * if it is we also need to check the other side of the split. */
+		/* Only check the other side of the split if it can be as close as the current best. */
 		size_t opposite = (xy[dim] >= c) ? n.left : n.right; // reverse of above
-		if (opposite != INVALID_NODE && limit >= abs((int)xy[dim] - (int)c)) {
-			node_distance other_candidate = this->FindNearestRecursive(xy, opposite, level + 1, limit);
-			best = SelectNearestNodeDistance(best, other_candidate);
+		if (opposite != INVALID_NODE && best.second >= abs((int)xy[dim] - (int)c)) this->FindNearestRecursive(xy, opposite, level + 1, best);
+	}
+
+	/**
+	 * Search a sub-tree for the k elements nearest to a given point.
+	 * @param xy       Point to search from.
+	 * @param node_idx Sub-tree to search in.
+	 * @param level    Current depth in the tree.
+	 * @param k        Number of elements to find.
+	 * @param[in,out] heap Heap of the nearest elements found so far, with the furthest one on top.
+	 */
+	void FindKNearestRecursive(const CoordT xy[2], size_t node_idx, int level, size_t k, std::vector<node_distance> &heap) const
+	{
+		/* Dimension index of current level */
+		int dim = level % 2;
+		/* Node reference */
+		const node &n = this->nodes[node_idx];
+
+		/* Coordinate of element splitting at this node */
+		CoordT c = this->xyfunc(n.element, dim);
+		node_distance here = std::make_pair(n.element, ManhattanDistance(n.element, xy[0], xy[1]));
+		if (heap.size() < k) {
+			heap.push_back(here);
+			std::push_heap(heap.begin(), heap.end(), IsNearer);
+		} else if (IsNearer(here, heap.front())) {
+			std::pop_heap(heap.begin(), heap.end(), IsNearer);
+			heap.back() = here;
+			std::push_heap(heap.begin(), heap.end(), IsNearer);
 		}
 
-		return best;
+		size_t next = (xy[dim] < c) ? n.left : n.right;
+		if (next != INVALID_NODE) this->FindKNearestRecursive(xy, next, level + 1, k, heap);
+
+		size_t opposite = (xy[dim] >= c) ? n.left : n.right; // reverse of above
+		if (opposite != INVALID_NODE && (heap.size() < k || heap.front().second >= abs((int)xy[dim] - (int)c))) this->FindKNearestRecursive(xy, opposite, level + 1, k, heap);
 	}
 
 	template <typename Outputter>
@@ -392,7 +471,8 @@ public:
 
 	/**
 	 * Insert a single element in the tree.
-	 * Repeatedly inserting single elements may cause the tree to become unbalanced.
+	 * Parts of the tree that become too deep are rebuilt, so the tree stays balanced
+	 * however many elements are inserted one by one.
 	 * Undefined behaviour if the element already exists in the tree.
 	 */
 	void Insert(const T &element)
@@ -400,10 +480,7 @@ public:
 		if (this->Count() == 0) {
 			this->root = this->AddNode(element);
 		} else {
-			if (!this->IsUnbalanced() || !this->Rebuild(&element, nullptr)) {
-				this->InsertRecursive(element, this->root, 0);
-				this->IncrementUnbalanced();
-			}
+			this->InsertRecursive(element);
 			CheckInvariant();
 		}
 	}
@@ -443,7 +520,60 @@ public:
 		assert(this->Count() > 0);
 
 		CoordT xy[2] = { x, y };
-		return this->FindNearestRecursive(xy, this->root, 0).first;
+		const T &start = this->nodes[this->root].element;
+		node_distance best = std::make_pair(start, ManhattanDistance(start, x, y));
+		this->FindNearestRecursive(xy, this->root, 0, best);
+		return best.first;
+	}
+
+	/**
+	 * Find the element closest to each of the given coordinates, in Manhattan distance.
+	 * This gives the same results as calling #FindNearest for each point, but the answer
+	 * for a point is used as starting guess for the next one. Nearby points are therefore
+	 * found quicker, so it pays to pass points in an order where they are close together.
+	 * @param points The coordinates to search from.
+	 * @return For each of the points, the element closest to it.
+	 */
+	std::vector<T> FindNearest(std::span<const std::pair<CoordT, CoordT>> points) const
+	{
+		std::vector<T> result;
+		if (points.empty()) return result;
+		assert(this->Count() > 0);
+
+		result.reserve(points.size());
+		T guess = this->nodes[this->root].element;
+		for (const auto &[x, y] : points) {
+			CoordT xy[2] = { x, y };
+			node_distance best = std::make_pair(guess, ManhattanDistance(guess, x, y));
+			this->FindNearestRecursive(xy, this->root, 0, best);
+			guess = best.first;
+			result.push_back(guess);
+		}
+		return result;
+	}
+
+	/**
+	 * Find the k elements closest to given coordinate, in Manhattan distance.
+	 * Elements with the same distance are ordered by less-than comparison.
+	 * @param x First coordinate of the point to search from.
+	 * @param y Second coordinate of the point to search from.
+	 * @param k Number of elements to find.
+	 * @return The nearest elements, nearest first. Fewer than \a k when the tree does not hold as many.
+	 */
+	std::vector<T> FindKNearest(CoordT x, CoordT y, size_t k) const
+	{
+		std::vector<node_distance> heap;
+		if (k == 0 || this->Count() == 0) return {};
+
+		heap.reserve(std::min(k, this->Count()));
+		CoordT xy[2] = { x, y };
+		this->FindKNearestRecursive(xy, this->root, 0, k, heap);
+		std::sort_heap(heap.begin(), heap.end(), IsNearer);
+
+		std::vector<T> result;
+		result.reserve(heap.size());
+		for (const node_distance &nd : heap) result.push_back(nd.first);
+		return result;
 	}
 
 	/**
@@ -271,16 +271,20 @@ bool operator!=(const Tmap_iter2 &iter2, const MultiMapIterator<Tmap_iter1, Tlis
 
 
 /**
- * Hand-rolled multimap as map of lists. Behaves mostly like a list, but is sorted
+ * Hand-rolled multimap as map of vectors. Behaves mostly like a list, but is sorted
  * by Tkey so that you can easily look up ranges of equal keys. Those ranges are
  * internally ordered in a deterministic way (contrary to STL multimap). All
  * STL-compatible members are named in STL style, all others are named in OpenTTD
  * style.
+ * The items with equal keys are stored contiguously, so walking over them is
+ * cheap. Like with std::vector, inserting an item invalidates the iterators to
+ * items with the same key, and erasing single items from the front of a range
+ * is expensive; erase ranges of items from List directly instead.
  */
 template<typename Tkey, typename Tvalue, typename Tcompare = std::less<Tkey> >
-class MultiMap : public std::map<Tkey, std::list<Tvalue>, Tcompare > {
+class MultiMap : public std::map<Tkey, std::vector<Tvalue>, Tcompare > {
 public:
-	typedef typename std::list<Tvalue> List;
+	typedef typename std::vector<Tvalue> List;
 	typedef typename List::iterator ListIterator;
 	typedef typename List::const_iterator ConstListIterator;
 
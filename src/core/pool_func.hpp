@@ -23,8 +23,8 @@
  * @param type The return type of the method.
  */
 #define DEFINE_POOL_METHOD(type) \
-	template <class Titem, typename Tindex, size_t Tgrowth_step, size_t Tmax_size, PoolType Tpool_type, bool Tcache, bool Tzero> \
-	type Pool<Titem, Tindex, Tgrowth_step, Tmax_size, Tpool_type, Tcache, Tzero>
+	template <class Titem, typename Tindex, size_t Tgrowth_step, size_t Tmax_size, PoolType Tpool_type, bool Tinplace, bool Tzero> \
+	type Pool<Titem, Tindex, Tgrowth_step, Tmax_size, Tpool_type, Tinplace, Tzero>
 
 /**
  * Create a clean pool.
@@ -42,7 +42,8 @@ DEFINE_POOL_METHOD(inline)::Pool(const char *name) :
 #endif /* WITH_ASSERT */
 		cleaning(false),
 		data(nullptr),
-		alloc_cache(nullptr)
+		allocated(0),
+		freed(0)
 { }
 
 /**
@@ -61,6 +62,10 @@ DEFINE_POOL_METHOD(inline void)::ResizeFor(size_t index)
 	this->data = ReallocT(this->data, new_size);
 	MemSetT(this->data + this->size, 0, new_size - this->size);
 
+	if constexpr (Tinplace) {
+		while (this->chunks.size() * Tgrowth_step < new_size) this->chunks.push_back(MallocT<uint8_t>(Tgrowth_step * sizeof(Titem)));
+	}
+
 	this->used_bitmap.resize(Align(new_size, BITMAP_SIZE) / BITMAP_SIZE);
 	if (this->size % BITMAP_SIZE != 0) {
 		/* Already-allocated bits above old size are now unused. */
@@ -111,12 +116,12 @@ DEFINE_POOL_METHOD(inline void *)::AllocateItem(size_t size, size_t index)
 
 	this->first_unused = std::max(this->first_unused, index + 1);
 	this->items++;
+	this->allocated++;
 
 	Titem *item;
-	if (Tcache && this->alloc_cache != nullptr) {
+	if constexpr (Tinplace) {
 		assert(sizeof(Titem) == size);
-		item = (Titem *)this->alloc_cache;
-		this->alloc_cache = this->alloc_cache->next;
+		item = (Titem *)(this->chunks[index / Tgrowth_step] + (index % Tgrowth_step) * sizeof(Titem));
 		if (Tzero) {
 			/* Explicitly casting to (void *) prevents a clang warning -
 			 * we are actually memsetting a (not-yet-constructed) object */
@@ -187,16 +192,12 @@ DEFINE_POOL_METHOD(void)::FreeItem(size_t index)
 {
 	assert(index < this->size);
 	assert(this->data[index] != nullptr);
-	if (Tcache) {
-		AllocCache *ac = (AllocCache *)this->data[index];
-		ac->next = this->alloc_cache;
-		this->alloc_cache = ac;
-	} else {
-		free(this->data[index]);
-	}
+	/* Items stored in place keep their memory in the chunk. */
+	if (!Tinplace) free(this->data[index]);
 	this->data[index] = nullptr;
 	this->first_free = std::min(this->first_free, index);
 	this->items--;
+	this->freed++;
 	if (!this->cleaning) {
 		ClrBit(this->used_bitmap[index / BITMAP_SIZE], index % BITMAP_SIZE);
 		Titem::PostDestructor(index);
@@ -218,13 +219,8 @@ DEFINE_POOL_METHOD(void)::CleanPool()
 	this->data = nullptr;
 	this->cleaning = false;
 
-	if (Tcache) {
-		while (this->alloc_cache != nullptr) {
-			AllocCache *ac = this->alloc_cache;
-			this->alloc_cache = ac->next;
-			free(ac);
-		}
-	}
+	for (uint8_t *chunk : this->chunks) free(chunk);
+	this->chunks.clear();
 }
 
 #undef DEFINE_POOL_METHOD
@@ -25,6 +25,19 @@ DECLARE_ENUM_AS_BIT_SET(PoolType)
 
 typedef std::vector<struct PoolBase *> PoolVector; ///< Vector of pointers to PoolBase
 
+/** Statistics of the allocations of a pool. */
+struct PoolStats {
+	const char *name;    ///< Name of the pool.
+	size_t items;        ///< Number of items in use.
+	size_t first_unused; ///< Number of indices up to and including the highest one in use.
+	size_t size;         ///< Number of indices there is room for without growing.
+	uint64_t allocated;  ///< Number of items allocated since the start.
+	uint64_t freed;      ///< Number of items freed since the start.
+	size_t chunks;       ///< Number of chunks the items are stored in, for pools that store their items in place.
+	size_t chunk_bytes;  ///< Size of all chunks in bytes.
+	size_t item_size;    ///< Size of a single item in bytes, without any memory it owns.
+};
+
 /** Base class for base of all pools. */
 struct PoolBase {
 	const PoolType type; ///< Type of this pool.
@@ -57,6 +70,12 @@ struct PoolBase {
 	 */
 	virtual void CleanPool() = 0;
 
+	/**
+	 * Virtual method that gets the statistics of the allocations of the pool.
+	 * @return The statistics.
+	 */
+	virtual PoolStats GetStats() const = 0;
+
 private:
 	/**
 	 * Dummy private copy constructor to prevent compilers from
@@ -72,11 +91,11 @@ private:
  * @tparam Tgrowth_step Size of growths; if the pool is full increase the size by this amount
  * @tparam Tmax_size    Maximum size of the pool
  * @tparam Tpool_type   Type of this pool
- * @tparam Tcache       Whether to perform 'alloc' caching, i.e. don't actually free/malloc just reuse the memory
+ * @tparam Tinplace     Whether to store the items in place, i.e. in chunks of #Tgrowth_step items in index order, instead of allocating each of them
  * @tparam Tzero        Whether to zero the memory
- * @warning when Tcache is enabled *all* instances of this pool's item must be of the same size.
+ * @warning when Tinplace is enabled *all* instances of this pool's item must be of the same size.
  */
-template <class Titem, typename Tindex, size_t Tgrowth_step, size_t Tmax_size, PoolType Tpool_type = PT_NORMAL, bool Tcache = false, bool Tzero = true>
+template <class Titem, typename Tindex, size_t Tgrowth_step, size_t Tmax_size, PoolType Tpool_type = PT_NORMAL, bool Tinplace = false, bool Tzero = true>
 struct Pool : PoolBase {
 	/* Ensure Tmax_size is within the bounds of Tindex. */
 	static_assert((uint64_t)(Tmax_size - 1) >> 8 * sizeof(Tindex) == 0);
@@ -100,9 +119,18 @@ struct Pool : PoolBase {
 	Titem **data;        ///< Pointer to array of pointers to Titem
 	std::vector<BitmapStorage> used_bitmap; ///< Bitmap of used indices.
 
+	uint64_t allocated;  ///< Number of items allocated since the start
+	uint64_t freed;      ///< Number of items freed since the start
+
 	Pool(const char *name);
 	void CleanPool() override;
 
+	PoolStats GetStats() const override
+	{
+		return { this->name, this->items, this->first_unused, this->size, this->allocated, this->freed,
+				this->chunks.size(), this->chunks.size() * Tgrowth_step * sizeof(Titem), sizeof(Titem) };
+	}
+
 	/**
 	 * Returns Titem with given index
 	 * @param index of item to get
@@ -233,12 +261,12 @@ struct Pool : PoolBase {
 	 * Base class for all PoolItems
 	 * @tparam Tpool The pool this item is going to be part of
 	 */
-	template <struct Pool<Titem, Tindex, Tgrowth_step, Tmax_size, Tpool_type, Tcache, Tzero> *Tpool>
+	template <struct Pool<Titem, Tindex, Tgrowth_step, Tmax_size, Tpool_type, Tinplace, Tzero> *Tpool>
 	struct PoolItem {
 		Tindex index; ///< Index of this pool item
 
 		/** Type of the pool this item is going to be part of */
-		typedef struct Pool<Titem, Tindex, Tgrowth_step, Tmax_size, Tpool_type, Tcache, Tzero> Pool;
+		typedef struct Pool<Titem, Tindex, Tgrowth_step, Tmax_size, Tpool_type, Tinplace, Tzero> Pool;
 
 		/**
 		 * Allocates space for new Titem
@@ -391,17 +419,8 @@ struct Pool : PoolBase {
 private:
 	static const size_t NO_FREE_ITEM = MAX_UVALUE(size_t); ///< Constant to indicate we can't allocate any more items
 
-	/**
-	 * Helper struct to cache 'freed' PoolItems so we
-	 * do not need to allocate them again.
-	 */
-	struct AllocCache {
-		/** The next in our 'cache' */
-		AllocCache *next;
-	};
-
-	/** Cache of freed pointers */
-	AllocCache *alloc_cache;
+	/** For pools that store their items in place, the chunks of #Tgrowth_step items each, in index order */
+	std::vector<uint8_t *> chunks;
 
 	void *AllocateItem(size_t size, size_t index);
 	void ResizeFor(size_t index);
@@ -10,6 +10,10 @@
 #include "stdafx.h"
 #include "core/bitmath_func.hpp"
 
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#	include <intrin.h>
+#endif
+
 #include "safeguards.h"
 
 /**
@@ -26,7 +30,12 @@
 #if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
 void ottd_cpuid(int info[4], int type)
 {
-	__cpuid(info, type);
+	__cpuidex(info, type, 0);
+}
+
+static uint64_t ottd_xgetbv()
+{
+	return _xgetbv(0);
 }
 #elif defined(__x86_64__) || defined(__i386)
 void ottd_cpuid(int info[4], int type)
@@ -46,16 +55,27 @@ void ottd_cpuid(int info[4], int type)
 			/* It is safe to write "=r" for (info[1]) as in case that PIC is enabled for i386,
 			 * the compiler will not choose EBX as target register (but something else).
 			 */
-			: "a" (type)
+			: "a" (type), "c" (0)
 	);
 #else
 	__asm__ __volatile__ (
 			"cpuid           \n\t"
 			: "=a" (info[0]), "=b" (info[1]), "=c" (info[2]), "=d" (info[3])
-			: "a" (type)
+			: "a" (type), "c" (0)
 	);
 #endif /* i386 PIC */
 }
+
+static uint64_t ottd_xgetbv()
+{
+	uint32_t eax, edx;
+	__asm__ __volatile__ (
+			"xgetbv          \n\t"
+			: "=a" (eax), "=d" (edx)
+			: "c" (0)
+	);
+	return (uint64_t)edx << 32 | eax;
+}
 #elif defined(__e2k__) /* MCST Elbrus 2000*/
 void ottd_cpuid(int info[4], int type)
 {
@@ -81,6 +101,13 @@ void ottd_cpuid(int info[4], int)
 }
 #endif
 
+#if !(defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))) && !defined(__x86_64__) && !defined(__i386)
+static uint64_t ottd_xgetbv()
+{
+	return 0;
+}
+#endif
+
 bool HasCPUIDFlag(uint type, uint index, uint bit)
 {
 	int cpu_info[4] = {-1};
@@ -91,3 +118,17 @@ bool HasCPUIDFlag(uint type, uint index, uint bit)
 	ottd_cpuid(cpu_info, type);
 	return HasBit(cpu_info[index], bit);
 }
+
+/**
+ * Check whether AVX2 instructions can be used: the CPU has to support them,
+ * and the operating system has to save the AVX registers on context switches.
+ * @return True if AVX2 instructions can be used.
+ */
+bool HasCPUAVX2Support()
+{
+	/* OSXSAVE, so XGETBV can be used, and AVX itself. */
+	if (!HasCPUIDFlag(1, 2, 27) || !HasCPUIDFlag(1, 2, 28)) return false;
+	/* The operating system saves both the SSE and the AVX state. */
+	if ((ottd_xgetbv() & 0x6) != 0x6) return false;
+	return HasCPUIDFlag(7, 1, 5);
+}
@@ -13,7 +13,7 @@
 /**
  * Get the CPUID information from the CPU.
  * @param info The retrieved info. All zeros on architectures without CPUID.
- * @param type The information this instruction should retrieve.
+ * @param type The information this instruction should retrieve; the sub leaf is always 0.
  */
 void ottd_cpuid(int info[4], int type);
 
@@ -26,4 +26,6 @@ void ottd_cpuid(int info[4], int type);
  */
 bool HasCPUIDFlag(uint type, uint index, uint bit);
 
+bool HasCPUAVX2Support();
+
 #endif /* CPU_H */
@@ -11,6 +11,7 @@
 #include "core/bitmath_func.hpp"
 
 #include "currency.h"
+#include "gfx_func.h"
 #include "news_func.h"
 #include "settings_type.h"
 #include "string_type.h"
@@ -147,6 +148,7 @@ static IntervalTimer<TimerGameCalendar> _check_switch_to_euro({TimerGameCalendar
 			_currency_specs[_settings_game.locale.currency].to_euro != CF_ISEURO &&
 			TimerGameCalendar::year >= _currency_specs[_settings_game.locale.currency].to_euro) {
 		_settings_game.locale.currency = 2; // this is the index of euro above.
+		MarkWholeScreenDirty();
 		AddNewsItem(STR_NEWS_EURO_INTRODUCTION, NT_ECONOMY, NF_NORMAL);
 	}
 });
@@ -13,11 +13,16 @@
 #include "string_func.h"
 #include "fileio_func.h"
 #include "settings_type.h"
+#include "thread.h"
 #include <mutex>
+#include <condition_variable>
 
 #if defined(_WIN32)
 #include "os/windows/win32.h"
 #endif
+#if defined(UNIX)
+#include <unistd.h>
+#endif
 
 #include "3rdparty/fmt/chrono.h"
 
@@ -35,6 +40,112 @@ std::mutex _debug_remote_console_mutex; ///< Mutex to guard the queue of debug m
 std::vector<QueuedDebugItem> _debug_remote_console_queue; ///< Queue for debug messages to be passed to NetworkAdminConsole or IConsolePrint.
 std::vector<QueuedDebugItem> _debug_remote_console_queue_spare; ///< Spare queue to swap with _debug_remote_console_queue.
 
+/**
+ * Debug output waiting to be written to stderr by the debug writer thread.
+ * It is never destroyed, as the detached writer thread may still be waiting on it when the game exits.
+ */
+struct QueuedDebugOutput {
+	std::mutex write_mutex;             ///< Held while writing to stderr, so queued and directly written lines stay in order.
+	std::mutex queue_mutex;             ///< Guards #queue; taken after #write_mutex when both are needed.
+	std::condition_variable queue_cv;   ///< Signalled when lines are added to #queue.
+	std::string queue;                  ///< The lines waiting to be written.
+	std::once_flag writer_start;        ///< Flag to start the writer thread only once.
+	std::atomic<bool> writer_running;   ///< Whether the writer thread is running.
+};
+static QueuedDebugOutput &_debug_output = *new QueuedDebugOutput();
+static bool _debug_in_forked_child = false; ///< Whether this process is a forked copy of the game, see #DebugEnterForkedChild.
+
+/**
+ * Tell the debug output that this process is a forked copy of the game, like the one saving in the background.
+ * Only the thread that forked exists in the copy, but the other threads might have held the locks of the debug
+ * output, or of stderr, at the moment of the fork; those locks are never released in the copy. The writer thread
+ * of the queue does not exist in the copy either. So from now on the debug output is written directly to the
+ * file descriptor of stderr, without taking any locks, and it is not passed on to the console or admins.
+ * Output that was queued before the fork is left to the original process.
+ */
+void DebugEnterForkedChild()
+{
+	_debug_in_forked_child = true;
+}
+
+/**
+ * Write the queued debug output, and optionally a line after it.
+ * @param line The line to write after the queued output.
+ * @pre The caller holds #QueuedDebugOutput::write_mutex.
+ */
+static void WriteQueuedDebugOutput(std::string_view line = {})
+{
+	std::string batch;
+	{
+		std::lock_guard<std::mutex> lock(_debug_output.queue_mutex);
+		std::swap(batch, _debug_output.queue);
+	}
+	batch += line;
+	if (!batch.empty()) fmt::print(stderr, "{}", batch);
+}
+
+/** Write the debug output that is still queued, when the game exits. */
+static void FlushQueuedDebugOutput()
+{
+	std::lock_guard<std::mutex> lock(_debug_output.write_mutex);
+	WriteQueuedDebugOutput();
+}
+
+/** Thread that writes the queued debug output in batches, so the threads logging do not wait for stderr. */
+static void DebugWriterThread()
+{
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(_debug_output.queue_mutex);
+			_debug_output.queue_cv.wait(lock, [] { return !_debug_output.queue.empty(); });
+		}
+		std::lock_guard<std::mutex> lock(_debug_output.write_mutex);
+		WriteQueuedDebugOutput();
+	}
+}
+
+/**
+ * Write a line of debug output to stderr.
+ * Errors and warnings, i.e. levels 0 and 1, are written directly after the output queued before them.
+ * More detailed output is queued for the writer thread, so verbose debug levels do not slow down the game.
+ * @param level The debug level of the line.
+ * @param line The line, including the trailing newline.
+ */
+static void WriteDebugLine(int level, std::string &&line)
+{
+	if (_debug_in_forked_child) {
+#if defined(UNIX)
+		std::string_view remaining = line;
+		while (!remaining.empty()) {
+			ssize_t written = write(STDERR_FILENO, remaining.data(), remaining.size());
+			if (written <= 0) break;
+			remaining.remove_prefix(written);
+		}
+#endif
+		return;
+	}
+
+	if (level > 1) {
+		/* Failing to start the thread is logged at level 1, which does not get here. */
+		std::call_once(_debug_output.writer_start, [] {
+			if (!StartNewThread(nullptr, "ottd:debug", &DebugWriterThread)) return;
+			_debug_output.writer_running = true;
+			std::atexit(FlushQueuedDebugOutput);
+		});
+		if (_debug_output.writer_running) {
+			{
+				std::lock_guard<std::mutex> lock(_debug_output.queue_mutex);
+				_debug_output.queue += line;
+			}
+			_debug_output.queue_cv.notify_one();
+			return;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(_debug_output.write_mutex);
+	WriteQueuedDebugOutput(line);
+}
+
 int _debug_driver_level;
 int _debug_grf_level;
 int _debug_map_level;
@@ -125,9 +236,9 @@ void DebugPrint(const char *category, int level, const std::string &message)
 		fflush(f);
 #endif
 	} else {
-		fmt::print(stderr, "{}dbg: [{}:{}] {}\n", GetLogPrefix(true), category, level, message);
+		WriteDebugLine(level, fmt::format("{}dbg: [{}:{}] {}\n", GetLogPrefix(true), category, level, message));
 
-		if (_debug_remote_console.load()) {
+		if (_debug_remote_console.load() && !_debug_in_forked_child) {
 			/* Only add to the queue when there is at least one consumer of the data. */
 			std::lock_guard<std::mutex> lock(_debug_remote_console_mutex);
 			_debug_remote_console_queue.push_back({ category, message });
@@ -36,6 +36,7 @@
  */
 #define Debug(category, level, format_string, ...) do { if ((level) == 0 || _debug_ ## category ## _level >= (level)) DebugPrint(#category, level, fmt::format(FMT_STRING(format_string), ## __VA_ARGS__)); } while (false)
 void DebugPrint(const char *category, int level, const std::string &message);
+void DebugEnterForkedChild();
 
 extern int _debug_driver_level;
 extern int _debug_grf_level;
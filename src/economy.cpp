@@ -49,6 +49,7 @@
 #include "goal_base.h"
 #include "story_base.h"
 #include "linkgraph/refresh.h"
+#include "thread.h"
 #include "company_cmd.h"
 #include "economy_cmd.h"
 #include "vehicle_cmd.h"
@@ -105,50 +106,87 @@ Economy _economy;
 Prices _price;
 static PriceMultipliers _price_base_multiplier;
 
+/** What the vehicles and stations of a company contribute to its value and performance rating. */
+struct CompanyAssetStats {
+	Money asset_value = 0;           ///< Value of the vehicles and stations.
+	uint profitable_vehicles = 0;    ///< Number of primary vehicles that made a profit last year.
+	Money min_profit = 0;            ///< Lowest profit last year of the primary vehicles that are old enough.
+	bool has_min_profit = false;     ///< Whether any primary vehicle is old enough for #min_profit.
+	uint serviced_facilities = 0;    ///< Number of facilities of the stations that were serviced recently.
+};
+
+/** The asset statistics of all companies. */
+using CompanyAssetStatsArray = std::array<CompanyAssetStats, MAX_COMPANIES>;
+
 /**
- * Calculate the value of the assets of a company.
- *
- * @param c The company to calculate the value of.
- * @return The value of the assets of the company.
+ * Gather the asset statistics of all companies, in a single pass over all stations and vehicles.
+ * @param[out] stats The statistics, indexed by company.
  */
-static Money CalculateCompanyAssetValue(const Company *c)
+static void GatherCompanyAssetStats(CompanyAssetStatsArray &stats)
 {
-	Owner owner = c->index;
-
-	uint num = 0;
+	stats.fill({});
 
+	std::array<uint, MAX_COMPANIES> facilities{};
 	for (const Station *st : Station::Iterate()) {
-		if (st->owner == owner) num += CountBits((uint8_t)st->facilities);
+		if (st->owner >= MAX_COMPANIES) continue;
+		uint num = CountBits((uint8_t)st->facilities);
+		facilities[st->owner] += num;
+		/* Only count stations that are actually serviced for the rating. */
+		if (st->time_since_load <= 20 || st->time_since_unload <= 20) stats[st->owner].serviced_facilities += num;
 	}
 
-	Money value = num * _price[PR_STATION_VALUE] * 25;
+	for (CompanyID c = COMPANY_FIRST; c < MAX_COMPANIES; c++) {
+		stats[c].asset_value = facilities[c] * _price[PR_STATION_VALUE] * 25;
+	}
 
 	for (const Vehicle *v : Vehicle::Iterate()) {
-		if (v->owner != owner) continue;
+		if (v->owner >= MAX_COMPANIES) continue;
+		CompanyAssetStats &s = stats[v->owner];
 
 		if (v->type == VEH_TRAIN ||
 				v->type == VEH_ROAD ||
 				(v->type == VEH_AIRCRAFT && Aircraft::From(v)->IsNormalAircraft()) ||
 				v->type == VEH_SHIP) {
-			value += v->value * 3 >> 1;
+			s.asset_value += v->value * 3 >> 1;
+		}
+
+		if (IsCompanyBuildableVehicleType(v->type) && v->IsPrimaryVehicle()) {
+			if (v->profit_last_year > 0) s.profitable_vehicles++; // For the vehicle score only count profitable vehicles
+			if (v->economy_age > VEHICLE_PROFIT_MIN_AGE) {
+				/* Find the vehicle with the lowest amount of profit */
+				if (!s.has_min_profit || s.min_profit > v->profit_last_year) {
+					s.min_profit = v->profit_last_year;
+					s.has_min_profit = true;
+				}
+			}
 		}
 	}
+}
 
-	return value;
+/**
+ * Calculate the value of the assets of a company.
+ *
+ * @param c The company to calculate the value of.
+ * @return The value of the assets of the company.
+ */
+static Money CalculateCompanyAssetValue(const Company *c)
+{
+	CompanyAssetStatsArray stats;
+	GatherCompanyAssetStats(stats);
+	return stats[c->index].asset_value;
 }
 
 /**
- * Calculate the value of the company. That is the value of all
- * assets (vehicles, stations) and money (including loan),
- * except when including_loan is \c false which is useful when
- * we want to calculate the value for bankruptcy.
+ * Calculate the value of the company from the value of its assets.
  * @param c the company to get the value of.
+ * @param asset_value the value of the assets of the company.
  * @param including_loan include the loan in the company value.
  * @return the value of the company.
+ * @see CalculateCompanyValue
  */
-Money CalculateCompanyValue(const Company *c, bool including_loan)
+static Money CalculateCompanyValue(const Company *c, Money asset_value, bool including_loan)
 {
-	Money value = CalculateCompanyAssetValue(c);
+	Money value = asset_value;
 
 	/* Add real money value */
 	if (including_loan) value -= c->current_loan;
@@ -157,6 +195,20 @@ Money CalculateCompanyValue(const Company *c, bool including_loan)
 	return std::max<Money>(value, 1);
 }
 
+/**
+ * Calculate the value of the company. That is the value of all
+ * assets (vehicles, stations) and money (including loan),
+ * except when including_loan is \c false which is useful when
+ * we want to calculate the value for bankruptcy.
+ * @param c the company to get the value of.
+ * @param including_loan include the loan in the company value.
+ * @return the value of the company.
+ */
+Money CalculateCompanyValue(const Company *c, bool including_loan)
+{
+	return CalculateCompanyValue(c, CalculateCompanyAssetValue(c), including_loan);
+}
+
 /**
  * Calculate what you have to pay to take over a company.
  *
@@ -195,10 +247,11 @@ Money CalculateHostileTakeoverValue(const Company *c)
  *  (also the house is updated, should only be true in the on-tick event)
  * @param update the economy with calculated score
  * @param c company been evaluated
+ * @param stats the asset statistics of the company
  * @return actual score of this company
  *
  */
-int UpdateCompanyRatingAndValue(Company *c, bool update)
+static int UpdateCompanyRatingAndValue(Company *c, bool update, const CompanyAssetStats &stats)
 {
 	Owner owner = c->index;
 	int score = 0;
@@ -207,27 +260,11 @@ int UpdateCompanyRatingAndValue(Company *c, bool update)
 
 	/* Count vehicles */
 	{
-		Money min_profit = 0;
-		bool min_profit_first = true;
-		uint num = 0;
-
-		for (const Vehicle *v : Vehicle::Iterate()) {
-			if (v->owner != owner) continue;
-			if (IsCompanyBuildableVehicleType(v->type) && v->IsPrimaryVehicle()) {
-				if (v->profit_last_year > 0) num++; // For the vehicle score only count profitable vehicles
-				if (v->economy_age > VEHICLE_PROFIT_MIN_AGE) {
-					/* Find the vehicle with the lowest amount of profit */
-					if (min_profit_first || min_profit > v->profit_last_year) {
-						min_profit = v->profit_last_year;
-						min_profit_first = false;
-					}
-				}
-			}
-		}
+		Money min_profit = stats.min_profit;
 
 		min_profit >>= 8; // remove the fract part
 
-		_score_part[owner][SCORE_VEHICLES] = num;
+		_score_part[owner][SCORE_VEHICLES] = stats.profitable_vehicles;
 		/* Don't allow negative min_profit to show */
 		if (min_profit > 0) {
 			_score_part[owner][SCORE_MIN_PROFIT] = min_profit;
@@ -236,12 +273,7 @@ int UpdateCompanyRatingAndValue(Company *c, bool update)
 
 	/* Count stations */
 	{
-		uint num = 0;
-		for (const Station *st : Station::Iterate()) {
-			/* Only count stations that are actually serviced */
-			if (st->owner == owner && (st->time_since_load <= 20 || st->time_since_unload <= 20)) num += CountBits((uint8_t)st->facilities);
-		}
-		_score_part[owner][SCORE_STATIONS] = num;
+		_score_part[owner][SCORE_STATIONS] = stats.serviced_facilities;
 	}
 
 	/* Generate statistics depending on recent income statistics */
@@ -319,13 +351,41 @@ int UpdateCompanyRatingAndValue(Company *c, bool update)
 	if (update) {
 		c->old_economy[0].performance_history = score;
 		UpdateCompanyHQ(c->location_of_HQ, score);
-		c->old_economy[0].company_value = CalculateCompanyValue(c);
+		c->old_economy[0].company_value = CalculateCompanyValue(c, stats.asset_value, true);
 	}
 
 	SetWindowDirty(WC_PERFORMANCE_DETAIL, 0);
 	return score;
 }
 
+/**
+ * if update is set to true, the economy is updated with this score
+ *  (also the house is updated, should only be true in the on-tick event)
+ * @param update the economy with calculated score
+ * @param c company been evaluated
+ * @return actual score of this company
+ *
+ */
+int UpdateCompanyRatingAndValue(Company *c, bool update)
+{
+	CompanyAssetStatsArray stats;
+	GatherCompanyAssetStats(stats);
+	return UpdateCompanyRatingAndValue(c, update, stats[c->index]);
+}
+
+/**
+ * Update the performance rating of all companies, without updating their economy.
+ * The vehicles and stations are only visited once for all companies.
+ */
+void UpdateAllCompanyRatings()
+{
+	CompanyAssetStatsArray stats;
+	GatherCompanyAssetStats(stats);
+	for (Company *c : Company::Iterate()) {
+		UpdateCompanyRatingAndValue(c, false, stats[c->index]);
+	}
+}
+
 /**
  * Change the ownership of all the items of a company.
  * @param old_owner The company that gets removed.
@@ -337,6 +397,8 @@ void ChangeOwnershipOfCompanyItems(Owner old_owner, Owner new_owner)
 	 * the client. This is needed as it needs to know whether "you" really
 	 * are the current local company. */
 	Backup<CompanyID> cur_company(_current_company, old_owner);
+	/* The owner of the tracks reservations are followed over changes. */
+	_track_reservation_generation++;
 	/* In all cases, make spectators of clients connected to that company */
 	if (_networking) NetworkClientsToSpectators(old_owner);
 	if (old_owner == _local_company) {
@@ -692,6 +754,8 @@ static void CompaniesGenStatistics()
 	/* Only run the economic statics and update company stats every 3rd economy month (1st of quarter). */
 	if (!HasBit(1 << 0 | 1 << 3 | 1 << 6 | 1 << 9, TimerGameEconomy::month)) return;
 
+	CompanyAssetStatsArray stats;
+	GatherCompanyAssetStats(stats);
 	for (Company *c : Company::Iterate()) {
 		/* Drop the oldest history off the end */
 		std::copy_backward(c->old_economy, c->old_economy + MAX_HISTORY_QUARTERS - 1, c->old_economy + MAX_HISTORY_QUARTERS);
@@ -700,7 +764,7 @@ static void CompaniesGenStatistics()
 
 		if (c->num_valid_stat_ent != MAX_HISTORY_QUARTERS) c->num_valid_stat_ent++;
 
-		UpdateCompanyRatingAndValue(c, true);
+		UpdateCompanyRatingAndValue(c, true, stats[c->index]);
 		if (c->block_preview != 0) c->block_preview--;
 	}
 
@@ -1932,7 +1996,12 @@ static void LoadUnloadVehicle(Vehicle *front)
 	if (dirty_vehicle) {
 		SetWindowDirty(GetWindowClassForVehicleType(front->type), front->owner);
 		SetWindowDirty(WC_VEHICLE_DETAILS, front->index);
-		front->MarkDirty();
+		/* After the empty trigger all properties may have changed, otherwise only the cargo in some parts did. */
+		if (completely_emptied) {
+			front->MarkDirty();
+		} else {
+			front->MarkCargoAmountDirty();
+		}
 	}
 	if (dirty_station) {
 		st->MarkTilesDirty(true);
@@ -1941,26 +2010,41 @@ static void LoadUnloadVehicle(Vehicle *front)
 	}
 }
 
+/** A station with vehicles in it, and the last of them that is done waiting for its next loading step. */
+struct StationLoading {
+	Station *st;                       ///< The station.
+	Vehicle *last_loading = nullptr; ///< Last vehicle to load or unload this tick, if any.
+};
+
+/** Minimum number of stations with vehicles worth handing to an extra thread. */
+static const size_t MIN_STATIONS_PER_LOADING_THREAD = 256;
+
 /**
- * Load/unload the vehicles in this station according to the order
- * they entered.
- * @param st the station to do the loading/unloading for
+ * Count down the time until the next loading step of the vehicles in some stations.
+ * Every vehicle is in the loading list of at most one station, so this only
+ * touches state owned by the given stations and can run on several threads.
+ * @param stations The stations to count down, and where to store the last vehicle that is to load.
  */
-void LoadUnloadStation(Station *st)
+static void CountDownLoading(std::span<StationLoading> stations)
 {
-	/* No vehicle is here... */
-	if (st->loading_vehicles.empty()) return;
-
-	Vehicle *last_loading = nullptr;
+	for (StationLoading &loading : stations) {
+		for (Vehicle *v : loading.st->loading_vehicles) {
+			if ((v->vehstatus & (VS_STOPPED | VS_CRASHED))) continue;
 
-	/* Check if anything will be loaded at all. Otherwise we don't need to reserve either. */
-	for (Vehicle *v : st->loading_vehicles) {
-		if ((v->vehstatus & (VS_STOPPED | VS_CRASHED))) continue;
-
-		assert(v->load_unload_ticks != 0);
-		if (--v->load_unload_ticks == 0) last_loading = v;
+			assert(v->load_unload_ticks != 0);
+			if (--v->load_unload_ticks == 0) loading.last_loading = v;
+		}
 	}
+}
 
+/**
+ * Load/unload the vehicles in this station according to the order
+ * they entered.
+ * @param st the station to do the loading/unloading for
+ * @param last_loading the last vehicle that is to load this tick
+ */
+static void LoadUnloadStation(Station *st, Vehicle *last_loading)
+{
 	/* We only need to reserve and load/unload up to the last loading vehicle.
 	 * Anything else will be forgotten anyway after returning from this function.
 	 *
@@ -1968,8 +2052,6 @@ void LoadUnloadStation(Station *st)
 	 * consist in a station which is not allowed to load yet because its
 	 * load_unload_ticks is still not 0.
 	 */
-	if (last_loading == nullptr) return;
-
 	for (Vehicle *v : st->loading_vehicles) {
 		if (!(v->vehstatus & (VS_STOPPED | VS_CRASHED))) LoadUnloadVehicle(v);
 		if (v == last_loading) break;
@@ -1982,6 +2064,28 @@ void LoadUnloadStation(Station *st)
 	_cargo_delivery_destinations.clear();
 }
 
+/**
+ * Load/unload the vehicles in all stations according to the order they entered.
+ * Counting down until the next loading step of each vehicle is independent per
+ * station and done in parallel. Moving the cargo allocates cargo packets, pays
+ * money and triggers NewGRF callbacks and randomisation, so that is done one
+ * station at a time, in order of station index.
+ */
+void LoadUnloadStations()
+{
+	static std::vector<StationLoading> stations;
+	stations.clear();
+	for (Station *st : Station::Iterate()) {
+		if (!st->loading_vehicles.empty()) stations.push_back({st});
+	}
+
+	RunInChunks(std::span<StationLoading>(stations), MIN_STATIONS_PER_LOADING_THREAD, CountDownLoading);
+
+	for (const StationLoading &loading : stations) {
+		if (loading.last_loading != nullptr) LoadUnloadStation(loading.st, loading.last_loading);
+	}
+}
+
 /**
  * Every calendar month update of inflation.
  */
@@ -28,13 +28,14 @@ extern Economy _economy;
 extern Prices _price;
 
 int UpdateCompanyRatingAndValue(Company *c, bool update);
+void UpdateAllCompanyRatings();
 void StartupIndustryDailyChanges(bool init_counter);
 
 Money GetTransportedGoodsIncome(uint num_pieces, uint dist, uint16_t transit_periods, CargoID cargo_type);
 uint MoveGoodsToStation(CargoID type, uint amount, SourceType source_type, SourceID source_id, const StationList *all_stations, Owner exclusivity = INVALID_OWNER);
 
 void PrepareUnload(Vehicle *front_v);
-void LoadUnloadStation(Station *st);
+void LoadUnloadStations();
 
 Money GetPrice(Price index, uint cost_factor, const struct GRFFile *grf_file, int shift = 0);
 
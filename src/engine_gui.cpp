@@ -28,6 +28,8 @@
 
 #include "widgets/engine_widget.h"
 
+#include <unordered_map>
+
 #include "table/strings.h"
 
 #include "safeguards.h"
@@ -351,3 +353,76 @@ void EngList_SortPartial(GUIEngineList &el, EngList_SortTypeFunction compare, si
 	std::sort(el.begin() + begin, el.begin() + begin + num_items, compare);
 }
 
+/**
+ * Ensure the primary engine of each variant group is in the list; the ones that are not are added shaded.
+ * @param el List to add to.
+ * @param variants Parents of the variant groups of the engines in the list, possibly with duplicates.
+ * @param added Optional function to call for every added engine.
+ */
+void EngList_AddMissingVariantParents(GUIEngineList &el, const std::vector<EngineID> &variants, std::function<void(const Engine *)> added)
+{
+	if (variants.empty()) return;
+
+	std::vector<bool> in_list(Engine::GetPoolSize());
+	for (const GUIEngineListItem &item : el) in_list[item.engine_id] = true;
+
+	for (EngineID variant : variants) {
+		if (in_list[variant]) continue;
+		in_list[variant] = true;
+
+		const Engine *e = Engine::Get(variant);
+		el.emplace_back(variant, e->info.variant_id, e->display_flags | EngineDisplayFlags::Shaded, 0);
+		if (added) added(e);
+	}
+}
+
+/**
+ * Add the engines of a list to another list, with the variants of an engine
+ * below it when the variant group is unfolded, in the order of the source list.
+ * @param source The list to add the engines of.
+ * @param children The engines of each variant group in \a source.
+ * @param target The list to add the engines to.
+ * @param parent The variant group to add.
+ * @param indent The indentation level of the variant group.
+ */
+static void EngList_AddChildren(const GUIEngineList &source, const std::unordered_map<EngineID, std::vector<size_t>> &children, GUIEngineList &target, EngineID parent, int indent)
+{
+	auto it = children.find(parent);
+	if (it == children.end()) return;
+
+	for (size_t index : it->second) {
+		const GUIEngineListItem &item = source[index];
+		const Engine *e = Engine::Get(item.engine_id);
+		EngineDisplayFlags flags = item.flags;
+		if (e->display_last_variant != INVALID_ENGINE) flags &= ~EngineDisplayFlags::Shaded;
+		target.emplace_back(e->display_last_variant == INVALID_ENGINE ? item.engine_id : e->display_last_variant, item.engine_id, flags, indent);
+
+		/* Add variants if not folded */
+		if ((item.flags & (EngineDisplayFlags::HasVariants | EngineDisplayFlags::IsFolded)) == EngineDisplayFlags::HasVariants) {
+			/* Add this engine again as a child */
+			if ((item.flags & EngineDisplayFlags::Shaded) == EngineDisplayFlags::None) {
+				target.emplace_back(item.engine_id, item.engine_id, EngineDisplayFlags::None, indent + 1);
+			}
+			EngList_AddChildren(source, children, target, item.engine_id, indent + 1);
+		}
+	}
+}
+
+/**
+ * Add the engines of a list to another list as a tree of variant groups, with the
+ * variants of an engine below it when the variant group is unfolded.
+ * @param source The list to add the engines of.
+ * @param target The list to add the engines to.
+ */
+void EngList_AddChildren(const GUIEngineList &source, GUIEngineList &target)
+{
+	/* Index the engines per variant group once, rather than going through the whole list for every group. */
+	std::unordered_map<EngineID, std::vector<size_t>> children;
+	for (size_t i = 0; i < source.size(); i++) {
+		const GUIEngineListItem &item = source[i];
+		if (item.variant_id != item.engine_id) children[item.variant_id].push_back(i);
+	}
+
+	EngList_AddChildren(source, children, target, INVALID_ENGINE, 0);
+}
+
@@ -33,6 +33,8 @@ typedef GUIList<GUIEngineListItem, std::nullptr_t, CargoID> GUIEngineList;
 typedef bool EngList_SortTypeFunction(const GUIEngineListItem&, const GUIEngineListItem&); ///< argument type for #EngList_Sort.
 void EngList_Sort(GUIEngineList &el, EngList_SortTypeFunction compare);
 void EngList_SortPartial(GUIEngineList &el, EngList_SortTypeFunction compare, size_t begin, size_t num_items);
+void EngList_AddMissingVariantParents(GUIEngineList &el, const std::vector<EngineID> &variants, std::function<void(const Engine *)> added = {});
+void EngList_AddChildren(const GUIEngineList &source, GUIEngineList &target);
 
 StringID GetEngineCategoryName(EngineID engine);
 StringID GetEngineInfoString(EngineID engine);
@@ -14,6 +14,7 @@
 #include "fios.h"
 #include "string_func.h"
 #include "tar_type.h"
+#include "scan_cache.h"
 #ifdef _WIN32
 #include <windows.h>
 # define access _taccess
@@ -53,6 +54,7 @@ static const char * const _subdirs[] = {
 	"game" PATHSEP "library" PATHSEP,
 	"screenshot" PATHSEP,
 	"social_integration" PATHSEP,
+	"cache" PATHSEP,
 };
 static_assert(lengthof(_subdirs) == NUM_SUBDIRS);
 
@@ -490,11 +492,29 @@ static std::string ExtractString(char *buffer, size_t buffer_length)
 	return StrMakeValid(std::string_view(buffer, length));
 }
 
-bool TarScanner::AddFile(const std::string &filename, size_t, [[maybe_unused]] const std::string &tar_filename)
-{
-	/* No tar within tar. */
-	assert(tar_filename.empty());
+/** The contents of a tar file, as read from its headers. */
+struct TarIndex {
+	/** A regular file in the tar. */
+	struct File {
+		std::string name; ///< Simplified name of the file within the tar.
+		size_t size;      ///< Size of the file.
+		size_t position;  ///< Position of the file within the tar.
+	};
 
+	std::vector<File> files;  ///< The regular files, in the order they are in the tar.
+	TarLinkList links;        ///< Links within the tar, from source to destination.
+	std::string dirname;      ///< The first directory in the tar.
+};
+
+/**
+ * Read the index of a tar file by walking all its headers.
+ * @param f        The tar file, positioned at its start.
+ * @param filename Name of the tar file, for messages.
+ * @param[out] index The contents of the tar. When the tar is invalid, the part before the fault.
+ * @return True iff the tar file is valid.
+ */
+static bool ReadTarIndex(FILE *f, const std::string &filename, TarIndex &index)
+{
 	/* The TAR-header, repeated for every file */
 	struct TarHeader {
 		char name[100];      ///< Name of the file
@@ -517,26 +537,8 @@ bool TarScanner::AddFile(const std::string &filename, size_t, [[maybe_unused]] c
 		char unused[12];
 	};
 
-	/* Check if we already seen this file */
-	TarList::iterator it = _tar_list[this->subdir].find(filename);
-	if (it != _tar_list[this->subdir].end()) return false;
-
-	FILE *f = fopen(filename.c_str(), "rb");
-	/* Although the file has been found there can be
-	 * a number of reasons we cannot open the file.
-	 * Most common case is when we simply have not
-	 * been given read access. */
-	if (f == nullptr) return false;
-
-	_tar_list[this->subdir][filename] = std::string{};
-
-	std::string filename_base = std::filesystem::path(filename).filename().string();
-	SimplifyFileName(filename_base);
-
-	TarLinkList links; ///< Temporary list to collect links
-
 	TarHeader th;
-	size_t num = 0, pos = 0;
+	size_t pos = 0;
 
 	/* Make a char of 512 empty bytes */
 	char empty[512];
@@ -553,7 +555,6 @@ bool TarScanner::AddFile(const std::string &filename, size_t, [[maybe_unused]] c
 			if (memcmp(&th, &empty[0], 512) == 0) continue;
 
 			Debug(misc, 0, "The file '{}' isn't a valid tar-file", filename);
-			fclose(f);
 			return false;
 		}
 
@@ -577,18 +578,11 @@ bool TarScanner::AddFile(const std::string &filename, size_t, [[maybe_unused]] c
 			case '0': { // regular file
 				if (name.empty()) break;
 
-				/* Store this entry in the list */
-				TarFileListEntry entry;
-				entry.tar_filename = filename;
-				entry.size         = skip;
-				entry.position     = pos;
-
 				/* Convert to lowercase and our PATHSEPCHAR */
 				SimplifyFileName(name);
 
 				Debug(misc, 6, "Found file in tar: {} ({} bytes, {} offset)", name, skip, pos);
-				if (_tar_filelist[this->subdir].insert(TarFileList::value_type(filename_base + PATHSEPCHAR + name, entry)).second) num++;
-
+				index.files.push_back({ name, skip, pos });
 				break;
 			}
 
@@ -619,7 +613,7 @@ bool TarScanner::AddFile(const std::string &filename, size_t, [[maybe_unused]] c
 
 				/* Store links in temporary list */
 				Debug(misc, 6, "Found link in tar: {} -> {}", name, dest);
-				links.insert(TarLinkList::value_type(filename_base + PATHSEPCHAR + name, filename_base + PATHSEPCHAR + dest));
+				index.links.insert(TarLinkList::value_type(name, dest));
 
 				break;
 			}
@@ -630,7 +624,7 @@ bool TarScanner::AddFile(const std::string &filename, size_t, [[maybe_unused]] c
 
 				/* Store the first directory name we detect */
 				Debug(misc, 6, "Found dir in tar: {}", name);
-				if (_tar_list[this->subdir][filename].empty()) _tar_list[this->subdir][filename] = name;
+				if (index.dirname.empty()) index.dirname = name;
 				break;
 
 			default:
@@ -642,15 +636,146 @@ bool TarScanner::AddFile(const std::string &filename, size_t, [[maybe_unused]] c
 		skip = Align(skip, 512);
 		if (fseek(f, skip, SEEK_CUR) < 0) {
 			Debug(misc, 0, "The file '{}' can't be read as a valid tar-file", filename);
-			fclose(f);
 			return false;
 		}
 		pos += skip;
 	}
 
-	Debug(misc, 4, "Found tar '{}' with {} new files", filename, num);
+	return true;
+}
+
+/**
+ * Convert the index of a tar to the form it is stored in the scan cache.
+ * @param index The index of the tar.
+ * @return The stored form.
+ */
+static std::vector<uint8_t> SerialiseTarIndex(const TarIndex &index)
+{
+	std::vector<uint8_t> buf;
+	auto write_bytes = [&buf](uint64_t v, uint n) {
+		for (uint i = 0; i < n; i++) buf.push_back(GB(v, i * 8, 8));
+	};
+	auto write_string = [&buf, &write_bytes](const std::string &str) {
+		write_bytes(str.size(), 2);
+		buf.insert(buf.end(), str.begin(), str.end());
+	};
+
+	write_string(index.dirname);
+	write_bytes(index.files.size(), 4);
+	for (const TarIndex::File &file : index.files) {
+		write_string(file.name);
+		write_bytes(file.size, 8);
+		write_bytes(file.position, 8);
+	}
+	write_bytes(index.links.size(), 4);
+	for (const auto &[src, dest] : index.links) {
+		write_string(src);
+		write_string(dest);
+	}
+	return buf;
+}
+
+/**
+ * Convert the index of a tar from the form it is stored in the scan cache.
+ * @param buf The stored form.
+ * @param[out] index The index of the tar.
+ * @return True iff the stored form is valid.
+ */
+static bool DeserialiseTarIndex(const std::vector<uint8_t> &buf, TarIndex &index)
+{
+	const uint8_t *p = buf.data();
+	const uint8_t *end = p + buf.size();
+	bool valid = true;
+	auto read_bytes = [&p, end, &valid](uint n) {
+		uint64_t v = 0;
+		if ((size_t)(end - p) < n) {
+			valid = false;
+			return v;
+		}
+		for (uint i = 0; i < n; i++) v |= (uint64_t)*p++ << (i * 8);
+		return v;
+	};
+	auto read_string = [&p, end, &valid, &read_bytes]() {
+		size_t length = (size_t)read_bytes(2);
+		if (!valid || (size_t)(end - p) < length) {
+			valid = false;
+			return std::string{};
+		}
+		std::string str(reinterpret_cast<const char *>(p), length);
+		p += length;
+		return str;
+	};
+
+	index.dirname = read_string();
+	uint32_t files = (uint32_t)read_bytes(4);
+	for (uint32_t i = 0; valid && i < files; i++) {
+		TarIndex::File &file = index.files.emplace_back();
+		file.name = read_string();
+		file.size = (size_t)read_bytes(8);
+		file.position = (size_t)read_bytes(8);
+	}
+	uint32_t links = (uint32_t)read_bytes(4);
+	for (uint32_t i = 0; valid && i < links; i++) {
+		std::string src = read_string();
+		index.links[src] = read_string();
+	}
+	return valid && p == end;
+}
+
+bool TarScanner::AddFile(const std::string &filename, size_t, [[maybe_unused]] const std::string &tar_filename)
+{
+	/* No tar within tar. */
+	assert(tar_filename.empty());
+
+	/* Check if we already seen this file */
+	TarList::iterator it = _tar_list[this->subdir].find(filename);
+	if (it != _tar_list[this->subdir].end()) return false;
+
+	FILE *f = fopen(filename.c_str(), "rb");
+	/* Although the file has been found there can be
+	 * a number of reasons we cannot open the file.
+	 * Most common case is when we simply have not
+	 * been given read access. */
+	if (f == nullptr) return false;
+
+	/* Walking all headers of a big tar takes long, so the index is kept in the scan cache until the tar changes. */
+	TarIndex index;
+	std::string cache_key = "tar:" + filename;
+	ScanCacheStamp stamp;
+	bool stamped = stamp.Stamp(f, 0);
+	std::vector<uint8_t> cached;
+	bool valid;
+	if (stamped && ScanCacheLookup(cache_key, stamp, cached) && DeserialiseTarIndex(cached, index)) {
+		Debug(misc, 6, "Using cached index of tar '{}'", filename);
+		valid = true;
+	} else {
+		index = {};
+		valid = ReadTarIndex(f, filename, index);
+		if (valid && stamped) ScanCacheStore(cache_key, stamp, SerialiseTarIndex(index));
+	}
 	fclose(f);
 
+	_tar_list[this->subdir][filename] = index.dirname;
+
+	std::string filename_base = std::filesystem::path(filename).filename().string();
+	SimplifyFileName(filename_base);
+
+	size_t num = 0;
+	for (const TarIndex::File &file : index.files) {
+		/* Store this entry in the list */
+		TarFileListEntry entry;
+		entry.tar_filename = filename;
+		entry.size         = file.size;
+		entry.position     = file.position;
+
+		if (_tar_filelist[this->subdir].insert(TarFileList::value_type(filename_base + PATHSEPCHAR + file.name, entry)).second) num++;
+	}
+
+	/* The files before the fault in an invalid tar are still known, its links are not. */
+	if (!valid) return false;
+
+	Debug(misc, 4, "Found tar '{}' with {} new files", filename, num);
+
 	/* Resolve file links and store directory links.
 	 * We restrict usage of links to two cases:
 	 *  1) Links to directories:
@@ -660,8 +785,8 @@ bool TarScanner::AddFile(const std::string &filename, size_t, [[maybe_unused]] c
 	 *      The destination path must NOT contain any links.
 	 *      The source path may contain one directory link.
 	 */
-	for (auto &it : links) {
-		TarAddLink(it.first, it.second, this->subdir);
+	for (auto &link : index.links) {
+		TarAddLink(filename_base + PATHSEPCHAR + link.first, filename_base + PATHSEPCHAR + link.second, this->subdir);
 	}
 
 	return true;
@@ -1058,7 +1183,7 @@ void DeterminePaths(const char *exe, bool only_local_path)
 	Debug(misc, 1, "{} found as personal directory", _personal_dir);
 
 	static const Subdirectory default_subdirs[] = {
-		SAVE_DIR, AUTOSAVE_DIR, SCENARIO_DIR, HEIGHTMAP_DIR, BASESET_DIR, NEWGRF_DIR, AI_DIR, AI_LIBRARY_DIR, GAME_DIR, GAME_LIBRARY_DIR, SCREENSHOT_DIR, SOCIAL_INTEGRATION_DIR
+		SAVE_DIR, AUTOSAVE_DIR, SCENARIO_DIR, HEIGHTMAP_DIR, BASESET_DIR, NEWGRF_DIR, AI_DIR, AI_LIBRARY_DIR, GAME_DIR, GAME_LIBRARY_DIR, SCREENSHOT_DIR, SOCIAL_INTEGRATION_DIR, CACHE_DIR
 	};
 
 	for (uint i = 0; i < lengthof(default_subdirs); i++) {
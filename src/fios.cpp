@@ -11,7 +11,7 @@
  */
 
 #include "stdafx.h"
-#include "3rdparty/md5/md5.h"
+#include "scan_cache.h"
 #include "fileio_func.h"
 #include "fios.h"
 #include "network/network_content.h"
@@ -19,8 +19,11 @@
 #include "string_func.h"
 #include "strings_func.h"
 #include "tar_type.h"
+#include "thread.h"
 #include <sys/stat.h>
 #include <charconv>
+#include <filesystem>
+#include <unordered_set>
 
 #ifndef _WIN32
 # include <unistd.h>
@@ -259,6 +262,7 @@ class FiosFileScanner : public FileScanner {
 	SaveLoadOperation fop;   ///< The kind of file we are looking for.
 	FiosGetTypeAndNameProc *callback_proc; ///< Callback to check whether the file may be added
 	FileList &file_list;     ///< Destination of the found files.
+	std::unordered_set<std::string> names; ///< Names of the files added to the list so far.
 public:
 	/**
 	 * Create the scanner
@@ -287,9 +291,7 @@ bool FiosFileScanner::AddFile(const std::string &filename, size_t, const std::st
 	auto [type, title] = this->callback_proc(this->fop, filename, ext);
 	if (type == FIOS_TYPE_INVALID) return false;
 
-	for (const auto &fios : file_list) {
-		if (filename == fios.name) return false;
-	}
+	if (!this->names.insert(filename).second) return false;
 
 	FiosItem *fios = &file_list.emplace_back();
 #ifdef _WIN32
@@ -421,6 +423,9 @@ static void FiosGetFileList(SaveLoadOperation fop, bool show_dirs, FiosGetTypeAn
  */
 static std::string GetFileTitle(const std::string &file, Subdirectory subdir)
 {
+	/* Files found while scanning have a full path; their title can only be right next to them, so do not look for it in every search path. */
+	if (std::filesystem::path(OTTD2FS(file)).is_absolute()) subdir = NO_DIRECTORY;
+
 	FILE *f = FioFOpenFile(file + ".title", "r", subdir);
 	if (f == nullptr) return {};
 
@@ -625,6 +630,7 @@ struct ScenarioIdentifier {
  */
 class ScenarioScanner : protected FileScanner, public std::vector<ScenarioIdentifier> {
 	bool scanned; ///< Whether we've already scanned
+	std::vector<ScenarioIdentifier> found; ///< Scenarios found by the current scan, their checksums are not yet known.
 public:
 	/** Initialise */
 	ScenarioScanner() : scanned(false) {}
@@ -638,6 +644,33 @@ public:
 		if (this->scanned && !rescan) return;
 
 		this->FileScanner::Scan(".id", SCENARIO_DIR, true, true);
+
+		/* Reading the scenarios for their checksums is the slow part, so do that on several threads. */
+		RunInChunks(std::span(this->found), 1, [](std::span<ScenarioIdentifier> ids) {
+			for (ScenarioIdentifier &id : ids) {
+				size_t size;
+
+				/* open the scenario file, but first get the name.
+				 * This is safe as we check on extension which
+				 * must always exist. */
+				std::string scenario = id.filename.substr(0, id.filename.rfind('.'));
+				FILE *f = FioFOpenFile(scenario, "rb", SCENARIO_DIR, &size);
+				if (f == nullptr) {
+					id.filename.clear();
+					continue;
+				}
+
+				/* calculate md5sum */
+				id.md5sum = CalcFileMD5(f, size, scenario, SCENARIO_DIR);
+
+				FioFCloseFile(f);
+			}
+		});
+
+		for (const ScenarioIdentifier &id : this->found) {
+			if (!id.filename.empty()) include(*this, id);
+		}
+		this->found.clear();
 		this->scanned = true;
 	}
 
@@ -652,26 +685,7 @@ public:
 		if (fret != 1) return false;
 		id.filename = filename;
 
-		Md5 checksum;
-		uint8_t buffer[1024];
-		size_t len, size;
-
-		/* open the scenario file, but first get the name.
-		 * This is safe as we check on extension which
-		 * must always exist. */
-		f = FioFOpenFile(filename.substr(0, filename.rfind('.')), "rb", SCENARIO_DIR, &size);
-		if (f == nullptr) return false;
-
-		/* calculate md5sum */
-		while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, f)) != 0 && size != 0) {
-			size -= len;
-			checksum.Append(buffer, len);
-		}
-		checksum.Finish(id.md5sum);
-
-		FioFCloseFile(f);
-
-		include(*this, id);
+		this->found.push_back(id);
 		return true;
 	}
 };
@@ -22,13 +22,17 @@
 #include "ai/ai_instance.hpp"
 #include "game/game.hpp"
 #include "game/game_instance.hpp"
+#include "spritecache.h"
 #include "timer/timer.h"
 #include "timer/timer_window.h"
 
 #include "widgets/framerate_widget.h"
+#include "fileio_func.h"
+#include "3rdparty/nlohmann/json.hpp"
 
 #include <atomic>
 #include <mutex>
+#include <numeric>
 
 #include "safeguards.h"
 
@@ -196,7 +200,10 @@ namespace {
 		PerformanceData(1),                     // PFE_ACC_GL_SHIPS
 		PerformanceData(1),                     // PFE_ACC_GL_AIRCRAFT
 		PerformanceData(1),                     // PFE_GL_LANDSCAPE
+		PerformanceData(1),                     // PFE_GL_INDUSTRIES
+		PerformanceData(1),                     // PFE_GL_STATIONS
 		PerformanceData(1),                     // PFE_GL_LINKGRAPH
+		PerformanceData(1),                     // PFE_GL_LATENESS
 		PerformanceData(1000.0 / 30),           // PFE_DRAWING
 		PerformanceData(1),                     // PFE_ACC_DRAWWORLD
 		PerformanceData(60.0),                  // PFE_VIDEO
@@ -220,6 +227,20 @@ namespace {
 		PerformanceData(1),                     // PFE_AI14
 	};
 
+	/** Number of ticks over which the time attributed to companies is summed. */
+	const uint COMPANY_PERFORMANCE_PERIOD = Ticks::DAY_TICKS;
+	/** Time attributed to each company in the current period, in microseconds. */
+	std::atomic<TimingMeasurement> _company_pf_current[MAX_COMPANIES][CPE_MAX];
+	/** Time attributed to each company in the last complete period, in microseconds. */
+	TimingMeasurement _company_pf_last[MAX_COMPANIES][CPE_MAX];
+	/** Number of ticks in the current period. */
+	uint _company_pf_ticks;
+
+	/** Whether every measurement is kept for a benchmark, see #StartFramerateBenchmark. */
+	bool _pf_benchmark = false;
+	/** Every measurement of each element since the benchmark started. */
+	std::array<std::vector<TimingMeasurement>, PFE_MAX> _pf_benchmark_durations;
+
 }
 
 
@@ -273,7 +294,9 @@ PerformanceMeasurer::~PerformanceMeasurer()
 		_sound_perf_pending.store(true, std::memory_order_release);
 		return;
 	}
-	_pf_data[this->elem].Add(this->start_time, GetPerformanceTimer());
+	TimingMeasurement end = GetPerformanceTimer();
+	_pf_data[this->elem].Add(this->start_time, end);
+	if (_pf_benchmark) _pf_benchmark_durations[this->elem].push_back(end - this->start_time);
 }
 
 /** Set the rate of expected cycles per second of a performance element. */
@@ -326,9 +349,59 @@ PerformanceAccumulator::~PerformanceAccumulator()
  */
 void PerformanceAccumulator::Reset(PerformanceElement elem)
 {
+	if (_pf_benchmark) _pf_benchmark_durations[elem].push_back(_pf_data[elem].acc_duration);
 	_pf_data[elem].BeginAccumulate(GetPerformanceTimer());
 }
 
+/**
+ * Add a period measured elsewhere to the accumulating value.
+ * @param elem The element to add the period to.
+ * @param duration The length of the period.
+ */
+/* static */ void PerformanceAccumulator::Add(PerformanceElement elem, std::chrono::microseconds duration)
+{
+	_pf_data[elem].AddAccumulate(static_cast<TimingMeasurement>(std::max<int64_t>(duration.count(), 0)));
+}
+
+
+bool _company_performance_accounting; ///< Whether time is attributed to companies, see #CompanyPerformanceMeasurer.
+
+/** Begin measuring the time of the company. */
+void CompanyPerformanceMeasurer::Start()
+{
+	this->start_time = GetPerformanceTimer();
+}
+
+/** Add the time of the company to the current period. */
+void CompanyPerformanceMeasurer::Finish()
+{
+	_company_pf_current[this->owner][this->elem].fetch_add(GetPerformanceTimer() - this->start_time, std::memory_order_relaxed);
+}
+
+/** Complete a period of attributing time to companies, once every #COMPANY_PERFORMANCE_PERIOD ticks. */
+void CompanyPerformanceTick()
+{
+	if (++_company_pf_ticks < COMPANY_PERFORMANCE_PERIOD) return;
+	_company_pf_ticks = 0;
+
+	for (CompanyID c = COMPANY_FIRST; c < MAX_COMPANIES; c++) {
+		for (uint e = 0; e < CPE_MAX; e++) {
+			_company_pf_last[c][e] = _company_pf_current[c][e].exchange(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+/**
+ * Get the time attributed to a company.
+ * @param company The company.
+ * @param elem What the time is spent on.
+ * @return The average time per tick in the last complete period, in milliseconds.
+ */
+double GetCompanyPerformanceMilliseconds(CompanyID company, CompanyPerformanceElement elem)
+{
+	return _company_pf_last[company][elem] / 1000.0 / COMPANY_PERFORMANCE_PERIOD;
+}
+
 
 void ShowFrametimeGraphWindow(PerformanceElement elem);
 
@@ -341,6 +414,8 @@ static const PerformanceElement DISPLAY_ORDER_PFE[PFE_MAX] = {
 	PFE_GL_SHIPS,
 	PFE_GL_AIRCRAFT,
 	PFE_GL_LANDSCAPE,
+	PFE_GL_INDUSTRIES,
+	PFE_GL_STATIONS,
 	PFE_ALLSCRIPTS,
 	PFE_GAMESCRIPT,
 	PFE_AI0,
@@ -359,6 +434,7 @@ static const PerformanceElement DISPLAY_ORDER_PFE[PFE_MAX] = {
 	PFE_AI13,
 	PFE_AI14,
 	PFE_GL_LINKGRAPH,
+	PFE_GL_LATENESS,
 	PFE_DRAWING,
 	PFE_DRAWWORLD,
 	PFE_VIDEO,
@@ -384,6 +460,7 @@ static constexpr NWidgetPart _framerate_window_widgets[] = {
 			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_RATE_GAMELOOP), SetDataTip(STR_FRAMERATE_RATE_GAMELOOP, STR_FRAMERATE_RATE_GAMELOOP_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
 			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_RATE_DRAWING),  SetDataTip(STR_FRAMERATE_RATE_BLITTER,  STR_FRAMERATE_RATE_BLITTER_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
 			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_RATE_FACTOR),   SetDataTip(STR_FRAMERATE_SPEED_FACTOR,  STR_FRAMERATE_SPEED_FACTOR_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
+			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_SPRITE_CACHE),  SetDataTip(STR_FRAMERATE_SPRITE_CACHE,  STR_FRAMERATE_SPRITE_CACHE_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
 		EndContainer(),
 	EndContainer(),
 	NWidget(NWID_HORIZONTAL),
@@ -398,6 +475,9 @@ static constexpr NWidgetPart _framerate_window_widgets[] = {
 					EndContainer(),
 				EndContainer(),
 				NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_INFO_DATA_POINTS), SetDataTip(STR_FRAMERATE_DATA_POINTS, 0x0), SetFill(1, 0), SetResize(1, 0),
+				NWidget(NWID_SELECTION, INVALID_COLOUR, WID_FRW_SEL_COMPANIES),
+					NWidget(WWT_EMPTY, COLOUR_GREY, WID_FRW_COMPANY_TIMES), SetFill(1, 0), SetResize(1, 0),
+				EndContainer(),
 			EndContainer(),
 		EndContainer(),
 		NWidget(NWID_VERTICAL),
@@ -410,6 +490,7 @@ static constexpr NWidgetPart _framerate_window_widgets[] = {
 struct FramerateWindow : Window {
 	bool small;
 	bool showing_memory;
+	int num_companies; ///< Number of companies in the company times, or -1 when they are not shown.
 	int num_active;
 	int num_displayed;
 
@@ -453,6 +534,7 @@ struct FramerateWindow : Window {
 		this->InitNested(number);
 		this->small = this->IsShaded();
 		this->showing_memory = true;
+		this->num_companies = 0;
 		this->UpdateData();
 		this->num_displayed = this->num_active;
 
@@ -503,6 +585,13 @@ struct FramerateWindow : Window {
 			this->showing_memory = have_script;
 		}
 
+		int num_companies = _company_performance_accounting ? static_cast<int>(Company::GetNumItems()) : -1;
+		if (num_companies != this->num_companies) {
+			this->num_companies = num_companies;
+			this->GetWidget<NWidgetStacked>(WID_FRW_SEL_COMPANIES)->SetDisplayedPlane(num_companies >= 0 ? 0 : SZSP_HORIZONTAL);
+			this->ReInit();
+		}
+
 		if (new_active != this->num_active) {
 			this->num_active = new_active;
 			Scrollbar *sb = this->GetScrollbar(WID_FRW_SCROLLBAR);
@@ -534,6 +623,15 @@ struct FramerateWindow : Window {
 			case WID_FRW_RATE_FACTOR:
 				this->speed_gameloop.InsertDParams(0);
 				break;
+			case WID_FRW_SPRITE_CACHE: {
+				const SpriteCacheStatistics &stats = GetSpriteCacheStatistics();
+				SetDParam(0, stats.usage);
+				SetDParam(1, stats.budget);
+				SetDParam(2, stats.hits);
+				SetDParam(3, stats.misses);
+				SetDParam(4, stats.evictions);
+				break;
+			}
 			case WID_FRW_INFO_DATA_POINTS:
 				SetDParam(0, NUM_FRAMERATE_POINTS);
 				break;
@@ -560,6 +658,14 @@ struct FramerateWindow : Window {
 				SetDParam(1, 2);
 				*size = GetStringBoundingBox(STR_FRAMERATE_SPEED_FACTOR);
 				break;
+			case WID_FRW_SPRITE_CACHE:
+				SetDParamMaxValue(0, 1024 * 1024 * 1024);
+				SetDParamMaxValue(1, 1024 * 1024 * 1024);
+				SetDParamMaxDigits(2, 10);
+				SetDParamMaxDigits(3, 10);
+				SetDParamMaxDigits(4, 10);
+				*size = GetStringBoundingBox(STR_FRAMERATE_SPRITE_CACHE);
+				break;
 
 			case WID_FRW_TIMES_NAMES: {
 				size->width = 0;
@@ -581,6 +687,16 @@ struct FramerateWindow : Window {
 				break;
 			}
 
+			case WID_FRW_COMPANY_TIMES:
+				SetDParam(0, COMPANY_FIRST);
+				for (uint i = 1; i <= CPE_MAX; i++) {
+					SetDParam(i * 2 - 1, 999999);
+					SetDParam(i * 2, 2);
+				}
+				size->width = std::max(GetStringBoundingBox(STR_FRAMERATE_COMPANY_TIMES_HEADING).width, GetStringBoundingBox(STR_FRAMERATE_COMPANY_TIMES).width);
+				size->height = GetCharacterHeight(FS_NORMAL) * (1 + std::max(this->num_companies, 0));
+				break;
+
 			case WID_FRW_TIMES_CURRENT:
 			case WID_FRW_TIMES_AVERAGE:
 			case WID_FRW_ALLOCSIZE: {
@@ -651,6 +767,27 @@ struct FramerateWindow : Window {
 		}
 	}
 
+	/** Render the time attributed to each company, the most demanding first. */
+	void DrawCompanyTimes(const Rect &r) const
+	{
+		std::vector<const Company *> companies;
+		for (const Company *c : Company::Iterate()) companies.push_back(c);
+		auto total = [](const Company *c) { return GetCompanyPerformanceMilliseconds(c->index, CPE_VEHICLES) + GetCompanyPerformanceMilliseconds(c->index, CPE_COMMANDS); };
+		std::stable_sort(companies.begin(), companies.end(), [&total](const Company *a, const Company *b) { return total(a) > total(b); });
+
+		int y = r.top;
+		DrawString(r.left, r.right, y, STR_FRAMERATE_COMPANY_TIMES_HEADING);
+		for (const Company *c : companies) {
+			y += GetCharacterHeight(FS_NORMAL);
+			SetDParam(0, c->index);
+			for (uint e = 0; e < CPE_MAX; e++) {
+				SetDParam(e * 2 + 1, static_cast<uint64_t>(GetCompanyPerformanceMilliseconds(c->index, static_cast<CompanyPerformanceElement>(e)) * 100));
+				SetDParam(e * 2 + 2, 2);
+			}
+			DrawString(r.left, r.right, y, STR_FRAMERATE_COMPANY_TIMES);
+		}
+	}
+
 	void DrawWidget(const Rect &r, WidgetID widget) const override
 	{
 		switch (widget) {
@@ -690,6 +827,9 @@ struct FramerateWindow : Window {
 			case WID_FRW_ALLOCSIZE:
 				DrawElementAllocationsColumn(r);
 				break;
+			case WID_FRW_COMPANY_TIMES:
+				DrawCompanyTimes(r);
+				break;
 		}
 	}
 
@@ -1039,6 +1179,45 @@ void ShowFrametimeGraphWindow(PerformanceElement elem)
 	AllocateWindowDescFront<FrametimeGraphWindow>(&_frametime_graph_window_desc, elem, true);
 }
 
+/**
+ * Get the measurements of a performance element, for reporting them elsewhere.
+ * @param elem The element.
+ * @param count Number of most recent cycles to average the duration over.
+ * @param[out] rate Current rate of the element, in cycles per second.
+ * @param[out] duration Average duration of a cycle, in milliseconds.
+ * @return False iff the element is not being measured.
+ */
+bool GetPerformanceMeasurement(PerformanceElement elem, int count, double &rate, double &duration)
+{
+	PerformanceData &pf = _pf_data[elem];
+	if (pf.num_valid == 0) return false;
+
+	rate = pf.GetRate();
+	duration = pf.GetAverageDurationMilliseconds(std::clamp(count, 1, NUM_FRAMERATE_POINTS));
+	return true;
+}
+
+/** Names of the elements in the console and benchmark output; the AIs get their name from #GetAIName. */
+static const char * const MEASUREMENT_NAMES[PFE_AI0] = {
+	"Game loop",
+	"  GL station ticks",
+	"  GL train ticks",
+	"  GL road vehicle ticks",
+	"  GL ship ticks",
+	"  GL aircraft ticks",
+	"  GL landscape ticks",
+	"    GL industry production",
+	"    GL station ticks",
+	"  GL link graph delays",
+	"  GL tick lateness",
+	"Drawing",
+	"  Viewport drawing",
+	"Video output",
+	"Sound mixing",
+	"AI/GS scripts total",
+	"Game script",
+};
+
 /** Print performance statistics to game console */
 void ConPrintFramerate()
 {
@@ -1048,22 +1227,6 @@ void ConPrintFramerate()
 
 	IConsolePrint(TC_SILVER, "Based on num. data points: {} {} {}", count1, count2, count3);
 
-	static const char *MEASUREMENT_NAMES[PFE_MAX] = {
-		"Game loop",
-		"  GL station ticks",
-		"  GL train ticks",
-		"  GL road vehicle ticks",
-		"  GL ship ticks",
-		"  GL aircraft ticks",
-		"  GL landscape ticks",
-		"  GL link graph delays",
-		"Drawing",
-		"  Viewport drawing",
-		"Video output",
-		"Sound mixing",
-		"AI/GS scripts total",
-		"Game script",
-	};
 	std::string ai_name_buf;
 
 	static const PerformanceElement rate_elements[] = { PFE_GAMELOOP, PFE_DRAWING, PFE_VIDEO };
@@ -1121,3 +1284,85 @@ void ProcessPendingPerformanceMeasurements()
 		_sound_perf_pending.store(false, std::memory_order_relaxed);
 	}
 }
+
+std::string _framerate_benchmark_file; ///< File to write the timings to when benchmarking with the null video driver, if any.
+
+/**
+ * Start keeping every measurement, instead of only the last few, for #WriteFramerateBenchmark.
+ */
+void StartFramerateBenchmark()
+{
+	for (auto &durations : _pf_benchmark_durations) durations.clear();
+	_pf_benchmark = true;
+}
+
+/**
+ * Describe the measurements of an element since the benchmark started.
+ * @param durations The measurements, in microseconds; gets sorted.
+ * @return The number of measurements, their mean, extremes and percentiles
+ *         in milliseconds, and a histogram with power of two microsecond buckets.
+ */
+static nlohmann::json DescribeBenchmarkDurations(std::vector<TimingMeasurement> &durations)
+{
+	std::sort(durations.begin(), durations.end());
+
+	auto to_ms = [](TimingMeasurement duration) { return duration / 1000.0; };
+	auto percentile = [&durations](uint permille) { return durations[std::min(durations.size() - 1, durations.size() * permille / 1000)]; };
+
+	nlohmann::json result;
+	result["count"] = durations.size();
+	result["mean_ms"] = to_ms(std::accumulate(durations.begin(), durations.end(), TimingMeasurement{0})) / durations.size();
+	result["min_ms"] = to_ms(durations.front());
+	result["p50_ms"] = to_ms(percentile(500));
+	result["p90_ms"] = to_ms(percentile(900));
+	result["p99_ms"] = to_ms(percentile(990));
+	result["p999_ms"] = to_ms(percentile(999));
+	result["max_ms"] = to_ms(durations.back());
+
+	/* The measurements are sorted, so each bucket is a range of them. */
+	nlohmann::json &histogram = result["histogram"] = nlohmann::json::array();
+	auto first = durations.begin();
+	for (TimingMeasurement below = 1; first != durations.end(); below *= 2) {
+		auto last = std::lower_bound(first, durations.end(), below);
+		if (last != first) histogram.push_back({ { "below_us", below }, { "count", last - first } });
+		first = last;
+	}
+	return result;
+}
+
+/**
+ * Stop the benchmark and write what was measured since #StartFramerateBenchmark as JSON.
+ * @param filename The file to write to.
+ * @param ticks The number of game ticks run.
+ * @param duration The wall clock time the ticks took.
+ * @return True iff the file was written.
+ */
+bool WriteFramerateBenchmark(const std::string &filename, uint ticks, std::chrono::steady_clock::duration duration)
+{
+	_pf_benchmark = false;
+
+	double seconds = std::chrono::duration<double>(duration).count();
+	nlohmann::json benchmark;
+	benchmark["ticks"] = ticks;
+	benchmark["seconds"] = seconds;
+	benchmark["ticks_per_second"] = seconds > 0 ? ticks / seconds : 0;
+
+	nlohmann::json &elements = benchmark["elements"] = nlohmann::json::object();
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		auto &durations = _pf_benchmark_durations[e];
+		if (durations.empty()) continue;
+
+		std::string name = e < PFE_AI0 ? std::string(StrTrimView(MEASUREMENT_NAMES[e])) : fmt::format("AI {} {}", e - PFE_AI0 + 1, GetAIName(e - PFE_AI0));
+		elements[name] = DescribeBenchmarkDurations(durations);
+		durations.clear();
+		durations.shrink_to_fit();
+	}
+
+	FILE *file = FioFOpenFile(filename, "w", NO_DIRECTORY);
+	if (file == nullptr) return false;
+
+	std::string json = benchmark.dump(4);
+	size_t written = fwrite(json.data(), 1, json.size(), file);
+	FioFCloseFile(file);
+	return written == json.size();
+}
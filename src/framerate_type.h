@@ -37,6 +37,9 @@
 
 #include "stdafx.h"
 #include "core/enum_type.hpp"
+#include "company_type.h"
+
+#include <chrono>
 
 /**
  * Elements of game performance that can be measured.
@@ -53,7 +56,10 @@ enum PerformanceElement {
 	PFE_GL_SHIPS,      ///< Time spent processing ships
 	PFE_GL_AIRCRAFT,   ///< Time spent processing aircraft
 	PFE_GL_LANDSCAPE,  ///< Time spent processing other world features
+	PFE_GL_INDUSTRIES, ///< Time spent processing industry production, part of #PFE_GL_LANDSCAPE
+	PFE_GL_STATIONS,   ///< Time spent processing station ratings and acceptance, part of #PFE_GL_LANDSCAPE
 	PFE_GL_LINKGRAPH,  ///< Time spent waiting for link graph background jobs
+	PFE_GL_LATENESS,   ///< Time by which the start of game loop ticks was later than scheduled
 	PFE_DRAWING,       ///< Speed of drawing world and GUI.
 	PFE_DRAWWORLD,     ///< Time spent drawing world viewports in GUI
 	PFE_VIDEO,         ///< Speed of painting drawn video buffer.
@@ -118,9 +124,56 @@ public:
 	PerformanceAccumulator(PerformanceElement elem);
 	~PerformanceAccumulator();
 	static void Reset(PerformanceElement elem);
+	static void Add(PerformanceElement elem, std::chrono::microseconds duration);
+};
+
+/** What the time attributed to a company is spent on, see #CompanyPerformanceMeasurer. */
+enum CompanyPerformanceElement : uint8_t {
+	CPE_VEHICLES,   ///< Ticking the company's vehicles, including their pathfinding.
+	CPE_PATHFINDER, ///< Pathfinding for the company's vehicles.
+	CPE_COMMANDS,   ///< Executing the company's commands.
+	CPE_MAX,        ///< End of enum, must be last.
+};
+
+extern bool _company_performance_accounting;
+
+/**
+ * RAII class attributing the time spent in a block to a company, when the
+ * accounting is enabled. Unlike the other classes it can be used from any thread.
+ */
+class CompanyPerformanceMeasurer {
+	CompanyPerformanceElement elem;
+	Owner owner;
+	TimingMeasurement start_time = 0;
+
+	void Start();
+	void Finish();
+public:
+	/**
+	 * Begin attributing time to a company.
+	 * @param elem What the time is spent on.
+	 * @param owner The company; time of other owners is not accounted.
+	 */
+	CompanyPerformanceMeasurer(CompanyPerformanceElement elem, Owner owner) : elem(elem), owner(owner)
+	{
+		if (_company_performance_accounting && owner < MAX_COMPANIES) this->Start();
+	}
+
+	/** Finish attributing time to the company. */
+	~CompanyPerformanceMeasurer()
+	{
+		if (this->start_time != 0) this->Finish();
+	}
 };
 
+void CompanyPerformanceTick();
+double GetCompanyPerformanceMilliseconds(CompanyID company, CompanyPerformanceElement elem);
+
 void ShowFramerateWindow();
+extern std::string _framerate_benchmark_file;
+void StartFramerateBenchmark();
+bool WriteFramerateBenchmark(const std::string &filename, uint ticks, std::chrono::steady_clock::duration duration);
 void ProcessPendingPerformanceMeasurements();
+bool GetPerformanceMeasurement(PerformanceElement elem, int count, double &rate, double &duration);
 
 #endif /* FRAMERATE_TYPE_H */
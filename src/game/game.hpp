@@ -77,6 +77,11 @@ public:
 	static void Rescan();
 	static void ResetConfig();
 
+	/**
+	 * Call the Save function of the GameScript, before saving the game.
+	 */
+	static void PrepareSave();
+
 	/**
 	 * Save data from a GameScript to a savegame.
 	 */
@@ -91,8 +91,7 @@
 	Game::info = info;
 	Game::instance = new GameInstance();
 	Game::instance->Initialize(info);
-	Game::instance->LoadOnStack(config->GetToLoadData());
-	config->SetToLoadData(nullptr);
+	Game::instance->SetLoadData(config->TakeToLoadData());
 
 	cur_company.Restore();
 
@@ -208,12 +207,19 @@
 }
 
 
-/* static */ void Game::Save()
+/* static */ void Game::PrepareSave()
 {
 	if (Game::instance != nullptr && (!_networking || _network_server)) {
 		Backup<CompanyID> cur_company(_current_company, OWNER_DEITY);
-		Game::instance->Save();
+		Game::instance->PrepareSave();
 		cur_company.Restore();
+	}
+}
+
+/* static */ void Game::Save()
+{
+	if (Game::instance != nullptr && (!_networking || _network_server)) {
+		Game::instance->Save();
 	} else {
 		GameInstance::SaveEmpty();
 	}
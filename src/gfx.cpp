@@ -50,7 +50,7 @@ PauseMode _pause_mode;
 GameSessionStats _game_session_stats; ///< Statistics about the current session.
 
 static uint8_t _stringwidth_table[FS_END][224]; ///< Cache containing width of often used characters. @see GetCharacterWidth()
-DrawPixelInfo *_cur_dpi;
+thread_local DrawPixelInfo *_cur_dpi; ///< The area being drawn to; per thread, as parts of the viewports are drawn by the workers.
 
 static void GfxMainBlitterViewport(const Sprite *sprite, int x, int y, BlitterMode mode, const SubSprite *sub = nullptr, SpriteID sprite_id = SPR_CURSOR_MOUSE);
 static void GfxMainBlitter(const Sprite *sprite, int x, int y, BlitterMode mode, const SubSprite *sub = nullptr, SpriteID sprite_id = SPR_CURSOR_MOUSE, ZoomLevel zoom = ZOOM_LVL_NORMAL);
@@ -70,8 +70,8 @@ int _gui_scale_cfg;                         ///< GUI scale in config.
  * @ingroup dirty
  */
 static Rect _invalid_rect;
-static const uint8_t *_colour_remap_ptr;
-static uint8_t _string_colourremap[3]; ///< Recoloursprite for stringdrawing. The grf loader ensures that #SpriteType::Font sprites only use colours 0 to 2.
+static thread_local const uint8_t *_colour_remap_ptr;
+static thread_local uint8_t _string_colourremap[3]; ///< Recoloursprite for stringdrawing. The grf loader ensures that #SpriteType::Font sprites only use colours 0 to 2.
 
 static const uint DIRTY_BLOCK_HEIGHT   = 8;
 static const uint DIRTY_BLOCK_WIDTH    = 64;
@@ -479,6 +479,69 @@ static void SetColourRemap(TextColour colour)
 	_colour_remap_ptr = _string_colourremap;
 }
 
+/** A glyph of a laid out line, ready to be blitted. */
+struct GlyphToDraw {
+	const Sprite *sprite; ///< The sprite of the glyph.
+	int x;                ///< Left position of the glyph, before the sprite's offset.
+	int y;                ///< Top position of the glyph, before the sprite's offset.
+	bool has_shadow;      ///< Whether the glyph gets a shadow; sprite glyphs never do.
+};
+
+/**
+ * Blit a batch of glyphs with the current colour remap.
+ * Glyphs are never scaled nor partially drawn through a sub sprite, so unlike
+ * #GfxBlitter this only clips against the drawing area, and it sets up the
+ * blitter once for the whole batch instead of once per glyph.
+ * @param glyphs The glyphs to draw.
+ * @param offset Offset of the glyphs in both directions, e.g. for the shadow.
+ * @param shadow Whether this is the shadow pass, i.e. only draw glyphs with a shadow.
+ */
+static void GfxBlitGlyphs(std::span<const GlyphToDraw> glyphs, int offset, bool shadow)
+{
+	const DrawPixelInfo *dpi = _cur_dpi;
+	Blitter *blitter = BlitterFactory::GetCurrentBlitter();
+
+	Blitter::BlitterParams bp;
+	bp.dst = dpi->dst_ptr;
+	bp.pitch = dpi->pitch;
+	bp.remap = _colour_remap_ptr;
+
+	for (const GlyphToDraw &glyph : glyphs) {
+		if (shadow && !glyph.has_shadow) continue;
+
+		const Sprite *sprite = glyph.sprite;
+		int x = glyph.x + offset + sprite->x_offs - dpi->left;
+		int y = glyph.y + offset + sprite->y_offs - dpi->top;
+
+		bp.sprite = sprite->data;
+		bp.sprite_width = sprite->width;
+		bp.sprite_height = sprite->height;
+		bp.width = sprite->width;
+		bp.height = sprite->height;
+		bp.skip_left = 0;
+		bp.skip_top = 0;
+
+		/* Clip against the drawing area. */
+		if (x < 0) {
+			bp.width += x;
+			bp.skip_left = -x;
+			x = 0;
+		}
+		if (y < 0) {
+			bp.height += y;
+			bp.skip_top = -y;
+			y = 0;
+		}
+		bp.width = std::min(bp.width, dpi->width - x);
+		bp.height = std::min(bp.height, dpi->height - y);
+		if (bp.width <= 0 || bp.height <= 0) continue;
+
+		bp.left = x;
+		bp.top = y;
+		blitter->Draw(&bp, BM_COLOUR_REMAP, ZOOM_LVL_NORMAL);
+	}
+}
+
 /**
  * Drawing routine for drawing a laid out line of text.
  * @param line      String to draw.
@@ -577,53 +640,70 @@ static int DrawLayoutLine(const ParagraphLayouter::Line &line, int y, int left,
 
 	const uint shadow_offset = ScaleGUITrad(1);
 
-	/* Draw shadow, then foreground */
-	for (bool do_shadow : { true, false }) {
-		bool colour_has_shadow = false;
-		for (int run_index = 0; run_index < line.CountRuns(); run_index++) {
-			const ParagraphLayouter::VisualRun &run = line.GetVisualRun(run_index);
-			const auto &glyphs = run.GetGlyphs();
-			const auto &positions = run.GetPositions();
-			const Font *f = run.GetFont();
+	/* Look up the glyphs of all runs once, for both the shadow and the foreground. */
+	thread_local std::vector<GlyphToDraw> glyphs_to_draw;
+	thread_local std::vector<size_t> run_ends;
+	glyphs_to_draw.clear();
+	run_ends.clear();
 
-			FontCache *fc = f->fc;
-			TextColour colour = f->colour;
-			colour_has_shadow = (colour & TC_NO_SHADE) == 0 && colour != TC_BLACK;
-			SetColourRemap(do_shadow ? TC_BLACK : colour); // the last run also sets the colour for the truncation dots
-			if (do_shadow && (!fc->GetDrawGlyphShadow() || !colour_has_shadow)) continue;
+	DrawPixelInfo *dpi = _cur_dpi;
+	int dpi_left  = dpi->left;
+	int dpi_right = dpi->left + dpi->width - 1;
 
-			DrawPixelInfo *dpi = _cur_dpi;
-			int dpi_left  = dpi->left;
-			int dpi_right = dpi->left + dpi->width - 1;
+	for (int run_index = 0; run_index < line.CountRuns(); run_index++) {
+		const ParagraphLayouter::VisualRun &run = line.GetVisualRun(run_index);
+		const auto &glyphs = run.GetGlyphs();
+		const auto &positions = run.GetPositions();
+		FontCache *fc = run.GetFont()->fc;
 
-			for (int i = 0; i < run.GetGlyphCount(); i++) {
-				GlyphID glyph = glyphs[i];
+		for (int i = 0; i < run.GetGlyphCount(); i++) {
+			GlyphID glyph = glyphs[i];
 
-				/* Not a valid glyph (empty) */
-				if (glyph == 0xFFFF) continue;
+			/* Not a valid glyph (empty) */
+			if (glyph == 0xFFFF) continue;
 
-				int begin_x = positions[i].x     + left - offset_x;
-				int end_x   = positions[i + 1].x + left - offset_x  - 1;
-				int top     = positions[i].y + y;
+			int begin_x = positions[i].x     + left - offset_x;
+			int end_x   = positions[i + 1].x + left - offset_x  - 1;
+			int top     = positions[i].y + y;
 
-				/* Truncated away. */
-				if (truncation && (begin_x < min_x || end_x > max_x)) continue;
+			/* Truncated away. */
+			if (truncation && (begin_x < min_x || end_x > max_x)) continue;
 
-				const Sprite *sprite = fc->GetGlyph(glyph);
-				/* Check clipping (the "+ 1" is for the shadow). */
-				if (begin_x + sprite->x_offs > dpi_right || begin_x + sprite->x_offs + sprite->width /* - 1 + 1 */ < dpi_left) continue;
+			const Sprite *sprite = fc->GetGlyph(glyph);
+			/* Check clipping (the "+ 1" is for the shadow). */
+			if (begin_x + sprite->x_offs > dpi_right || begin_x + sprite->x_offs + sprite->width /* - 1 + 1 */ < dpi_left) continue;
 
-				if (do_shadow && (glyph & SPRITE_GLYPH) != 0) continue;
+			glyphs_to_draw.push_back({sprite, begin_x, top, (glyph & SPRITE_GLYPH) == 0});
+		}
+		run_ends.push_back(glyphs_to_draw.size());
+	}
 
-				GfxMainBlitter(sprite, begin_x + (do_shadow ? shadow_offset : 0), top + (do_shadow ? shadow_offset : 0), BM_COLOUR_REMAP);
-			}
+	if (truncation) {
+		int x = (_current_text_dir == TD_RTL) ? left : (right - 3 * dot_width);
+		for (int i = 0; i < 3; i++, x += dot_width) {
+			glyphs_to_draw.push_back({dot_sprite, x, y, true});
+		}
+	}
+
+	/* Draw shadow, then foreground */
+	for (bool do_shadow : { true, false }) {
+		bool colour_has_shadow = false;
+		size_t run_begin = 0;
+		for (int run_index = 0; run_index < line.CountRuns(); run_index++) {
+			const Font *f = line.GetVisualRun(run_index).GetFont();
+			std::span<const GlyphToDraw> run_glyphs(glyphs_to_draw.data() + run_begin, run_ends[run_index] - run_begin);
+			run_begin = run_ends[run_index];
+
+			TextColour colour = f->colour;
+			colour_has_shadow = (colour & TC_NO_SHADE) == 0 && colour != TC_BLACK;
+			SetColourRemap(do_shadow ? TC_BLACK : colour); // the last run also sets the colour for the truncation dots
+			if (do_shadow && (!f->fc->GetDrawGlyphShadow() || !colour_has_shadow)) continue;
+
+			GfxBlitGlyphs(run_glyphs, do_shadow ? shadow_offset : 0, do_shadow);
 		}
 
 		if (truncation && (!do_shadow || (dot_has_shadow && colour_has_shadow))) {
-			int x = (_current_text_dir == TD_RTL) ? left : (right - 3 * dot_width);
-			for (int i = 0; i < 3; i++, x += dot_width) {
-				GfxMainBlitter(dot_sprite, x + (do_shadow ? shadow_offset : 0), y + (do_shadow ? shadow_offset : 0), BM_COLOUR_REMAP);
-			}
+			GfxBlitGlyphs(std::span<const GlyphToDraw>(glyphs_to_draw).subspan(run_begin), do_shadow ? shadow_offset : 0, do_shadow);
 		}
 	}
 
@@ -1543,6 +1623,8 @@ void AddDirtyBlock(int left, int top, int right, int bottom)
  */
 void MarkWholeScreenDirty()
 {
+	ClearViewportChunkCache();
+	ClearFormattedStringCache();
 	AddDirtyBlock(0, 0, _screen.width, _screen.height);
 }
 
@@ -34,6 +34,15 @@
 
 /** Cache of ParagraphLayout lines. */
 Layouter::LineCache *Layouter::linecache;
+std::list<const Layouter::LineCacheKey *> Layouter::linecache_used;
+Layouter::LineCacheStatistics Layouter::linecache_stats{};
+
+/** Memory budget of the linecache; the least recently used lines are removed when it is exceeded. */
+static const size_t LINE_CACHE_BUDGET = 8 * 1024 * 1024;
+/** Estimated memory use of a cached line, besides its characters. */
+static const size_t LINE_CACHE_LINE_SIZE = 512;
+/** Estimated memory use of each character of a cached line: the key, the layout buffer, and its glyphs and positions. */
+static const size_t LINE_CACHE_CHAR_SIZE = 32;
 
 /** Cache of Font instances. */
 Layouter::FontColourMap Layouter::fonts[FS_END];
@@ -379,14 +388,24 @@ Layouter::LineCacheItem &Layouter::GetCachedParagraphLayout(std::string_view str
 
 	if (auto match = linecache->find(LineCacheQuery{state, str});
 		match != linecache->end()) {
+		linecache_stats.hits++;
+		linecache_used.splice(linecache_used.begin(), linecache_used, match->second.used);
 		return match->second;
 	}
 
 	/* Create missing entry */
+	linecache_stats.misses++;
 	LineCacheKey key;
 	key.state_before = state;
 	key.str.assign(str);
-	return (*linecache)[key];
+	auto [it, inserted] = linecache->try_emplace(std::move(key));
+	assert(inserted);
+
+	LineCacheItem &line = it->second;
+	line.size = LINE_CACHE_LINE_SIZE + str.size() * LINE_CACHE_CHAR_SIZE;
+	line.used = linecache_used.insert(linecache_used.begin(), &it->first);
+	linecache_stats.size += line.size;
+	return line;
 }
 
 /**
@@ -395,15 +414,28 @@ Layouter::LineCacheItem &Layouter::GetCachedParagraphLayout(std::string_view str
 void Layouter::ResetLineCache()
 {
 	if (linecache != nullptr) linecache->clear();
+	linecache_used.clear();
+	linecache_stats.size = 0;
 }
 
 /**
  * Reduce the size of linecache if necessary to prevent infinite growth.
+ * The least recently used lines are removed until the linecache is within its memory budget.
+ * This may not be done while a Layouter exists, as its lines are in the linecache.
  */
 void Layouter::ReduceLineCache()
 {
-	if (linecache != nullptr) {
-		/* TODO LRU cache would be fancy, but not exactly necessary */
-		if (linecache->size() > 4096) ResetLineCache();
+	if (linecache == nullptr || linecache_stats.size <= LINE_CACHE_BUDGET) return;
+
+	/* Remove a bit more, so this isn't needed again right away. */
+	while (!linecache_used.empty() && linecache_stats.size > LINE_CACHE_BUDGET * 3 / 4) {
+		auto it = linecache->find(*linecache_used.back());
+		linecache_stats.size -= it->second.size;
+		linecache_stats.evictions++;
+		linecache_used.pop_back();
+		linecache->erase(it);
 	}
+
+	Debug(misc, 4, "Line cache: {} lines, {} bytes, {} hits, {} misses, {} evictions",
+			linecache->size(), linecache_stats.size, linecache_stats.hits, linecache_stats.misses, linecache_stats.evictions);
 }
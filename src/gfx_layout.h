@@ -160,12 +160,25 @@ public:
 		FontState state_after;     ///< Font state after the line.
 		ParagraphLayouter *layout; ///< Layout of the line.
 
-		LineCacheItem() : buffer(nullptr), layout(nullptr) {}
+		size_t size;                                    ///< Estimated memory use of the line.
+		std::list<const LineCacheKey *>::iterator used; ///< Position of the line in the least recently used list.
+
+		LineCacheItem() : buffer(nullptr), layout(nullptr), size(0) {}
 		~LineCacheItem() { delete layout; free(buffer); }
 	};
+
+	/** Statistics of the linecache. */
+	struct LineCacheStatistics {
+		size_t size;       ///< Estimated memory use of all lines.
+		uint64_t hits;     ///< Number of lines that were found in the cache.
+		uint64_t misses;   ///< Number of lines that had to be laid out.
+		uint64_t evictions; ///< Number of lines that were removed to stay in the memory budget.
+	};
 private:
 	typedef std::map<LineCacheKey, LineCacheItem, LineCacheCompare> LineCache;
 	static LineCache *linecache;
+	static std::list<const LineCacheKey *> linecache_used; ///< Lines of the linecache, most recently used first.
+	static LineCacheStatistics linecache_stats;
 
 	static LineCacheItem &GetCachedParagraphLayout(std::string_view str, const FontState &state);
 
@@ -183,6 +196,7 @@ public:
 	static void ResetFontCache(FontSize size);
 	static void ResetLineCache();
 	static void ReduceLineCache();
+	static const LineCacheStatistics &GetLineCacheStatistics() { return linecache_stats; }
 };
 
 #endif /* GFX_LAYOUT_H */
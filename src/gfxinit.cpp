@@ -10,7 +10,7 @@
 #include "stdafx.h"
 #include "fios.h"
 #include "newgrf.h"
-#include "3rdparty/md5/md5.h"
+#include "scan_cache.h"
 #include "fontcache.h"
 #include "gfx_func.h"
 #include "transparency.h"
@@ -18,6 +18,8 @@
 #include "video/video_driver.hpp"
 #include "window_func.h"
 #include "palette_func.h"
+#include "spritecache.h"
+#include "viewport_func.h"
 
 /* The type of set we're replacing */
 #define SET_TYPE "graphics"
@@ -225,6 +227,8 @@ static void RealChangeBlitter(const char *repl_blitter)
 	if (strcmp(cur_blitter, repl_blitter) == 0) return;
 
 	Debug(driver, 1, "Switching blitter from '{}' to '{}'... ", cur_blitter, repl_blitter);
+	/* The old blitter is deleted, so stop the workers encoding sprites for it. */
+	DiscardAsyncSprites();
 	Blitter *new_blitter = BlitterFactory::SelectBlitter(repl_blitter);
 	if (new_blitter == nullptr) NOT_REACHED();
 	Debug(driver, 1, "Successfully switched to {}.", repl_blitter);
@@ -277,10 +281,15 @@ static bool SwitchNewGRFBlitter()
 		{ "8bpp-optimized",  2,  8,  8,  8,  8 },
 		{ "40bpp-anim",      2,  8, 32,  8, 32 },
 #ifdef WITH_SSE
+		{ "32bpp-avx2",      0, 32, 32,  8, 32 },
 		{ "32bpp-sse4",      0, 32, 32,  8, 32 },
 		{ "32bpp-ssse3",     0, 32, 32,  8, 32 },
 		{ "32bpp-sse2",      0, 32, 32,  8, 32 },
 		{ "32bpp-sse4-anim", 1, 32, 32,  8, 32 },
+#endif
+#ifdef WITH_NEON
+		{ "32bpp-neon",      0,  8, 32,  8, 32 },
+		{ "32bpp-neon-anim", 1,  8, 32,  8, 32 },
 #endif
 		{ "32bpp-optimized", 0,  8, 32,  8, 32 },
 #ifdef WITH_SSE
@@ -334,6 +343,7 @@ void GfxLoadSprites()
 	GfxInitSpriteMem();
 	LoadSpriteTables();
 	GfxInitPalettes();
+	ClearViewportTileCache();
 
 	UpdateCursorSize();
 }
@@ -448,19 +458,10 @@ MD5File::ChecksumResult MD5File::CheckMD5(Subdirectory subdir, size_t max_size)
 
 	size = std::min(size, max_size);
 
-	Md5 checksum;
-	uint8_t buffer[1024];
-	MD5Hash digest;
-	size_t len;
-
-	while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, f)) != 0 && size != 0) {
-		size -= len;
-		checksum.Append(buffer, len);
-	}
+	MD5Hash digest = CalcFileMD5(f, size, this->filename, subdir);
 
 	FioFCloseFile(f);
 
-	checksum.Finish(digest);
 	return this->hash == digest ? CR_MATCH : CR_MISMATCH;
 }
 
@@ -476,22 +477,11 @@ template <class Tbase_set>
 {
 	if (BaseMedia<Tbase_set>::used_set != nullptr) return true;
 
-	const Tbase_set *best = nullptr;
-	for (const Tbase_set *c = BaseMedia<Tbase_set>::available_sets; c != nullptr; c = c->next) {
-		/* Skip unusable sets */
-		if (c->GetNumMissing() != 0) continue;
-
-		if (best == nullptr ||
-				(best->fallback && !c->fallback) ||
-				best->valid_files < c->valid_files ||
-				(best->valid_files == c->valid_files && (
-					(best->shortname == c->shortname && best->version < c->version) ||
-					(best->palette != PAL_DOS && c->palette == PAL_DOS)))) {
-			best = c;
-		}
-	}
-
-	BaseMedia<Tbase_set>::used_set = best;
+	/* Prefer a newer version of the same set, and otherwise the original DOS palette. */
+	BaseMedia<Tbase_set>::used_set = BaseMedia<Tbase_set>::FindBestSet([](const Tbase_set *best, const Tbase_set *c) {
+		return (best->shortname == c->shortname && best->version < c->version) ||
+				(best->palette != PAL_DOS && c->palette == PAL_DOS);
+	});
 	return BaseMedia<Tbase_set>::used_set != nullptr;
 }
 
@@ -201,6 +201,27 @@ protected:
 	StringID format_str_y_axis;
 	uint8_t colours[GRAPH_MAX_DATASETS];
 	OverflowSafeInt64 cost[GRAPH_MAX_DATASETS][GRAPH_NUM_MONTHS]; ///< Stored costs for the last #GRAPH_NUM_MONTHS months
+	ValuesInterval ranges[GRAPH_MAX_DATASETS]; ///< Highest and lowest valid datapoint of each dataset; not limited by zero.
+
+	/**
+	 * Update the cached highest and lowest value of a dataset, after its datapoints changed.
+	 * @param dataset The dataset to update the range of.
+	 */
+	void UpdateDataRange(int dataset)
+	{
+		ValuesInterval &range = this->ranges[dataset];
+		range.highest = INT64_MIN;
+		range.lowest  = INT64_MAX;
+
+		for (int j = 0; j < this->num_on_x_axis; j++) {
+			OverflowSafeInt64 datapoint = this->cost[dataset][j];
+
+			if (datapoint != INVALID_DATAPOINT) {
+				range.highest = std::max(range.highest, datapoint);
+				range.lowest  = std::min(range.lowest, datapoint);
+			}
+		}
+	}
 
 	/**
 	 * Get the interval that contains the graph's data. Excluded data is ignored to show smaller values in
@@ -218,14 +239,8 @@ protected:
 
 		for (int i = 0; i < this->num_dataset; i++) {
 			if (HasBit(this->excluded_data, i)) continue;
-			for (int j = 0; j < this->num_on_x_axis; j++) {
-				OverflowSafeInt64 datapoint = this->cost[i][j];
-
-				if (datapoint != INVALID_DATAPOINT) {
-					current_interval.highest = std::max(current_interval.highest, datapoint);
-					current_interval.lowest  = std::min(current_interval.lowest, datapoint);
-				}
-			}
+			current_interval.highest = std::max(current_interval.highest, this->ranges[i].highest);
+			current_interval.lowest  = std::min(current_interval.lowest, this->ranges[i].lowest);
 		}
 
 		/* Always include zero in the shown range. */
@@ -638,6 +653,7 @@ public:
 					}
 					i++;
 				}
+				this->UpdateDataRange(numd);
 			}
 			numd++;
 		}
@@ -1123,6 +1139,7 @@ struct PaymentRatesGraphWindow : BaseGraphWindow {
 			for (uint j = 0; j != this->num_on_x_axis; j++) {
 				this->cost[i][j] = GetTransportedGoodsIncome(10, 20, j * 4 + 4, cs->Index());
 			}
+			this->UpdateDataRange(i);
 			i++;
 		}
 		this->num_dataset = i;
@@ -1200,9 +1217,7 @@ struct PerformanceRatingDetailWindow : Window {
 	{
 		/* Update all company stats with the current data
 		 * (this is because _score_info is not saved to a savegame) */
-		for (Company *c : Company::Iterate()) {
-			UpdateCompanyRatingAndValue(c, false);
-		}
+		UpdateAllCompanyRatings();
 
 		this->timeout = Ticks::DAY_TICKS * 5;
 	}
@@ -28,12 +28,14 @@ void GroundVehicle<T, Type>::PowerChanged()
 	uint32_t number_of_parts = 0;
 	uint16_t max_track_speed = this->vcache.cached_max_speed; // Max track speed in internal units.
 
-	for (const T *u = v; u != nullptr; u = u->Next()) {
+	for (T *u = T::From(this); u != nullptr; u = u->Next()) {
 		uint32_t current_power = u->GetPower() + u->GetPoweredPartPower(u);
 		total_power += current_power;
+		u->gcache.cached_part_power = current_power;
 
 		/* Only powered parts add tractive effort. */
-		if (current_power > 0) max_te += u->GetWeight() * u->GetTractiveEffort();
+		u->gcache.cached_part_te = current_power > 0 ? u->GetTractiveEffort() : 0;
+		max_te += u->gcache.cached_part_weight * u->gcache.cached_part_te;
 		number_of_parts++;
 
 		/* Get minimum max speed for this track. */
@@ -56,6 +58,18 @@ void GroundVehicle<T, Type>::PowerChanged()
 
 	this->gcache.cached_air_drag = air_drag + 3 * air_drag * number_of_parts / 20;
 
+	this->SetPowerAndTractiveEffort(total_power, max_te);
+	this->gcache.cached_max_track_speed = max_track_speed;
+}
+
+/**
+ * Store the power and tractive effort of the consist.
+ * @param total_power Total power of the consist.
+ * @param max_te Sum of the weight times the tractive effort coefficient of the powered parts.
+ */
+template <class T, VehicleType Type>
+void GroundVehicle<T, Type>::SetPowerAndTractiveEffort(uint32_t total_power, uint32_t max_te)
+{
 	max_te *= GROUND_ACCELERATION; // Tractive effort in (tonnes * 1000 * 9.8 =) N.
 	max_te /= 256;  // Tractive effort is a [0-255] coefficient.
 	if (this->gcache.cached_power != total_power || this->gcache.cached_max_te != max_te) {
@@ -67,8 +81,6 @@ void GroundVehicle<T, Type>::PowerChanged()
 		SetWindowDirty(WC_VEHICLE_DETAILS, this->index);
 		SetWindowWidgetDirty(WC_VEHICLE_VIEW, this->index, WID_VV_START_STOP);
 	}
-
-	this->gcache.cached_max_track_speed = max_track_speed;
 }
 
 /**
@@ -84,17 +96,83 @@ void GroundVehicle<T, Type>::CargoChanged()
 	for (T *u = T::From(this); u != nullptr; u = u->Next()) {
 		uint32_t current_weight = u->GetWeight();
 		weight += current_weight;
+		u->gcache.cached_part_weight = current_weight;
+		u->gcache.cached_cargo_count = u->cargo.StoredCount();
 		/* Slope steepness is in percent, result in N. */
 		u->gcache.cached_slope_resistance = current_weight * u->GetSlopeSteepness() * 100;
 	}
 
+	this->SetWeight(weight);
+
+	/* Now update vehicle power (tractive effort is dependent on weight). */
+	this->PowerChanged();
+}
+
+/**
+ * Store the weight of the consist.
+ * @param weight Total weight of the consist.
+ */
+template <class T, VehicleType Type>
+void GroundVehicle<T, Type>::SetWeight(uint32_t weight)
+{
 	/* Store consist weight in cache. */
 	this->gcache.cached_weight = std::max(1u, weight);
 	/* Friction in bearings and other mechanical parts is 0.1% of the weight (result in N). */
 	this->gcache.cached_axle_resistance = 10 * weight;
+}
 
-	/* Now update vehicle power (tractive effort is dependent on weight). */
-	this->PowerChanged();
+/**
+ * Recalculates the cached weight, power and tractive effort of a vehicle after only the
+ * amount of cargo in some of its parts changed, e.g. while loading and unloading.
+ * Only the parts with a different amount of cargo are evaluated again; the totals are
+ * updated from the cached values of the other parts. Consists with NewGRF vehicles are
+ * always evaluated completely. Everything else, like the length of the consist and the
+ * track it is on, is assumed not to have changed.
+ */
+template <class T, VehicleType Type>
+void GroundVehicle<T, Type>::CargoAmountChanged()
+{
+	assert(this->First() == this);
+
+	/* Nothing has been cached yet, so determine everything. */
+	if (this->gcache.cached_weight == 0) {
+		this->CargoChanged();
+		return;
+	}
+
+	/* The property callback of NewGRF vehicles can look at the whole consist, its random bits
+	 * and triggers, so a part whose cargo did not change may still get different properties.
+	 * Evaluate all parts, so the result is the same as after loading a game. */
+	for (const T *u = T::From(this); u != nullptr; u = u->Next()) {
+		if (u->GetGRF() != nullptr) {
+			this->CargoChanged();
+			return;
+		}
+	}
+
+	uint32_t weight = 0;
+	uint32_t total_power = 0;
+	uint32_t max_te = 0;
+
+	for (T *u = T::From(this); u != nullptr; u = u->Next()) {
+		if (u->gcache.cached_cargo_count != u->cargo.StoredCount()) {
+			u->gcache.cached_part_weight = u->GetWeight();
+			u->gcache.cached_cargo_count = u->cargo.StoredCount();
+			/* Slope steepness is in percent, result in N. */
+			u->gcache.cached_slope_resistance = u->gcache.cached_part_weight * u->GetSlopeSteepness() * 100;
+
+			/* The cargo may have triggered a different appearance with different properties. */
+			u->gcache.cached_part_power = u->GetPower() + u->GetPoweredPartPower(u);
+			u->gcache.cached_part_te = u->gcache.cached_part_power > 0 ? u->GetTractiveEffort() : 0;
+		}
+
+		weight += u->gcache.cached_part_weight;
+		total_power += u->gcache.cached_part_power;
+		max_te += u->gcache.cached_part_weight * u->gcache.cached_part_te;
+	}
+
+	this->SetWeight(weight);
+	this->SetPowerAndTractiveEffort(total_power, max_te);
 }
 
 /**
@@ -33,6 +33,10 @@ struct GroundVehicleCache {
 	uint32_t cached_slope_resistance; ///< Resistance caused by weight when this vehicle part is at a slope.
 	uint32_t cached_max_te;           ///< Maximum tractive effort of consist (valid only for the first engine).
 	uint16_t cached_axle_resistance;  ///< Resistance caused by the axles of the vehicle (valid only for the first engine).
+	uint16_t cached_part_weight;      ///< Weight of this vehicle part, including its cargo.
+	uint32_t cached_part_power;       ///< Power of this vehicle part.
+	uint8_t cached_part_te;           ///< Tractive effort coefficient of this vehicle part, zero when it is not powered.
+	uint cached_cargo_count;          ///< Amount of cargo in this vehicle part when its weight was determined.
 
 	/* Cached acceleration values, recalculated on load and each time a vehicle is added to/removed from the consist. */
 	uint16_t cached_max_track_speed;  ///< Maximum consist speed (in internal units) limited by track type (valid only for the first engine).
@@ -90,6 +94,9 @@ struct GroundVehicle : public SpecializedVehicle<T, Type> {
 
 	void PowerChanged();
 	void CargoChanged();
+	void CargoAmountChanged();
+	void SetWeight(uint32_t weight);
+	void SetPowerAndTractiveEffort(uint32_t total_power, uint32_t max_te);
 	int GetAcceleration() const;
 	bool IsChainInDepot() const override;
 
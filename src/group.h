@@ -47,8 +47,10 @@ struct GroupStatistics {
 	}
 
 	uint16_t GetNumEngines(EngineID engine) const;
+	void Add(const GroupStatistics &other, int sign);
 
 	static GroupStatistics &Get(CompanyID company, GroupID id_g, VehicleType type);
+	static GroupStatistics &GetWithSubgroups(CompanyID company, GroupID id_g, VehicleType type);
 	static GroupStatistics &Get(const Vehicle *v);
 	static GroupStatistics &GetAllGroup(const Vehicle *v);
 
@@ -77,6 +79,7 @@ struct Group : GroupPool::PoolItem<&_group_pool> {
 	uint8_t flags;                ///< Group flags
 	Livery livery;              ///< Custom colour scheme for vehicles in this group
 	GroupStatistics statistics; ///< NOSAVE: Statistics and caches on the vehicles in the group.
+	GroupStatistics statistics_with_subgroups; ///< NOSAVE: Statistics on the vehicles in the group and all its sub-groups.
 
 	bool folded;                ///< NOSAVE: Is this group folded in the group view?
 
@@ -53,6 +53,22 @@ uint16_t GroupStatistics::GetNumEngines(EngineID engine) const
 	return 0;
 }
 
+/**
+ * Add the vehicle and engine counts and profits of other statistics to these.
+ * @param other The statistics to add.
+ * @param sign 1 to add, -1 to subtract.
+ */
+void GroupStatistics::Add(const GroupStatistics &other, int sign)
+{
+	assert(sign == 1 || sign == -1);
+
+	this->num_vehicle += other.num_vehicle * sign;
+	this->profit_last_year += other.profit_last_year * sign;
+	this->num_vehicle_min_age += other.num_vehicle_min_age * sign;
+	this->profit_last_year_min_age += other.profit_last_year_min_age * sign;
+	for (const auto &[engine, count] : other.num_engines) this->num_engines[engine] += count * sign;
+}
+
 /**
  * Returns the GroupStatistics for a specific group.
  * @param company Owner of the group.
@@ -75,6 +91,43 @@ uint16_t GroupStatistics::GetNumEngines(EngineID engine) const
 	NOT_REACHED();
 }
 
+/**
+ * Returns the GroupStatistics for a specific group including all its sub-groups.
+ * @param company Owner of the group.
+ * @param id_g    GroupID of the group.
+ * @param type    VehicleType of the vehicles in the group.
+ * @return Statistics for the group and its sub-groups.
+ */
+/* static */ GroupStatistics &GroupStatistics::GetWithSubgroups(CompanyID company, GroupID id_g, VehicleType type)
+{
+	if (Group::IsValidID(id_g)) {
+		Group *g = Group::Get(id_g);
+		assert(g->owner == company);
+		assert(g->vehicle_type == type);
+		return g->statistics_with_subgroups;
+	}
+
+	/* The default and all groups do not have sub-groups. */
+	return GroupStatistics::Get(company, id_g, type);
+}
+
+/**
+ * Apply a change to the statistics of a group, and to the statistics
+ * including sub-groups of the group and all groups above it.
+ * @param company Owner of the group.
+ * @param id_g    GroupID of the group.
+ * @param type    VehicleType of the vehicles in the group.
+ * @param change  Function applying the change to a GroupStatistics.
+ */
+template <class T>
+static void ChangeGroupStatistics(CompanyID company, GroupID id_g, VehicleType type, T change)
+{
+	change(GroupStatistics::Get(company, id_g, type));
+	for (Group *g = Group::GetIfValid(id_g); g != nullptr; g = Group::GetIfValid(g->parent)) {
+		change(g->statistics_with_subgroups);
+	}
+}
+
 /**
  * Returns the GroupStatistic for the group of a vehicle.
  * @param v Vehicle.
@@ -111,7 +164,9 @@ uint16_t GroupStatistics::GetNumEngines(EngineID engine) const
 	/* Recalculate */
 	for (Group *g : Group::Iterate()) {
 		g->statistics.Clear();
+		g->statistics_with_subgroups.Clear();
 	}
+	ResetCompanyVehicleLists();
 
 	for (const Vehicle *v : Vehicle::Iterate()) {
 		if (!v->IsEngineCountable()) continue;
@@ -134,20 +189,20 @@ uint16_t GroupStatistics::GetNumEngines(EngineID engine) const
 {
 	assert(delta == 1 || delta == -1);
 
-	GroupStatistics &stats_all = GroupStatistics::GetAllGroup(v);
-	GroupStatistics &stats = GroupStatistics::Get(v);
+	UpdateCompanyVehicleList(v, delta);
 
-	stats_all.num_vehicle += delta;
-	stats_all.profit_last_year += v->GetDisplayProfitLastYear() * delta;
-	stats.num_vehicle += delta;
-	stats.profit_last_year += v->GetDisplayProfitLastYear() * delta;
+	auto count = [v, delta](GroupStatistics &stats) {
+		stats.num_vehicle += delta;
+		stats.profit_last_year += v->GetDisplayProfitLastYear() * delta;
 
-	if (v->economy_age > VEHICLE_PROFIT_MIN_AGE) {
-		stats_all.num_vehicle_min_age += delta;
-		stats_all.profit_last_year_min_age += v->GetDisplayProfitLastYear() * delta;
-		stats.num_vehicle_min_age += delta;
-		stats.profit_last_year_min_age += v->GetDisplayProfitLastYear() * delta;
-	}
+		if (v->economy_age > VEHICLE_PROFIT_MIN_AGE) {
+			stats.num_vehicle_min_age += delta;
+			stats.profit_last_year_min_age += v->GetDisplayProfitLastYear() * delta;
+		}
+	};
+
+	count(GroupStatistics::GetAllGroup(v));
+	ChangeGroupStatistics(v->owner, v->group_id, v->type, count);
 }
 
 /**
@@ -158,8 +213,10 @@ uint16_t GroupStatistics::GetNumEngines(EngineID engine) const
 /* static */ void GroupStatistics::CountEngine(const Vehicle *v, int delta)
 {
 	assert(delta == 1 || delta == -1);
-	GroupStatistics::GetAllGroup(v).num_engines[v->engine_type] += delta;
-	GroupStatistics::Get(v).num_engines[v->engine_type] += delta;
+	auto count = [v, delta](GroupStatistics &stats) { stats.num_engines[v->engine_type] += delta; };
+
+	count(GroupStatistics::GetAllGroup(v));
+	ChangeGroupStatistics(v->owner, v->group_id, v->type, count);
 }
 
 /**
@@ -167,11 +224,10 @@ uint16_t GroupStatistics::GetNumEngines(EngineID engine) const
  */
 /* static */ void GroupStatistics::AddProfitLastYear(const Vehicle *v)
 {
-	GroupStatistics &stats_all = GroupStatistics::GetAllGroup(v);
-	GroupStatistics &stats = GroupStatistics::Get(v);
+	auto add = [v](GroupStatistics &stats) { stats.profit_last_year += v->GetDisplayProfitLastYear(); };
 
-	stats_all.profit_last_year += v->GetDisplayProfitLastYear();
-	stats.profit_last_year += v->GetDisplayProfitLastYear();
+	add(GroupStatistics::GetAllGroup(v));
+	ChangeGroupStatistics(v->owner, v->group_id, v->type, add);
 }
 
 /**
@@ -179,13 +235,13 @@ uint16_t GroupStatistics::GetNumEngines(EngineID engine) const
  */
 /* static */ void GroupStatistics::VehicleReachedMinAge(const Vehicle *v)
 {
-	GroupStatistics &stats_all = GroupStatistics::GetAllGroup(v);
-	GroupStatistics &stats = GroupStatistics::Get(v);
+	auto add = [v](GroupStatistics &stats) {
+		stats.num_vehicle_min_age++;
+		stats.profit_last_year_min_age += v->GetDisplayProfitLastYear();
+	};
 
-	stats_all.num_vehicle_min_age++;
-	stats_all.profit_last_year_min_age += v->GetDisplayProfitLastYear();
-	stats.num_vehicle_min_age++;
-	stats.profit_last_year_min_age += v->GetDisplayProfitLastYear();
+	add(GroupStatistics::GetAllGroup(v));
+	ChangeGroupStatistics(v->owner, v->group_id, v->type, add);
 }
 
 /**
@@ -204,6 +260,7 @@ uint16_t GroupStatistics::GetNumEngines(EngineID engine) const
 	/* Recalculate */
 	for (Group *g : Group::Iterate()) {
 		g->statistics.ClearProfits();
+		g->statistics_with_subgroups.ClearProfits();
 	}
 
 	for (const Vehicle *v : Vehicle::Iterate()) {
@@ -255,10 +312,10 @@ static inline void UpdateNumEngineGroup(const Vehicle *v, GroupID old_g, GroupID
 {
 	if (old_g != new_g) {
 		/* Decrease the num engines in the old group */
-		GroupStatistics::Get(v->owner, old_g, v->type).num_engines[v->engine_type]--;
+		ChangeGroupStatistics(v->owner, old_g, v->type, [v](GroupStatistics &stats) { stats.num_engines[v->engine_type]--; });
 
 		/* Increase the num engines in the new group */
-		GroupStatistics::Get(v->owner, new_g, v->type).num_engines[v->engine_type]++;
+		ChangeGroupStatistics(v->owner, new_g, v->type, [v](GroupStatistics &stats) { stats.num_engines[v->engine_type]++; });
 	}
 }
 
@@ -464,7 +521,10 @@ CommandCost CmdAlterGroup(DoCommandFlag flags, AlterGroupMode mode, GroupID grou
 		}
 
 		if (flags & DC_EXEC) {
+			/* Move the statistics of the group and its sub-groups from the old to the new parents. */
+			for (Group *a = Group::GetIfValid(g->parent); a != nullptr; a = Group::GetIfValid(a->parent)) a->statistics_with_subgroups.Add(g->statistics_with_subgroups, -1);
 			g->parent = (pg == nullptr) ? INVALID_GROUP : pg->index;
+			for (Group *a = Group::GetIfValid(g->parent); a != nullptr; a = Group::GetIfValid(a->parent)) a->statistics_with_subgroups.Add(g->statistics_with_subgroups, 1);
 			GroupStatistics::UpdateAutoreplace(g->owner);
 
 			if (!HasBit(g->livery.in_use, 0) || !HasBit(g->livery.in_use, 1)) {
@@ -796,12 +856,8 @@ void UpdateTrainGroupID(Train *v)
  */
 uint GetGroupNumEngines(CompanyID company, GroupID id_g, EngineID id_e)
 {
-	uint count = 0;
 	const Engine *e = Engine::Get(id_e);
-	for (const Group *g : Group::Iterate()) {
-		if (g->parent == id_g) count += GetGroupNumEngines(company, g->index, id_e);
-	}
-	return count + GroupStatistics::Get(company, id_g, e->type).GetNumEngines(id_e);
+	return GroupStatistics::GetWithSubgroups(company, id_g, e->type).GetNumEngines(id_e);
 }
 
 /**
@@ -814,11 +870,7 @@ uint GetGroupNumEngines(CompanyID company, GroupID id_g, EngineID id_e)
  */
 uint GetGroupNumVehicle(CompanyID company, GroupID id_g, VehicleType type)
 {
-	uint count = 0;
-	for (const Group *g : Group::Iterate()) {
-		if (g->parent == id_g) count += GetGroupNumVehicle(company, g->index, type);
-	}
-	return count + GroupStatistics::Get(company, id_g, type).num_vehicle;
+	return GroupStatistics::GetWithSubgroups(company, id_g, type).num_vehicle;
 }
 
 /**
@@ -831,11 +883,7 @@ uint GetGroupNumVehicle(CompanyID company, GroupID id_g, VehicleType type)
  */
 uint GetGroupNumVehicleMinAge(CompanyID company, GroupID id_g, VehicleType type)
 {
-	uint count = 0;
-	for (const Group *g : Group::Iterate()) {
-		if (g->parent == id_g) count += GetGroupNumVehicleMinAge(company, g->index, type);
-	}
-	return count + GroupStatistics::Get(company, id_g, type).num_vehicle_min_age;
+	return GroupStatistics::GetWithSubgroups(company, id_g, type).num_vehicle_min_age;
 }
 
 /**
@@ -848,11 +896,7 @@ uint GetGroupNumVehicleMinAge(CompanyID company, GroupID id_g, VehicleType type)
  */
 Money GetGroupProfitLastYearMinAge(CompanyID company, GroupID id_g, VehicleType type)
 {
-	Money sum = 0;
-	for (const Group *g : Group::Iterate()) {
-		if (g->parent == id_g) sum += GetGroupProfitLastYearMinAge(company, g->index, type);
-	}
-	return sum + GroupStatistics::Get(company, id_g, type).profit_last_year_min_age;
+	return GroupStatistics::GetWithSubgroups(company, id_g, type).profit_last_year_min_age;
 }
 
 void RemoveAllGroupsForCompany(const CompanyID company)
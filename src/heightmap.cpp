@@ -59,8 +59,9 @@ static inline bool IsValidHeightmapDimension(size_t width, size_t height)
 /**
  * Convert RGB colours to Grayscale using 29.9% Red, 58.7% Green, 11.4% Blue
  *  (average luminosity formula, NTSC Colour Space)
+ * The colours are either all 8 bit or all 16 bit; the result has the same depth.
  */
-static inline uint8_t RGBToGrayscale(uint8_t red, uint8_t green, uint8_t blue)
+static inline uint RGBToGrayscale(uint red, uint green, uint blue)
 {
 	/* To avoid doubles and stuff, multiply it with a total of 65536 (16bits), then
 	 *  divide by it to normalize the value to a byte again. */
@@ -68,157 +69,118 @@ static inline uint8_t RGBToGrayscale(uint8_t red, uint8_t green, uint8_t blue)
 }
 
 
-#ifdef WITH_PNG
+/** Reader of the rows of a heightmap image, from the top row to the bottom one. */
+struct HeightmapReader {
+	uint width = 0;       ///< Width of the image in pixels.
+	uint height = 0;      ///< Height of the image in pixels.
+	uint max_value = 255; ///< Brightness of a white pixel; 255 for 8-bit images and 65535 for 16-bit ones.
 
-#include <png.h>
+	virtual ~HeightmapReader() = default;
 
-/**
- * The PNG Heightmap loader.
- */
-static void ReadHeightmapPNGImageData(uint8_t *map, png_structp png_ptr, png_infop info_ptr)
-{
-	uint x, y;
-	uint8_t gray_palette[256];
-	png_bytep *row_pointers = nullptr;
-	bool has_palette = png_get_color_type(png_ptr, info_ptr) == PNG_COLOR_TYPE_PALETTE;
-	uint channels = png_get_channels(png_ptr, info_ptr);
-
-	/* Get palette and convert it to grayscale */
-	if (has_palette) {
-		int i;
-		int palette_size;
-		png_color *palette;
-		bool all_gray = true;
-
-		png_get_PLTE(png_ptr, info_ptr, &palette, &palette_size);
-		for (i = 0; i < palette_size && (palette_size != 16 || all_gray); i++) {
-			all_gray &= palette[i].red == palette[i].green && palette[i].red == palette[i].blue;
-			gray_palette[i] = RGBToGrayscale(palette[i].red, palette[i].green, palette[i].blue);
-		}
+	/**
+	 * Read the next row of the image.
+	 * @param[out] row The brightness of the pixels of the row, from 0 up to #max_value.
+	 * @return False iff reading the row failed.
+	 */
+	virtual bool ReadRow(std::vector<uint16_t> &row) = 0;
+};
 
-		/**
-		 * For a non-gray palette of size 16 we assume that
-		 * the order of the palette determines the height;
-		 * the first entry is the sea (level 0), the second one
-		 * level 1, etc.
-		 */
-		if (palette_size == 16 && !all_gray) {
-			for (i = 0; i < palette_size; i++) {
-				gray_palette[i] = 256 * i / palette_size;
-			}
-		}
-	}
-
-	row_pointers = png_get_rows(png_ptr, info_ptr);
-
-	/* Read the raw image data and convert in 8-bit grayscale */
-	for (x = 0; x < png_get_image_width(png_ptr, info_ptr); x++) {
-		for (y = 0; y < png_get_image_height(png_ptr, info_ptr); y++) {
-			uint8_t *pixel = &map[y * png_get_image_width(png_ptr, info_ptr) + x];
-			uint x_offset = x * channels;
+#ifdef WITH_PNG
 
-			if (has_palette) {
-				*pixel = gray_palette[row_pointers[y][x_offset]];
-			} else if (channels == 3) {
-				*pixel = RGBToGrayscale(row_pointers[y][x_offset + 0],
-						row_pointers[y][x_offset + 1], row_pointers[y][x_offset + 2]);
-			} else {
-				*pixel = row_pointers[y][x_offset];
-			}
-		}
-	}
-}
+#include <png.h>
 
 /**
- * Reads the heightmap and/or size of the heightmap from a PNG file.
- * If map == nullptr only the size of the PNG is read, otherwise a map
- * with grayscale pixels is allocated and assigned to *map.
+ * The PNG Heightmap loader. Non-interlaced images are read row by row, so
+ * only one row of the image is in memory at a time.
  */
-static bool ReadHeightmapPNG(const char *filename, uint *x, uint *y, uint8_t **map)
-{
-	FILE *fp;
-	png_structp png_ptr = nullptr;
-	png_infop info_ptr  = nullptr;
-
-	fp = FioFOpenFile(filename, "rb", HEIGHTMAP_DIR);
-	if (fp == nullptr) {
-		ShowErrorMessage(STR_ERROR_PNGMAP, STR_ERROR_PNGMAP_FILE_NOT_FOUND, WL_ERROR);
-		return false;
+struct PNGHeightmapReader : HeightmapReader {
+	FILE *fp = nullptr;             ///< The image file.
+	png_structp png_ptr = nullptr;  ///< The state of libpng.
+	png_infop info_ptr = nullptr;   ///< The information about the image.
+	uint16_t gray_palette[256];     ///< The brightness of every colour of the palette.
+	bool has_palette = false;       ///< Whether the image has a palette.
+	uint channels = 0;              ///< Number of samples per pixel.
+	bool is_16bit = false;          ///< Whether the samples are 16 bit.
+	std::vector<png_byte> buffer;   ///< The current row, or all rows of an interlaced image.
+	std::vector<png_bytep> rows;    ///< Pointers to the rows of an interlaced image.
+	size_t row_bytes = 0;           ///< Number of bytes of a row.
+	uint next_row = 0;              ///< The row that is read next.
+	bool interlaced = false;        ///< Whether the image is interlaced, so it is read at once.
+
+	~PNGHeightmapReader() override
+	{
+		if (this->png_ptr != nullptr) png_destroy_read_struct(&this->png_ptr, &this->info_ptr, nullptr);
+		if (this->fp != nullptr) fclose(this->fp);
 	}
 
-	png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
-	if (png_ptr == nullptr) {
-		ShowErrorMessage(STR_ERROR_PNGMAP, STR_ERROR_PNGMAP_MISC, WL_ERROR);
-		fclose(fp);
-		return false;
-	}
-
-	info_ptr = png_create_info_struct(png_ptr);
-	if (info_ptr == nullptr || setjmp(png_jmpbuf(png_ptr))) {
-		ShowErrorMessage(STR_ERROR_PNGMAP, STR_ERROR_PNGMAP_MISC, WL_ERROR);
-		fclose(fp);
-		png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
-		return false;
-	}
-
-	png_init_io(png_ptr, fp);
-
-	/* Allocate memory and read image, without alpha or 16-bit samples
-	 * (result is either 8-bit indexed/grayscale or 24-bit RGB) */
-	png_set_packing(png_ptr);
-	png_read_png(png_ptr, info_ptr, PNG_TRANSFORM_PACKING | PNG_TRANSFORM_STRIP_ALPHA | PNG_TRANSFORM_STRIP_16, nullptr);
-
-	/* Maps of wrong colour-depth are not used.
-	 * (this should have been taken care of by stripping alpha and 16-bit samples on load) */
-	if ((png_get_channels(png_ptr, info_ptr) != 1) && (png_get_channels(png_ptr, info_ptr) != 3) && (png_get_bit_depth(png_ptr, info_ptr) != 8)) {
-		ShowErrorMessage(STR_ERROR_PNGMAP, STR_ERROR_PNGMAP_IMAGE_TYPE, WL_ERROR);
-		fclose(fp);
-		png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
-		return false;
-	}
-
-	uint width = png_get_image_width(png_ptr, info_ptr);
-	uint height = png_get_image_height(png_ptr, info_ptr);
+	/**
+	 * Open the image and read its header.
+	 * @param filename The name of the file.
+	 * @return False iff the image cannot be used as heightmap; an error has been shown then.
+	 */
+	bool Open(const char *filename)
+	{
+		this->fp = FioFOpenFile(filename, "rb", HEIGHTMAP_DIR);
+		if (this->fp == nullptr) {
+			ShowErrorMessage(STR_ERROR_PNGMAP, STR_ERROR_PNGMAP_FILE_NOT_FOUND, WL_ERROR);
+			return false;
+		}
 
-	if (!IsValidHeightmapDimension(width, height)) {
-		ShowErrorMessage(STR_ERROR_PNGMAP, STR_ERROR_HEIGHTMAP_TOO_LARGE, WL_ERROR);
-		fclose(fp);
-		png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
-		return false;
-	}
+		this->png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+		if (this->png_ptr == nullptr) {
+			ShowErrorMessage(STR_ERROR_PNGMAP, STR_ERROR_PNGMAP_MISC, WL_ERROR);
+			return false;
+		}
 
-	if (map != nullptr) {
-		*map = MallocT<uint8_t>(static_cast<size_t>(width) * height);
-		ReadHeightmapPNGImageData(*map, png_ptr, info_ptr);
-	}
+		this->info_ptr = png_create_info_struct(this->png_ptr);
+		if (this->info_ptr == nullptr || setjmp(png_jmpbuf(this->png_ptr))) {
+			ShowErrorMessage(STR_ERROR_PNGMAP, STR_ERROR_PNGMAP_MISC, WL_ERROR);
+			return false;
+		}
 
-	*x = width;
-	*y = height;
+		png_init_io(this->png_ptr, this->fp);
+		png_read_info(this->png_ptr, this->info_ptr);
 
-	fclose(fp);
-	png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
-	return true;
-}
+		/* Read the image without alpha, and with at least 8-bit samples
+		 * (result is either 8-bit indexed, 8 or 16-bit grayscale or 24 or 48-bit RGB) */
+		png_set_packing(this->png_ptr);
+		png_set_strip_alpha(this->png_ptr);
+		this->interlaced = png_set_interlace_handling(this->png_ptr) > 1;
+		png_read_update_info(this->png_ptr, this->info_ptr);
 
-#endif /* WITH_PNG */
+		this->channels = png_get_channels(this->png_ptr, this->info_ptr);
+		this->is_16bit = png_get_bit_depth(this->png_ptr, this->info_ptr) == 16;
 
+		/* Maps of wrong colour-depth are not used.
+		 * (this should have been taken care of by stripping alpha on load) */
+		if (this->channels != 1 && this->channels != 3) {
+			ShowErrorMessage(STR_ERROR_PNGMAP, STR_ERROR_PNGMAP_IMAGE_TYPE, WL_ERROR);
+			return false;
+		}
 
-/**
- * The BMP Heightmap loader.
- */
-static void ReadHeightmapBMPImageData(uint8_t *map, BmpInfo *info, BmpData *data)
-{
-	uint x, y;
-	uint8_t gray_palette[256];
+		this->width = png_get_image_width(this->png_ptr, this->info_ptr);
+		this->height = png_get_image_height(this->png_ptr, this->info_ptr);
 
-	if (data->palette != nullptr) {
-		uint i;
-		bool all_gray = true;
+		if (!IsValidHeightmapDimension(this->width, this->height)) {
+			ShowErrorMessage(STR_ERROR_PNGMAP, STR_ERROR_HEIGHTMAP_TOO_LARGE, WL_ERROR);
+			return false;
+		}
 
-		if (info->palette_size != 2) {
-			for (i = 0; i < info->palette_size && (info->palette_size != 16 || all_gray); i++) {
-				all_gray &= data->palette[i].r == data->palette[i].g && data->palette[i].r == data->palette[i].b;
-				gray_palette[i] = RGBToGrayscale(data->palette[i].r, data->palette[i].g, data->palette[i].b);
+		this->max_value = this->is_16bit ? 65535 : 255;
+		this->row_bytes = png_get_rowbytes(this->png_ptr, this->info_ptr);
+		this->has_palette = png_get_color_type(this->png_ptr, this->info_ptr) == PNG_COLOR_TYPE_PALETTE;
+
+		/* Get palette and convert it to grayscale */
+		if (this->has_palette) {
+			int i;
+			int palette_size;
+			png_color *palette;
+			bool all_gray = true;
+
+			png_get_PLTE(this->png_ptr, this->info_ptr, &palette, &palette_size);
+			for (i = 0; i < palette_size && (palette_size != 16 || all_gray); i++) {
+				all_gray &= palette[i].red == palette[i].green && palette[i].red == palette[i].blue;
+				this->gray_palette[i] = RGBToGrayscale(palette[i].red, palette[i].green, palette[i].blue);
 			}
 
 			/**
@@ -227,103 +189,179 @@ static void ReadHeightmapBMPImageData(uint8_t *map, BmpInfo *info, BmpData *data
 			 * the first entry is the sea (level 0), the second one
 			 * level 1, etc.
 			 */
-			if (info->palette_size == 16 && !all_gray) {
-				for (i = 0; i < info->palette_size; i++) {
-					gray_palette[i] = 256 * i / info->palette_size;
+			if (palette_size == 16 && !all_gray) {
+				for (i = 0; i < palette_size; i++) {
+					this->gray_palette[i] = 256 * i / palette_size;
 				}
 			}
-		} else {
-			/**
-			 * For a palette of size 2 we assume that the order of the palette determines the height;
-			 * the first entry is the sea (level 0), the second one is the land (level 1)
-			 */
-			gray_palette[0] = 0;
-			gray_palette[1] = 16;
 		}
+
+		return true;
 	}
 
-	/* Read the raw image data and convert in 8-bit grayscale */
-	for (y = 0; y < info->height; y++) {
-		uint8_t *pixel = &map[y * info->width];
-		uint8_t *bitmap = &data->bitmap[y * info->width * (info->bpp == 24 ? 3 : 1)];
+	bool ReadRow(std::vector<uint16_t> &row) override
+	{
+		assert(this->next_row < this->height);
 
-		for (x = 0; x < info->width; x++) {
-			if (info->bpp != 24) {
-				*pixel++ = gray_palette[*bitmap++];
+		if (setjmp(png_jmpbuf(this->png_ptr))) {
+			ShowErrorMessage(STR_ERROR_PNGMAP, STR_ERROR_PNGMAP_MISC, WL_ERROR);
+			return false;
+		}
+
+		png_bytep data;
+		if (this->interlaced) {
+			/* All passes have to be read before the first row is complete. */
+			if (this->buffer.empty()) {
+				this->buffer.resize(this->row_bytes * this->height);
+				this->rows.resize(this->height);
+				for (uint y = 0; y < this->height; y++) this->rows[y] = &this->buffer[this->row_bytes * y];
+				png_read_image(this->png_ptr, this->rows.data());
+			}
+			data = &this->buffer[this->row_bytes * this->next_row];
+		} else {
+			this->buffer.resize(this->row_bytes);
+			png_read_row(this->png_ptr, this->buffer.data(), nullptr);
+			data = this->buffer.data();
+		}
+		this->next_row++;
+
+		/* Convert the row into grayscale, with 16-bit samples as they are stored: big endian */
+		auto sample = [data, is_16bit = this->is_16bit](uint i) -> uint { return is_16bit ? (data[i * 2] << 8) | data[i * 2 + 1] : data[i]; };
+		row.resize(this->width);
+		for (uint x = 0; x < this->width; x++) {
+			uint x_offset = x * this->channels;
+
+			if (this->has_palette) {
+				row[x] = this->gray_palette[data[x_offset]];
+			} else if (this->channels == 3) {
+				row[x] = RGBToGrayscale(sample(x_offset + 0), sample(x_offset + 1), sample(x_offset + 2));
 			} else {
-				*pixel++ = RGBToGrayscale(*bitmap, *(bitmap + 1), *(bitmap + 2));
-				bitmap += 3;
+				row[x] = sample(x_offset);
 			}
 		}
+		return true;
 	}
-}
+};
+
+#endif /* WITH_PNG */
+
 
 /**
- * Reads the heightmap and/or size of the heightmap from a BMP file.
- * If map == nullptr only the size of the BMP is read, otherwise a map
- * with grayscale pixels is allocated and assigned to *map.
+ * The BMP Heightmap loader. The bitmap is read at once, but it is converted
+ * into grayscale row by row.
  */
-static bool ReadHeightmapBMP(const char *filename, uint *x, uint *y, uint8_t **map)
-{
-	FILE *f;
-	BmpInfo info;
-	BmpData data;
-	BmpBuffer buffer;
-
-	/* Init BmpData */
-	memset(&data, 0, sizeof(data));
-
-	f = FioFOpenFile(filename, "rb", HEIGHTMAP_DIR);
-	if (f == nullptr) {
-		ShowErrorMessage(STR_ERROR_BMPMAP, STR_ERROR_PNGMAP_FILE_NOT_FOUND, WL_ERROR);
-		return false;
+struct BMPHeightmapReader : HeightmapReader {
+	FILE *f = nullptr;           ///< The image file.
+	BmpInfo info;                ///< The information about the image.
+	BmpData data{};              ///< The palette and bitmap of the image.
+	BmpBuffer buffer;            ///< Buffer for reading the file.
+	uint8_t gray_palette[256];   ///< The brightness of every colour of the palette.
+	uint next_row = 0;           ///< The row that is read next.
+
+	~BMPHeightmapReader() override
+	{
+		BmpDestroyData(&this->data);
+		if (this->f != nullptr) fclose(this->f);
 	}
 
-	BmpInitializeBuffer(&buffer, f);
+	/**
+	 * Open the image and read its header.
+	 * @param filename The name of the file.
+	 * @param read_bitmap Whether to read the bitmap as well, to read the rows later.
+	 * @return False iff the image cannot be used as heightmap; an error has been shown then.
+	 */
+	bool Open(const char *filename, bool read_bitmap)
+	{
+		this->f = FioFOpenFile(filename, "rb", HEIGHTMAP_DIR);
+		if (this->f == nullptr) {
+			ShowErrorMessage(STR_ERROR_BMPMAP, STR_ERROR_PNGMAP_FILE_NOT_FOUND, WL_ERROR);
+			return false;
+		}
 
-	if (!BmpReadHeader(&buffer, &info, &data)) {
-		ShowErrorMessage(STR_ERROR_BMPMAP, STR_ERROR_BMPMAP_IMAGE_TYPE, WL_ERROR);
-		fclose(f);
-		BmpDestroyData(&data);
-		return false;
-	}
+		BmpInitializeBuffer(&this->buffer, this->f);
 
-	if (!IsValidHeightmapDimension(info.width, info.height)) {
-		ShowErrorMessage(STR_ERROR_BMPMAP, STR_ERROR_HEIGHTMAP_TOO_LARGE, WL_ERROR);
-		fclose(f);
-		BmpDestroyData(&data);
-		return false;
-	}
+		if (!BmpReadHeader(&this->buffer, &this->info, &this->data)) {
+			ShowErrorMessage(STR_ERROR_BMPMAP, STR_ERROR_BMPMAP_IMAGE_TYPE, WL_ERROR);
+			return false;
+		}
+
+		if (!IsValidHeightmapDimension(this->info.width, this->info.height)) {
+			ShowErrorMessage(STR_ERROR_BMPMAP, STR_ERROR_HEIGHTMAP_TOO_LARGE, WL_ERROR);
+			return false;
+		}
+
+		this->width = this->info.width;
+		this->height = this->info.height;
+		if (!read_bitmap) return true;
 
-	if (map != nullptr) {
-		if (!BmpReadBitmap(&buffer, &info, &data)) {
+		if (!BmpReadBitmap(&this->buffer, &this->info, &this->data)) {
 			ShowErrorMessage(STR_ERROR_BMPMAP, STR_ERROR_BMPMAP_IMAGE_TYPE, WL_ERROR);
-			fclose(f);
-			BmpDestroyData(&data);
 			return false;
 		}
 
-		*map = MallocT<uint8_t>(static_cast<size_t>(info.width) * info.height);
-		ReadHeightmapBMPImageData(*map, &info, &data);
+		if (this->data.palette != nullptr) {
+			uint i;
+			bool all_gray = true;
+
+			if (this->info.palette_size != 2) {
+				for (i = 0; i < this->info.palette_size && (this->info.palette_size != 16 || all_gray); i++) {
+					all_gray &= this->data.palette[i].r == this->data.palette[i].g && this->data.palette[i].r == this->data.palette[i].b;
+					this->gray_palette[i] = RGBToGrayscale(this->data.palette[i].r, this->data.palette[i].g, this->data.palette[i].b);
+				}
+
+				/**
+				 * For a non-gray palette of size 16 we assume that
+				 * the order of the palette determines the height;
+				 * the first entry is the sea (level 0), the second one
+				 * level 1, etc.
+				 */
+				if (this->info.palette_size == 16 && !all_gray) {
+					for (i = 0; i < this->info.palette_size; i++) {
+						this->gray_palette[i] = 256 * i / this->info.palette_size;
+					}
+				}
+			} else {
+				/**
+				 * For a palette of size 2 we assume that the order of the palette determines the height;
+				 * the first entry is the sea (level 0), the second one is the land (level 1)
+				 */
+				this->gray_palette[0] = 0;
+				this->gray_palette[1] = 16;
+			}
+		}
+
+		return true;
 	}
 
-	BmpDestroyData(&data);
+	bool ReadRow(std::vector<uint16_t> &row) override
+	{
+		assert(this->next_row < this->height);
 
-	*x = info.width;
-	*y = info.height;
+		/* Convert the raw image data of the row into 8-bit grayscale */
+		const uint8_t *bitmap = &this->data.bitmap[static_cast<size_t>(this->next_row) * this->info.width * (this->info.bpp == 24 ? 3 : 1)];
+		this->next_row++;
 
-	fclose(f);
-	return true;
-}
+		row.resize(this->width);
+		for (uint x = 0; x < this->width; x++) {
+			if (this->info.bpp != 24) {
+				row[x] = this->gray_palette[*bitmap++];
+			} else {
+				row[x] = RGBToGrayscale(*bitmap, *(bitmap + 1), *(bitmap + 2));
+				bitmap += 3;
+			}
+		}
+		return true;
+	}
+};
 
 /**
  * Converts a given grayscale map to something that fits in OTTD map system
- * and create a map of that data.
- * @param img_width  the with of the image in pixels/tiles
- * @param img_height the height of the image in pixels/tiles
- * @param map        the input map
+ * and create a map of that data. The image is read row by row while the
+ * map is created, so only one row of it is in memory.
+ * @param reader The reader of the image.
+ * @return False iff reading the image failed.
  */
-static void GrayscaleToMapHeights(uint img_width, uint img_height, uint8_t *map)
+static bool GrayscaleToMapHeights(HeightmapReader &reader)
 {
 	/* Defines the detail of the aspect ratio (to avoid doubles) */
 	const uint num_div = 16384;
@@ -335,7 +373,11 @@ static void GrayscaleToMapHeights(uint img_width, uint img_height, uint8_t *map)
 	uint row_pad = 0, col_pad = 0;
 	uint img_scale;
 	uint img_row, img_col;
+	uint img_width = reader.width;
+	uint img_height = reader.height;
 	TileIndex tile;
+	std::vector<uint16_t> img_data;
+	uint img_data_row = UINT_MAX; // The row of the image in img_data.
 
 	/* Get map size and calculate scale and padding values */
 	switch (_settings_game.game_creation.heightmap_rotation) {
@@ -367,6 +409,16 @@ static void GrayscaleToMapHeights(uint img_width, uint img_height, uint8_t *map)
 
 	/* Form the landscape */
 	for (row = 0; row < height; row++) {
+		bool in_padding = (row < row_pad) || (row >= (height - row_pad - (_settings_game.construction.freeform_edges ? 0 : 1)));
+		img_row = in_padding ? 0 : (((row - row_pad) * num_div) / img_scale);
+		assert(in_padding || img_row < img_height);
+
+		/* The rows of the image are only read forward, up to the one of this row of the map. */
+		while (!in_padding && img_data_row != img_row) {
+			if (!reader.ReadRow(img_data)) return false;
+			img_data_row = img_data_row == UINT_MAX ? 0 : img_data_row + 1;
+		}
+
 		for (col = 0; col < width; col++) {
 			switch (_settings_game.game_creation.heightmap_rotation) {
 				default: NOT_REACHED();
@@ -375,14 +427,12 @@ static void GrayscaleToMapHeights(uint img_width, uint img_height, uint8_t *map)
 			}
 
 			/* Check if current tile is within the 1-pixel map edge or padding regions */
-			if ((!_settings_game.construction.freeform_edges && DistanceFromEdge(tile) <= 1) ||
-					(row < row_pad) || (row >= (height - row_pad - (_settings_game.construction.freeform_edges ? 0 : 1))) ||
+			if ((!_settings_game.construction.freeform_edges && DistanceFromEdge(tile) <= 1) || in_padding ||
 					(col < col_pad) || (col >= (width  - col_pad - (_settings_game.construction.freeform_edges ? 0 : 1)))) {
 				SetTileHeight(tile, 0);
 			} else {
 				/* Use nearest neighbour resizing to scale map data.
 				 *  We rotate the map 45 degrees (counter)clockwise */
-				img_row = (((row - row_pad) * num_div) / img_scale);
 				switch (_settings_game.game_creation.heightmap_rotation) {
 					default: NOT_REACHED();
 					case HM_COUNTER_CLOCKWISE:
@@ -393,16 +443,15 @@ static void GrayscaleToMapHeights(uint img_width, uint img_height, uint8_t *map)
 						break;
 				}
 
-				assert(img_row < img_height);
 				assert(img_col < img_width);
 
-				uint heightmap_height = map[img_row * img_width + img_col];
+				uint heightmap_height = img_data[img_col];
 
 				if (heightmap_height > 0) {
 					/* 0 is sea level.
 					 * Other grey scales are scaled evenly to the available height levels > 0.
 					 * (The coastline is independent from the number of height levels) */
-					heightmap_height = 1 + (heightmap_height - 1) * _settings_game.game_creation.heightmap_height / 255;
+					heightmap_height = 1 + (heightmap_height - 1) * _settings_game.game_creation.heightmap_height / reader.max_value;
 				}
 
 				SetTileHeight(tile, heightmap_height);
@@ -413,6 +462,7 @@ static void GrayscaleToMapHeights(uint img_width, uint img_height, uint8_t *map)
 			}
 		}
 	}
+	return true;
 }
 
 /**
@@ -476,27 +526,31 @@ void FixSlopes()
 }
 
 /**
- * Reads the heightmap with the correct file reader.
+ * Open a heightmap with the correct file reader.
  * @param dft Type of image file.
  * @param filename Name of the file to load.
- * @param[out] x Length of the image.
- * @param[out] y Height of the image.
- * @param[in,out] map If not \c nullptr, destination to store the loaded block of image data.
- * @return Whether loading was successful.
+ * @param read_image Whether the rows of the image are going to be read.
+ * @return The reader, or \c nullptr when the image cannot be used; an error has been shown then.
  */
-static bool ReadHeightMap(DetailedFileType dft, const char *filename, uint *x, uint *y, uint8_t **map)
+static std::unique_ptr<HeightmapReader> OpenHeightMap(DetailedFileType dft, const char *filename, bool read_image)
 {
 	switch (dft) {
 		default:
 			NOT_REACHED();
 
 #ifdef WITH_PNG
-		case DFT_HEIGHTMAP_PNG:
-			return ReadHeightmapPNG(filename, x, y, map);
+		case DFT_HEIGHTMAP_PNG: {
+			auto reader = std::make_unique<PNGHeightmapReader>();
+			if (!reader->Open(filename)) return nullptr;
+			return reader;
+		}
 #endif /* WITH_PNG */
 
-		case DFT_HEIGHTMAP_BMP:
-			return ReadHeightmapBMP(filename, x, y, map);
+		case DFT_HEIGHTMAP_BMP: {
+			auto reader = std::make_unique<BMPHeightmapReader>();
+			if (!reader->Open(filename, read_image)) return nullptr;
+			return reader;
+		}
 	}
 }
 
@@ -510,7 +564,12 @@ static bool ReadHeightMap(DetailedFileType dft, const char *filename, uint *x, u
  */
 bool GetHeightmapDimensions(DetailedFileType dft, const char *filename, uint *x, uint *y)
 {
-	return ReadHeightMap(dft, filename, x, y, nullptr);
+	std::unique_ptr<HeightmapReader> reader = OpenHeightMap(dft, filename, false);
+	if (reader == nullptr) return false;
+
+	*x = reader->width;
+	*y = reader->height;
+	return true;
 }
 
 /**
@@ -522,16 +581,9 @@ bool GetHeightmapDimensions(DetailedFileType dft, const char *filename, uint *x,
  */
 bool LoadHeightmap(DetailedFileType dft, const char *filename)
 {
-	uint x, y;
-	uint8_t *map = nullptr;
-
-	if (!ReadHeightMap(dft, filename, &x, &y, &map)) {
-		free(map);
-		return false;
-	}
-
-	GrayscaleToMapHeights(x, y, map);
-	free(map);
+	std::unique_ptr<HeightmapReader> reader = OpenHeightMap(dft, filename, true);
+	if (reader == nullptr || !GrayscaleToMapHeights(*reader)) return false;
+	reader.reset();
 
 	FixSlopes();
 	MarkWholeScreenDirty();
@@ -43,6 +43,7 @@
 #include "industry_cmd.h"
 #include "landscape_cmd.h"
 #include "terraform_cmd.h"
+#include "framerate_type.h"
 #include "timer/timer.h"
 #include "timer/timer_game_calendar.h"
 #include "timer/timer_game_economy.h"
@@ -209,6 +210,8 @@ Industry::~Industry()
  */
 void Industry::PostDestructor(size_t)
 {
+	/* Industries are also built outside of commands, so a new industry could get the name of this one from the cache. */
+	ClearFormattedStringCache();
 	InvalidateWindowData(WC_INDUSTRY_DIRECTORY, 0, IDIWD_FORCE_REBUILD);
 	SetWindowDirty(WC_BUILD_INDUSTRY, 0);
 }
@@ -1246,6 +1249,8 @@ void OnTick_Industry()
 
 	if (_game_mode == GM_EDITOR) return;
 
+	PerformanceAccumulator framerate(PFE_GL_INDUSTRIES);
+
 	for (Industry *i : Industry::Iterate()) {
 		ProduceIndustryGoods(i);
 	}
@@ -1955,6 +1960,8 @@ static void DoCreateNewIndustry(Industry *i, TileIndex tile, IndustryType type,
 		}
 	}
 
+	InvalidateStationAcceptanceCache(i->location);
+
 	if (GetIndustrySpec(i->type)->behaviour & INDUSTRYBEH_PLANT_ON_BUILT) {
 		for (uint j = 0; j != 50; j++) PlantRandomFarmField(i);
 	}
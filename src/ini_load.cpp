@@ -51,11 +51,8 @@ IniGroup::IniGroup(const std::string &name, IniGroupType type) : type(type), com
  */
 const IniItem *IniGroup::GetItem(const std::string &name) const
 {
-	for (const IniItem &item : this->items) {
-		if (item.name == name) return &item;
-	}
-
-	return nullptr;
+	auto it = this->item_index.find(name);
+	return it == this->item_index.end() ? nullptr : it->second;
 }
 
 /**
@@ -65,9 +62,8 @@ const IniItem *IniGroup::GetItem(const std::string &name) const
  */
 IniItem &IniGroup::GetOrCreateItem(const std::string &name)
 {
-	for (IniItem &item : this->items) {
-		if (item.name == name) return item;
-	}
+	auto it = this->item_index.find(name);
+	if (it != this->item_index.end()) return *it->second;
 
 	/* Item doesn't exist, make a new one. */
 	return this->CreateItem(name);
@@ -80,7 +76,9 @@ IniItem &IniGroup::GetOrCreateItem(const std::string &name)
  */
 IniItem &IniGroup::CreateItem(const std::string &name)
 {
-	return this->items.emplace_back(name);
+	IniItem &item = this->items.emplace_back(name);
+	this->item_index.try_emplace(item.name, &item);
+	return item;
 }
 
 /**
@@ -89,6 +87,7 @@ IniItem &IniGroup::CreateItem(const std::string &name)
  */
 void IniGroup::RemoveItem(const std::string &name)
 {
+	this->item_index.erase(name);
 	this->items.remove_if([&name](const IniItem &item) { return item.name == name; });
 }
 
@@ -97,6 +96,7 @@ void IniGroup::RemoveItem(const std::string &name)
  */
 void IniGroup::Clear()
 {
+	this->item_index.clear();
 	this->items.clear();
 }
 
@@ -118,11 +118,8 @@ IniLoadFile::IniLoadFile(const IniGroupNameList &list_group_names, const IniGrou
  */
 const IniGroup *IniLoadFile::GetGroup(const std::string &name) const
 {
-	for (const IniGroup &group : this->groups) {
-		if (group.name == name) return &group;
-	}
-
-	return nullptr;
+	auto it = this->group_index.find(name);
+	return it == this->group_index.end() ? nullptr : it->second;
 }
 
 /**
@@ -132,11 +129,8 @@ const IniGroup *IniLoadFile::GetGroup(const std::string &name) const
  */
 IniGroup *IniLoadFile::GetGroup(const std::string &name)
 {
-	for (IniGroup &group : this->groups) {
-		if (group.name == name) return &group;
-	}
-
-	return nullptr;
+	auto it = this->group_index.find(name);
+	return it == this->group_index.end() ? nullptr : it->second;
 }
 
 /**
@@ -146,9 +140,8 @@ IniGroup *IniLoadFile::GetGroup(const std::string &name)
  */
 IniGroup &IniLoadFile::GetOrCreateGroup(const std::string &name)
 {
-	for (IniGroup &group : this->groups) {
-		if (group.name == name) return group;
-	}
+	IniGroup *group = this->GetGroup(name);
+	if (group != nullptr) return *group;
 
 	/* Group doesn't exist, make a new one. */
 	return this->CreateGroup(name);
@@ -165,7 +158,9 @@ IniGroup &IniLoadFile::CreateGroup(const std::string &name)
 	if (std::find(this->list_group_names.begin(), this->list_group_names.end(), name) != this->list_group_names.end()) type = IGT_LIST;
 	if (std::find(this->seq_group_names.begin(), this->seq_group_names.end(), name) != this->seq_group_names.end()) type = IGT_SEQUENCE;
 
-	return this->groups.emplace_back(name, type);
+	IniGroup &group = this->groups.emplace_back(name, type);
+	this->group_index.try_emplace(group.name, &group);
+	return group;
 }
 
 /**
@@ -176,6 +171,10 @@ void IniLoadFile::RemoveGroup(const std::string &name)
 {
 	size_t len = name.length();
 	this->groups.remove_if([&name, &len](const IniGroup &group) { return group.name.compare(0, len, name) == 0; });
+
+	/* Any number of groups may be gone, so rebuild the index. */
+	this->group_index.clear();
+	for (IniGroup &group : this->groups) this->group_index.try_emplace(group.name, &group);
 }
 
 /**
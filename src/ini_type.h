@@ -12,6 +12,8 @@
 
 #include "fileio_type.h"
 
+#include <unordered_map>
+
 /** Types of groups */
 enum IniGroupType {
 	IGT_VARIABLES = 0, ///< Values of the form "landscape = hilly".
@@ -36,8 +38,11 @@ struct IniGroup {
 	IniGroupType type;   ///< type of group
 	std::string name;    ///< name of group
 	std::string comment; ///< comment for group
+	std::unordered_map<std::string_view, IniItem *> item_index; ///< first item of each name in #items; only change the items via the functions below
 
 	IniGroup(const std::string &name, IniGroupType type);
+	IniGroup(const IniGroup &) = delete;
+	IniGroup &operator=(const IniGroup &) = delete;
 
 	const IniItem *GetItem(const std::string &name) const;
 	IniItem &GetOrCreateItem(const std::string &name);
@@ -51,6 +56,7 @@ struct IniLoadFile {
 	using IniGroupNameList = std::initializer_list<std::string_view>;
 
 	std::list<IniGroup> groups; ///< all groups in the ini
+	std::unordered_map<std::string_view, IniGroup *> group_index; ///< first group of each name in #groups; only change the groups via the functions below
 	std::string comment;                  ///< last comment in file
 	const IniGroupNameList list_group_names; ///< list of group names that are lists
 	const IniGroupNameList seq_group_names;  ///< list of group names that are sequences.
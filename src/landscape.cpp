@@ -12,6 +12,9 @@
 #include "stdafx.h"
 #include "heightmap.h"
 #include "clear_map.h"
+#include "tree_map.h"
+#include "water_map.h"
+#include "newgrf_generic.h"
 #include "spritecache.h"
 #include "viewport_func.h"
 #include "command_func.h"
@@ -33,10 +36,14 @@
 #include "pathfinder/npf/aystar.h"
 #include "saveload/saveload.h"
 #include "framerate_type.h"
+#include "trace.h"
 #include "landscape_cmd.h"
 #include "terraform_cmd.h"
 #include "station_func.h"
 #include "pathfinder/water_regions.h"
+#include "tunnelbridge.h"
+#include "thread.h"
+#include "task_pool.h"
 
 #include "table/strings.h"
 #include "table/sprites.h"
@@ -707,8 +714,7 @@ std::tuple<CommandCost, Money> CmdClearArea(DoCommandFlag flags, TileIndex tile,
 
 	if (tile != start_tile) flags |= DC_FORCE_CLEAR_TILE;
 
-	std::unique_ptr<TileIterator> iter = TileIterator::Create(tile, start_tile, diagonal);
-	for (; *iter != INVALID_TILE; ++(*iter)) {
+	for (BatchedRedrawTileIterator iter(tile, start_tile, diagonal); *iter != INVALID_TILE; ++iter) {
 		TileIndex t = *iter;
 		CommandCost ret = Command<CMD_LANDSCAPE_CLEAR>::Do(flags & ~DC_EXEC, t);
 		if (ret.Failed()) {
@@ -748,21 +754,313 @@ std::tuple<CommandCost, Money> CmdClearArea(DoCommandFlag flags, TileIndex tile,
 
 TileIndex _cur_tileloop_tile;
 
+/** Minimum number of independent tiles worth handing to an extra thread in the tile loop. */
+static const size_t MIN_TILES_PER_TILE_LOOP_THREAD = 256;
+
+/** Log2 of the edge length of the regions the tile loop can put to sleep. */
+static const uint TILE_LOOP_REGION_BITS = 4;
+
+/** Number of ticks between two checks whether an awake region can be put to sleep. */
+static const uint TILE_LOOP_REGION_CHECK_INTERVAL = 2048;
+
+/** Conditions under which the tile loop of the different tile types cannot change anything. */
+struct TileLoopSleepConditions {
+	bool water; ///< Interior sea, canals and rivers do nothing.
+	bool clear; ///< Fully grown grass, rough land and rocks do nothing.
+	bool trees; ///< Trees on fully grown grass or rough land do nothing.
+
+	bool operator==(const TileLoopSleepConditions &other) const = default;
+
+	/**
+	 * Whether any tile can sleep at all.
+	 * @return True if the tile loop may skip something.
+	 */
+	bool Any() const { return this->water || this->clear || this->trees; }
+};
+
+static std::vector<bool> _tile_loop_region_sleeping; ///< For each region on the map whether the tile loop skips its tiles.
+uint _tile_loop_sleeping_regions = 0;                 ///< Number of regions the tile loop skips.
+static TileLoopSleepConditions _tile_loop_sleep_conditions{}; ///< Conditions the sleeping regions were evaluated with.
+static uint _tile_loop_region_cursor = 0;            ///< Next region to check whether it can sleep.
+
+/**
+ * Get the index of the region of a tile.
+ * @param x X coordinate of the tile.
+ * @param y Y coordinate of the tile.
+ * @return The region index.
+ */
+static inline uint GetTileLoopRegion(uint x, uint y)
+{
+	return (y >> TILE_LOOP_REGION_BITS) * (Map::SizeX() >> TILE_LOOP_REGION_BITS) + (x >> TILE_LOOP_REGION_BITS);
+}
+
+/** Wake all regions and size the region state to the current map. */
+void AllocateTileLoopRegions()
+{
+	_tile_loop_region_sleeping.assign((Map::SizeX() >> TILE_LOOP_REGION_BITS) * (Map::SizeY() >> TILE_LOOP_REGION_BITS), false);
+	_tile_loop_sleeping_regions = 0;
+	_tile_loop_region_cursor = 0;
+}
+
+/**
+ * Wake the tile loop regions that may be affected by a change of a tile.
+ * Whether a tile is idle may depend on its direct neighbours, so the regions of those are woken as well.
+ * @param tile The changed tile.
+ */
+void WakeTileLoopRegions(TileIndex tile)
+{
+	if (_tile_loop_sleeping_regions == 0) return;
+
+	uint x = TileX(tile);
+	uint y = TileY(tile);
+	uint x0 = (x == 0 ? 0 : x - 1) >> TILE_LOOP_REGION_BITS;
+	uint x1 = std::min(x + 1, Map::MaxX()) >> TILE_LOOP_REGION_BITS;
+	uint y0 = (y == 0 ? 0 : y - 1) >> TILE_LOOP_REGION_BITS;
+	uint y1 = std::min(y + 1, Map::MaxY()) >> TILE_LOOP_REGION_BITS;
+	uint width = Map::SizeX() >> TILE_LOOP_REGION_BITS;
+
+	for (uint ry = y0; ry <= y1; ry++) {
+		for (uint rx = x0; rx <= x1; rx++) {
+			uint region = ry * width + rx;
+			if (!_tile_loop_region_sleeping[region]) continue;
+			_tile_loop_region_sleeping[region] = false;
+			_tile_loop_sleeping_regions--;
+		}
+	}
+}
+
+/**
+ * Check whether all valid neighbours of a tile are water, so flooding from it cannot do anything.
+ * @param tile The tile to check.
+ * @return True if no neighbour can be flooded.
+ * @see TileLoop_Water
+ */
+static bool AreAllNeighboursWater(TileIndex tile)
+{
+	for (Direction dir = DIR_BEGIN; dir < DIR_END; dir++) {
+		TileIndex dest = tile + TileOffsByDir(dir);
+		if (!IsValidTile(dest)) continue;
+		if (!IsTileType(dest, MP_WATER)) return false;
+	}
+	return true;
+}
+
+/**
+ * Check whether the tile loop of a tile cannot change anything, and keeps doing so while neither the tile
+ * nor its neighbours change.
+ * @param tile The tile to check.
+ * @param conditions The conditions for the tile types.
+ * @return True if the tile loop may skip the tile.
+ */
+static bool IsTileLoopIdle(TileIndex tile, const TileLoopSleepConditions &conditions)
+{
+	switch (GetTileType(tile)) {
+		case MP_VOID:
+			return conditions.water && AreAllNeighboursWater(tile);
+
+		case MP_WATER:
+			if (!conditions.water || IsCoast(tile)) return false;
+			return GetWaterClass(tile) != WATER_CLASS_SEA || AreAllNeighboursWater(tile);
+
+		case MP_CLEAR:
+			if (!conditions.clear) return false;
+			switch (GetClearGround(tile)) {
+				case CLEAR_GRASS: return GetClearDensity(tile) == 3;
+				case CLEAR_FIELDS: return false;
+				default: return true;
+			}
+
+		case MP_TREES:
+			if (!conditions.trees) return false;
+			switch (GetTreeGround(tile)) {
+				case TREE_GROUND_SHORE: return false;
+				case TREE_GROUND_GRASS: return GetTreeDensity(tile) == 3;
+				default: return true;
+			}
+
+		default:
+			return false;
+	}
+}
+
+/**
+ * Put the regions in which nothing can happen to sleep, so the tile loop skips them.
+ * A limited number of regions is checked each tick.
+ */
+static void UpdateTileLoopRegions()
+{
+	const bool simple_ground = (_settings_game.game_creation.landscape == LT_TEMPERATE || _settings_game.game_creation.landscape == LT_TOYLAND) && !HasGrfMiscBit(GMB_AMBIENT_SOUND_CALLBACK);
+	TileLoopSleepConditions conditions;
+	conditions.water = !HasGrfMiscBit(GMB_AMBIENT_SOUND_CALLBACK);
+	conditions.clear = simple_ground && _game_mode != GM_EDITOR;
+	conditions.trees = simple_ground && _settings_game.construction.extra_tree_placement == ETP_NO_GROWTH_NO_SPREAD;
+
+	if (conditions != _tile_loop_sleep_conditions) {
+		/* What is idle has changed, so everything has to be checked again. */
+		AllocateTileLoopRegions();
+		_tile_loop_sleep_conditions = conditions;
+	}
+	if (!conditions.Any()) return;
+
+	const uint width = Map::SizeX() >> TILE_LOOP_REGION_BITS;
+	const uint regions = static_cast<uint>(_tile_loop_region_sleeping.size());
+	for (uint n = CeilDiv(regions, TILE_LOOP_REGION_CHECK_INTERVAL); n > 0; n--) {
+		uint region = _tile_loop_region_cursor;
+		_tile_loop_region_cursor = (_tile_loop_region_cursor + 1) % regions;
+		if (_tile_loop_region_sleeping[region]) continue;
+
+		uint x0 = (region % width) << TILE_LOOP_REGION_BITS;
+		uint y0 = (region / width) << TILE_LOOP_REGION_BITS;
+		bool idle = true;
+		for (uint y = y0; idle && y < y0 + (1U << TILE_LOOP_REGION_BITS); y++) {
+			for (uint x = x0; idle && x < x0 + (1U << TILE_LOOP_REGION_BITS); x++) {
+				idle = IsTileLoopIdle(TileXY(x, y), conditions);
+			}
+		}
+
+		if (idle) {
+			_tile_loop_region_sleeping[region] = true;
+			_tile_loop_sleeping_regions++;
+		}
+	}
+}
+
+/**
+ * Tile loop of a clear tile for the common case where at most the growth counter of the tile changes.
+ * Only valid without climate specific ground handling, without the ambient sound callback and outside the scenario editor.
+ * @param tile The clear tile.
+ * @return True if the tile loop was handled, false if the full tile loop proc has to run.
+ * @see TileLoop_Clear
+ */
+static inline bool TileLoopClearFast(TileIndex tile)
+{
+	switch (GetClearGround(tile)) {
+		case CLEAR_GRASS:
+			if (GetClearDensity(tile) == 3) return true;
+			if (GetClearCounter(tile) == 7) return false;
+			AddClearCounter(tile, 1);
+			return true;
+
+		case CLEAR_FIELDS:
+			return false;
+
+		default:
+			return true;
+	}
+}
+
+void TileLoopTreesClimate(TileIndex tile);
+void TileLoopTreesGrowth(TileIndex tile);
+
+/**
+ * Tile loop of a tree tile, skipping the growth handling in the common case where it does nothing.
+ * Only valid without the ambient sound callback.
+ * @param tile The tree tile.
+ * @param cycle_base The tick counter part of the update cycle of the tree tile loop.
+ * @param growth Whether trees grow and spread.
+ * @return True if the tile loop was handled, false if the full tile loop proc has to run.
+ * @see TileLoop_Trees
+ */
+static inline bool TileLoopTreesFast(TileIndex tile, uint32_t cycle_base, bool growth)
+{
+	if (GetTreeGround(tile) == TREE_GROUND_SHORE) return false;
+
+	/* Snow and desert may change the ground, and draw random numbers for sounds, so always run this part. */
+	if (_settings_game.game_creation.landscape == LT_ARCTIC || _settings_game.game_creation.landscape == LT_TROPIC) TileLoopTreesClimate(tile);
+
+	uint32_t cycle = 11 * TileX(tile) + 9 * TileY(tile) + cycle_base;
+	if (((cycle & 7) == 7 && GetTreeGround(tile) == TREE_GROUND_GRASS && GetTreeDensity(tile) < 3) ||
+			(growth && (cycle & 15) == 15)) {
+		TileLoopTreesGrowth(tile);
+	}
+	return true;
+}
+
+/**
+ * Run the tile loop procs for a batch of tiles, in the order of the batch.
+ *
+ * Most visited tiles are clear or tree tiles where nothing, or only a counter on the tile itself,
+ * changes. When the settings allow it, these are handled inline and only the tiles that actually
+ * change go through the tile loop proc.
+ *
+ * Tunnel and bridge heads only update their own snow/desert state, which no other tile loop proc
+ * reads, so they are queued and processed after the ordered pass, possibly in parallel. The type
+ * of a queued tile is checked again before it is processed; if an earlier proc changed the type
+ * of the tile, the ordered pass already ran the proc of the new type. If a later proc removed the
+ * tunnel or bridge, the tile is skipped, as the removal overwrote the state anyway. Either way the
+ * resulting map is identical to processing every tile in order.
+ * @param tiles The tiles to run the tile loop for.
+ */
+void FindStationsAroundHousesInTileLoop(std::span<const TileIndex> tiles);
+
+static void RunTileLoopBatch(std::span<const TileIndex> tiles)
+{
+	static std::vector<TileIndex> tunnelbridges;
+	static std::vector<uint8_t> changed;
+	tunnelbridges.clear();
+
+	const bool simple_ground = (_settings_game.game_creation.landscape == LT_TEMPERATE || _settings_game.game_creation.landscape == LT_TOYLAND) && !HasGrfMiscBit(GMB_AMBIENT_SOUND_CALLBACK);
+	const bool fast_clear = simple_ground && _game_mode != GM_EDITOR;
+	const bool fast_trees = !HasGrfMiscBit(GMB_AMBIENT_SOUND_CALLBACK);
+	/* TimerGameTick::counter is incremented by 256 between each call, see TileLoop_Trees. */
+	const uint32_t tree_cycle_base = TimerGameTick::counter >> 8;
+	const bool tree_growth = _settings_game.construction.extra_tree_placement != ETP_NO_GROWTH_NO_SPREAD;
+
+	FindStationsAroundHousesInTileLoop(tiles);
+
+	for (TileIndex tile : tiles) {
+		TileType type = GetTileType(tile);
+		switch (type) {
+			case MP_CLEAR:
+				if (fast_clear && TileLoopClearFast(tile)) continue;
+				break;
+
+			case MP_TREES:
+				if (fast_trees && TileLoopTreesFast(tile, tree_cycle_base, tree_growth)) continue;
+				break;
+
+			case MP_TUNNELBRIDGE:
+				tunnelbridges.push_back(tile);
+				continue;
+
+			default:
+				break;
+		}
+		_tile_type_procs[type]->tile_loop_proc(tile);
+	}
+
+	if (tunnelbridges.empty()) return;
+
+	changed.assign(tunnelbridges.size(), 0);
+	const TileIndex *first = tunnelbridges.data();
+	RunInChunks(std::span<const TileIndex>(tunnelbridges), MIN_TILES_PER_TILE_LOOP_THREAD, [first](std::span<const TileIndex> chunk) {
+		for (const TileIndex &tile : chunk) {
+			if (IsTileType(tile, MP_TUNNELBRIDGE) && UpdateTunnelBridgeSnowOrDesert(tile)) changed[&tile - first] = 1;
+		}
+	});
+
+	/* Marking dirty has to happen on the main thread. */
+	for (size_t i = 0; i < tunnelbridges.size(); i++) {
+		if (changed[i] != 0) MarkTileDirtyByTile(tunnelbridges[i]);
+	}
+}
+
 /**
  * Gradually iterate over all tiles on the map, calling their TileLoopProcs once every 256 ticks.
  */
 void RunTileLoop()
 {
 	PerformanceAccumulator framerate(PFE_GL_LANDSCAPE);
+	TraceScope trace("Tile loop");
 
 	/* The pseudorandom sequence of tiles is generated using a Galois linear feedback
 	 * shift register (LFSR). This allows a deterministic pseudorandom ordering, but
 	 * still with minimal state and fast iteration. */
 
-	/* Maximal length LFSR feedback terms, from 12-bit (for 64x64 maps) to 24-bit (for 4096x4096 maps).
+	/* Maximal length LFSR feedback terms, from 12-bit (for 64x64 maps) to 26-bit (for 8192x8192 maps).
 	 * Extracted from http://www.ece.cmu.edu/~koopman/lfsr/ */
 	static const uint32_t feedbacks[] = {
-		0xD8F, 0x1296, 0x2496, 0x4357, 0x8679, 0x1030E, 0x206CD, 0x403FE, 0x807B8, 0x1004B2, 0x2006A8, 0x4004B2, 0x800B87
+		0xD8F, 0x1296, 0x2496, 0x4357, 0x8679, 0x1030E, 0x206CD, 0x403FE, 0x807B8, 0x1004B2, 0x2006A8, 0x4004B2, 0x800B87, 0x1200000, 0x2000023
 	};
 	static_assert(lengthof(feedbacks) == 2 * MAX_MAP_SIZE_BITS - 2 * MIN_MAP_SIZE_BITS + 1);
 	const uint32_t feedback = feedbacks[Map::LogX() + Map::LogY() - 2 * MIN_MAP_SIZE_BITS];
@@ -770,24 +1068,31 @@ void RunTileLoop()
 	/* We update every tile every 256 ticks, so divide the map size by 2^8 = 256 */
 	uint count = 1 << (Map::LogX() + Map::LogY() - 8);
 
+	static std::vector<TileIndex> batch;
+	batch.clear();
+
 	TileIndex tile = _cur_tileloop_tile;
 	/* The LFSR cannot have a zeroed state. */
 	assert(tile != 0);
 
 	/* Manually update tile 0 every 256 ticks - the LFSR never iterates over it itself.  */
 	if (TimerGameTick::counter % 256 == 0) {
-		_tile_type_procs[GetTileType(0)]->tile_loop_proc(0);
+		batch.push_back(0);
 		count--;
 	}
 
+	const bool check_sleeping = _tile_loop_sleeping_regions != 0;
 	while (count--) {
-		_tile_type_procs[GetTileType(tile)]->tile_loop_proc(tile);
+		if (!check_sleeping || !_tile_loop_region_sleeping[GetTileLoopRegion(TileX(tile), TileY(tile))]) batch.push_back(tile);
 
 		/* Get the next tile in sequence using a Galois LFSR. */
 		tile = (tile.base() >> 1) ^ (-(int32_t)(tile.base() & 1) & feedback);
 	}
 
 	_cur_tileloop_tile = tile;
+
+	RunTileLoopBatch(batch);
+	UpdateTileLoopRegions();
 }
 
 void InitializeLandscape()
@@ -930,24 +1235,39 @@ static void GenerateTerrain(int type, uint flag)
 
 #include "table/genland.h"
 
-static void CreateDesertOrRainForest(uint desert_tropic_line)
+/**
+ * Check a condition for all valid tiles of the map, in bands on the task workers.
+ * The condition may only read the map. The four quarters of the map each count
+ * as a step of the landscape generation progress.
+ * @param[out] result For every tile whether it is valid and meets the condition.
+ * @param condition The condition to check.
+ */
+static void ForAllTilesInBands(std::vector<uint8_t> &result, const std::function<bool(TileIndex)> &condition)
 {
-	uint update_freq = Map::Size() / 4;
-	const TileIndexDiffC *data;
-
-	for (TileIndex tile = 0; tile != Map::Size(); ++tile) {
-		if ((tile.base() % update_freq) == 0) IncreaseGeneratingWorldProgress(GWP_LANDSCAPE);
+	uint quarter = Map::Size() / 4;
+	for (uint first = 0; first != Map::Size(); first += quarter) {
+		IncreaseGeneratingWorldProgress(GWP_LANDSCAPE);
+		RunInBands(TaskCategory::WorldGen, quarter, 1 << 14, [&result, &condition, first](uint begin, uint end) {
+			for (TileIndex tile{first + begin}; tile != first + end; ++tile) {
+				result[tile.base()] = IsValidTile(tile) && condition(tile);
+			}
+		});
+	}
+}
 
-		if (!IsValidTile(tile)) continue;
+static void CreateDesertOrRainForest(uint desert_tropic_line)
+{
+	std::vector<uint8_t> in_zone(Map::Size());
 
-		for (data = _make_desert_or_rainforest_data;
-				data != endof(_make_desert_or_rainforest_data); ++data) {
-			TileIndex t = AddTileIndexDiffCWrap(tile, *data);
-			if (t != INVALID_TILE && (TileHeight(t) >= desert_tropic_line || IsTileType(t, MP_WATER))) break;
-		}
-		if (data == endof(_make_desert_or_rainforest_data)) {
-			SetTropicZone(tile, TROPICZONE_DESERT);
+	ForAllTilesInBands(in_zone, [desert_tropic_line](TileIndex tile) {
+		for (const TileIndexDiffC &data : _make_desert_or_rainforest_data) {
+			TileIndex t = AddTileIndexDiffCWrap(tile, data);
+			if (t != INVALID_TILE && (TileHeight(t) >= desert_tropic_line || IsTileType(t, MP_WATER))) return false;
 		}
+		return true;
+	});
+	for (TileIndex tile = 0; tile != Map::Size(); ++tile) {
+		if (in_zone[tile.base()] != 0) SetTropicZone(tile, TROPICZONE_DESERT);
 	}
 
 	for (uint i = 0; i != 256; i++) {
@@ -956,19 +1276,15 @@ static void CreateDesertOrRainForest(uint desert_tropic_line)
 		RunTileLoop();
 	}
 
-	for (TileIndex tile = 0; tile != Map::Size(); ++tile) {
-		if ((tile.base() % update_freq) == 0) IncreaseGeneratingWorldProgress(GWP_LANDSCAPE);
-
-		if (!IsValidTile(tile)) continue;
-
-		for (data = _make_desert_or_rainforest_data;
-				data != endof(_make_desert_or_rainforest_data); ++data) {
-			TileIndex t = AddTileIndexDiffCWrap(tile, *data);
-			if (t != INVALID_TILE && IsTileType(t, MP_CLEAR) && IsClearGround(t, CLEAR_DESERT)) break;
-		}
-		if (data == endof(_make_desert_or_rainforest_data)) {
-			SetTropicZone(tile, TROPICZONE_RAINFOREST);
+	ForAllTilesInBands(in_zone, [](TileIndex tile) {
+		for (const TileIndexDiffC &data : _make_desert_or_rainforest_data) {
+			TileIndex t = AddTileIndexDiffCWrap(tile, data);
+			if (t != INVALID_TILE && IsTileType(t, MP_CLEAR) && IsClearGround(t, CLEAR_DESERT)) return false;
 		}
+		return true;
+	});
+	for (TileIndex tile = 0; tile != Map::Size(); ++tile) {
+		if (in_zone[tile.base()] != 0) SetTropicZone(tile, TROPICZONE_RAINFOREST);
 	}
 }
 
@@ -136,6 +136,7 @@ void DoClearSquare(TileIndex tile);
 void RunTileLoop();
 
 void InitializeLandscape();
+void AllocateTileLoopRegions();
 bool GenerateLandscape(uint8_t mode);
 
 #endif /* LANDSCAPE_H */
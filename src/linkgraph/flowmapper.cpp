@@ -56,7 +56,7 @@ void FlowMapper::Run(LinkGraphJob &job) const
 			}
 		}
 		/* Clear paths. */
-		for (Path *i : node.paths) delete i;
+		for (Path *i : node.paths) job.Paths().Free(i);
 		node.paths.clear();
 	}
 }
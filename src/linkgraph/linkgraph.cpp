@@ -9,6 +9,7 @@
 
 #include "../stdafx.h"
 #include "../core/pool_func.hpp"
+#include "../settings_type.h"
 #include "linkgraph.h"
 
 #include "../safeguards.h"
@@ -83,6 +84,60 @@ void LinkGraph::Compress()
 	}
 }
 
+/**
+ * Reduce a value to roughly its three most significant bits, so that small
+ * relative changes of it usually don't change the result.
+ * @param value Value to be quantized.
+ * @return Quantized value, 0 only for 0.
+ */
+static uint QuantizeForFingerprint(uint value)
+{
+	if (value == 0) return 0;
+	uint8_t bit = FindLastBit(value);
+	uint mantissa = bit >= 3 ? value >> (bit - 3) : value << (3 - bit);
+	return bit * 8 + (mantissa & 7) + 1;
+}
+
+/**
+ * Calculate a fingerprint of everything a link graph job reads: the settings,
+ * the stations, their supply and acceptance, and the capacities and travel
+ * times of the links. Supplies and capacities are taken as monthly values and
+ * quantized, so a network that only fluctuates a little keeps its fingerprint.
+ * The fingerprint also changes every #STABLE_RECALC_INTERVAL days, so even
+ * stable networks are recalculated every now and then.
+ * @return Fingerprint, never 0.
+ */
+uint64_t LinkGraph::CalculateJobFingerprint() const
+{
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	auto mix = [&hash](uint64_t value) { hash = (hash ^ value) * 0x100000001B3ULL; };
+
+	const LinkGraphSettings &settings = _settings_game.linkgraph;
+	mix(settings.GetDistributionType(this->cargo));
+	mix(settings.accuracy);
+	mix(settings.demand_size);
+	mix(settings.demand_distance);
+	mix(settings.short_path_saturation);
+	mix(settings.recalc_time);
+	mix(TimerGameEconomy::date.base() / STABLE_RECALC_INTERVAL.base());
+
+	mix(this->Size());
+	for (const BaseNode &node : this->nodes) {
+		mix(node.station);
+		mix(node.xy.base());
+		mix(node.demand);
+		mix(QuantizeForFingerprint(this->Monthly(node.supply)));
+		for (const BaseEdge &edge : node.edges) {
+			mix(edge.dest_node);
+			mix(QuantizeForFingerprint(this->Monthly(edge.capacity)));
+			mix(edge.capacity > 0 ? QuantizeForFingerprint(edge.TravelTime()) : 0);
+			mix(edge.last_unrestricted_update == EconomyTime::INVALID_DATE);
+			mix(edge.last_restricted_update == EconomyTime::INVALID_DATE);
+		}
+	}
+	return hash == 0 ? 1 : hash;
+}
+
 /**
  * Merge a link graph with another one.
  * @param other LinkGraph to be merged into this one.
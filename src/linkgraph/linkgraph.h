@@ -175,6 +175,9 @@ public:
 	/** Minimum number of days between subsequent compressions of a LG. */
 	static constexpr TimerGameEconomy::Date COMPRESSION_INTERVAL = 256;
 
+	/** Number of days after which the flows of a LG are recalculated even if it didn't change. */
+	static constexpr TimerGameEconomy::Date STABLE_RECALC_INTERVAL = 128;
+
 	/**
 	 * Scale a value from a link graph of age orig_age for usage in one of age
 	 * target_age. Make sure that the value stays > 0 if it was > 0 before.
@@ -189,12 +192,12 @@ public:
 	}
 
 	/** Bare constructor, only for save/load. */
-	LinkGraph() : cargo(INVALID_CARGO), last_compression(0) {}
+	LinkGraph() : cargo(INVALID_CARGO), last_compression(0), job_fingerprint(0) {}
 	/**
 	 * Real constructor.
 	 * @param cargo Cargo the link graph is about.
 	 */
-	LinkGraph(CargoID cargo) : cargo(cargo), last_compression(TimerGameEconomy::date) {}
+	LinkGraph(CargoID cargo) : cargo(cargo), last_compression(TimerGameEconomy::date), job_fingerprint(0) {}
 
 	void Init(uint size);
 	void ShiftDates(TimerGameEconomy::Date interval);
@@ -254,6 +257,18 @@ public:
 	NodeID AddNode(const Station *st);
 	void RemoveNode(NodeID id);
 
+	uint64_t CalculateJobFingerprint() const;
+
+	/**
+	 * Check whether a new job would have the same input as the last one, so
+	 * the flows it calculated can be kept.
+	 * @return If the link graph didn't change noticeably since the last job.
+	 */
+	inline bool IsUnchangedSinceLastJob() const { return this->job_fingerprint == this->CalculateJobFingerprint(); }
+
+	/** Remember the input of the job that is about to be spawned. */
+	inline void RecordJobFingerprint() { this->job_fingerprint = this->CalculateJobFingerprint(); }
+
 protected:
 	friend SaveLoadTable GetLinkGraphDesc();
 	friend SaveLoadTable GetLinkGraphJobDesc();
@@ -263,6 +278,7 @@ protected:
 
 	CargoID cargo;         ///< Cargo of this component's link graph.
 	TimerGameEconomy::Date last_compression; ///< Last time the capacities and supplies were compressed.
+	uint64_t job_fingerprint; ///< Fingerprint of the input of the last job, 0 if there was none.
 	NodeVector nodes;      ///< Nodes in the component.
 };
 
@@ -71,6 +71,7 @@ void LinkGraphOverlay::GetWidgetDpi(DrawPixelInfo *dpi) const
 void LinkGraphOverlay::RebuildCache()
 {
 	this->cached_links.clear();
+	this->cached_link_list.clear();
 	this->cached_stations.clear();
 	if (this->company_mask == 0) return;
 
@@ -116,6 +117,22 @@ void LinkGraphOverlay::RebuildCache()
 			this->cached_stations.push_back(std::make_pair(from, supply));
 		}
 	}
+
+	/* Determining the height of a station is relatively expensive, and the links are drawn in many
+	 * small parts every frame. So remember the virtual coordinates of the stations until the next rebuild. */
+	const bool is_viewport = this->window->viewport != nullptr;
+	std::map<StationID, Point> virtual_pos;
+	auto get_virtual_pos = [&](StationID id) -> Point {
+		if (!is_viewport) return {};
+		auto it = virtual_pos.find(id);
+		if (it == virtual_pos.end()) it = virtual_pos.emplace(id, GetStationVirtualMiddle(Station::Get(id))).first;
+		return it->second;
+	};
+	for (const auto &i : this->cached_links) {
+		for (const auto &j : i.second) {
+			this->cached_link_list.push_back({ i.first, j.first, get_virtual_pos(i.first), get_virtual_pos(j.first), &j.second });
+		}
+	}
 }
 
 /**
@@ -276,15 +293,12 @@ void LinkGraphOverlay::Draw(const DrawPixelInfo *dpi)
 void LinkGraphOverlay::DrawLinks(const DrawPixelInfo *dpi) const
 {
 	int width = ScaleGUITrad(this->scale);
-	for (const auto &i : this->cached_links) {
-		if (!Station::IsValidID(i.first)) continue;
-		Point pta = this->GetStationMiddle(Station::Get(i.first));
-		for (const auto &j : i.second) {
-			if (!Station::IsValidID(j.first)) continue;
-			Point ptb = this->GetStationMiddle(Station::Get(j.first));
-			if (!this->IsLinkVisible(pta, ptb, dpi, width + 2)) continue;
-			this->DrawContent(pta, ptb, j.second);
-		}
+	for (const CachedLink &link : this->cached_link_list) {
+		if (!Station::IsValidID(link.from) || !Station::IsValidID(link.to)) continue;
+		Point pta = this->GetStationMiddle(link.from, link.from_pos);
+		Point ptb = this->GetStationMiddle(link.to, link.to_pos);
+		if (!this->IsLinkVisible(pta, ptb, dpi, width + 2)) continue;
+		this->DrawContent(pta, ptb, *link.props);
 	}
 }
 
@@ -358,55 +372,52 @@ void LinkGraphOverlay::DrawStationDots(const DrawPixelInfo *dpi) const
 
 bool LinkGraphOverlay::ShowTooltip(Point pt, TooltipCloseCondition close_cond)
 {
-	for (auto i(this->cached_links.crbegin()); i != this->cached_links.crend(); ++i) {
-		if (!Station::IsValidID(i->first)) continue;
-		Point pta = this->GetStationMiddle(Station::Get(i->first));
-		for (auto j(i->second.crbegin()); j != i->second.crend(); ++j) {
-			if (!Station::IsValidID(j->first)) continue;
-			if (i->first == j->first) continue;
-
-			/* Check the distance from the cursor to the line defined by the two stations. */
-			Point ptb = this->GetStationMiddle(Station::Get(j->first));
-			float dist = std::abs((int64_t)(ptb.x - pta.x) * (int64_t)(pta.y - pt.y) - (int64_t)(pta.x - pt.x) * (int64_t)(ptb.y - pta.y)) /
-				std::sqrt((int64_t)(ptb.x - pta.x) * (int64_t)(ptb.x - pta.x) + (int64_t)(ptb.y - pta.y) * (int64_t)(ptb.y - pta.y));
-			const auto &link = j->second;
-			if (dist <= 4 && link.Usage() > 0 &&
-					pt.x + 2 >= std::min(pta.x, ptb.x) &&
-					pt.x - 2 <= std::max(pta.x, ptb.x) &&
-					pt.y + 2 >= std::min(pta.y, ptb.y) &&
-					pt.y - 2 <= std::max(pta.y, ptb.y)) {
-				static std::string tooltip_extension;
-				tooltip_extension.clear();
-				/* Fill buf with more information if this is a bidirectional link. */
-				uint32_t back_time = 0;
-				auto k = this->cached_links[j->first].find(i->first);
-				if (k != this->cached_links[j->first].end()) {
-					const auto &back = k->second;
-					back_time = back.time;
-					if (back.Usage() > 0) {
-						SetDParam(0, back.cargo);
-						SetDParam(1, back.Usage());
-						SetDParam(2, back.Usage() * 100 / (back.capacity + 1));
-						tooltip_extension = GetString(STR_LINKGRAPH_STATS_TOOLTIP_RETURN_EXTENSION);
-					}
+	for (auto i(this->cached_link_list.crbegin()); i != this->cached_link_list.crend(); ++i) {
+		if (!Station::IsValidID(i->from) || !Station::IsValidID(i->to)) continue;
+		if (i->from == i->to) continue;
+
+		/* Check the distance from the cursor to the line defined by the two stations. */
+		Point pta = this->GetStationMiddle(i->from, i->from_pos);
+		Point ptb = this->GetStationMiddle(i->to, i->to_pos);
+		float dist = std::abs((int64_t)(ptb.x - pta.x) * (int64_t)(pta.y - pt.y) - (int64_t)(pta.x - pt.x) * (int64_t)(ptb.y - pta.y)) /
+			std::sqrt((int64_t)(ptb.x - pta.x) * (int64_t)(ptb.x - pta.x) + (int64_t)(ptb.y - pta.y) * (int64_t)(ptb.y - pta.y));
+		const auto &link = *i->props;
+		if (dist <= 4 && link.Usage() > 0 &&
+				pt.x + 2 >= std::min(pta.x, ptb.x) &&
+				pt.x - 2 <= std::max(pta.x, ptb.x) &&
+				pt.y + 2 >= std::min(pta.y, ptb.y) &&
+				pt.y - 2 <= std::max(pta.y, ptb.y)) {
+			static std::string tooltip_extension;
+			tooltip_extension.clear();
+			/* Fill buf with more information if this is a bidirectional link. */
+			uint32_t back_time = 0;
+			auto k = this->cached_links[i->to].find(i->from);
+			if (k != this->cached_links[i->to].end()) {
+				const auto &back = k->second;
+				back_time = back.time;
+				if (back.Usage() > 0) {
+					SetDParam(0, back.cargo);
+					SetDParam(1, back.Usage());
+					SetDParam(2, back.Usage() * 100 / (back.capacity + 1));
+					tooltip_extension = GetString(STR_LINKGRAPH_STATS_TOOLTIP_RETURN_EXTENSION);
 				}
-				/* Add information about the travel time if known. */
-				const auto time = link.time ? back_time ? ((link.time + back_time) / 2) : link.time : back_time;
-				if (time > 0) {
-					SetDParam(0, time);
-					tooltip_extension += GetString(STR_LINKGRAPH_STATS_TOOLTIP_TIME_EXTENSION);
-				}
-				SetDParam(0, link.cargo);
-				SetDParam(1, link.Usage());
-				SetDParam(2, i->first);
-				SetDParam(3, j->first);
-				SetDParam(4, link.Usage() * 100 / (link.capacity + 1));
-				SetDParamStr(5, tooltip_extension);
-				GuiShowTooltips(this->window,
-					TimerGameEconomy::UsingWallclockUnits() ? STR_LINKGRAPH_STATS_TOOLTIP_MINUTE : STR_LINKGRAPH_STATS_TOOLTIP_MONTH,
-					close_cond, 7);
-				return true;
 			}
+			/* Add information about the travel time if known. */
+			const auto time = link.time ? back_time ? ((link.time + back_time) / 2) : link.time : back_time;
+			if (time > 0) {
+				SetDParam(0, time);
+				tooltip_extension += GetString(STR_LINKGRAPH_STATS_TOOLTIP_TIME_EXTENSION);
+			}
+			SetDParam(0, link.cargo);
+			SetDParam(1, link.Usage());
+			SetDParam(2, i->from);
+			SetDParam(3, i->to);
+			SetDParam(4, link.Usage() * 100 / (link.capacity + 1));
+			SetDParamStr(5, tooltip_extension);
+			GuiShowTooltips(this->window,
+				TimerGameEconomy::UsingWallclockUnits() ? STR_LINKGRAPH_STATS_TOOLTIP_MINUTE : STR_LINKGRAPH_STATS_TOOLTIP_MONTH,
+				close_cond, 7);
+			return true;
 		}
 	}
 	GuiShowTooltips(this->window, STR_NULL, close_cond);
@@ -428,6 +439,22 @@ Point LinkGraphOverlay::GetStationMiddle(const Station *st) const
 	}
 }
 
+/**
+ * Determine the middle of a cached station in the current window.
+ * @param st The station we're looking for.
+ * @param virtual_pos The cached virtual coordinates of the station.
+ * @return Middle point of the station in the current window.
+ */
+Point LinkGraphOverlay::GetStationMiddle(StationID st, Point virtual_pos) const
+{
+	if (this->window->viewport != nullptr) {
+		return VirtualToViewportPoint(this->window->viewport, virtual_pos);
+	} else {
+		/* assume this is a smallmap */
+		return GetSmallMapStationMiddle(this->window, Station::Get(st));
+	}
+}
+
 /**
  * Set a new cargo mask and rebuild the cache.
  * @param cargo_mask New cargo mask.
@@ -46,6 +46,15 @@ public:
 
 	static const uint8_t LINK_COLOURS[][12];
 
+	/** A cached link together with the positions of its stations that do not change when scrolling. */
+	struct CachedLink {
+		StationID from;              ///< Station the link starts at.
+		StationID to;                ///< Station the link ends at.
+		Point from_pos;              ///< Virtual coordinates of the first station, only used for viewports.
+		Point to_pos;                ///< Virtual coordinates of the second station, only used for viewports.
+		const LinkProperties *props; ///< Properties of the link, owned by #cached_links.
+	};
+
 	/**
 	 * Create a link graph overlay for the specified window.
 	 * @param w Window to be drawn into.
@@ -79,11 +88,13 @@ protected:
 	CargoTypes cargo_mask;             ///< Bitmask of cargos to be displayed.
 	CompanyMask company_mask;          ///< Bitmask of companies to be displayed.
 	LinkMap cached_links;              ///< Cache for links to reduce recalculation.
+	std::vector<CachedLink> cached_link_list; ///< Flat list of #cached_links to be drawn.
 	StationSupplyList cached_stations; ///< Cache for stations to be drawn.
 	uint scale;                        ///< Width of link lines.
 	bool dirty;                        ///< Set if overlay should be rebuilt.
 
 	Point GetStationMiddle(const Station *st) const;
+	Point GetStationMiddle(StationID st, Point virtual_pos) const;
 
 	void AddLinks(const Station *sta, const Station *stb);
 	void DrawLinks(const DrawPixelInfo *dpi) const;
@@ -38,8 +38,10 @@ LinkGraphJob::LinkGraphJob(const LinkGraph &orig) :
 		link_graph(orig),
 		settings(_settings_game.linkgraph),
 		join_date(TimerGameEconomy::date + (_settings_game.linkgraph.recalc_time / EconomyTime::SECONDS_PER_DAY)),
+		join_delay(0),
 		job_completed(false),
-		job_aborted(false)
+		job_aborted(false),
+		progress(0)
 {
 }
 
@@ -55,12 +57,14 @@ void LinkGraphJob::EraseFlows(NodeID from)
 }
 
 /**
- * Spawn a thread if possible and run the link graph job in the thread. If
- * that's not possible run the job right now in the current thread.
+ * Hand the link graph job to the worker pool if possible. If there are no
+ * worker threads run the job right now in the current thread.
  */
 void LinkGraphJob::SpawnThread()
 {
-	if (!StartNewThread(&this->thread, "ottd:linkgraph", &(LinkGraphSchedule::Run), this)) {
+	if (HasTaskWorkers()) {
+		this->task = SubmitTask(TaskCategory::LinkGraph, [this]() { LinkGraphSchedule::Run(this); });
+	} else {
 		/* Of course this will hang a bit.
 		 * On the other hand, if you want to play games which make this hang noticeably
 		 * on a platform without threads then you'll probably get other problems first.
@@ -77,8 +81,9 @@ void LinkGraphJob::SpawnThread()
  */
 void LinkGraphJob::JoinThread()
 {
-	if (this->thread.joinable()) {
-		this->thread.join();
+	if (this->task.IsValid()) {
+		this->task.Wait();
+		this->task = {};
 	}
 }
 
@@ -157,7 +162,7 @@ LinkGraphJob::~LinkGraphJob()
 				} else {
 					FlowStat shares(INVALID_STATION, 1);
 					it->second.SwapShares(shares);
-					ge.flows.erase(it++);
+					it = ge.flows.erase(it);
 					for (FlowStat::SharesMap::const_iterator shares_it(shares.GetShares()->begin());
 							shares_it != shares.GetShares()->end(); ++shares_it) {
 						RerouteCargo(st, this->Cargo(), shares_it->second, st->index);
@@ -182,12 +187,73 @@ LinkGraphJob::~LinkGraphJob()
 void LinkGraphJob::Init()
 {
 	uint size = this->Size();
+	this->demands.resize(size * size);
 	this->nodes.reserve(size);
 	for (uint i = 0; i < size; ++i) {
-		this->nodes.emplace_back(this->link_graph.nodes[i], this->link_graph.Size());
+		this->nodes.emplace_back(this->link_graph.nodes[i], std::span(this->demands).subspan(i * size, size));
 	}
 }
 
+/**
+ * Estimate the memory used by the job. As the job may be running in its own
+ * thread, this is calculated from the copy of the link graph, which does not
+ * change, rather than from the annotations and flows being calculated.
+ * @return Estimated number of bytes used by the job.
+ */
+size_t LinkGraphJob::MemoryUsage() const
+{
+	size_t size = this->Size();
+	size_t edges = 0;
+	for (const LinkGraph::BaseNode &node : this->link_graph.nodes) edges += node.edges.size();
+
+	size_t graph = size * sizeof(LinkGraph::BaseNode) + edges * sizeof(LinkGraph::BaseEdge);
+	size_t annotations = size * sizeof(NodeAnnotation) + size * size * sizeof(DemandAnnotation) + edges * sizeof(EdgeAnnotation);
+	return sizeof(*this) + graph + annotations + this->path_arena.MemoryUsage();
+}
+
+/**
+ * Get storage for a number of paths. The paths are to be constructed in it
+ * with placement new. This may be called from multiple threads at once.
+ * @param slots Span to be filled with the storage for one path each.
+ */
+void PathArena::Allocate(std::span<void *> slots)
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	for (void *&slot : slots) {
+		if (!this->free_slots.empty()) {
+			slot = this->free_slots.back();
+			this->free_slots.pop_back();
+			continue;
+		}
+		if (this->block_used == BLOCK_SIZE) {
+			this->blocks.push_back(std::make_unique<Slot[]>(BLOCK_SIZE));
+			this->block_used = 0;
+		}
+		slot = &this->blocks.back()[this->block_used++];
+	}
+}
+
+/**
+ * Destroy a path and make its storage available again.
+ * @param path Path allocated from this arena.
+ */
+void PathArena::Free(Path *path)
+{
+	path->~Path();
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->free_slots.push_back(path);
+}
+
+/**
+ * Get the memory allocated for paths.
+ * @return Number of bytes in all blocks of the arena.
+ */
+size_t PathArena::MemoryUsage() const
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->blocks.size() * BLOCK_SIZE * sizeof(Slot);
+}
+
 /**
  * Add this path as a new child to the given base path, thus making this path
  * a "fork" of the base path.
@@ -13,11 +13,41 @@
 #include "../thread.h"
 #include "linkgraph.h"
 #include <atomic>
+#include <mutex>
 
 class LinkGraphJob;
 class Path;
 typedef std::list<Path *> PathList;
 
+/**
+ * Storage for the paths of a link graph job. The MCF creates and throws away
+ * paths for every node per source in every iteration, so rather than
+ * allocating each of them on the heap they are taken from blocks owned by
+ * the job and recycled through a free list. The blocks are freed together
+ * with the job.
+ */
+class PathArena {
+public:
+	static constexpr size_t SLOT_SIZE = 64; ///< Maximum size of a path, including any annotation deriving from it.
+
+	void Allocate(std::span<void *> slots);
+	void Free(Path *path);
+	size_t MemoryUsage() const;
+
+private:
+	static constexpr size_t BLOCK_SIZE = 1024; ///< Number of slots allocated at once.
+
+	/** Storage for a single path. */
+	struct alignas(std::max_align_t) Slot {
+		std::byte data[SLOT_SIZE];
+	};
+
+	mutable std::mutex mutex;                    ///< Protects the arena from concurrent Dijkstra runs.
+	std::vector<std::unique_ptr<Slot[]>> blocks; ///< All allocated blocks.
+	size_t block_used = BLOCK_SIZE;              ///< Number of slots of the last block handed out so far.
+	std::vector<void *> free_slots;              ///< Slots that have been freed and can be reused.
+};
+
 /** Type of the pool for link graph jobs. */
 typedef Pool<LinkGraphJob, LinkGraphJobID, 32, 0xFFFF> LinkGraphJobPool;
 /** The actual pool with link graph jobs. */
@@ -84,14 +114,13 @@ public:
 		PathList paths;          ///< Paths through this node, sorted so that those with flow == 0 are in the back.
 		FlowStatMap flows;       ///< Planned flows to other nodes.
 
-		std::vector<EdgeAnnotation>   edges;   ///< Annotations for all edges originating at this node.
-		std::vector<DemandAnnotation> demands; ///< Annotations for the demand to all other nodes.
+		std::vector<EdgeAnnotation>     edges;   ///< Annotations for all edges originating at this node.
+		std::span<DemandAnnotation>     demands; ///< Annotations for the demand to all other nodes, part of LinkGraphJob::demands.
 
-		NodeAnnotation(const LinkGraph::BaseNode &node, size_t size) : base(node), undelivered_supply(node.supply), paths(), flows()
+		NodeAnnotation(const LinkGraph::BaseNode &node, std::span<DemandAnnotation> demands) : base(node), undelivered_supply(node.supply), paths(), flows(), demands(demands)
 		{
 			this->edges.reserve(node.edges.size());
 			for (auto &e : node.edges) this->edges.emplace_back(e);
-			this->demands.resize(size);
 		}
 
 		/**
@@ -162,11 +191,15 @@ private:
 protected:
 	const LinkGraph link_graph;        ///< Link graph to by analyzed. Is copied when job is started and mustn't be modified later.
 	const LinkGraphSettings settings;  ///< Copy of _settings_game.linkgraph at spawn time.
-	std::thread thread;                ///< Thread the job is running in or a default-constructed thread if it's running in the main thread.
+	TaskHandle task;                   ///< Task the job is running in or an invalid handle if it's running in the main thread.
 	TimerGameEconomy::Date join_date; ///< Date when the job is to be joined.
+	TimerGameEconomy::Date join_delay; ///< Number of days the join has been postponed by because the job was overdue.
 	NodeAnnotationVector nodes;        ///< Extra node data necessary for link graph calculation.
+	std::vector<DemandAnnotation> demands; ///< Demands between all pairs of nodes, one row per node.
+	PathArena path_arena;              ///< Storage for the paths calculated by the MCF.
 	std::atomic<bool> job_completed;   ///< Is the job still running. This is accessed by multiple threads and reads may be stale.
 	std::atomic<bool> job_aborted;     ///< Has the job been aborted. This is accessed by multiple threads and reads may be stale.
+	std::atomic<uint16_t> progress;    ///< Per mille of the handlers that have run. This is accessed by multiple threads and reads may be stale.
 
 	void EraseFlows(NodeID from);
 	void JoinThread();
@@ -178,7 +211,7 @@ public:
 	 * settings have to be brutally const-casted in order to populate them.
 	 */
 	LinkGraphJob() : settings(_settings_game.linkgraph),
-			join_date(EconomyTime::INVALID_DATE), job_completed(false), job_aborted(false) {}
+			join_date(EconomyTime::INVALID_DATE), join_delay(0), job_completed(false), job_aborted(false), progress(0) {}
 
 	LinkGraphJob(const LinkGraph &orig);
 	~LinkGraphJob();
@@ -211,14 +244,34 @@ public:
 	 * Check if job is supposed to be finished.
 	 * @return True if job should be finished by now, false if not.
 	 */
-	inline bool IsScheduledToBeJoined() const { return this->join_date <= TimerGameEconomy::date; }
+	inline bool IsScheduledToBeJoined() const { return this->join_date + this->join_delay <= TimerGameEconomy::date; }
 
 	/**
-	 * Get the date when the job should be finished.
+	 * Get the date when the job should be finished. This is the date the job
+	 * was scheduled for when it was spawned; postponing the join doesn't change it.
 	 * @return Join date.
 	 */
 	inline TimerGameEconomy::Date JoinDate() const { return join_date; }
 
+	/**
+	 * Get the number of days the join has been postponed by.
+	 * @return Delay of the join.
+	 */
+	inline TimerGameEconomy::Date JoinDelay() const { return this->join_delay; }
+
+	/**
+	 * Postpone the join of an overdue job.
+	 * @param days Number of days to postpone the join by.
+	 */
+	inline void PostponeJoin(TimerGameEconomy::Date days) { this->join_delay += days; }
+
+	/**
+	 * Get the progress of the job. Only meant as a hint for how long the job
+	 * still needs; this is allowed to return an outdated value.
+	 * @return Per mille of the calculation that is done.
+	 */
+	inline uint16_t Progress() const { return this->progress.load(std::memory_order_relaxed); }
+
 	/**
 	 * Change the join date on date cheating.
 	 * @param interval Number of days to add.
@@ -244,6 +297,12 @@ public:
 	 */
 	inline NodeID Size() const { return this->link_graph.Size(); }
 
+	/**
+	 * Get the storage for the paths of this job.
+	 * @return Path arena.
+	 */
+	inline PathArena &Paths() { return this->path_arena; }
+
 	/**
 	 * Get the cargo of the underlying link graph.
 	 * @return Cargo.
@@ -267,6 +326,8 @@ public:
 	 * @return Link graph.
 	 */
 	inline const LinkGraph &Graph() const { return this->link_graph; }
+
+	size_t MemoryUsage() const;
 };
 
 /**
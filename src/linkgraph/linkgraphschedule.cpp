@@ -14,9 +14,11 @@
 #include "mcf.h"
 #include "flowmapper.h"
 #include "../framerate_type.h"
+#include "../trace.h"
 #include "../command_func.h"
 #include "../network/network.h"
 #include "../misc_cmd.h"
+#include "../core/math_func.hpp"
 
 #include "../safeguards.h"
 
@@ -28,14 +30,16 @@
 /* static */ LinkGraphSchedule LinkGraphSchedule::instance;
 
 /**
- * Start the next job in the schedule.
+ * Start the next job in the schedule. If enabled, link graphs that didn't
+ * change noticeably since their last job keep their flows and are skipped, so
+ * the next link graph that does need a recalculation gets it right away.
  */
 void LinkGraphSchedule::SpawnNext()
 {
 	if (this->schedule.empty()) return;
 	LinkGraph *next = this->schedule.front();
 	LinkGraph *first = next;
-	while (next->Size() < 2) {
+	while (next->Size() < 2 || (_settings_game.linkgraph.skip_unchanged_jobs && next->IsUnchangedSinceLastJob())) {
 		this->schedule.splice(this->schedule.end(), this->schedule, this->schedule.begin());
 		next = this->schedule.front();
 		if (next == first) return;
@@ -43,6 +47,7 @@ void LinkGraphSchedule::SpawnNext()
 	assert(next == LinkGraph::Get(next->index));
 	this->schedule.pop_front();
 	if (LinkGraphJob::CanAllocateItem()) {
+		next->RecordJobFingerprint();
 		LinkGraphJob *job = new LinkGraphJob(*next);
 		job->SpawnThread();
 		this->running.push_back(job);
@@ -70,6 +75,7 @@ void LinkGraphSchedule::JoinNext()
 	if (this->running.empty()) return;
 	LinkGraphJob *next = this->running.front();
 	if (!next->IsScheduledToBeJoined()) return;
+	TraceScope trace("Link graph join");
 	this->running.pop_front();
 	LinkGraphID id = next->LinkGraphIndex();
 	delete next; // implicitly joins the thread
@@ -89,6 +95,7 @@ void LinkGraphSchedule::JoinNext()
 	for (uint i = 0; i < lengthof(instance.handlers); ++i) {
 		if (job->IsJobAborted()) return;
 		instance.handlers[i]->Run(*job);
+		job->progress.store(static_cast<uint16_t>((i + 1) * 1000 / lengthof(instance.handlers)), std::memory_order_relaxed);
 	}
 
 	/*
@@ -162,12 +169,51 @@ LinkGraphSchedule::~LinkGraphSchedule()
 	}
 }
 
+/**
+ * Estimate by how many days the join of an overdue job has to be postponed
+ * for the job to be finished by then. The estimate assumes the rest of the
+ * job runs at the same pace as the part that is done. At a low progress that
+ * can be a lot, so the postponement is capped such that the total delay of
+ * the job stays within its original duration.
+ * @param elapsed Number of days the job has been running.
+ * @param progress Progress of the job, in thousandths.
+ * @param interval Number of days between two joins.
+ * @param max_delay Number of days the join may still be postponed by in total.
+ * @return Number of days, a multiple of \a interval and at least one interval.
+ */
+int GetLinkGraphJoinPostponement(int elapsed, uint progress, int interval, int max_delay)
+{
+	const int pace = Clamp<int>(progress, 1, 1000);
+	const int remaining = std::max(1, static_cast<int>(static_cast<int64_t>(elapsed) * (1000 - pace) / pace));
+	const int postponement = std::min<int>(CeilDiv(remaining, interval), max_delay / interval);
+	return std::max(postponement, 1) * interval;
+}
+
+/**
+ * Estimate by how many days the join of an overdue job has to be postponed.
+ * @param job The overdue job.
+ * @return Number of days, a multiple of the recalculation interval.
+ * @see GetLinkGraphJoinPostponement
+ */
+static TimerGameEconomy::Date GetJoinPostponement(const LinkGraphJob &job)
+{
+	const int interval = _settings_game.linkgraph.recalc_interval / EconomyTime::SECONDS_PER_DAY;
+	const int duration = job.Settings().recalc_time / EconomyTime::SECONDS_PER_DAY;
+	const int delay = job.JoinDelay().base();
+	return GetLinkGraphJoinPostponement(duration + delay, job.Progress(), interval, duration - delay);
+}
+
 /**
  * Pause the game if in 2 TimerGameEconomy::date_fract ticks, we would do a join with the next
  * link graph job, but it is still running.
  * The check is done 2 TimerGameEconomy::date_fract ticks early instead of 1, as in multiplayer
  * calls to DoCommandP are executed after a delay of 1 TimerGameEconomy::date_fract tick.
  * If we previously paused, unpause if the job is now ready to be joined with.
+ *
+ * If overdue jobs may be postponed, the server instead postpones the join by
+ * the time it expects the job still needs, up to its original duration. Only
+ * the server looks at the progress of its job; the clients just execute the
+ * command, so they all postpone the join by the same number of days.
  */
 void StateGameLoop_LinkGraphPauseControl()
 {
@@ -182,7 +228,14 @@ void StateGameLoop_LinkGraphPauseControl()
 			LinkGraphSchedule::instance.IsJoinWithUnfinishedJobDue()) {
 		/* Perform check two TimerGameEconomy::date_fract ticks before we would join, to make
 		 * sure it also works in multiplayer. */
-		Command<CMD_PAUSE>::Post(PM_PAUSED_LINK_GRAPH, true);
+		const LinkGraphJob *job = LinkGraphSchedule::instance.GetNextJob();
+		if (_settings_game.linkgraph.postpone_overdue_jobs && job->JoinDelay() < job->Settings().recalc_time / EconomyTime::SECONDS_PER_DAY) {
+			if (!_networking || _network_server) {
+				Command<CMD_POSTPONE_LINK_GRAPH_JOB>::Post(job->index, GetJoinPostponement(*job).base());
+			}
+		} else {
+			Command<CMD_PAUSE>::Post(PM_PAUSED_LINK_GRAPH, true);
+		}
 	}
 }
 
@@ -60,6 +60,12 @@ public:
 	void SpawnAll();
 	void ShiftDates(TimerGameEconomy::Date interval);
 
+	/**
+	 * Get the job that is to be joined next.
+	 * @return The job, or nullptr if no job is running.
+	 */
+	const LinkGraphJob *GetNextJob() const { return this->running.empty() ? nullptr : this->running.front(); }
+
 	/**
 	 * Queue a link graph for execution.
 	 * @param lg Link graph to be queued.
@@ -77,6 +83,7 @@ public:
 	void Unqueue(LinkGraph *lg) { this->schedule.remove(lg); }
 };
 
+int GetLinkGraphJoinPostponement(int elapsed, uint progress, int interval, int max_delay);
 void StateGameLoop_LinkGraphPauseControl();
 void AfterLoad_LinkGraphPauseControl();
 
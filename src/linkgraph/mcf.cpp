@@ -3,12 +3,21 @@
 #include "../stdafx.h"
 #include "../core/math_func.hpp"
 #include "../timer/timer_game_tick.h"
+#include "../thread.h"
 #include "mcf.h"
 
 #include "../safeguards.h"
 
 typedef std::map<NodeID, Path *> PathViaMap;
 
+/**
+ * Number of sources whose paths are calculated against the same state of the
+ * flows. This must not depend on the number of threads, or clients with
+ * different settings would calculate different flows.
+ */
+static const NodeID MCF_SOURCES_PER_BATCH = 8;
+static const NodeID MIN_NODES_FOR_PARALLEL_DIJKSTRA = 64; ///< Minimum size of a component worth running Dijkstra concurrently for.
+
 /**
  * Distance-based annotation for use in the Dijkstra algorithm. This is close
  * to the original meaning of "annotation" in this context. Paths are rated
@@ -259,10 +268,13 @@ void MultiCommodityFlow::Dijkstra(NodeID source_node, PathVector &paths)
 	typedef std::set<Tannotation *, typename Tannotation::Comparator> AnnoSet;
 	Tedge_iterator iter(this->job);
 	uint16_t size = this->job.Size();
+	static_assert(sizeof(Tannotation) <= PathArena::SLOT_SIZE);
 	AnnoSet annos;
+	std::vector<void *> slots(size);
+	this->job.Paths().Allocate(slots);
 	paths.resize(size, nullptr);
 	for (NodeID node = 0; node < size; ++node) {
-		Tannotation *anno = new Tannotation(node, node == source_node);
+		Tannotation *anno = new (slots[node]) Tannotation(node, node == source_node);
 		anno->UpdateAnnotation();
 		annos.insert(anno);
 		paths[node] = anno;
@@ -304,6 +316,38 @@ void MultiCommodityFlow::Dijkstra(NodeID source_node, PathVector &paths)
 	}
 }
 
+/**
+ * Run the Dijkstra algorithm for a batch of sources. The algorithm only reads
+ * the job, so the searches are run concurrently for large enough components.
+ * @tparam Tannotation Annotation to be used.
+ * @tparam Tedge_iterator Iterator to be used for getting outgoing edges.
+ * @param sources Sources to calculate the paths for.
+ */
+template<class Tannotation, class Tedge_iterator>
+void MultiCommodityFlow::Dijkstra(std::span<SourcePaths> sources)
+{
+	if (sources.empty()) return;
+	size_t min_chunk_size = this->job.Size() >= MIN_NODES_FOR_PARALLEL_DIJKSTRA ? 1 : sources.size();
+	RunInChunks(sources, min_chunk_size, [this](std::span<SourcePaths> chunk) {
+		for (SourcePaths &source : chunk) this->Dijkstra<Tannotation, Tedge_iterator>(source.source, source.paths);
+	});
+}
+
+/**
+ * Collect the next batch of unfinished sources.
+ * @param first First node to consider; updated to the node after the batch.
+ * @param finished_sources Sources for which all demand has been assigned.
+ * @param batch Batch to fill.
+ */
+static void GetSourceBatch(NodeID &first, const std::vector<bool> &finished_sources, std::vector<SourcePaths> &batch)
+{
+	batch.clear();
+	NodeID last = std::min<NodeID>(first + MCF_SOURCES_PER_BATCH, static_cast<NodeID>(finished_sources.size()));
+	for (; first < last; ++first) {
+		if (!finished_sources[first]) batch.push_back({first, {}});
+	}
+}
+
 /**
  * Clean up paths that lead nowhere and the root path.
  * @param source_id ID of the root node.
@@ -322,12 +366,12 @@ void MultiCommodityFlow::CleanupPaths(NodeID source_id, PathVector &paths)
 			path->Detach();
 			if (path->GetNumChildren() == 0) {
 				paths[path->GetNode()] = nullptr;
-				delete path;
+				this->job.Paths().Free(path);
 			}
 			path = parent;
 		}
 	}
-	delete source;
+	this->job.Paths().Free(source);
 	paths.clear();
 }
 
@@ -498,7 +542,7 @@ bool MCF1stPass::EliminateCycles()
  */
 MCF1stPass::MCF1stPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 {
-	PathVector paths;
+	std::vector<SourcePaths> batch;
 	uint16_t size = job.Size();
 	uint accuracy = job.Settings().accuracy;
 	bool more_loops;
@@ -506,35 +550,39 @@ MCF1stPass::MCF1stPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 
 	do {
 		more_loops = false;
-		for (NodeID source = 0; source < size; ++source) {
-			if (finished_sources[source]) continue;
-
-			/* First saturate the shortest paths. */
-			this->Dijkstra<DistanceAnnotation, GraphEdgeIterator>(source, paths);
-
-			Node &src_node = job[source];
-			bool source_demand_left = false;
-			for (NodeID dest = 0; dest < size; ++dest) {
-				if (src_node.UnsatisfiedDemandTo(dest) > 0) {
-					Path *path = paths[dest];
-					assert(path != nullptr);
-					/* Generally only allow paths that don't exceed the
-					 * available capacity. But if no demand has been assigned
-					 * yet, make an exception and allow any valid path *once*. */
-					if (path->GetFreeCapacity() > 0 && this->PushFlow(src_node, dest, path,
-							accuracy, this->max_saturation) > 0) {
-						/* If a path has been found there is a chance we can
-						 * find more. */
-						more_loops = more_loops || (src_node.UnsatisfiedDemandTo(dest) > 0);
-					} else if (src_node.UnsatisfiedDemandTo(dest) == src_node.DemandTo(dest) &&
-							path->GetFreeCapacity() > INT_MIN) {
-						this->PushFlow(src_node, dest, path, accuracy, UINT_MAX);
+		for (NodeID first = 0; first < size;) {
+			GetSourceBatch(first, finished_sources, batch);
+
+			/* First saturate the shortest paths. The paths of the whole batch
+			 * are calculated before any flow is assigned, the flow is then
+			 * assigned in node order. */
+			this->Dijkstra<DistanceAnnotation, GraphEdgeIterator>(batch);
+
+			for (auto &[source, paths] : batch) {
+				Node &src_node = job[source];
+				bool source_demand_left = false;
+				for (NodeID dest = 0; dest < size; ++dest) {
+					if (src_node.UnsatisfiedDemandTo(dest) > 0) {
+						Path *path = paths[dest];
+						assert(path != nullptr);
+						/* Generally only allow paths that don't exceed the
+						 * available capacity. But if no demand has been assigned
+						 * yet, make an exception and allow any valid path *once*. */
+						if (path->GetFreeCapacity() > 0 && this->PushFlow(src_node, dest, path,
+								accuracy, this->max_saturation) > 0) {
+							/* If a path has been found there is a chance we can
+							 * find more. */
+							more_loops = more_loops || (src_node.UnsatisfiedDemandTo(dest) > 0);
+						} else if (src_node.UnsatisfiedDemandTo(dest) == src_node.DemandTo(dest) &&
+								path->GetFreeCapacity() > INT_MIN) {
+							this->PushFlow(src_node, dest, path, accuracy, UINT_MAX);
+						}
+						if (src_node.UnsatisfiedDemandTo(dest) > 0) source_demand_left = true;
 					}
-					if (src_node.UnsatisfiedDemandTo(dest) > 0) source_demand_left = true;
 				}
+				finished_sources[source] = !source_demand_left;
+				this->CleanupPaths(source, paths);
 			}
-			finished_sources[source] = !source_demand_left;
-			this->CleanupPaths(source, paths);
 		}
 	} while ((more_loops || this->EliminateCycles()) && !job.IsJobAborted());
 }
@@ -547,32 +595,33 @@ MCF1stPass::MCF1stPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 MCF2ndPass::MCF2ndPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 {
 	this->max_saturation = UINT_MAX; // disable artificial cap on saturation
-	PathVector paths;
+	std::vector<SourcePaths> batch;
 	uint16_t size = job.Size();
 	uint accuracy = job.Settings().accuracy;
 	bool demand_left = true;
 	std::vector<bool> finished_sources(size);
 	while (demand_left && !job.IsJobAborted()) {
 		demand_left = false;
-		for (NodeID source = 0; source < size; ++source) {
-			if (finished_sources[source]) continue;
-
-			this->Dijkstra<CapacityAnnotation, FlowEdgeIterator>(source, paths);
-
-			Node &src_node = job[source];
-			bool source_demand_left = false;
-			for (NodeID dest = 0; dest < size; ++dest) {
-				Path *path = paths[dest];
-				if (src_node.UnsatisfiedDemandTo(dest) > 0 && path->GetFreeCapacity() > INT_MIN) {
-					this->PushFlow(src_node, dest, path, accuracy, UINT_MAX);
-					if (src_node.UnsatisfiedDemandTo(dest) > 0) {
-						demand_left = true;
-						source_demand_left = true;
+		for (NodeID first = 0; first < size;) {
+			GetSourceBatch(first, finished_sources, batch);
+			this->Dijkstra<CapacityAnnotation, FlowEdgeIterator>(batch);
+
+			for (auto &[source, paths] : batch) {
+				Node &src_node = job[source];
+				bool source_demand_left = false;
+				for (NodeID dest = 0; dest < size; ++dest) {
+					Path *path = paths[dest];
+					if (src_node.UnsatisfiedDemandTo(dest) > 0 && path->GetFreeCapacity() > INT_MIN) {
+						this->PushFlow(src_node, dest, path, accuracy, UINT_MAX);
+						if (src_node.UnsatisfiedDemandTo(dest) > 0) {
+							demand_left = true;
+							source_demand_left = true;
+						}
 					}
 				}
+				finished_sources[source] = !source_demand_left;
+				this->CleanupPaths(source, paths);
 			}
-			finished_sources[source] = !source_demand_left;
-			this->CleanupPaths(source, paths);
 		}
 	}
 }
@@ -7,6 +7,12 @@
 
 typedef std::vector<Path *> PathVector;
 
+/** Path tree calculated for one source node by the Dijkstra algorithm. */
+struct SourcePaths {
+	NodeID source;    ///< Root of the path tree.
+	PathVector paths; ///< Paths from the source, indexed by destination node.
+};
+
 /**
  * Multi-commodity flow calculating base class.
  */
@@ -23,6 +29,9 @@ protected:
 	template<class Tannotation, class Tedge_iterator>
 	void Dijkstra(NodeID from, PathVector &paths);
 
+	template<class Tannotation, class Tedge_iterator>
+	void Dijkstra(std::span<SourcePaths> sources);
+
 	uint PushFlow(Node &node, NodeID to, Path *path, uint accuracy, uint max_saturation);
 
 	void CleanupPaths(NodeID source, PathVector &paths);
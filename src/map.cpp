@@ -11,9 +11,13 @@
 #include "debug.h"
 #include "core/alloc_func.hpp"
 #include "water_map.h"
+#include "water.h"
 #include "error_func.h"
 #include "string_func.h"
 #include "pathfinder/water_regions.h"
+#include "pathfinder/rail_regions.h"
+#include "pathfinder/road_regions.h"
+#include "landscape.h"
 
 #include "safeguards.h"
 
@@ -24,8 +28,16 @@
 /* static */ uint Map::size;      ///< The number of tiles on the map
 /* static */ uint Map::tile_mask; ///< _map_size - 1 (to mask the mapsize)
 
+#if defined(WITH_MERGED_TILE_STORAGE)
+/* static */ Tile::TileCombined *Tile::combined_tiles = nullptr; ///< Combined base and extended tiles of the map
+#else
 /* static */ Tile::TileBase *Tile::base_tiles = nullptr;         ///< Base tiles of the map
 /* static */ Tile::TileExtended *Tile::extended_tiles = nullptr; ///< Extended tiles of the map
+#endif
+#if defined(WITH_TILE_LAYOUT_BLOCKED) || defined(WITH_TILE_LAYOUT_MORTON)
+/* static */ uint Tile::storage_log_x;   ///< Copy of Map::log_x for the storage index
+/* static */ uint Tile::storage_log_min; ///< Logarithm of the shortest side of the map
+#endif
 
 
 /**
@@ -52,14 +64,29 @@
 	Map::size_y = size_y;
 	Map::size = size_x * size_y;
 	Map::tile_mask = Map::size - 1;
+#if defined(WITH_TILE_LAYOUT_BLOCKED) || defined(WITH_TILE_LAYOUT_MORTON)
+	Tile::storage_log_x = Map::log_x;
+	Tile::storage_log_min = std::min(Map::log_x, Map::log_y);
+#endif
 
+#if defined(WITH_MERGED_TILE_STORAGE)
+	free(Tile::combined_tiles);
+
+	Tile::combined_tiles = CallocT<Tile::TileCombined>(Map::size);
+#else
 	free(Tile::base_tiles);
 	free(Tile::extended_tiles);
 
 	Tile::base_tiles = CallocT<Tile::TileBase>(Map::size);
 	Tile::extended_tiles = CallocT<Tile::TileExtended>(Map::size);
+#endif
 
 	AllocateWaterRegions();
+	AllocateRoadRegions();
+	AllocateRailRegions();
+	AllocateTileLoopRegions();
+	AllocateFloodInterior();
+	InvalidateSignalBlocks();
 }
 
 
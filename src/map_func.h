@@ -51,11 +51,105 @@ private:
 		uint16_t m8; ///< General purpose
 	};
 
+#if defined(WITH_MERGED_TILE_STORAGE)
+	/**
+	 * The base and extended data of a tile stored next to each other, so
+	 * code that needs both only touches a single cache line.
+	 */
+	struct TileCombined {
+		TileBase base;         ///< The base data of the tile.
+		TileExtended extended; ///< The extended data of the tile.
+	};
+
+	static_assert(sizeof(TileCombined) == 12);
+
+	static TileCombined *combined_tiles; ///< Pointer to the combined tile-array.
+#else
 	static TileBase *base_tiles;         ///< Pointer to the tile-array.
 	static TileExtended *extended_tiles; ///< Pointer to the extended tile-array.
+#endif
+#if defined(WITH_TILE_LAYOUT_BLOCKED) || defined(WITH_TILE_LAYOUT_MORTON)
+	static uint storage_log_x;           ///< Copy of Map::LogX() for the storage index calculation.
+	static uint storage_log_min;         ///< Logarithm of the shortest side of the map.
+#endif
 
 	TileIndex tile; ///< The tile to access the map data for.
 
+#if defined(WITH_TILE_LAYOUT_MORTON)
+	/**
+	 * Spread the lower 16 bits of a value so there is a zero bit between each of them.
+	 * @param v The value to spread.
+	 * @return The spread value.
+	 */
+	debug_inline static constexpr uint32_t SpreadBits(uint32_t v)
+	{
+		v &= 0x0000FFFF;
+		v = (v | (v << 8)) & 0x00FF00FF;
+		v = (v | (v << 4)) & 0x0F0F0F0F;
+		v = (v | (v << 2)) & 0x33333333;
+		v = (v | (v << 1)) & 0x55555555;
+		return v;
+	}
+#endif
+
+	/**
+	 * Get the index into the tile arrays for the given tile.
+	 * The TileIndex itself is always row-major, so tile differences and the
+	 * TileXY/TileX/TileY functions behave the same for every layout; only the
+	 * place where the data of a tile is stored changes.
+	 * With the blocked layout the map is stored as a row-major grid of
+	 * (1 << TILE_LAYOUT_BLOCK_BITS) square blocks, each of which is stored
+	 * row-major itself. With the Morton layout the coordinates of the tile are
+	 * bit-interleaved (Z-order) up to the size of the shortest side of the
+	 * map, the remainder of the longest side makes up the upper bits.
+	 * @return The index into the tile arrays.
+	 */
+	debug_inline uint StorageIndex() const
+	{
+#if defined(WITH_TILE_LAYOUT_BLOCKED)
+		const uint x = tile.base() & ((1U << storage_log_x) - 1);
+		const uint y = tile.base() >> storage_log_x;
+		const uint block_mask = (1U << TILE_LAYOUT_BLOCK_BITS) - 1;
+		const uint block = ((y >> TILE_LAYOUT_BLOCK_BITS) << (storage_log_x - TILE_LAYOUT_BLOCK_BITS)) + (x >> TILE_LAYOUT_BLOCK_BITS);
+		return (block << (2 * TILE_LAYOUT_BLOCK_BITS)) | ((y & block_mask) << TILE_LAYOUT_BLOCK_BITS) | (x & block_mask);
+#elif defined(WITH_TILE_LAYOUT_MORTON)
+		const uint x = tile.base() & ((1U << storage_log_x) - 1);
+		const uint y = tile.base() >> storage_log_x;
+		const uint low_mask = (1U << storage_log_min) - 1;
+		/* Only one of the axes can have bits above the shortest side. */
+		const uint high = (x >> storage_log_min) | (y >> storage_log_min);
+		return (high << (2 * storage_log_min)) | SpreadBits(x & low_mask) | (SpreadBits(y & low_mask) << 1);
+#else
+		return tile.base();
+#endif
+	}
+
+	/**
+	 * Get the base data of this tile.
+	 * @return Reference to the base data.
+	 */
+	debug_inline TileBase &Base()
+	{
+#if defined(WITH_MERGED_TILE_STORAGE)
+		return combined_tiles[this->StorageIndex()].base;
+#else
+		return base_tiles[this->StorageIndex()];
+#endif
+	}
+
+	/**
+	 * Get the extended data of this tile.
+	 * @return Reference to the extended data.
+	 */
+	debug_inline TileExtended &Extended()
+	{
+#if defined(WITH_MERGED_TILE_STORAGE)
+		return combined_tiles[this->StorageIndex()].extended;
+#else
+		return extended_tiles[this->StorageIndex()];
+#endif
+	}
+
 public:
 	/**
 	 * Create the tile wrapper for the given tile.
@@ -88,7 +182,7 @@ public:
 	 */
 	debug_inline uint8_t &type()
 	{
-		return base_tiles[tile.base()].type;
+		return this->Base().type;
 	}
 
 	/**
@@ -100,7 +194,7 @@ public:
 	 */
 	debug_inline uint8_t &height()
 	{
-		return base_tiles[tile.base()].height;
+		return this->Base().height;
 	}
 
 	/**
@@ -112,7 +206,7 @@ public:
 	 */
 	debug_inline uint8_t &m1()
 	{
-		return base_tiles[tile.base()].m1;
+		return this->Base().m1;
 	}
 
 	/**
@@ -124,7 +218,7 @@ public:
 	 */
 	debug_inline uint16_t &m2()
 	{
-		return base_tiles[tile.base()].m2;
+		return this->Base().m2;
 	}
 
 	/**
@@ -136,7 +230,7 @@ public:
 	 */
 	debug_inline uint8_t &m3()
 	{
-		return base_tiles[tile.base()].m3;
+		return this->Base().m3;
 	}
 
 	/**
@@ -148,7 +242,7 @@ public:
 	 */
 	debug_inline uint8_t &m4()
 	{
-		return base_tiles[tile.base()].m4;
+		return this->Base().m4;
 	}
 
 	/**
@@ -160,7 +254,7 @@ public:
 	 */
 	debug_inline uint8_t &m5()
 	{
-		return base_tiles[tile.base()].m5;
+		return this->Base().m5;
 	}
 
 	/**
@@ -172,7 +266,7 @@ public:
 	 */
 	debug_inline uint8_t &m6()
 	{
-		return extended_tiles[tile.base()].m6;
+		return this->Extended().m6;
 	}
 
 	/**
@@ -184,7 +278,7 @@ public:
 	 */
 	debug_inline uint8_t &m7()
 	{
-		return extended_tiles[tile.base()].m7;
+		return this->Extended().m7;
 	}
 
 	/**
@@ -196,7 +290,7 @@ public:
 	 */
 	debug_inline uint16_t &m8()
 	{
-		return extended_tiles[tile.base()].m8;
+		return this->Extended().m8;
 	}
 };
 
@@ -290,6 +384,15 @@ public:
 		return Map::size;
 	}
 
+	/**
+	 * Get the memory used by the tile arrays.
+	 * @return the number of bytes allocated for the tiles of the map
+	 */
+	static inline size_t MemoryUsage()
+	{
+		return (size_t)Map::Size() * (sizeof(Tile::TileBase) + sizeof(Tile::TileExtended));
+	}
+
 	/**
 	 * Gets the maximum X coordinate within the map, including MP_VOID
 	 * @return the maximum X coordinate
@@ -353,7 +456,11 @@ public:
 	 */
 	static bool IsInitialized()
 	{
+#if defined(WITH_MERGED_TILE_STORAGE)
+		return Tile::combined_tiles != nullptr;
+#else
 		return Tile::base_tiles != nullptr;
+#endif
 	}
 
 	/**
@@ -35,9 +35,11 @@ struct TileIndexDiffC {
 
 /** Minimal and maximal map width and height */
 static const uint MIN_MAP_SIZE_BITS = 6;                       ///< Minimal size of map is equal to 2 ^ MIN_MAP_SIZE_BITS
-static const uint MAX_MAP_SIZE_BITS = 12;                      ///< Maximal size of map is equal to 2 ^ MAX_MAP_SIZE_BITS
+static const uint MAX_MAP_SIZE_BITS = 13;                      ///< Maximal size of map is equal to 2 ^ MAX_MAP_SIZE_BITS
 static const uint MIN_MAP_SIZE      = 1U << MIN_MAP_SIZE_BITS; ///< Minimal map size = 64
-static const uint MAX_MAP_SIZE      = 1U << MAX_MAP_SIZE_BITS; ///< Maximal map size = 4096
+static const uint MAX_MAP_SIZE      = 1U << MAX_MAP_SIZE_BITS; ///< Maximal map size = 8192
+static const uint TILE_LAYOUT_BLOCK_BITS = 6;                  ///< Side of a block of the blocked tile layout is 2 ^ TILE_LAYOUT_BLOCK_BITS
+static_assert(TILE_LAYOUT_BLOCK_BITS <= MIN_MAP_SIZE_BITS);
 
 /**
  * Approximation of the length of a straight track, relative to a diagonal
@@ -31,6 +31,7 @@
 #include "station_kdtree.h"
 #include "town_kdtree.h"
 #include "viewport_kdtree.h"
+#include "viewport_func.h"
 #include "newgrf_profiling.h"
 #include "3rdparty/monocypher/monocypher.h"
 
@@ -125,8 +126,11 @@ void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settin
 	PoolBase::Clean(PT_NORMAL);
 
 	RebuildStationKdtree();
+	ResetStationCatchmentIndex();
 	RebuildTownKdtree();
+	RebuildTownGrowthSchedule();
 	RebuildViewportKdtree();
+	ClearViewportTileCache();
 
 	ResetPersistentNewGRFData();
 
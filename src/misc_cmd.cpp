@@ -22,6 +22,7 @@
 #include "texteff.hpp"
 #include "core/backup_type.hpp"
 #include "misc_cmd.h"
+#include "linkgraph/linkgraphjob.h"
 
 #include "table/strings.h"
 
@@ -254,3 +255,22 @@ CommandCost CmdChangeBankBalance(DoCommandFlag flags, TileIndex tile, Money delt
 	CommandCost zero_cost(expenses_type, (Money)0);
 	return zero_cost;
 }
+
+/**
+ * Postpone the join of a link graph job that is not finished by its join date (server-only).
+ * The server decides this based on the progress of its own job, so every
+ * client postpones the join by the same number of days.
+ * @param flags operation to perform
+ * @param job the job to postpone the join of
+ * @param days number of days to postpone the join by
+ * @return the cost of this operation or an error
+ */
+CommandCost CmdPostponeLinkGraphJob(DoCommandFlag flags, LinkGraphJobID job, int32_t days)
+{
+	if (!LinkGraphJob::IsValidID(job) || days <= 0) return CMD_ERROR;
+
+	if (flags & DC_EXEC) {
+		LinkGraphJob::Get(job)->PostponeJoin(days);
+	}
+	return CommandCost();
+}
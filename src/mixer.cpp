@@ -15,11 +15,20 @@
 #include "mixer.h"
 #include "settings_type.h"
 
+/* SSE2 is only used when general sources may use it, i.e. not for 32 bits x86 builds without it. */
+#if defined(WITH_SSE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#	include <emmintrin.h>
+#	define MIXER_SSE2
+#elif defined(WITH_NEON)
+#	include <arm_neon.h>
+#	define MIXER_NEON
+#endif
+
 #include "safeguards.h"
 
 struct MixerChannel {
-	/* pointer to allocated buffer memory */
-	int8_t *memory;
+	/* sample data, shared with the sound it belongs to */
+	std::shared_ptr<std::vector<int8_t>> memory;
 
 	/* current position in memory */
 	uint32_t pos;
@@ -30,6 +39,7 @@ struct MixerChannel {
 	/* Mixing volume */
 	int volume_left;
 	int volume_right;
+	uint volume; ///< Volume before panning, to decide which sound to stop when all channels are busy.
 
 	bool is16bit;
 };
@@ -64,44 +74,113 @@ static int RateConversion(T *b, int frac_pos)
 	return ((b[0] * ((1 << 16) - frac_pos)) + (b[1] * frac_pos)) >> 16;
 }
 
+/** Number of samples that are resampled at once before they are mixed. */
+static const uint MIX_BLOCK_SIZE = 256;
+
+/**
+ * Mix a block of mono samples into the stereo output buffer.
+ * The samples are scaled to 16 bits, multiplied by the volume of each
+ * side and then added to the output, clamped to #MAX_VOLUME.
+ * @param buffer       The stereo output buffer.
+ * @param b            The samples to mix.
+ * @param samples      Number of samples to mix.
+ * @param volume_left  Volume of the left side, at most INT16_MAX.
+ * @param volume_right Volume of the right side, at most INT16_MAX.
+ * @tparam T the size of the samples (8 or 16 bits)
+ */
 template <typename T>
-static void mix_int16(MixerChannel *sc, int16_t *buffer, uint samples, uint8_t effect_vol)
+static void MixBlock(int16_t *buffer, const T *b, uint samples, int volume_left, int volume_right)
 {
 	/* Shift required to get sample value into range for the data type. */
 	const uint SHIFT = sizeof(T) * CHAR_BIT;
 
+#if defined(MIXER_SSE2)
+	/* (sample << (16 - SHIFT)) * volume >> 16 is exactly what the scalar code below calculates. */
+	const __m128i volume = _mm_set_epi16(volume_right, volume_left, volume_right, volume_left, volume_right, volume_left, volume_right, volume_left);
+	const __m128i min = _mm_set1_epi16(-MAX_VOLUME);
+	for (; samples >= 8; samples -= 8) {
+		__m128i data;
+		if constexpr (sizeof(T) == 1) {
+			data = _mm_unpacklo_epi8(_mm_setzero_si128(), _mm_loadl_epi64((const __m128i *)b));
+		} else {
+			data = _mm_loadu_si128((const __m128i *)b);
+		}
+		/* Saturating at -32768 and then taking the maximum with -MAX_VOLUME clamps like the scalar code. */
+		__m128i lo = _mm_mulhi_epi16(_mm_unpacklo_epi16(data, data), volume);
+		__m128i hi = _mm_mulhi_epi16(_mm_unpackhi_epi16(data, data), volume);
+		_mm_storeu_si128((__m128i *)buffer, _mm_max_epi16(_mm_adds_epi16(_mm_loadu_si128((const __m128i *)buffer), lo), min));
+		_mm_storeu_si128((__m128i *)(buffer + 8), _mm_max_epi16(_mm_adds_epi16(_mm_loadu_si128((const __m128i *)(buffer + 8)), hi), min));
+		b += 8;
+		buffer += 16;
+	}
+#elif defined(MIXER_NEON)
+	const int16_t volumes[8] = { (int16_t)volume_left, (int16_t)volume_right, (int16_t)volume_left, (int16_t)volume_right, (int16_t)volume_left, (int16_t)volume_right, (int16_t)volume_left, (int16_t)volume_right };
+	const int16x8_t volume = vld1q_s16(volumes);
+	const int16x8_t min = vdupq_n_s16(-MAX_VOLUME);
+	auto mulhi = [&volume](int16x8_t data) {
+		return vcombine_s16(vshrn_n_s32(vmull_s16(vget_low_s16(data), vget_low_s16(volume)), 16), vshrn_n_s32(vmull_s16(vget_high_s16(data), vget_high_s16(volume)), 16));
+	};
+	for (; samples >= 8; samples -= 8) {
+		int16x8_t data;
+		if constexpr (sizeof(T) == 1) {
+			data = vshll_n_s8(vld1_s8((const int8_t *)b), 8);
+		} else {
+			data = vld1q_s16((const int16_t *)b);
+		}
+		int16x8x2_t stereo = vzipq_s16(data, data);
+		vst1q_s16(buffer, vmaxq_s16(vqaddq_s16(vld1q_s16(buffer), mulhi(stereo.val[0])), min));
+		vst1q_s16(buffer + 8, vmaxq_s16(vqaddq_s16(vld1q_s16(buffer + 8), mulhi(stereo.val[1])), min));
+		b += 8;
+		buffer += 16;
+	}
+#endif
+
+	for (; samples > 0; samples--) {
+		buffer[0] = Clamp(buffer[0] + (*b * volume_left  >> SHIFT), -MAX_VOLUME, MAX_VOLUME);
+		buffer[1] = Clamp(buffer[1] + (*b * volume_right >> SHIFT), -MAX_VOLUME, MAX_VOLUME);
+		b++;
+		buffer += 2;
+	}
+}
+
+template <typename T>
+static void mix_int16(MixerChannel *sc, int16_t *buffer, uint samples, uint8_t effect_vol)
+{
 	if (samples > sc->samples_left) samples = sc->samples_left;
 	sc->samples_left -= samples;
 	assert(samples > 0);
 
-	const T *b = (const T *)sc->memory + sc->pos;
+	const T *b = (const T *)sc->memory->data() + sc->pos;
 	uint32_t frac_pos = sc->frac_pos;
 	uint32_t frac_speed = sc->frac_speed;
 	int volume_left = sc->volume_left * effect_vol / 255;
 	int volume_right = sc->volume_right * effect_vol / 255;
+	assert(volume_left <= INT16_MAX && volume_right <= INT16_MAX);
 
 	if (frac_speed == 0x10000) {
 		/* Special case when frac_speed is 0x10000 */
-		do {
-			buffer[0] = Clamp(buffer[0] + (*b * volume_left  >> SHIFT), -MAX_VOLUME, MAX_VOLUME);
-			buffer[1] = Clamp(buffer[1] + (*b * volume_right >> SHIFT), -MAX_VOLUME, MAX_VOLUME);
-			b++;
-			buffer += 2;
-		} while (--samples > 0);
+		MixBlock(buffer, b, samples, volume_left, volume_right);
+		b += samples;
 	} else {
+		/* Resample a block into 16 bit samples, so mixing it does not depend on the rate. */
+		const uint SHIFT = 16 - sizeof(T) * CHAR_BIT;
+		int16_t block[MIX_BLOCK_SIZE];
 		do {
-			int data = RateConversion(b, frac_pos);
-			buffer[0] = Clamp(buffer[0] + (data * volume_left  >> SHIFT), -MAX_VOLUME, MAX_VOLUME);
-			buffer[1] = Clamp(buffer[1] + (data * volume_right >> SHIFT), -MAX_VOLUME, MAX_VOLUME);
-			buffer += 2;
-			frac_pos += frac_speed;
-			b += frac_pos >> 16;
-			frac_pos &= 0xffff;
-		} while (--samples > 0);
+			uint count = std::min(samples, MIX_BLOCK_SIZE);
+			for (uint i = 0; i < count; i++) {
+				block[i] = RateConversion(b, frac_pos) * (1 << SHIFT);
+				frac_pos += frac_speed;
+				b += frac_pos >> 16;
+				frac_pos &= 0xffff;
+			}
+			MixBlock(buffer, block, count, volume_left, volume_right);
+			buffer += 2 * count;
+			samples -= count;
+		} while (samples > 0);
 	}
 
 	sc->frac_pos = frac_pos;
-	sc->pos = b - (const T *)sc->memory;
+	sc->pos = b - (const T *)sc->memory->data();
 }
 
 static void MxCloseChannel(uint8_t channel_index)
@@ -174,12 +253,11 @@ MixerChannel *MxAllocateChannel()
 	uint8_t channel_index = FindFirstBit(available);
 
 	MixerChannel *mc = &_channels[channel_index];
-	free(mc->memory);
-	mc->memory = nullptr;
+	mc->memory.reset();
 	return mc;
 }
 
-void MxSetChannelRawSrc(MixerChannel *mc, int8_t *mem, size_t size, uint rate, bool is16bit)
+void MxSetChannelRawSrc(MixerChannel *mc, const std::shared_ptr<std::vector<int8_t>> &mem, size_t size, uint rate, bool is16bit)
 {
 	mc->memory = mem;
 	mc->frac_pos = 0;
@@ -211,6 +289,28 @@ void MxSetChannelVolume(MixerChannel *mc, uint volume, float pan)
 	 * of position. */
 	mc->volume_left = (uint)(sin((1.0 - pan) * M_PI / 2.0) * volume);
 	mc->volume_right = (uint)(sin(pan * M_PI / 2.0) * volume);
+	mc->volume = volume;
+}
+
+/**
+ * Make room for a sound when all channels are busy, by stopping the
+ * quietest playing sound when it is quieter than the new sound. Sounds
+ * further away in the viewport are played at a lower volume, so nearby
+ * sounds take precedence. The channel becomes available once the mixer
+ * has processed the stop request.
+ * @param volume Volume of the sound that could not be played, as for #MxSetChannelVolume.
+ */
+void MxStopQuieterChannel(uint volume)
+{
+	uint8_t active = _active_channels.load(std::memory_order_acquire) & ~_stop_channels.load(std::memory_order_acquire);
+	if (active != UINT8_MAX) return;
+
+	MixerChannel *quietest = nullptr;
+	for (uint8_t idx : SetBitIterator(active)) {
+		MixerChannel *mc = &_channels[idx];
+		if (mc->volume < volume && (quietest == nullptr || mc->volume < quietest->volume)) quietest = mc;
+	}
+	if (quietest != nullptr) _stop_channels.fetch_or(1 << (quietest - _channels), std::memory_order_release);
 }
 
 
@@ -99,20 +99,9 @@ template <class Tbase_set>
 {
 	if (BaseMedia<Tbase_set>::used_set != nullptr) return true;
 
-	const Tbase_set *best = nullptr;
-	for (const Tbase_set *c = BaseMedia<Tbase_set>::available_sets; c != nullptr; c = c->next) {
-		if (c->GetNumMissing() != 0) continue;
-
-		if (best == nullptr ||
-				(best->fallback && !c->fallback) ||
-				best->valid_files < c->valid_files ||
-				(best->valid_files == c->valid_files &&
-					(best->shortname == c->shortname && best->version < c->version))) {
-			best = c;
-		}
-	}
-
-	BaseMedia<Tbase_set>::used_set = best;
+	BaseMedia<Tbase_set>::used_set = BaseMedia<Tbase_set>::FindBestSet([](const Tbase_set *best, const Tbase_set *c) {
+		return best->shortname == c->shortname && best->version < c->version;
+	});
 	return BaseMedia<Tbase_set>::used_set != nullptr;
 }
 
@@ -1224,6 +1224,11 @@ void MusicDriver_DMusic::PlaySong(const MusicSongInfo &song)
 }
 
 
+void MusicDriver_DMusic::PrepareSong(const MusicSongInfo &song)
+{
+	MidiFile::PrepareSong(song, false);
+}
+
 void MusicDriver_DMusic::StopSong()
 {
 	_playback.do_stop = true;
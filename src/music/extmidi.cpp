@@ -80,6 +80,11 @@ void MusicDriver_ExtMidi::PlaySong(const MusicSongInfo &song)
 	}
 }
 
+void MusicDriver_ExtMidi::PrepareSong(const MusicSongInfo &song)
+{
+	MidiFile::PrepareSong(song, true);
+}
+
 void MusicDriver_ExtMidi::StopSong()
 {
 	this->song.clear();
@@ -28,6 +28,8 @@ public:
 
 	void PlaySong(const MusicSongInfo &song) override;
 
+	void PrepareSong(const MusicSongInfo &song) override;
+
 	void StopSong() override;
 
 	bool IsSongPlaying() override;
@@ -161,6 +161,11 @@ void MusicDriver_FluidSynth::PlaySong(const MusicSongInfo &song)
 	}
 }
 
+void MusicDriver_FluidSynth::PrepareSong(const MusicSongInfo &song)
+{
+	MidiFile::PrepareSong(song, true);
+}
+
 void MusicDriver_FluidSynth::StopSong()
 {
 	std::lock_guard<std::mutex> lock{ _midi.synth_mutex };
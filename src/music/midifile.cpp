@@ -14,6 +14,7 @@
 #include "../core/endian_func.hpp"
 #include "../core/mem_func.hpp"
 #include "../base_media_base.h"
+#include "../task_pool.h"
 #include "midi.h"
 
 #include "../console_func.h"
@@ -447,8 +448,6 @@ bool MidiFile::ReadSMFHeader(FILE *file, SMFHeader &header)
  */
 bool MidiFile::LoadFile(const std::string &filename)
 {
-	_midifile_instance = this;
-
 	this->blocks.clear();
 	this->tempos.clear();
 	this->tickdiv = 0;
@@ -830,23 +829,27 @@ const uint8_t MpsMachine::programvelocities[128] = {
  */
 bool MidiFile::LoadMpsData(const uint8_t *data, size_t length)
 {
-	_midifile_instance = this;
-
 	MpsMachine machine(data, length, *this);
 	return machine.PlayInto() && FixupMidiData(*this);
 }
 
-bool MidiFile::LoadSong(const MusicSongInfo &song)
+/**
+ * Parse a song of any supported format.
+ * @param song The song to parse.
+ * @param target Where to put the song.
+ * @return true if the song was parsed successfully.
+ */
+static bool ParseSong(const MusicSongInfo &song, MidiFile &target)
 {
 	switch (song.filetype) {
 		case MTT_STANDARDMIDI:
-			return this->LoadFile(song.filename);
+			return target.LoadFile(song.filename);
 		case MTT_MPSMIDI:
 		{
 			size_t songdatalen = 0;
 			uint8_t *songdata = GetMusicCatEntryData(song.filename, song.cat_index, songdatalen);
 			if (songdata != nullptr) {
-				bool result = this->LoadMpsData(songdata, songdatalen);
+				bool result = target.LoadMpsData(songdata, songdatalen);
 				free(songdata);
 				return result;
 			} else {
@@ -858,6 +861,90 @@ bool MidiFile::LoadSong(const MusicSongInfo &song)
 	}
 }
 
+static std::string MakeSMFFile(const MusicSongInfo &song);
+
+/** A song that has been prepared for playing, or is being prepared in the background. */
+struct PreparedSong {
+	TaskHandle task;          ///< Task preparing the song, until it has been waited for.
+	bool as_smf_file;         ///< Whether the song is prepared as standard MIDI file on disk, otherwise it is parsed.
+	bool parsed = false;      ///< Whether parsing the song succeeded.
+	MidiFile data;            ///< The parsed song.
+	std::string smf_filename; ///< The standard MIDI file of the song, empty if it could not be made.
+
+	~PreparedSong()
+	{
+		if (this->task.IsValid()) this->task.Wait();
+	}
+};
+
+/** Songs that have been prepared for playing, by their file and index in it. Only the main thread uses this. */
+static std::map<std::pair<std::string, int>, std::unique_ptr<PreparedSong>> _prepared_songs;
+
+/**
+ * Prepare a song for playing in the background, so it is ready by the time it is played.
+ * Once prepared, the song is kept until #ForgetPreparedSongs is called.
+ * @param song The song to prepare.
+ * @param as_smf_file Whether the song is needed as standard MIDI file on disk (see #GetSMFFile) instead of parsed (see #LoadSong).
+ */
+/* static */ void MidiFile::PrepareSong(const MusicSongInfo &song, bool as_smf_file)
+{
+	std::unique_ptr<PreparedSong> &prepared = _prepared_songs[{ song.filename, song.cat_index }];
+	if (prepared != nullptr && prepared->as_smf_file == as_smf_file) return;
+
+	prepared = std::make_unique<PreparedSong>();
+	prepared->as_smf_file = as_smf_file;
+	prepared->task = SubmitTask(TaskCategory::Music, [p = prepared.get(), song]() {
+		if (p->as_smf_file) {
+			p->smf_filename = MakeSMFFile(song);
+		} else {
+			p->parsed = ParseSong(song, p->data);
+		}
+	});
+}
+
+/**
+ * Get a song that is prepared for playing, preparing it now when that has not been done yet.
+ * @param song The song to get.
+ * @param as_smf_file Whether the song is needed as standard MIDI file on disk instead of parsed.
+ * @return The prepared song.
+ */
+static const PreparedSong &GetPreparedSong(const MusicSongInfo &song, bool as_smf_file)
+{
+	MidiFile::PrepareSong(song, as_smf_file);
+
+	PreparedSong &prepared = *_prepared_songs[{ song.filename, song.cat_index }];
+	if (prepared.task.IsValid()) {
+		prepared.task.Wait();
+		prepared.task = {};
+	}
+	return prepared;
+}
+
+/**
+ * Forget all prepared songs, after waiting for the ones still being prepared.
+ */
+/* static */ void MidiFile::ForgetPreparedSongs()
+{
+	_prepared_songs.clear();
+}
+
+/**
+ * Load a song of any supported format, using the prepared song when there is one.
+ * @param song The song to load.
+ * @return true if the song was loaded successfully.
+ */
+bool MidiFile::LoadSong(const MusicSongInfo &song)
+{
+	const PreparedSong &prepared = GetPreparedSong(song, false);
+
+	this->blocks = prepared.data.blocks;
+	this->tempos = prepared.data.tempos;
+	this->tickdiv = prepared.data.tickdiv;
+
+	_midifile_instance = this;
+	return prepared.parsed;
+}
+
 /**
  * Move data from other to this, and clears other.
  * @param other object containing loaded data to take over
@@ -1037,6 +1124,16 @@ bool MidiFile::WriteSMF(const std::string &filename)
  * @return Full filename string, empty string if failed
  */
 std::string MidiFile::GetSMFFile(const MusicSongInfo &song)
+{
+	return GetPreparedSong(song, true).smf_filename;
+}
+
+/**
+ * Find or make the standard MIDI file of a song, see #MidiFile::GetSMFFile.
+ * @param song Song definition to query
+ * @return Full filename string, empty string if failed
+ */
+static std::string MakeSMFFile(const MusicSongInfo &song)
 {
 	if (song.filetype == MTT_STANDARDMIDI) {
 		std::string filename = FioFindFullPath(Subdirectory::BASESET_DIR, song.filename);
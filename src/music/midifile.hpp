@@ -42,6 +42,8 @@ struct MidiFile {
 
 	bool WriteSMF(const std::string &filename);
 
+	static void PrepareSong(const MusicSongInfo &song, bool as_smf_file);
+	static void ForgetPreparedSongs();
 	static std::string GetSMFFile(const MusicSongInfo &song);
 	static bool ReadSMFHeader(const std::string &filename, SMFHeader &header);
 	static bool ReadSMFHeader(FILE *file, SMFHeader &header);
@@ -23,6 +23,12 @@ public:
 	 */
 	virtual void PlaySong(const MusicSongInfo &song) = 0;
 
+	/**
+	 * Prepare a song that is going to be played soon, without blocking.
+	 * @param song The information for the song to prepare.
+	 */
+	virtual void PrepareSong([[maybe_unused]] const MusicSongInfo &song) {}
+
 	/**
 	 * Stop playing the current song.
 	 */
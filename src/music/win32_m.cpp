@@ -348,6 +348,11 @@ void MusicDriver_Win32::PlaySong(const MusicSongInfo &song)
 	}
 }
 
+void MusicDriver_Win32::PrepareSong(const MusicSongInfo &song)
+{
+	MidiFile::PrepareSong(song, false);
+}
+
 void MusicDriver_Win32::StopSong()
 {
 	Debug(driver, 2, "Win32-MIDI: StopSong: entry");
@@ -11,6 +11,7 @@
 #include "openttd.h"
 #include "base_media_base.h"
 #include "music/music_driver.hpp"
+#include "music/midifile.hpp"
 #include "window_gui.h"
 #include "strings_func.h"
 #include "window_func.h"
@@ -173,6 +174,7 @@ void MusicSystem::ChangeMusicSet(const std::string &set_name)
 {
 	BaseMusic::SetSetByName(set_name);
 	BaseMusic::ini_set = set_name;
+	MidiFile::ForgetPreparedSongs();
 
 	this->BuildPlaylists();
 	this->ChangePlaylist(this->selected_playlist);
@@ -253,6 +255,11 @@ void MusicSystem::Play()
 	if (_game_mode == GM_MENU && this->selected_playlist == PLCH_THEMEONLY) song.loop = true;
 	MusicDriver::GetInstance()->PlaySong(song);
 
+	/* Get the next song ready while this one plays. */
+	if (this->active_playlist.size() > 1) {
+		MusicDriver::GetInstance()->PrepareSong(this->active_playlist[(this->playlist_position + 1) % this->active_playlist.size()]);
+	}
+
 	InvalidateWindowData(WC_MUSIC_WINDOW, 0);
 }
 
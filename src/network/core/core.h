@@ -14,6 +14,7 @@
 
 #include "../../newgrf_config.h"
 #include "../network_crypto.h"
+#include "../network_compression.h"
 #include "config.h"
 
 bool NetworkCoreInitialize();
@@ -48,6 +49,8 @@ protected:
 	friend struct Packet;
 	std::unique_ptr<class NetworkEncryptionHandler> receive_encryption_handler; ///< The handler for decrypting received packets.
 	std::unique_ptr<class NetworkEncryptionHandler> send_encryption_handler; ///< The handler for encrypting sent packets.
+	std::unique_ptr<class NetworkCompressionHandler> receive_compression_handler; ///< The handler for decompressing received packets.
+	std::unique_ptr<class NetworkCompressionHandler> send_compression_handler; ///< The handler for compressing sent packets.
 
 public:
 	/** Create a new unbound socket */
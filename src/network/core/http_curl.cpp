@@ -59,11 +59,13 @@ public:
 	 * @param uri      the URI to connect to (https://.../..).
 	 * @param callback the callback to send data back on.
 	 * @param data     the data we want to send. When non-empty, this will be a POST request, otherwise a GET request.
+	 * @param resume_from The byte to start the data from.
 	 */
-	NetworkHTTPRequest(const std::string &uri, HTTPCallback *callback, const std::string &data) :
+	NetworkHTTPRequest(const std::string &uri, HTTPCallback *callback, const std::string &data, size_t resume_from) :
 		uri(uri),
 		callback(callback),
-		data(data)
+		data(data),
+		resume_from(resume_from)
 	{
 		std::lock_guard<std::mutex> lock(_new_http_callback_mutex);
 		_new_http_callbacks.push_back(&this->callback);
@@ -78,9 +80,14 @@ public:
 	const std::string uri; ///< URI to connect to.
 	HTTPThreadSafeCallback callback; ///< Callback to send data back on.
 	const std::string data; ///< Data to send, if any.
+	const size_t resume_from; ///< The byte to start the data from.
 };
 
-static std::thread _http_thread;
+/** Maximum number of requests handled at the same time, each by its own thread. */
+static constexpr size_t MAX_HTTP_THREADS = 8;
+
+static std::vector<std::thread> _http_threads;
+static size_t _http_idle_threads = 0; ///< Number of threads waiting for a request; protected by _http_mutex.
 static std::atomic<bool> _http_thread_exit = false;
 static std::queue<std::unique_ptr<NetworkHTTPRequest>> _http_requests;
 static std::mutex _http_mutex;
@@ -90,7 +97,9 @@ static std::string _http_ca_file = "";
 static std::string _http_ca_path = "";
 #endif /* UNIX */
 
-/* static */ void NetworkHTTPSocketHandler::Connect(const std::string &uri, HTTPCallback *callback, const std::string data)
+void HttpThread();
+
+/* static */ void NetworkHTTPSocketHandler::Connect(const std::string &uri, HTTPCallback *callback, const std::string data, size_t resume_from)
 {
 #if defined(UNIX)
 	if (_http_ca_file.empty() && _http_ca_path.empty()) {
@@ -100,7 +109,12 @@ static std::string _http_ca_path = "";
 #endif /* UNIX */
 
 	std::lock_guard<std::mutex> lock(_http_mutex);
-	_http_requests.push(std::make_unique<NetworkHTTPRequest>(uri, callback, data));
+	_http_requests.push(std::make_unique<NetworkHTTPRequest>(uri, callback, data, resume_from));
+
+	/* Start another thread when all are busy, so requests are handled at the same time. */
+	if (_http_requests.size() > _http_idle_threads && _http_threads.size() < MAX_HTTP_THREADS) {
+		if (!StartNewThread(&_http_threads.emplace_back(), "ottd:http", &HttpThread)) _http_threads.pop_back();
+	}
 	_http_cv.notify_one();
 }
 
@@ -131,9 +145,11 @@ void HttpThread()
 		std::unique_lock<std::mutex> lock(_http_mutex);
 
 		/* Wait for a new request. */
+		_http_idle_threads++;
 		while (_http_requests.empty() && !_http_thread_exit) {
 			_http_cv.wait(lock);
 		}
+		_http_idle_threads--;
 		if (_http_thread_exit) break;
 
 		std::unique_ptr<NetworkHTTPRequest> request = std::move(_http_requests.front());
@@ -187,6 +203,7 @@ void HttpThread()
 			curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
 		}
 		curl_easy_setopt(curl, CURLOPT_URL, request->uri.c_str());
+		if (request->resume_from != 0) curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE, static_cast<curl_off_t>(request->resume_from));
 
 		/* Setup our (C-style) callback function which we pipe back into the callback. */
 		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +[](char *ptr, size_t size, size_t nmemb, void *userdata) -> size_t {
@@ -270,8 +287,8 @@ void NetworkHTTPInitialize()
 	}
 #endif /* UNIX */
 
+	/* The threads are started when requests come in. */
 	_http_thread_exit = false;
-	StartNewThread(&_http_thread, "ottd:http", &HttpThread);
 }
 
 void NetworkHTTPUninitialize()
@@ -284,12 +301,13 @@ void NetworkHTTPUninitialize()
 
 	{
 		std::lock_guard<std::mutex> lock(_http_mutex);
-		_http_cv.notify_one();
+		_http_cv.notify_all();
 	}
 
-	if (_http_thread.joinable()) {
-		_http_thread.join();
+	for (std::thread &thread : _http_threads) {
+		if (thread.joinable()) thread.join();
 	}
+	_http_threads.clear();
 
 	curl_global_cleanup();
 }
@@ -30,6 +30,7 @@ private:
 	const std::wstring uri; ///< URI to connect to.
 	HTTPThreadSafeCallback callback; ///< Callback to send data back on.
 	const std::string data; ///< Data to send, if any.
+	const size_t resume_from; ///< The byte to start the data from.
 
 	HINTERNET connection = nullptr;      ///< Current connection object.
 	HINTERNET request = nullptr;         ///< Current request object.
@@ -37,7 +38,7 @@ private:
 	int depth = 0;                       ///< Current redirect depth we are in.
 
 public:
-	NetworkHTTPRequest(const std::wstring &uri, HTTPCallback *callback, const std::string &data);
+	NetworkHTTPRequest(const std::wstring &uri, HTTPCallback *callback, const std::string &data, size_t resume_from);
 
 	~NetworkHTTPRequest();
 
@@ -61,11 +62,13 @@ static std::mutex _new_http_callback_mutex;
  * @param uri      the URI to connect to (https://.../..).
  * @param callback the callback to send data back on.
  * @param data     the data we want to send. When non-empty, this will be a POST request, otherwise a GET request.
+ * @param resume_from The byte to start the data from.
  */
-NetworkHTTPRequest::NetworkHTTPRequest(const std::wstring &uri, HTTPCallback *callback, const std::string &data) :
+NetworkHTTPRequest::NetworkHTTPRequest(const std::wstring &uri, HTTPCallback *callback, const std::string &data, size_t resume_from) :
 	uri(uri),
 	callback(callback),
-	data(data)
+	data(data),
+	resume_from(resume_from)
 {
 	std::lock_guard<std::mutex> lock(_new_http_callback_mutex);
 	_new_http_callbacks.push_back(&this->callback);
@@ -149,6 +152,14 @@ void NetworkHTTPRequest::WinHttpCallback(DWORD code, void *info, DWORD length)
 				return;
 			}
 
+			/* The server has to send just the part we asked for, or it would end up after what we have already. */
+			if (this->resume_from != 0 && status_code != 206) {
+				Debug(net, 0, "HTTP request failed: server cannot resume the download");
+				this->finished = true;
+				this->callback.OnFailure();
+				return;
+			}
+
 			/* Next step: query for any data. */
 			WinHttpQueryDataAvailable(this->request, nullptr);
 		} break;
@@ -248,6 +259,11 @@ void NetworkHTTPRequest::Connect()
 		return;
 	}
 
+	if (this->resume_from != 0) {
+		std::wstring range = L"Range: bytes=" + std::to_wstring(this->resume_from) + L"-";
+		WinHttpAddRequestHeaders(this->request, range.c_str(), -1, WINHTTP_ADDREQ_FLAG_ADD);
+	}
+
 	/* Send the request (possibly with a payload). */
 	if (data.empty()) {
 		WinHttpSendRequest(this->request, WINHTTP_NO_ADDITIONAL_HEADERS, 0, WINHTTP_NO_REQUEST_DATA, 0, 0, reinterpret_cast<DWORD_PTR>(this));
@@ -291,9 +307,9 @@ NetworkHTTPRequest::~NetworkHTTPRequest()
 	_http_callbacks.erase(std::remove(_http_callbacks.begin(), _http_callbacks.end(), &this->callback), _http_callbacks.end());
 }
 
-/* static */ void NetworkHTTPSocketHandler::Connect(const std::string &uri, HTTPCallback *callback, const std::string data)
+/* static */ void NetworkHTTPSocketHandler::Connect(const std::string &uri, HTTPCallback *callback, const std::string data, size_t resume_from)
 {
-	auto request = new NetworkHTTPRequest(std::wstring(uri.begin(), uri.end()), callback, data);
+	auto request = new NetworkHTTPRequest(std::wstring(uri.begin(), uri.end()), callback, data, resume_from);
 	request->Connect();
 
 	std::lock_guard<std::mutex> lock(_new_http_requests_mutex);
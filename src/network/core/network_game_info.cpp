@@ -26,6 +26,8 @@
 #include "../network.h"
 #include "packet.h"
 
+#include <optional>
+
 #include "../../safeguards.h"
 
 
@@ -36,6 +38,7 @@
 static const uint GITHASH_SUFFIX_LEN = 12;
 
 NetworkServerGameInfo _network_game_info; ///< Information about our game.
+static uint32_t _network_game_info_generation = 0; ///< Changed whenever the static part of #_network_game_info is filled.
 
 /**
  * Get the network version string used by this build.
@@ -135,6 +138,8 @@ void FillStaticNetworkServerGameInfo()
 
 	_network_game_info.server_name = _settings_client.network.server_name;
 	_network_game_info.server_revision = GetNetworkRevisionString();
+
+	_network_game_info_generation++;
 }
 
 /**
@@ -253,6 +258,55 @@ void SerializeNetworkGameInfo(Packet &p, const NetworkServerGameInfo &info, bool
 	p.Send_bool  (info.dedicated);
 }
 
+/** Everything of the current game info that may change, except for the ticks that are sent separately. */
+struct NetworkGameInfoCacheKey {
+	uint32_t generation;                     ///< Generation of the static part of the game info.
+	const GRFConfig *grfconfig;              ///< The NewGRFs of the game.
+	const GameInfo *game_info;               ///< The game script.
+	int game_info_version;                   ///< Version of the game script.
+	TimerGameCalendar::Date calendar_date;   ///< Current calendar date.
+	uint8_t companies_on;                    ///< Number of companies.
+	uint8_t spectators_on;                   ///< Number of spectators.
+	uint8_t clients_on;                      ///< Number of clients.
+
+	bool operator==(const NetworkGameInfoCacheKey &other) const = default;
+};
+
+/**
+ * Serializes the current game info of this server to the packet.
+ * Everything following the ticks does not change often, even though every
+ * server scanner on the internet asks for it, so it is serialized once and
+ * copied into the packet as long as it does not change.
+ * @param p The packet to write the data to.
+ */
+void SerializeCurrentNetworkServerGameInfo(Packet &p)
+{
+	static std::optional<NetworkGameInfoCacheKey> cached_key;
+	static std::vector<uint8_t> cached_data;
+
+	const NetworkServerGameInfo &info = GetCurrentNetworkServerGameInfo();
+	const GameInfo *game_info = Game::GetInfo();
+	NetworkGameInfoCacheKey key{ _network_game_info_generation, info.grfconfig, game_info, game_info == nullptr ? -1 : game_info->GetVersion(),
+			info.calendar_date, info.companies_on, info.spectators_on, info.clients_on };
+
+	if (cached_key != key) {
+		Packet packet(nullptr, p.GetPacketType(), TCP_MTU);
+		SerializeNetworkGameInfo(packet, info);
+		packet.PrepareToSend();
+
+		/* Skip the header of the packet, and the version and the ticks that SerializeNetworkGameInfo starts with. */
+		size_t header = Packet::EncodedLengthOfPacketSize() + Packet::EncodedLengthOfPacketType() + sizeof(uint8_t) + sizeof(uint64_t);
+		std::span<const uint8_t> data = packet.GetBytesToTransfer();
+		cached_data.assign(data.begin() + header, data.end());
+		cached_key = key;
+	}
+
+	p.Send_uint8(NETWORK_GAME_INFO_VERSION);
+	p.Send_uint64(info.ticks_playing);
+	[[maybe_unused]] std::span<const uint8_t> remaining = p.Send_bytes(cached_data);
+	assert(remaining.empty());
+}
+
 /**
  * Deserializes the NetworkGameInfo struct from the packet.
  * @param p    the packet to read the data from.
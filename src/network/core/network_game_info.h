@@ -149,5 +149,6 @@ void SerializeGRFIdentifier(Packet &p, const GRFIdentifier &grf);
 
 void DeserializeNetworkGameInfo(Packet &p, NetworkGameInfo &info, const GameInfoNewGRFLookupTable *newgrf_lookup_table = nullptr);
 void SerializeNetworkGameInfo(Packet &p, const NetworkServerGameInfo &info, bool send_newgrf_names = true);
+void SerializeCurrentNetworkServerGameInfo(Packet &p);
 
 #endif /* NETWORK_CORE_GAME_INFO_H */
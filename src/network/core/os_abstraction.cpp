@@ -189,3 +189,41 @@ NetworkError GetSocketError(SOCKET d)
 
 	return NetworkError(err);
 }
+
+/**
+ * Send the data of several buffers with a single system call, instead of a call per buffer.
+ * @param d The socket to send the data over.
+ * @param buffers The buffers to send in order; at most #MAX_GATHERED_SEND_BUFFERS of them are sent.
+ * @return The number of bytes that were sent, or -1 upon errors.
+ */
+ssize_t SendGathered(SOCKET d, std::span<const std::span<const uint8_t>> buffers)
+{
+	assert(!buffers.empty());
+	size_t count = std::min(buffers.size(), MAX_GATHERED_SEND_BUFFERS);
+
+#if defined(_WIN32)
+	std::array<WSABUF, MAX_GATHERED_SEND_BUFFERS> wsa_buffers;
+	for (size_t i = 0; i < count; i++) {
+		wsa_buffers[i].buf = const_cast<char *>(reinterpret_cast<const char *>(buffers[i].data()));
+		wsa_buffers[i].len = static_cast<ULONG>(buffers[i].size());
+	}
+
+	DWORD sent;
+	if (WSASend(d, wsa_buffers.data(), static_cast<DWORD>(count), &sent, 0, nullptr, nullptr) != 0) return -1;
+	return sent;
+#elif defined(__EMSCRIPTEN__)
+	/* Emscripten's sockets cannot gather, so just send the first buffer. */
+	return send(d, buffers[0].data(), buffers[0].size(), 0);
+#else
+	std::array<iovec, MAX_GATHERED_SEND_BUFFERS> io_buffers;
+	for (size_t i = 0; i < count; i++) {
+		io_buffers[i].iov_base = const_cast<uint8_t *>(buffers[i].data());
+		io_buffers[i].iov_len = buffers[i].size();
+	}
+
+	msghdr message{};
+	message.msg_iov = io_buffers.data();
+	message.msg_iovlen = count;
+	return sendmsg(d, &message, 0);
+#endif
+}
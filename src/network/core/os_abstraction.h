@@ -137,6 +137,10 @@ bool SetNoDelay(SOCKET d);
 bool SetReusePort(SOCKET d);
 NetworkError GetSocketError(SOCKET d);
 
+/** Maximum number of buffers to send with a single call to #SendGathered. */
+static const size_t MAX_GATHERED_SEND_BUFFERS = 64;
+ssize_t SendGathered(SOCKET d, std::span<const std::span<const uint8_t>> buffers);
+
 /* Make sure these structures have the size we expect them to be */
 static_assert(sizeof(in_addr)  ==  4); ///< IPv4 addresses should be 4 bytes.
 static_assert(sizeof(in6_addr) == 16); ///< IPv6 addresses should be 16 bytes.
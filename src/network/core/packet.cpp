@@ -16,6 +16,41 @@
 
 #include "../../safeguards.h"
 
+/** Maximum number of buffers of each size class to keep for reuse, per thread. */
+static const size_t MAX_RECYCLED_PACKET_BUFFERS = 64;
+
+/**
+ * Get the buffers of destroyed packets for reuse by packets with the given limit.
+ * There is a set of buffers for packets up to #COMPAT_MTU bytes and one for larger packets.
+ * @param limit The maximum size of the packet.
+ * @return The recycled buffers.
+ */
+static std::vector<std::vector<uint8_t>> &GetRecycledPacketBuffers(size_t limit)
+{
+	/* Never destroyed, as packets of static socket handlers are destroyed during exit as well. */
+	static thread_local auto *recycled = new std::array<std::vector<std::vector<uint8_t>>, 2>();
+	return (*recycled)[limit > COMPAT_MTU ? 1 : 0];
+}
+
+/**
+ * Get an empty buffer for a new packet, reusing the memory of a destroyed packet when possible.
+ * @param limit The maximum size of the packet.
+ * @return The buffer.
+ */
+static std::vector<uint8_t> TakePacketBuffer(size_t limit)
+{
+	std::vector<std::vector<uint8_t>> &recycled = GetRecycledPacketBuffers(limit);
+	if (recycled.empty()) {
+		std::vector<uint8_t> buffer;
+		buffer.reserve(std::min(limit, COMPAT_MTU));
+		return buffer;
+	}
+
+	std::vector<uint8_t> buffer = std::move(recycled.back());
+	recycled.pop_back();
+	return buffer;
+}
+
 /**
  * Create a packet that is used to read from a network socket.
  * @param cs                The socket handler associated with the socket we are reading from.
@@ -28,7 +63,7 @@
  *                          loose some the data of the packet, so there you pass the maximum
  *                          size for the packet you expect from the network.
  */
-Packet::Packet(NetworkSocketHandler *cs, size_t limit, size_t initial_read_size) : pos(0), limit(limit)
+Packet::Packet(NetworkSocketHandler *cs, size_t limit, size_t initial_read_size) : pos(0), buffer(TakePacketBuffer(limit)), limit(limit)
 {
 	assert(cs != nullptr);
 
@@ -45,7 +80,7 @@ Packet::Packet(NetworkSocketHandler *cs, size_t limit, size_t initial_read_size)
  *              the limit as it might break things if the other side is not expecting
  *              much larger packets than what they support.
  */
-Packet::Packet(NetworkSocketHandler *cs, PacketType type, size_t limit) : pos(0), limit(limit), cs(cs)
+Packet::Packet(NetworkSocketHandler *cs, PacketType type, size_t limit) : pos(0), buffer(TakePacketBuffer(limit)), limit(limit), cs(cs)
 {
 	/* Allocate space for the the size so we can write that in just before sending the packet. */
 	size_t size = EncodedLengthOfPacketSize();
@@ -59,15 +94,34 @@ Packet::Packet(NetworkSocketHandler *cs, PacketType type, size_t limit) : pos(0)
 	this->Send_uint8(type);
 }
 
+/**
+ * Give the buffer of the packet back for reuse by the next packets.
+ */
+Packet::~Packet()
+{
+	std::vector<std::vector<uint8_t>> &recycled = GetRecycledPacketBuffers(this->limit);
+	if (recycled.size() >= MAX_RECYCLED_PACKET_BUFFERS || this->buffer.capacity() == 0) return;
+
+	this->buffer.clear();
+	recycled.push_back(std::move(this->buffer));
+}
+
 
 /**
  * Writes the packet size from the raw packet from packet->size
+ * @return Whether the packet could be prepared; when it could not, it must not be sent.
  */
-void Packet::PrepareToSend()
+bool Packet::PrepareToSend()
 {
 	/* Prevent this to be called twice and for packets that have been received. */
 	assert(this->buffer[0] == 0 && this->buffer[1] == 0);
 
+	if (cs != nullptr && cs->send_compression_handler != nullptr) {
+		size_t offset = EncodedLengthOfPacketSize();
+		if (cs->send_encryption_handler != nullptr) offset += cs->send_encryption_handler->MACSize();
+		if (!cs->send_compression_handler->Process(this->buffer, offset, std::numeric_limits<PacketSize>::max())) return false;
+	}
+
 	this->buffer[0] = GB(this->Size(), 0, 8);
 	this->buffer[1] = GB(this->Size(), 8, 8);
 
@@ -79,7 +133,7 @@ void Packet::PrepareToSend()
 	}
 
 	this->pos  = 0; // We start reading from here
-	this->buffer.shrink_to_fit();
+	return true;
 }
 
 /**
@@ -280,14 +334,24 @@ bool Packet::PrepareToRead()
 	/* Put the position on the right place */
 	this->pos = static_cast<PacketSize>(EncodedLengthOfPacketSize());
 
-	if (cs == nullptr || cs->receive_encryption_handler == nullptr) return true;
+	if (cs == nullptr) return true;
+
+	if (cs->receive_encryption_handler != nullptr) {
+		size_t mac_size = cs->receive_encryption_handler->MACSize();
+		if (this->buffer.size() <= pos + mac_size) return false;
 
-	size_t mac_size = cs->receive_encryption_handler->MACSize();
-	if (this->buffer.size() <= pos + mac_size) return false;
+		bool valid = cs->receive_encryption_handler->Decrypt(std::span(&this->buffer[pos], mac_size), std::span(&this->buffer[pos + mac_size], this->buffer.size() - pos - mac_size));
+		this->pos += static_cast<PacketSize>(mac_size);
+		if (!valid) return false;
+	}
+
+	if (cs->receive_compression_handler != nullptr) {
+		if (!cs->receive_compression_handler->Process(this->buffer, this->pos, this->limit)) return false;
+		/* A packet must at least have its type. */
+		if (this->buffer.size() < this->pos + EncodedLengthOfPacketType()) return false;
+	}
 
-	bool valid = cs->receive_encryption_handler->Decrypt(std::span(&this->buffer[pos], mac_size), std::span(&this->buffer[pos + mac_size], this->buffer.size() - pos - mac_size));
-	this->pos += static_cast<PacketSize>(mac_size);
-	return valid;
+	return true;
 }
 
 /**
@@ -448,3 +512,24 @@ size_t Packet::RemainingBytesToTransfer() const
 {
 	return this->Size() - this->pos;
 }
+
+/**
+ * Get the data that still has to be transferred out, starting at the
+ * position the last transfer stopped.
+ * @return The bytes to transfer.
+ */
+std::span<const uint8_t> Packet::GetBytesToTransfer() const
+{
+	return std::span(this->buffer).subspan(this->pos);
+}
+
+/**
+ * Mark a number of bytes as transferred out, after they were sent
+ * together with the data of other packets.
+ * @param bytes The number of bytes that were transferred.
+ */
+void Packet::MarkTransferred(size_t bytes)
+{
+	assert(bytes <= this->RemainingBytesToTransfer());
+	this->pos += static_cast<PacketSize>(bytes);
+}
@@ -56,9 +56,10 @@ private:
 public:
 	Packet(NetworkSocketHandler *cs, size_t limit, size_t initial_read_size = EncodedLengthOfPacketSize());
 	Packet(NetworkSocketHandler *cs, PacketType type, size_t limit = COMPAT_MTU);
+	~Packet();
 
 	/* Sending/writing of packets */
-	void PrepareToSend();
+	bool PrepareToSend();
 
 	bool   CanWriteToPacket(size_t bytes_to_write);
 	void   Send_bool  (bool   data);
@@ -88,6 +89,8 @@ public:
 	std::string Recv_string(size_t length, StringValidationSettings settings = SVS_REPLACE_WITH_QUESTION_MARK);
 
 	size_t RemainingBytesToTransfer() const;
+	std::span<const uint8_t> GetBytesToTransfer() const;
+	void MarkTransferred(size_t bytes);
 
 	/**
 	 * Transfer data from the packet to the given function. It starts reading at the
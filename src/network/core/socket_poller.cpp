@@ -0,0 +1,192 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file socket_poller.cpp Checking many sockets for being readable or writable at once.
+ */
+
+#include "../../stdafx.h"
+#include "../../debug.h"
+#include "socket_poller.h"
+
+#include <thread>
+
+#if defined(WITH_EPOLL)
+#	include <sys/epoll.h>
+#elif defined(WITH_KQUEUE)
+#	include <sys/types.h>
+#	include <sys/event.h>
+#endif
+
+#include "../../safeguards.h"
+
+SocketPoller::~SocketPoller()
+{
+	this->Clear();
+}
+
+/** Forget all sockets, e.g. because they got closed. */
+void SocketPoller::Clear()
+{
+#if defined(WITH_EPOLL) || defined(WITH_KQUEUE)
+	if (this->poll_fd != -1) close(this->poll_fd);
+	this->poll_fd = -1;
+#endif
+	this->registered.clear();
+	this->watched.clear();
+	this->ready.clear();
+}
+
+/**
+ * Register a socket with the OS.
+ * @param s The socket.
+ * @param write Whether to check whether the socket is writable as well.
+ */
+void SocketPoller::Register([[maybe_unused]] SOCKET s, [[maybe_unused]] bool write)
+{
+#if defined(WITH_EPOLL)
+	epoll_event event{};
+	event.events = EPOLLIN;
+	if (write) event.events |= EPOLLOUT;
+	event.data.fd = s;
+	if (epoll_ctl(this->poll_fd, EPOLL_CTL_ADD, s, &event) != 0) {
+		Debug(net, 0, "Could not register socket for polling: {}", NetworkError::GetLast().AsString());
+	}
+#elif defined(WITH_KQUEUE)
+	struct kevent changes[2];
+	int count = 0;
+	EV_SET(&changes[count++], s, EVFILT_READ, EV_ADD, 0, 0, nullptr);
+	if (write) EV_SET(&changes[count++], s, EVFILT_WRITE, EV_ADD, 0, 0, nullptr);
+	if (kevent(this->poll_fd, changes, count, nullptr, 0, nullptr) != 0) {
+		Debug(net, 0, "Could not register socket for polling: {}", NetworkError::GetLast().AsString());
+	}
+#endif
+}
+
+/**
+ * Unregister a socket from the OS. This fails when the socket got closed
+ * already, but then the OS has forgotten about it as well.
+ * @param s The socket.
+ * @param write Whether the writability of the socket was checked.
+ */
+void SocketPoller::Unregister([[maybe_unused]] SOCKET s, [[maybe_unused]] bool write)
+{
+#if defined(WITH_EPOLL)
+	epoll_ctl(this->poll_fd, EPOLL_CTL_DEL, s, nullptr);
+#elif defined(WITH_KQUEUE)
+	struct kevent change;
+	EV_SET(&change, s, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+	kevent(this->poll_fd, &change, 1, nullptr, 0, nullptr);
+	if (write) {
+		EV_SET(&change, s, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+		kevent(this->poll_fd, &change, 1, nullptr, 0, nullptr);
+	}
+#endif
+}
+
+/**
+ * Check which of the watched sockets are readable or writable.
+ * @param timeout How long to wait for a socket to become ready; by default do not block at all.
+ * @return False iff checking the sockets failed.
+ */
+bool SocketPoller::Poll(std::chrono::milliseconds timeout)
+{
+	this->ready.clear();
+
+#if defined(WITH_EPOLL) || defined(WITH_KQUEUE)
+	if (this->poll_fd == -1) {
+#	if defined(WITH_EPOLL)
+		this->poll_fd = epoll_create1(EPOLL_CLOEXEC);
+#	else
+		this->poll_fd = kqueue();
+#	endif
+		if (this->poll_fd == -1) {
+			Debug(net, 0, "Could not create socket poller: {}", NetworkError::GetLast().AsString());
+			this->watched.clear();
+			return false;
+		}
+	}
+
+	/* Only tell the OS about the sockets that changed since the last poll. */
+	for (auto it = this->registered.begin(); it != this->registered.end(); /* nothing */) {
+		auto watch = this->watched.find(it->first);
+		if (watch == this->watched.end() || watch->second != it->second) {
+			this->Unregister(it->first, it->second);
+			it = this->registered.erase(it);
+		} else {
+			++it;
+		}
+	}
+	for (const auto &[s, write] : this->watched) {
+		if (this->registered.emplace(s, write).second) this->Register(s, write);
+	}
+	this->watched.clear();
+
+	if (this->registered.empty()) {
+		if (timeout.count() > 0) std::this_thread::sleep_for(timeout);
+		return true;
+	}
+
+#	if defined(WITH_EPOLL)
+	static thread_local std::vector<epoll_event> events;
+	events.resize(this->registered.size());
+	int count = epoll_wait(this->poll_fd, events.data(), static_cast<int>(events.size()), static_cast<int>(timeout.count()));
+	if (count < 0) return errno == EINTR;
+
+	for (int i = 0; i < count; i++) {
+		SocketReadiness &readiness = this->ready[events[i].data.fd];
+		if ((events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0) readiness |= SR_READ;
+		if ((events[i].events & EPOLLOUT) != 0) readiness |= SR_WRITE;
+	}
+#	else
+	static thread_local std::vector<struct kevent> events;
+	events.resize(this->registered.size() * 2);
+	struct timespec ts = {static_cast<time_t>(timeout.count() / 1000), static_cast<long>(timeout.count() % 1000) * 1000000};
+	int count = kevent(this->poll_fd, nullptr, 0, events.data(), static_cast<int>(events.size()), &ts);
+	if (count < 0) return errno == EINTR;
+
+	for (int i = 0; i < count; i++) {
+		SocketReadiness &readiness = this->ready[static_cast<SOCKET>(events[i].ident)];
+		if (events[i].filter == EVFILT_READ) readiness |= SR_READ;
+		if (events[i].filter == EVFILT_WRITE) readiness |= SR_WRITE;
+	}
+#	endif
+#else
+	if (this->watched.empty()) {
+		if (timeout.count() > 0) std::this_thread::sleep_for(timeout);
+		return true;
+	}
+
+	fd_set read_fd, write_fd;
+	struct timeval tv;
+
+	FD_ZERO(&read_fd);
+	FD_ZERO(&write_fd);
+
+	for (const auto &[s, write] : this->watched) {
+		FD_SET(s, &read_fd);
+		if (write) FD_SET(s, &write_fd);
+	}
+
+	tv.tv_sec = static_cast<long>(timeout.count() / 1000);
+	tv.tv_usec = static_cast<long>(timeout.count() % 1000) * 1000;
+	if (select(FD_SETSIZE, &read_fd, &write_fd, nullptr, &tv) < 0) {
+		this->watched.clear();
+		return false;
+	}
+
+	for (const auto &[s, write] : this->watched) {
+		SocketReadiness readiness = SR_NONE;
+		if (FD_ISSET(s, &read_fd)) readiness |= SR_READ;
+		if (FD_ISSET(s, &write_fd)) readiness |= SR_WRITE;
+		if (readiness != SR_NONE) this->ready[s] = readiness;
+	}
+	this->watched.clear();
+#endif
+
+	return true;
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file socket_poller.h Checking many sockets for being readable or writable at once.
+ */
+
+#ifndef NETWORK_CORE_SOCKET_POLLER_H
+#define NETWORK_CORE_SOCKET_POLLER_H
+
+#include "os_abstraction.h"
+#include "../../core/enum_type.hpp"
+
+#include <chrono>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#	define WITH_EPOLL
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__) || defined(__DragonFly__)
+#	define WITH_KQUEUE
+#endif
+
+/** What a socket is ready for. */
+enum SocketReadiness : uint8_t {
+	SR_NONE  = 0,      ///< The socket is not ready.
+	SR_READ  = 1 << 0, ///< The socket can be read from, or got an error or was closed.
+	SR_WRITE = 1 << 1, ///< The socket can be written to.
+};
+DECLARE_ENUM_AS_BIT_SET(SocketReadiness)
+
+/**
+ * Checks the readiness of a set of sockets that changes only a bit between the checks.
+ * The sockets stay registered with the OS using epoll on Linux and kqueue on BSD and
+ * macOS, so a check does not pass all sockets to the OS again, and the number of
+ * sockets is not limited by FD_SETSIZE. Elsewhere select is used.
+ *
+ * Before every #Poll all sockets to check have to be passed to #Watch; the sockets
+ * that are not watched anymore are unregistered. As the OS forgets a socket when it
+ * gets closed, #Clear has to be called when sockets got closed and new ones could be
+ * opened without a #Poll in between.
+ */
+class SocketPoller {
+	std::unordered_map<SOCKET, bool> registered; ///< The sockets registered with the OS, and whether writability is checked.
+	std::unordered_map<SOCKET, bool> watched;    ///< The sockets to check with the next poll, and whether writability is checked.
+	std::unordered_map<SOCKET, SocketReadiness> ready; ///< The readiness of the sockets found by the last poll.
+#if defined(WITH_EPOLL) || defined(WITH_KQUEUE)
+	int poll_fd = -1; ///< The epoll or kqueue instance.
+#endif
+
+	void Register(SOCKET s, bool write);
+	void Unregister(SOCKET s, bool write);
+
+public:
+	SocketPoller() = default;
+	SocketPoller(const SocketPoller &) = delete;
+	SocketPoller &operator=(const SocketPoller &) = delete;
+	~SocketPoller();
+
+	/**
+	 * Check the socket with the next #Poll.
+	 * @param s The socket.
+	 * @param write Whether to check whether the socket is writable as well.
+	 */
+	void Watch(SOCKET s, bool write)
+	{
+		if (s != INVALID_SOCKET) this->watched[s] = write;
+	}
+
+	bool Poll(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+	void Clear();
+
+	/**
+	 * Get what a socket was ready for at the last #Poll.
+	 * @param s The socket.
+	 * @return The readiness.
+	 */
+	SocketReadiness GetReadiness(SOCKET s) const
+	{
+		auto it = this->ready.find(s);
+		return it == this->ready.end() ? SR_NONE : it->second;
+	}
+};
+
+#endif /* NETWORK_CORE_SOCKET_POLLER_H */
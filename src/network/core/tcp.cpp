@@ -54,6 +54,7 @@ NetworkRecvStatus NetworkTCPSocketHandler::CloseConnection([[maybe_unused]] bool
 	this->writable = false;
 
 	this->packet_queue.clear();
+	this->bulk_packet_queue.clear();
 	this->packet_recv = nullptr;
 
 	return NETWORK_RECV_STATUS_OKAY;
@@ -69,10 +70,44 @@ void NetworkTCPSocketHandler::SendPacket(std::unique_ptr<Packet> &&packet)
 {
 	assert(packet != nullptr);
 
-	packet->PrepareToSend();
+	if (this->send_stream_broken) return;
+	if (!packet->PrepareToSend()) {
+		this->HandlePrepareToSendFailure(false);
+		return;
+	}
 	this->packet_queue.push_back(std::move(packet));
 }
 
+/**
+ * This function puts a bulk packet, e.g. a part of the map, in the
+ * send-queue. The packets passed to #SendPacket are sent before the
+ * bulk packets that are waiting, so frames do not have to wait for
+ * the bulk data. Bulk packets are sent in the order they are queued.
+ * The packet is only prepared when it joins the other packets, as the
+ * encryption requires the packets to be prepared in the order they are sent.
+ * @param packet the packet to send
+ */
+void NetworkTCPSocketHandler::SendBulkPacket(std::unique_ptr<Packet> &&packet)
+{
+	assert(packet != nullptr);
+
+	this->bulk_packet_queue.push_back(std::move(packet));
+}
+
+/**
+ * Handle a packet that could not be prepared to be sent, e.g. because compressing it failed.
+ * The packets form one stream, so no packet can be sent after it and the connection is closed.
+ * @param closing_down Whether we are closing down the connection.
+ */
+void NetworkTCPSocketHandler::HandlePrepareToSendFailure(bool closing_down)
+{
+	Debug(net, 0, "Preparing a packet to send failed, closing the connection");
+	this->send_stream_broken = true;
+	this->packet_queue.clear();
+	this->bulk_packet_queue.clear();
+	if (!closing_down) this->CloseConnection();
+}
+
 /**
  * Sends all the buffered packets out for this client. It stops when:
  *   1) all packets are send (queue is empty)
@@ -86,12 +121,33 @@ void NetworkTCPSocketHandler::SendPacket(std::unique_ptr<Packet> &&packet)
 SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 {
 	/* We can not write to this socket!! */
+	if (this->send_stream_broken) return SPS_CLOSED;
 	if (!this->writable) return SPS_NONE_SENT;
 	if (!this->IsConnected()) return SPS_CLOSED;
 
-	while (!this->packet_queue.empty()) {
-		Packet &p = *this->packet_queue.front();
-		ssize_t res = p.TransferOut<int>(send, this->sock, 0);
+	while (this->HasSendQueue()) {
+		/* Once all other packets are out, the next bulk packet joins them. Packets that are
+		 * queued later have to wait for that packet only. */
+		if (this->packet_queue.empty()) {
+			this->packet_queue.push_back(std::move(this->bulk_packet_queue.front()));
+			this->bulk_packet_queue.pop_front();
+			if (!this->packet_queue.back()->PrepareToSend()) {
+				this->HandlePrepareToSendFailure(closing_down);
+				return SPS_CLOSED;
+			}
+		}
+
+		/* Send as many of the queued packets as possible with a single system call. */
+		std::array<std::span<const uint8_t>, MAX_GATHERED_SEND_BUFFERS> buffers;
+		size_t count = 0;
+		size_t to_send = 0;
+		for (auto it = this->packet_queue.begin(); it != this->packet_queue.end() && count < buffers.size(); ++it) {
+			buffers[count] = (*it)->GetBytesToTransfer();
+			to_send += buffers[count].size();
+			count++;
+		}
+
+		ssize_t res = SendGathered(this->sock, std::span(buffers.data(), count));
 		if (res == -1) {
 			NetworkError err = NetworkError::GetLast();
 			if (!err.WouldBlock()) {
@@ -110,13 +166,19 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 			return SPS_CLOSED;
 		}
 
-		/* Is this packet sent? */
-		if (p.RemainingBytesToTransfer() == 0) {
-			/* Go to the next packet */
-			this->packet_queue.pop_front();
-		} else {
-			return SPS_PARTLY_SENT;
+		/* Go to the next packet for every packet that is sent. */
+		size_t sent = res;
+		while (sent > 0) {
+			Packet &p = *this->packet_queue.front();
+			size_t amount = std::min(sent, p.RemainingBytesToTransfer());
+			p.MarkTransferred(amount);
+			sent -= amount;
+
+			if (p.RemainingBytesToTransfer() == 0) this->packet_queue.pop_front();
 		}
+
+		/* The OS could not take everything. */
+		if (static_cast<size_t>(res) < to_send) return SPS_PARTLY_SENT;
 	}
 
 	return SPS_ALL_SENT;
@@ -133,7 +195,9 @@ std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
 	if (!this->IsConnected()) return nullptr;
 
 	if (this->packet_recv == nullptr) {
-		this->packet_recv = std::make_unique<Packet>(this, TCP_MTU);
+		/* Compressing a packet of the largest size may make it a bit larger. */
+		size_t limit = TCP_MTU + (this->receive_compression_handler != nullptr ? NETWORK_COMPRESSION_OVERHEAD : 0);
+		this->packet_recv = std::make_unique<Packet>(this, limit);
 	}
 
 	Packet &p = *this->packet_recv.get();
@@ -31,9 +31,12 @@ enum SendPacketsState {
 class NetworkTCPSocketHandler : public NetworkSocketHandler {
 private:
 	std::deque<std::unique_ptr<Packet>> packet_queue; ///< Packets that are awaiting delivery. Cannot be std::queue as that does not have a clear() function.
+	std::deque<std::unique_ptr<Packet>> bulk_packet_queue; ///< Bulk packets that are awaiting delivery after all packets of #packet_queue; they are not prepared yet.
 	std::unique_ptr<Packet> packet_recv; ///< Partially received packet
+	bool send_stream_broken = false; ///< Whether a packet could not be prepared, after which no packet can be sent anymore.
 
 	void EmptyPacketQueue();
+	void HandlePrepareToSendFailure(bool closing_down);
 public:
 	SOCKET sock;              ///< The socket currently connected to
 	bool writable;            ///< Can we write to this socket?
@@ -48,6 +51,7 @@ public:
 	void CloseSocket();
 
 	virtual void SendPacket(std::unique_ptr<Packet> &&packet);
+	void SendBulkPacket(std::unique_ptr<Packet> &&packet);
 	SendPacketsState SendPackets(bool closing_down = false);
 
 	virtual std::unique_ptr<Packet> ReceivePacket();
@@ -58,7 +62,13 @@ public:
 	 * Whether there is something pending in the send queue.
 	 * @return true when something is pending in the send queue.
 	 */
-	bool HasSendQueue() { return !this->packet_queue.empty(); }
+	bool HasSendQueue() { return !this->packet_queue.empty() || !this->bulk_packet_queue.empty(); }
+
+	/**
+	 * Whether there are bulk packets pending in the send queue.
+	 * @return true when bulk packets are pending in the send queue.
+	 */
+	bool HasBulkSendQueue() { return !this->bulk_packet_queue.empty(); }
 
 	NetworkTCPSocketHandler(SOCKET s = INVALID_SOCKET);
 	~NetworkTCPSocketHandler();
@@ -84,11 +94,10 @@ private:
 		Connected,  ///< The connection is established.
 	};
 
-	std::thread resolve_thread;                         ///< Thread used during resolving.
 	std::atomic<Status> status = Status::Init;          ///< The current status of the connecter.
 	std::atomic<bool> killed = false;                   ///< Whether this connecter is marked as killed.
 
-	addrinfo *ai = nullptr;                             ///< getaddrinfo() allocated linked-list of resolved addresses.
+	std::shared_ptr<addrinfo> ai;                       ///< getaddrinfo() allocated linked-list of resolved addresses, possibly shared with other connecters.
 	std::vector<addrinfo *> addresses;                  ///< Addresses we can connect to.
 	std::map<SOCKET, NetworkAddress> sock_to_address;   ///< Mapping of a socket to the real address it is connecting to. USed for DEBUG statements.
 	size_t current_address = 0;                         ///< Current index in addresses we are trying.
@@ -102,7 +111,7 @@ private:
 
 	static std::vector<std::shared_ptr<TCPConnecter>> connecters; ///< List of connections that are currently being created.
 
-	void Resolve();
+	bool Resolve();
 	void OnResolved(addrinfo *ai);
 	bool TryNextAddress();
 	void Connect(addrinfo *address);
@@ -112,8 +121,6 @@ private:
 	 * access these private members, but it is okay for TCPServerConnecter. */
 	friend class TCPServerConnecter;
 
-	static void ResolveThunk(TCPConnecter *connecter);
-
 public:
 	TCPConnecter() {};
 	TCPConnecter(const std::string &connection_string, uint16_t default_port, const NetworkAddress &bind_address = {}, int family = AF_UNSPEC);
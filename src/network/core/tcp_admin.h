@@ -61,6 +61,7 @@ enum PacketAdminType : uint8_t {
 	ADMIN_PACKET_SERVER_RCON_END,        ///< The server indicates that the remote console command has completed.
 	ADMIN_PACKET_SERVER_PONG,            ///< The server replies to a ping request from the admin.
 	ADMIN_PACKET_SERVER_CMD_LOGGING,     ///< The server gives the admin copies of incoming command packets.
+	ADMIN_PACKET_SERVER_PERFORMANCE,     ///< The server gives the admin its performance measurements and the sizes of the game.
 
 	INVALID_ADMIN_PACKET = 0xFF,         ///< An invalid marker for admin packets.
 };
@@ -84,6 +85,7 @@ enum AdminUpdateType {
 	ADMIN_UPDATE_CMD_NAMES,       ///< The admin would like a list of all DoCommand names.
 	ADMIN_UPDATE_CMD_LOGGING,     ///< The admin would like to have DoCommand information.
 	ADMIN_UPDATE_GAMESCRIPT,      ///< The admin would like to have gamescript messages.
+	ADMIN_UPDATE_PERFORMANCE,     ///< The admin would like to have performance measurements.
 	ADMIN_UPDATE_END,             ///< Must ALWAYS be on the end of this list!! (period)
 };
 
@@ -488,6 +490,41 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_RCON_END(Packet &p);
 
+	/**
+	 * Send the performance measurements of the server, the sizes of the game and
+	 * the vehicle and station counts of all companies, in one packet:
+	 * uint32_t  Frame counter of the server.
+	 * uint8_t   Number of performance elements (see #PerformanceElement), followed by for each element:
+	 *   uint32_t  Rate in thousandths of cycles per second, or UINT32_MAX when not measured.
+	 *   uint32_t  Average duration of a cycle in microseconds, or UINT32_MAX when not measured.
+	 * uint8_t   Number of pool sizes, followed by for each of them:
+	 *   uint32_t  Number of vehicles, stations and waypoints, towns, industries, orders and cargo packets, in that order.
+	 * uint8_t   Number of companies, followed by for each company:
+	 *   uint8_t   ID of the company.
+	 *   uint16_t  Number of trains, lorries, busses, planes and ships.
+	 *   uint16_t  Number of train stations, lorry stations, bus stops, airports and harbours.
+	 * uint8_t   Number of companies with attributed time, 0 unless misc.company_performance_accounting is enabled, followed by for each company:
+	 *   uint8_t   ID of the company.
+	 *   uint32_t  Average time per tick in microseconds spent on the company's vehicles (including pathfinding), pathfinding and commands.
+	 * uint8_t   Number of pathfinder transport types, followed by for trains, road vehicles and ships, counted since the start or the last 'pathfinder_stats reset':
+	 *   uint64_t  Number of searches.
+	 *   uint64_t  Number of nodes expanded.
+	 *   uint64_t  Number of node costs taken from the cache.
+	 *   uint64_t  Number of node costs that had to be calculated.
+	 *   uint64_t  Total duration of the searches in microseconds.
+	 *   uint32_t  Duration of the slowest search in microseconds.
+	 * uint8_t   Number of slowest searches, slowest first, followed by for each search:
+	 *   uint8_t   Transport type (see #VehicleType).
+	 *   uint32_t  ID of the vehicle.
+	 *   uint32_t  Tile of the vehicle.
+	 *   uint32_t  Destination tile of the vehicle.
+	 *   uint32_t  Number of nodes expanded.
+	 *   uint32_t  Duration of the search in microseconds.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_PERFORMANCE(Packet &p);
+
 	NetworkRecvStatus HandlePacket(Packet &p);
 public:
 	NetworkRecvStatus CloseConnection(bool error = true) override;
@@ -16,10 +16,173 @@
 #include "../network_coordinator.h"
 #include "../network_internal.h"
 
+#include <condition_variable>
+#include <deque>
+
 #include "../../safeguards.h"
 
 /* static */ std::vector<std::shared_ptr<TCPConnecter>> TCPConnecter::connecters;
 
+/**
+ * Resolves the hostnames of all connecters on a single thread, and remembers
+ * the results for a while. Refreshing the server list or the content list
+ * connects to the same few hosts over and over again, so most lookups are
+ * answered from the cache and the others do not each need their own thread.
+ * The resolver is never destroyed, so a lookup that is still running on exit
+ * does not have to be waited for; the thread simply ends with the process.
+ */
+class NetworkResolver {
+public:
+	/** For how long a successful lookup is remembered. */
+	static constexpr std::chrono::seconds SUCCESS_LIFETIME = std::chrono::seconds(60);
+	/** For how long a failed lookup is remembered, so all connecters waiting for it see the failure. */
+	static constexpr std::chrono::seconds FAILURE_LIFETIME = std::chrono::seconds(2);
+
+	static NetworkResolver &Get();
+	bool Lookup(const std::string &connection_string, std::shared_ptr<addrinfo> &ai);
+
+private:
+	/** A lookup, either done or still to be done. */
+	struct Entry {
+		std::shared_ptr<addrinfo> ai; ///< The result, or nullptr when the lookup failed.
+		std::chrono::steady_clock::time_point expire; ///< When the result is not to be used anymore.
+		bool resolving = true; ///< Whether the lookup has not been done yet.
+	};
+
+	void ResolverLoop();
+	static std::shared_ptr<addrinfo> Resolve(const std::string &connection_string);
+
+	std::mutex mutex;              ///< Protects all members.
+	std::condition_variable work;  ///< Signalled when a lookup is queued.
+	std::map<std::string, Entry> cache; ///< Lookups by normalized connection string.
+	std::deque<std::string> queue; ///< Connection strings to look up.
+	std::thread thread;            ///< The thread doing the lookups.
+	bool started = false;          ///< Whether starting the thread has been tried.
+};
+
+/**
+ * Get the resolver.
+ * @return The resolver.
+ */
+/* static */ NetworkResolver &NetworkResolver::Get()
+{
+	static NetworkResolver *resolver = new NetworkResolver();
+	return *resolver;
+}
+
+/**
+ * Look up the addresses of a connection string. When there is no recent
+ * result, the lookup is queued for the resolver thread, or done right away
+ * when there is no such thread.
+ * @param connection_string The normalized connection string, including the port.
+ * @param[out] ai The addresses, or nullptr when the lookup failed.
+ * @return False iff the lookup has not been done yet; try again later.
+ */
+bool NetworkResolver::Lookup(const std::string &connection_string, std::shared_ptr<addrinfo> &ai)
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+
+	auto now = std::chrono::steady_clock::now();
+	auto it = this->cache.find(connection_string);
+	if (it != this->cache.end()) {
+		if (it->second.resolving) return false;
+		if (now < it->second.expire) {
+			ai = it->second.ai;
+			return true;
+		}
+	}
+
+	/* Forget the results that are too old, so the cache stays small. */
+	for (auto old = this->cache.begin(); old != this->cache.end(); /* nothing */) {
+		if (!old->second.resolving && old->second.expire <= now) {
+			old = this->cache.erase(old);
+		} else {
+			++old;
+		}
+	}
+
+	if (!this->started) {
+		this->started = true;
+		if (!StartNewThread(&this->thread, "ottd:resolve", [this]() { this->ResolverLoop(); })) {
+			Debug(net, 1, "Could not start resolver thread; resolving blocks the game");
+		}
+	}
+
+	if (!this->thread.joinable()) {
+		/* No thread, do a blocking lookup. */
+		lock.unlock();
+		ai = NetworkResolver::Resolve(connection_string);
+		return true;
+	}
+
+	this->cache[connection_string] = {};
+	this->queue.push_back(connection_string);
+	lock.unlock();
+	this->work.notify_one();
+	return false;
+}
+
+/** Main loop of the resolver thread. */
+void NetworkResolver::ResolverLoop()
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	for (;;) {
+		this->work.wait(lock, [this]() { return !this->queue.empty(); });
+
+		std::string connection_string = std::move(this->queue.front());
+		this->queue.pop_front();
+
+		lock.unlock();
+		std::shared_ptr<addrinfo> ai = NetworkResolver::Resolve(connection_string);
+		lock.lock();
+
+		Entry &entry = this->cache[connection_string];
+		entry.ai = std::move(ai);
+		entry.expire = std::chrono::steady_clock::now() + (entry.ai != nullptr ? SUCCESS_LIFETIME : FAILURE_LIFETIME);
+		entry.resolving = false;
+	}
+}
+
+/**
+ * Resolve the hostname of a connection string.
+ * @param connection_string The normalized connection string, including the port.
+ * @return The addresses, or nullptr when resolving failed.
+ */
+/* static */ std::shared_ptr<addrinfo> NetworkResolver::Resolve(const std::string &connection_string)
+{
+	/* Port is already guaranteed part of the connection_string. */
+	NetworkAddress address = ParseConnectionString(connection_string, 0);
+
+	addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_flags = AI_ADDRCONFIG;
+	hints.ai_socktype = SOCK_STREAM;
+
+	std::string port_name = std::to_string(address.GetPort());
+
+	static bool getaddrinfo_timeout_error_shown = false;
+	auto start = std::chrono::steady_clock::now();
+
+	addrinfo *ai;
+	int error = getaddrinfo(address.GetHostname().c_str(), port_name.c_str(), &hints, &ai);
+
+	auto end = std::chrono::steady_clock::now();
+	auto duration = std::chrono::duration_cast<std::chrono::seconds>(end - start);
+	if (!getaddrinfo_timeout_error_shown && duration >= std::chrono::seconds(5)) {
+		Debug(net, 0, "getaddrinfo() for address \"{}\" took {} seconds", connection_string, duration.count());
+		Debug(net, 0, "  This is likely an issue in the DNS name resolver's configuration causing it to time out");
+		getaddrinfo_timeout_error_shown = true;
+	}
+
+	if (error != 0) {
+		Debug(net, 0, "Failed to resolve DNS for {}", connection_string);
+		return nullptr;
+	}
+
+	return std::shared_ptr<addrinfo>(ai, freeaddrinfo);
+}
+
 /**
  * Create a new connecter for the given address.
  * @param connection_string The address to connect to.
@@ -58,17 +221,11 @@ TCPServerConnecter::TCPServerConnecter(const std::string &connection_string, uin
 
 TCPConnecter::~TCPConnecter()
 {
-	if (this->resolve_thread.joinable()) {
-		this->resolve_thread.join();
-	}
-
 	for (const auto &socket : this->sockets) {
 		closesocket(socket);
 	}
 	this->sockets.clear();
 	this->sock_to_address.clear();
-
-	if (this->ai != nullptr) freeaddrinfo(this->ai);
 }
 
 /**
@@ -212,56 +369,24 @@ void TCPConnecter::OnResolved(addrinfo *ai)
 }
 
 /**
- * Start resolving the hostname.
+ * Check whether the hostname has been resolved, and start resolving it if needed.
  *
- * This function must change "status" to either Status::FAILURE
- * or Status::CONNECTING before returning.
+ * This function changes "status" to either Status::Failure or
+ * Status::Connecting once the hostname has been resolved.
+ * @return True iff the hostname has been resolved.
  */
-void TCPConnecter::Resolve()
+bool TCPConnecter::Resolve()
 {
-	/* Port is already guaranteed part of the connection_string. */
-	NetworkAddress address = ParseConnectionString(this->connection_string, 0);
-
-	addrinfo hints;
-	memset(&hints, 0, sizeof(hints));
-	hints.ai_family = AF_UNSPEC;
-	hints.ai_flags = AI_ADDRCONFIG;
-	hints.ai_socktype = SOCK_STREAM;
-
-	std::string port_name = std::to_string(address.GetPort());
-
-	static bool getaddrinfo_timeout_error_shown = false;
-	auto start = std::chrono::steady_clock::now();
+	if (!NetworkResolver::Get().Lookup(this->connection_string, this->ai)) return false;
 
-	addrinfo *ai;
-	int error = getaddrinfo(address.GetHostname().c_str(), port_name.c_str(), &hints, &ai);
-
-	auto end = std::chrono::steady_clock::now();
-	auto duration = std::chrono::duration_cast<std::chrono::seconds>(end - start);
-	if (!getaddrinfo_timeout_error_shown && duration >= std::chrono::seconds(5)) {
-		Debug(net, 0, "getaddrinfo() for address \"{}\" took {} seconds", this->connection_string, duration.count());
-		Debug(net, 0, "  This is likely an issue in the DNS name resolver's configuration causing it to time out");
-		getaddrinfo_timeout_error_shown = true;
-	}
-
-	if (error != 0) {
-		Debug(net, 0, "Failed to resolve DNS for {}", this->connection_string);
+	if (this->ai == nullptr) {
 		this->status = Status::Failure;
-		return;
+		return true;
 	}
 
-	this->ai = ai;
-	this->OnResolved(ai);
-
+	this->OnResolved(this->ai.get());
 	this->status = Status::Connecting;
-}
-
-/**
- * Thunk to start Resolve() on the right instance.
- */
-/* static */ void TCPConnecter::ResolveThunk(TCPConnecter *connecter)
-{
-	connecter->Resolve();
+	return true;
 }
 
 /**
@@ -274,27 +399,21 @@ bool TCPConnecter::CheckActivity()
 
 	switch (this->status) {
 		case Status::Init:
-			/* Start the thread delayed, so the vtable is loaded. This allows classes
-			 * to overload functions used by Resolve() (in case threading is disabled). */
-			if (StartNewThread(&this->resolve_thread, "ottd:resolve", &TCPConnecter::ResolveThunk, this)) {
+		case Status::Resolving:
+			if (!this->Resolve()) {
 				this->status = Status::Resolving;
 				return false;
 			}
 
-			/* No threads, do a blocking resolve. */
-			this->Resolve();
-
-			/* Continue as we are either failed or can start the first
-			 * connection. The rest of this function handles exactly that. */
+			/* Either resolving failed, or we can start the first connection;
+			 * the rest of this function handles exactly that. */
+			if (this->status == Status::Failure) {
+				this->OnFailure();
+				return true;
+			}
 			break;
 
-		case Status::Resolving:
-			/* Wait till Resolve() comes back with an answer (in case it runs threaded). */
-			return false;
-
 		case Status::Failure:
-			/* Ensure the OnFailure() is called from the game-thread instead of the
-			 * resolve-thread, as otherwise we can get into some threading issues. */
 			this->OnFailure();
 			return true;
 
@@ -104,6 +104,7 @@ enum PacketGameType : uint8_t {
 	/* Sending commands around. */
 	PACKET_CLIENT_COMMAND,               ///< Client executed a command and sends it to the server.
 	PACKET_SERVER_COMMAND,               ///< Server distributes a command to (all) the clients.
+	PACKET_SERVER_COMMANDS,              ///< Server distributes several commands at once to a client with #NGC_COMMAND_BATCHES.
 
 	/* Human communication! */
 	PACKET_CLIENT_CHAT,                  ///< Client said something that should be distributed.
@@ -133,6 +134,14 @@ enum PacketGameType : uint8_t {
 	PACKET_END,                          ///< Must ALWAYS be on the end of this list!! (period)
 };
 
+/** Optional parts of the protocol that the client announces to support when joining. */
+enum NetworkGameCapabilities : uint32_t {
+	NGC_NONE            = 0,      ///< None of the optional parts.
+	NGC_COMMAND_BATCHES = 1 << 0, ///< The client understands #PACKET_SERVER_COMMANDS.
+	NGC_COMPRESSED_STREAM = 1 << 1, ///< The client can decompress the packets from the server, see network_compression.h.
+};
+DECLARE_ENUM_AS_BIT_SET(NetworkGameCapabilities)
+
 /** Packet that wraps a command */
 struct CommandPacket;
 
@@ -169,6 +178,7 @@ protected:
 	 * Try to join the server:
 	 * string   OpenTTD revision (norev0000 if no revision).
 	 * uint32_t NewGRF version (added in 1.2).
+	 * uint32_t #NetworkGameCapabilities of the client (added in 15).
 	 * string   Name of the client (max NETWORK_NAME_LENGTH) (removed in 15).
 	 * uint8_t  ID of the company to play as (1..MAX_COMPANIES) (removed in 15).
 	 * uint8_t  ID of the clients Language (removed in 15).
@@ -262,6 +272,7 @@ protected:
 	 * uint32_t  Own client ID.
 	 * uint32_t  Generation seed.
 	 * string  Network ID of the server.
+	 * bool    Whether the packets after this one are compressed, for clients with #NGC_COMPRESSED_STREAM.
 	 * @param p The packet that was just received.
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_WELCOME(Packet &p);
@@ -335,6 +346,8 @@ protected:
 	 * uint32_t  Frame counter.
 	 * uint32_t  General seed 1.
 	 * uint32_t  General seed 2 (dependent on compile settings, not default).
+	 * uint8_t   Number of game state hashes, only when the server has network.sync_state_hash enabled, followed by:
+	 *   uint64_t  Hash of each part of the game state (see #StateHashSection).
 	 * @param p The packet that was just received.
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_SYNC(Packet &p);
@@ -370,6 +383,14 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_COMMAND(Packet &p);
 
+	/**
+	 * Sends several DoCommands to the client, which are all after each other
+	 * in the same format as in #PACKET_SERVER_COMMAND. Only sent to clients
+	 * that announced #NGC_COMMAND_BATCHES.
+	 * @param p The packet that was just received.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_COMMANDS(Packet &p);
+
 	/**
 	 * Sends a chat-packet to the server:
 	 * uint8_t   ID of the action (see NetworkAction).
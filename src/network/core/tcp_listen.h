@@ -13,6 +13,7 @@
 #define NETWORK_CORE_TCP_LISTEN_H
 
 #include "tcp.h"
+#include "socket_poller.h"
 #include "../network.h"
 #include "../../core/pool_type.hpp"
 #include "../../debug.h"
@@ -28,6 +29,8 @@ template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet>
 class TCPListenHandler {
 	/** List of sockets we listen on. */
 	static SocketList sockets;
+	/** Checks the readiness of the sockets we listen on and of the clients. */
+	static SocketPoller poller;
 
 public:
 	static bool ValidateClient(SOCKET s, NetworkAddress &address)
@@ -100,41 +103,50 @@ public:
 	 */
 	static bool Receive()
 	{
-		fd_set read_fd, write_fd;
-		struct timeval tv;
-
-		FD_ZERO(&read_fd);
-		FD_ZERO(&write_fd);
-
-
 		for (Tsocket *cs : Tsocket::Iterate()) {
-			FD_SET(cs->sock, &read_fd);
-			FD_SET(cs->sock, &write_fd);
+			poller.Watch(cs->sock, true);
 		}
 
 		/* take care of listener port */
 		for (auto &s : sockets) {
-			FD_SET(s.first, &read_fd);
+			poller.Watch(s.first, false);
 		}
 
-		tv.tv_sec = tv.tv_usec = 0; // don't block at all.
-		if (select(FD_SETSIZE, &read_fd, &write_fd, nullptr, &tv) < 0) return false;
+		if (!poller.Poll()) return false;
 
 		/* accept clients.. */
 		for (auto &s : sockets) {
-			if (FD_ISSET(s.first, &read_fd)) AcceptClient(s.first);
+			if ((poller.GetReadiness(s.first) & SR_READ) != SR_NONE) AcceptClient(s.first);
 		}
 
 		/* read stuff from clients */
 		for (Tsocket *cs : Tsocket::Iterate()) {
-			cs->writable = !!FD_ISSET(cs->sock, &write_fd);
-			if (FD_ISSET(cs->sock, &read_fd)) {
+			SocketReadiness readiness = poller.GetReadiness(cs->sock);
+			cs->writable = (readiness & SR_WRITE) != SR_NONE;
+			if ((readiness & SR_READ) != SR_NONE) {
 				cs->ReceivePackets();
 			}
 		}
 		return _networking;
 	}
 
+	/**
+	 * Wait until a client connects or one of the clients sends something.
+	 * The actual handling is left to the next #Receive.
+	 * @param timeout The maximum time to wait.
+	 */
+	static void Wait(std::chrono::milliseconds timeout)
+	{
+		for (Tsocket *cs : Tsocket::Iterate()) {
+			poller.Watch(cs->sock, false);
+		}
+		for (auto &s : sockets) {
+			poller.Watch(s.first, false);
+		}
+
+		poller.Poll(timeout);
+	}
+
 	/**
 	 * Listen on a particular port.
 	 * @param port The port to listen on.
@@ -167,10 +179,13 @@ public:
 			closesocket(s.first);
 		}
 		sockets.clear();
+		/* The client sockets get closed as well, and new ones could get the same numbers before the next poll. */
+		poller.Clear();
 		Debug(net, 5, "[{}] Closed listeners", Tsocket::GetName());
 	}
 };
 
 template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet> SocketList TCPListenHandler<Tsocket, Tfull_packet, Tban_packet>::sockets;
+template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet> SocketPoller TCPListenHandler<Tsocket, Tfull_packet, Tban_packet>::poller;
 
 #endif /* NETWORK_CORE_TCP_LISTEN_H */
@@ -45,8 +45,46 @@
 
 #ifdef DEBUG_DUMP_COMMANDS
 #include "../fileio_func.h"
+#include "../openttd.h"
 /** When running the server till the wait point, run as fast as we can! */
 bool _ddc_fastforward = true;
+
+/** Timings of the game loop while replaying the commands.log, to compare the performance of builds. */
+struct ReplayTimings {
+	static const uint BUCKETS = 8; ///< Number of buckets in the histogram; the first one is for ticks up to a quarter of a millisecond, each next one doubles that.
+
+	uint64_t ticks = 0;                             ///< Number of replayed ticks.
+	std::chrono::steady_clock::duration total{};    ///< Total time spent in the replayed ticks.
+	std::chrono::steady_clock::duration max{};      ///< Time spent in the slowest tick.
+	std::array<uint64_t, BUCKETS> histogram{};      ///< Number of ticks per duration range.
+
+	/**
+	 * Account for one replayed tick.
+	 * @param duration Time spent in the tick.
+	 */
+	void Add(std::chrono::steady_clock::duration duration)
+	{
+		this->ticks++;
+		this->total += duration;
+		this->max = std::max(this->max, duration);
+
+		uint bucket = 0;
+		for (auto limit = std::chrono::microseconds(250); bucket < BUCKETS - 1 && duration >= limit; limit *= 2) bucket++;
+		this->histogram[bucket]++;
+	}
+
+	/** Write the timings to the desync debug output. */
+	void Report() const
+	{
+		if (this->ticks == 0) return;
+		auto us = [](std::chrono::steady_clock::duration d) { return std::chrono::duration_cast<std::chrono::microseconds>(d).count(); };
+		Debug(desync, 0, "Replayed {} ticks in {} us; mean {} us, max {} us per tick", this->ticks, us(this->total), us(this->total) / this->ticks, us(this->max));
+		Debug(desync, 0, "Tick histogram (<250 us, doubling per bucket): {}", fmt::join(this->histogram, ", "));
+	}
+};
+
+/** Timings of the replay of the commands.log. */
+static ReplayTimings _ddc_timings;
 #endif /* DEBUG_DUMP_COMMANDS */
 
 /** Make sure both pools have the same size. */
@@ -78,6 +116,7 @@ uint32_t _sync_seed_1;                  ///< Seed to compare during sync checks.
 uint32_t _sync_seed_2;                  ///< Second part of the seed.
 #endif
 uint32_t _sync_frame;                   ///< The frame to perform the sync check.
+std::optional<StateHashes> _sync_state_hashes; ///< Hashes of the game state at the sync check, if the server sends them.
 bool _network_first_time;             ///< Whether we have finished joining or not.
 CompanyMask _network_company_passworded; ///< Bitmask of the password status of all companies.
 
@@ -322,14 +361,16 @@ void NetworkTextMessage(NetworkAction action, TextColour colour, bool self_send,
 /* Calculate the frame-lag of a client */
 uint NetworkCalculateLag(const NetworkClientSocket *cs)
 {
-	int lag = cs->last_frame_server - cs->last_frame;
+	/* Delayed spectators get their frames this much later, on purpose. */
+	int delay = cs->IsDelayedSpectator() ? _settings_client.network.spectator_frame_freq : 0;
+	int lag = cs->last_frame_server - cs->last_frame - delay;
 	/* This client has missed their ACK packet after 1 DAY_TICKS..
 	 *  so we increase their lag for every frame that passes!
 	 * The packet can be out by a max of _net_frame_freq */
-	if (cs->last_frame_server + Ticks::DAY_TICKS + _settings_client.network.frame_freq < _frame_counter) {
-		lag += _frame_counter - (cs->last_frame_server + Ticks::DAY_TICKS + _settings_client.network.frame_freq);
+	if (cs->last_frame_server + Ticks::DAY_TICKS + _settings_client.network.frame_freq + delay < _frame_counter) {
+		lag += _frame_counter - (cs->last_frame_server + Ticks::DAY_TICKS + _settings_client.network.frame_freq + delay);
 	}
-	return lag;
+	return std::max(lag, 0);
 }
 
 
@@ -638,6 +679,7 @@ void NetworkClose(bool close_admins)
 		}
 		ServerNetworkGameSocketHandler::CloseListeners();
 		ServerNetworkAdminSocketHandler::CloseListeners();
+		NetworkServerForgetMapSnapshot();
 
 		_network_coordinator_client.CloseConnection();
 	} else {
@@ -1226,6 +1268,10 @@ void NetworkGameLoop()
 			Debug(desync, 0, "End of commands.log");
 			fclose(f);
 			f = nullptr;
+
+			_ddc_timings.Report();
+			/* Nobody is going to join a replay without a join point; it is a benchmark run, so stop. */
+			if (_ddc_fastforward) _exit_game = true;
 		}
 #endif /* DEBUG_DUMP_COMMANDS */
 		if (_frame_counter >= _frame_counter_max) {
@@ -1250,7 +1296,13 @@ void NetworkGameLoop()
 		NetworkExecuteLocalCommandQueue();
 
 		/* Then we make the frame */
+#ifdef DEBUG_DUMP_COMMANDS
+		auto tick_start = std::chrono::steady_clock::now();
+		StateGameLoop();
+		_ddc_timings.Add(std::chrono::steady_clock::now() - tick_start);
+#else
 		StateGameLoop();
+#endif /* DEBUG_DUMP_COMMANDS */
 
 		_sync_seed_1 = _random.state[0];
 #ifdef NETWORK_SEND_DOUBLE_SEED
@@ -1277,6 +1329,8 @@ void NetworkGameLoop()
 	}
 
 	NetworkSend();
+
+	if (_network_server) NetworkServerExecuteRconCommands();
 }
 
 static void NetworkGenerateServerId()
@@ -21,7 +21,15 @@
 #include "../core/pool_func.hpp"
 #include "../map_func.h"
 #include "../rev.h"
+#include "../framerate_type.h"
+#include "../vehicle_base.h"
+#include "../station_base.h"
+#include "../town.h"
+#include "../industry.h"
+#include "../order_base.h"
+#include "../cargopacket.h"
 #include "../game/game.hpp"
+#include "../pathfinder/yapf/yapf_stats.h"
 
 #include "../safeguards.h"
 
@@ -54,6 +62,7 @@ static const AdminUpdateFrequency _admin_update_type_frequencies[] = {
 	ADMIN_FREQUENCY_POLL,                                                                                                                                  ///< ADMIN_UPDATE_CMD_NAMES
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_CMD_LOGGING
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_GAMESCRIPT
+	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_PERFORMANCE
 };
 /** Sanity check. */
 static_assert(lengthof(_admin_update_type_frequencies) == ADMIN_UPDATE_END);
@@ -437,6 +446,86 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCompanyStats()
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Send the performance measurements, the sizes of the game and the vehicle and
+ * station counts of the companies; all in one packet, so it can be sent often.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendPerformance()
+{
+	auto p = std::make_unique<Packet>(this, ADMIN_PACKET_SERVER_PERFORMANCE);
+
+	p->Send_uint32(_frame_counter);
+
+	/* Average the durations over the ticks since the previous update. */
+	p->Send_uint8(PFE_MAX);
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		double rate, duration;
+		if (GetPerformanceMeasurement(e, _settings_client.network.admin_performance_interval, rate, duration)) {
+			p->Send_uint32(static_cast<uint32_t>(std::clamp(rate * 1000, 0.0, UINT32_MAX - 1.0)));
+			p->Send_uint32(static_cast<uint32_t>(std::clamp(duration * 1000, 0.0, UINT32_MAX - 1.0)));
+		} else {
+			p->Send_uint32(UINT32_MAX);
+			p->Send_uint32(UINT32_MAX);
+		}
+	}
+
+	const size_t pool_sizes[] = {
+		Vehicle::GetNumItems(), BaseStation::GetNumItems(), Town::GetNumItems(),
+		Industry::GetNumItems(), Order::GetNumItems(), CargoPacket::GetNumItems(),
+	};
+	p->Send_uint8(static_cast<uint8_t>(std::size(pool_sizes)));
+	for (size_t size : pool_sizes) p->Send_uint32(ClampTo<uint32_t>(size));
+
+	NetworkCompanyStats company_stats[MAX_COMPANIES];
+	NetworkPopulateCompanyStats(company_stats);
+
+	p->Send_uint8(static_cast<uint8_t>(Company::GetNumItems()));
+	for (const Company *company : Company::Iterate()) {
+		p->Send_uint8(company->index);
+		for (uint i = 0; i < NETWORK_VEH_END; i++) p->Send_uint16(company_stats[company->index].num_vehicle[i]);
+		for (uint i = 0; i < NETWORK_VEH_END; i++) p->Send_uint16(company_stats[company->index].num_station[i]);
+	}
+
+	/* The time attributed to the companies, if accounted. */
+	p->Send_uint8(_company_performance_accounting ? static_cast<uint8_t>(Company::GetNumItems()) : 0);
+	if (_company_performance_accounting) {
+		for (const Company *company : Company::Iterate()) {
+			p->Send_uint8(company->index);
+			for (uint e = 0; e < CPE_MAX; e++) {
+				double duration = GetCompanyPerformanceMilliseconds(company->index, static_cast<CompanyPerformanceElement>(e));
+				p->Send_uint32(static_cast<uint32_t>(std::clamp(duration * 1000, 0.0, UINT32_MAX - 1.0)));
+			}
+		}
+	}
+
+	/* The totals of the pathfinder searches, and the slowest of them. */
+	p->Send_uint8(YAPF_STATS_TYPES);
+	for (uint type = 0; type < YAPF_STATS_TYPES; type++) {
+		YapfSearchStats stats = GetYapfSearchStats(static_cast<VehicleType>(type));
+		p->Send_uint64(stats.searches);
+		p->Send_uint64(stats.nodes);
+		p->Send_uint64(stats.cache_hits);
+		p->Send_uint64(stats.cache_misses);
+		p->Send_uint64(stats.total_us);
+		p->Send_uint32(ClampTo<uint32_t>(stats.max_us));
+	}
+
+	std::vector<YapfSlowSearch> slow_searches = GetYapfSlowSearches();
+	p->Send_uint8(static_cast<uint8_t>(slow_searches.size()));
+	for (const YapfSlowSearch &search : slow_searches) {
+		p->Send_uint8(search.type);
+		p->Send_uint32(search.vehicle);
+		p->Send_uint32(search.origin.base());
+		p->Send_uint32(search.destination.base());
+		p->Send_uint32(search.nodes);
+		p->Send_uint32(ClampTo<uint32_t>(search.us));
+	}
+
+	this->SendPacket(std::move(p));
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Send a chat message.
  * @param action The action associated with the message.
@@ -737,6 +826,11 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_POLL(Packet &p)
 			this->SendCmdNames();
 			break;
 
+		case ADMIN_UPDATE_PERFORMANCE:
+			/* The admin is requesting the performance measurements. */
+			this->SendPerformance();
+			break;
+
 		default:
 			/* An unsupported "poll" update type. */
 			Debug(net, 1, "[admin] Not supported poll {} ({}) from '{}' ({}).", type, d1, this->admin_name, this->admin_version);
@@ -1006,3 +1100,16 @@ void NetworkAdminUpdate(AdminUpdateFrequency freq)
 		}
 	}
 }
+
+/**
+ * Send the performance measurements to the admins that want them, every
+ * network.admin_performance_interval ticks.
+ */
+void NetworkAdminTick()
+{
+	if (_frame_counter % _settings_client.network.admin_performance_interval != 0) return;
+
+	for (ServerNetworkAdminSocketHandler *as : ServerNetworkAdminSocketHandler::IterateActive()) {
+		if (as->update_frequency[ADMIN_UPDATE_PERFORMANCE] & ADMIN_FREQUENCY_AUTOMATIC) as->SendPerformance();
+	}
+}
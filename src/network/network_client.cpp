@@ -261,6 +261,26 @@ void ClientNetworkGameSocketHandler::ClientError(NetworkRecvStatus res)
 	if (my_client != nullptr) my_client->CheckConnection();
 }
 
+/**
+ * Compare the hashes of the game state with those of the server, and log the parts that differ.
+ * @param server_hashes The hashes of the server at this frame.
+ * @return True iff all hashes are the same.
+ */
+static bool CheckStateHashes(const StateHashes &server_hashes)
+{
+	StateHashes hashes = CalculateStateHashes();
+	bool same = true;
+	for (uint i = 0; i < SHS_END; i++) {
+		if (hashes[i] == server_hashes[i]) continue;
+
+		std::string name = GetStateHashSectionName(static_cast<StateHashSection>(i));
+		Debug(desync, 0, "state hash mismatch: frame {}, {}: {:016x} instead of {:016x}", _frame_counter, name, hashes[i], server_hashes[i]);
+		Debug(net, 0, "Game state differs from the server in the {}", name);
+		same = false;
+	}
+	return same;
+}
+
 /**
  * Actual game loop for the client.
  * @return Whether everything went okay, or not.
@@ -277,10 +297,14 @@ void ClientNetworkGameSocketHandler::ClientError(NetworkRecvStatus res)
 	if (_sync_frame != 0) {
 		if (_sync_frame == _frame_counter) {
 #ifdef NETWORK_SEND_DOUBLE_SEED
-			if (_sync_seed_1 != _random.state[0] || _sync_seed_2 != _random.state[1]) {
+			bool in_sync = _sync_seed_1 == _random.state[0] && _sync_seed_2 == _random.state[1];
 #else
-			if (_sync_seed_1 != _random.state[0]) {
+			bool in_sync = _sync_seed_1 == _random.state[0];
 #endif
+			/* With the hashes of the server the game state itself is compared, logging which part of it differs. */
+			if (_sync_state_hashes.has_value() && !CheckStateHashes(*_sync_state_hashes)) in_sync = false;
+
+			if (!in_sync) {
 				ShowNetworkError(STR_NETWORK_ERROR_DESYNC);
 				Debug(desync, 1, "sync_err: {:08x}; {:02x}", TimerGameEconomy::date, TimerGameEconomy::date_fract);
 				Debug(net, 0, "Sync error detected");
@@ -347,6 +371,7 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::SendJoin()
 	auto p = std::make_unique<Packet>(my_client, PACKET_CLIENT_JOIN);
 	p->Send_string(GetNetworkRevisionString());
 	p->Send_uint32(_openttd_newgrf_version);
+	p->Send_uint32(NGC_COMMAND_BATCHES | (IsNetworkCompressionAvailable() ? NGC_COMPRESSED_STREAM : NGC_NONE));
 	my_client->SendPacket(std::move(p));
 
 	return NETWORK_RECV_STATUS_OKAY;
@@ -835,6 +860,12 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::Receive_SERVER_WELCOME(Packet
 	_password_game_seed = p.Recv_uint32();
 	_password_server_id = p.Recv_string(NETWORK_SERVER_ID_LENGTH);
 
+	/* Servers that do not know about compression do not send whether they use it. */
+	if (p.CanReadFromPacket(sizeof(bool)) && p.Recv_bool()) {
+		this->receive_compression_handler = CreateNetworkDecompressionHandler();
+		if (this->receive_compression_handler == nullptr) return NETWORK_RECV_STATUS_MALFORMED_PACKET;
+	}
+
 	/* Start receiving the map */
 	return SendGetMap();
 }
@@ -1011,6 +1042,14 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::Receive_SERVER_SYNC(Packet &p)
 	_sync_seed_2 = p.Recv_uint32();
 #endif
 
+	/* The hashes of the game state, when the server has them enabled. */
+	_sync_state_hashes.reset();
+	if (p.CanReadFromPacket(sizeof(uint8_t))) {
+		if (p.Recv_uint8() != SHS_END) return NETWORK_RECV_STATUS_MALFORMED_PACKET;
+		StateHashes &hashes = _sync_state_hashes.emplace();
+		for (uint64_t &hash : hashes) hash = p.Recv_uint64();
+	}
+
 	Debug(net, 9, "Client::Receive_SERVER_SYNC(): sync_frame={}, sync_seed_1={}", _sync_frame, _sync_seed_1);
 
 	return NETWORK_RECV_STATUS_OKAY;
@@ -1037,6 +1076,17 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::Receive_SERVER_COMMAND(Packet
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+NetworkRecvStatus ClientNetworkGameSocketHandler::Receive_SERVER_COMMANDS(Packet &p)
+{
+	/* The commands are just after each other, so read them like a single command until the packet is done. */
+	while (p.CanReadFromPacket(1)) {
+		NetworkRecvStatus res = this->Receive_SERVER_COMMAND(p);
+		if (res != NETWORK_RECV_STATUS_OKAY) return res;
+	}
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 NetworkRecvStatus ClientNetworkGameSocketHandler::Receive_SERVER_CHAT(Packet &p)
 {
 	if (this->status != STATUS_ACTIVE) return NETWORK_RECV_STATUS_MALFORMED_PACKET;
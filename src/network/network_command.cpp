@@ -169,6 +169,10 @@ static constexpr auto _cmd_dispatch = MakeDispatchTable(std::make_integer_sequen
 static CommandQueue _local_wait_queue;
 /** Local queue of packets waiting for execution. */
 static CommandQueue _local_execution_queue;
+/** Packets to execute since the last map snapshot for joining clients was made. */
+static CommandQueue _snapshot_command_log;
+/** Whether the distributed packets are added to #_snapshot_command_log. */
+static bool _snapshot_command_logging = false;
 
 
 /**
@@ -223,20 +227,44 @@ void NetworkSendCommand(Commands cmd, StringID err_message, CommandCallback *cal
 }
 
 /**
- * Sync our local command queue to the command queue of the given
- * socket. This is needed for the case where we receive a command
- * before saving the game for a joining client, but without the
- * execution of those commands. Not syncing those commands means
- * that the client will never get them and as such will be in a
- * desynced state from the time it started with joining.
+ * Sync the commands since the map snapshot for joining clients was made to
+ * the command queue of the given socket. This is needed for the case where
+ * we receive a command before saving the game for a joining client, but
+ * without the execution of those commands, and for the commands that were
+ * executed since a snapshot the client starts with was made. Not syncing
+ * those commands means that the client will never get them and as such
+ * will be in a desynced state from the time it started with joining.
  * @param cs The client to sync the queue to.
  */
 void NetworkSyncCommandQueue(NetworkClientSocket *cs)
 {
+	assert(_snapshot_command_logging);
+
+	for (auto &p : _snapshot_command_log) {
+		cs->outgoing_queue.push_back(p);
+	}
+}
+
+/**
+ * Start logging the commands for the clients joining with a map snapshot
+ * that is made this frame, beginning with the commands that are waiting
+ * for their execution.
+ */
+void NetworkStartCommandLog()
+{
+	_snapshot_command_log.clear();
 	for (auto &p : _local_execution_queue) {
-		CommandPacket &c = cs->outgoing_queue.emplace_back(p);
+		CommandPacket &c = _snapshot_command_log.emplace_back(p);
 		c.callback = nullptr;
 	}
+	_snapshot_command_logging = true;
+}
+
+/** Stop logging the commands, as no client is going to join with the last map snapshot anymore. */
+void NetworkStopCommandLog()
+{
+	_snapshot_command_log.clear();
+	_snapshot_command_logging = false;
 }
 
 /**
@@ -302,6 +330,12 @@ static void DistributeCommandPacket(CommandPacket &cp, const NetworkClientSocket
 		}
 	}
 
+	if (_snapshot_command_logging) {
+		CommandPacket &c = _snapshot_command_log.emplace_back(cp);
+		c.callback = nullptr;
+		c.my_cmd = false;
+	}
+
 	cp.callback = (nullptr != owner) ? nullptr : callback;
 	cp.my_cmd = (nullptr == owner);
 	_local_execution_queue.push_back(cp);
@@ -0,0 +1,141 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file network_compression.cpp Implementation of the compression of the packets of a connection. */
+
+#include "../stdafx.h"
+#include "network_compression.h"
+
+#if defined(WITH_ZSTD)
+#include <zstd.h>
+#endif
+
+#include "../safeguards.h"
+
+#if defined(WITH_ZSTD)
+
+/** Compression level of the stream; the packets are small and have to go out every frame. */
+static const int NETWORK_COMPRESSION_LEVEL = 1;
+/** Logarithm of the window size, which limits the memory each connection needs. */
+static const int NETWORK_COMPRESSION_WINDOW_LOG = 17;
+
+/** Compress the packets with a Zstandard stream. */
+class ZstdCompressionHandler : public NetworkCompressionHandler {
+	ZSTD_CCtx *context;          ///< The compression stream.
+	std::vector<uint8_t> output; ///< Buffer for the compressed data.
+
+public:
+	ZstdCompressionHandler() : context(ZSTD_createCCtx())
+	{
+		ZSTD_CCtx_setParameter(this->context, ZSTD_c_compressionLevel, NETWORK_COMPRESSION_LEVEL);
+		ZSTD_CCtx_setParameter(this->context, ZSTD_c_windowLog, NETWORK_COMPRESSION_WINDOW_LOG);
+	}
+
+	~ZstdCompressionHandler()
+	{
+		ZSTD_freeCCtx(this->context);
+	}
+
+	bool Process(std::vector<uint8_t> &buffer, size_t offset, size_t limit) override
+	{
+		if (this->context == nullptr || offset > buffer.size() || limit < offset) return false;
+
+		ZSTD_inBuffer input = { buffer.data() + offset, buffer.size() - offset, 0 };
+		this->output.resize(limit - offset);
+		ZSTD_outBuffer out = { this->output.data(), this->output.size(), 0 };
+
+		/* Flush everything, so the receiver can decompress the whole packet right away. */
+		size_t remaining = ZSTD_compressStream2(this->context, &out, &input, ZSTD_e_flush);
+		if (ZSTD_isError(remaining) || remaining != 0) return false;
+
+		buffer.resize(offset + out.pos);
+		std::copy_n(this->output.data(), out.pos, buffer.data() + offset);
+		return true;
+	}
+};
+
+/** Decompress the packets of a Zstandard stream. */
+class ZstdDecompressionHandler : public NetworkCompressionHandler {
+	ZSTD_DCtx *context;          ///< The decompression stream.
+	std::vector<uint8_t> output; ///< Buffer for the decompressed data.
+
+public:
+	ZstdDecompressionHandler() : context(ZSTD_createDCtx())
+	{
+		ZSTD_DCtx_setParameter(this->context, ZSTD_d_windowLogMax, NETWORK_COMPRESSION_WINDOW_LOG);
+	}
+
+	~ZstdDecompressionHandler()
+	{
+		ZSTD_freeDCtx(this->context);
+	}
+
+	bool Process(std::vector<uint8_t> &buffer, size_t offset, size_t limit) override
+	{
+		if (this->context == nullptr || offset > buffer.size() || limit < offset) return false;
+
+		ZSTD_inBuffer input = { buffer.data() + offset, buffer.size() - offset, 0 };
+		this->output.resize(limit - offset);
+		ZSTD_outBuffer out = { this->output.data(), this->output.size(), 0 };
+
+		/* The sender flushed the packet, so all of it comes out; unless it is larger than allowed. */
+		while (input.pos < input.size) {
+			size_t result = ZSTD_decompressStream(this->context, &out, &input);
+			if (ZSTD_isError(result) || (out.pos == out.size && input.pos < input.size)) return false;
+		}
+
+		buffer.resize(offset + out.pos);
+		std::copy_n(this->output.data(), out.pos, buffer.data() + offset);
+		return true;
+	}
+};
+
+/**
+ * Whether this build can compress the packets of a connection.
+ * @return True iff the compression handlers can be created.
+ */
+bool IsNetworkCompressionAvailable()
+{
+	return true;
+}
+
+/**
+ * Create the handler that compresses the packets sent over a connection.
+ * @return The handler, or \c nullptr when compression is not available.
+ */
+std::unique_ptr<NetworkCompressionHandler> CreateNetworkCompressionHandler()
+{
+	return std::make_unique<ZstdCompressionHandler>();
+}
+
+/**
+ * Create the handler that decompresses the packets received over a connection.
+ * @return The handler, or \c nullptr when compression is not available.
+ */
+std::unique_ptr<NetworkCompressionHandler> CreateNetworkDecompressionHandler()
+{
+	return std::make_unique<ZstdDecompressionHandler>();
+}
+
+#else
+
+bool IsNetworkCompressionAvailable()
+{
+	return false;
+}
+
+std::unique_ptr<NetworkCompressionHandler> CreateNetworkCompressionHandler()
+{
+	return nullptr;
+}
+
+std::unique_ptr<NetworkCompressionHandler> CreateNetworkDecompressionHandler()
+{
+	return nullptr;
+}
+
+#endif /* WITH_ZSTD */
@@ -0,0 +1,45 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file network_compression.h Compression of the packets of a connection as one stream.
+ *
+ * The packets of a connection are compressed one after another with the same
+ * compression context, so a packet that looks like an earlier one, like the
+ * frame packets, takes only a few bytes. Each packet is flushed completely, so
+ * it can be decompressed as soon as it is received. Packets are compressed
+ * before they are encrypted, and decompressed after they are decrypted.
+ */
+
+#ifndef NETWORK_COMPRESSION_H
+#define NETWORK_COMPRESSION_H
+
+/** Number of bytes compressing the data of a packet may add to it at most. */
+static const size_t NETWORK_COMPRESSION_OVERHEAD = 512;
+
+/**
+ * Compression or decompression of the packets of one direction of a connection.
+ */
+class NetworkCompressionHandler {
+public:
+	virtual ~NetworkCompressionHandler() {}
+
+	/**
+	 * Compress or decompress the data of the next packet in-place.
+	 * @param buffer The buffer of the packet.
+	 * @param offset Position in the buffer where the data to process starts.
+	 * @param limit  Maximum size of the buffer after processing the data.
+	 * @return Whether the data could be processed.
+	 */
+	virtual bool Process(std::vector<uint8_t> &buffer, size_t offset, size_t limit) = 0;
+};
+
+bool IsNetworkCompressionAvailable();
+std::unique_ptr<NetworkCompressionHandler> CreateNetworkCompressionHandler();
+std::unique_ptr<NetworkCompressionHandler> CreateNetworkDecompressionHandler();
+
+#endif /* NETWORK_COMPRESSION_H */
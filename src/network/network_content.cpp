@@ -488,7 +488,7 @@ bool ClientNetworkContentSocketHandler::Receive_SERVER_CONTENT(Packet &p)
 		this->curInfo->filesize = p.Recv_uint32();
 		this->curInfo->filename = p.Recv_string(NETWORK_CONTENT_FILENAME_LENGTH);
 
-		if (!this->BeforeDownload()) {
+		if (!this->BeforeDownload(this->curInfo, this->curFile)) {
 			this->CloseConnection();
 			return false;
 		}
@@ -507,7 +507,7 @@ bool ClientNetworkContentSocketHandler::Receive_SERVER_CONTENT(Packet &p)
 
 		this->OnDownloadProgress(this->curInfo, (int)toRead);
 
-		if (toRead == 0) this->AfterDownload();
+		if (toRead == 0) this->AfterDownload(this->curInfo, this->curFile);
 	}
 
 	return true;
@@ -515,20 +515,18 @@ bool ClientNetworkContentSocketHandler::Receive_SERVER_CONTENT(Packet &p)
 
 /**
  * Handle the opening of the file before downloading.
+ * @param ci The content to download.
+ * @param[out] file The opened file, or nullptr when there is nothing to download.
  * @return false on any error.
  */
-bool ClientNetworkContentSocketHandler::BeforeDownload()
+bool ClientNetworkContentSocketHandler::BeforeDownload(const ContentInfo *ci, FILE *&file)
 {
-	if (!this->curInfo->IsValid()) {
-		delete this->curInfo;
-		this->curInfo = nullptr;
-		return false;
-	}
+	if (!ci->IsValid()) return false;
 
-	if (this->curInfo->filesize != 0) {
+	if (ci->filesize != 0) {
 		/* The filesize is > 0, so we are going to download it */
-		std::string filename = GetFullFilename(this->curInfo, true);
-		if (filename.empty() || (this->curFile = fopen(filename.c_str(), "wb")) == nullptr) {
+		std::string filename = GetFullFilename(ci, true);
+		if (filename.empty() || (file = fopen(filename.c_str(), "wb")) == nullptr) {
 			/* Unless that fails of course... */
 			CloseWindowById(WC_NETWORK_STATUS_WINDOW, WN_NETWORK_STATUS_WINDOW_CONTENT_DOWNLOAD);
 			ShowErrorMessage(STR_CONTENT_ERROR_COULD_NOT_DOWNLOAD, STR_CONTENT_ERROR_COULD_NOT_DOWNLOAD_FILE_NOT_WRITABLE, WL_ERROR);
@@ -541,25 +539,27 @@ bool ClientNetworkContentSocketHandler::BeforeDownload()
 /**
  * Handle the closing and extracting of a file after
  * downloading it has been done.
+ * @param ci The downloaded content.
+ * @param file The file the content got written to; it gets closed.
  */
-void ClientNetworkContentSocketHandler::AfterDownload()
+void ClientNetworkContentSocketHandler::AfterDownload(const ContentInfo *ci, FILE *&file)
 {
 	/* We read nothing; that's our marker for end-of-stream.
 	 * Now gunzip the tar and make it known. */
-	fclose(this->curFile);
-	this->curFile = nullptr;
+	fclose(file);
+	file = nullptr;
 
-	if (GunzipFile(this->curInfo)) {
-		unlink(GetFullFilename(this->curInfo, true).c_str());
+	if (GunzipFile(ci)) {
+		unlink(GetFullFilename(ci, true).c_str());
 
-		Subdirectory sd = GetContentInfoSubDir(this->curInfo->type);
+		Subdirectory sd = GetContentInfoSubDir(ci->type);
 		if (sd == NO_DIRECTORY) NOT_REACHED();
 
 		TarScanner ts;
-		std::string fname = GetFullFilename(this->curInfo, false);
+		std::string fname = GetFullFilename(ci, false);
 		ts.AddFile(sd, fname);
 
-		if (this->curInfo->type == CONTENT_TYPE_BASE_MUSIC) {
+		if (ci->type == CONTENT_TYPE_BASE_MUSIC) {
 			/* Music can't be in a tar. So extract the tar! */
 			ExtractTar(fname, BASESET_DIR);
 			unlink(fname.c_str());
@@ -569,12 +569,138 @@ void ClientNetworkContentSocketHandler::AfterDownload()
 		EM_ASM(if (window["openttd_syncfs"]) openttd_syncfs());
 #endif
 
-		this->OnDownloadComplete(this->curInfo->id);
+		this->OnDownloadComplete(ci->id);
 	} else {
 		ShowErrorMessage(STR_CONTENT_ERROR_COULD_NOT_EXTRACT, INVALID_STRING_ID, WL_ERROR);
 	}
 }
 
+/**
+ * Start downloading the next files over HTTP, as many at the same time as allowed.
+ */
+void ClientNetworkContentSocketHandler::StartHTTPDownloads()
+{
+	uint active = 0;
+	for (const auto &download : this->http_downloads) {
+		if (download->info != nullptr) active++;
+	}
+
+	while (!this->http_failed && !this->isCancelled && !this->http_files.empty() && active < _settings_client.network.content_download_connections) {
+		auto [info, url] = std::move(this->http_files.front());
+		this->http_files.pop_front();
+
+		FILE *file = nullptr;
+		if (!this->BeforeDownload(info.get(), file)) {
+			this->http_failed = true;
+			break;
+		}
+
+		auto it = std::ranges::find_if(this->http_downloads, [](const auto &download) { return download->info == nullptr; });
+		ContentHTTPDownload *download = it != this->http_downloads.end() ? it->get() : this->http_downloads.emplace_back(std::make_unique<ContentHTTPDownload>(this)).get();
+		download->info = std::move(info);
+		download->url = std::move(url);
+		download->file = file;
+		download->received = 0;
+		download->resumes = 0;
+		active++;
+
+		NetworkHTTPSocketHandler::Connect(download->url, download);
+	}
+}
+
+/**
+ * When all downloads over HTTP are done, download whatever is left via the
+ * fallback; content without an HTTP mirror, or content that failed.
+ */
+void ClientNetworkContentSocketHandler::CheckHTTPDownloadsDone()
+{
+	if (!this->http_downloading) return;
+	for (const auto &download : this->http_downloads) {
+		if (download->info != nullptr) return;
+	}
+	if (!this->http_failed && !this->isCancelled && !this->http_files.empty()) return;
+
+	this->http_downloading = false;
+	this->http_files.clear();
+
+	if (!this->isCancelled) {
+		uint files, bytes;
+
+		this->DownloadSelectedContent(files, bytes, true);
+	}
+}
+
+ContentHTTPDownload::~ContentHTTPDownload()
+{
+	if (this->file != nullptr) fclose(this->file);
+}
+
+bool ContentHTTPDownload::IsCancelled() const
+{
+	return this->owner->isCancelled;
+}
+
+void ContentHTTPDownload::OnFailure()
+{
+	if (this->info == nullptr) return;
+
+	/* Continue where the download got interrupted, unless writing the file failed. */
+	if (this->file != nullptr && this->received != 0 && this->resumes < MAX_RESUMES && !this->owner->isCancelled) {
+		this->resumes++;
+		Debug(net, 1, "Resuming download of {} at byte {}", this->info->filename, this->received);
+		NetworkHTTPSocketHandler::Connect(this->url, this, "", this->received);
+		return;
+	}
+
+	this->owner->OnDownloadProgress(this->info.get(), -1);
+
+	if (this->file != nullptr) {
+		fclose(this->file);
+		this->file = nullptr;
+	}
+	this->info.reset();
+
+	this->owner->http_failed = true;
+	this->owner->CheckHTTPDownloadsDone();
+}
+
+void ContentHTTPDownload::OnReceiveData(std::unique_ptr<char[]> data, size_t length)
+{
+	assert(data.get() == nullptr || length != 0);
+
+	if (this->info == nullptr) return;
+
+	if (data != nullptr) {
+		/* After writing failed, ignore the rest; the request fails at its end. */
+		if (this->file == nullptr) return;
+
+		if (fwrite(data.get(), 1, length, this->file) != length) {
+			fclose(this->file);
+			this->file = nullptr;
+			return;
+		}
+
+		this->received += length;
+		this->owner->OnDownloadProgress(this->info.get(), (int)length);
+		return;
+	}
+
+	if (this->file == nullptr && this->info->filesize != 0) {
+		/* Writing failed somehow, let the fallback try. */
+		this->OnFailure();
+		return;
+	}
+
+	std::unique_ptr<ContentInfo> info = std::move(this->info);
+	FILE *file = this->file;
+	this->file = nullptr;
+
+	/* Request the next file before unpacking this one, so it downloads in the meantime. */
+	this->owner->StartHTTPDownloads();
+	if (file != nullptr) this->owner->AfterDownload(info.get(), file);
+	this->owner->CheckHTTPDownloadsDone();
+}
+
 bool ClientNetworkContentSocketHandler::IsCancelled() const
 {
 	return this->isCancelled;
@@ -587,13 +713,6 @@ void ClientNetworkContentSocketHandler::OnFailure()
 	this->http_response.shrink_to_fit();
 	this->http_response_index = -2;
 
-	if (this->curFile != nullptr) {
-		this->OnDownloadProgress(this->curInfo, -1);
-
-		fclose(this->curFile);
-		this->curFile = nullptr;
-	}
-
 	/* If we fail, download the rest via the 'old' system. */
 	if (!this->isCancelled) {
 		uint files, bytes;
@@ -611,57 +730,25 @@ void ClientNetworkContentSocketHandler::OnReceiveData(std::unique_ptr<char[]> da
 		return;
 	}
 
-	if (this->http_response_index == -1) {
-		if (data != nullptr) {
-			/* Append the rest of the response. */
-			this->http_response.insert(this->http_response.end(), data.get(), data.get() + length);
-			return;
-		} else {
-			/* Make sure the response is properly terminated. */
-			this->http_response.push_back('\0');
-
-			/* And prepare for receiving the rest of the data. */
-			this->http_response_index = 0;
-		}
-	}
-
 	if (data != nullptr) {
-		/* We have data, so write it to the file. */
-		if (fwrite(data.get(), 1, length, this->curFile) != length) {
-			/* Writing failed somehow, let try via the old method. */
-			this->OnFailure();
-		} else {
-			/* Just received the data. */
-			this->OnDownloadProgress(this->curInfo, (int)length);
-		}
-
-		/* Nothing more to do now. */
+		/* Append the rest of the response. */
+		this->http_response.insert(this->http_response.end(), data.get(), data.get() + length);
 		return;
 	}
 
-	if (this->curFile != nullptr) {
-		/* We've finished downloading a file. */
-		this->AfterDownload();
-	}
-
-	if ((uint)this->http_response_index >= this->http_response.size()) {
-		/* It's not a real failure, but if there's
-		 * nothing more to download it helps with
-		 * cleaning up the stuff we allocated. */
-		this->OnFailure();
-		return;
-	}
+	/* Make sure the response is properly terminated. */
+	this->http_response.push_back('\0');
+	this->http_response_index = 0;
 
-	delete this->curInfo;
-	/* When we haven't opened a file this must be our first packet with metadata. */
-	this->curInfo = new ContentInfo;
+	std::deque<std::pair<std::unique_ptr<ContentInfo>, std::string>> files;
 
 /** Check p for not being null and return calling OnFailure if that's not the case. */
 #define check_not_null(p) { if ((p) == nullptr) { this->OnFailure(); return; } }
 /** Check p for not being null and then terminate, or return calling OnFailure. */
 #define check_and_terminate(p) { check_not_null(p); *(p) = '\0'; }
 
-	for (;;) {
+	/* The last byte is the terminator we added. */
+	while ((size_t)this->http_response_index + 1 < this->http_response.size()) {
 		char *str = this->http_response.data() + this->http_response_index;
 		char *p = strchr(str, '\n');
 		check_and_terminate(p);
@@ -669,34 +756,29 @@ void ClientNetworkContentSocketHandler::OnReceiveData(std::unique_ptr<char[]> da
 		/* Update the index for the next one */
 		this->http_response_index += (int)strlen(str) + 1;
 
+		auto info = std::make_unique<ContentInfo>();
+
 		/* Read the ID */
 		p = strchr(str, ',');
 		check_and_terminate(p);
-		this->curInfo->id = (ContentID)atoi(str);
+		info->id = (ContentID)atoi(str);
 
 		/* Read the type */
 		str = p + 1;
 		p = strchr(str, ',');
 		check_and_terminate(p);
-		this->curInfo->type = (ContentType)atoi(str);
+		info->type = (ContentType)atoi(str);
 
 		/* Read the file size */
 		str = p + 1;
 		p = strchr(str, ',');
 		check_and_terminate(p);
-		this->curInfo->filesize = atoi(str);
+		info->filesize = atoi(str);
 
 		/* Read the URL */
 		str = p + 1;
 		/* Is it a fallback URL? If so, just continue with the next one. */
-		if (strncmp(str, "ottd", 4) == 0) {
-			if ((uint)this->http_response_index >= this->http_response.size()) {
-				/* Have we gone through all lines? */
-				this->OnFailure();
-				return;
-			}
-			continue;
-		}
+		if (strncmp(str, "ottd", 4) == 0) continue;
 
 		p = strrchr(str, '/');
 		check_not_null(p);
@@ -714,20 +796,24 @@ void ClientNetworkContentSocketHandler::OnReceiveData(std::unique_ptr<char[]> da
 		}
 
 		/* Copy the string, without extension, to the filename. */
-		this->curInfo->filename = std::move(filename);
-
-		/* Request the next file. */
-		if (!this->BeforeDownload()) {
-			this->OnFailure();
-			return;
-		}
+		info->filename = std::move(filename);
 
-		NetworkHTTPSocketHandler::Connect(str, this);
-		return;
+		files.emplace_back(std::move(info), str);
 	}
 
-#undef check
+#undef check_not_null
 #undef check_and_terminate
+
+	this->http_response.clear();
+	this->http_response.shrink_to_fit();
+	this->http_response_index = -2;
+
+	/* Download the files, a number at the same time. */
+	this->http_files = std::move(files);
+	this->http_downloading = true;
+	this->http_failed = false;
+	this->StartHTTPDownloads();
+	this->CheckHTTPDownloadsDone();
 }
 
 /**
@@ -12,6 +12,7 @@
 
 #include "core/tcp_content.h"
 #include "core/http.h"
+#include <deque>
 #include <unordered_map>
 #include "../core/container_func.hpp"
 
@@ -61,6 +62,29 @@ struct ContentCallback {
 	virtual ~ContentCallback() = default;
 };
 
+class ClientNetworkContentSocketHandler;
+
+/** A file that is downloaded over HTTP; a number of them are downloaded at the same time. */
+class ContentHTTPDownload : public HTTPCallback {
+public:
+	/** How often to resume a download that got interrupted, before giving up. */
+	static constexpr uint MAX_RESUMES = 3;
+
+	ClientNetworkContentSocketHandler *owner; ///< The handler that started the download.
+	std::unique_ptr<ContentInfo> info;        ///< The content being downloaded, or nullptr when this download is idle.
+	std::string url;                          ///< Where to download the content from.
+	FILE *file = nullptr;                     ///< The file being written.
+	size_t received = 0;                      ///< Number of bytes written to the file.
+	uint resumes = 0;                         ///< Number of times the download got resumed.
+
+	ContentHTTPDownload(ClientNetworkContentSocketHandler *owner) : owner(owner) {}
+	~ContentHTTPDownload();
+
+	void OnFailure() override;
+	void OnReceiveData(std::unique_ptr<char[]> data, size_t length) override;
+	bool IsCancelled() const override;
+};
+
 /**
  * Socket handler for the content server connection
  */
@@ -73,6 +97,10 @@ protected:
 	std::unordered_multimap<ContentID, ContentID> reverse_dependency_map; ///< Content reverse dependency map
 	std::vector<char> http_response;              ///< The HTTP response to the requests we've been doing
 	int http_response_index;                      ///< Where we are, in the response, with handling it
+	std::deque<std::pair<std::unique_ptr<ContentInfo>, std::string>> http_files; ///< The content still to download over HTTP, and their URLs.
+	std::vector<std::unique_ptr<ContentHTTPDownload>> http_downloads; ///< The downloads over HTTP; idle ones get reused, as the HTTP backend may still refer to them.
+	bool http_downloading = false;                ///< Whether files are being downloaded over HTTP.
+	bool http_failed = false;                     ///< Whether a download over HTTP failed, so the rest goes via the fallback.
 
 	FILE *curFile;        ///< Currently downloaded file
 	ContentInfo *curInfo; ///< Information about the currently downloaded file
@@ -81,6 +109,7 @@ protected:
 	std::chrono::steady_clock::time_point lastActivity;  ///< The last time there was network activity
 
 	friend class NetworkContentConnecter;
+	friend class ContentHTTPDownload;
 
 	bool Receive_SERVER_INFO(Packet &p) override;
 	bool Receive_SERVER_CONTENT(Packet &p) override;
@@ -98,8 +127,10 @@ protected:
 	void OnReceiveData(std::unique_ptr<char[]> data, size_t length) override;
 	bool IsCancelled() const override;
 
-	bool BeforeDownload();
-	void AfterDownload();
+	bool BeforeDownload(const ContentInfo *ci, FILE *&file);
+	void AfterDownload(const ContentInfo *ci, FILE *&file);
+	void StartHTTPDownloads();
+	void CheckHTTPDownloadsDone();
 
 	void DownloadSelectedContentHTTP(const ContentIDList &content);
 	void DownloadSelectedContentFallback(const ContentIDList &content);
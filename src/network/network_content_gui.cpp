@@ -173,7 +173,10 @@ void BaseNetworkContentDownloadStatusWindow::OnDownloadProgress(const ContentInf
 	if (ci->id != this->cur_id) {
 		this->name = ci->filename;
 		this->cur_id = ci->id;
-		this->downloaded_files++;
+		if (std::ranges::find(this->started_ids, ci->id) == this->started_ids.end()) {
+			this->started_ids.push_back(ci->id);
+			this->downloaded_files++;
+		}
 	}
 
 	/* A negative value means we are resetting; for example, when retrying or using a fallback. */
@@ -23,6 +23,7 @@ protected:
 	uint downloaded_files; ///< Number of files downloaded
 
 	uint32_t cur_id;    ///< The current ID of the downloaded file
+	std::vector<ContentID> started_ids; ///< The IDs of the files that started downloading; a number of them download at the same time
 	std::string name; ///< The current name of the downloaded file
 
 public:
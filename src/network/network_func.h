@@ -67,6 +67,8 @@ void NetworkHandlePauseChange(PauseMode prev_mode, PauseMode changed_mode);
 /*** Commands ran by the server ***/
 void NetworkServerSendConfigUpdate();
 void NetworkServerUpdateGameInfo();
+bool NetworkServerIsIdle();
+void NetworkServerWaitForActivity(std::chrono::milliseconds timeout);
 void NetworkServerShowStatusToConsole();
 bool NetworkServerStart();
 void NetworkServerNewCompany(const Company *company, NetworkClientInfo *ci);
@@ -17,6 +17,7 @@
 #include "../command_type.h"
 #include "../command_func.h"
 #include "../misc/endian_buffer.hpp"
+#include "../state_hash.h"
 
 #ifdef RANDOM_DEBUG
 /**
@@ -79,6 +80,7 @@ extern uint32_t _sync_seed_1;
 extern uint32_t _sync_seed_2;
 #endif
 extern uint32_t _sync_frame;
+extern std::optional<StateHashes> _sync_state_hashes;
 extern bool _network_first_time;
 /* Vars needed for the join-GUI */
 extern NetworkJoinStatus _network_join_status;
@@ -122,6 +124,8 @@ void NetworkDistributeCommands();
 void NetworkExecuteLocalCommandQueue();
 void NetworkFreeLocalCommandQueue();
 void NetworkSyncCommandQueue(NetworkClientSocket *cs);
+void NetworkStartCommandLog();
+void NetworkStopCommandLog();
 void NetworkReplaceCommandClientId(CommandPacket &cp, ClientID client_id);
 
 void ShowNetworkError(StringID error_string);
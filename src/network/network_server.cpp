@@ -21,6 +21,7 @@
 #include "../saveload/saveload_filter.h"
 #include "../station_base.h"
 #include "../genworld.h"
+#include "../game/game.hpp"
 #include "../company_func.h"
 #include "../company_gui.h"
 #include "../company_cmd.h"
@@ -35,7 +36,6 @@
 #include "../timer/timer_game_economy.h"
 #include "../timer/timer_game_realtime.h"
 #include <mutex>
-#include <condition_variable>
 
 #include "../safeguards.h"
 
@@ -63,126 +63,214 @@ static NetworkAuthenticationDefaultAuthorizedKeyHandler _authorized_key_handler(
 static NetworkAuthenticationDefaultAuthorizedKeyHandler _rcon_authorized_key_handler(_settings_client.network.rcon_authorized_keys); ///< Provides the authorized key validation for rcon.
 
 
-/** Writing a savegame directly to a number of packets. */
-struct PacketWriter : SaveFilter {
-	ServerNetworkGameSocketHandler *cs; ///< Socket we are associated with.
-	std::unique_ptr<Packet> current; ///< The packet we're currently writing to.
-	size_t total_size;                  ///< Total size of the compressed savegame.
-	std::deque<std::unique_ptr<Packet>> packets; ///< Packet queue of the savegame; send these "slowly" to the client. Cannot be a std::queue as we want to push the map size packet in front of the data packets.
-	std::mutex mutex;                   ///< Mutex for making threaded saving safe.
-	std::condition_variable exit_sig;   ///< Signal for threaded destruction of this packet writer.
+/** Number of bytes of the map that are queued for a client at once. */
+static const size_t MAP_SEND_BURST = 1024 * 1024;
+/** Number of rcon commands of a client that may wait for their execution. */
+static const size_t MAX_QUEUED_RCON_COMMANDS = 16;
+
+/**
+ * Savegame of the map that is made once and sent to all clients that start joining
+ * while it is recent. The data is only ever appended to, so each client can stream
+ * it at its own pace while the savegame is still being written.
+ */
+struct NetworkMapSnapshot : SaveFilter {
+	std::vector<uint8_t> data; ///< The compressed savegame written so far.
+	bool finished = false;     ///< Whether the whole savegame has been written.
+	bool cancelled = false;    ///< Whether the saving got cancelled.
+	uint clients = 0;          ///< Number of clients that are still downloading this snapshot.
+	std::mutex mutex;          ///< Mutex for making threaded saving safe.
+
+	/** Create the snapshot. */
+	NetworkMapSnapshot() : SaveFilter(nullptr)
+	{
+	}
 
 	/**
-	 * Create the packet writer.
-	 * @param cs The socket handler we're making the packets for.
+	 * A client starts downloading this snapshot.
+	 * @return False iff the saving of the snapshot got cancelled.
 	 */
-	PacketWriter(ServerNetworkGameSocketHandler *cs) : SaveFilter(nullptr), cs(cs), total_size(0)
+	bool AddClient()
 	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (this->cancelled) return false;
+		this->clients++;
+		return true;
 	}
 
-	/** Make sure everything is cleaned up. */
-	~PacketWriter()
+	/**
+	 * A client stopped downloading this snapshot. When nobody is
+	 * downloading it anymore, the saving is cancelled.
+	 */
+	void RemoveClient()
 	{
-		std::unique_lock<std::mutex> lock(this->mutex);
-
-		if (this->cs != nullptr) this->exit_sig.wait(lock);
-
-		/* This must all wait until the Destroy function is called. */
-
-		this->packets.clear();
-		this->current = nullptr;
+		std::lock_guard<std::mutex> lock(this->mutex);
+		assert(this->clients > 0);
+		this->clients--;
 	}
 
 	/**
-	 * Begin the destruction of this packet writer. It can happen in two ways:
-	 * in the first case the client disconnected while saving the map. In this
-	 * case the saving has not finished and killed this PacketWriter. In that
-	 * case we simply set cs to nullptr, triggering the appending to fail due to
-	 * the connection problem and eventually triggering the destructor. In the
-	 * second case the destructor is already called, and it is waiting for our
-	 * signal which we will send. Only then the packets will be removed by the
-	 * destructor.
+	 * Whether the whole savegame has been written.
+	 * @return True iff the snapshot is complete.
 	 */
-	void Destroy()
+	bool IsFinished()
 	{
-		std::unique_lock<std::mutex> lock(this->mutex);
-
-		this->cs = nullptr;
-
-		this->exit_sig.notify_all();
-		lock.unlock();
-
-		/* Make sure the saving is completely cancelled. Yes,
-		 * we need to handle the save finish as well as the
-		 * next connection might just be requesting a map. */
-		WaitTillSaved();
+		std::lock_guard<std::mutex> lock(this->mutex);
+		return this->finished;
 	}
 
 	/**
-	 * Transfer all packets from here to the network's queue while holding
-	 * the lock on our mutex.
-	 * @return True iff the last packet of the map has been sent.
+	 * Whether the saving of the snapshot got cancelled.
+	 * @return True iff the snapshot is never going to be complete.
 	 */
-	bool TransferToNetworkQueue()
+	bool IsCancelled()
 	{
-		/* Unsafe check for the queue being empty or not. */
-		if (this->packets.empty()) return false;
+		std::lock_guard<std::mutex> lock(this->mutex);
+		return this->cancelled;
+	}
 
+	/**
+	 * Transfer the next part of the snapshot to the network's queue of a client.
+	 * @param cs The client to send the snapshot to.
+	 * @param max_bytes The maximum number of bytes of the snapshot to transfer.
+	 * @return True iff the last packet of the map has been queued.
+	 */
+	bool TransferToNetworkQueue(ServerNetworkGameSocketHandler *cs, size_t max_bytes)
+	{
 		std::lock_guard<std::mutex> lock(this->mutex);
 
-		while (!this->packets.empty()) {
-			bool last_packet = this->packets.front()->GetPacketType() == PACKET_SERVER_MAP_DONE;
-			this->cs->SendPacket(std::move(this->packets.front()));
-			this->packets.pop_front();
+		if (this->finished && !cs->savegame_size_sent) {
+			/* Fast-track the size to the client. */
+			auto p = std::make_unique<Packet>(cs, PACKET_SERVER_MAP_SIZE);
+			p->Send_uint32((uint32_t)this->data.size());
+			cs->SendBulkPacket(std::move(p));
+			cs->savegame_size_sent = true;
+		}
+
+		size_t end = std::min(this->data.size(), cs->savegame_sent + max_bytes);
+		while (cs->savegame_sent < end) {
+			auto p = std::make_unique<Packet>(cs, PACKET_SERVER_MAP_DATA, TCP_MTU);
+			std::span<const uint8_t> to_write(this->data.data() + cs->savegame_sent, end - cs->savegame_sent);
+			size_t written = to_write.size() - p->Send_bytes(to_write).size();
+
+			/* Only send a packet that is not full when nothing is going to follow it. */
+			if (p->CanWriteToPacket(1) && (!this->finished || end != this->data.size())) break;
 
-			if (last_packet) return true;
+			cs->savegame_sent += written;
+			cs->SendBulkPacket(std::move(p));
 		}
 
-		return false;
+		if (!this->finished || cs->savegame_sent != this->data.size()) return false;
+
+		/* Add a packet stating that this is the end to the queue. */
+		cs->SendBulkPacket(std::make_unique<Packet>(cs, PACKET_SERVER_MAP_DONE));
+		return true;
 	}
 
 	void Write(uint8_t *buf, size_t size) override
 	{
 		std::lock_guard<std::mutex> lock(this->mutex);
 
-		/* We want to abort the saving when the socket is closed. */
-		if (this->cs == nullptr) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
-
-		if (this->current == nullptr) this->current = std::make_unique<Packet>(this->cs, PACKET_SERVER_MAP_DATA, TCP_MTU);
-
-		std::span<const uint8_t> to_write(buf, size);
-		while (!to_write.empty()) {
-			to_write = this->current->Send_bytes(to_write);
-
-			if (!this->current->CanWriteToPacket(1)) {
-				this->packets.push_back(std::move(this->current));
-				if (!to_write.empty()) this->current = std::make_unique<Packet>(this->cs, PACKET_SERVER_MAP_DATA, TCP_MTU);
-			}
+		/* We want to abort the saving when nobody is waiting for it anymore. */
+		if (this->clients == 0) {
+			this->cancelled = true;
+			SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
 		}
 
-		this->total_size += size;
+		this->data.insert(this->data.end(), buf, buf + size);
 	}
 
 	void Finish() override
 	{
 		std::lock_guard<std::mutex> lock(this->mutex);
 
-		/* We want to abort the saving when the socket is closed. */
-		if (this->cs == nullptr) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
-
-		/* Make sure the last packet is flushed. */
-		if (this->current != nullptr) this->packets.push_back(std::move(this->current));
-
-		/* Add a packet stating that this is the end to the queue. */
-		this->packets.push_back(std::make_unique<Packet>(this->cs, PACKET_SERVER_MAP_DONE));
+		/* We want to abort the saving when nobody is waiting for it anymore. */
+		if (this->clients == 0) {
+			this->cancelled = true;
+			SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
+		}
 
-		/* Fast-track the size to the client. */
-		auto p = std::make_unique<Packet>(this->cs, PACKET_SERVER_MAP_SIZE);
-		p->Send_uint32((uint32_t)this->total_size);
-		this->packets.push_front(std::move(p));
+		this->finished = true;
 	}
 };
 
+/** The last snapshot of the map that was made for joining clients, if any. */
+static std::shared_ptr<NetworkMapSnapshot> _network_map_snapshot;
+/** The frame the last snapshot of the map was made in. */
+static uint32_t _network_map_snapshot_frame;
+
+/**
+ * Whether a snapshot of the map is being made, in which case new joiners that cannot start with it have to wait for the next one.
+ * @return True iff a snapshot is being made.
+ */
+static bool IsMakingMapSnapshot()
+{
+	if (_network_map_snapshot == nullptr || _network_map_snapshot->IsFinished() || _network_map_snapshot->IsCancelled()) return false;
+
+	/* When the saving failed, the snapshot is never finished; nobody could have downloaded it by now anyway. */
+	return _frame_counter - _network_map_snapshot_frame <= _settings_client.network.max_download_time;
+}
+
+/**
+ * Get the last snapshot of the map when a joining client can still start with it. The client
+ * has to catch up with all commands since the snapshot was made, so it may not be too old.
+ * @return The snapshot, or \c nullptr when a new one has to be made.
+ */
+static std::shared_ptr<NetworkMapSnapshot> GetRecentMapSnapshot()
+{
+	if (_network_map_snapshot == nullptr || _network_map_snapshot->IsCancelled()) return nullptr;
+	if (_frame_counter - _network_map_snapshot_frame > _settings_client.network.max_map_snapshot_age) return nullptr;
+	if (!_network_map_snapshot->IsFinished() && !IsMakingMapSnapshot()) return nullptr;
+	return _network_map_snapshot;
+}
+
+/** Forget the last snapshot of the map and the commands since then, once joining clients cannot start with it anymore. */
+static void CheckMapSnapshotAge()
+{
+	if (_network_map_snapshot == nullptr || GetRecentMapSnapshot() != nullptr) return;
+
+	NetworkStopCommandLog();
+	if (!IsMakingMapSnapshot()) _network_map_snapshot = nullptr;
+}
+
+/** Forget the last snapshot of the map, e.g. because another game is going to be played. */
+void NetworkServerForgetMapSnapshot()
+{
+	NetworkStopCommandLog();
+	_network_map_snapshot = nullptr;
+}
+
+/**
+ * Let a client start downloading a snapshot of the map.
+ * @param cs The client.
+ * @param snapshot The snapshot, which is either being made this frame or recent.
+ * @return False iff the saving of the snapshot got cancelled.
+ */
+static bool StartMapDownload(NetworkClientSocket *cs, std::shared_ptr<NetworkMapSnapshot> snapshot)
+{
+	if (!snapshot->AddClient()) return false;
+
+	Debug(net, 9, "client[{}] SendMap(): first_packet", cs->client_id);
+
+	cs->savegame = snapshot;
+	cs->savegame_sent = 0;
+	cs->savegame_size_sent = false;
+	cs->map_send_limit = 0;
+
+	/* Now send the frame of the snapshot and how many packets are coming */
+	auto p = std::make_unique<Packet>(cs, PACKET_SERVER_MAP_BEGIN);
+	p->Send_uint32(_network_map_snapshot_frame);
+	cs->SendPacket(std::move(p));
+
+	/* The client has to catch up with the commands from the frame of the snapshot. */
+	NetworkSyncCommandQueue(cs);
+	Debug(net, 9, "client[{}] status = MAP", cs->client_id);
+	cs->status = NetworkClientSocket::STATUS_MAP;
+	/* Mark the start of download */
+	cs->last_frame = _frame_counter;
+	cs->last_frame_server = _frame_counter;
+	return true;
+}
+
 
 /**
  * Create a new socket for the server side of the game connection.
@@ -213,7 +301,7 @@ ServerNetworkGameSocketHandler::~ServerNetworkGameSocketHandler()
 	OrderBackup::ResetUser(this->client_id);
 
 	if (this->savegame != nullptr) {
-		this->savegame->Destroy();
+		this->savegame->RemoveClient();
 		this->savegame = nullptr;
 	}
 }
@@ -258,10 +346,9 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::CloseConnection(NetworkRecvSta
 	}
 
 	/* If we were transfering a map to this client, stop the savegame creation
-	 * process and queue the next client to receive the map. */
+	 * process when nobody else needs it and queue the next clients to receive the map. */
 	if (this->status == STATUS_MAP) {
-		/* Ensure the saving of the game is stopped too. */
-		this->savegame->Destroy();
+		this->savegame->RemoveClient();
 		this->savegame = nullptr;
 
 		this->CheckNextClientToSendMap(this);
@@ -344,7 +431,7 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendGameInfo()
 	Debug(net, 9, "client[{}] SendGameInfo()", this->client_id);
 
 	auto p = std::make_unique<Packet>(this, PACKET_SERVER_GAME_INFO, TCP_MTU);
-	SerializeNetworkGameInfo(*p, GetCurrentNetworkServerGameInfo());
+	SerializeCurrentNetworkServerGameInfo(*p);
 
 	this->SendPacket(std::move(p));
 
@@ -514,12 +601,18 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendWelcome()
 
 	_network_game_info.clients_on++;
 
+	bool compress = _settings_client.network.compress_stream && (this->capabilities & NGC_COMPRESSED_STREAM) != NGC_NONE && IsNetworkCompressionAvailable();
+
 	auto p = std::make_unique<Packet>(this, PACKET_SERVER_WELCOME);
 	p->Send_uint32(this->client_id);
 	p->Send_uint32(_settings_game.game_creation.generation_seed);
 	p->Send_string(_settings_client.network.network_id);
+	p->Send_bool(compress);
 	this->SendPacket(std::move(p));
 
+	/* Packets are prepared in the order they are sent, so everything after the welcome is compressed. */
+	if (compress) this->send_compression_handler = CreateNetworkCompressionHandler();
+
 	/* Transmit info about all the active clients */
 	for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
 		if (new_cs != this && new_cs->status >= STATUS_AUTHORIZED) {
@@ -553,6 +646,9 @@ void ServerNetworkGameSocketHandler::CheckNextClientToSendMap(NetworkClientSocke
 {
 	Debug(net, 9, "client[{}] CheckNextClientToSendMap()", this->client_id);
 
+	/* The clients that are waiting get the next snapshot. */
+	if (IsMakingMapSnapshot()) return;
+
 	/* Find the best candidate for joining, i.e. the first joiner. */
 	NetworkClientSocket *best = nullptr;
 	for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
@@ -565,16 +661,10 @@ void ServerNetworkGameSocketHandler::CheckNextClientToSendMap(NetworkClientSocke
 		}
 	}
 
-	/* Is there someone else to join? */
+	/* Is there someone else to join? Then all waiting clients start joining together with them. */
 	if (best != nullptr) {
-		/* Let the first start joining. */
 		best->status = STATUS_AUTHORIZED;
 		best->SendMap();
-
-		/* And update the rest. */
-		for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
-			if (new_cs->status == STATUS_MAP_WAIT) new_cs->SendWait();
-		}
 	}
 }
 
@@ -587,34 +677,41 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 	}
 
 	if (this->status == STATUS_AUTHORIZED) {
-		Debug(net, 9, "client[{}] SendMap(): first_packet", this->client_id);
-
-		WaitTillSaved();
-		this->savegame = std::make_shared<PacketWriter>(this);
-
-		/* Now send the _frame_counter and how many packets are coming */
-		auto p = std::make_unique<Packet>(this, PACKET_SERVER_MAP_BEGIN);
-		p->Send_uint32(_frame_counter);
-		this->SendPacket(std::move(p));
-
-		NetworkSyncCommandQueue(this);
-		Debug(net, 9, "client[{}] status = MAP", this->client_id);
-		this->status = STATUS_MAP;
-		/* Mark the start of download */
-		this->last_frame = _frame_counter;
-		this->last_frame_server = _frame_counter;
+		/* Start with the last snapshot when it is recent, instead of making a new one. */
+		std::shared_ptr<NetworkMapSnapshot> snapshot = GetRecentMapSnapshot();
+		if (snapshot == nullptr || !StartMapDownload(this, snapshot)) {
+			WaitTillSaved();
+			_network_map_snapshot = std::make_shared<NetworkMapSnapshot>();
+			_network_map_snapshot_frame = _frame_counter;
+			NetworkStartCommandLog();
+
+			/* Everyone that is waiting for the map gets this same snapshot. */
+			for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
+				if (cs != this && (cs->status != STATUS_MAP_WAIT || cs->IsPendingDeletion())) continue;
+				StartMapDownload(cs, _network_map_snapshot);
+			}
 
-		/* Make a dump of the current game */
-		if (SaveWithFilter(this->savegame, true) != SL_OK) UserError("network savedump failed");
+			/* Make a dump of the current game */
+			if (SaveWithFilter(_network_map_snapshot, true) != SL_OK) UserError("network savedump failed");
+		}
 	}
 
 	if (this->status == STATUS_MAP) {
-		bool last_packet = this->savegame->TransferToNetworkQueue();
+		/* Only queue more of the map when the previous part has been sent, so the
+		 * snapshot is not copied into the packet queue of every client at once. */
+		if (this->HasBulkSendQueue()) return NETWORK_RECV_STATUS_OKAY;
+
+		/* When the map's bandwidth is limited, only send what the client has saved up. */
+		bool limited = _settings_client.network.map_bytes_per_frame != 0;
+		size_t max_bytes = limited ? this->map_send_limit : MAP_SEND_BURST;
+		size_t sent = this->savegame_sent;
+
+		bool last_packet = this->savegame->TransferToNetworkQueue(this, max_bytes);
+		if (limited) this->map_send_limit -= this->savegame_sent - sent;
 		if (last_packet) {
 			Debug(net, 9, "client[{}] SendMap(): last_packet", this->client_id);
 
-			/* Done reading, make sure saving is done as well */
-			this->savegame->Destroy();
+			this->savegame->RemoveClient();
 			this->savegame = nullptr;
 
 			/* Set the status to DONE_MAP, no we will wait for the client
@@ -645,10 +742,14 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendJoin(ClientID client_id)
 }
 
 /** Tell the client that they may run to a particular frame. */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
+/**
+ * Tell the client up to which frame it may run.
+ * @param frame The frame the client is told the server is at; the client quickly runs the frames up to it.
+ */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame(uint32_t frame)
 {
 	auto p = std::make_unique<Packet>(this, PACKET_SERVER_FRAME);
-	p->Send_uint32(_frame_counter);
+	p->Send_uint32(frame);
 	p->Send_uint32(_frame_counter_max);
 #ifdef ENABLE_NETWORK_SYNC_EVERY_FRAME
 	p->Send_uint32(_sync_seed_1);
@@ -679,6 +780,11 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync()
 #ifdef NETWORK_SEND_DOUBLE_SEED
 	p->Send_uint32(_sync_seed_2);
 #endif
+
+	if (_sync_state_hashes.has_value()) {
+		p->Send_uint8(SHS_END);
+		for (uint64_t hash : *_sync_state_hashes) p->Send_uint64(hash);
+	}
 	this->SendPacket(std::move(p));
 	return NETWORK_RECV_STATUS_OKAY;
 }
@@ -701,6 +807,31 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommand(const CommandPacke
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Send several commands to the client in as few packets as possible.
+ * @param queue The commands to send.
+ */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommands(const CommandQueue &queue)
+{
+	Debug(net, 9, "client[{}] SendCommands(): count={}", this->client_id, queue.size());
+
+	/* Company, command, error message, data length, callback, frame and whether it is the client's command. */
+	static const size_t COMMAND_SIZE = sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint32_t) + sizeof(bool);
+
+	std::unique_ptr<Packet> p;
+	for (const CommandPacket &cp : queue) {
+		if (p != nullptr && !p->CanWriteToPacket(COMMAND_SIZE + cp.data.size())) this->SendPacket(std::move(p));
+		if (p == nullptr) p = std::make_unique<Packet>(this, PACKET_SERVER_COMMANDS, TCP_MTU);
+
+		this->NetworkGameSocketHandler::SendCommand(*p, cp);
+		p->Send_uint32(cp.frame);
+		p->Send_bool  (cp.my_cmd);
+	}
+
+	if (p != nullptr) this->SendPacket(std::move(p));
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Send a chat message.
  * @param action The action associated with the message.
@@ -723,7 +854,7 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendChat(NetworkAction action,
 	p->Send_string(msg);
 	p->Send_uint64(data);
 
-	this->SendPacket(std::move(p));
+	this->SendBulkPacket(std::move(p));
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
@@ -747,7 +878,7 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendExternalChat(const std::st
 	p->Send_string(user);
 	p->Send_string(msg);
 
-	this->SendPacket(std::move(p));
+	this->SendBulkPacket(std::move(p));
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
@@ -902,6 +1033,8 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_JOIN(Packet &p)
 
 	std::string client_revision = p.Recv_string(NETWORK_REVISION_LENGTH);
 	uint32_t newgrf_version = p.Recv_uint32();
+	/* Clients that do not know about capabilities do not send them. */
+	this->capabilities = p.CanReadFromPacket(sizeof(uint32_t)) ? static_cast<NetworkGameCapabilities>(p.Recv_uint32()) : NGC_NONE;
 
 	Debug(net, 9, "client[{}] Receive_CLIENT_JOIN(): client_revision={}, newgrf_version={}", this->client_id, client_revision, newgrf_version);
 
@@ -1052,14 +1185,12 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_GETMAP(Packet &
 
 	Debug(net, 9, "client[{}] Receive_CLIENT_GETMAP()", this->client_id);
 
-	/* Check if someone else is receiving the map */
-	for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
-		if (new_cs->status == STATUS_MAP) {
-			/* Tell the new client to wait */
-			Debug(net, 9, "client[{}] status = MAP_WAIT", this->client_id);
-			this->status = STATUS_MAP_WAIT;
-			return this->SendWait();
-		}
+	/* Check if a snapshot is being made for other clients that we cannot start with; then wait for the next one. */
+	if (GetRecentMapSnapshot() == nullptr && IsMakingMapSnapshot()) {
+		/* Tell the new client to wait */
+		Debug(net, 9, "client[{}] status = MAP_WAIT", this->client_id);
+		this->status = STATUS_MAP_WAIT;
+		return this->SendWait();
 	}
 
 	/* We receive a request to upload the map.. give it to the client! */
@@ -1084,7 +1215,7 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_MAP_OK(Packet &
 		Debug(net, 9, "client[{}] status = PRE_ACTIVE", this->client_id);
 		this->status = STATUS_PRE_ACTIVE;
 		NetworkHandleCommandQueue(this);
-		this->SendFrame();
+		this->SendFrame(_frame_counter);
 		this->SendSync();
 
 		/* This is the frame the client receives
@@ -1201,6 +1332,12 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_ERROR(Packet &p
 
 	Debug(net, 1, "'{}' reported an error and is closing its connection: {}", client_name, GetString(strid));
 
+	if (errorno == NETWORK_ERROR_DESYNC && _sync_state_hashes.has_value()) {
+		for (uint i = 0; i < SHS_END; i++) {
+			Debug(desync, 0, "state hash: frame {}, client {}, {}: {:016x}", _last_sync_frame, this->client_id, GetStateHashSectionName(static_cast<StateHashSection>(i)), (*_sync_state_hashes)[i]);
+		}
+	}
+
 	NetworkTextMessage(NETWORK_ACTION_LEAVE, CC_DEFAULT, false, client_name, "", strid);
 
 	for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
@@ -1521,14 +1658,38 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_RCON(Packet &p)
 		return NETWORK_RECV_STATUS_OKAY;
 	}
 
-	Debug(net, 3, "[rcon] Client-id {} executed: {}", this->client_id, command);
+	if (this->rcon_queue.size() >= MAX_QUEUED_RCON_COMMANDS) {
+		Debug(net, 1, "[rcon] Too many queued commands from client-id {}, ignoring: {}", this->client_id, command);
+		return this->SendRConResult(CC_ERROR, "Too many rcon commands are waiting to be executed; command ignored.");
+	}
 
-	_redirect_console_to_client = this->client_id;
-	IConsoleCmdExec(command);
-	_redirect_console_to_client = INVALID_CLIENT_ID;
+	/* Commands are executed with the game loop, so a burst of them is spread over several ticks. */
+	this->rcon_queue.push_back(std::move(command));
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Execute the oldest queued rcon command of each client. This is done after
+ * the packets of the tick have been sent, so a slow command does not hold
+ * back the frame of the clients. The output of the command is queued for
+ * the client line by line, and sent with the packets of the next tick.
+ */
+void NetworkServerExecuteRconCommands()
+{
+	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
+		if (cs->status != NetworkClientSocket::STATUS_ACTIVE || cs->rcon_queue.empty()) continue;
+
+		std::string command = std::move(cs->rcon_queue.front());
+		cs->rcon_queue.pop_front();
+
+		Debug(net, 3, "[rcon] Client-id {} executed: {}", cs->client_id, command);
+
+		_redirect_console_to_client = cs->client_id;
+		IConsoleCmdExec(command);
+		_redirect_console_to_client = INVALID_CLIENT_ID;
+	}
+}
+
 NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_MOVE(Packet &p)
 {
 	if (this->status != STATUS_ACTIVE) return this->SendError(NETWORK_ERROR_NOT_EXPECTED);
@@ -1767,10 +1928,32 @@ void NetworkServerSetCompanyPassword(CompanyID company_id, const std::string &pa
  */
 static void NetworkHandleCommandQueue(NetworkClientSocket *cs)
 {
-	for (auto &cp : cs->outgoing_queue) cs->SendCommand(cp);
+	if (_settings_client.network.batch_commands && cs->outgoing_queue.size() > 1 && (cs->capabilities & NGC_COMMAND_BATCHES) != NGC_NONE) {
+		cs->SendCommands(cs->outgoing_queue);
+	} else {
+		for (auto &cp : cs->outgoing_queue) cs->SendCommand(cp);
+	}
 	cs->outgoing_queue.clear();
 }
 
+/**
+ * Check whether the client is a spectator that gets its frames and commands delayed,
+ * so it does not need to be sent packets every tick.
+ * @return True iff the client is an active spectator and spectators are delayed.
+ */
+bool ServerNetworkGameSocketHandler::IsDelayedSpectator() const
+{
+#ifdef ENABLE_NETWORK_SYNC_EVERY_FRAME
+	/* The sync seed in the frame packet is only right for the current frame. */
+	return false;
+#else
+	if (_settings_client.network.spectator_frame_freq == 0 || this->status != STATUS_ACTIVE) return false;
+
+	const NetworkClientInfo *ci = this->GetInfo();
+	return ci != nullptr && ci->client_playas == COMPANY_SPECTATOR;
+#endif
+}
+
 /**
  * This is called every tick if this is a _network_server
  * @param send_frame Whether to send the frame to the clients.
@@ -1785,9 +1968,18 @@ void NetworkServer_Tick(bool send_frame)
 	if (_frame_counter >= _last_sync_frame + _settings_client.network.sync_freq) {
 		_last_sync_frame = _frame_counter;
 		send_sync = true;
+
+		if (_settings_client.network.sync_state_hash) {
+			_sync_state_hashes = CalculateStateHashes();
+		} else {
+			_sync_state_hashes.reset();
+		}
 	}
 #endif
 
+	CheckMapSnapshotAge();
+	NetworkAdminTick();
+
 	/* Now we are done with the frame, inform the clients that they can
 	 *  do their frame! */
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
@@ -1796,6 +1988,11 @@ void NetworkServer_Tick(bool send_frame)
 		cs->receive_limit = std::min<size_t>(cs->receive_limit + _settings_client.network.bytes_per_frame,
 				_settings_client.network.bytes_per_frame_burst);
 
+		/* Likewise for sending the map, but with a burst of what is queued at once. */
+		if (cs->status == NetworkClientSocket::STATUS_MAP) {
+			cs->map_send_limit = std::min<size_t>(cs->map_send_limit + _settings_client.network.map_bytes_per_frame, MAP_SEND_BURST);
+		}
+
 		/* Check if the speed of the client is what we can expect from a client */
 		uint lag = NetworkCalculateLag(cs);
 		switch (cs->status) {
@@ -1846,6 +2043,12 @@ void NetworkServer_Tick(bool send_frame)
 				break;
 
 			case NetworkClientSocket::STATUS_MAP_WAIT:
+				/* The snapshot this client was waiting for is done or got cancelled. */
+				if (!IsMakingMapSnapshot()) {
+					cs->CheckNextClientToSendMap();
+					break;
+				}
+
 				/* Send every two seconds a packet to the client, to make sure
 				 * it knows the server is still there; just someone else is
 				 * still receiving the map. */
@@ -1894,12 +2097,26 @@ void NetworkServer_Tick(bool send_frame)
 				NOT_REACHED();
 		}
 
-		if (cs->status >= NetworkClientSocket::STATUS_PRE_ACTIVE) {
+		if (cs->IsDelayedSpectator()) {
+			/* Give the spectator the commands and frames of a number of ticks at once.
+			 * It is told the server is where it was at the previous frame packet, so it
+			 * keeps running at the normal pace, just that many ticks behind. */
+			if (_frame_counter >= cs->spectator_frame + _settings_client.network.spectator_frame_freq) {
+				NetworkHandleCommandQueue(cs);
+				cs->SendFrame(cs->spectator_frame);
+				cs->spectator_frame = _frame_counter;
+			}
+
+#ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
+			if (send_sync) cs->SendSync();
+#endif
+		} else if (cs->status >= NetworkClientSocket::STATUS_PRE_ACTIVE) {
 			/* Check if we can send command, and if we have anything in the queue */
 			NetworkHandleCommandQueue(cs);
 
 			/* Send an updated _frame_counter_max to the client */
-			if (send_frame) cs->SendFrame();
+			if (send_frame) cs->SendFrame(_frame_counter);
+			cs->spectator_frame = _frame_counter;
 
 #ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
 			/* Send a sync-check packet */
@@ -2069,6 +2286,26 @@ void NetworkServerUpdateGameInfo()
 	if (_network_server) FillStaticNetworkServerGameInfo();
 }
 
+/**
+ * Check whether nothing can happen on the server until someone connects: the
+ * game is paused, no game script runs and there are no clients or admins.
+ * @return True iff the server is idle.
+ */
+bool NetworkServerIsIdle()
+{
+	return _network_server && _pause_mode != PM_UNPAUSED && Game::GetInstance() == nullptr &&
+			NetworkClientSocket::GetNumItems() == 0 && ServerNetworkAdminSocketHandler::GetNumItems() == 0;
+}
+
+/**
+ * Wait until a client connects to the game server, or the timeout expires.
+ * @param timeout The maximum time to wait.
+ */
+void NetworkServerWaitForActivity(std::chrono::milliseconds timeout)
+{
+	ServerNetworkGameSocketHandler::Wait(timeout);
+}
+
 /**
  * Tell that a particular company is (not) passworded.
  * @param company_id The company that got/removed the password.
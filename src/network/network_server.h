@@ -60,7 +60,7 @@ public:
 		STATUS_NEWGRFS_CHECK, ///< The client is checking NewGRFs.
 		STATUS_AUTH_COMPANY,  ///< The client is authorizing with company password.
 		STATUS_AUTHORIZED,    ///< The client is authorized.
-		STATUS_MAP_WAIT,      ///< The client is waiting as someone else is downloading the map.
+		STATUS_MAP_WAIT,      ///< The client is waiting for the next snapshot of the map.
 		STATUS_MAP,           ///< The client is downloading the map.
 		STATUS_DONE_MAP,      ///< The client has downloaded the map.
 		STATUS_PRE_ACTIVE,    ///< The client is catching up the delayed frames.
@@ -74,8 +74,14 @@ public:
 	ClientStatus status;         ///< Status of this client
 	CommandQueue outgoing_queue; ///< The command-queue awaiting delivery; conceptually more a bucket to gather commands in, after which the whole bucket is sent to the client.
 	size_t receive_limit;        ///< Amount of bytes that we can receive at this moment
-
-	std::shared_ptr<struct PacketWriter> savegame; ///< Writer used to write the savegame.
+	NetworkGameCapabilities capabilities = NGC_NONE; ///< Optional parts of the protocol the client supports
+	size_t map_send_limit = 0;   ///< Amount of bytes of the map that we can send at this moment, when the map's bandwidth is limited
+	uint32_t spectator_frame = 0; ///< The frame a delayed spectator is told the server is at; it gets the frames after that with its next frame packet.
+	std::deque<std::string> rcon_queue; ///< Rcon commands of this client that still have to be executed.
+
+	std::shared_ptr<struct NetworkMapSnapshot> savegame; ///< Snapshot of the map that is being sent to this client.
+	size_t savegame_sent = 0;       ///< Number of bytes of the snapshot that have been queued for this client.
+	bool savegame_size_sent = false; ///< Whether the size of the snapshot has been queued for this client.
 	NetworkAddress client_address; ///< IP-address of the client (so they can be banned)
 
 	ServerNetworkGameSocketHandler(SOCKET s);
@@ -84,6 +90,7 @@ public:
 	std::unique_ptr<Packet> ReceivePacket() override;
 	NetworkRecvStatus CloseConnection(NetworkRecvStatus status) override;
 	std::string GetClientName() const;
+	bool IsDelayedSpectator() const;
 
 	void CheckNextClientToSendMap(NetworkClientSocket *ignore_cs = nullptr);
 
@@ -101,9 +108,10 @@ public:
 	NetworkRecvStatus SendChat(NetworkAction action, ClientID client_id, bool self_send, const std::string &msg, int64_t data);
 	NetworkRecvStatus SendExternalChat(const std::string &source, TextColour colour, const std::string &user, const std::string &msg);
 	NetworkRecvStatus SendJoin(ClientID client_id);
-	NetworkRecvStatus SendFrame();
+	NetworkRecvStatus SendFrame(uint32_t frame);
 	NetworkRecvStatus SendSync();
 	NetworkRecvStatus SendCommand(const CommandPacket &cp);
+	NetworkRecvStatus SendCommands(const CommandQueue &queue);
 	NetworkRecvStatus SendCompanyUpdate();
 	NetworkRecvStatus SendConfigUpdate();
 
@@ -127,6 +135,8 @@ public:
 };
 
 void NetworkServer_Tick(bool send_frame);
+void NetworkServerExecuteRconCommands();
+void NetworkServerForgetMapSnapshot();
 void ChangeNetworkRestartTime(bool reset);
 void NetworkServerSetCompanyPassword(CompanyID company_id, const std::string &password, bool already_hashed = true);
 void NetworkServerUpdateCompanyPassworded(CompanyID company_id, bool passworded);
@@ -30,6 +30,9 @@
 
 #include "core/udp.h"
 
+#include <chrono>
+#include <unordered_map>
+
 #include "../safeguards.h"
 
 static bool _network_udp_server;         ///< Is the UDP server started?
@@ -62,6 +65,15 @@ static UDPSocket _udp_server("Server"); ///< udp server socket
 
 /** Helper class for handling all server side communication. */
 class ServerNetworkUDPSocketHandler : public NetworkUDPSocketHandler {
+	/** Minimum time between two responses to the same host, so floods of requests do not cost anything. */
+	static constexpr std::chrono::milliseconds RESPONSE_INTERVAL{1000};
+	/** Number of hosts remembered before the ones that may get a response again are forgotten. */
+	static constexpr size_t MAX_RECENT_HOSTS = 1024;
+
+	std::unordered_map<std::string, std::chrono::steady_clock::time_point> recent_hosts; ///< When the hosts that asked recently got their response.
+
+	bool MayRespond(const std::string &host);
+
 protected:
 	void Receive_CLIENT_FIND_SERVER(Packet &p, NetworkAddress &client_addr) override;
 public:
@@ -73,8 +85,33 @@ public:
 	virtual ~ServerNetworkUDPSocketHandler() = default;
 };
 
+/**
+ * Check whether a host may get a response now, and remember it if so.
+ * @param host The host that asked.
+ * @return True iff the host did not get a response recently.
+ */
+bool ServerNetworkUDPSocketHandler::MayRespond(const std::string &host)
+{
+	auto now = std::chrono::steady_clock::now();
+
+	if (this->recent_hosts.size() >= MAX_RECENT_HOSTS) {
+		std::erase_if(this->recent_hosts, [now](const auto &it) { return now - it.second >= RESPONSE_INTERVAL; });
+	}
+
+	auto [it, inserted] = this->recent_hosts.try_emplace(host, now);
+	if (inserted) return true;
+	if (now - it->second < RESPONSE_INTERVAL) return false;
+	it->second = now;
+	return true;
+}
+
 void ServerNetworkUDPSocketHandler::Receive_CLIENT_FIND_SERVER(Packet &, NetworkAddress &client_addr)
 {
+	if (!this->MayRespond(client_addr.GetHostname())) {
+		Debug(net, 7, "Ignored query from {}", client_addr.GetHostname());
+		return;
+	}
+
 	Packet packet(this, PACKET_UDP_SERVER_RESPONSE);
 	this->SendPacket(packet, client_addr);
 
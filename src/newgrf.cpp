@@ -49,6 +49,7 @@
 #include "vehicle_base.h"
 #include "road.h"
 #include "newgrf_roadstop.h"
+#include "core/flathashmap_type.hpp"
 
 #include "table/strings.h"
 #include "table/build_industry.h"
@@ -93,7 +94,7 @@ private:
 	};
 
 	/** Currently referenceable spritesets */
-	std::map<uint, SpriteSet> spritesets[GSF_END];
+	FlatHashMap<uint, SpriteSet> spritesets[GSF_END];
 
 public:
 	/* Global state */
@@ -574,7 +575,7 @@ StringID MapGRFStringID(uint32_t grfid, StringID str)
 	}
 }
 
-static std::map<uint32_t, uint32_t> _grf_id_overrides;
+static FlatHashMap<uint32_t, uint32_t> _grf_id_overrides;
 
 /**
  * Set the override for a NewGRF
@@ -5320,6 +5321,7 @@ static void NewSpriteGroup(ByteReader *buf)
 				}
 			}
 
+			group->AnalyseAdjusts();
 			break;
 		}
 
@@ -10097,6 +10099,8 @@ void LoadNewGRF(uint load_index, uint num_baseset)
 	 * in each loading stage, (try to) open each file specified in the config
 	 * and load information from it. */
 	for (GrfLoadingStage stage = GLS_LABELSCAN; stage <= GLS_ACTIVATION; stage++) {
+		auto stage_start = std::chrono::steady_clock::now();
+
 		/* Set activated grfs back to will-be-activated between reservation- and activation-stage.
 		 * This ensures that action7/9 conditions 0x06 - 0x0A work correctly. */
 		for (GRFConfig *c = _grfconfig; c != nullptr; c = c->next) {
@@ -10129,7 +10133,11 @@ void LoadNewGRF(uint load_index, uint num_baseset)
 				continue;
 			}
 
-			if (stage == GLS_LABELSCAN) InitNewGRFFile(c);
+			if (stage == GLS_LABELSCAN) {
+				InitNewGRFFile(c);
+				/* The sprite sections are needed from the init stage on; read them while the earlier stages run. */
+				PrefetchGRFSpriteOffsets(c->filename, subdir, c->ident.md5sum);
+			}
 
 			if (!HasBit(c->flags, GCF_STATIC) && !HasBit(c->flags, GCF_SYSTEM)) {
 				if (num_non_static == NETWORK_MAX_GRF_COUNT) {
@@ -10157,10 +10165,14 @@ void LoadNewGRF(uint load_index, uint num_baseset)
 				ClearTemporaryNewGRFData(_cur.grffile);
 			}
 		}
+
+		auto stage_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - stage_start);
+		Debug(grf, 1, "LoadNewGRF: Stage {} of {} files took {} ms", stage, num_grfs, stage_time.count());
 	}
 
 	/* Pseudo sprite processing is finished; free temporary stuff */
 	_cur.ClearDataForNextFile();
+	ClearGRFSpriteOffsetsPrefetch();
 
 	/* Call any functions that should be run after GRFs have been loaded. */
 	AfterLoadGRFs();
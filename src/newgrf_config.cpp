@@ -9,7 +9,7 @@
 
 #include "stdafx.h"
 #include "debug.h"
-#include "3rdparty/md5/md5.h"
+#include "scan_cache.h"
 #include "newgrf.h"
 #include "network/network_func.h"
 #include "gfx_func.h"
@@ -284,13 +284,10 @@ size_t GRFGetSizeOfDataSection(FILE *f)
  */
 static bool CalcGRFMD5Sum(GRFConfig *config, Subdirectory subdir)
 {
-	FILE *f;
-	Md5 checksum;
-	uint8_t buffer[1024];
-	size_t len, size;
+	size_t size;
 
 	/* open the file */
-	f = FioFOpenFile(config->filename, "rb", subdir, &size);
+	FILE *f = FioFOpenFile(config->filename, "rb", subdir, &size);
 	if (f == nullptr) return false;
 
 	long start = ftell(f);
@@ -302,11 +299,7 @@ static bool CalcGRFMD5Sum(GRFConfig *config, Subdirectory subdir)
 	}
 
 	/* calculate md5sum */
-	while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, f)) != 0 && size != 0) {
-		size -= len;
-		checksum.Append(buffer, len);
-	}
-	checksum.Finish(config->ident.md5sum);
+	config->ident.md5sum = CalcFileMD5(f, size, config->filename, subdir);
 
 	FioFCloseFile(f);
 
@@ -655,6 +648,8 @@ void DoScanNewGRFFiles(NewGRFScanCallback *callback)
 		NetworkAfterNewGRFScan();
 	}
 
+	SaveScanCache();
+
 	/* Yes... these are the NewGRF windows */
 	InvalidateWindowClassesData(WC_SAVELOAD, 0, true);
 	InvalidateWindowData(WC_GAME_OPTIONS, WN_GAME_OPTIONS_NEWGRF_STATE, GOID_NEWGRF_RESCANNED, true);
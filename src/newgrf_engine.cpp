@@ -314,6 +314,27 @@ static uint8_t MapAircraftMovementAction(const Aircraft *v)
 	return this->v == nullptr ? 0 : this->v->waiting_triggers;
 }
 
+/* virtual */ bool VehicleScopeResolver::IsCacheableVariable(uint8_t variable) const
+{
+	/* Other vehicles of the chain do not necessarily invalidate the cache of this vehicle when they change. */
+	if (this->v == nullptr || this->v != static_cast<const VehicleResolverObject &>(this->ro).self_scope.v) return false;
+
+	switch (variable) {
+		/* The variables in the NewGRF cache of the vehicle. */
+		case 0x40:
+		case 0x41:
+		case 0x42:
+		case 0x43:
+		case 0x4D:
+		/* Random bits and triggers; TriggerVehicle() invalidates the cache when it changes them. */
+		case 0x5F:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
 
 /* virtual */ ScopeResolver *VehicleResolverObject::GetScope(VarSpriteGroupScope scope, uint8_t relative)
 {
@@ -986,6 +1007,9 @@ static uint32_t VehicleGetVariable(Vehicle *v, const VehicleScopeResolver *objec
 		return nullptr;
 	}
 
+	/* Unless there is just one set, it depends on the load of the vehicle. */
+	if (group->loaded.size() > 1 || group->loaded != group->loading) this->cacheable = false;
+
 	bool in_motion = !v->First()->current_order.IsType(OT_LOADING);
 
 	uint totalsets = in_motion ? (uint)group->loaded.size() : (uint)group->loading.size();
@@ -1072,8 +1096,20 @@ VehicleResolverObject::VehicleResolverObject(EngineID engine_type, const Vehicle
 
 void GetCustomEngineSprite(EngineID engine, const Vehicle *v, Direction direction, EngineImageType image_type, VehicleSpriteSeq *result)
 {
+	/* Vehicles are drawn again and again while nothing their sprites depend on changes. */
+	NewGRFSpriteCache *cache = v == nullptr ? nullptr : &v->grf_sprite_cache;
+	if (cache != nullptr && cache->valid && cache->engine == engine && cache->image_type == image_type) {
+		result->count = cache->count;
+		for (uint i = 0; i < cache->count; i++) {
+			result->seq[i].sprite = cache->sprites[i].sprite + (direction % cache->num_results[i]);
+			result->seq[i].pal    = cache->sprites[i].pal;
+		}
+		return;
+	}
+
 	VehicleResolverObject object(engine, v, VehicleResolverObject::WO_CACHED, false, CBID_NO_CALLBACK);
 	result->Clear();
+	if (cache != nullptr) cache->count = 0;
 
 	bool sprite_stack = HasBit(EngInfo(engine)->misc_flags, EF_SPRITE_STACK);
 	uint max_stack = sprite_stack ? lengthof(result->seq) : 1;
@@ -1085,10 +1121,21 @@ void GetCustomEngineSprite(EngineID engine, const Vehicle *v, Direction directio
 		if (group != nullptr && group->GetNumResults() != 0) {
 			result->seq[result->count].sprite = group->GetResult() + (direction % group->GetNumResults());
 			result->seq[result->count].pal    = GB(reg100, 0, 16); // zero means default recolouring
+			if (cache != nullptr) {
+				cache->sprites[result->count] = { group->GetResult(), result->seq[result->count].pal };
+				cache->num_results[result->count] = group->GetNumResults();
+			}
 			result->count++;
 		}
 		if (!HasBit(reg100, 31)) break;
 	}
+
+	if (cache != nullptr) {
+		cache->valid = object.cacheable;
+		cache->engine = engine;
+		cache->image_type = image_type;
+		cache->count = result->count;
+	}
 }
 
 
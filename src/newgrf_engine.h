@@ -40,6 +40,7 @@ struct VehicleScopeResolver : public ScopeResolver {
 
 	uint32_t GetRandomBits() const override;
 	uint32_t GetVariable(uint8_t variable, [[maybe_unused]] uint32_t parameter, bool *available) const override;
+	bool IsCacheableVariable(uint8_t variable) const override;
 	uint32_t GetTriggers() const override;
 };
 
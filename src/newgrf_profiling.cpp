@@ -16,8 +16,6 @@
 #include "timer/timer.h"
 #include "timer/timer_game_tick.h"
 
-#include <chrono>
-
 
 std::vector<NewGRFProfiler> _newgrf_profilers;
 
@@ -27,7 +25,7 @@ std::vector<NewGRFProfiler> _newgrf_profilers;
  * @param grffile   The GRF file to collect profiling data on
  * @param end_date  Game date to end profiling on
  */
-NewGRFProfiler::NewGRFProfiler(const GRFFile *grffile) : grffile{ grffile }, active{ false }, cur_call{}
+NewGRFProfiler::NewGRFProfiler(const GRFFile *grffile) : grffile{ grffile }, active{ false }, aggregate{ false }, cur_call{}
 {
 }
 
@@ -45,12 +43,17 @@ NewGRFProfiler::~NewGRFProfiler()
 void NewGRFProfiler::BeginResolve(const ResolverObject &resolver)
 {
 	using namespace std::chrono;
-	this->cur_call.root_sprite = resolver.root_spritegroup->nfo_line;
 	this->cur_call.subs = 0;
-	this->cur_call.time = (uint32_t)time_point_cast<microseconds>(high_resolution_clock::now()).time_since_epoch().count();
-	this->cur_call.tick = TimerGameTick::counter;
 	this->cur_call.cb = resolver.callback;
 	this->cur_call.feat = resolver.GetFeature();
+	if (this->aggregate) {
+		this->cur_call_start = high_resolution_clock::now();
+		return;
+	}
+
+	this->cur_call.root_sprite = resolver.root_spritegroup->nfo_line;
+	this->cur_call.time = (uint32_t)time_point_cast<microseconds>(high_resolution_clock::now()).time_since_epoch().count();
+	this->cur_call.tick = TimerGameTick::counter;
 	this->cur_call.item = resolver.GetDebugID();
 }
 
@@ -60,6 +63,20 @@ void NewGRFProfiler::BeginResolve(const ResolverObject &resolver)
 void NewGRFProfiler::EndResolve(const SpriteGroup *result)
 {
 	using namespace std::chrono;
+	if (this->aggregate) {
+		uint64_t time = duration_cast<nanoseconds>(high_resolution_clock::now() - this->cur_call_start).count();
+		CallStats &stats = this->stats[{ this->cur_call.feat, this->cur_call.cb }];
+		stats.count++;
+		stats.subs += this->cur_call.subs;
+		stats.time += time;
+		stats.max_time = std::max(stats.max_time, time);
+
+		uint bucket = 0;
+		for (uint64_t t = time / 250; t > 0 && bucket < CallStats::HISTOGRAM_BUCKETS - 1; t >>= 2) bucket++;
+		stats.histogram[bucket]++;
+		return;
+	}
+
 	this->cur_call.time = (uint32_t)time_point_cast<microseconds>(high_resolution_clock::now()).time_since_epoch().count() - this->cur_call.time;
 
 	if (result == nullptr) {
@@ -83,17 +100,64 @@ void NewGRFProfiler::RecursiveResolve()
 	this->cur_call.subs += 1;
 }
 
-void NewGRFProfiler::Start()
+/**
+ * Start collecting data.
+ * @param aggregate Whether to only collect aggregated data per feature and callback, which is cheap enough to leave running.
+ */
+void NewGRFProfiler::Start(bool aggregate)
 {
 	this->Abort();
 	this->active = true;
+	this->aggregate = aggregate;
 	this->start_tick = TimerGameTick::counter;
 }
 
+/**
+ * Print the aggregated data collected so far to the console, the callbacks taking the most time first.
+ */
+void NewGRFProfiler::PrintStats() const
+{
+	std::vector<std::pair<StatsKey, CallStats>> sorted(this->stats.begin(), this->stats.end());
+	std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) { return a.second.time > b.second.time; });
+
+	IConsolePrint(CC_DEBUG, "NewGRF [{:08X}] over {} ticks:", BSWAP32(this->grffile->grfid), TimerGameTick::counter - this->start_tick);
+	for (const auto &[key, s] : sorted) {
+		IConsolePrint(CC_DEBUG, "  feature {:#X}, callback {:#X}: {} calls, {} us total, {} ns average, {} us max",
+				key.first, (uint)key.second, s.count, s.time / 1000, s.time / s.count, s.max_time / 1000);
+	}
+}
+
 uint32_t NewGRFProfiler::Finish()
 {
 	if (!this->active) return 0;
 
+	if (this->aggregate) {
+		if (this->stats.empty()) {
+			IConsolePrint(CC_DEBUG, "Finished profile of NewGRF [{:08X}], no events collected, not writing a file.", BSWAP32(this->grffile->grfid));
+
+			this->Abort();
+			return 0;
+		}
+
+		std::string filename = this->GetOutputFilename();
+		IConsolePrint(CC_DEBUG, "Finished profile of NewGRF [{:08X}], writing statistics of {} callbacks to '{}'.", BSWAP32(this->grffile->grfid), this->stats.size(), filename);
+		this->PrintStats();
+
+		FILE *f = FioFOpenFile(filename, "wt", Subdirectory::NO_DIRECTORY);
+		FileCloser fcloser(f);
+
+		uint64_t total_nanoseconds = 0;
+
+		fmt::print(f, "Feature,CallbackID,Calls,Depth,Nanoseconds,MaxNanoseconds,Under250ns,Under1us,Under4us,Under16us,Under64us,Under256us,Under1ms,Over1ms\n");
+		for (const auto &[key, s] : this->stats) {
+			fmt::print(f, "{:#X},{:#X},{},{},{},{},{}\n", key.first, (uint)key.second, s.count, s.subs, s.time, s.max_time, fmt::join(s.histogram, ","));
+			total_nanoseconds += s.time;
+		}
+
+		this->Abort();
+		return static_cast<uint32_t>(total_nanoseconds / 1000);
+	}
+
 	if (this->calls.empty()) {
 		IConsolePrint(CC_DEBUG, "Finished profile of NewGRF [{:08X}], no events collected, not writing a file.", BSWAP32(this->grffile->grfid));
 
@@ -123,6 +187,7 @@ void NewGRFProfiler::Abort()
 {
 	this->active = false;
 	this->calls.clear();
+	this->stats.clear();
 }
 
 /**
@@ -131,7 +196,7 @@ void NewGRFProfiler::Abort()
  */
 std::string NewGRFProfiler::GetOutputFilename() const
 {
-	return fmt::format("{}grfprofile-{:%Y%m%d-%H%M}-{:08X}.csv", FiosGetScreenshotDir(), fmt::localtime(time(nullptr)), BSWAP32(this->grffile->grfid));
+	return fmt::format("{}grfprofile-{:%Y%m%d-%H%M}-{:08X}{}.csv", FiosGetScreenshotDir(), fmt::localtime(time(nullptr)), BSWAP32(this->grffile->grfid), this->aggregate ? "-stats" : "");
 }
 
 /* static */ uint32_t NewGRFProfiler::FinishAll()
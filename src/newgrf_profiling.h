@@ -16,6 +16,8 @@
 #include "newgrf_callbacks.h"
 #include "newgrf_spritegroup.h"
 
+#include <chrono>
+
 
 /**
  * Callback profiler for NewGRF development
@@ -28,9 +30,10 @@ struct NewGRFProfiler {
 	void EndResolve(const SpriteGroup *result);
 	void RecursiveResolve();
 
-	void Start();
+	void Start(bool aggregate = false);
 	uint32_t Finish();
 	void Abort();
+	void PrintStats() const;
 	std::string GetOutputFilename() const;
 
 	static void StartTimer(uint64_t ticks);
@@ -49,11 +52,26 @@ struct NewGRFProfiler {
 		GrfSpecFeature feat; ///< GRF feature being resolved for
 	};
 
+	/** Aggregated measurements of all sprite group resolutions of a callback of a feature. */
+	struct CallStats {
+		static constexpr uint HISTOGRAM_BUCKETS = 8; ///< Number of buckets of #histogram.
+
+		uint64_t count = 0;      ///< Number of resolutions
+		uint64_t subs = 0;       ///< Total number of sub-calls to other sprite groups
+		uint64_t time = 0;       ///< Total time taken for resolution (nanoseconds)
+		uint64_t max_time = 0;   ///< Longest time taken by a single resolution (nanoseconds)
+		std::array<uint64_t, HISTOGRAM_BUCKETS> histogram{}; ///< Number of resolutions taking less than 250 ns, 1 us, 4 us and so on, with the last bucket for the rest
+	};
+	using StatsKey = std::pair<GrfSpecFeature, CallbackID>; ///< Feature and callback the statistics are for.
+
 	const GRFFile *grffile;  ///< Which GRF is being profiled
 	bool active;             ///< Is this profiler collecting data
+	bool aggregate;          ///< Is only aggregated data collected, instead of every call
 	uint64_t start_tick;       ///< Tick number this profiler was started on
 	Call cur_call;           ///< Data for current call in progress
+	std::chrono::high_resolution_clock::time_point cur_call_start; ///< Start of the current call in progress, when aggregating
 	std::vector<Call> calls; ///< All calls collected so far
+	std::map<StatsKey, CallStats> stats; ///< Aggregated data collected so far
 };
 
 extern std::vector<NewGRFProfiler> _newgrf_profilers;
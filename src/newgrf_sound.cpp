@@ -156,7 +156,7 @@ bool LoadNewGRFSound(SoundEntry *sound)
 	Debug(grf, 1, "LoadNewGRFSound [{}]: RIFF does not contain any sound data", file.GetSimplifiedFilename());
 
 	/* Clear everything that was read */
-	MemSetT(sound, 0);
+	*sound = {};
 	return false;
 }
 
@@ -188,6 +188,9 @@ bool PlayVehicleSound(const Vehicle *v, VehicleSoundEvent event, bool force)
 {
 	if (!_settings_client.sound.vehicle && !force) return true;
 
+	/* A sound nobody can hear is as good as played, also for the default sound; skip the callback. */
+	if (!IsVehicleSoundAudible(v)) return true;
+
 	const GRFFile *file = v->GetGRF();
 	uint16_t callback;
 
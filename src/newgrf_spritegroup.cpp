@@ -11,6 +11,7 @@
 #include "debug.h"
 #include "newgrf_spritegroup.h"
 #include "newgrf_profiling.h"
+#include "newgrf.h"
 #include "core/pool_func.hpp"
 
 #include "safeguards.h"
@@ -60,9 +61,12 @@ static inline uint32_t GetVariable(const ResolverObject &object, ScopeResolver *
 		case 0x0C: return object.callback;
 		case 0x10: return object.callback_param1;
 		case 0x18: return object.callback_param2;
+		case 0x1A: return UINT_MAX;
 		case 0x1C: return object.last_value;
 
-		case 0x5F: return (scope->GetRandomBits() << 8) | scope->GetTriggers();
+		case 0x5F:
+			if (!scope->IsCacheableVariable(variable)) object.cacheable = false;
+			return (scope->GetRandomBits() << 8) | scope->GetTriggers();
 
 		case 0x7D: return _temp_store.GetValue(parameter);
 
@@ -72,8 +76,12 @@ static inline uint32_t GetVariable(const ResolverObject &object, ScopeResolver *
 
 		default:
 			/* First handle variables common with Action7/9/D */
-			if (variable < 0x40 && GetGlobalVariable(variable, &value, object.grffile)) return value;
+			if (variable < 0x40 && GetGlobalVariable(variable, &value, object.grffile)) {
+				object.cacheable = false;
+				return value;
+			}
 			/* Not a common variable, so evaluate the feature specific variables */
+			if (!scope->IsCacheableVariable(variable)) object.cacheable = false;
 			return scope->GetVariable(variable, parameter, available);
 	}
 }
@@ -110,6 +118,18 @@ static inline uint32_t GetVariable(const ResolverObject &object, ScopeResolver *
 	return UINT_MAX;
 }
 
+/**
+ * Check whether a variable only changes when the NewGRF cache of the object
+ * is invalidated, so results that only depend on such variables can be kept
+ * until then. Default implementation has no such variables.
+ * @param variable Variable to check; 5F also covers the random bits used by random sprite groups.
+ * @return True if the variable can be cached.
+ */
+/* virtual */ bool ScopeResolver::IsCacheableVariable([[maybe_unused]] uint8_t variable) const
+{
+	return false;
+}
+
 /**
  * Store a value into the persistent storage area (PSA). Default implementation does nothing (for newgrf classes without storage).
  */
@@ -180,21 +200,22 @@ static U EvalAdjustT(const DeterministicSpriteGroupAdjust &adjust, ScopeResolver
 }
 
 
-static bool RangeHighComparator(const DeterministicSpriteGroupRange &range, uint32_t value)
-{
-	return range.high < value;
-}
-
-const SpriteGroup *DeterministicSpriteGroup::Resolve(ResolverObject &object) const
+/**
+ * Evaluate the adjusts of a deterministic sprite group for variables of the given size.
+ * U is the unsigned type and S is the signed type to use.
+ * @param adjusts The adjusts to evaluate.
+ * @param object The object to resolve for.
+ * @param scope The scope of the variables.
+ * @param[out] last_value The result of the adjusts.
+ * @return False if a variable is not available.
+ */
+template <typename U, typename S>
+static bool EvalAdjustsT(const std::vector<DeterministicSpriteGroupAdjust> &adjusts, ResolverObject &object, ScopeResolver *scope, uint32_t &last_value)
 {
-	uint32_t last_value = 0;
-	uint32_t value = 0;
-
-	ScopeResolver *scope = object.GetScope(this->var_scope);
-
-	for (const auto &adjust : this->adjusts) {
+	for (const auto &adjust : adjusts) {
 		/* Try to get the variable. We shall assume it is available, unless told otherwise. */
 		bool available = true;
+		uint32_t value;
 		if (adjust.variable == 0x7E) {
 			const SpriteGroup *subgroup = SpriteGroup::Resolve(adjust.subroutine, object, false);
 			if (subgroup == nullptr) {
@@ -210,21 +231,140 @@ const SpriteGroup *DeterministicSpriteGroup::Resolve(ResolverObject &object) con
 			value = GetVariable(object, scope, adjust.variable, adjust.parameter, &available);
 		}
 
-		if (!available) {
-			/* Unsupported variable: skip further processing and return either
-			 * the group from the first range or the default group. */
-			return SpriteGroup::Resolve(this->error_group, object, false);
+		if (!available) return false;
+
+		last_value = EvalAdjustT<U, S>(adjust, scope, last_value, value);
+	}
+	return true;
+}
+
+/**
+ * Get whether a variable never changes during a game.
+ * @param variable The variable.
+ * @return True if the variable is a constant.
+ */
+static bool IsConstantVariable(uint8_t variable)
+{
+	switch (variable) {
+		case 0x03: // climate
+		case 0x0B: // TTDPatch version
+		case 0x11: // current rail tool type, fake
+		case 0x1A: // always -1
+		case 0x1B: // display options, fake
+		case 0x1D: // TTD platform
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+/**
+ * Get whether a variable only depends on the current calendar date.
+ * @param variable The variable.
+ * @return True if the variable only changes when the date does.
+ */
+static bool IsDateVariable(uint8_t variable)
+{
+	return variable == 0x00 || variable == 0x01 || variable == 0x02;
+}
+
+/**
+ * Work out what the result of the adjusts depends on, and evaluate them
+ * right away when that is nothing that changes during the game. Resolving
+ * the group then no longer has to walk the adjusts, or does so only once
+ * per day. GRF parameters (variable 0x7F) are not treated as constants,
+ * because action D can still change them after the group has been defined.
+ */
+void DeterministicSpriteGroup::AnalyseAdjusts()
+{
+	this->inputs = DeterministicSpriteGroupInputs::Constant;
+	for (const auto &adjust : this->adjusts) {
+		if (adjust.operation == DSGA_OP_STO || adjust.operation == DSGA_OP_STOP) {
+			this->inputs = DeterministicSpriteGroupInputs::Any;
+			return;
 		}
+		if (IsDateVariable(adjust.variable)) {
+			this->inputs = DeterministicSpriteGroupInputs::Date;
+		} else if (!IsConstantVariable(adjust.variable) || adjust.type != DSGA_TYPE_NONE) {
+			/* Division or modulo of constants are left to the time of resolving, in case they divide by zero. */
+			this->inputs = DeterministicSpriteGroupInputs::Any;
+			return;
+		}
+	}
+	if (this->inputs != DeterministicSpriteGroupInputs::Constant) return;
 
+	uint32_t value = 0;
+	for (const auto &adjust : this->adjusts) {
+		uint32_t var_value;
+		[[maybe_unused]] bool found = GetGlobalVariable(adjust.variable, &var_value, nullptr);
+		assert(found);
 		switch (this->size) {
-			case DSG_SIZE_BYTE:  value = EvalAdjustT<uint8_t,  int8_t> (adjust, scope, last_value, value); break;
-			case DSG_SIZE_WORD:  value = EvalAdjustT<uint16_t, int16_t>(adjust, scope, last_value, value); break;
-			case DSG_SIZE_DWORD: value = EvalAdjustT<uint32_t, int32_t>(adjust, scope, last_value, value); break;
+			case DSG_SIZE_BYTE:  value = EvalAdjustT<uint8_t,  int8_t> (adjust, nullptr, value, var_value); break;
+			case DSG_SIZE_WORD:  value = EvalAdjustT<uint16_t, int16_t>(adjust, nullptr, value, var_value); break;
+			case DSG_SIZE_DWORD: value = EvalAdjustT<uint32_t, int32_t>(adjust, nullptr, value, var_value); break;
 			default: NOT_REACHED();
 		}
-		last_value = value;
 	}
+	this->constant_value = value;
+}
 
+/**
+ * Evaluate the adjusts of this group.
+ * @param object The object to resolve for.
+ * @param[out] last_value The result of the adjusts.
+ * @return False if a variable is not available.
+ */
+bool DeterministicSpriteGroup::EvalAdjusts(ResolverObject &object, uint32_t &last_value) const
+{
+	ScopeResolver *scope = object.GetScope(this->var_scope);
+	last_value = 0;
+
+	switch (this->size) {
+		case DSG_SIZE_BYTE:  return EvalAdjustsT<uint8_t,  int8_t> (this->adjusts, object, scope, last_value);
+		case DSG_SIZE_WORD:  return EvalAdjustsT<uint16_t, int16_t>(this->adjusts, object, scope, last_value);
+		case DSG_SIZE_DWORD: return EvalAdjustsT<uint32_t, int32_t>(this->adjusts, object, scope, last_value);
+		default: NOT_REACHED();
+	}
+}
+
+static bool RangeHighComparator(const DeterministicSpriteGroupRange &range, uint32_t value)
+{
+	return range.high < value;
+}
+
+const SpriteGroup *DeterministicSpriteGroup::Resolve(ResolverObject &object) const
+{
+	uint32_t last_value;
+	bool available = true;
+
+	switch (this->inputs) {
+		case DeterministicSpriteGroupInputs::Constant:
+			last_value = this->constant_value;
+			break;
+
+		case DeterministicSpriteGroupInputs::Date:
+			/* NewGRF sprites are only resolved from the main thread, so the cache needs no locking. */
+			if (this->cached_date != TimerGameCalendar::date) {
+				available = this->EvalAdjusts(object, this->cached_value);
+				this->cached_date = TimerGameCalendar::date;
+			}
+			object.cacheable = false;
+			last_value = this->cached_value;
+			break;
+
+		default:
+			available = this->EvalAdjusts(object, last_value);
+			break;
+	}
+
+	if (!available) {
+		/* Unsupported variable: skip further processing and return either
+		 * the group from the first range or the default group. */
+		return SpriteGroup::Resolve(this->error_group, object, false);
+	}
+
+	uint32_t value = last_value;
 	object.last_value = last_value;
 
 	if (this->calculated_result) {
@@ -267,6 +407,8 @@ const SpriteGroup *RandomizedSpriteGroup::Resolve(ResolverObject &object) const
 		}
 	}
 
+	if (!scope->IsCacheableVariable(0x5F)) object.cacheable = false;
+
 	uint32_t mask = ((uint)this->groups.size() - 1) << this->lowest_randbit;
 	uint8_t index = (scope->GetRandomBits() & mask) >> this->lowest_randbit;
 
@@ -14,6 +14,7 @@
 #include "engine_type.h"
 #include "house_type.h"
 #include "industry_type.h"
+#include "timer/timer_game_calendar.h"
 
 #include "newgrf_callbacks.h"
 #include "newgrf_generic.h"
@@ -144,6 +145,13 @@ enum DeterministicSpriteGroupAdjustOperation {
 };
 
 
+/** What the result of the adjusts of a deterministic sprite group depends on. */
+enum class DeterministicSpriteGroupInputs : uint8_t {
+	Constant, ///< Nothing that changes during a game; the result is computed when loading the group.
+	Date,     ///< The current calendar date; the result is computed once per day.
+	Any,      ///< The resolved object or anything else; the result is computed every time.
+};
+
 struct DeterministicSpriteGroupAdjust {
 	DeterministicSpriteGroupAdjustOperation operation;
 	DeterministicSpriteGroupAdjustType type;
@@ -178,8 +186,18 @@ struct DeterministicSpriteGroup : SpriteGroup {
 
 	const SpriteGroup *error_group; // was first range, before sorting ranges
 
+	DeterministicSpriteGroupInputs inputs = DeterministicSpriteGroupInputs::Any; ///< What the result of the adjusts depends on.
+	uint32_t constant_value = 0; ///< Result of the adjusts, if they are constant.
+	mutable TimerGameCalendar::Date cached_date = CalendarTime::INVALID_DATE; ///< Date #cached_value was evaluated for, if the adjusts only depend on the date.
+	mutable uint32_t cached_value = 0; ///< Result of the adjusts at #cached_date.
+
+	void AnalyseAdjusts();
+
 protected:
 	const SpriteGroup *Resolve(ResolverObject &object) const override;
+
+private:
+	bool EvalAdjusts(ResolverObject &object, uint32_t &last_value) const;
 };
 
 enum RandomizedSpriteGroupCompareMode {
@@ -295,6 +313,7 @@ struct ScopeResolver {
 	virtual uint32_t GetTriggers() const;
 
 	virtual uint32_t GetVariable(uint8_t variable, [[maybe_unused]] uint32_t parameter, bool *available) const;
+	virtual bool IsCacheableVariable(uint8_t variable) const;
 	virtual void StorePSA(uint reg, int32_t value);
 };
 
@@ -327,6 +346,7 @@ struct ResolverObject {
 	uint32_t callback_param2;     ///< Second parameter (var 18) of the callback.
 
 	uint32_t last_value;          ///< Result of most recent DeterministicSpriteGroup (including procedure calls)
+	mutable bool cacheable = true; ///< Whether everything read while resolving only changes when the NewGRF cache of the object is invalidated, see ScopeResolver::IsCacheableVariable.
 
 	uint32_t waiting_triggers;    ///< Waiting triggers to be used by any rerandomisation. (scope independent)
 	uint32_t used_triggers;       ///< Subset of cur_triggers, which actually triggered some rerandomisation. (scope independent)
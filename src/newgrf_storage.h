@@ -68,12 +68,12 @@ struct PersistentStorageArray : BasePersistentStorageArray {
 	using StorageType = std::array<TYPE, SIZE>;
 
 	StorageType storage{}; ///< Memory for the storage array
-	std::unique_ptr<StorageType> prev_storage{}; ///< Temporary memory to store previous state so it can be reverted, e.g. for command tests.
+	std::vector<std::pair<uint, TYPE>> prev_values{}; ///< Previous values of the temporarily changed positions, oldest first, so they can be reverted, e.g. for command tests.
 
 	/**
 	 * Stores some value at a given position.
-	 * If there is no backup of the data that backup is made and then
-	 * we write the data.
+	 * If the change is temporary, the previous value is recorded
+	 * first, so only the changed positions have to be reverted.
 	 * @param pos   the position to write at
 	 * @param value the value to write
 	 */
@@ -86,15 +86,13 @@ struct PersistentStorageArray : BasePersistentStorageArray {
 		 * Saves a few cycles and such and it's pretty easy to check. */
 		if (this->storage[pos] == value) return;
 
-		/* We do not have made a backup; lets do so */
 		if (AreChangesPersistent()) {
-			assert(!this->prev_storage);
-		} else if (!this->prev_storage) {
-			this->prev_storage = std::make_unique<StorageType>(this->storage);
-
-			/* We only need to register ourselves when we made the backup
+			assert(this->prev_values.empty());
+		} else {
+			/* We only need to register ourselves for the first change,
 			 * as that is the only time something will have changed */
-			AddChangedPersistentStorage(this);
+			if (this->prev_values.empty()) AddChangedPersistentStorage(this);
+			this->prev_values.emplace_back(pos, this->storage[pos]);
 		}
 
 		this->storage[pos] = value;
@@ -115,10 +113,11 @@ struct PersistentStorageArray : BasePersistentStorageArray {
 
 	void ClearChanges() override
 	{
-		if (this->prev_storage) {
-			this->storage = *this->prev_storage;
-			this->prev_storage.reset();
+		/* Revert newest first, so a position changed several times ends up with its oldest value. */
+		for (auto it = this->prev_values.rbegin(); it != this->prev_values.rend(); ++it) {
+			this->storage[it->first] = it->second;
 		}
+		this->prev_values.clear();
 	}
 };
 
@@ -27,6 +27,7 @@
 #include "debug.h"
 #include "core/alloc_type.hpp"
 #include "language.h"
+#include "video/video_driver.hpp"
 #include <sstream>
 
 #include "table/strings.h"
@@ -537,6 +538,16 @@ void AddGRFTextToList(GRFTextWrapper &list, const std::string &text_to_add)
 	AddGRFTextToList(*list, GRFLX_UNSPECIFIED, text_to_add);
 }
 
+/**
+ * Check whether a text in the given language can be shown in the current language.
+ * @param langid The NewGRF language ID of the text.
+ * @return True iff GetGRFStringFromGRFText may return texts in this language.
+ */
+static bool IsGRFLanguageShown(uint8_t langid)
+{
+	return langid == _currentLangID || langid == GRFLX_UNSPECIFIED || langid == GRFLX_ENGLISH || langid == GRFLX_AMERICAN;
+}
+
 /**
  * Add the new read string into our structure.
  */
@@ -573,6 +584,12 @@ StringID AddGRFString(uint32_t grfid, uint16_t stringid, uint8_t langid_to_add,
 	}
 	uint id = static_cast<uint>(it - std::begin(_grf_text));
 
+	/* Without a GUI the language can never change, so only the texts that can be shown in the current language are kept. */
+	if (VideoDriver::GetInstance() != nullptr && !VideoDriver::GetInstance()->HasGUI() && !IsGRFLanguageShown(langid_to_add)) {
+		GrfMsg(3, "Skipped 0x{:X} grfid {:08X} string 0x{:X} lang 0x{:X}, it is never shown", id, grfid, stringid, langid_to_add);
+		return MakeStringID(TEXT_TAB_NEWGRF_START, id);
+	}
+
 	std::string newtext = TranslateTTDPatchCodes(grfid, langid_to_add, allow_newlines, text_to_add);
 	AddGRFTextToList(it->textholder, langid_to_add, newtext);
 
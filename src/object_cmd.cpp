@@ -132,6 +132,8 @@ void BuildObject(ObjectType type, TileIndex tile, CompanyID owner, Town *town, u
 		MarkTileDirtyByTile(t);
 	}
 
+	InvalidateStationAcceptanceCache(ta);
+
 	Object::IncTypeCount(type);
 	if (spec->flags & OBJECT_FLAG_ANIMATION) TriggerObjectAnimation(o, OAT_BUILT, spec);
 }
@@ -405,8 +407,7 @@ CommandCost CmdBuildObjectArea(DoCommandFlag flags, TileIndex tile, TileIndex st
 	const Company *c = Company::GetIfValid(_current_company);
 	int limit = (c == nullptr ? INT32_MAX : GB(c->build_object_limit, 16, 16));
 
-	std::unique_ptr<TileIterator> iter = TileIterator::Create(tile, start_tile, diagonal);
-	for (; *iter != INVALID_TILE; ++(*iter)) {
+	for (BatchedRedrawTileIterator iter(tile, start_tile, diagonal); *iter != INVALID_TILE; ++iter) {
 		TileIndex t = *iter;
 		CommandCost ret = Command<CMD_BUILD_OBJECT>::Do(flags & ~DC_EXEC, t, type, view);
 
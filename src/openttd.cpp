@@ -12,6 +12,7 @@
 #include "blitter/factory.hpp"
 #include "sound/sound_driver.hpp"
 #include "music/music_driver.hpp"
+#include "music/midifile.hpp"
 #include "video/video_driver.hpp"
 #include "mixer.h"
 
@@ -63,10 +64,11 @@
 #include "game/game_config.hpp"
 #include "town.h"
 #include "subsidy_func.h"
-#include "gfx_layout.h"
 #include "viewport_func.h"
 #include "viewport_sprite_sorter.h"
 #include "framerate_type.h"
+#include "trace.h"
+#include "thread.h"
 #include "industry.h"
 #include "network/network_gui.h"
 #include "network/network_survey.h"
@@ -77,6 +79,7 @@
 #include "timer/timer_game_realtime.h"
 #include "timer/timer_game_tick.h"
 #include "social_integration.h"
+#include "scan_cache.h"
 
 #include "linkgraph/linkgraphschedule.h"
 
@@ -103,6 +106,7 @@ extern void ShowOSErrorBox(const char *buf, bool system);
 extern std::string _config_file;
 
 bool _save_config = false;
+uint8_t _game_loop_threads = 0; ///< Maximum number of threads for the parallel phases of the game loop; 0 or 1 means serial.
 bool _request_newgrf_scan = false;
 NewGRFScanCallback *_request_newgrf_scan_callback = nullptr;
 
@@ -161,6 +165,8 @@ static void ShowHelp()
 		"  -s drv              = Set sound driver (see below)\n"
 		"  -m drv              = Set music driver (see below)\n"
 		"  -b drv              = Set the blitter to use (see below)\n"
+		"  -B file             = Benchmark: run the game of -g headless for the ticks of\n"
+		"                        -v null:ticks=N as fast as possible, write timings to file\n"
 		"  -r res              = Set resolution (for instance 800x600)\n"
 		"  -h                  = Display this help text\n"
 		"  -t year             = Set starting year\n"
@@ -292,6 +298,7 @@ static void ShutdownGame()
 
 	SocialIntegration::Shutdown();
 	DriverFactoryBase::ShutdownDrivers();
+	MidiFile::ForgetPreparedSongs();
 
 	UnInitWindowSystem();
 
@@ -470,6 +477,8 @@ void PostMainLoop()
 		SaveToHighScore();
 	}
 
+	SaveScanCache();
+
 	/* Reset windowing system, stop drivers, free used memory, ... */
 	ShutdownGame();
 }
@@ -487,6 +496,7 @@ static const OptionData _options[] = {
 	 GETOPT_SHORT_VALUE('s'),
 	 GETOPT_SHORT_VALUE('v'),
 	 GETOPT_SHORT_VALUE('b'),
+	 GETOPT_SHORT_VALUE('B'),
 	GETOPT_SHORT_OPTVAL('D'),
 	 GETOPT_SHORT_VALUE('n'),
 	 GETOPT_SHORT_VALUE('p'),
@@ -551,6 +561,7 @@ int openttd_main(int argc, char *argv[])
 		case 's': sounddriver = mgo.opt; break;
 		case 'v': videodriver = mgo.opt; break;
 		case 'b': blitter = mgo.opt; break;
+		case 'B': _framerate_benchmark_file = mgo.opt; break;
 		case 'D':
 			musicdriver = "null";
 			sounddriver = "null";
@@ -679,6 +690,13 @@ int openttd_main(int argc, char *argv[])
 	DeterminePaths(argv[0], only_local_path);
 	TarScanner::DoScan(TarScanner::BASESET);
 
+	if (!_framerate_benchmark_file.empty()) {
+		/* Benchmarks run headless, as fast as possible. */
+		if (videodriver.empty()) videodriver = "null";
+		if (sounddriver.empty()) sounddriver = "null";
+		if (musicdriver.empty()) musicdriver = "null";
+	}
+
 	if (dedicated) Debug(net, 3, "Starting dedicated server, version {}", _openttd_revision);
 	if (_dedicated_forks && !dedicated) _dedicated_forks = false;
 
@@ -788,26 +806,32 @@ int openttd_main(int argc, char *argv[])
 	InitializeScreenshotFormats();
 
 	BaseSounds::FindSets();
-	if (sounds_set.empty() && !BaseSounds::ini_set.empty()) sounds_set = BaseSounds::ini_set;
-	if (!BaseSounds::SetSetByName(sounds_set)) {
-		if (sounds_set.empty() || !BaseSounds::SetSet({})) {
-			UserError("Failed to find a sounds set. Please acquire a sounds set for OpenTTD. See section 1.4 of README.md.");
-		} else {
-			ErrorMessageData msg(STR_CONFIG_ERROR, STR_CONFIG_ERROR_INVALID_BASE_SOUNDS_NOT_FOUND);
-			msg.SetDParamStr(0, sounds_set);
-			ScheduleErrorMessage(msg);
+	/* A dedicated server does not play any sounds, so unless told otherwise it does not even read them. */
+	if (!dedicated || !sounds_set.empty() || !BaseSounds::SetEmptySet()) {
+		if (sounds_set.empty() && !BaseSounds::ini_set.empty()) sounds_set = BaseSounds::ini_set;
+		if (!BaseSounds::SetSetByName(sounds_set)) {
+			if (sounds_set.empty() || !BaseSounds::SetSet({})) {
+				UserError("Failed to find a sounds set. Please acquire a sounds set for OpenTTD. See section 1.4 of README.md.");
+			} else {
+				ErrorMessageData msg(STR_CONFIG_ERROR, STR_CONFIG_ERROR_INVALID_BASE_SOUNDS_NOT_FOUND);
+				msg.SetDParamStr(0, sounds_set);
+				ScheduleErrorMessage(msg);
+			}
 		}
 	}
 
 	BaseMusic::FindSets();
-	if (music_set.empty() && !BaseMusic::ini_set.empty()) music_set = BaseMusic::ini_set;
-	if (!BaseMusic::SetSetByName(music_set)) {
-		if (music_set.empty() || !BaseMusic::SetSet({})) {
-			UserError("Failed to find a music set. Please acquire a music set for OpenTTD. See section 1.4 of README.md.");
-		} else {
-			ErrorMessageData msg(STR_CONFIG_ERROR, STR_CONFIG_ERROR_INVALID_BASE_MUSIC_NOT_FOUND);
-			msg.SetDParamStr(0, music_set);
-			ScheduleErrorMessage(msg);
+	/* A dedicated server does not play any music, so unless told otherwise it does not even read it. */
+	if (!dedicated || !music_set.empty() || !BaseMusic::SetEmptySet()) {
+		if (music_set.empty() && !BaseMusic::ini_set.empty()) music_set = BaseMusic::ini_set;
+		if (!BaseMusic::SetSetByName(music_set)) {
+			if (music_set.empty() || !BaseMusic::SetSet({})) {
+				UserError("Failed to find a music set. Please acquire a music set for OpenTTD. See section 1.4 of README.md.");
+			} else {
+				ErrorMessageData msg(STR_CONFIG_ERROR, STR_CONFIG_ERROR_INVALID_BASE_MUSIC_NOT_FOUND);
+				msg.SetDParamStr(0, music_set);
+				ScheduleErrorMessage(msg);
+			}
 		}
 	}
 
@@ -1232,19 +1256,16 @@ void SwitchToMode(SwitchMode new_mode)
 }
 
 
-/**
- * Check the validity of some of the caches.
- * Especially in the sense of desyncs between
- * the cached value and what the value would
- * be when calculated from the 'base' data.
- */
-static void CheckCaches()
-{
-	/* Return here so it is easy to add checks that are run
-	 * always to aid testing of caches. */
-	if (_debug_desync_level <= 1) return;
+uint16_t _cache_check_objects = 0; ///< Number of vehicles and stations of which the caches are checked each tick; 0 disables the incremental check.
+static size_t _cache_check_next_vehicle = 0; ///< Pool index of the vehicle the incremental cache check continues with.
+static size_t _cache_check_next_station = 0; ///< Pool index of the station the incremental cache check continues with.
 
-	/* Check the town caches. */
+/** Minimum number of cargo lists worth checking on an extra thread. */
+static const size_t MIN_CARGO_CACHE_CHECKS_PER_THREAD = 256;
+
+/** Check the caches of the towns and the subsidised flags of the sources and destinations. */
+static void CheckTownCaches()
+{
 	std::vector<TownCache> old_town_caches;
 	for (const Town *t : Town::Iterate()) {
 		old_town_caches.push_back(t->cache);
@@ -1256,115 +1277,242 @@ static void CheckCaches()
 	uint i = 0;
 	for (Town *t : Town::Iterate()) {
 		if (MemCmpT(old_town_caches.data() + i, &t->cache) != 0) {
-			Debug(desync, 2, "town cache mismatch: town {}", t->index);
+			Debug(desync, 0, "town cache mismatch: town {}", t->index);
 		}
 		i++;
 	}
+}
 
-	/* Check company infrastructure cache. */
+/** Check the infrastructure caches of the companies. */
+static void CheckInfrastructureCaches()
+{
 	std::vector<CompanyInfrastructure> old_infrastructure;
 	for (const Company *c : Company::Iterate()) old_infrastructure.push_back(c->infrastructure);
 
 	AfterLoadCompanyStats();
 
-	i = 0;
+	uint i = 0;
 	for (const Company *c : Company::Iterate()) {
 		if (MemCmpT(old_infrastructure.data() + i, &c->infrastructure) != 0) {
-			Debug(desync, 2, "infrastructure cache mismatch: company {}", c->index);
+			Debug(desync, 0, "infrastructure cache mismatch: company {}", c->index);
 		}
 		i++;
 	}
+}
 
-	/* Strict checking of the road stop cache entries */
-	for (const RoadStop *rs : RoadStop::Iterate()) {
-		if (IsBayRoadStopTile(rs->xy)) continue;
+/**
+ * Check the caches of a vehicle chain by recalculating them.
+ * @param v The first vehicle of the chain.
+ */
+static void CheckVehicleCaches(Vehicle *v)
+{
+	if (v != v->First() || v->vehstatus & VS_CRASHED || !v->IsPrimaryVehicle()) return;
+
+	uint length = 0;
+	for (const Vehicle *u = v; u != nullptr; u = u->Next()) length++;
+
+	NewGRFCache        *grf_cache = CallocT<NewGRFCache>(length);
+	VehicleCache       *veh_cache = CallocT<VehicleCache>(length);
+	GroundVehicleCache *gro_cache = CallocT<GroundVehicleCache>(length);
+	TrainCache         *tra_cache = CallocT<TrainCache>(length);
+
+	length = 0;
+	for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
+		FillNewGRFVehicleCache(u);
+		grf_cache[length] = u->grf_cache;
+		veh_cache[length] = u->vcache;
+		switch (u->type) {
+			case VEH_TRAIN:
+				gro_cache[length] = Train::From(u)->gcache;
+				tra_cache[length] = Train::From(u)->tcache;
+				break;
+			case VEH_ROAD:
+				gro_cache[length] = RoadVehicle::From(u)->gcache;
+				break;
+			default:
+				break;
+		}
+		length++;
+	}
 
-		assert(rs->GetEntry(DIAGDIR_NE) != rs->GetEntry(DIAGDIR_NW));
-		rs->GetEntry(DIAGDIR_NE)->CheckIntegrity(rs);
-		rs->GetEntry(DIAGDIR_NW)->CheckIntegrity(rs);
+	switch (v->type) {
+		case VEH_TRAIN:    Train::From(v)->ConsistChanged(CCF_TRACK); break;
+		case VEH_ROAD:     RoadVehUpdateCache(RoadVehicle::From(v)); break;
+		case VEH_AIRCRAFT: UpdateAircraftCache(Aircraft::From(v));   break;
+		case VEH_SHIP:     Ship::From(v)->UpdateCache();             break;
+		default: break;
 	}
 
-	for (Vehicle *v : Vehicle::Iterate()) {
-		if (v != v->First() || v->vehstatus & VS_CRASHED || !v->IsPrimaryVehicle()) continue;
-
-		uint length = 0;
-		for (const Vehicle *u = v; u != nullptr; u = u->Next()) length++;
-
-		NewGRFCache        *grf_cache = CallocT<NewGRFCache>(length);
-		VehicleCache       *veh_cache = CallocT<VehicleCache>(length);
-		GroundVehicleCache *gro_cache = CallocT<GroundVehicleCache>(length);
-		TrainCache         *tra_cache = CallocT<TrainCache>(length);
-
-		length = 0;
-		for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
-			FillNewGRFVehicleCache(u);
-			grf_cache[length] = u->grf_cache;
-			veh_cache[length] = u->vcache;
-			switch (u->type) {
-				case VEH_TRAIN:
-					gro_cache[length] = Train::From(u)->gcache;
-					tra_cache[length] = Train::From(u)->tcache;
-					break;
-				case VEH_ROAD:
-					gro_cache[length] = RoadVehicle::From(u)->gcache;
-					break;
-				default:
-					break;
-			}
-			length++;
+	length = 0;
+	for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
+		FillNewGRFVehicleCache(u);
+		if (memcmp(&grf_cache[length], &u->grf_cache, sizeof(NewGRFCache)) != 0) {
+			Debug(desync, 0, "newgrf cache mismatch: type {}, vehicle {}, company {}, unit number {}, wagon {}", v->type, v->index, v->owner, v->unitnumber, length);
+		}
+		if (memcmp(&veh_cache[length], &u->vcache, sizeof(VehicleCache)) != 0) {
+			Debug(desync, 0, "vehicle cache mismatch: type {}, vehicle {}, company {}, unit number {}, wagon {}", v->type, v->index, v->owner, v->unitnumber, length);
 		}
+		switch (u->type) {
+			case VEH_TRAIN:
+				if (memcmp(&gro_cache[length], &Train::From(u)->gcache, sizeof(GroundVehicleCache)) != 0) {
+					Debug(desync, 0, "train ground vehicle cache mismatch: vehicle {}, company {}, unit number {}, wagon {}", v->index, v->owner, v->unitnumber, length);
+				}
+				if (memcmp(&tra_cache[length], &Train::From(u)->tcache, sizeof(TrainCache)) != 0) {
+					Debug(desync, 0, "train cache mismatch: vehicle {}, company {}, unit number {}, wagon {}", v->index, v->owner, v->unitnumber, length);
+				}
+				break;
+			case VEH_ROAD:
+				if (memcmp(&gro_cache[length], &RoadVehicle::From(u)->gcache, sizeof(GroundVehicleCache)) != 0) {
+					Debug(desync, 0, "road vehicle ground vehicle cache mismatch: vehicle {}, company {}, unit number {}, wagon {}", v->index, v->owner, v->unitnumber, length);
+				}
+				break;
+			default:
+				break;
+		}
+		length++;
+	}
 
-		switch (v->type) {
-			case VEH_TRAIN:    Train::From(v)->ConsistChanged(CCF_TRACK); break;
-			case VEH_ROAD:     RoadVehUpdateCache(RoadVehicle::From(v)); break;
-			case VEH_AIRCRAFT: UpdateAircraftCache(Aircraft::From(v));   break;
-			case VEH_SHIP:     Ship::From(v)->UpdateCache();             break;
-			default: break;
+	free(grf_cache);
+	free(veh_cache);
+	free(gro_cache);
+	free(tra_cache);
+}
+
+/**
+ * Check the cargo caches of vehicles.
+ * Every cargo list only depends on its own packets, so they are checked on the game loop threads.
+ * @param vehicles The vehicles to check.
+ */
+static void CheckVehicleCargoCaches(std::span<Vehicle * const> vehicles)
+{
+	RunInChunks(vehicles, MIN_CARGO_CACHE_CHECKS_PER_THREAD, [](std::span<Vehicle * const> chunk) {
+		for (Vehicle *v : chunk) {
+			uint8_t buff[sizeof(VehicleCargoList)];
+			memcpy(buff, &v->cargo, sizeof(VehicleCargoList));
+			v->cargo.InvalidateCache();
+			assert(memcmp(&v->cargo, buff, sizeof(VehicleCargoList)) == 0);
 		}
+	});
+}
 
-		length = 0;
-		for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
-			FillNewGRFVehicleCache(u);
-			if (memcmp(&grf_cache[length], &u->grf_cache, sizeof(NewGRFCache)) != 0) {
-				Debug(desync, 2, "newgrf cache mismatch: type {}, vehicle {}, company {}, unit number {}, wagon {}", v->type, v->index, v->owner, v->unitnumber, length);
-			}
-			if (memcmp(&veh_cache[length], &u->vcache, sizeof(VehicleCache)) != 0) {
-				Debug(desync, 2, "vehicle cache mismatch: type {}, vehicle {}, company {}, unit number {}, wagon {}", v->type, v->index, v->owner, v->unitnumber, length);
-			}
-			switch (u->type) {
-				case VEH_TRAIN:
-					if (memcmp(&gro_cache[length], &Train::From(u)->gcache, sizeof(GroundVehicleCache)) != 0) {
-						Debug(desync, 2, "train ground vehicle cache mismatch: vehicle {}, company {}, unit number {}, wagon {}", v->index, v->owner, v->unitnumber, length);
-					}
-					if (memcmp(&tra_cache[length], &Train::From(u)->tcache, sizeof(TrainCache)) != 0) {
-						Debug(desync, 2, "train cache mismatch: vehicle {}, company {}, unit number {}, wagon {}", v->index, v->owner, v->unitnumber, length);
-					}
-					break;
-				case VEH_ROAD:
-					if (memcmp(&gro_cache[length], &RoadVehicle::From(u)->gcache, sizeof(GroundVehicleCache)) != 0) {
-						Debug(desync, 2, "road vehicle ground vehicle cache mismatch: vehicle {}, company {}, unit number {}, wagon {}", v->index, v->owner, v->unitnumber, length);
-					}
-					break;
-				default:
-					break;
+/**
+ * Check the cargo caches of stations.
+ * Every cargo list only depends on its own packets, so they are checked on the game loop threads.
+ * @param stations The stations to check.
+ */
+static void CheckStationCargoCaches(std::span<Station * const> stations)
+{
+	RunInChunks(stations, MIN_CARGO_CACHE_CHECKS_PER_THREAD / NUM_CARGO, [](std::span<Station * const> chunk) {
+		for (Station *st : chunk) {
+			for (GoodsEntry &ge : st->goods) {
+				uint8_t buff[sizeof(StationCargoList)];
+				memcpy(buff, &ge.cargo, sizeof(StationCargoList));
+				ge.cargo.InvalidateCache();
+				assert(memcmp(&ge.cargo, buff, sizeof(StationCargoList)) == 0);
 			}
-			length++;
 		}
+	});
+}
 
-		free(grf_cache);
-		free(veh_cache);
-		free(gro_cache);
-		free(tra_cache);
+/**
+ * Check the docking tiles and the nearby industries of a station by recalculating them.
+ * This also recalculates the stations near the towns and industries around it.
+ * @param st The station to check.
+ */
+static void CheckStationCaches(Station *st)
+{
+	/* Check docking tiles */
+	TileArea ta;
+	std::map<TileIndex, bool> docking_tiles;
+	for (TileIndex tile : st->docking_station) {
+		ta.Add(tile);
+		docking_tiles[tile] = IsDockingTile(tile);
+	}
+	UpdateStationDockingTiles(st);
+	if (ta.tile != st->docking_station.tile || ta.w != st->docking_station.w || ta.h != st->docking_station.h) {
+		Debug(desync, 0, "station docking mismatch: station {}, company {}", st->index, st->owner);
+	}
+	for (TileIndex tile : ta) {
+		if (docking_tiles[tile] != IsDockingTile(tile)) {
+			Debug(desync, 0, "docking tile mismatch: tile {}", tile);
+		}
 	}
 
-	/* Check whether the caches are still valid */
+	/* Check industries_near */
+	IndustryList industries_near = st->industries_near;
+	st->RecomputeCatchment();
+	if (st->industries_near != industries_near) {
+		Debug(desync, 0, "station industries near mismatch: station {}", st->index);
+	}
+}
+
+/**
+ * Check the caches of the next #_cache_check_objects vehicles and stations,
+ * continuing where the previous tick stopped, so that all of them are checked
+ * every so many ticks at a fraction of the cost of checking all caches.
+ * The caches that can only be recalculated for the whole map are not checked.
+ */
+static void CheckCachesIncrementally()
+{
+	static std::vector<Vehicle *> vehicles;
+	vehicles.clear();
+	for (Vehicle *v : Vehicle::Iterate(_cache_check_next_vehicle)) {
+		if (vehicles.size() == _cache_check_objects) break;
+		vehicles.push_back(v);
+	}
+	_cache_check_next_vehicle = (vehicles.size() == _cache_check_objects) ? vehicles.back()->index + 1 : 0;
+
+	for (Vehicle *v : vehicles) CheckVehicleCaches(v);
+	CheckVehicleCargoCaches(vehicles);
+
+	static std::vector<Station *> stations;
+	stations.clear();
+	for (Station *st : Station::Iterate(_cache_check_next_station)) {
+		if (stations.size() == _cache_check_objects) break;
+		stations.push_back(st);
+	}
+	_cache_check_next_station = (stations.size() == _cache_check_objects) ? stations.back()->index + 1 : 0;
+
+	CheckStationCargoCaches(stations);
+	for (Station *st : stations) CheckStationCaches(st);
+}
+
+/**
+ * Check the validity of some of the caches.
+ * Especially in the sense of desyncs between
+ * the cached value and what the value would
+ * be when calculated from the 'base' data.
+ * With a desync debug level above 1 all caches are checked every tick,
+ * otherwise the caches of #_cache_check_objects vehicles and stations.
+ */
+static void CheckCaches()
+{
+	if (_debug_desync_level <= 1) {
+		if (_cache_check_objects != 0) CheckCachesIncrementally();
+		return;
+	}
+
+	CheckTownCaches();
+	CheckInfrastructureCaches();
+
+	/* Strict checking of the road stop cache entries */
+	for (const RoadStop *rs : RoadStop::Iterate()) {
+		if (IsBayRoadStopTile(rs->xy)) continue;
+
+		assert(rs->GetEntry(DIAGDIR_NE) != rs->GetEntry(DIAGDIR_NW));
+		rs->GetEntry(DIAGDIR_NE)->CheckIntegrity(rs);
+		rs->GetEntry(DIAGDIR_NW)->CheckIntegrity(rs);
+	}
+
+	std::vector<Vehicle *> vehicles;
 	for (Vehicle *v : Vehicle::Iterate()) {
-		uint8_t buff[sizeof(VehicleCargoList)];
-		memcpy(buff, &v->cargo, sizeof(VehicleCargoList));
-		v->cargo.InvalidateCache();
-		assert(memcmp(&v->cargo, buff, sizeof(VehicleCargoList)) == 0);
+		CheckVehicleCaches(v);
+		vehicles.push_back(v);
 	}
 
+	/* Check whether the caches are still valid */
+	CheckVehicleCargoCaches(vehicles);
+
 	/* Backup stations_near */
 	std::vector<StationList> old_town_stations_near;
 	for (Town *t : Town::Iterate()) old_town_stations_near.push_back(t->stations_near);
@@ -1372,51 +1520,24 @@ static void CheckCaches()
 	std::vector<StationList> old_industry_stations_near;
 	for (Industry *ind : Industry::Iterate())  old_industry_stations_near.push_back(ind->stations_near);
 
-	for (Station *st : Station::Iterate()) {
-		for (GoodsEntry &ge : st->goods) {
-			uint8_t buff[sizeof(StationCargoList)];
-			memcpy(buff, &ge.cargo, sizeof(StationCargoList));
-			ge.cargo.InvalidateCache();
-			assert(memcmp(&ge.cargo, buff, sizeof(StationCargoList)) == 0);
-		}
-
-		/* Check docking tiles */
-		TileArea ta;
-		std::map<TileIndex, bool> docking_tiles;
-		for (TileIndex tile : st->docking_station) {
-			ta.Add(tile);
-			docking_tiles[tile] = IsDockingTile(tile);
-		}
-		UpdateStationDockingTiles(st);
-		if (ta.tile != st->docking_station.tile || ta.w != st->docking_station.w || ta.h != st->docking_station.h) {
-			Debug(desync, 2, "station docking mismatch: station {}, company {}", st->index, st->owner);
-		}
-		for (TileIndex tile : ta) {
-			if (docking_tiles[tile] != IsDockingTile(tile)) {
-				Debug(desync, 2, "docking tile mismatch: tile {}", tile);
-			}
-		}
+	std::vector<Station *> stations;
+	for (Station *st : Station::Iterate()) stations.push_back(st);
 
-		/* Check industries_near */
-		IndustryList industries_near = st->industries_near;
-		st->RecomputeCatchment();
-		if (st->industries_near != industries_near) {
-			Debug(desync, 2, "station industries near mismatch: station {}", st->index);
-		}
-	}
+	CheckStationCargoCaches(stations);
+	for (Station *st : stations) CheckStationCaches(st);
 
 	/* Check stations_near */
-	i = 0;
+	uint i = 0;
 	for (Town *t : Town::Iterate()) {
 		if (t->stations_near != old_town_stations_near[i]) {
-			Debug(desync, 2, "town stations near mismatch: town {}", t->index);
+			Debug(desync, 0, "town stations near mismatch: town {}", t->index);
 		}
 		i++;
 	}
 	i = 0;
 	for (Industry *ind : Industry::Iterate()) {
 		if (ind->stations_near != old_industry_stations_near[i]) {
-			Debug(desync, 2, "industry stations near mismatch: industry {}", ind->index);
+			Debug(desync, 0, "industry stations near mismatch: industry {}", ind->index);
 		}
 		i++;
 	}
@@ -1442,6 +1563,8 @@ void StateGameLoop()
 		PerformanceMeasurer::Paused(PFE_GL_SHIPS);
 		PerformanceMeasurer::Paused(PFE_GL_AIRCRAFT);
 		PerformanceMeasurer::Paused(PFE_GL_LANDSCAPE);
+		PerformanceMeasurer::Paused(PFE_GL_INDUSTRIES);
+		PerformanceMeasurer::Paused(PFE_GL_STATIONS);
 
 		if (!HasModalProgress()) UpdateLandscapingLimits();
 #ifndef DEBUG_DUMP_COMMANDS
@@ -1451,9 +1574,11 @@ void StateGameLoop()
 	}
 
 	PerformanceMeasurer framerate(PFE_GAMELOOP);
+	TraceScope trace("Game loop");
 	PerformanceAccumulator::Reset(PFE_GL_LANDSCAPE);
-
-	Layouter::ReduceLineCache();
+	PerformanceAccumulator::Reset(PFE_GL_INDUSTRIES);
+	PerformanceAccumulator::Reset(PFE_GL_STATIONS);
+	CompanyPerformanceTick();
 
 	if (_game_mode == GM_EDITOR) {
 		BasePersistentStorageArray::SwitchMode(PSM_ENTER_GAMELOOP);
@@ -1590,8 +1715,6 @@ void GameLoop()
 		if (_exit_game) return;
 	}
 
-	IncreaseSpriteLRU();
-
 	/* Check for UDP stuff */
 	if (_network_available) NetworkBackgroundLoop();
 
@@ -1610,6 +1733,8 @@ void GameLoop()
 		StateGameLoop();
 	}
 
+	ProcessPendingWindowInvalidations();
+
 	if (!_pause_mode && HasBit(_display_opt, DO_FULL_ANIMATION)) DoPaletteAnimations();
 
 	SoundDriver::GetInstance()->MainLoop();
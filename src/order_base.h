@@ -20,7 +20,7 @@
 #include "timer/timer_game_tick.h"
 #include "saveload/saveload.h"
 
-typedef Pool<Order, OrderID, 256, 0xFF0000> OrderPool;
+typedef Pool<Order, OrderID, 256, 0xFF0000, PT_NORMAL, true> OrderPool;
 typedef Pool<OrderList, OrderListID, 128, 64000> OrderListPool;
 extern OrderPool _order_pool;
 extern OrderListPool _orderlist_pool;
@@ -263,6 +263,7 @@ private:
 	friend SaveLoadTable GetOrderListDescription(); ///< Saving and loading of order lists.
 
 	Order *first;                     ///< First order of the order list.
+	std::vector<Order *> order_index; ///< NOSAVE: The orders of the chain by their index, so looking them up does not walk the chain.
 	VehicleOrderID num_orders;        ///< NOSAVE: How many orders there are in the list.
 	VehicleOrderID num_manual_orders; ///< NOSAVE: How many manually added orders are there in the list.
 	uint num_vehicles;                ///< NOSAVE: Number of vehicles that share this order list.
@@ -297,7 +298,16 @@ public:
 	 */
 	inline Order *GetFirstOrder() const { return this->first; }
 
-	Order *GetOrderAt(int index) const;
+	/**
+	 * Get a certain order of the order chain.
+	 * @param index zero-based index of the order within the chain.
+	 * @return the order at position index, or \c nullptr when there is no such order.
+	 */
+	inline Order *GetOrderAt(int index) const
+	{
+		if (index < 0 || static_cast<size_t>(index) >= this->order_index.size()) return nullptr;
+		return this->order_index[index];
+	}
 
 	/**
 	 * Get the last order of the order chain.
@@ -328,6 +338,7 @@ public:
 	StationIDStack GetNextStoppingStation(const Vehicle *v, const Order *first = nullptr, uint hops = 0) const;
 	const Order *GetNextDecisionNode(const Order *next, uint hops) const;
 
+	void RebuildOrderIndex();
 	void InsertOrderAt(Order *new_order, int index);
 	void DeleteOrderAt(int index);
 	void MoveOrder(int from, int to);
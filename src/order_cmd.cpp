@@ -253,9 +253,9 @@ void InvalidateVehicleOrder(const Vehicle *v, int data)
 	SetWindowDirty(WC_VEHICLE_VIEW, v->index);
 
 	if (data != 0) {
-		/* Calls SetDirty() too */
-		InvalidateWindowData(WC_VEHICLE_ORDERS,    v->index, data);
-		InvalidateWindowData(WC_VEHICLE_TIMETABLE, v->index, data);
+		/* Calls SetDirty() too; the order windows track the selected order by these changes, so don't queue them. */
+		InvalidateWindowDataImmediately(WC_VEHICLE_ORDERS,    v->index, data);
+		InvalidateWindowDataImmediately(WC_VEHICLE_TIMETABLE, v->index, data);
 		return;
 	}
 
@@ -304,6 +304,7 @@ void OrderList::Initialize(Order *chain, Vehicle *v)
 		this->total_duration += o->GetWaitTime() + o->GetTravelTime();
 	}
 
+	this->RebuildOrderIndex();
 	this->RecalculateTimetableDuration();
 
 	for (Vehicle *u = this->first_shared->PreviousShared(); u != nullptr; u = u->PreviousShared()) {
@@ -341,6 +342,7 @@ void OrderList::FreeChain(bool keep_orderlist)
 
 	if (keep_orderlist) {
 		this->first = nullptr;
+		this->order_index.clear();
 		this->num_orders = 0;
 		this->num_manual_orders = 0;
 		this->timetable_duration = 0;
@@ -350,20 +352,12 @@ void OrderList::FreeChain(bool keep_orderlist)
 }
 
 /**
- * Get a certain order of the order chain.
- * @param index zero-based index of the order within the chain.
- * @return the order at position index.
+ * Recompute the lookup of the orders by their index, after the chain changed.
  */
-Order *OrderList::GetOrderAt(int index) const
+void OrderList::RebuildOrderIndex()
 {
-	if (index < 0) return nullptr;
-
-	Order *order = this->first;
-
-	while (order != nullptr && index-- > 0) {
-		order = order->next;
-	}
-	return order;
+	this->order_index.clear();
+	for (Order *o = this->first; o != nullptr; o = o->next) this->order_index.push_back(o);
 }
 
 /**
@@ -489,6 +483,7 @@ void OrderList::InsertOrderAt(Order *new_order, int index)
 		}
 	}
 	++this->num_orders;
+	this->RebuildOrderIndex();
 	if (!new_order->IsType(OT_IMPLICIT)) ++this->num_manual_orders;
 	this->timetable_duration += new_order->GetTimetabledWait() + new_order->GetTimetabledTravel();
 	this->total_duration += new_order->GetWaitTime() + new_order->GetTravelTime();
@@ -522,6 +517,7 @@ void OrderList::DeleteOrderAt(int index)
 		prev->next = to_remove->next;
 	}
 	--this->num_orders;
+	this->RebuildOrderIndex();
 	if (!to_remove->IsType(OT_IMPLICIT)) --this->num_manual_orders;
 	this->timetable_duration -= (to_remove->GetTimetabledWait() + to_remove->GetTimetabledTravel());
 	this->total_duration -= (to_remove->GetWaitTime() + to_remove->GetTravelTime());
@@ -548,6 +544,7 @@ void OrderList::MoveOrder(int from, int to)
 		moving_one = one_before->next;
 		one_before->next = moving_one->next;
 	}
+	this->RebuildOrderIndex();
 
 	/* Insert the moving_order again in the pointer-chain */
 	if (to == 0) {
@@ -558,6 +555,7 @@ void OrderList::MoveOrder(int from, int to)
 		moving_one->next = one_before->next;
 		one_before->next = moving_one;
 	}
+	this->RebuildOrderIndex();
 }
 
 /**
@@ -45,6 +45,9 @@ static const int YAPF_ROADVEH_PATH_CACHE_SEGMENTS = 8;
 /** Distance from destination road stops to not cache any further */
 static const int YAPF_ROADVEH_PATH_CACHE_DESTINATION_LIMIT = 8;
 
+/** Distance to the destination from which road vehicle searches are first restricted to a road region path */
+static const uint YAPF_ROADVEH_REGION_SEARCH_MIN_DISTANCE = 64;
+
 /**
  * Helper container to find a depot
  */
@@ -0,0 +1,112 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file rail_regions.cpp Handles dividing the railways in the map into square regions to assist pathfinding. */
+
+#include "stdafx.h"
+#include "rail_regions.h"
+#include "tile_regions.hpp"
+#include "rail_map.h"
+#include "road_map.h"
+#include "station_map.h"
+#include "debug.h"
+
+#include "safeguards.h"
+
+/** The rail network, for #TileRegion. */
+struct RailRegionTraits {
+	/**
+	 * Is the tile a rail tunnel or bridge head?
+	 * @param tile The tile to check.
+	 * @return True iff the tile is the head of a tunnel or bridge carrying rail.
+	 */
+	inline bool IsTunnelBridgeTile(TileIndex tile) const
+	{
+		return IsTileType(tile, MP_TUNNELBRIDGE) && GetTunnelBridgeTransportType(tile) == TRANSPORT_RAIL;
+	}
+
+	/**
+	 * Get the sides of a tile through which a train could leave, or enter, the tile.
+	 * Only the layout of the map is taken into account, not signals, rail type compatibility
+	 * or whether two pieces of track in the tile actually connect, so this is an upper bound
+	 * of what a train can do. For tunnels and bridges only the side towards the ground next
+	 * to the head is returned.
+	 * @param tile The tile to get the sides for.
+	 * @return Bit mask of DiagDirections.
+	 */
+	TTileRegionSides GetTileSides(TileIndex tile) const
+	{
+		switch (GetTileType(tile)) {
+			case MP_RAILWAY: {
+				if (IsRailDepot(tile)) return 1 << GetRailDepotDirection(tile);
+				const TrackBits bits = GetTrackBits(tile);
+				TTileRegionSides sides = 0;
+				for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+					if ((bits & DiagdirReachesTracks(ReverseDiagDir(side))) != TRACK_BIT_NONE) SetBit(sides, side);
+				}
+				return sides;
+			}
+
+			case MP_ROAD:
+				if (!IsLevelCrossing(tile)) return 0;
+				return GetCrossingRailAxis(tile) == AXIS_X ? (1 << DIAGDIR_NE | 1 << DIAGDIR_SW) : (1 << DIAGDIR_SE | 1 << DIAGDIR_NW);
+
+			case MP_STATION:
+				if (!HasStationRail(tile)) return 0;
+				return GetRailStationAxis(tile) == AXIS_X ? (1 << DIAGDIR_NE | 1 << DIAGDIR_SW) : (1 << DIAGDIR_SE | 1 << DIAGDIR_NW);
+
+			case MP_TUNNELBRIDGE:
+				if (!this->IsTunnelBridgeTile(tile)) return 0;
+				return 1 << ReverseDiagDir(GetTunnelBridgeDirection(tile));
+
+			default:
+				return 0;
+		}
+	}
+};
+
+/** The rail regions. */
+static TileRegions<RailRegionTraits> _rail_regions;
+
+/**
+ * Returns basic rail region patch information for the provided tile.
+ * @param tile The tile for which the information will be calculated.
+ */
+TileRegionPatchDesc GetRailRegionPatchInfo(TileIndex tile)
+{
+	return _rail_regions.GetPatchInfo(tile);
+}
+
+/**
+ * Marks the rail region that tile is part of as invalid.
+ * @param tile Tile within the rail region that we wish to invalidate.
+ */
+void InvalidateRailRegion(TileIndex tile)
+{
+	_rail_regions.Invalidate(tile);
+}
+
+/**
+ * Calls the provided callback function on all accessible rail region patches in
+ * each cardinal direction, plus any others that are reachable via tunnels and bridges.
+ * @param rail_region_patch Rail patch within the rail region to start searching from
+ * @param callback The function that will be called for each accessible rail patch that is found
+ */
+void VisitRailRegionPatchNeighbors(const TileRegionPatchDesc &rail_region_patch, const TVisitTileRegionPatchCallBack &callback)
+{
+	_rail_regions.VisitPatchNeighbors(rail_region_patch, callback);
+}
+
+/**
+ * Allocates the appropriate amount of rail regions for the current map size
+ */
+void AllocateRailRegions()
+{
+	Debug(map, 2, "Allocating {} x {} rail regions", GetTileRegionMapSizeX(), GetTileRegionMapSizeY());
+
+	_rail_regions.Allocate();
+}
@@ -0,0 +1,21 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file rail_regions.h Handles dividing the railways in the map into regions to assist pathfinding. */
+
+#ifndef RAIL_REGIONS_H
+#define RAIL_REGIONS_H
+
+#include "tile_regions.h"
+
+TileRegionPatchDesc GetRailRegionPatchInfo(TileIndex tile);
+
+void VisitRailRegionPatchNeighbors(const TileRegionPatchDesc &rail_region_patch, const TVisitTileRegionPatchCallBack &callback);
+
+void AllocateRailRegions();
+
+#endif /* RAIL_REGIONS_H */
@@ -0,0 +1,128 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file road_regions.cpp Handles dividing the roads in the map into square regions to assist pathfinding. */
+
+#include "stdafx.h"
+#include "road_regions.h"
+#include "tile_regions.hpp"
+#include "road_map.h"
+#include "station_map.h"
+#include "debug.h"
+
+#include "safeguards.h"
+
+/** The road or the tram network, for #TileRegion. */
+struct RoadRegionTraits {
+	RoadTramType rtt; ///< Whether to look at road or tram.
+
+	/**
+	 * Is the tile a road tunnel or bridge head carrying the road/tram type?
+	 * @param tile The tile to check.
+	 * @return True iff the tile is the head of a tunnel or bridge with #rtt on it.
+	 */
+	inline bool IsTunnelBridgeTile(TileIndex tile) const
+	{
+		return IsTileType(tile, MP_TUNNELBRIDGE) && GetTunnelBridgeTransportType(tile) == TRANSPORT_ROAD && HasTileRoadType(tile, this->rtt);
+	}
+
+	/**
+	 * Get the sides of a tile through which a road vehicle could leave, or enter, the tile.
+	 * Only the layout of the map is taken into account, not one-way roads, road works or
+	 * road type compatibility, so this is an upper bound of what a vehicle can do. For
+	 * tunnels and bridges only the side towards the ground next to the head is returned.
+	 * @param tile The tile to get the sides for.
+	 * @return Bit mask of DiagDirections.
+	 */
+	TTileRegionSides GetTileSides(TileIndex tile) const
+	{
+		switch (GetTileType(tile)) {
+			case MP_ROAD: {
+				if (!HasTileRoadType(tile, this->rtt)) return 0;
+				switch (GetRoadTileType(tile)) {
+					case ROAD_TILE_NORMAL: {
+						const RoadBits bits = GetRoadBits(tile, this->rtt);
+						TTileRegionSides sides = 0;
+						for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+							if ((bits & DiagDirToRoadBits(side)) != ROAD_NONE) SetBit(sides, side);
+						}
+						return sides;
+					}
+
+					case ROAD_TILE_CROSSING:
+						return GetCrossingRoadAxis(tile) == AXIS_X ? (1 << DIAGDIR_NE | 1 << DIAGDIR_SW) : (1 << DIAGDIR_SE | 1 << DIAGDIR_NW);
+
+					case ROAD_TILE_DEPOT:
+						return 1 << GetRoadDepotDirection(tile);
+
+					default: NOT_REACHED();
+				}
+			}
+
+			case MP_STATION: {
+				if (!IsRoadStopTile(tile) || !HasTileRoadType(tile, this->rtt)) return 0;
+				const DiagDirection dir = GetRoadStopDir(tile);
+				if (IsBayRoadStopTile(tile)) return 1 << dir;
+				return 1 << dir | 1 << ReverseDiagDir(dir);
+			}
+
+			case MP_TUNNELBRIDGE:
+				if (!this->IsTunnelBridgeTile(tile)) return 0;
+				return 1 << ReverseDiagDir(GetTunnelBridgeDirection(tile));
+
+			default:
+				return 0;
+		}
+	}
+};
+
+/** The road regions, separately for the road and the tram network. */
+static std::array<TileRegions<RoadRegionTraits>, 2> _road_regions = {
+	TileRegions<RoadRegionTraits>(RoadRegionTraits{ RTT_ROAD }),
+	TileRegions<RoadRegionTraits>(RoadRegionTraits{ RTT_TRAM }),
+};
+
+/**
+ * Returns basic road region patch information for the provided tile.
+ * @param tile The tile for which the information will be calculated.
+ * @param rtt Whether to look at the road or the tram network.
+ */
+TileRegionPatchDesc GetRoadRegionPatchInfo(TileIndex tile, RoadTramType rtt)
+{
+	return _road_regions[rtt].GetPatchInfo(tile);
+}
+
+/**
+ * Marks the road regions that tile is part of as invalid.
+ * @param tile Tile within the road region that we wish to invalidate.
+ */
+void InvalidateRoadRegion(TileIndex tile)
+{
+	for (auto &regions : _road_regions) regions.Invalidate(tile);
+}
+
+/**
+ * Calls the provided callback function on all accessible road region patches in
+ * each cardinal direction, plus any others that are reachable via tunnels and bridges.
+ * @param road_region_patch Road patch within the road region to start searching from
+ * @param rtt Whether to look at the road or the tram network.
+ * @param callback The function that will be called for each accessible road patch that is found
+ */
+void VisitRoadRegionPatchNeighbors(const TileRegionPatchDesc &road_region_patch, RoadTramType rtt, const TVisitTileRegionPatchCallBack &callback)
+{
+	_road_regions[rtt].VisitPatchNeighbors(road_region_patch, callback);
+}
+
+/**
+ * Allocates the appropriate amount of road regions for the current map size
+ */
+void AllocateRoadRegions()
+{
+	Debug(map, 2, "Allocating {} x {} road regions", GetTileRegionMapSizeX(), GetTileRegionMapSizeY());
+
+	for (auto &regions : _road_regions) regions.Allocate();
+}
@@ -0,0 +1,22 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file road_regions.h Handles dividing the roads in the map into regions to assist pathfinding. */
+
+#ifndef ROAD_REGIONS_H
+#define ROAD_REGIONS_H
+
+#include "tile_regions.h"
+#include "../road.h"
+
+TileRegionPatchDesc GetRoadRegionPatchInfo(TileIndex tile, RoadTramType rtt);
+
+void VisitRoadRegionPatchNeighbors(const TileRegionPatchDesc &road_region_patch, RoadTramType rtt, const TVisitTileRegionPatchCallBack &callback);
+
+void AllocateRoadRegions();
+
+#endif /* ROAD_REGIONS_H */
@@ -0,0 +1,113 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file tile_regions.cpp Dividing a transport network in the map into square regions to assist pathfinding. */
+
+#include "stdafx.h"
+#include "tile_regions.hpp"
+#include "debug.h"
+
+#include "safeguards.h"
+
+static TileIndex GetTileIndexFromLocalCoordinate(int region_x, int region_y, int local_x, int local_y)
+{
+	assert(local_x >= 0 && local_x < TILE_REGION_EDGE_LENGTH);
+	assert(local_y >= 0 && local_y < TILE_REGION_EDGE_LENGTH);
+	return TileXY(TILE_REGION_EDGE_LENGTH * region_x + local_x, TILE_REGION_EDGE_LENGTH * region_y + local_y);
+}
+
+/**
+ * Returns one of the tiles along an edge of a region.
+ * @param region_x The X coordinate of the region.
+ * @param region_y The Y coordinate of the region.
+ * @param side The edge of the region.
+ * @param x_or_y The position along the edge, see TileRegion::GetEdgeTraversabilityBits.
+ * @returns The tile.
+ */
+TileIndex GetTileRegionEdgeTile(int region_x, int region_y, DiagDirection side, int x_or_y)
+{
+	assert(x_or_y >= 0 && x_or_y < TILE_REGION_EDGE_LENGTH);
+	switch (side) {
+		case DIAGDIR_NE: return GetTileIndexFromLocalCoordinate(region_x, region_y, 0, x_or_y);
+		case DIAGDIR_SW: return GetTileIndexFromLocalCoordinate(region_x, region_y, TILE_REGION_EDGE_LENGTH - 1, x_or_y);
+		case DIAGDIR_NW: return GetTileIndexFromLocalCoordinate(region_x, region_y, x_or_y, 0);
+		case DIAGDIR_SE: return GetTileIndexFromLocalCoordinate(region_x, region_y, x_or_y, TILE_REGION_EDGE_LENGTH - 1);
+		default: NOT_REACHED();
+	}
+}
+
+/**
+ * Returns the center tile of a particular region.
+ * @param region The region to find the center tile for.
+ * @returns The center tile of the region.
+ */
+TileIndex GetTileRegionCenterTile(const TileRegionDesc &region)
+{
+	return TileXY(region.x * TILE_REGION_EDGE_LENGTH + (TILE_REGION_EDGE_LENGTH / 2), region.y * TILE_REGION_EDGE_LENGTH + (TILE_REGION_EDGE_LENGTH / 2));
+}
+
+/**
+ * Returns the labels of the traversable tiles along one edge of the region.
+ * @param side The edge of the region.
+ * @returns For each edge tile its label, or #INVALID_TILE_REGION_PATCH when the edge can't be crossed there.
+ */
+TTileRegionEdgeLabels TileRegion::GetEdgeLabels(DiagDirection side) const
+{
+	TTileRegionEdgeLabels labels{};
+	for (int x_or_y = 0; x_or_y < TILE_REGION_EDGE_LENGTH; ++x_or_y) {
+		if (!HasBit(this->edge_traversability_bits[side], x_or_y)) continue;
+		labels[x_or_y] = this->GetLabel(GetTileRegionEdgeTile(this->GetRegionX(), this->GetRegionY(), side, x_or_y));
+	}
+	return labels;
+}
+
+void TileRegion::PrintDebugInfo() const
+{
+	Debug(map, 9, "Region {},{} labels and edge traversability = ...", this->GetRegionX(), this->GetRegionY());
+
+	const size_t max_element_width = std::to_string(this->number_of_patches).size();
+
+	std::array<int, 16> traversability_NW{0};
+	for (auto bitIndex : SetBitIterator(this->edge_traversability_bits[DIAGDIR_NW])) *(traversability_NW.rbegin() + bitIndex) = 1;
+	Debug(map, 9, "    {:{}}", fmt::join(traversability_NW, " "), max_element_width);
+	Debug(map, 9, "  +{:->{}}+", "", TILE_REGION_EDGE_LENGTH * (max_element_width + 1) + 1);
+
+	for (int y = 0; y < TILE_REGION_EDGE_LENGTH; ++y) {
+		std::string line{};
+		for (int x = 0; x < TILE_REGION_EDGE_LENGTH; ++x) {
+			const auto label = this->GetLabel(TileAddXY(this->tile_area.tile, x, y));
+			const std::string label_str = label == INVALID_TILE_REGION_PATCH ? "." : std::to_string(label);
+			line = fmt::format("{:{}}", label_str, max_element_width) + " " + line;
+		}
+		Debug(map, 9, "{} | {}| {}", GB(this->edge_traversability_bits[DIAGDIR_SW], y, 1), line, GB(this->edge_traversability_bits[DIAGDIR_NE], y, 1));
+	}
+
+	Debug(map, 9, "  +{:->{}}+", "", TILE_REGION_EDGE_LENGTH * (max_element_width + 1) + 1);
+	std::array<int, 16> traversability_SE{0};
+	for (auto bitIndex : SetBitIterator(this->edge_traversability_bits[DIAGDIR_SE])) *(traversability_SE.rbegin() + bitIndex) = 1;
+	Debug(map, 9, "    {:{}}", fmt::join(traversability_SE, " "), max_element_width);
+}
+
+/**
+ * Restricts the search to the regions along the given path, and the regions directly next to them.
+ * @param path The regions the vehicle should follow.
+ */
+void TileRegionCorridor::Restrict(const std::vector<TileRegionDesc> &path)
+{
+	this->regions.clear();
+	for (const TileRegionDesc &region : path) {
+		this->regions.push_back(GetTileRegionIndex(region));
+		for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+			const TileIndexDiffC offset = TileIndexDiffCByDiagDir(side);
+			const int x = region.x + offset.x;
+			const int y = region.y + offset.y;
+			if (x >= 0 && y >= 0 && x < GetTileRegionMapSizeX() && y < GetTileRegionMapSizeY()) this->regions.push_back(GetTileRegionIndex(x, y));
+		}
+	}
+	std::sort(this->regions.begin(), this->regions.end());
+	this->regions.erase(std::unique(this->regions.begin(), this->regions.end()), this->regions.end());
+}
@@ -0,0 +1,104 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file tile_regions.h Types shared by the water, road and rail regions that assist pathfinding. */
+
+#ifndef TILE_REGIONS_H
+#define TILE_REGIONS_H
+
+#include "../tile_type.h"
+#include "../map_func.h"
+
+using TTileRegionPatchLabel = uint8_t;
+using TTileRegionIndex = uint;
+
+constexpr int TILE_REGION_EDGE_LENGTH = 16;
+constexpr int TILE_REGION_NUMBER_OF_TILES = TILE_REGION_EDGE_LENGTH * TILE_REGION_EDGE_LENGTH;
+constexpr TTileRegionPatchLabel INVALID_TILE_REGION_PATCH = 0;
+
+/**
+ * Describes a single interconnected patch of a transport network within a particular region.
+ */
+struct TileRegionPatchDesc
+{
+	int x; ///< The X coordinate of the region, i.e. X=2 is the 3rd region along the X-axis
+	int y; ///< The Y coordinate of the region, i.e. Y=2 is the 3rd region along the Y-axis
+	TTileRegionPatchLabel label; ///< Unique label identifying the patch within the region
+
+	bool operator==(const TileRegionPatchDesc &other) const { return x == other.x && y == other.y && label == other.label; }
+	bool operator!=(const TileRegionPatchDesc &other) const { return !(*this == other); }
+};
+
+/**
+ * Describes a single square region.
+ */
+struct TileRegionDesc
+{
+	int x; ///< The X coordinate of the region, i.e. X=2 is the 3rd region along the X-axis
+	int y; ///< The Y coordinate of the region, i.e. Y=2 is the 3rd region along the Y-axis
+
+	TileRegionDesc(const int x, const int y) : x(x), y(y) {}
+	TileRegionDesc(const TileRegionPatchDesc &region_patch) : x(region_patch.x), y(region_patch.y) {}
+
+	bool operator==(const TileRegionDesc &other) const { return x == other.x && y == other.y; }
+	bool operator!=(const TileRegionDesc &other) const { return !(*this == other); }
+};
+
+inline int GetTileRegionX(TileIndex tile) { return TileX(tile) / TILE_REGION_EDGE_LENGTH; }
+inline int GetTileRegionY(TileIndex tile) { return TileY(tile) / TILE_REGION_EDGE_LENGTH; }
+
+inline int GetTileRegionMapSizeX() { return Map::SizeX() / TILE_REGION_EDGE_LENGTH; }
+inline int GetTileRegionMapSizeY() { return Map::SizeY() / TILE_REGION_EDGE_LENGTH; }
+
+inline TTileRegionIndex GetTileRegionIndex(int region_x, int region_y) { return GetTileRegionMapSizeX() * region_y + region_x; }
+inline TTileRegionIndex GetTileRegionIndex(const TileRegionDesc &region) { return GetTileRegionIndex(region.x, region.y); }
+inline TTileRegionIndex GetTileRegionIndex(TileIndex tile) { return GetTileRegionIndex(GetTileRegionX(tile), GetTileRegionY(tile)); }
+
+/**
+ * Returns basic region information for the provided tile.
+ * @param tile The tile for which the information will be calculated.
+ */
+inline TileRegionDesc GetTileRegionInfo(TileIndex tile) { return TileRegionDesc{ GetTileRegionX(tile), GetTileRegionY(tile) }; }
+
+/**
+ * Calculates a number that uniquely identifies the provided region patch.
+ * @param region_patch The region patch to calculate the hash for.
+ */
+inline int CalculateTileRegionPatchHash(const TileRegionPatchDesc &region_patch)
+{
+	static_assert(sizeof(TTileRegionPatchLabel) == sizeof(uint8_t)); // Important for the hash calculation.
+	return region_patch.label | GetTileRegionIndex(region_patch) << 8;
+}
+
+TileIndex GetTileRegionCenterTile(const TileRegionDesc &region);
+TileIndex GetTileRegionEdgeTile(int region_x, int region_y, DiagDirection side, int x_or_y);
+
+using TVisitTileRegionPatchCallBack = std::function<void(const TileRegionPatchDesc &)>;
+
+/**
+ * The regions a pathfinder search is restricted to.
+ */
+class TileRegionCorridor
+{
+private:
+	std::vector<TTileRegionIndex> regions; ///< Sorted indices of the regions; empty when not restricted.
+
+public:
+	void Restrict(const std::vector<TileRegionDesc> &path);
+
+	/**
+	 * Whether the search may enter the given tile.
+	 * @param tile The tile to check.
+	 * @returns True when the search is not restricted, or the tile is within the corridor.
+	 */
+	inline bool Contains(TileIndex tile) const
+	{
+		return this->regions.empty() || std::binary_search(this->regions.begin(), this->regions.end(), GetTileRegionIndex(tile));
+	}
+};
+
+#endif /* TILE_REGIONS_H */
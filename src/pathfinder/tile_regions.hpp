@@ -0,0 +1,339 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file tile_regions.hpp Dividing a transport network in the map into square regions to assist pathfinding. */
+
+#ifndef TILE_REGIONS_HPP
+#define TILE_REGIONS_HPP
+
+#include "tile_regions.h"
+#include "../tilearea_type.h"
+#include "../tunnelbridge_map.h"
+
+using TTileRegionTraversabilityBits = uint16_t;
+using TTileRegionSides = uint8_t; ///< Bit mask of DiagDirections.
+constexpr TTileRegionPatchLabel FIRST_TILE_REGION_LABEL = 1;
+
+static_assert(sizeof(TTileRegionTraversabilityBits) * 8 == TILE_REGION_EDGE_LENGTH);
+
+using TTileRegionPatchLabelArray = std::array<TTileRegionPatchLabel, TILE_REGION_NUMBER_OF_TILES>;
+using TTileRegionEdgeLabels = std::array<TTileRegionPatchLabel, TILE_REGION_EDGE_LENGTH>;
+
+/**
+ * Represents a square section of the map of a fixed size. Within this square individual unconnected patches of a
+ * transport network are identified using a Connected Component Labeling (CCL) algorithm. Note that all information
+ * stored in this class applies only to tiles within the square section, there is no knowledge about the rest of the
+ * map. This makes it easy to invalidate and update a region if any changes are made to it, such as construction or
+ * terraforming. Whether two adjacent regions are connected is decided by combining the edges of both.
+ *
+ * The transport network is described by a traits type, which provides:
+ *  - `TTileRegionSides GetTileSides(TileIndex tile) const`: the sides through which a vehicle could leave, or enter,
+ *    the tile. For the head of a tunnel or bridge only the side away from the tunnel or bridge.
+ *  - `bool IsTunnelBridgeTile(TileIndex tile) const`: whether the tile is the head of a tunnel or bridge that is
+ *    part of the network.
+ */
+class TileRegion
+{
+private:
+	std::array<TTileRegionTraversabilityBits, DIAGDIR_END> edge_traversability_bits{};
+	bool has_cross_region_tunnel_bridges = false;
+	bool initialized = false;
+	TTileRegionPatchLabel number_of_patches = 0; // 0 = no network, 1 = one single patch, etc...
+	const OrthogonalTileArea tile_area;
+	std::unique_ptr<TTileRegionPatchLabelArray> tile_patch_labels; ///< Tile patch labels, this may be nullptr in the following trivial cases: region is invalid, region has no network (0 patches), the whole region is one patch (1 patch)
+
+	/**
+	 * Returns the local index of the tile within the region. The N corner represents 0,
+	 * the x direction is positive in the SW direction, and Y is positive in the SE direction.
+	 * @param tile Tile within the region.
+	 * @returns The local index.
+	 */
+	inline int GetLocalIndex(TileIndex tile) const
+	{
+		assert(this->tile_area.Contains(tile));
+		return (TileX(tile) - TileX(this->tile_area.tile)) + TILE_REGION_EDGE_LENGTH * (TileY(tile) - TileY(this->tile_area.tile));
+	}
+
+public:
+	TileRegion(int region_x, int region_y)
+		: tile_area(TileXY(region_x * TILE_REGION_EDGE_LENGTH, region_y * TILE_REGION_EDGE_LENGTH), TILE_REGION_EDGE_LENGTH, TILE_REGION_EDGE_LENGTH)
+	{}
+
+	OrthogonalTileIterator begin() const { return this->tile_area.begin(); }
+	OrthogonalTileIterator end() const { return this->tile_area.end(); }
+
+	int GetRegionX() const { return GetTileRegionX(this->tile_area.tile); }
+	int GetRegionY() const { return GetTileRegionY(this->tile_area.tile); }
+
+	bool IsInitialized() const { return this->initialized; }
+
+	void Invalidate() { this->initialized = false; }
+
+	/**
+	 * Returns a set of bits indicating which edge tiles on a particular side have the network leading out of the region.
+	 * @see GetLocalIndex() for a description of the coordinate system used.
+	 * @param side Which side of the region we want to know the edge traversability of.
+	 * @returns A value holding the edge traversability bits.
+	 */
+	TTileRegionTraversabilityBits GetEdgeTraversabilityBits(DiagDirection side) const { return this->edge_traversability_bits[side]; }
+
+	/**
+	 * @returns The amount of individual patches present within the region. A value of
+	 * 0 means there is no network present in the region at all.
+	 */
+	int NumberOfPatches() const { return this->number_of_patches; }
+
+	/**
+	 * @returns Whether the region contains tunnels or bridges that cross the region boundaries.
+	 */
+	bool HasCrossRegionTunnelBridges() const { return this->has_cross_region_tunnel_bridges; }
+
+	/**
+	 * Returns the patch label that was assigned to the tile.
+	 * @param tile The tile of which we want to retrieve the label.
+	 * @returns The label assigned to the tile.
+	 */
+	TTileRegionPatchLabel GetLabel(TileIndex tile) const
+	{
+		assert(this->tile_area.Contains(tile));
+		if (this->tile_patch_labels == nullptr) {
+			return this->NumberOfPatches() == 0 ? INVALID_TILE_REGION_PATCH : FIRST_TILE_REGION_LABEL;
+		}
+		return (*this->tile_patch_labels)[GetLocalIndex(tile)];
+	}
+
+	/**
+	 * Performs the connected component labeling and other data gathering.
+	 * @param traits The transport network to label.
+	 * @see TileRegion
+	 */
+	template <class Ttraits>
+	void ForceUpdate(const Ttraits &traits)
+	{
+		this->has_cross_region_tunnel_bridges = false;
+
+		/* Acquire a tile patch label array if this region does not already have one */
+		if (this->tile_patch_labels == nullptr) {
+			this->tile_patch_labels = std::make_unique<TTileRegionPatchLabelArray>();
+		}
+
+		this->tile_patch_labels->fill(INVALID_TILE_REGION_PATCH);
+		this->edge_traversability_bits.fill(0);
+
+		TTileRegionPatchLabel current_label = FIRST_TILE_REGION_LABEL;
+		TTileRegionPatchLabel highest_assigned_label = 0;
+
+		/* Perform connected component labeling. This uses a flooding algorithm that expands until no
+		 * additional tiles can be added. Only tiles inside the region are considered. */
+		for (const TileIndex start_tile : this->tile_area) {
+			static std::vector<TileIndex> tiles_to_check;
+			tiles_to_check.clear();
+			tiles_to_check.push_back(start_tile);
+
+			bool increase_label = false;
+			while (!tiles_to_check.empty()) {
+				const TileIndex tile = tiles_to_check.back();
+				tiles_to_check.pop_back();
+
+				const TTileRegionSides sides = traits.GetTileSides(tile);
+				if (sides == 0) continue;
+
+				TTileRegionPatchLabel &tile_patch = (*this->tile_patch_labels)[GetLocalIndex(tile)];
+				if (tile_patch != INVALID_TILE_REGION_PATCH) continue;
+
+				tile_patch = current_label;
+				highest_assigned_label = current_label;
+				increase_label = true;
+
+				for (const DiagDirection side : SetBitIterator<DiagDirection>(sides)) {
+					const TileIndex neighbour = TileAddByDiagDir(tile, side);
+					if (!this->tile_area.Contains(neighbour)) {
+						const int local_x_or_y = DiagDirToAxis(side) == AXIS_X ? TileY(tile) - TileY(this->tile_area.tile) : TileX(tile) - TileX(this->tile_area.tile);
+						SetBit(this->edge_traversability_bits[side], local_x_or_y);
+					} else if (HasBit(traits.GetTileSides(neighbour), ReverseDiagDir(side))) {
+						tiles_to_check.push_back(neighbour);
+					}
+				}
+
+				if (traits.IsTunnelBridgeTile(tile)) {
+					const TileIndex other_end = GetOtherTunnelBridgeEnd(tile);
+					if (this->tile_area.Contains(other_end)) {
+						tiles_to_check.push_back(other_end);
+					} else {
+						this->has_cross_region_tunnel_bridges = true;
+					}
+				}
+			}
+
+			if (increase_label) current_label++;
+		}
+
+		this->number_of_patches = highest_assigned_label;
+		this->initialized = true;
+
+		if (this->number_of_patches == 0 || (this->number_of_patches == 1 &&
+				std::all_of(this->tile_patch_labels->begin(), this->tile_patch_labels->end(), [](TTileRegionPatchLabel label) { return label == FIRST_TILE_REGION_LABEL; }))) {
+			/* No need for patch storage: trivial cases */
+			this->tile_patch_labels.reset();
+		}
+	}
+
+	TTileRegionEdgeLabels GetEdgeLabels(DiagDirection side) const;
+
+	/**
+	 * Calls the provided callback function for all patches of an adjacent region
+	 * that are accessible from one particular side of a patch of this region.
+	 * @param label The label of the patch of this region.
+	 * @param side The side of this region to look for neighbouring patches.
+	 * @param neighboring_region The region on that side.
+	 * @param func The function that will be called for each #TileRegionPatchDesc that is found.
+	 */
+	template <class Tfunc>
+	void VisitAdjacentPatches(TTileRegionPatchLabel label, DiagDirection side, const TileRegion &neighboring_region, Tfunc &&func) const
+	{
+		/* Indicates via which local x or y coordinates (depends on the "side" parameter) we can cross over into the adjacent region. */
+		const DiagDirection opposite_side = ReverseDiagDir(side);
+		const TTileRegionTraversabilityBits traversability_bits = this->edge_traversability_bits[side]
+			& neighboring_region.edge_traversability_bits[opposite_side];
+		if (traversability_bits == 0) return;
+
+		const int nx = neighboring_region.GetRegionX();
+		const int ny = neighboring_region.GetRegionY();
+
+		if (this->number_of_patches == 1 && neighboring_region.number_of_patches == 1) {
+			func(TileRegionPatchDesc{ nx, ny, FIRST_TILE_REGION_LABEL }); // No further checks needed because we know there is just one patch for both adjacent regions
+			return;
+		}
+
+		/* Multiple patches can be reached from the current patch. Check each edge tile individually. */
+		std::array<TTileRegionPatchLabel, TILE_REGION_EDGE_LENGTH> unique_labels;
+		auto unique_labels_end = unique_labels.begin();
+		for (int x_or_y = 0; x_or_y < TILE_REGION_EDGE_LENGTH; ++x_or_y) {
+			if (!HasBit(traversability_bits, x_or_y)) continue;
+			if (this->GetLabel(GetTileRegionEdgeTile(this->GetRegionX(), this->GetRegionY(), side, x_or_y)) != label) continue;
+
+			const TTileRegionPatchLabel neighbor_label = neighboring_region.GetLabel(GetTileRegionEdgeTile(nx, ny, opposite_side, x_or_y));
+			assert(neighbor_label != INVALID_TILE_REGION_PATCH);
+			if (std::find(unique_labels.begin(), unique_labels_end, neighbor_label) == unique_labels_end) *unique_labels_end++ = neighbor_label;
+		}
+		for (auto it = unique_labels.begin(); it != unique_labels_end; ++it) func(TileRegionPatchDesc{ nx, ny, *it });
+	}
+
+	/**
+	 * Calls the provided callback function for the far ends of all tunnels and bridges
+	 * that lead from a patch of this region into another region.
+	 * @param traits The transport network of this region.
+	 * @param label The label of the patch of this region.
+	 * @param func The function that will be called with each far end tile.
+	 */
+	template <class Ttraits, class Tfunc>
+	void VisitCrossRegionTunnelBridgeEnds(const Ttraits &traits, TTileRegionPatchLabel label, Tfunc &&func) const
+	{
+		if (!this->has_cross_region_tunnel_bridges) return;
+
+		for (const TileIndex tile : this->tile_area) {
+			if (!traits.IsTunnelBridgeTile(tile) || this->GetLabel(tile) != label) continue;
+			const TileIndex other_end_tile = GetOtherTunnelBridgeEnd(tile);
+			if (GetTileRegionIndex(tile) != GetTileRegionIndex(other_end_tile)) func(other_end_tile);
+		}
+	}
+
+	void PrintDebugInfo() const;
+};
+
+/**
+ * All regions of a transport network on the map. The regions are updated when
+ * they are needed, so this may only be used by one thread at a time.
+ * @tparam Ttraits The transport network, see #TileRegion.
+ */
+template <class Ttraits>
+class TileRegions
+{
+private:
+	const Ttraits traits; ///< The transport network.
+	std::vector<TileRegion> regions; ///< The regions, row by row.
+
+public:
+	explicit TileRegions(Ttraits traits = {}) : traits(traits) {}
+
+	/**
+	 * Allocates the appropriate amount of regions for the current map size.
+	 */
+	void Allocate()
+	{
+		this->regions.clear();
+		this->regions.reserve(static_cast<size_t>(GetTileRegionMapSizeX()) * GetTileRegionMapSizeY());
+
+		for (int region_y = 0; region_y < GetTileRegionMapSizeY(); region_y++) {
+			for (int region_x = 0; region_x < GetTileRegionMapSizeX(); region_x++) {
+				this->regions.emplace_back(region_x, region_y);
+			}
+		}
+	}
+
+	/**
+	 * Marks the region that tile is part of as invalid.
+	 * @param tile Tile within the region that we wish to invalidate.
+	 */
+	void Invalidate(TileIndex tile)
+	{
+		const TTileRegionIndex index = GetTileRegionIndex(tile);
+		if (index < this->regions.size()) this->regions[index].Invalidate();
+	}
+
+	/**
+	 * Returns a region, after updating it when it is not initialized.
+	 * @param region_x The X coordinate of the region.
+	 * @param region_y The Y coordinate of the region.
+	 * @returns The up to date region.
+	 */
+	const TileRegion &GetUpdatedRegion(int region_x, int region_y)
+	{
+		TileRegion &region = this->regions[GetTileRegionIndex(region_x, region_y)];
+		if (!region.IsInitialized()) region.ForceUpdate(this->traits);
+		return region;
+	}
+
+	/**
+	 * Returns basic region patch information for the provided tile.
+	 * @param tile The tile for which the information will be calculated.
+	 */
+	TileRegionPatchDesc GetPatchInfo(TileIndex tile)
+	{
+		const TileRegion &region = this->GetUpdatedRegion(GetTileRegionX(tile), GetTileRegionY(tile));
+		return TileRegionPatchDesc{ GetTileRegionX(tile), GetTileRegionY(tile), region.GetLabel(tile) };
+	}
+
+	/**
+	 * Calls the provided callback function on all accessible region patches in
+	 * each cardinal direction, plus any others that are reachable via tunnels and bridges.
+	 * @param region_patch Patch within the region to start searching from.
+	 * @param func The function that will be called for each accessible #TileRegionPatchDesc that is found.
+	 */
+	template <class Tfunc>
+	void VisitPatchNeighbors(const TileRegionPatchDesc &region_patch, Tfunc &&func)
+	{
+		if (region_patch.label == INVALID_TILE_REGION_PATCH) return;
+
+		const TileRegion &current_region = this->GetUpdatedRegion(region_patch.x, region_patch.y);
+
+		/* Visit adjacent region patches in each cardinal direction */
+		for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+			const TileIndexDiffC offset = TileIndexDiffCByDiagDir(side);
+			const int nx = region_patch.x + offset.x;
+			const int ny = region_patch.y + offset.y;
+			if (nx < 0 || ny < 0 || nx >= GetTileRegionMapSizeX() || ny >= GetTileRegionMapSizeY()) continue;
+
+			current_region.VisitAdjacentPatches(region_patch.label, side, this->GetUpdatedRegion(nx, ny), func);
+		}
+
+		/* Visit neighbouring patches accessible via cross-region tunnels and bridges */
+		current_region.VisitCrossRegionTunnelBridgeEnds(this->traits, region_patch.label, [&](TileIndex other_end_tile) { func(this->GetPatchInfo(other_end_tile)); });
+	}
+};
+
+#endif /* TILE_REGIONS_HPP */
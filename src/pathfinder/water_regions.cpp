@@ -8,295 +8,209 @@
  /** @file water_regions.cpp Handles dividing the water in the map into square regions to assist pathfinding. */
 
 #include "stdafx.h"
-#include "map_func.h"
 #include "water_regions.h"
-#include "map_func.h"
-#include "tilearea_type.h"
+#include "tile_regions.hpp"
 #include "track_func.h"
 #include "transport_type.h"
 #include "landscape.h"
-#include "tunnelbridge_map.h"
-#include "follow_track.hpp"
-#include "ship.h"
+#include "yapf/yapf_ship_regions.h"
 #include "debug.h"
 
-using TWaterRegionTraversabilityBits = uint16_t;
-constexpr TWaterRegionPatchLabel FIRST_REGION_LABEL = 1;
-
-static_assert(sizeof(TWaterRegionTraversabilityBits) * 8 == WATER_REGION_EDGE_LENGTH);
-static_assert(sizeof(TWaterRegionPatchLabel) == sizeof(uint8_t)); // Important for the hash calculation.
-
-static inline TrackBits GetWaterTracks(TileIndex tile) { return TrackStatusToTrackBits(GetTileTrackStatus(tile, TRANSPORT_WATER, 0)); }
-static inline bool IsAqueductTile(TileIndex tile) { return IsBridgeTile(tile) && GetTunnelBridgeTransportType(tile) == TRANSPORT_WATER; }
-
-static inline int GetWaterRegionX(TileIndex tile) { return TileX(tile) / WATER_REGION_EDGE_LENGTH; }
-static inline int GetWaterRegionY(TileIndex tile) { return TileY(tile) / WATER_REGION_EDGE_LENGTH; }
-
-static inline int GetWaterRegionMapSizeX() { return Map::SizeX() / WATER_REGION_EDGE_LENGTH; }
-static inline int GetWaterRegionMapSizeY() { return Map::SizeY() / WATER_REGION_EDGE_LENGTH; }
+/** The water network, for #TileRegion. */
+struct WaterRegionTraits {
+	/**
+	 * Is the tile the head of an aqueduct?
+	 * @param tile The tile to check.
+	 * @return True iff the tile is the head of an aqueduct.
+	 */
+	inline bool IsTunnelBridgeTile(TileIndex tile) const
+	{
+		return IsBridgeTile(tile) && GetTunnelBridgeTransportType(tile) == TRANSPORT_WATER;
+	}
 
-static inline TWaterRegionIndex GetWaterRegionIndex(int region_x, int region_y) { return GetWaterRegionMapSizeX() * region_y + region_x; }
-static inline TWaterRegionIndex GetWaterRegionIndex(TileIndex tile) { return GetWaterRegionIndex(GetWaterRegionX(tile), GetWaterRegionY(tile)); }
+	/**
+	 * Get the sides of a tile through which a ship could leave, or enter, the tile.
+	 * These are the sides that the water tracks of the tile lead to, so two tiles are
+	 * connected under the same rules the ship track follower uses. For aqueducts only
+	 * the side towards the ground next to the head is returned.
+	 * @param tile The tile to get the sides for.
+	 * @return Bit mask of DiagDirections.
+	 */
+	TTileRegionSides GetTileSides(TileIndex tile) const
+	{
+		if (this->IsTunnelBridgeTile(tile)) return 1 << ReverseDiagDir(GetTunnelBridgeDirection(tile));
 
-using TWaterRegionPatchLabelArray = std::array<TWaterRegionPatchLabel, WATER_REGION_NUMBER_OF_TILES>;
+		const TrackBits bits = TrackStatusToTrackBits(GetTileTrackStatus(tile, TRANSPORT_WATER, 0));
+		TTileRegionSides sides = 0;
+		for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+			if ((bits & DiagdirReachesTracks(ReverseDiagDir(side))) != TRACK_BIT_NONE) SetBit(sides, side);
+		}
+		return sides;
+	}
+};
 
 /**
- * Represents a square section of the map of a fixed size. Within this square individual unconnected patches of water are
- * identified using a Connected Component Labeling (CCL) algorithm. Note that all information stored in this class applies
- * only to tiles within the square section, there is no knowledge about the rest of the map. This makes it easy to invalidate
- * and update a water region if any changes are made to it, such as construction or terraforming.
+ * A water region, with the graph of the water region patches that can be reached from each of its patches.
  */
-class WaterRegion
+class WaterRegion : public TileRegion
 {
 private:
-	std::array<TWaterRegionTraversabilityBits, DIAGDIR_END> edge_traversability_bits{};
-	bool has_cross_region_aqueducts = false;
-	bool initialized = false;
-	TWaterRegionPatchLabel number_of_patches = 0; // 0 = no water, 1 = one single patch of water, etc...
-	const OrthogonalTileArea tile_area;
-	std::unique_ptr<TWaterRegionPatchLabelArray> tile_patch_labels; ///< Tile patch labels, this may be nullptr in the following trivial cases: region is invalid, region is only land (0 patches), region is only water (1 patch)
-
-	/**
-	 * Returns the local index of the tile within the region. The N corner represents 0,
-	 * the x direction is positive in the SW direction, and Y is positive in the SE direction.
-	 * @param tile Tile within the water region.
-	 * @returns The local index.
-	 */
-	inline int GetLocalIndex(TileIndex tile) const
-	{
-		assert(this->tile_area.Contains(tile));
-		return (TileX(tile) - TileX(this->tile_area.tile)) + WATER_REGION_EDGE_LENGTH * (TileY(tile) - TileY(this->tile_area.tile));
-	}
+	bool graph_valid = false; ///< Whether the neighbor lists match the current labels of this region and of the adjacent regions.
+	std::vector<uint16_t> neighbor_offsets; ///< Offset into #neighbors for each patch label, plus one for the end of the last patch.
+	std::vector<WaterRegionPatchDesc> neighbors; ///< Patches in adjacent regions that can be reached from the patches of this region.
+	std::vector<uint16_t> aqueduct_offsets; ///< Offset into #aqueduct_ends for each patch label, plus one for the end of the last patch.
+	std::vector<TileIndex> aqueduct_ends; ///< Far ends of the aqueducts that lead from the patches of this region into another region.
 
 public:
-	WaterRegion(int region_x, int region_y)
-		: tile_area(TileXY(region_x * WATER_REGION_EDGE_LENGTH, region_y * WATER_REGION_EDGE_LENGTH), WATER_REGION_EDGE_LENGTH, WATER_REGION_EDGE_LENGTH)
-	{}
-
-	OrthogonalTileIterator begin() const { return this->tile_area.begin(); }
-	OrthogonalTileIterator end() const { return this->tile_area.end(); }
-
-	bool IsInitialized() const { return this->initialized; }
-
-	void Invalidate()
-	{
-		if (!IsInitialized()) Debug(map, 3, "Invalidated water region ({},{})", GetWaterRegionX(this->tile_area.tile), GetWaterRegionY(this->tile_area.tile));
-		this->initialized = false;
-	}
-
-	/**
-	 * Returns a set of bits indicating whether an edge tile on a particular side is traversable or not. These
-	 * values can be used to determine whether a ship can enter/leave the region through a particular edge tile.
-	 * @see GetLocalIndex() for a description of the coordinate system used.
-	 * @param side Which side of the region we want to know the edge traversability of.
-	 * @returns A value holding the edge traversability bits.
-	 */
-	TWaterRegionTraversabilityBits GetEdgeTraversabilityBits(DiagDirection side) const { return edge_traversability_bits[side]; }
+	using TileRegion::TileRegion;
 
-	/**
-	 * @returns The amount of individual water patches present within the water region. A value of
-	 * 0 means there is no water present in the water region at all.
-	 */
-	int NumberOfPatches() const { return this->number_of_patches; }
+	bool IsGraphValid() const { return this->graph_valid; }
 
-	/**
-	 * @returns Whether the water region contains aqueducts that cross the region boundaries.
-	 */
-	bool HasCrossRegionAqueducts() const { return this->has_cross_region_aqueducts; }
+	void InvalidateGraph() { this->graph_valid = false; }
 
 	/**
-	 * Returns the patch label that was assigned to the tile.
-	 * @param tile The tile of which we want to retrieve the label.
-	 * @returns The label assigned to the tile.
+	 * Rebuilds the lists of neighboring patches for all patches of this region.
+	 * The labels of this region and of the adjacent regions must be up to date.
+	 * @param adjacent_regions The adjacent region on each side, or nullptr at the edge of the map.
 	 */
-	TWaterRegionPatchLabel GetLabel(TileIndex tile) const
+	void UpdateGraph(const std::array<const WaterRegion *, DIAGDIR_END> &adjacent_regions)
 	{
-		assert(this->tile_area.Contains(tile));
-		if (this->tile_patch_labels == nullptr) {
-			return this->NumberOfPatches() == 0 ? INVALID_WATER_REGION_PATCH : 1;
-		}
-		return (*this->tile_patch_labels)[GetLocalIndex(tile)];
-	}
+		assert(this->IsInitialized());
 
-	/**
-	 * Performs the connected component labeling and other data gathering.
-	 * @see WaterRegion
-	 */
-	void ForceUpdate()
-	{
-		Debug(map, 3, "Updating water region ({},{})", GetWaterRegionX(this->tile_area.tile), GetWaterRegionY(this->tile_area.tile));
-		this->has_cross_region_aqueducts = false;
+		this->neighbor_offsets.clear();
+		this->neighbors.clear();
+		this->aqueduct_offsets.clear();
+		this->aqueduct_ends.clear();
 
-		/* Acquire a tile patch label array if this region does not already have one */
-		if (this->tile_patch_labels == nullptr) {
-			this->tile_patch_labels = std::make_unique<TWaterRegionPatchLabelArray>();
-		}
+		for (TWaterRegionPatchLabel label = FIRST_TILE_REGION_LABEL; label <= this->NumberOfPatches(); label++) {
+			this->neighbor_offsets.push_back(static_cast<uint16_t>(this->neighbors.size()));
+			this->aqueduct_offsets.push_back(static_cast<uint16_t>(this->aqueduct_ends.size()));
 
-		this->tile_patch_labels->fill(INVALID_WATER_REGION_PATCH);
-		this->edge_traversability_bits.fill(0);
-
-		TWaterRegionPatchLabel current_label = 1;
-		TWaterRegionPatchLabel highest_assigned_label = 0;
-
-		/* Perform connected component labeling. This uses a flooding algorithm that expands until no
-		 * additional tiles can be added. Only tiles inside the water region are considered. */
-		for (const TileIndex start_tile : tile_area) {
-			static std::vector<TileIndex> tiles_to_check;
-			tiles_to_check.clear();
-			tiles_to_check.push_back(start_tile);
-
-			bool increase_label = false;
-			while (!tiles_to_check.empty()) {
-				const TileIndex tile = tiles_to_check.back();
-				tiles_to_check.pop_back();
-
-				const TrackdirBits valid_dirs = TrackBitsToTrackdirBits(GetWaterTracks(tile));
-				if (valid_dirs == TRACKDIR_BIT_NONE) continue;
-
-				TWaterRegionPatchLabel &tile_patch = (*this->tile_patch_labels)[GetLocalIndex(tile)];
-				if (tile_patch != INVALID_WATER_REGION_PATCH) continue;
-
-				tile_patch = current_label;
-				highest_assigned_label = current_label;
-				increase_label = true;
-
-				for (const Trackdir dir : SetTrackdirBitIterator(valid_dirs)) {
-					/* By using a TrackFollower we "play by the same rules" as the actual ship pathfinder */
-					CFollowTrackWater ft;
-					if (ft.Follow(tile, dir)) {
-						if (this->tile_area.Contains(ft.m_new_tile)) {
-							tiles_to_check.push_back(ft.m_new_tile);
-						} else if (!ft.m_is_bridge) {
-							assert(DistanceManhattan(ft.m_new_tile, tile) == 1);
-							const auto side = DiagdirBetweenTiles(tile, ft.m_new_tile);
-							const int local_x_or_y = DiagDirToAxis(side) == AXIS_X ? TileY(tile) - TileY(this->tile_area.tile) : TileX(tile) - TileX(this->tile_area.tile);
-							SetBit(this->edge_traversability_bits[side], local_x_or_y);
-						} else {
-							this->has_cross_region_aqueducts = true;
-						}
-					}
-				}
+			for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+				if (adjacent_regions[side] == nullptr) continue;
+				this->VisitAdjacentPatches(label, side, *adjacent_regions[side], [this](const WaterRegionPatchDesc &neighbor) { this->neighbors.push_back(neighbor); });
 			}
 
-			if (increase_label) current_label++;
+			this->VisitCrossRegionTunnelBridgeEnds(WaterRegionTraits{}, label, [this](TileIndex other_end_tile) { this->aqueduct_ends.push_back(other_end_tile); });
 		}
 
-		this->number_of_patches = highest_assigned_label;
-		this->initialized = true;
-
-		if (this->number_of_patches == 0 || (this->number_of_patches == 1 &&
-				std::all_of(this->tile_patch_labels->begin(), this->tile_patch_labels->end(), [](TWaterRegionPatchLabel label) { return label == 1; }))) {
-			/* No need for patch storage: trivial cases */
-			this->tile_patch_labels.reset();
-		}
+		this->neighbor_offsets.push_back(static_cast<uint16_t>(this->neighbors.size()));
+		this->aqueduct_offsets.push_back(static_cast<uint16_t>(this->aqueduct_ends.size()));
+		this->graph_valid = true;
 	}
 
 	/**
-	 * Updates the patch labels and other data, but only if the region is not yet initialized.
+	 * Returns the patches that can be reached from one of the patches of this region.
+	 * @param label The label of the patch.
+	 * @returns The neighbors of the patch.
 	 */
-	inline void UpdateIfNotInitialized()
+	WaterRegionPatchNeighbors GetNeighbors(TWaterRegionPatchLabel label) const
 	{
-		if (!this->initialized) ForceUpdate();
-	}
-
-	void PrintDebugInfo()
-	{
-		Debug(map, 9, "Water region {},{} labels and edge traversability = ...", GetWaterRegionX(tile_area.tile), GetWaterRegionY(tile_area.tile));
-
-		const size_t max_element_width = std::to_string(this->number_of_patches).size();
-
-		std::array<int, 16> traversability_NW{0};
-		for (auto bitIndex : SetBitIterator(edge_traversability_bits[DIAGDIR_NW])) *(traversability_NW.rbegin() + bitIndex) = 1;
-		Debug(map, 9, "    {:{}}", fmt::join(traversability_NW, " "), max_element_width);
-		Debug(map, 9, "  +{:->{}}+", "", WATER_REGION_EDGE_LENGTH * (max_element_width + 1) + 1);
-
-		for (int y = 0; y < WATER_REGION_EDGE_LENGTH; ++y) {
-			std::string line{};
-			for (int x = 0; x < WATER_REGION_EDGE_LENGTH; ++x) {
-				const auto label = this->GetLabel(TileAddXY(tile_area.tile, x, y));
-				const std::string label_str = label == INVALID_WATER_REGION_PATCH ? "." : std::to_string(label);
-				line = fmt::format("{:{}}", label_str, max_element_width) + " " + line;
-			}
-			Debug(map, 9, "{} | {}| {}", GB(this->edge_traversability_bits[DIAGDIR_SW], y, 1), line, GB(this->edge_traversability_bits[DIAGDIR_NE], y, 1));
-		}
-
-		Debug(map, 9, "  +{:->{}}+", "", WATER_REGION_EDGE_LENGTH * (max_element_width + 1) + 1);
-		std::array<int, 16> traversability_SE{0};
-		for (auto bitIndex : SetBitIterator(edge_traversability_bits[DIAGDIR_SE])) *(traversability_SE.rbegin() + bitIndex) = 1;
-		Debug(map, 9, "    {:{}}", fmt::join(traversability_SE, " "), max_element_width);
+		assert(this->graph_valid);
+		assert(label != INVALID_WATER_REGION_PATCH && label <= this->NumberOfPatches());
+		return WaterRegionPatchNeighbors{
+			{ this->neighbors.data() + this->neighbor_offsets[label - 1], this->neighbors.data() + this->neighbor_offsets[label] },
+			{ this->aqueduct_ends.data() + this->aqueduct_offsets[label - 1], this->aqueduct_ends.data() + this->aqueduct_offsets[label] },
+		};
 	}
 };
 
 std::vector<WaterRegion> _water_regions;
+static std::vector<TWaterRegionIndex> _invalidated_water_regions; ///< Water regions that may not be initialized; see #UpdateInvalidatedWaterRegions.
+static std::vector<TWaterRegionIndex> _invalidated_water_region_graphs; ///< Water regions of which the patch graph may not be valid; see #UpdateInvalidatedWaterRegions.
 
-TileIndex GetTileIndexFromLocalCoordinate(int region_x, int region_y, int local_x, int local_y)
-{
-	assert(local_x >= 0 && local_x < WATER_REGION_EDGE_LENGTH);
-	assert(local_y >= 0 && local_y < WATER_REGION_EDGE_LENGTH);
-	return TileXY(WATER_REGION_EDGE_LENGTH * region_x + local_x, WATER_REGION_EDGE_LENGTH * region_y + local_y);
-}
-
-TileIndex GetEdgeTileCoordinate(int region_x, int region_y, DiagDirection side, int x_or_y)
+/**
+ * Marks a water region as invalid, and remembers it for #UpdateInvalidatedWaterRegions.
+ * @param index The index of the water region.
+ */
+static void InvalidateWaterRegionIndex(TWaterRegionIndex index)
 {
-	assert(x_or_y >= 0 && x_or_y < WATER_REGION_EDGE_LENGTH);
-	switch (side) {
-		case DIAGDIR_NE: return GetTileIndexFromLocalCoordinate(region_x, region_y, 0, x_or_y);
-		case DIAGDIR_SW: return GetTileIndexFromLocalCoordinate(region_x, region_y, WATER_REGION_EDGE_LENGTH - 1, x_or_y);
-		case DIAGDIR_NW: return GetTileIndexFromLocalCoordinate(region_x, region_y, x_or_y, 0);
-		case DIAGDIR_SE: return GetTileIndexFromLocalCoordinate(region_x, region_y, x_or_y, WATER_REGION_EDGE_LENGTH - 1);
-		default: NOT_REACHED();
+	if (_water_regions[index].IsInitialized()) {
+		Debug(map, 3, "Invalidated water region ({},{})", _water_regions[index].GetRegionX(), _water_regions[index].GetRegionY());
+		_invalidated_water_regions.push_back(index);
+		InvalidateWaterRegionPathCache();
 	}
+	_water_regions[index].Invalidate();
 }
 
-WaterRegion &GetUpdatedWaterRegion(uint16_t region_x, uint16_t region_y)
-{
-	WaterRegion &result = _water_regions[GetWaterRegionIndex(region_x, region_y)];
-	result.UpdateIfNotInitialized();
-	return result;
-}
-
-WaterRegion &GetUpdatedWaterRegion(TileIndex tile)
+/**
+ * Marks the patch graph of a water region as invalid, and remembers it for #UpdateInvalidatedWaterRegions.
+ * @param index The index of the water region.
+ */
+static void InvalidateWaterRegionGraphIndex(TWaterRegionIndex index)
 {
-	WaterRegion &result = _water_regions[GetWaterRegionIndex(tile)];
-	result.UpdateIfNotInitialized();
-	return result;
+	if (_water_regions[index].IsGraphValid()) {
+		_invalidated_water_region_graphs.push_back(index);
+		InvalidateWaterRegionPathCache();
+	}
+	_water_regions[index].InvalidateGraph();
 }
 
 /**
- * Returns the index of the water region.
- * @param water_region The water region to return the index for.
+ * Returns the index of the water region adjacent to another water region.
+ * @param index The index of the water region.
+ * @param side The side to look at.
+ * @returns The index of the adjacent region, or std::nullopt at the edge of the map.
  */
-TWaterRegionIndex GetWaterRegionIndex(const WaterRegionDesc &water_region)
+static std::optional<TWaterRegionIndex> GetAdjacentWaterRegionIndex(TWaterRegionIndex index, DiagDirection side)
 {
-	return GetWaterRegionIndex(water_region.x, water_region.y);
+	const TileIndexDiffC offset = TileIndexDiffCByDiagDir(side);
+	const int nx = static_cast<int>(index % GetTileRegionMapSizeX()) + offset.x;
+	const int ny = static_cast<int>(index / GetTileRegionMapSizeX()) + offset.y;
+	if (nx < 0 || ny < 0 || nx >= GetTileRegionMapSizeX() || ny >= GetTileRegionMapSizeY()) return std::nullopt;
+	return GetTileRegionIndex(nx, ny);
 }
 
 /**
- * Calculates a number that uniquely identifies the provided water region patch.
- * @param water_region_patch The Water region to calculate the hash for.
+ * Updates the patch labels and other data of a water region, but only if the region is not initialized.
+ * The patch graph of the region itself always has to be rebuilt after that. The graph of an adjacent
+ * region only has to be rebuilt when the labels along the edge towards it changed.
+ * @param index The index of the water region.
+ * @returns The up to date water region.
  */
-int CalculateWaterRegionPatchHash(const WaterRegionPatchDesc &water_region_patch)
+static WaterRegion &UpdateWaterRegion(TWaterRegionIndex index)
 {
-	return water_region_patch.label | GetWaterRegionIndex(water_region_patch) << 8;
+	WaterRegion &region = _water_regions[index];
+	if (region.IsInitialized()) return region;
+
+	std::array<TTileRegionEdgeLabels, DIAGDIR_END> old_edge_labels;
+	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) old_edge_labels[side] = region.GetEdgeLabels(side);
+
+	Debug(map, 3, "Updating water region ({},{})", region.GetRegionX(), region.GetRegionY());
+	region.ForceUpdate(WaterRegionTraits{});
+
+	InvalidateWaterRegionGraphIndex(index);
+	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+		if (region.GetEdgeLabels(side) == old_edge_labels[side]) continue;
+		const std::optional<TWaterRegionIndex> adjacent_index = GetAdjacentWaterRegionIndex(index, side);
+		if (adjacent_index.has_value()) InvalidateWaterRegionGraphIndex(*adjacent_index);
+	}
+	return region;
 }
 
 /**
- * Returns the center tile of a particular water region.
- * @param water_region The water region to find the center tile for.
- * @returns The center tile of the water region.
+ * Updates the patch graph of a water region when it is not valid.
+ * @param index The index of the water region.
+ * @returns The water region with an up to date graph.
  */
-TileIndex GetWaterRegionCenterTile(const WaterRegionDesc &water_region)
+static WaterRegion &UpdateWaterRegionGraph(TWaterRegionIndex index)
 {
-	return TileXY(water_region.x * WATER_REGION_EDGE_LENGTH + (WATER_REGION_EDGE_LENGTH / 2), water_region.y * WATER_REGION_EDGE_LENGTH + (WATER_REGION_EDGE_LENGTH / 2));
+	WaterRegion &region = UpdateWaterRegion(index);
+
+	/* Updating the adjacent regions may invalidate the graph of this region. */
+	std::array<const WaterRegion *, DIAGDIR_END> adjacent_regions{};
+	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+		const std::optional<TWaterRegionIndex> adjacent_index = GetAdjacentWaterRegionIndex(index, side);
+		if (adjacent_index.has_value()) adjacent_regions[side] = &UpdateWaterRegion(*adjacent_index);
+	}
+
+	if (!region.IsGraphValid()) region.UpdateGraph(adjacent_regions);
+	return region;
 }
 
-/**
- * Returns basic water region information for the provided tile.
- * @param tile The tile for which the information will be calculated.
- */
-WaterRegionDesc GetWaterRegionInfo(TileIndex tile)
+static WaterRegion &GetUpdatedWaterRegion(TileIndex tile)
 {
-	return WaterRegionDesc{ GetWaterRegionX(tile), GetWaterRegionY(tile) };
+	return UpdateWaterRegion(GetTileRegionIndex(tile));
 }
 
 /**
@@ -306,7 +220,7 @@ WaterRegionDesc GetWaterRegionInfo(TileIndex tile)
 WaterRegionPatchDesc GetWaterRegionPatchInfo(TileIndex tile)
 {
 	WaterRegion &region = GetUpdatedWaterRegion(tile);
-	return WaterRegionPatchDesc{ GetWaterRegionX(tile), GetWaterRegionY(tile), region.GetLabel(tile)};
+	return WaterRegionPatchDesc{ GetTileRegionX(tile), GetTileRegionY(tile), region.GetLabel(tile)};
 }
 
 /**
@@ -316,92 +230,35 @@ WaterRegionPatchDesc GetWaterRegionPatchInfo(TileIndex tile)
 void InvalidateWaterRegion(TileIndex tile)
 {
 	if (!IsValidTile(tile)) return;
-	const int water_region_index = GetWaterRegionIndex(tile);
-	_water_regions[water_region_index].Invalidate();
 
-	/* When updating the water region we look into the first tile of adjacent water regions to determine edge
-	 * traversability. This means that if we invalidate any region edge tiles we might also change the traversability
-	 * of the adjacent region. This code ensures the adjacent regions also get invalidated in such a case. */
-	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
-		const int adjacent_region_index = GetWaterRegionIndex(TileAddByDiagDir(tile, side));
-		if (adjacent_region_index != water_region_index) _water_regions[adjacent_region_index].Invalidate();
-	}
+	/* The edge traversability of a water region only depends on its own tiles. When it changes,
+	 * updating the region invalidates the patch graph of the adjacent region. */
+	InvalidateWaterRegionIndex(GetTileRegionIndex(tile));
 }
 
 /**
- * Calls the provided callback function for all water region patches
- * accessible from one particular side of the starting patch.
- * @param water_region_patch Water patch within the water region to start searching from
- * @param side Side of the water region to look for neigboring patches of water
- * @param callback The function that will be called for each neighbor that is found
+ * Updates all water regions and patch graphs that are not up to date. After this the water
+ * regions are only read by the pathfinders, so they can be used by multiple threads at once
+ * until the map changes again.
  */
-static inline void VisitAdjacentWaterRegionPatchNeighbors(const WaterRegionPatchDesc &water_region_patch, DiagDirection side, TVisitWaterRegionPatchCallBack &func)
+void UpdateInvalidatedWaterRegions()
 {
-	if (water_region_patch.label == INVALID_WATER_REGION_PATCH) return;
-
-	const WaterRegion &current_region = GetUpdatedWaterRegion(water_region_patch.x, water_region_patch.y);
+	for (TWaterRegionIndex index : _invalidated_water_regions) UpdateWaterRegion(index);
+	_invalidated_water_regions.clear();
 
-	const TileIndexDiffC offset = TileIndexDiffCByDiagDir(side);
-	const int nx = water_region_patch.x + offset.x;
-	const int ny = water_region_patch.y + offset.y;
-
-	if (nx < 0 || ny < 0 || nx >= GetWaterRegionMapSizeX() || ny >= GetWaterRegionMapSizeY()) return;
-
-	const WaterRegion &neighboring_region = GetUpdatedWaterRegion(nx, ny);
-	const DiagDirection opposite_side = ReverseDiagDir(side);
-
-	/* Indicates via which local x or y coordinates (depends on the "side" parameter) we can cross over into the adjacent region. */
-	const TWaterRegionTraversabilityBits traversability_bits = current_region.GetEdgeTraversabilityBits(side)
-		& neighboring_region.GetEdgeTraversabilityBits(opposite_side);
-	if (traversability_bits == 0) return;
-
-	if (current_region.NumberOfPatches() == 1 && neighboring_region.NumberOfPatches() == 1) {
-		func(WaterRegionPatchDesc{ nx, ny, FIRST_REGION_LABEL }); // No further checks needed because we know there is just one patch for both adjacent regions
-		return;
-	}
-
-	/* Multiple water patches can be reached from the current patch. Check each edge tile individually. */
-	static std::vector<TWaterRegionPatchLabel> unique_labels; // static and vector-instead-of-map for performance reasons
-	unique_labels.clear();
-	for (int x_or_y = 0; x_or_y < WATER_REGION_EDGE_LENGTH; ++x_or_y) {
-		if (!HasBit(traversability_bits, x_or_y)) continue;
-
-		const TileIndex current_edge_tile = GetEdgeTileCoordinate(water_region_patch.x, water_region_patch.y, side, x_or_y);
-		const TWaterRegionPatchLabel current_label = current_region.GetLabel(current_edge_tile);
-		if (current_label != water_region_patch.label) continue;
-
-		const TileIndex neighbor_edge_tile = GetEdgeTileCoordinate(nx, ny, opposite_side, x_or_y);
-		const TWaterRegionPatchLabel neighbor_label = neighboring_region.GetLabel(neighbor_edge_tile);
-		assert(neighbor_label != INVALID_WATER_REGION_PATCH);
-		if (std::find(unique_labels.begin(), unique_labels.end(), neighbor_label) == unique_labels.end()) unique_labels.push_back(neighbor_label);
-	}
-	for (TWaterRegionPatchLabel unique_label : unique_labels) func(WaterRegionPatchDesc{ nx, ny, unique_label });
+	for (TWaterRegionIndex index : _invalidated_water_region_graphs) UpdateWaterRegionGraph(index);
+	_invalidated_water_region_graphs.clear();
 }
 
 /**
- * Calls the provided callback function on all accessible water region patches in
- * each cardinal direction, plus any others that are reachable via aqueducts.
- * @param water_region_patch Water patch within the water region to start searching from
- * @param callback The function that will be called for each accessible water patch that is found
+ * Returns the water region patches that can be reached from a particular patch.
+ * @param water_region_patch Water patch within the water region to start searching from.
+ * @returns The neighbors of the patch; these stay valid until the map changes.
  */
-void VisitWaterRegionPatchNeighbors(const WaterRegionPatchDesc &water_region_patch, TVisitWaterRegionPatchCallBack &callback)
+WaterRegionPatchNeighbors GetWaterRegionPatchNeighbors(const WaterRegionPatchDesc &water_region_patch)
 {
-	if (water_region_patch.label == INVALID_WATER_REGION_PATCH) return;
-
-	const WaterRegion &current_region = GetUpdatedWaterRegion(water_region_patch.x, water_region_patch.y);
-
-	/* Visit adjacent water region patches in each cardinal direction */
-	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) VisitAdjacentWaterRegionPatchNeighbors(water_region_patch, side, callback);
-
-	/* Visit neigboring water patches accessible via cross-region aqueducts */
-	if (current_region.HasCrossRegionAqueducts()) {
-		for (const TileIndex tile : current_region) {
-			if (GetWaterRegionPatchInfo(tile) == water_region_patch && IsAqueductTile(tile)) {
-				const TileIndex other_end_tile = GetOtherBridgeEnd(tile);
-				if (GetWaterRegionIndex(tile) != GetWaterRegionIndex(other_end_tile)) callback(GetWaterRegionPatchInfo(other_end_tile));
-			}
-		}
-	}
+	assert(water_region_patch.label != INVALID_WATER_REGION_PATCH);
+	return UpdateWaterRegionGraph(GetTileRegionIndex(water_region_patch.x, water_region_patch.y)).GetNeighbors(water_region_patch.label);
 }
 
 /**
@@ -410,15 +267,21 @@ void VisitWaterRegionPatchNeighbors(const WaterRegionPatchDesc &water_region_pat
 void AllocateWaterRegions()
 {
 	_water_regions.clear();
-	_water_regions.reserve(static_cast<size_t>(GetWaterRegionMapSizeX()) * GetWaterRegionMapSizeY());
+	InvalidateWaterRegionPathCache();
+	_water_regions.reserve(static_cast<size_t>(GetTileRegionMapSizeX()) * GetTileRegionMapSizeY());
 
-	Debug(map, 2, "Allocating {} x {} water regions", GetWaterRegionMapSizeX(), GetWaterRegionMapSizeY());
+	Debug(map, 2, "Allocating {} x {} water regions", GetTileRegionMapSizeX(), GetTileRegionMapSizeY());
 
-	for (int region_y = 0; region_y < GetWaterRegionMapSizeY(); region_y++) {
-		for (int region_x = 0; region_x < GetWaterRegionMapSizeX(); region_x++) {
+	for (int region_y = 0; region_y < GetTileRegionMapSizeY(); region_y++) {
+		for (int region_x = 0; region_x < GetTileRegionMapSizeX(); region_x++) {
 			_water_regions.emplace_back(region_x, region_y);
 		}
 	}
+
+	/* None of the new regions is initialized yet. */
+	_invalidated_water_regions.resize(_water_regions.size());
+	std::iota(_invalidated_water_regions.begin(), _invalidated_water_regions.end(), 0);
+	_invalidated_water_region_graphs = _invalidated_water_regions;
 }
 
 void PrintWaterRegionDebugInfo(TileIndex tile)
@@ -10,58 +10,54 @@
 #ifndef WATER_REGIONS_H
 #define WATER_REGIONS_H
 
-#include "tile_type.h"
-#include "map_func.h"
+#include "tile_regions.h"
 
-using TWaterRegionPatchLabel = uint8_t;
-using TWaterRegionIndex = uint;
+using TWaterRegionPatchLabel = TTileRegionPatchLabel;
+using TWaterRegionIndex = TTileRegionIndex;
 
-constexpr int WATER_REGION_EDGE_LENGTH = 16;
-constexpr int WATER_REGION_NUMBER_OF_TILES = WATER_REGION_EDGE_LENGTH * WATER_REGION_EDGE_LENGTH;
-constexpr TWaterRegionPatchLabel INVALID_WATER_REGION_PATCH = 0;
+constexpr int WATER_REGION_EDGE_LENGTH = TILE_REGION_EDGE_LENGTH;
+constexpr int WATER_REGION_NUMBER_OF_TILES = TILE_REGION_NUMBER_OF_TILES;
+constexpr TWaterRegionPatchLabel INVALID_WATER_REGION_PATCH = INVALID_TILE_REGION_PATCH;
 
-/**
- * Describes a single interconnected patch of water within a particular water region.
- */
-struct WaterRegionPatchDesc
-{
-	int x; ///< The X coordinate of the water region, i.e. X=2 is the 3rd water region along the X-axis
-	int y; ///< The Y coordinate of the water region, i.e. Y=2 is the 3rd water region along the Y-axis
-	TWaterRegionPatchLabel label; ///< Unique label identifying the patch within the region
+using WaterRegionPatchDesc = TileRegionPatchDesc; ///< Describes a single interconnected patch of water within a particular water region.
+using WaterRegionDesc = TileRegionDesc; ///< Describes a single square water region.
 
-	bool operator==(const WaterRegionPatchDesc &other) const { return x == other.x && y == other.y && label == other.label; }
-	bool operator!=(const WaterRegionPatchDesc &other) const { return !(*this == other); }
-};
+inline TWaterRegionIndex GetWaterRegionIndex(const WaterRegionDesc &water_region) { return GetTileRegionIndex(water_region); }
+inline int CalculateWaterRegionPatchHash(const WaterRegionPatchDesc &water_region_patch) { return CalculateTileRegionPatchHash(water_region_patch); }
+inline TileIndex GetWaterRegionCenterTile(const WaterRegionDesc &water_region) { return GetTileRegionCenterTile(water_region); }
+inline WaterRegionDesc GetWaterRegionInfo(TileIndex tile) { return GetTileRegionInfo(tile); }
 
+WaterRegionPatchDesc GetWaterRegionPatchInfo(TileIndex tile);
+
+void InvalidateWaterRegion(TileIndex tile);
+void UpdateInvalidatedWaterRegions();
 
 /**
- * Describes a single square water region.
+ * The water region patches that can be reached from a particular patch.
  */
-struct WaterRegionDesc
+struct WaterRegionPatchNeighbors
 {
-	int x; ///< The X coordinate of the water region, i.e. X=2 is the 3rd water region along the X-axis
-	int y; ///< The Y coordinate of the water region, i.e. Y=2 is the 3rd water region along the Y-axis
-
-	WaterRegionDesc(const int x, const int y) : x(x), y(y) {}
-	WaterRegionDesc(const WaterRegionPatchDesc &water_region_patch) : x(water_region_patch.x), y(water_region_patch.y) {}
-
-	bool operator==(const WaterRegionDesc &other) const { return x == other.x && y == other.y; }
-	bool operator!=(const WaterRegionDesc &other) const { return !(*this == other); }
+	std::span<const WaterRegionPatchDesc> adjacent; ///< Patches in the adjacent water regions.
+	std::span<const TileIndex> aqueduct_ends; ///< Far ends of aqueducts that lead into another water region.
 };
 
-TWaterRegionIndex GetWaterRegionIndex(const WaterRegionDesc &water_region);
+WaterRegionPatchNeighbors GetWaterRegionPatchNeighbors(const WaterRegionPatchDesc &water_region_patch);
 
-int CalculateWaterRegionPatchHash(const WaterRegionPatchDesc &water_region_patch);
-
-TileIndex GetWaterRegionCenterTile(const WaterRegionDesc &water_region);
-
-WaterRegionDesc GetWaterRegionInfo(TileIndex tile);
-WaterRegionPatchDesc GetWaterRegionPatchInfo(TileIndex tile);
-
-void InvalidateWaterRegion(TileIndex tile);
+/**
+ * Calls the provided visitor for all accessible water region patches in
+ * each cardinal direction, plus any others that are reachable via aqueducts.
+ * @param water_region_patch Water patch within the water region to start searching from
+ * @param visitor The callable that will be called for each accessible water patch that is found
+ */
+template <typename Tvisitor>
+inline void VisitWaterRegionPatchNeighbors(const WaterRegionPatchDesc &water_region_patch, Tvisitor &&visitor)
+{
+	if (water_region_patch.label == INVALID_WATER_REGION_PATCH) return;
 
-using TVisitWaterRegionPatchCallBack = std::function<void(const WaterRegionPatchDesc &)>;
-void VisitWaterRegionPatchNeighbors(const WaterRegionPatchDesc &water_region_patch, TVisitWaterRegionPatchCallBack &callback);
+	const WaterRegionPatchNeighbors neighbors = GetWaterRegionPatchNeighbors(water_region_patch);
+	for (const WaterRegionPatchDesc &neighbor : neighbors.adjacent) visitor(neighbor);
+	for (const TileIndex &tile : neighbors.aqueduct_ends) visitor(GetWaterRegionPatchInfo(tile));
+}
 
 void AllocateWaterRegions();
 
@@ -13,6 +13,7 @@
 #include "../../misc/array.hpp"
 #include "../../misc/hashtable.hpp"
 #include "../../misc/binaryheap.hpp"
+#include "../../debug.h"
 
 /**
  * Hash table based node list multi-container class.
@@ -157,4 +158,313 @@ public:
 	}
 };
 
+/**
+ * Open addressing hash set of node pointers, keyed on the key of the node.
+ *  Uses linear probing and backward shift deletion, so no tombstones are needed.
+ */
+template <class Titem_>
+class CNodePtrHashSetT {
+public:
+	typedef typename Titem_::Key Key;
+
+private:
+	std::vector<Titem_ *> m_slots; ///< The slots; nullptr for an empty slot.
+	uint m_count = 0;              ///< Number of used slots.
+
+	inline uint GetIdealSlot(const Key &key) const
+	{
+		return (static_cast<uint>(key.CalcHash()) * 2654435761U) & (m_slots.size() - 1);
+	}
+
+	inline uint FindSlot(const Key &key) const
+	{
+		uint mask = static_cast<uint>(m_slots.size()) - 1;
+		uint i = GetIdealSlot(key);
+		while (m_slots[i] != nullptr && !(m_slots[i]->GetKey() == key)) i = (i + 1) & mask;
+		return i;
+	}
+
+	void Grow()
+	{
+		std::vector<Titem_ *> old_slots(m_slots.size() * 2, nullptr);
+		std::swap(old_slots, m_slots);
+		for (Titem_ *item : old_slots) {
+			if (item != nullptr) m_slots[FindSlot(item->GetKey())] = item;
+		}
+	}
+
+public:
+	/**
+	 * Create the hash set.
+	 * @param bits Log2 of the initial number of slots.
+	 */
+	explicit CNodePtrHashSetT(int bits) : m_slots(static_cast<size_t>(1) << bits, nullptr) {}
+
+	/** Number of items in the set. */
+	inline int Count() const
+	{
+		return m_count;
+	}
+
+	/** Find the item with the given key, or nullptr when there is none. */
+	inline Titem_ *Find(const Key &key) const
+	{
+		return m_slots[FindSlot(key)];
+	}
+
+	/** Add an item; no item with the same key may be in the set. */
+	inline void Push(Titem_ &item)
+	{
+		if ((m_count + 1) * 2 > m_slots.size()) Grow();
+		uint i = FindSlot(item.GetKey());
+		assert(m_slots[i] == nullptr);
+		m_slots[i] = &item;
+		m_count++;
+	}
+
+	/** Remove and return the item with the given key, which must be in the set. */
+	inline Titem_ &Pop(const Key &key)
+	{
+		uint mask = static_cast<uint>(m_slots.size()) - 1;
+		uint i = FindSlot(key);
+		Titem_ *item = m_slots[i];
+		assert(item != nullptr);
+
+		/* Move back items of the same probe sequence into the gap. */
+		for (uint j = (i + 1) & mask; m_slots[j] != nullptr; j = (j + 1) & mask) {
+			uint k = GetIdealSlot(m_slots[j]->GetKey());
+			if (((j - k) & mask) >= ((j - i) & mask)) {
+				m_slots[i] = m_slots[j];
+				i = j;
+			}
+		}
+		m_slots[i] = nullptr;
+		m_count--;
+		return *item;
+	}
+};
+
+/**
+ * Node list multi-container class that avoids allocations during the search.
+ *  Implements the same interface as CNodeList_HashTableT, but:
+ *  - nodes are stored in chunks that are taken from, and at the end of the
+ *    search handed back to, a per thread pool instead of being freed;
+ *  - open and closed nodes are kept in open addressing hash sets;
+ *  - the priority queue is a 4-ary heap in one contiguous array. Nodes that
+ *    are removed from the open list, or got a better estimate, are not searched
+ *    for in the heap, but skipped when their old entry reaches the top of it.
+ */
+template <class Titem_, int Thash_bits_open_, int Thash_bits_closed_>
+class CNodeList_PooledHeapT {
+public:
+	typedef Titem_ Titem;                    ///< Make #Titem_ visible from outside of class.
+	typedef typename Titem_::Key Key;        ///< Make Titem_::Key a property of this class.
+	typedef CNodePtrHashSetT<Titem_> CNodeSet; ///< How pointers to open and closed nodes will be stored.
+
+	static_assert(std::is_trivially_destructible_v<Titem_>);
+
+protected:
+	static const uint CHUNK_SIZE = 4096; ///< Number of nodes in one chunk of the arena.
+	static const uint HEAP_ARITY = 4;    ///< Number of children of each heap node.
+
+	typedef std::unique_ptr<Titem_[]> Chunk;
+	static inline thread_local std::vector<Chunk> s_spare_chunks; ///< Chunks that are not used by any search.
+
+	std::vector<Chunk> m_chunks;  ///< Chunks used by this search.
+	uint m_num_items = 0;         ///< Number of nodes created in the chunks.
+	uint m_chunks_reused = 0;     ///< Number of chunks taken from the pool.
+	uint m_chunks_allocated = 0;  ///< Number of chunks that had to be allocated.
+	CNodeSet m_open;              ///< Hash set of pointers to open item data.
+	CNodeSet m_closed;            ///< Hash set of pointers to closed item data.
+	/** Entry in the heap; the estimate is stored so outdated entries can be recognised. */
+	struct HeapEntry {
+		int estimate; ///< Estimate of the item when it was added.
+		Titem_ *item; ///< The item.
+	};
+
+	std::vector<HeapEntry> m_heap; ///< 4-ary heap of open items; may contain outdated entries.
+	Titem *m_new_node = nullptr;  ///< New open node under construction.
+
+	/** Does the heap entry still describe an open item? */
+	inline bool IsCurrent(const HeapEntry &entry) const
+	{
+		return entry.item->GetCostEstimate() == entry.estimate && m_open.Find(entry.item->GetKey()) == entry.item;
+	}
+
+	void HeapPush(Titem_ *item)
+	{
+		HeapEntry entry{ item->GetCostEstimate(), item };
+		uint gap = static_cast<uint>(m_heap.size());
+		m_heap.push_back(entry);
+		while (gap > 0) {
+			uint parent = (gap - 1) / HEAP_ARITY;
+			if (entry.estimate >= m_heap[parent].estimate) break;
+			m_heap[gap] = m_heap[parent];
+			gap = parent;
+		}
+		m_heap[gap] = entry;
+	}
+
+	void HeapPop()
+	{
+		HeapEntry last = m_heap.back();
+		m_heap.pop_back();
+		uint size = static_cast<uint>(m_heap.size());
+		if (size == 0) return;
+
+		uint gap = 0;
+		for (;;) {
+			uint first_child = gap * HEAP_ARITY + 1;
+			if (first_child >= size) break;
+			uint best = first_child;
+			uint end = std::min(first_child + HEAP_ARITY, size);
+			for (uint child = first_child + 1; child < end; child++) {
+				if (m_heap[child].estimate < m_heap[best].estimate) best = child;
+			}
+			if (m_heap[best].estimate >= last.estimate) break;
+			m_heap[gap] = m_heap[best];
+			gap = best;
+		}
+		m_heap[gap] = last;
+	}
+
+	/** Drop outdated entries from the top of the heap. */
+	inline void SkipOutdatedHeapTop()
+	{
+		while (!m_heap.empty() && !IsCurrent(m_heap.front())) HeapPop();
+	}
+
+public:
+	/** default constructor */
+	CNodeList_PooledHeapT() : m_open(Thash_bits_open_), m_closed(Thash_bits_closed_)
+	{
+		m_heap.reserve(2048);
+	}
+
+	/** destructor, hands the chunks back to the pool */
+	~CNodeList_PooledHeapT()
+	{
+		Debug(yapf, 4, "Node list: {} nodes in {} chunks, {} reused and {} allocated", m_num_items, m_chunks.size(), m_chunks_reused, m_chunks_allocated);
+		for (Chunk &chunk : m_chunks) s_spare_chunks.push_back(std::move(chunk));
+	}
+
+	/** return number of open nodes */
+	inline int OpenCount()
+	{
+		return m_open.Count();
+	}
+
+	/** return number of closed nodes */
+	inline int ClosedCount()
+	{
+		return m_closed.Count();
+	}
+
+	/** allocate new data item from the arena */
+	inline Titem_ *CreateNewNode()
+	{
+		if (m_new_node == nullptr) {
+			if (m_num_items == m_chunks.size() * CHUNK_SIZE) {
+				if (s_spare_chunks.empty()) {
+					m_chunks.push_back(std::make_unique<Titem_[]>(CHUNK_SIZE));
+					m_chunks_allocated++;
+				} else {
+					m_chunks.push_back(std::move(s_spare_chunks.back()));
+					s_spare_chunks.pop_back();
+					m_chunks_reused++;
+				}
+			}
+			m_new_node = &ItemAt(m_num_items++);
+			new (m_new_node) Titem_;
+		}
+		return m_new_node;
+	}
+
+	/** Notify the nodelist that we don't want to discard the given node. */
+	inline void FoundBestNode(Titem_ &item)
+	{
+		if (&item == m_new_node) {
+			m_new_node = nullptr;
+		}
+	}
+
+	/** insert given item as open node (into m_open and m_heap) */
+	inline void InsertOpenNode(Titem_ &item)
+	{
+		assert(m_closed.Find(item.GetKey()) == nullptr);
+		m_open.Push(item);
+		HeapPush(&item);
+		if (&item == m_new_node) {
+			m_new_node = nullptr;
+		}
+	}
+
+	/** return the best open node */
+	inline Titem_ *GetBestOpenNode()
+	{
+		SkipOutdatedHeapTop();
+		return m_heap.empty() ? nullptr : m_heap.front().item;
+	}
+
+	/** remove and return the best open node */
+	inline Titem_ *PopBestOpenNode()
+	{
+		SkipOutdatedHeapTop();
+		if (m_heap.empty()) return nullptr;
+		Titem_ *item = m_heap.front().item;
+		HeapPop();
+		m_open.Pop(item->GetKey());
+		return item;
+	}
+
+	/** return the open node specified by a key or nullptr if not found */
+	inline Titem_ *FindOpenNode(const Key &key)
+	{
+		return m_open.Find(key);
+	}
+
+	/** remove and return the open node specified by a key */
+	inline Titem_ &PopOpenNode(const Key &key)
+	{
+		Titem_ &item = m_open.Pop(key);
+		/* Removing the top is cheap, other items are skipped once they get there. */
+		if (!m_heap.empty() && m_heap.front().item == &item) HeapPop();
+		return item;
+	}
+
+	/** close node */
+	inline void InsertClosedNode(Titem_ &item)
+	{
+		assert(m_open.Find(item.GetKey()) == nullptr);
+		m_closed.Push(item);
+	}
+
+	/** return the closed node specified by a key or nullptr if not found */
+	inline Titem_ *FindClosedNode(const Key &key)
+	{
+		return m_closed.Find(key);
+	}
+
+	/** The number of items. */
+	inline int TotalCount()
+	{
+		return m_num_items;
+	}
+
+	/** Get a particular item. */
+	inline Titem_ &ItemAt(int idx)
+	{
+		return m_chunks[idx / CHUNK_SIZE][idx % CHUNK_SIZE];
+	}
+
+	/** Helper for creating output of this array. */
+	template <class D> void Dump(D &dmp) const
+	{
+		dmp.WriteValue("num_items", m_num_items);
+		for (uint i = 0; i < m_num_items; i++) {
+			dmp.WriteStructT(fmt::format("item[{}]", i), &m_chunks[i / CHUNK_SIZE][i % CHUNK_SIZE]);
+		}
+	}
+};
+
 #endif /* NODELIST_HPP */
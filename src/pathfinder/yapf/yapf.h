@@ -26,6 +26,14 @@
  */
 Track YapfShipChooseTrack(const Ship *v, TileIndex tile, bool &path_found, ShipPathCache &path_cache);
 
+/**
+ * Finds the path for a ship beyond its current tile, without making random choices.
+ * @param v          the ship that needs to find a path
+ * @param path_cache [out] the path, starting with the trackdir on the next tile
+ * @return           whether a path has been found
+ */
+bool YapfShipFindPathAhead(const Ship *v, ShipPathCache &path_cache);
+
 /**
  * Returns true if it is better to reverse the ship before leaving depot using YAPF.
  * @param v the ship leaving the depot
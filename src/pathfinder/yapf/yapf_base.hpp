@@ -12,6 +12,7 @@
 
 #include "../../debug.h"
 #include "../../settings_type.h"
+#include "yapf_stats.h"
 
 /**
  * CYapfBaseT - A-star type path finder base class.
@@ -22,11 +23,11 @@
  *  ----------------------------------
  *  The following types must be defined in the 'Types' argument:
  *    - Types::Tpf - your pathfinder derived from CYapfBaseT
- *    - Types::NodeList - open/closed node list (look at CNodeList_HashTableT)
+ *    - Types::NodeList - open/closed node list (look at CNodeList_HashTableT or CNodeList_PooledHeapT)
  *  NodeList needs to have defined local type Titem - defines the pathfinder node type.
  *  Node needs to define local type Key - the node key in the collection ()
  *
- *  For node list you can use template class CNodeList_HashTableT, for which
+ *  For node list you can use template class CNodeList_PooledHeapT, for which
  *  you need to declare only your node type. Look at test_yapf.h for an example.
  *
  *
@@ -112,6 +113,12 @@ public:
 	{
 		m_veh = v;
 
+		const bool record_search = _debug_yapf_level >= YAPF_STATS_DEBUG_LEVEL;
+		const auto start_time = record_search ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+		const int start_closed = m_nodes.ClosedCount();
+		const int start_cost_calcs = m_stats_cost_calcs;
+		const int start_cache_hits = m_stats_cache_hits;
+
 		Yapf().PfSetStartupNodes();
 
 		for (;;) {
@@ -133,6 +140,13 @@ public:
 
 		const bool destination_found = (m_pBestDestNode != nullptr);
 
+		if (record_search) {
+			YapfRecordSearch(VehicleType::EXPECTED_TYPE, (m_veh != nullptr) ? m_veh->index : INVALID_VEHICLE,
+				(m_veh != nullptr) ? m_veh->tile : INVALID_TILE, (m_veh != nullptr) ? m_veh->dest_tile : INVALID_TILE,
+				m_nodes.ClosedCount() - start_closed, m_stats_cache_hits - start_cache_hits, m_stats_cost_calcs - start_cost_calcs,
+				std::chrono::steady_clock::now() - start_time);
+		}
+
 		if (_debug_yapf_level >= 3) {
 			const UnitID veh_idx = (m_veh != nullptr) ? m_veh->unitnumber : 0;
 			const char ttc = Yapf().TransportTypeChar();
@@ -157,6 +171,12 @@ public:
 		return (m_pBestDestNode != nullptr) ? m_pBestDestNode : m_pBestIntermediateNode;
 	}
 
+	/** Did the last search stop because it visited the maximum number of nodes? */
+	inline bool HasReachedNodeLimit()
+	{
+		return m_max_search_nodes != 0 && m_nodes.ClosedCount() >= m_max_search_nodes;
+	}
+
 	/**
 	 * Calls NodeList::CreateNewNode() - allocates new node that can be filled and used
 	 *  as argument for AddStartupNode() or AddNewNode()
@@ -96,14 +96,53 @@ public:
  *  the track layout changes. It is implemented as base class because it needs
  *  to be shared between all rail YAPF types (one shared counter, one notification
  *  function.
+ *
+ *  Next to the global counter the map is divided in cells of 16x16 tiles and
+ *  every cell remembers the value of the counter when a tile in it changed for
+ *  the last time. Segments remember the cells they touch, so only the segments
+ *  that pass through a changed cell are thrown away when the track layout changes.
  */
 struct CSegmentCostCacheBase
 {
-	static int   s_rail_change_counter;
+	static const uint CELL_BITS = 4; ///< Log2 of the size of a cell in tiles.
 
-	static void NotifyTrackLayoutChange(TileIndex, Track)
+	static uint64_t s_rail_change_counter; ///< Incremented on every change of the track layout; 64 bits, so it never wraps.
+	static uint s_rail_flush_counter;      ///< Incremented when the whole cache has to be thrown away; only compared for equality.
+	static std::vector<uint64_t> s_cell_change_counter; ///< Value of #s_rail_change_counter at the last change within a cell.
+
+	/**
+	 * Get the index of the cell the given tile is in.
+	 * @param tile The tile to get the cell for.
+	 * @return The index of the cell.
+	 */
+	static inline uint GetCellIndex(TileIndex tile)
+	{
+		return (TileY(tile) >> CELL_BITS) * (Map::SizeX() >> CELL_BITS) + (TileX(tile) >> CELL_BITS);
+	}
+
+	/**
+	 * Check whether anything changed in the given cell after the given moment.
+	 * @param cell The cell to check.
+	 * @param counter The value of #s_rail_change_counter at the moment to check against.
+	 * @return True iff a tile in the cell changed after \a counter.
+	 */
+	static inline bool IsCellChangedSince(uint cell, uint64_t counter)
+	{
+		return cell >= s_cell_change_counter.size() || s_cell_change_counter[cell] > counter;
+	}
+
+	static void NotifyTrackLayoutChange(TileIndex tile, Track)
 	{
 		s_rail_change_counter++;
+
+		size_t cells = Map::Size() >> (2 * CELL_BITS);
+		if (tile == INVALID_TILE || s_cell_change_counter.size() != cells) {
+			/* Unknown location or a different map; throw everything away. */
+			s_rail_flush_counter++;
+			s_cell_change_counter.assign(cells, s_rail_change_counter);
+			return;
+		}
+		s_cell_change_counter[GetCellIndex(tile)] = s_rail_change_counter;
 	}
 };
 
@@ -145,6 +184,10 @@ struct CSegmentCostCacheT : public CSegmentCostCacheBase {
 			*found = false;
 			item = new (m_heap.Append()) Tsegment(key);
 			m_map.Push(*item);
+		} else if (item->IsChanged()) {
+			/* The track layout changed somewhere along the segment; start over. */
+			*found = false;
+			item->Reset();
 		} else {
 			*found = true;
 		}
@@ -181,12 +224,12 @@ protected:
 
 	inline static Cache &stGetGlobalCache()
 	{
-		static int last_rail_change_counter = 0;
+		static uint last_rail_flush_counter = 0;
 		static Cache C;
 
 		/* delete the cache sometimes... */
-		if (last_rail_change_counter != Cache::s_rail_change_counter) {
-			last_rail_change_counter = Cache::s_rail_change_counter;
+		if (last_rail_flush_counter != Cache::s_rail_flush_counter) {
+			last_rail_flush_counter = Cache::s_rail_flush_counter;
 			C.Flush();
 		}
 		return C;
@@ -323,6 +323,12 @@ public:
 
 		TrackFollower tf_local(v, Yapf().GetCompatibleRailTypes());
 
+		if (!is_cached_segment) {
+			/* The tiles the segment depends on are gathered while walking it. */
+			segment.m_change_counter = CSegmentCostCacheBase::s_rail_change_counter;
+			segment.m_cells.clear();
+		}
+
 		if (!has_parent) {
 			/* We will jump to the middle of the cost calculator assuming that segment cache is not used. */
 			assert(!is_cached_segment);
@@ -369,6 +375,17 @@ public:
 
 no_entry_cost: // jump here at the beginning if the node has no parent (it is the first node)
 
+			/* Remember where the segment goes, including the tiles that got skipped. */
+			segment.AddTile(cur.tile);
+			if (tf->m_tiles_skipped > 0) {
+				TileIndex skipped_tile = cur.tile;
+				TileIndexDiff back = TileOffsByDiagDir(ReverseDiagDir(TrackdirToExitdir(cur.td)));
+				for (int i = 0; i < tf->m_tiles_skipped; i++) {
+					skipped_tile = TileAdd(skipped_tile, back);
+					segment.AddTile(skipped_tile);
+				}
+			}
+
 			/* All other tile costs will be calculated here. */
 			segment_cost += Yapf().OneTileCost(cur.tile, cur.td);
 
@@ -493,9 +510,14 @@ no_entry_cost: // jump here at the beginning if the node has no parent (it is th
 				if (TrackFollower::DoTrackMasking() && !HasOnewaySignalBlockingTrackdir(cur.tile, cur.td)) {
 					end_segment_reason |= ESRB_SAFE_TILE;
 				}
+				/* Building track on the tile ahead would change this segment. */
+				segment.AddTile(TileAddByDiagDir(cur.tile, TrackdirToExitdir(cur.td)));
 				break;
 			}
 
+			/* The next tile determines where the segment ends. */
+			segment.AddTile(tf_local.m_new_tile);
+
 			/* Check if the next tile is not a choice. */
 			if (KillFirstBit(tf_local.m_new_td_bits) != TRACKDIR_BIT_NONE) {
 				/* More than one segment will follow. Close this one. */
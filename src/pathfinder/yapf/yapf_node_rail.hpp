@@ -70,6 +70,8 @@ struct CYapfRailSegment
 	Trackdir               m_last_signal_td;
 	EndSegmentReasonBits   m_end_segment_reason;
 	CYapfRailSegment      *m_hash_next;
+	uint64_t               m_change_counter; ///< Value of CSegmentCostCacheBase::s_rail_change_counter when the cost was calculated.
+	std::vector<uint>      m_cells;          ///< Cells (see CSegmentCostCacheBase) the segment depends on.
 
 	inline CYapfRailSegment(const CYapfRailSegmentKey &key)
 		: m_key(key)
@@ -80,8 +82,45 @@ struct CYapfRailSegment
 		, m_last_signal_td(INVALID_TRACKDIR)
 		, m_end_segment_reason(ESRB_NONE)
 		, m_hash_next(nullptr)
+		, m_change_counter(CSegmentCostCacheBase::s_rail_change_counter)
 	{}
 
+	/** Forget the calculated cost, but keep the segment in its hash chain. */
+	inline void Reset()
+	{
+		m_last_tile = INVALID_TILE;
+		m_last_td = INVALID_TRACKDIR;
+		m_cost = -1;
+		m_last_signal_tile = INVALID_TILE;
+		m_last_signal_td = INVALID_TRACKDIR;
+		m_end_segment_reason = ESRB_NONE;
+		m_change_counter = CSegmentCostCacheBase::s_rail_change_counter;
+		m_cells.clear();
+	}
+
+	/**
+	 * Mark the segment as depending on the state of the given tile.
+	 * @param tile The tile the segment passes or looks at.
+	 */
+	inline void AddTile(TileIndex tile)
+	{
+		uint cell = CSegmentCostCacheBase::GetCellIndex(tile);
+		if (std::find(m_cells.begin(), m_cells.end(), cell) == m_cells.end()) m_cells.push_back(cell);
+	}
+
+	/**
+	 * Check whether the track layout changed in any of the cells of this segment
+	 * since its cost was calculated.
+	 * @return True iff the cached data can not be used anymore.
+	 */
+	inline bool IsChanged() const
+	{
+		for (uint cell : m_cells) {
+			if (CSegmentCostCacheBase::IsCellChangedSince(cell, m_change_counter)) return true;
+		}
+		return false;
+	}
+
 	inline const Key &GetKey() const
 	{
 		return m_key;
@@ -218,7 +257,7 @@ typedef CYapfRailNodeT<CYapfNodeKeyExitDir>  CYapfRailNodeExitDir;
 typedef CYapfRailNodeT<CYapfNodeKeyTrackDir> CYapfRailNodeTrackDir;
 
 /* Default NodeList types */
-typedef CNodeList_HashTableT<CYapfRailNodeExitDir , 8, 10> CRailNodeListExitDir;
-typedef CNodeList_HashTableT<CYapfRailNodeTrackDir, 8, 10> CRailNodeListTrackDir;
+typedef CNodeList_PooledHeapT<CYapfRailNodeExitDir , 8, 10> CRailNodeListExitDir;
+typedef CNodeList_PooledHeapT<CYapfRailNodeTrackDir, 8, 10> CRailNodeListTrackDir;
 
 #endif /* YAPF_NODE_RAIL_HPP */
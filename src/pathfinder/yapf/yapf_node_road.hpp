@@ -31,7 +31,7 @@ typedef CYapfRoadNodeT<CYapfNodeKeyExitDir>  CYapfRoadNodeExitDir;
 typedef CYapfRoadNodeT<CYapfNodeKeyTrackDir> CYapfRoadNodeTrackDir;
 
 /* Default NodeList types */
-typedef CNodeList_HashTableT<CYapfRoadNodeExitDir , 8, 10> CRoadNodeListExitDir;
-typedef CNodeList_HashTableT<CYapfRoadNodeTrackDir, 8, 10> CRoadNodeListTrackDir;
+typedef CNodeList_PooledHeapT<CYapfRoadNodeExitDir , 8, 10> CRoadNodeListExitDir;
+typedef CNodeList_PooledHeapT<CYapfRoadNodeTrackDir, 8, 10> CRoadNodeListTrackDir;
 
 #endif /* YAPF_NODE_ROAD_HPP */
@@ -14,8 +14,12 @@
 #include "yapf_node_rail.hpp"
 #include "yapf_costrail.hpp"
 #include "yapf_destrail.hpp"
+#include "yapf_rail_regions.h"
+#include "../rail_regions.h"
 #include "../../viewport_func.h"
 #include "../../newgrf_station.h"
+#include "../../trace.h"
+#include "../../framerate_type.h"
 
 #include "../../safeguards.h"
 
@@ -122,6 +126,23 @@ private:
 		return (tile != m_res_dest || td != m_res_dest_td) && (tile != m_res_fail_tile || td != m_res_fail_td);
 	}
 
+	/** Tell the segment cost cache the reservation of a single track/platform changed. */
+	bool NotifyReservedTrack(TileIndex tile, Trackdir td)
+	{
+		if (IsRailStationTile(tile)) {
+			TileIndex     start = tile;
+			TileIndexDiff diff = TileOffsByDiagDir(TrackdirToExitdir(ReverseTrackdir(td)));
+			do {
+				YapfNotifyTrackLayoutChange(tile, TrackdirToTrack(td));
+				tile = TileAdd(tile, diff);
+			} while (IsCompatibleTrainStationTile(tile, start) && tile != m_origin_tile);
+			tile = start;
+		} else {
+			YapfNotifyTrackLayoutChange(tile, TrackdirToTrack(td));
+		}
+		return tile != m_res_dest || td != m_res_dest_td;
+	}
+
 public:
 	/** Set the target to where the reservation should be extended. */
 	inline void SetReservationTarget(Node *node, TileIndex tile, Trackdir td)
@@ -178,7 +199,9 @@ public:
 		if (target != nullptr) target->okay = true;
 
 		if (Yapf().CanUseGlobalCache(*m_res_node)) {
-			YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
+			for (Node *node = m_res_node; node->m_parent != nullptr; node = node->m_parent) {
+				node->IterateTiles(Yapf().GetVehicle(), Yapf(), *this, &CYapfReserveTrack<Types>::NotifyReservedTrack);
+			}
 		}
 
 		return true;
@@ -369,6 +392,8 @@ public:
 	typedef typename Node::Key Key;                      ///< key to hash tables
 
 protected:
+	TileRegionCorridor m_region_corridor; ///< The rail regions the search is restricted to.
+
 	/** to access inherited path finder */
 	inline Tpf &Yapf()
 	{
@@ -385,10 +410,20 @@ public:
 	{
 		TrackFollower F(Yapf().GetVehicle());
 		if (F.Follow(old_node.GetLastTile(), old_node.GetLastTrackdir())) {
+			if (!m_region_corridor.Contains(F.m_new_tile)) return;
 			Yapf().AddMultipleNodes(&old_node, F);
 		}
 	}
 
+	/**
+	 * Restricts the search to the rail regions along the given path, and the regions directly next to them.
+	 * @param path The rail regions the train should follow.
+	 */
+	inline void RestrictSearch(const std::vector<TileRegionDesc> &path)
+	{
+		m_region_corridor.Restrict(path);
+	}
+
 	/** return debug report character to identify the transportation type */
 	inline char TransportTypeChar() const
 	{
@@ -414,6 +449,23 @@ public:
 			}
 		}
 
+		/* On very long routes the search may run out of nodes before it reaches the destination.
+		 * Retry within the corridor of rail regions leading to the destination, which keeps the
+		 * number of explored nodes down; the result is only used when that does find a path. */
+		if (!path_found && pf1.HasReachedNodeLimit()) {
+			const std::vector<TileRegionDesc> high_level_path = YapfTrainFindRailRegionPath(v, FollowTrainReservation(v).tile);
+			if (!high_level_path.empty()) {
+				Tpf pf3;
+				pf3.RestrictSearch(high_level_path);
+				bool restricted_path_found;
+				Trackdir result3 = pf3.ChooseRailTrack(v, tile, enterdir, tracks, restricted_path_found, reserve_track, target, dest);
+				if (restricted_path_found) {
+					path_found = true;
+					return result3;
+				}
+			}
+		}
+
 		return result1;
 	}
 
@@ -539,6 +591,9 @@ struct CYapfAnySafeTileRail2 : CYapfT<CYapfRail_TypesT<CYapfAnySafeTileRail2, CF
 
 Track YapfTrainChooseTrack(const Train *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, bool reserve_track, PBSTileInfo *target, TileIndex *dest)
 {
+	TraceScope trace("Train pathfinder", v->index);
+	CompanyPerformanceMeasurer company_framerate(CPE_PATHFINDER, v->owner);
+
 	/* default is YAPF type 2 */
 	typedef Trackdir (*PfnChooseRailTrack)(const Train*, TileIndex, DiagDirection, TrackBits, bool&, bool, PBSTileInfo*, TileIndex*);
 	PfnChooseRailTrack pfnChooseRailTrack = &CYapfRail1::stChooseRailTrack;
@@ -613,6 +668,9 @@ bool YapfTrainCheckReverse(const Train *v)
 
 FindDepotData YapfTrainFindNearestDepot(const Train *v, int max_penalty)
 {
+	TraceScope trace("Train depot pathfinder", v->index);
+	CompanyPerformanceMeasurer company_framerate(CPE_PATHFINDER, v->owner);
+
 	const Train *last_veh = v->Last();
 
 	PBSTileInfo origin = FollowTrainReservation(v);
@@ -644,7 +702,11 @@ bool YapfTrainFindNearestSafeTile(const Train *v, TileIndex tile, Trackdir td, b
 }
 
 /** if any track changes, this counter is incremented - that will invalidate segment cost cache */
-int CSegmentCostCacheBase::s_rail_change_counter = 0;
+uint64_t CSegmentCostCacheBase::s_rail_change_counter = 0;
+/** if the whole segment cost cache has to be thrown away, this counter is incremented */
+uint CSegmentCostCacheBase::s_rail_flush_counter = 0;
+/** value of s_rail_change_counter at the last change within each cell */
+std::vector<uint64_t> CSegmentCostCacheBase::s_cell_change_counter;
 
 void YapfNotifyTrackLayoutChange(TileIndex tile, Track track)
 {
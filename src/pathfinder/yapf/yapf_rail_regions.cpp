@@ -0,0 +1,67 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file yapf_rail_regions.cpp Implementation of YAPF for rail regions, which are used for restricting long train searches. */
+
+#include "../../stdafx.h"
+#include "../../train.h"
+#include "../../base_station_base.h"
+
+#include "yapf_regions.hpp"
+#include "yapf_rail_regions.h"
+#include "../rail_regions.h"
+
+#include "../../safeguards.h"
+
+struct CYapfRailRegion : CYapfT<CYapfRegion_TypesT<CYapfRailRegion, CRegionNodeList, Train>>
+{
+	explicit CYapfRailRegion(int max_nodes) { m_max_search_nodes = max_nodes; }
+
+	inline char TransportTypeChar() const { return '%'; }
+
+	inline void VisitPatchNeighbors(const TileRegionPatchDesc &rail_region_patch, const TVisitTileRegionPatchCallBack &func)
+	{
+		VisitRailRegionPatchNeighbors(rail_region_patch, func);
+	}
+};
+
+/**
+ * Finds a path at the rail region level from the given tile to the destination of the vehicle.
+ * The connectivity of the rail regions does not take signals, track connections within a tile
+ * and rail types into account, so the returned path is only a hint; a train may not actually be able to follow it.
+ * @param v The train to find a path for.
+ * @param start_tile The tile to start searching from.
+ * @returns The rail regions along the path in order, starting with the region of \a start_tile,
+ *          or an empty vector if no path was found or a path would not restrict anything.
+ */
+std::vector<TileRegionDesc> YapfTrainFindRailRegionPath(const Train *v, TileIndex start_tile)
+{
+	const TileRegionPatchDesc start_rail_region_patch = GetRailRegionPatchInfo(start_tile);
+	if (start_rail_region_patch.label == INVALID_TILE_REGION_PATCH) return {};
+
+	CYapfRailRegion pf(GetRegionPatchSearchMaxNodes());
+	pf.SetDestination(start_rail_region_patch);
+
+	if (v->current_order.IsType(OT_GOTO_STATION) || v->current_order.IsType(OT_GOTO_WAYPOINT)) {
+		const BaseStation *st = BaseStation::GetIfValid(v->current_order.GetDestination());
+		if (st == nullptr) return {};
+		for (const TileIndex tile : st->train_station) {
+			if (st->TileBelongsToRailStation(tile)) pf.AddOrigin(GetRailRegionPatchInfo(tile));
+		}
+	} else {
+		pf.AddOrigin(GetRailRegionPatchInfo(v->dest_tile));
+	}
+	if (pf.GetOrigins().empty()) return {};
+
+	/* If origin and destination are the same there is nothing to restrict. */
+	if (pf.HasOrigin(start_rail_region_patch)) return {};
+
+	/* Find best path. */
+	if (!pf.FindPath(v)) return {}; // Path not found.
+
+	return GetRegionPath(pf.GetBestNode());
+}
@@ -0,0 +1,283 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file yapf_regions.hpp YAPF modules for searching paths through the patches of water, road or rail regions. */
+
+#ifndef YAPF_REGIONS_HPP
+#define YAPF_REGIONS_HPP
+
+#include "yapf.hpp"
+#include "../tile_regions.h"
+
+constexpr int DIRECT_NEIGHBOR_COST = 100;
+constexpr int NODES_PER_REGION = 4;
+constexpr int MAX_NUMBER_OF_NODES = 65536;
+
+/**
+ * Get the maximum number of nodes of a search through the region patches.
+ * We reserve 4 nodes (patches) per region. The vast majority of regions have 1 or 2 patches so this should be a pretty
+ * safe limit. We cap the limit at 65536 which is at a region size of 16x16 is equivalent to one node per region for a 4096x4096 map.
+ * @return The maximum number of nodes.
+ */
+inline int GetRegionPatchSearchMaxNodes()
+{
+	return std::min(static_cast<int>(Map::Size() * NODES_PER_REGION) / TILE_REGION_NUMBER_OF_TILES, MAX_NUMBER_OF_NODES);
+}
+
+/** Yapf Node Key that represents a single patch of interconnected tiles within a region. */
+struct CYapfRegionPatchNodeKey {
+	TileRegionPatchDesc m_region_patch;
+
+	inline void Set(const TileRegionPatchDesc &region_patch)
+	{
+		m_region_patch = region_patch;
+	}
+
+	inline int CalcHash() const { return CalculateTileRegionPatchHash(m_region_patch); }
+	inline bool operator==(const CYapfRegionPatchNodeKey &other) const { return CalcHash() == other.CalcHash(); }
+};
+
+inline uint ManhattanDistance(const CYapfRegionPatchNodeKey &a, const CYapfRegionPatchNodeKey &b)
+{
+	return (std::abs(a.m_region_patch.x - b.m_region_patch.x) + std::abs(a.m_region_patch.y - b.m_region_patch.y)) * DIRECT_NEIGHBOR_COST;
+}
+
+/** Yapf Node for regions. */
+template <class Tkey_>
+struct CYapfRegionNodeT {
+	typedef Tkey_ Key;
+	typedef CYapfRegionNodeT<Tkey_> Node;
+
+	Tkey_       m_key;
+	Node       *m_hash_next;
+	Node       *m_parent;
+	int         m_cost;
+	int         m_estimate;
+
+	inline void Set(Node *parent, const TileRegionPatchDesc &region_patch)
+	{
+		m_key.Set(region_patch);
+		m_hash_next = nullptr;
+		m_parent = parent;
+		m_cost = 0;
+		m_estimate = 0;
+	}
+
+	inline void Set(Node *parent, const Key &key)
+	{
+		Set(parent, key.m_region_patch);
+	}
+
+	DiagDirection GetDiagDirFromParent() const
+	{
+		if (!m_parent) return INVALID_DIAGDIR;
+		const int dx = m_key.m_region_patch.x - m_parent->m_key.m_region_patch.x;
+		const int dy = m_key.m_region_patch.y - m_parent->m_key.m_region_patch.y;
+		if (dx > 0 && dy == 0) return DIAGDIR_SW;
+		if (dx < 0 && dy == 0) return DIAGDIR_NE;
+		if (dx == 0 && dy > 0) return DIAGDIR_SE;
+		if (dx == 0 && dy < 0) return DIAGDIR_NW;
+		return INVALID_DIAGDIR;
+	}
+
+	inline Node *GetHashNext() { return m_hash_next; }
+	inline void SetHashNext(Node *pNext) { m_hash_next = pNext; }
+	inline const Tkey_ &GetKey() const { return m_key; }
+	inline int GetCost() { return m_cost; }
+	inline int GetCostEstimate() { return m_estimate; }
+	inline bool operator<(const Node &other) const { return m_estimate < other.m_estimate; }
+};
+
+/** YAPF origin for regions. */
+template <class Types>
+class CYapfOriginRegionT
+{
+public:
+	typedef typename Types::Tpf Tpf;              ///< The pathfinder class (derived from THIS class).
+	typedef typename Types::NodeList::Titem Node; ///< This will be our node type.
+	typedef typename Node::Key Key;               ///< Key to hash tables.
+
+protected:
+	inline Tpf &Yapf() { return *static_cast<Tpf*>(this); }
+
+private:
+	std::vector<CYapfRegionPatchNodeKey> m_origin_keys;
+
+public:
+	void AddOrigin(const TileRegionPatchDesc &region_patch)
+	{
+		if (region_patch.label == INVALID_TILE_REGION_PATCH) return;
+		if (!HasOrigin(region_patch)) m_origin_keys.push_back(CYapfRegionPatchNodeKey{ region_patch });
+	}
+
+	bool HasOrigin(const TileRegionPatchDesc &region_patch)
+	{
+		return std::find(m_origin_keys.begin(), m_origin_keys.end(), CYapfRegionPatchNodeKey{ region_patch }) != m_origin_keys.end();
+	}
+
+	const std::vector<CYapfRegionPatchNodeKey> &GetOrigins() const
+	{
+		return m_origin_keys;
+	}
+
+	void PfSetStartupNodes()
+	{
+		for (const CYapfRegionPatchNodeKey &origin_key : m_origin_keys) {
+			Node &node = Yapf().CreateNewNode();
+			node.Set(nullptr, origin_key);
+			Yapf().AddStartupNode(node);
+		}
+	}
+};
+
+/** YAPF destination provider for regions. */
+template <class Types>
+class CYapfDestinationRegionT
+{
+public:
+	typedef typename Types::Tpf Tpf;              ///< The pathfinder class (derived from THIS class).
+	typedef typename Types::NodeList::Titem Node; ///< This will be our node type.
+	typedef typename Node::Key Key;               ///< Key to hash tables.
+
+protected:
+	Key m_dest;
+
+public:
+	void SetDestination(const TileRegionPatchDesc &region_patch)
+	{
+		m_dest.Set(region_patch);
+	}
+
+protected:
+	Tpf &Yapf() { return *static_cast<Tpf*>(this); }
+
+public:
+	inline bool PfDetectDestination(Node &n) const
+	{
+		return n.m_key == m_dest;
+	}
+
+	inline bool PfCalcEstimate(Node &n)
+	{
+		if (PfDetectDestination(n)) {
+			n.m_estimate = n.m_cost;
+			return true;
+		}
+
+		n.m_estimate = n.m_cost + ManhattanDistance(n.m_key, m_dest);
+
+		return true;
+	}
+};
+
+/**
+ * YAPF node following for region pathfinding.
+ * The pathfinder class provides the neighbours of a patch with `VisitPatchNeighbors(const TileRegionPatchDesc &, Tfunc &&)`.
+ */
+template <class Types>
+class CYapfFollowRegionT
+{
+public:
+	typedef typename Types::Tpf Tpf;                     ///< The pathfinder class (derived from THIS class).
+	typedef typename Types::TrackFollower TrackFollower;
+	typedef typename Types::NodeList::Titem Node;        ///< This will be our node type.
+	typedef typename Node::Key Key;                      ///< Key to hash tables.
+
+protected:
+	inline Tpf &Yapf() { return *static_cast<Tpf*>(this); }
+
+public:
+	inline void PfFollowNode(Node &old_node)
+	{
+		auto visitFunc = [&](const TileRegionPatchDesc &region_patch)
+		{
+			Node &node = Yapf().CreateNewNode();
+			node.Set(&old_node, region_patch);
+			Yapf().AddNewNode(node, TrackFollower{});
+		};
+		Yapf().VisitPatchNeighbors(old_node.m_key.m_region_patch, visitFunc);
+	}
+};
+
+/** Cost Provider of YAPF for regions. */
+template <class Types>
+class CYapfCostRegionT
+{
+public:
+	typedef typename Types::Tpf Tpf;              ///< The pathfinder class (derived from THIS class).
+	typedef typename Types::TrackFollower TrackFollower;
+	typedef typename Types::NodeList::Titem Node; ///< This will be our node type.
+	typedef typename Node::Key Key;               ///< Key to hash tables.
+
+protected:
+	/** To access inherited path finder. */
+	Tpf &Yapf() { return *static_cast<Tpf*>(this); }
+
+public:
+	/**
+	 * Called by YAPF to calculate the cost from the origin to the given node.
+	 * Calculates only the cost of given node, adds it to the parent node cost
+	 * and stores the result into Node::m_cost member.
+	 */
+	inline bool PfCalcCost(Node &n, const TrackFollower *)
+	{
+		n.m_cost = n.m_parent->m_cost + ManhattanDistance(n.m_key, n.m_parent->m_key);
+
+		/* Incentivise zigzagging by adding a slight penalty when the search continues in the same direction. */
+		Node *grandparent = n.m_parent->m_parent;
+		if (grandparent != nullptr) {
+			const DiagDirDiff dir_diff = DiagDirDifference(n.m_parent->GetDiagDirFromParent(), n.GetDiagDirFromParent());
+			if (dir_diff != DIAGDIRDIFF_90LEFT && dir_diff != DIAGDIRDIFF_90RIGHT) n.m_cost += 1;
+		}
+
+		return true;
+	}
+};
+
+/* We don't need a follower but YAPF requires one. */
+struct DummyFollower : public CFollowTrackWater {};
+
+/**
+ * Config struct of YAPF for route planning through region patches.
+ * Defines all 6 base YAPF modules as classes providing services for CYapfBaseT.
+ */
+template <class Tpf_, class Tnode_list, class Tvehicle>
+struct CYapfRegion_TypesT
+{
+	typedef CYapfRegion_TypesT<Tpf_, Tnode_list, Tvehicle> Types; ///< Shortcut for this struct type.
+	typedef Tpf_                                 Tpf;           ///< Pathfinder type.
+	typedef DummyFollower                        TrackFollower; ///< Track follower helper class
+	typedef Tnode_list                           NodeList;
+	typedef Tvehicle                             VehicleType;
+
+	/** Pathfinder components (modules). */
+	typedef CYapfBaseT<Types>                 PfBase;        ///< Base pathfinder class.
+	typedef CYapfFollowRegionT<Types>         PfFollow;      ///< Node follower.
+	typedef CYapfOriginRegionT<Types>         PfOrigin;      ///< Origin provider.
+	typedef CYapfDestinationRegionT<Types>    PfDestination; ///< Destination/distance provider.
+	typedef CYapfSegmentCostCacheNoneT<Types> PfCache;       ///< Segment cost cache provider.
+	typedef CYapfCostRegionT<Types>           PfCost;        ///< Cost provider.
+};
+
+typedef CNodeList_PooledHeapT<CYapfRegionNodeT<CYapfRegionPatchNodeKey>, 12, 12> CRegionNodeList;
+
+/**
+ * Collects the regions along the best path that was found.
+ * @param best_node The best node of the search.
+ * @returns The regions along the path, starting with the region of \a best_node.
+ */
+template <class Node>
+std::vector<TileRegionDesc> GetRegionPath(const Node *best_node)
+{
+	std::vector<TileRegionDesc> path;
+	for (const Node *node = best_node; node != nullptr; node = node->m_parent) {
+		path.emplace_back(node->m_key.m_region_patch);
+	}
+	return path;
+}
+
+#endif /* YAPF_REGIONS_HPP */
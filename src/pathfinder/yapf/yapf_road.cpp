@@ -10,7 +10,11 @@
 #include "../../stdafx.h"
 #include "yapf.hpp"
 #include "yapf_node_road.hpp"
+#include "yapf_road_regions.h"
+#include "../road_regions.h"
 #include "../../roadstop_base.h"
+#include "../../trace.h"
+#include "../../framerate_type.h"
 
 #include "../../safeguards.h"
 
@@ -324,6 +328,8 @@ public:
 	typedef typename Node::Key Key;                      ///< key to hash tables
 
 protected:
+	TileRegionCorridor m_region_corridor; ///< The road regions the search is restricted to.
+
 	/** to access inherited path finder */
 	inline Tpf &Yapf()
 	{
@@ -341,10 +347,20 @@ public:
 	{
 		TrackFollower F(Yapf().GetVehicle());
 		if (F.Follow(old_node.m_segment_last_tile, old_node.m_segment_last_td)) {
+			if (!m_region_corridor.Contains(F.m_new_tile)) return;
 			Yapf().AddMultipleNodes(&old_node, F);
 		}
 	}
 
+	/**
+	 * Restricts the search to the road regions along the given path, and the regions directly next to them.
+	 * @param path The road regions the vehicle should follow.
+	 */
+	inline void RestrictSearch(const std::vector<TileRegionDesc> &path)
+	{
+		m_region_corridor.Restrict(path);
+	}
+
 	/** return debug report character to identify the transportation type */
 	inline char TransportTypeChar() const
 	{
@@ -353,6 +369,20 @@ public:
 
 	static Trackdir stChooseRoadTrack(const RoadVehicle *v, TileIndex tile, DiagDirection enterdir, bool &path_found, RoadVehPathCache &path_cache)
 	{
+		/* For long routes first find a path through the road regions, and only search along that path.
+		 * The road regions ignore one-way roads and road types, so when nothing is found that way we
+		 * fall back to searching everywhere. */
+		if (DistanceManhattan(tile, v->dest_tile) >= YAPF_ROADVEH_REGION_SEARCH_MIN_DISTANCE) {
+			const std::vector<TileRegionDesc> high_level_path = YapfRoadVehicleFindRoadRegionPath(v, tile);
+			if (!high_level_path.empty()) {
+				Tpf pf;
+				pf.RestrictSearch(high_level_path);
+				Trackdir trackdir = pf.ChooseRoadTrack(v, tile, enterdir, path_found, path_cache);
+				if (path_found) return trackdir;
+				path_cache.clear();
+			}
+		}
+
 		Tpf pf;
 		return pf.ChooseRoadTrack(v, tile, enterdir, path_found, path_cache);
 	}
@@ -525,6 +555,9 @@ struct CYapfRoadAnyDepot2 : CYapfT<CYapfRoad_TypesT<CYapfRoadAnyDepot2, CRoadNod
 
 Trackdir YapfRoadVehicleChooseTrack(const RoadVehicle *v, TileIndex tile, DiagDirection enterdir, TrackdirBits trackdirs, bool &path_found, RoadVehPathCache &path_cache)
 {
+	TraceScope trace("Road vehicle pathfinder", v->index);
+	CompanyPerformanceMeasurer company_framerate(CPE_PATHFINDER, v->owner);
+
 	/* default is YAPF type 2 */
 	typedef Trackdir (*PfnChooseRoadTrack)(const RoadVehicle*, TileIndex, DiagDirection, bool &path_found, RoadVehPathCache &path_cache);
 	PfnChooseRoadTrack pfnChooseRoadTrack = &CYapfRoad2::stChooseRoadTrack; // default: ExitDir, allow 90-deg
@@ -540,6 +573,9 @@ Trackdir YapfRoadVehicleChooseTrack(const RoadVehicle *v, TileIndex tile, DiagDi
 
 FindDepotData YapfRoadVehicleFindNearestDepot(const RoadVehicle *v, int max_distance)
 {
+	TraceScope trace("Road vehicle depot pathfinder", v->index);
+	CompanyPerformanceMeasurer company_framerate(CPE_PATHFINDER, v->owner);
+
 	TileIndex tile = v->tile;
 	Trackdir trackdir = v->GetVehicleTrackdir();
 
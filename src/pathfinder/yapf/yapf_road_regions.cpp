@@ -0,0 +1,71 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file yapf_road_regions.cpp Implementation of YAPF for road regions, which are used for restricting long road vehicle searches. */
+
+#include "../../stdafx.h"
+#include "../../roadveh.h"
+#include "../../station_base.h"
+#include "../../station_map.h"
+
+#include "yapf_regions.hpp"
+#include "yapf_road_regions.h"
+#include "../road_regions.h"
+
+#include "../../safeguards.h"
+
+struct CYapfRoadRegion : CYapfT<CYapfRegion_TypesT<CYapfRoadRegion, CRegionNodeList, RoadVehicle>>
+{
+	RoadTramType m_rtt; ///< Whether we search the road or the tram network.
+
+	CYapfRoadRegion(int max_nodes, RoadTramType rtt) : m_rtt(rtt) { m_max_search_nodes = max_nodes; }
+
+	inline char TransportTypeChar() const { return '%'; }
+
+	inline void VisitPatchNeighbors(const TileRegionPatchDesc &road_region_patch, const TVisitTileRegionPatchCallBack &func)
+	{
+		VisitRoadRegionPatchNeighbors(road_region_patch, m_rtt, func);
+	}
+};
+
+/**
+ * Finds a path at the road region level from the given tile to the destination of the vehicle.
+ * The connectivity of the road regions does not take one-way roads and road types into account,
+ * so the returned path is only a hint; a vehicle may not actually be able to follow it.
+ * @param v The road vehicle to find a path for.
+ * @param start_tile The tile to start searching from.
+ * @returns The road regions along the path in order, starting with the region of \a start_tile,
+ *          or an empty vector if no path was found or a path would not restrict anything.
+ */
+std::vector<TileRegionDesc> YapfRoadVehicleFindRoadRegionPath(const RoadVehicle *v, TileIndex start_tile)
+{
+	const RoadTramType rtt = GetRoadTramType(v->roadtype);
+	const TileRegionPatchDesc start_road_region_patch = GetRoadRegionPatchInfo(start_tile, rtt);
+	if (start_road_region_patch.label == INVALID_TILE_REGION_PATCH) return {};
+
+	CYapfRoadRegion pf(GetRegionPatchSearchMaxNodes(), rtt);
+	pf.SetDestination(start_road_region_patch);
+
+	if (v->current_order.IsType(OT_GOTO_STATION)) {
+		const Station *st = Station::GetIfValid(v->current_order.GetDestination());
+		if (st == nullptr) return {};
+		for (const TileIndex tile : v->IsBus() ? st->bus_station : st->truck_station) {
+			if (IsRoadStopTile(tile) && GetStationIndex(tile) == st->index) pf.AddOrigin(GetRoadRegionPatchInfo(tile, rtt));
+		}
+	} else {
+		pf.AddOrigin(GetRoadRegionPatchInfo(v->dest_tile, rtt));
+	}
+	if (pf.GetOrigins().empty()) return {};
+
+	/* If origin and destination are the same there is nothing to restrict. */
+	if (pf.HasOrigin(start_road_region_patch)) return {};
+
+	/* Find best path. */
+	if (!pf.FindPath(v)) return {}; // Path not found.
+
+	return GetRegionPath(pf.GetBestNode());
+}
@@ -0,0 +1,21 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file yapf_road_regions.h Implementation of YAPF for road regions, which are used for restricting long road vehicle searches. */
+
+#ifndef YAPF_ROAD_REGIONS_H
+#define YAPF_ROAD_REGIONS_H
+
+#include "../../stdafx.h"
+#include "../../tile_type.h"
+#include "../road_regions.h"
+
+struct RoadVehicle;
+
+std::vector<TileRegionDesc> YapfRoadVehicleFindRoadRegionPath(const RoadVehicle *v, TileIndex start_tile);
+
+#endif /* YAPF_ROAD_REGIONS_H */
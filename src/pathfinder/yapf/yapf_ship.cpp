@@ -16,6 +16,8 @@
 #include "yapf_node_ship.hpp"
 #include "yapf_ship_regions.h"
 #include "../water_regions.h"
+#include "../../trace.h"
+#include "../../framerate_type.h"
 
 #include "../../safeguards.h"
 
@@ -204,7 +206,17 @@ public:
 		return result;
 	}
 
-	static Trackdir ChooseShipTrack(const Ship *v, TileIndex tile, bool &path_found, ShipPathCache &path_cache)
+	/**
+	 * Find the track a ship should take.
+	 * @param v The ship.
+	 * @param tile The tile the ship is about to enter.
+	 * @param[out] path_found Whether a path to the destination was found.
+	 * @param[out] path_cache The rest of the path after the returned trackdir.
+	 * @param allow_random Whether a random trackdir may be chosen when no proper path exists. When false,
+	 *                     INVALID_TRACKDIR is returned instead, so the search does not touch the random state.
+	 * @return The trackdir to take on \a tile, or INVALID_TRACKDIR when the ship should reverse.
+	 */
+	static Trackdir ChooseShipTrack(const Ship *v, TileIndex tile, bool &path_found, ShipPathCache &path_cache, bool allow_random = true)
 	{
 		const Trackdir trackdir = v->GetVehicleTrackdir();
 		assert(IsValidTrackdir(trackdir));
@@ -215,6 +227,7 @@ public:
 		const std::vector<WaterRegionPatchDesc> high_level_path = YapfShipFindWaterRegionPath(v, tile, NUMBER_OR_WATER_REGIONS_LOOKAHEAD + 1);
 		if (high_level_path.empty()) {
 			path_found = false;
+			if (!allow_random) return INVALID_TRACKDIR;
 			/* Make the ship move around aimlessly. This prevents repeated pathfinder calls and clearly indicates that the ship is lost. */
 			return CreateRandomPath(v, trackdir, path_cache, SHIP_LOST_PATH_LENGTH);
 		}
@@ -239,6 +252,10 @@ public:
 			path_found = pf.FindPath(v);
 			Node *node = pf.GetBestNode();
 			if (attempt == 0 && !path_found) continue; // Try again with restricted search area.
+			if (!allow_random && (!path_found || node == nullptr)) {
+				path_found = false;
+				return INVALID_TRACKDIR;
+			}
 			if (!path_found || node == nullptr) return GetRandomFollowUpTileTrackdir(v, v->tile, trackdir).second;
 
 			/* Return only the path within the current water region if an intermediate destination was returned. If not, cache the entire path
@@ -265,7 +282,13 @@ public:
 
 			/* A empty path means we are already at the destination. The pathfinder shouldn't have been called at all.
 			 * Return a random reachable trackdir to hopefully nudge the ship out of this strange situation. */
-			if (path_cache.empty()) return GetRandomFollowUpTileTrackdir(v, v->tile, trackdir).second;
+			if (path_cache.empty()) {
+				if (!allow_random) {
+					path_found = false;
+					return INVALID_TRACKDIR;
+				}
+				return GetRandomFollowUpTileTrackdir(v, v->tile, trackdir).second;
+			}
 
 			/* Take out the last trackdir as the result. */
 			const Trackdir result = path_cache.front();
@@ -437,10 +460,35 @@ struct CYapfShip : CYapfT<CYapfShip_TypesT<CYapfShip, CFollowTrackWater, CShipNo
 /** Ship controller helper - path finder invoker. */
 Track YapfShipChooseTrack(const Ship *v, TileIndex tile, bool &path_found, ShipPathCache &path_cache)
 {
+	TraceScope trace("Ship pathfinder", v->index);
+	CompanyPerformanceMeasurer company_framerate(CPE_PATHFINDER, v->owner);
+
 	Trackdir td_ret = CYapfShip::ChooseShipTrack(v, tile, path_found, path_cache);
 	return (td_ret != INVALID_TRACKDIR) ? TrackdirToTrack(td_ret) : INVALID_TRACK;
 }
 
+/**
+ * Find the path a ship should take after it leaves its current tile, without making any random choices.
+ * Only the map and the vehicles are read, so different ships can be handled by different threads.
+ * @param v The ship; it must be on a normal water track.
+ * @param[out] path_cache The path, starting with the trackdir to take on the next tile.
+ * @return True if a path to the destination was found and stored in \a path_cache.
+ */
+bool YapfShipFindPathAhead(const Ship *v, ShipPathCache &path_cache)
+{
+	const TileIndex tile = TileAddByDiagDir(v->tile, TrackdirToExitdir(v->GetVehicleTrackdir()));
+	if (!IsValidTile(tile)) return false;
+
+	bool path_found = false;
+	const Trackdir td_ret = CYapfShip::ChooseShipTrack(v, tile, path_found, path_cache, false);
+	if (!path_found || td_ret == INVALID_TRACKDIR) {
+		path_cache.clear();
+		return false;
+	}
+	path_cache.push_front(td_ret);
+	return true;
+}
+
 bool YapfShipCheckReverse(const Ship *v, Trackdir *trackdir)
 {
 	Trackdir td = v->GetVehicleTrackdir();
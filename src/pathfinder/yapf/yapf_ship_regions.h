@@ -17,5 +17,6 @@
 struct Ship;
 
 std::vector<WaterRegionPatchDesc> YapfShipFindWaterRegionPath(const Ship *v, TileIndex start_tile, int max_returned_path_length);
+void InvalidateWaterRegionPathCache();
 
 #endif /* YAPF_SHIP_REGIONS_H */
@@ -0,0 +1,84 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_stats.cpp Statistics of the searches of YAPF, to find the track layouts that make it slow. */
+
+#include "../../stdafx.h"
+#include "yapf_stats.h"
+
+#include <mutex>
+
+#include "../../safeguards.h"
+
+/* Ship paths are searched from worker threads too, so all access is locked. */
+static std::mutex _yapf_stats_mutex; ///< Lock for the statistics.
+static std::array<YapfSearchStats, YAPF_STATS_TYPES> _yapf_stats; ///< Totals per transport type.
+static std::vector<YapfSlowSearch> _yapf_slow_searches; ///< The slowest searches, slowest first.
+
+/**
+ * Add a finished search to the statistics.
+ * @param type Transport type of the search.
+ * @param vehicle The vehicle searched for, or #INVALID_VEHICLE.
+ * @param origin Where the vehicle was.
+ * @param destination Where the vehicle wanted to go.
+ * @param nodes Number of nodes expanded.
+ * @param cache_hits Number of node costs taken from the cache.
+ * @param cache_misses Number of node costs that had to be calculated.
+ * @param duration Duration of the search.
+ */
+void YapfRecordSearch(VehicleType type, VehicleID vehicle, TileIndex origin, TileIndex destination, uint nodes, uint cache_hits, uint cache_misses, std::chrono::steady_clock::duration duration)
+{
+	assert(type < YAPF_STATS_TYPES);
+	uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+
+	std::lock_guard<std::mutex> lock(_yapf_stats_mutex);
+
+	YapfSearchStats &stats = _yapf_stats[type];
+	stats.searches++;
+	stats.nodes += nodes;
+	stats.cache_hits += cache_hits;
+	stats.cache_misses += cache_misses;
+	stats.total_us += us;
+	stats.max_us = std::max(stats.max_us, us);
+
+	if (_yapf_slow_searches.size() == YAPF_SLOW_SEARCHES) {
+		if (us <= _yapf_slow_searches.back().us) return;
+		_yapf_slow_searches.pop_back();
+	}
+	auto it = std::upper_bound(_yapf_slow_searches.begin(), _yapf_slow_searches.end(), us, [](uint64_t us, const YapfSlowSearch &search) { return us > search.us; });
+	_yapf_slow_searches.insert(it, { type, vehicle, origin, destination, nodes, us });
+}
+
+/**
+ * Get the totals of the searches since the start or the last reset.
+ * @param type Transport type to get the totals of.
+ * @return The totals.
+ */
+YapfSearchStats GetYapfSearchStats(VehicleType type)
+{
+	assert(type < YAPF_STATS_TYPES);
+	std::lock_guard<std::mutex> lock(_yapf_stats_mutex);
+	return _yapf_stats[type];
+}
+
+/**
+ * Get the slowest searches since the start or the last reset.
+ * @return At most #YAPF_SLOW_SEARCHES searches, slowest first.
+ */
+std::vector<YapfSlowSearch> GetYapfSlowSearches()
+{
+	std::lock_guard<std::mutex> lock(_yapf_stats_mutex);
+	return _yapf_slow_searches;
+}
+
+/** Forget all recorded searches. */
+void ResetYapfSearchStats()
+{
+	std::lock_guard<std::mutex> lock(_yapf_stats_mutex);
+	_yapf_stats = {};
+	_yapf_slow_searches.clear();
+}
@@ -0,0 +1,52 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_stats.h Statistics of the searches of YAPF, to find the track layouts that make it slow. */
+
+#ifndef YAPF_STATS_H
+#define YAPF_STATS_H
+
+#include "../../tile_type.h"
+#include "../../vehicle_type.h"
+
+#include <chrono>
+
+/** Number of transport types YAPF searches for: trains, road vehicles and ships. */
+static const uint YAPF_STATS_TYPES = VEH_SHIP + 1;
+
+/** Minimum level of the yapf debug output at which the searches are recorded; recording them takes time too. */
+static const int YAPF_STATS_DEBUG_LEVEL = 1;
+
+/** Number of slowest searches that are remembered. */
+static const uint YAPF_SLOW_SEARCHES = 16;
+
+/** Totals of the searches for one transport type. */
+struct YapfSearchStats {
+	uint64_t searches = 0;     ///< Number of searches.
+	uint64_t nodes = 0;        ///< Number of nodes expanded.
+	uint64_t cache_hits = 0;   ///< Number of node costs taken from the segment cost cache.
+	uint64_t cache_misses = 0; ///< Number of node costs that had to be calculated.
+	uint64_t total_us = 0;     ///< Time spent searching, in microseconds.
+	uint64_t max_us = 0;       ///< Time of the slowest search, in microseconds.
+};
+
+/** A search that took long. */
+struct YapfSlowSearch {
+	VehicleType type;      ///< Transport type of the search.
+	VehicleID vehicle;     ///< The vehicle searched for.
+	TileIndex origin;      ///< Where the vehicle was.
+	TileIndex destination; ///< Where the vehicle wanted to go.
+	uint nodes;            ///< Number of nodes expanded.
+	uint64_t us;           ///< Duration of the search, in microseconds.
+};
+
+void YapfRecordSearch(VehicleType type, VehicleID vehicle, TileIndex origin, TileIndex destination, uint nodes, uint cache_hits, uint cache_misses, std::chrono::steady_clock::duration duration);
+YapfSearchStats GetYapfSearchStats(VehicleType type);
+std::vector<YapfSlowSearch> GetYapfSlowSearches();
+void ResetYapfSearchStats();
+
+#endif /* YAPF_STATS_H */
@@ -15,6 +15,12 @@
 
 #include "safeguards.h"
 
+/**
+ * Counter that is increased whenever a track reservation on the map, or the map itself by a command, changes.
+ * As long as it does not change, following a reservation from the same track gives the same result.
+ */
+uint64_t _track_reservation_generation = 1;
+
 /**
  * Get the reserved trackbits for any tile, regardless of type.
  * @param t the tile
@@ -259,23 +265,26 @@ struct FindTrainOnTrackInfo {
 	FindTrainOnTrackInfo() : best(nullptr) {}
 };
 
-/** Callback for Has/FindVehicleOnPos to find a train on a specific track. */
-static Vehicle *FindTrainOnTrackEnum(Vehicle *v, void *data)
+/**
+ * Find the train with the lowest index on the track of a reservation end.
+ * @param tile The tile to look at.
+ * @param ftoti The reservation end; the best train is stored into it.
+ */
+static void FindTrainOnTrack(TileIndex tile, FindTrainOnTrackInfo &ftoti)
 {
-	FindTrainOnTrackInfo *info = (FindTrainOnTrackInfo *)data;
+	if (!MayHaveTrainOnTile(tile)) return;
 
-	if (v->type != VEH_TRAIN || (v->vehstatus & VS_CRASHED)) return nullptr;
+	FindVehicleOnPos(tile, [&ftoti](Vehicle *v) {
+		if (v->type != VEH_TRAIN || (v->vehstatus & VS_CRASHED)) return;
 
-	Train *t = Train::From(v);
-	if (t->track == TRACK_BIT_WORMHOLE || HasBit((TrackBits)t->track, TrackdirToTrack(info->res.trackdir))) {
-		t = t->First();
+		Train *t = Train::From(v);
+		if (t->track == TRACK_BIT_WORMHOLE || HasBit((TrackBits)t->track, TrackdirToTrack(ftoti.res.trackdir))) {
+			t = t->First();
 
-		/* ALWAYS return the lowest ID (anti-desync!) */
-		if (info->best == nullptr || t->index < info->best->index) info->best = t;
-		return t;
-	}
-
-	return nullptr;
+			/* ALWAYS return the lowest ID (anti-desync!) */
+			if (ftoti.best == nullptr || t->index < ftoti.best->index) ftoti.best = t;
+		}
+	});
 }
 
 /**
@@ -295,10 +304,17 @@ PBSTileInfo FollowTrainReservation(const Train *v, Vehicle **train_on_res)
 	if (IsRailDepotTile(tile) && !GetDepotReservationTrackBits(tile)) return PBSTileInfo(tile, trackdir, false);
 
 	FindTrainOnTrackInfo ftoti;
-	ftoti.res = FollowReservation(v->owner, GetRailTypeInfo(v->railtype)->compatible_railtypes, tile, trackdir);
+	RailTypes rts = GetRailTypeInfo(v->railtype)->compatible_railtypes;
+	TrainReservationEndCache &cache = v->reservation_end_cache;
+	if (cache.generation == _track_reservation_generation && cache.start_tile == tile && cache.start_trackdir == trackdir && cache.railtypes == rts) {
+		ftoti.res = PBSTileInfo(cache.end_tile, cache.end_trackdir, false);
+	} else {
+		ftoti.res = FollowReservation(v->owner, rts, tile, trackdir);
+		cache = { _track_reservation_generation, tile, trackdir, rts, ftoti.res.tile, ftoti.res.trackdir };
+	}
 	ftoti.res.okay = IsSafeWaitingPosition(v, ftoti.res.tile, ftoti.res.trackdir, true, _settings_game.pf.forbid_90_deg);
 	if (train_on_res != nullptr) {
-		FindVehicleOnPos(ftoti.res.tile, &ftoti, FindTrainOnTrackEnum);
+		FindTrainOnTrack(ftoti.res.tile, ftoti);
 		if (ftoti.best != nullptr) *train_on_res = ftoti.best->First();
 		if (*train_on_res == nullptr && IsRailStationTile(ftoti.res.tile)) {
 			/* The target tile is a rail station. The track follower
@@ -307,13 +323,13 @@ PBSTileInfo FollowTrainReservation(const Train *v, Vehicle **train_on_res)
 			 * for a possible train. */
 			TileIndexDiff diff = TileOffsByDiagDir(TrackdirToExitdir(ReverseTrackdir(ftoti.res.trackdir)));
 			for (TileIndex st_tile = ftoti.res.tile + diff; *train_on_res == nullptr && IsCompatibleTrainStationTile(st_tile, ftoti.res.tile); st_tile += diff) {
-				FindVehicleOnPos(st_tile, &ftoti, FindTrainOnTrackEnum);
+				FindTrainOnTrack(st_tile, ftoti);
 				if (ftoti.best != nullptr) *train_on_res = ftoti.best->First();
 			}
 		}
 		if (*train_on_res == nullptr && IsTileType(ftoti.res.tile, MP_TUNNELBRIDGE)) {
 			/* The target tile is a bridge/tunnel, also check the other end tile. */
-			FindVehicleOnPos(GetOtherTunnelBridgeEnd(ftoti.res.tile), &ftoti, FindTrainOnTrackEnum);
+			FindTrainOnTrack(GetOtherTunnelBridgeEnd(ftoti.res.tile), ftoti);
 			if (ftoti.best != nullptr) *train_on_res = ftoti.best->First();
 		}
 	}
@@ -345,21 +361,21 @@ Train *GetTrainForReservation(TileIndex tile, Track track)
 		FindTrainOnTrackInfo ftoti;
 		ftoti.res = FollowReservation(GetTileOwner(tile), rts, tile, trackdir, true);
 
-		FindVehicleOnPos(ftoti.res.tile, &ftoti, FindTrainOnTrackEnum);
+		FindTrainOnTrack(ftoti.res.tile, ftoti);
 		if (ftoti.best != nullptr) return ftoti.best;
 
 		/* Special case for stations: check the whole platform for a vehicle. */
 		if (IsRailStationTile(ftoti.res.tile)) {
 			TileIndexDiff diff = TileOffsByDiagDir(TrackdirToExitdir(ReverseTrackdir(ftoti.res.trackdir)));
 			for (TileIndex st_tile = ftoti.res.tile + diff; IsCompatibleTrainStationTile(st_tile, ftoti.res.tile); st_tile += diff) {
-				FindVehicleOnPos(st_tile, &ftoti, FindTrainOnTrackEnum);
+				FindTrainOnTrack(st_tile, ftoti);
 				if (ftoti.best != nullptr) return ftoti.best;
 			}
 		}
 
 		/* Special case for bridges/tunnels: check the other end as well. */
 		if (IsTileType(ftoti.res.tile, MP_TUNNELBRIDGE)) {
-			FindVehicleOnPos(GetOtherTunnelBridgeEnd(ftoti.res.tile), &ftoti, FindTrainOnTrackEnum);
+			FindTrainOnTrack(GetOtherTunnelBridgeEnd(ftoti.res.tile), ftoti);
 			if (ftoti.best != nullptr) return ftoti.best;
 		}
 	}
@@ -84,6 +84,7 @@ inline void SetHasSignals(Tile tile, bool signals)
 {
 	assert(IsPlainRailTile(tile));
 	SB(tile.m5(), 6, 1, signals);
+	InvalidateSignalBlocks();
 }
 
 /**
@@ -148,6 +149,8 @@ inline void SetTrackBits(Tile t, TrackBits b)
 {
 	assert(IsPlainRailTile(t));
 	SB(t.m5(), 0, 6, b);
+	InvalidateRailRegion(t);
+	InvalidateSignalBlocks();
 }
 
 /**
@@ -214,6 +217,7 @@ inline void SetTrackReservation(Tile t, TrackBits b)
 	Track track = RemoveFirstTrack(&b);
 	SB(t.m2(), 8, 3, track == INVALID_TRACK ? 0 : track + 1);
 	SB(t.m2(), 11, 1, (uint8_t)(b != TRACK_BIT_NONE));
+	_track_reservation_generation++;
 }
 
 /**
@@ -271,6 +275,7 @@ inline void SetDepotReservation(Tile t, bool b)
 {
 	assert(IsRailDepot(t));
 	SB(t.m5(), 4, 1, (uint8_t)b);
+	_track_reservation_generation++;
 }
 
 /**
@@ -303,6 +308,7 @@ inline void SetSignalType(Tile t, Track track, SignalType s)
 	uint8_t pos = (track == TRACK_LOWER || track == TRACK_RIGHT) ? 4 : 0;
 	SB(t.m2(), pos, 3, s);
 	if (track == INVALID_TRACK) SB(t.m2(), 4, 3, s);
+	InvalidateSignalBlocks();
 }
 
 inline bool IsPresignalEntry(Tile t, Track track)
@@ -383,6 +389,7 @@ inline SignalState GetSingleSignalState(Tile t, uint8_t signalbit)
 inline void SetPresentSignals(Tile tile, uint signals)
 {
 	SB(tile.m3(), 4, 4, signals);
+	InvalidateSignalBlocks();
 }
 
 /**
@@ -539,6 +546,7 @@ inline void SetRailDepotExitDirection(Tile tile, DiagDirection dir)
 {
 	assert(IsRailDepotTile(tile));
 	SB(tile.m5(), 0, 2, dir);
+	InvalidateSignalBlocks();
 }
 
 /**
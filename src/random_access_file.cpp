@@ -15,8 +15,32 @@
 #include "fileio_func.h"
 #include "string_func.h"
 
+#if defined(UNIX)
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <mutex>
+#endif
+
 #include "safeguards.h"
 
+#if defined(UNIX)
+/** A file mapped into memory. */
+struct FileMapping {
+	const uint8_t *data; ///< Begin of the mapping.
+	size_t size;         ///< Size of the mapping.
+
+	FileMapping(const uint8_t *data, size_t size) : data(data), size(size) {}
+	~FileMapping() { munmap(const_cast<uint8_t *>(this->data), this->size); }
+};
+
+/** Identification of a file on disk: device, inode, size and modification time. */
+using FileMappingKey = std::tuple<dev_t, ino_t, off_t, time_t>;
+
+static std::mutex _file_mappings_mutex; ///< Lock for #_file_mappings, files are opened on several threads.
+/** The files currently mapped into memory. All files read from one tar share the mapping of the tar. */
+static std::map<FileMappingKey, std::weak_ptr<const FileMapping>> _file_mappings;
+#endif
+
 /**
  * Create the RandomAccesFile.
  * @param filename Name of the file at the disk.
@@ -37,6 +61,7 @@ RandomAccessFile::RandomAccessFile(const std::string &filename, Subdirectory sub
 	this->simplified_filename = name_without_path.substr(0, name_without_path.rfind('.'));
 	strtolower(this->simplified_filename);
 
+	this->MapFile();
 	this->SeekTo((size_t)pos, SEEK_SET);
 }
 
@@ -48,6 +73,44 @@ RandomAccessFile::~RandomAccessFile()
 	fclose(this->file_handle);
 }
 
+/**
+ * Map the file into memory when possible, so reading is just copying from memory
+ * instead of a call into the C library, and a system call, for every few bytes.
+ * The whole file is mapped, also for files inside a tar, as the positions in the
+ * file are relative to the begin of the tar, and mappings must begin at a page.
+ * Readers of the same file on disk, like all NewGRFs in one tar, share one mapping.
+ */
+void RandomAccessFile::MapFile()
+{
+#if defined(UNIX)
+	int fd = fileno(this->file_handle);
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) return;
+	/* Do not use up the address space of 32 bits systems with huge archives. */
+	if (static_cast<uintmax_t>(st.st_size) > std::numeric_limits<size_t>::max() / 4) return;
+
+	std::lock_guard<std::mutex> lock(_file_mappings_mutex);
+	FileMappingKey key{ st.st_dev, st.st_ino, st.st_size, st.st_mtime };
+	this->mapping = _file_mappings[key].lock();
+	if (this->mapping == nullptr) {
+		void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map == MAP_FAILED) {
+			Debug(misc, 1, "Mapping {} into memory failed, reading it through a buffer", this->filename);
+			_file_mappings.erase(key);
+			return;
+		}
+
+		/* Forget about mappings that are not used anymore. */
+		std::erase_if(_file_mappings, [](const auto &it) { return it.second.expired(); });
+		this->mapping = std::make_shared<const FileMapping>(static_cast<const uint8_t *>(map), st.st_size);
+		_file_mappings[key] = this->mapping;
+	}
+
+	this->map = this->mapping->data;
+	this->map_size = this->mapping->size;
+#endif
+}
+
 /**
  * Get the filename of the opened file with the path from the SubDirectory and the extension.
  * @return Name of the file.
@@ -85,6 +148,14 @@ void RandomAccessFile::SeekTo(size_t pos, int mode)
 {
 	if (mode == SEEK_CUR) pos += this->GetPos();
 
+	if (this->map != nullptr) {
+		/* The mapping is one buffer with the whole file. */
+		this->pos = this->map_size;
+		this->buffer = this->map + std::min(pos, this->map_size);
+		this->buffer_end = this->map + this->map_size;
+		return;
+	}
+
 	this->pos = pos;
 	if (fseek(this->file_handle, this->pos, SEEK_SET) < 0) {
 		Debug(misc, 0, "Seeking in {} failed", this->filename);
@@ -95,19 +166,20 @@ void RandomAccessFile::SeekTo(size_t pos, int mode)
 }
 
 /**
- * Read a byte from the file.
- * @return Read byte.
+ * Read a byte from the file when the buffer is empty, refilling the buffer.
+ * @return Read byte, or 0 at the end of the file.
  */
-uint8_t RandomAccessFile::ReadByte()
+uint8_t RandomAccessFile::ReadByteFromFile()
 {
-	if (this->buffer == this->buffer_end) {
-		this->buffer = this->buffer_start;
-		size_t size = fread(this->buffer, 1, RandomAccessFile::BUFFER_SIZE, this->file_handle);
-		this->pos += size;
-		this->buffer_end = this->buffer_start + size;
+	/* The mapping has the whole file, so this is the end of the file. */
+	if (this->map != nullptr) return 0;
 
-		if (size == 0) return 0;
-	}
+	size_t size = fread(this->buffer_start, 1, RandomAccessFile::BUFFER_SIZE, this->file_handle);
+	this->pos += size;
+	this->buffer = this->buffer_start;
+	this->buffer_end = this->buffer_start + size;
+
+	if (size == 0) return 0;
 	return *this->buffer++;
 }
 
@@ -138,6 +210,15 @@ uint32_t RandomAccessFile::ReadDword()
  */
 void RandomAccessFile::ReadBlock(void *ptr, size_t size)
 {
+	size_t remaining = this->buffer_end - this->buffer;
+	if (size <= remaining || this->map != nullptr) {
+		/* Past the end of a mapping there is nothing to read. */
+		size = std::min(size, remaining);
+		memcpy(ptr, this->buffer, size);
+		this->buffer += size;
+		return;
+	}
+
 	this->SeekTo(this->GetPos(), SEEK_SET);
 	this->pos += fread(ptr, 1, size, this->file_handle);
 }
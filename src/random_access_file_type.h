@@ -29,10 +29,17 @@ class RandomAccessFile {
 	FILE *file_handle;               ///< File handle of the open file.
 	size_t pos;                      ///< Position in the file of the end of the read buffer.
 
-	uint8_t *buffer;                    ///< Current position within the local buffer.
-	uint8_t *buffer_end;                ///< Last valid byte of buffer.
+	const uint8_t *buffer;              ///< Current position within the local buffer, or within the mapping.
+	const uint8_t *buffer_end;          ///< Last valid byte of buffer.
 	uint8_t buffer_start[BUFFER_SIZE];  ///< Local buffer when read from file.
 
+	std::shared_ptr<const struct FileMapping> mapping; ///< The mapping of the file, shared with other readers of the same file.
+	const uint8_t *map = nullptr;    ///< The whole file mapped into memory, or nullptr when reading through the buffer.
+	size_t map_size = 0;             ///< Size of the mapping.
+
+	void MapFile();
+	uint8_t ReadByteFromFile();
+
 public:
 	RandomAccessFile(const std::string &filename, Subdirectory subdir);
 	RandomAccessFile(const RandomAccessFile&) = delete;
@@ -46,7 +53,16 @@ public:
 	size_t GetPos() const;
 	void SeekTo(size_t pos, int mode);
 
-	uint8_t ReadByte();
+	/**
+	 * Read a byte from the file.
+	 * @return Read byte.
+	 */
+	inline uint8_t ReadByte()
+	{
+		if (this->buffer == this->buffer_end) return this->ReadByteFromFile();
+		return *this->buffer++;
+	}
+
 	uint16_t ReadWord();
 	uint32_t ReadDword();
 
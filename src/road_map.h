@@ -158,6 +158,7 @@ inline void SetRoadBits(Tile t, RoadBits r, RoadTramType rtt)
 	} else {
 		SB(t.m5(), 0, 4, r);
 	}
+	InvalidateRoadRegion(t);
 }
 
 inline RoadType GetRoadTypeRoad(Tile t)
@@ -394,6 +395,7 @@ inline void SetCrossingReservation(Tile t, bool b)
 {
 	assert(IsLevelCrossingTile(t));
 	SB(t.m5(), 4, 1, b ? 1 : 0);
+	_track_reservation_generation++;
 }
 
 /**
@@ -581,6 +583,7 @@ inline void SetRoadTypeRoad(Tile t, RoadType rt)
 	assert(MayHaveRoad(t));
 	assert(rt == INVALID_ROADTYPE || RoadTypeIsRoad(rt));
 	SB(t.m4(), 0, 6, rt);
+	InvalidateRoadRegion(t);
 }
 
 /**
@@ -593,6 +596,7 @@ inline void SetRoadTypeTram(Tile t, RoadType rt)
 	assert(MayHaveRoad(t));
 	assert(rt == INVALID_ROADTYPE || RoadTypeIsTram(rt));
 	SB(t.m8(), 6, 6, rt);
+	InvalidateRoadRegion(t);
 }
 
 /**
@@ -175,18 +175,21 @@ void RoadStop::ClearDriveThrough()
 				rs_north = RoadStop::GetByTile(north_tile, rst);
 			}
 
-			/* We have to rebuild the entries because we cannot easily determine
-			 * how full each part is. So instead of keeping and maintaining a list
-			 * of vehicles and using that to 'rebuild' the occupied state we just
-			 * rebuild it from scratch as that removes lots of maintenance code
-			 * for the vehicle list and it's faster in real games as long as you
-			 * do not keep split and merge road stop every tick by the millions. */
+			/* We have to rebuild the entries of the new southern part because we
+			 * cannot easily determine how full it is. So instead of keeping and
+			 * maintaining a list of vehicles and using that to 'rebuild' the
+			 * occupied state we just rebuild it from scratch as that removes lots
+			 * of maintenance code for the vehicle list and it's faster in real
+			 * games as long as you do not keep split and merge road stop every
+			 * tick by the millions. */
 			rs_south_base->east->Rebuild(rs_south_base);
 			rs_south_base->west->Rebuild(rs_south_base);
 
+			/* There are no vehicles on the removed tile, so whatever is not in
+			 * the southern part remains in the northern part. */
 			assert(HasBit(rs_north->status, RSSFB_BASE_ENTRY));
-			rs_north->east->Rebuild(rs_north);
-			rs_north->west->Rebuild(rs_north);
+			rs_north->east->Split(rs_south_base->east);
+			rs_north->west->Split(rs_south_base->west);
 		} else {
 			/* Only we left, so simple update the length. */
 			rs_north->east->length -= TILE_SIZE;
@@ -311,39 +314,6 @@ void RoadStop::Entry::Enter(const RoadVehicle *rv)
 			IsDriveThroughStopTile(next);
 }
 
-typedef std::list<const RoadVehicle *> RVList; ///< A list of road vehicles
-
-/** Helper for finding RVs in a road stop. */
-struct RoadStopEntryRebuilderHelper {
-	RVList vehicles;   ///< The list of vehicles to possibly add to.
-	DiagDirection dir; ///< The direction the vehicle has to face to be added.
-};
-
-/**
- * Add road vehicles to the station's list if needed.
- * @param v the found vehicle
- * @param data the extra data used to make our decision
- * @return always nullptr
- */
-Vehicle *FindVehiclesInRoadStop(Vehicle *v, void *data)
-{
-	RoadStopEntryRebuilderHelper *rserh = (RoadStopEntryRebuilderHelper*)data;
-	/* Not a RV or not in the right direction or crashed :( */
-	if (v->type != VEH_ROAD || DirToDiagDir(v->direction) != rserh->dir || !v->IsPrimaryVehicle() || (v->vehstatus & VS_CRASHED) != 0) return nullptr;
-
-	RoadVehicle *rv = RoadVehicle::From(v);
-	/* Don't add ones not in a road stop */
-	if (rv->state < RVSB_IN_ROAD_STOP) return nullptr;
-
-	/* Do not add duplicates! */
-	for (const auto &it : rserh->vehicles) {
-		if (rv == it) return nullptr;
-	}
-
-	rserh->vehicles.push_back(rv);
-	return nullptr;
-}
-
 /**
  * Rebuild, from scratch, the vehicles and other metadata on this stop.
  * @param rs   the roadstop this entry is part of
@@ -356,22 +326,38 @@ void RoadStop::Entry::Rebuild(const RoadStop *rs, int side)
 	DiagDirection dir = GetRoadStopDir(rs->xy);
 	if (side == -1) side = (rs->east == this);
 
-	RoadStopEntryRebuilderHelper rserh;
-	rserh.dir = side ? dir : ReverseDiagDir(dir);
+	DiagDirection entry_dir = side ? dir : ReverseDiagDir(dir);
 
+	/* Only the road vehicle hash is walked; a primary vehicle is on one tile only, so it is counted once. */
 	this->length = 0;
+	this->occupied = 0;
 	TileIndexDiff offset = abs(TileOffsByDiagDir(dir));
 	for (TileIndex tile = rs->xy; IsDriveThroughRoadStopContinuation(rs->xy, tile); tile += offset) {
 		this->length += TILE_SIZE;
-		FindVehicleOnPos(tile, &rserh, FindVehiclesInRoadStop);
-	}
+		FindRoadVehicleOnPos(tile, [this, entry_dir](const Vehicle *v) {
+			/* Not in the right direction or crashed :( */
+			if (DirToDiagDir(v->direction) != entry_dir || !v->IsPrimaryVehicle() || (v->vehstatus & VS_CRASHED) != 0) return;
 
-	this->occupied = 0;
-	for (const auto &it : rserh.vehicles) {
-		this->occupied += it->gcache.cached_total_length;
+			/* Don't add ones not in a road stop */
+			const RoadVehicle *rv = RoadVehicle::From(v);
+			if (rv->state < RVSB_IN_ROAD_STOP) return;
+
+			this->occupied += rv->gcache.cached_total_length;
+		});
 	}
 }
 
+/**
+ * Split off the southern part of the road stop, after the tile between both parts got removed.
+ * @param south The rebuilt entry of the southern part.
+ */
+void RoadStop::Entry::Split(const Entry *south)
+{
+	this->length -= south->length + TILE_SIZE;
+	this->occupied -= south->occupied;
+	assert(this->length > 0 && this->occupied >= 0);
+}
+
 
 /**
  * Check the integrity of the data in this struct.
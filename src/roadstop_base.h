@@ -15,7 +15,7 @@
 #include "core/bitmath_func.hpp"
 #include "vehicle_type.h"
 
-typedef Pool<RoadStop, RoadStopID, 32, 64000> RoadStopPool;
+typedef Pool<RoadStop, RoadStopID, 32, 64000, PT_NORMAL, true> RoadStopPool;
 extern RoadStopPool _roadstop_pool;
 
 /** A Stop for a Road Vehicle */
@@ -62,6 +62,7 @@ struct RoadStop : RoadStopPool::PoolItem<&_roadstop_pool> {
 		void Enter(const RoadVehicle *rv);
 		void CheckIntegrity(const RoadStop *rs) const;
 		void Rebuild(const RoadStop *rs, int side = -1);
+		void Split(const Entry *south);
 	};
 
 	TileIndex       xy;     ///< Position on the map
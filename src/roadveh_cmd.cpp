@@ -36,6 +36,7 @@
 #include "newgrf.h"
 #include "zoom_func.h"
 #include "framerate_type.h"
+#include "trace.h"
 #include "roadveh_cmd.h"
 #include "road_cmd.h"
 
@@ -408,6 +409,15 @@ void RoadVehicle::MarkDirty()
 	this->CargoChanged();
 }
 
+void RoadVehicle::MarkCargoAmountDirty()
+{
+	for (RoadVehicle *v = this; v != nullptr; v = v->Next()) {
+		v->colourmap = PAL_NONE;
+		v->UpdateViewport(true, false);
+	}
+	this->CargoAmountChanged();
+}
+
 void RoadVehicle::UpdateDeltaXY()
 {
 	static const int8_t _delta_xy_table[8][10] = {
@@ -611,6 +621,7 @@ static void StartRoadVehSound(const RoadVehicle *v)
 	}
 }
 
+/** Data of the search for the closest road vehicle in front of another road vehicle. */
 struct RoadVehFindData {
 	int x;
 	int y;
@@ -618,36 +629,37 @@ struct RoadVehFindData {
 	Vehicle *best;
 	uint best_diff;
 	Direction dir;
+
+	void Check(Vehicle *v);
 };
 
-static Vehicle *EnumCheckRoadVehClose(Vehicle *v, void *data)
+/**
+ * Check whether a road vehicle is closer in front than the best one found so far.
+ * @param v The road vehicle to check.
+ */
+void RoadVehFindData::Check(Vehicle *v)
 {
 	static const int8_t dist_x[] = { -4, -8, -4, -1, 4, 8, 4, 1 };
 	static const int8_t dist_y[] = { -4, -1, 4, 8, 4, 1, -4, -8 };
 
-	RoadVehFindData *rvf = (RoadVehFindData*)data;
-
-	short x_diff = v->x_pos - rvf->x;
-	short y_diff = v->y_pos - rvf->y;
+	short x_diff = v->x_pos - this->x;
+	short y_diff = v->y_pos - this->y;
 
-	if (v->type == VEH_ROAD &&
+	if (v->direction == this->dir &&
 			!v->IsInDepot() &&
-			abs(v->z_pos - rvf->veh->z_pos) < 6 &&
-			v->direction == rvf->dir &&
-			rvf->veh->First() != v->First() &&
+			abs(v->z_pos - this->veh->z_pos) < 6 &&
+			this->veh->First() != v->First() &&
 			(dist_x[v->direction] >= 0 || (x_diff > dist_x[v->direction] && x_diff <= 0)) &&
 			(dist_x[v->direction] <= 0 || (x_diff < dist_x[v->direction] && x_diff >= 0)) &&
 			(dist_y[v->direction] >= 0 || (y_diff > dist_y[v->direction] && y_diff <= 0)) &&
 			(dist_y[v->direction] <= 0 || (y_diff < dist_y[v->direction] && y_diff >= 0))) {
 		uint diff = abs(x_diff) + abs(y_diff);
 
-		if (diff < rvf->best_diff || (diff == rvf->best_diff && v->index < rvf->best->index)) {
-			rvf->best = v;
-			rvf->best_diff = diff;
+		if (diff < this->best_diff || (diff == this->best_diff && v->index < this->best->index)) {
+			this->best = v;
+			this->best_diff = diff;
 		}
 	}
-
-	return nullptr;
 }
 
 static RoadVehicle *RoadVehFindCloseTo(RoadVehicle *v, int x, int y, Direction dir, bool update_blocked_ctr = true)
@@ -663,11 +675,20 @@ static RoadVehicle *RoadVehFindCloseTo(RoadVehicle *v, int x, int y, Direction d
 	rvf.veh = v;
 	rvf.best_diff = UINT_MAX;
 
+	auto check = [&rvf](Vehicle *u) { rvf.Check(u); };
 	if (front->state == RVSB_WORMHOLE) {
-		FindVehicleOnPos(v->tile, &rvf, EnumCheckRoadVehClose);
-		FindVehicleOnPos(GetOtherTunnelBridgeEnd(v->tile), &rvf, EnumCheckRoadVehClose);
+		FindRoadVehicleOnPos(v->tile, check);
+		FindRoadVehicleOnPos(GetOtherTunnelBridgeEnd(v->tile), check);
 	} else {
-		FindVehicleOnPosXY(x, y, &rvf, EnumCheckRoadVehClose);
+		/* Only road vehicles on the tiles within the collision distance can be close enough. */
+		const int COLL_DIST = 6;
+		uint xl = std::max(x - COLL_DIST, 0) / TILE_SIZE;
+		uint xu = std::min<uint>((x + COLL_DIST) / TILE_SIZE, Map::MaxX());
+		uint yl = std::max(y - COLL_DIST, 0) / TILE_SIZE;
+		uint yu = std::min<uint>((y + COLL_DIST) / TILE_SIZE, Map::MaxY());
+		for (uint ty = yl; ty <= yu; ty++) {
+			for (uint tx = xl; tx <= xu; tx++) FindRoadVehicleOnPos(TileXY(tx, ty), check);
+		}
 	}
 
 	/* This code protects a roadvehicle from being blocked for ever
@@ -774,13 +795,6 @@ struct OvertakeData {
 	Trackdir trackdir;
 };
 
-static Vehicle *EnumFindVehBlockingOvertake(Vehicle *v, void *data)
-{
-	const OvertakeData *od = (OvertakeData*)data;
-
-	return (v->type == VEH_ROAD && v->First() == v && v != od->u && v != od->v) ? v : nullptr;
-}
-
 /**
  * Check if overtaking is possible on a piece of track
  *
@@ -799,7 +813,9 @@ static bool CheckRoadBlockedForOvertaking(OvertakeData *od)
 	if (!HasBit(trackdirbits, od->trackdir) || (trackbits & ~TRACK_BIT_CROSS) || (red_signals != TRACKDIR_BIT_NONE)) return true;
 
 	/* Are there more vehicles on the tile except the two vehicles involved in overtaking */
-	return HasVehicleOnPos(od->tile, od, EnumFindVehBlockingOvertake);
+	return HasRoadVehicleOnPos(od->tile, [od](const Vehicle *u) {
+		return u->First() == u && u != od->u && u != od->v;
+	});
 }
 
 static void RoadVehCheckOvertake(RoadVehicle *v, RoadVehicle *u)
@@ -1656,6 +1672,8 @@ Money RoadVehicle::GetRunningCost() const
 bool RoadVehicle::Tick()
 {
 	PerformanceAccumulator framerate(PFE_GL_ROADVEHS);
+	TraceScope trace("Road vehicle tick", this->index);
+	CompanyPerformanceMeasurer company_framerate(CPE_VEHICLES, this->owner);
 
 	this->tick_counter++;
 
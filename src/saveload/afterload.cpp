@@ -62,6 +62,7 @@
 #include "../timer/timer_game_calendar.h"
 #include "../timer/timer_game_economy.h"
 #include "../timer/timer_game_tick.h"
+#include "../task_pool.h"
 
 #include "saveload_internal.h"
 
@@ -574,11 +575,14 @@ bool AfterLoadGame()
 	_gamelog.TestRevision();
 	_gamelog.TestMode();
 
-	RebuildTownKdtree();
-	RebuildStationKdtree();
+	/* The trees do not depend on each other, so they are built at the same time. */
+	TaskHandle town_kdtree = SubmitTask(TaskCategory::Savegame, RebuildTownKdtree);
+	TaskHandle station_kdtree = SubmitTask(TaskCategory::Savegame, RebuildStationKdtree);
 	/* This needs to be done even before conversion, because some conversions will destroy objects
 	 * that otherwise won't exist in the tree. */
 	RebuildViewportKdtree();
+	town_kdtree.Wait();
+	station_kdtree.Wait();
 
 	if (IsSavegameVersionBefore(SLV_98)) _gamelog.GRFAddList(_grfconfig);
 
@@ -3310,6 +3314,7 @@ bool AfterLoadGame()
 	ResetSignalHandlers();
 
 	AfterLoadLinkGraphs();
+	RebuildTownGrowthSchedule();
 
 	CheckGroundVehiclesAtCorrectZ();
 
@@ -3357,6 +3362,8 @@ void ReloadNewGRFData()
 	AfterLoadCompanyStats();
 	/* Check and update house and town values */
 	UpdateHousesAndTowns();
+	/* The house specs may have changed, so the acceptance of the houses too. */
+	InvalidateAllStationAcceptanceCaches();
 	/* Delete news referring to no longer existing entities */
 	DeleteInvalidEngineNews();
 	/* Update livery selection windows */
@@ -156,6 +156,17 @@ struct AIPLChunkHandler : ChunkHandler {
 		}
 	}
 
+	void PrepareSave() const override
+	{
+		for (CompanyID c = COMPANY_FIRST; c < MAX_COMPANIES; c++) {
+			/* Create missing configs here, as Save() runs on another thread. */
+			AIConfig::GetConfig(c, AIConfig::SSS_FORCE_GAME);
+			if (Company::IsValidAiID(c)) AI::PrepareSave(c);
+		}
+	}
+
+	bool CanSaveConcurrently() const override { return true; }
+
 	void Save() const override
 	{
 		SlTableHeader(_ai_company_desc);
@@ -43,6 +43,21 @@ static CargoMonitorID FixupCargoMonitor(CargoMonitorID number)
 	return number;
 }
 
+/**
+ * Get the monitors of a monitoring map in a fixed order.
+ * The order of the map itself depends on the order the monitors were added in.
+ * @param monitor_map The monitoring map.
+ * @return The monitors, in increasing order.
+ */
+static std::vector<CargoMonitorID> SortedMonitors(const CargoMonitorMap &monitor_map)
+{
+	std::vector<CargoMonitorID> monitors;
+	monitors.reserve(monitor_map.size());
+	for (const auto &[number, amount] : monitor_map) monitors.push_back(number);
+	std::sort(monitors.begin(), monitors.end());
+	return monitors;
+}
+
 /** #_cargo_deliveries monitoring map. */
 struct CMDLChunkHandler : ChunkHandler {
 	CMDLChunkHandler() : ChunkHandler('CMDL', CH_TABLE) {}
@@ -54,16 +69,14 @@ struct CMDLChunkHandler : ChunkHandler {
 		TempStorage storage;
 
 		int i = 0;
-		CargoMonitorMap::const_iterator iter = _cargo_deliveries.begin();
-		while (iter != _cargo_deliveries.end()) {
-			storage.number = iter->first;
-			storage.amount = iter->second;
+		for (CargoMonitorID number : SortedMonitors(_cargo_deliveries)) {
+			storage.number = number;
+			storage.amount = _cargo_deliveries.find(number)->second;
 
 			SlSetArrayIndex(i);
 			SlObject(&storage, _cargomonitor_pair_desc);
 
 			i++;
-			iter++;
 		}
 	}
 
@@ -81,8 +94,7 @@ struct CMDLChunkHandler : ChunkHandler {
 
 			if (fix) storage.number = FixupCargoMonitor(storage.number);
 
-			std::pair<CargoMonitorID, uint32_t> p(storage.number, storage.amount);
-			_cargo_deliveries.insert(p);
+			_cargo_deliveries.try_emplace(storage.number, storage.amount);
 		}
 	}
 };
@@ -98,16 +110,14 @@ struct CMPUChunkHandler : ChunkHandler {
 		TempStorage storage;
 
 		int i = 0;
-		CargoMonitorMap::const_iterator iter = _cargo_pickups.begin();
-		while (iter != _cargo_pickups.end()) {
-			storage.number = iter->first;
-			storage.amount = iter->second;
+		for (CargoMonitorID number : SortedMonitors(_cargo_pickups)) {
+			storage.number = number;
+			storage.amount = _cargo_pickups.find(number)->second;
 
 			SlSetArrayIndex(i);
 			SlObject(&storage, _cargomonitor_pair_desc);
 
 			i++;
-			iter++;
 		}
 	}
 
@@ -125,8 +135,7 @@ struct CMPUChunkHandler : ChunkHandler {
 
 			if (fix) storage.number = FixupCargoMonitor(storage.number);
 
-			std::pair<CargoMonitorID, uint32_t> p(storage.number, storage.amount);
-			_cargo_pickups.insert(p);
+			_cargo_pickups.try_emplace(storage.number, storage.amount);
 		}
 	}
 };
@@ -22,8 +22,14 @@
 
 #include "table/strings.h"
 
+#include "../task_pool.h"
+
+#include <mutex>
+
 #include "../safeguards.h"
 
+static const uint INFRASTRUCTURE_BAND_SIZE = 1 << 18; ///< Number of tiles counted by a task when rebuilding the infrastructure statistics.
+
 /**
  * Converts an old company manager's face format to the new company manager's face format
  *
@@ -92,24 +98,21 @@ CompanyManagerFace ConvertFromOldCompanyManagerFace(uint32_t face)
 	return cmf;
 }
 
-/** Rebuilding of company statistics after loading a savegame. */
-void AfterLoadCompanyStats()
+/**
+ * Count the infrastructure on a part of the map.
+ * @param begin First tile to count.
+ * @param end Tile after the last tile to count.
+ * @param[out] infrastructure Infrastructure per company to add the tiles to.
+ */
+static void CountInfrastructure(TileIndex begin, TileIndex end, std::array<CompanyInfrastructure, MAX_COMPANIES> &infrastructure)
 {
-	/* Reset infrastructure statistics to zero. */
-	for (Company *c : Company::Iterate()) MemSetT(&c->infrastructure, 0);
+	auto get = [&infrastructure](Owner owner) { return Company::IsValidID(owner) ? &infrastructure[owner] : nullptr; };
 
-	/* Collect airport count. */
-	for (const Station *st : Station::Iterate()) {
-		if ((st->facilities & FACIL_AIRPORT) && Company::IsValidID(st->owner)) {
-			Company::Get(st->owner)->infrastructure.airport++;
-		}
-	}
-
-	Company *c;
-	for (TileIndex tile = 0; tile < Map::Size(); tile++) {
+	CompanyInfrastructure *c;
+	for (TileIndex tile = begin; tile < end; tile++) {
 		switch (GetTileType(tile)) {
 			case MP_RAILWAY:
-				c = Company::GetIfValid(GetTileOwner(tile));
+				c = get(GetTileOwner(tile));
 				if (c != nullptr) {
 					uint pieces = 1;
 					if (IsPlainRail(tile)) {
@@ -117,37 +120,37 @@ void AfterLoadCompanyStats()
 						pieces = CountBits(bits);
 						if (TracksOverlap(bits)) pieces *= pieces;
 					}
-					c->infrastructure.rail[GetRailType(tile)] += pieces;
+					c->rail[GetRailType(tile)] += pieces;
 
-					if (HasSignals(tile)) c->infrastructure.signal += CountBits(GetPresentSignals(tile));
+					if (HasSignals(tile)) c->signal += CountBits(GetPresentSignals(tile));
 				}
 				break;
 
 			case MP_ROAD: {
 				if (IsLevelCrossing(tile)) {
-					c = Company::GetIfValid(GetTileOwner(tile));
-					if (c != nullptr) c->infrastructure.rail[GetRailType(tile)] += LEVELCROSSING_TRACKBIT_FACTOR;
+					c = get(GetTileOwner(tile));
+					if (c != nullptr) c->rail[GetRailType(tile)] += LEVELCROSSING_TRACKBIT_FACTOR;
 				}
 
 				/* Iterate all present road types as each can have a different owner. */
 				for (RoadTramType rtt : _roadtramtypes) {
 					RoadType rt = GetRoadType(tile, rtt);
 					if (rt == INVALID_ROADTYPE) continue;
-					c = Company::GetIfValid(IsRoadDepot(tile) ? GetTileOwner(tile) : GetRoadOwner(tile, rtt));
+					c = get(IsRoadDepot(tile) ? GetTileOwner(tile) : GetRoadOwner(tile, rtt));
 					/* A level crossings and depots have two road bits. */
-					if (c != nullptr) c->infrastructure.road[rt] += IsNormalRoad(tile) ? CountBits(GetRoadBits(tile, rtt)) : 2;
+					if (c != nullptr) c->road[rt] += IsNormalRoad(tile) ? CountBits(GetRoadBits(tile, rtt)) : 2;
 				}
 				break;
 			}
 
 			case MP_STATION:
-				c = Company::GetIfValid(GetTileOwner(tile));
-				if (c != nullptr && GetStationType(tile) != STATION_AIRPORT && !IsBuoy(tile)) c->infrastructure.station++;
+				c = get(GetTileOwner(tile));
+				if (c != nullptr && GetStationType(tile) != STATION_AIRPORT && !IsBuoy(tile)) c->station++;
 
 				switch (GetStationType(tile)) {
 					case STATION_RAIL:
 					case STATION_WAYPOINT:
-						if (c != nullptr && !IsStationTileBlocked(tile)) c->infrastructure.rail[GetRailType(tile)]++;
+						if (c != nullptr && !IsStationTileBlocked(tile)) c->rail[GetRailType(tile)]++;
 						break;
 
 					case STATION_BUS:
@@ -156,8 +159,8 @@ void AfterLoadCompanyStats()
 						for (RoadTramType rtt : _roadtramtypes) {
 							RoadType rt = GetRoadType(tile, rtt);
 							if (rt == INVALID_ROADTYPE) continue;
-							c = Company::GetIfValid(GetRoadOwner(tile, rtt));
-							if (c != nullptr) c->infrastructure.road[rt] += 2; // A road stop has two road bits.
+							c = get(GetRoadOwner(tile, rtt));
+							if (c != nullptr) c->road[rt] += 2; // A road stop has two road bits.
 						}
 						break;
 					}
@@ -165,7 +168,7 @@ void AfterLoadCompanyStats()
 					case STATION_DOCK:
 					case STATION_BUOY:
 						if (GetWaterClass(tile) == WATER_CLASS_CANAL) {
-							if (c != nullptr) c->infrastructure.water++;
+							if (c != nullptr) c->water++;
 						}
 						break;
 
@@ -176,12 +179,12 @@ void AfterLoadCompanyStats()
 
 			case MP_WATER:
 				if (IsShipDepot(tile) || IsLock(tile)) {
-					c = Company::GetIfValid(GetTileOwner(tile));
+					c = get(GetTileOwner(tile));
 					if (c != nullptr) {
-						if (IsShipDepot(tile)) c->infrastructure.water += LOCK_DEPOT_TILE_FACTOR;
+						if (IsShipDepot(tile)) c->water += LOCK_DEPOT_TILE_FACTOR;
 						if (IsLock(tile) && GetLockPart(tile) == LOCK_PART_MIDDLE) {
 							/* The middle tile specifies the owner of the lock. */
-							c->infrastructure.water += 3 * LOCK_DEPOT_TILE_FACTOR; // the middle tile specifies the owner of the
+							c->water += 3 * LOCK_DEPOT_TILE_FACTOR; // the middle tile specifies the owner of the
 							break; // do not count the middle tile as canal
 						}
 					}
@@ -190,8 +193,8 @@ void AfterLoadCompanyStats()
 
 			case MP_OBJECT:
 				if (GetWaterClass(tile) == WATER_CLASS_CANAL) {
-					c = Company::GetIfValid(GetTileOwner(tile));
-					if (c != nullptr) c->infrastructure.water++;
+					c = get(GetTileOwner(tile));
+					if (c != nullptr) c->water++;
 				}
 				break;
 
@@ -205,8 +208,8 @@ void AfterLoadCompanyStats()
 
 					switch (GetTunnelBridgeTransportType(tile)) {
 						case TRANSPORT_RAIL:
-							c = Company::GetIfValid(GetTileOwner(tile));
-							if (c != nullptr) c->infrastructure.rail[GetRailType(tile)] += len;
+							c = get(GetTileOwner(tile));
+							if (c != nullptr) c->rail[GetRailType(tile)] += len;
 							break;
 
 						case TRANSPORT_ROAD: {
@@ -214,15 +217,15 @@ void AfterLoadCompanyStats()
 							for (RoadTramType rtt : _roadtramtypes) {
 								RoadType rt = GetRoadType(tile, rtt);
 								if (rt == INVALID_ROADTYPE) continue;
-								c = Company::GetIfValid(GetRoadOwner(tile, rtt));
-								if (c != nullptr) c->infrastructure.road[rt] += len * 2; // A full diagonal road has two road bits.
+								c = get(GetRoadOwner(tile, rtt));
+								if (c != nullptr) c->road[rt] += len * 2; // A full diagonal road has two road bits.
 							}
 							break;
 						}
 
 						case TRANSPORT_WATER:
-							c = Company::GetIfValid(GetTileOwner(tile));
-							if (c != nullptr) c->infrastructure.water += len;
+							c = get(GetTileOwner(tile));
+							if (c != nullptr) c->water += len;
 							break;
 
 						default:
@@ -238,6 +241,45 @@ void AfterLoadCompanyStats()
 	}
 }
 
+/**
+ * Add the counts of some infrastructure to those of a company.
+ * @param[in,out] to Infrastructure of the company.
+ * @param from Infrastructure to add.
+ */
+static void AddInfrastructure(CompanyInfrastructure &to, const CompanyInfrastructure &from)
+{
+	for (uint i = 0; i < lengthof(to.road); i++) to.road[i] += from.road[i];
+	for (uint i = 0; i < lengthof(to.rail); i++) to.rail[i] += from.rail[i];
+	to.signal += from.signal;
+	to.water += from.water;
+	to.station += from.station;
+	to.airport += from.airport;
+}
+
+/** Rebuilding of company statistics after loading a savegame. */
+void AfterLoadCompanyStats()
+{
+	/* Reset infrastructure statistics to zero. */
+	for (Company *c : Company::Iterate()) MemSetT(&c->infrastructure, 0);
+
+	/* Collect airport count. */
+	for (const Station *st : Station::Iterate()) {
+		if ((st->facilities & FACIL_AIRPORT) && Company::IsValidID(st->owner)) {
+			Company::Get(st->owner)->infrastructure.airport++;
+		}
+	}
+
+	/* The map is only read, so parts of it are counted at the same time and added up afterwards. */
+	std::mutex mutex;
+	RunInBands(TaskCategory::Savegame, Map::Size(), INFRASTRUCTURE_BAND_SIZE, [&mutex](uint begin, uint end) {
+		std::array<CompanyInfrastructure, MAX_COMPANIES> infrastructure{};
+		CountInfrastructure(TileIndex(begin), TileIndex(end), infrastructure);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		for (Company *c : Company::Iterate()) AddInfrastructure(c->infrastructure, infrastructure[c->index]);
+	});
+}
+
 /* We do need to read this single value, as the bigger it gets, the more data is stored */
 struct CompanyOldAI {
 	uint8_t num_build_rec;
@@ -522,6 +564,8 @@ struct PLYRChunkHandler : ChunkHandler {
 	}
 
 
+	bool HasLoadCheck() const override { return true; }
+
 	void LoadCheck(size_t) const override
 	{
 		const std::vector<SaveLoad> slt = SlCompatTableHeader(_company_desc, _company_sl_compat);
@@ -105,6 +105,15 @@ struct GSDTChunkHandler : ChunkHandler {
 		if (SlIterateArray() != -1) SlErrorCorrupt("Too many GameScript configs");
 	}
 
+	void PrepareSave() const override
+	{
+		/* Create a missing config here, as Save() runs on another thread. */
+		GameConfig::GetConfig();
+		Game::PrepareSave();
+	}
+
+	bool CanSaveConcurrently() const override { return true; }
+
 	void Save() const override
 	{
 		SlTableHeader(_game_script_desc);
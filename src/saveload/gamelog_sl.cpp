@@ -417,6 +417,8 @@ struct GLOGChunkHandler : ChunkHandler {
 		this->LoadCommon(_gamelog);
 	}
 
+	bool HasLoadCheck() const override { return true; }
+
 	void LoadCheck(size_t) const override
 	{
 		this->LoadCommon(_load_check_data.gamelog);
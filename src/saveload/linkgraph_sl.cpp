@@ -139,6 +139,7 @@ SaveLoadTable GetLinkGraphDesc()
 		 SLE_VAR(LinkGraph, last_compression, SLE_INT32),
 		SLEG_CONDVAR("num_nodes", _num_nodes, SLE_UINT16, SL_MIN_VERSION, SLV_SAVELOAD_LIST_LENGTH),
 		 SLE_VAR(LinkGraph, cargo,            SLE_UINT8),
+		SLE_CONDVAR(LinkGraph, job_fingerprint, SLE_UINT64, SLV_LINKGRAPH_JOB_FINGERPRINT, SL_MAX_VERSION),
 		SLEG_STRUCTLIST("nodes", SlLinkgraphNode),
 	};
 	return link_graph_desc;
@@ -183,6 +184,7 @@ SaveLoadTable GetLinkGraphJobDesc()
 
 	static const SaveLoad job_desc[] = {
 		SLE_VAR(LinkGraphJob, join_date,        SLE_INT32),
+		SLE_CONDVAR(LinkGraphJob, join_delay,   SLE_INT32, SLV_LINKGRAPH_POSTPONE_JOIN, SL_MAX_VERSION),
 		SLE_VAR(LinkGraphJob, link_graph.index, SLE_UINT16),
 		SLEG_STRUCT("linkgraph", SlLinkgraphJobProxy),
 	};
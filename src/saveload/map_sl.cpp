@@ -51,6 +51,8 @@ struct MAPSChunkHandler : ChunkHandler {
 		Map::Allocate(_map_dim_x, _map_dim_y);
 	}
 
+	bool HasLoadCheck() const override { return true; }
+
 	void LoadCheck(size_t) const override
 	{
 		const std::vector<SaveLoad> slt = SlCompatTableHeader(_map_desc, _map_sl_compat);
@@ -66,11 +68,174 @@ struct MAPSChunkHandler : ChunkHandler {
 
 static const uint MAP_SL_BUF_SIZE = 4096;
 
+/** Encoding of a map array in the savegame, since #SLV_MAP_ARRAY_ENCODING. */
+enum class MapArrayEncoding : uint8_t {
+	Raw,            ///< The value of every tile.
+	RunLength,      ///< The values, run length encoded.
+	DeltaRunLength, ///< The difference of every value with the previous one, run length encoded.
+};
+
+static const uint MAP_SL_MAX_LITERALS = 128; ///< Maximum number of values in a literal run; their control byte is the number minus one.
+static const uint MAP_SL_MIN_REPEAT = 3;     ///< Minimum length of a run of repeated values; their control byte is the length plus 125.
+static const uint MAP_SL_MAX_REPEAT = 255 - MAP_SL_MAX_LITERALS + MAP_SL_MIN_REPEAT; ///< Maximum length of a run of repeated values.
+
+/**
+ * Append a value of a map array to an encoded buffer, big endian like the rest of the savegame.
+ * @param buf The buffer.
+ * @param value The value.
+ */
+template <typename T>
+static void AppendMapArrayValue(std::vector<uint8_t> &buf, T value)
+{
+	if constexpr (sizeof(T) == 2) buf.push_back(GB(value, 8, 8));
+	buf.push_back(GB(value, 0, 8));
+}
+
+/**
+ * Read a value of a map array from an encoded map array.
+ * @return The value.
+ */
+template <typename T>
+static T ReadMapArrayValue()
+{
+	if constexpr (sizeof(T) == 2) {
+		T value = SlReadByte() << 8;
+		return value | SlReadByte();
+	}
+	return SlReadByte();
+}
+
+/**
+ * Run length encode the values of a map array. Every run starts with a
+ * control byte: below #MAP_SL_MAX_LITERALS it is followed by that many plus
+ * one values, otherwise by one value that is repeated the control byte minus
+ * #MAP_SL_MAX_LITERALS plus #MAP_SL_MIN_REPEAT times.
+ * @param values The values to encode.
+ * @return The encoded values.
+ */
+template <typename T>
+static std::vector<uint8_t> RunLengthEncodeMapArray(const std::vector<T> &values)
+{
+	std::vector<uint8_t> buf;
+	size_t literals = 0; // Start of the values not encoded yet.
+
+	auto append_literals = [&](size_t end) {
+		while (literals != end) {
+			size_t count = std::min<size_t>(end - literals, MAP_SL_MAX_LITERALS);
+			buf.push_back(static_cast<uint8_t>(count - 1));
+			for (size_t j = 0; j != count; j++) AppendMapArrayValue(buf, values[literals++]);
+		}
+	};
+
+	for (size_t i = 0; i != values.size();) {
+		size_t run = 1;
+		while (run != MAP_SL_MAX_REPEAT && i + run != values.size() && values[i + run] == values[i]) run++;
+
+		if (run >= MAP_SL_MIN_REPEAT) {
+			append_literals(i);
+			buf.push_back(static_cast<uint8_t>(run - MAP_SL_MIN_REPEAT + MAP_SL_MAX_LITERALS));
+			AppendMapArrayValue(buf, values[i]);
+			literals = i + run;
+		}
+		i += run;
+	}
+	append_literals(values.size());
+
+	return buf;
+}
+
+/**
+ * Save a map array, encoded when that makes it smaller.
+ * @param get Function to get the value of a tile.
+ * @param encoding Encoding to try; #MapArrayEncoding::DeltaRunLength is for slowly changing values.
+ */
+template <typename T, typename F>
+static void SaveMapArray(F get, MapArrayEncoding encoding)
+{
+	uint size = Map::Size();
+	const VarType conv = sizeof(T) == 2 ? SLE_UINT16 : SLE_UINT8;
+
+	std::vector<T> values(size);
+	T previous = 0;
+	for (uint i = 0; i != size; i++) {
+		T value = get(Tile(i));
+		values[i] = (encoding == MapArrayEncoding::DeltaRunLength) ? static_cast<T>(value - previous) : value;
+		previous = value;
+	}
+
+	std::vector<uint8_t> encoded = RunLengthEncodeMapArray(values);
+	if (encoded.size() < static_cast<size_t>(size) * sizeof(T)) {
+		SlSetLength(1 + encoded.size());
+		SlWriteByte(static_cast<uint8_t>(encoding));
+		SlCopy(encoded.data(), encoded.size(), SLE_UINT8);
+		return;
+	}
+
+	SlSetLength(1 + static_cast<size_t>(size) * sizeof(T));
+	SlWriteByte(static_cast<uint8_t>(MapArrayEncoding::Raw));
+	if (encoding == MapArrayEncoding::DeltaRunLength) {
+		for (uint i = 0; i != size; i++) values[i] = get(Tile(i));
+	}
+	SlCopy(values.data(), size, conv);
+}
+
+/**
+ * Load a map array saved by #SaveMapArray.
+ * @param set Function to set the value of a tile.
+ */
+template <typename T, typename F>
+static void LoadMapArray(F set)
+{
+	uint size = Map::Size();
+	MapArrayEncoding encoding = static_cast<MapArrayEncoding>(SlReadByte());
+
+	switch (encoding) {
+		case MapArrayEncoding::Raw: {
+			std::array<T, MAP_SL_BUF_SIZE> buf;
+			for (TileIndex i = 0; i != size;) {
+				SlCopy(buf.data(), MAP_SL_BUF_SIZE, sizeof(T) == 2 ? SLE_UINT16 : SLE_UINT8);
+				for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) set(Tile(i++), buf[j]);
+			}
+			break;
+		}
+
+		case MapArrayEncoding::RunLength:
+		case MapArrayEncoding::DeltaRunLength: {
+			bool delta = encoding == MapArrayEncoding::DeltaRunLength;
+			T previous = 0;
+			for (TileIndex i = 0; i != size;) {
+				uint8_t control = SlReadByte();
+				bool repeat = control >= MAP_SL_MAX_LITERALS;
+				uint count = repeat ? control - MAP_SL_MAX_LITERALS + MAP_SL_MIN_REPEAT : control + 1;
+				if (count > size - i) SlErrorCorrupt("Map array run beyond the end of the map");
+
+				T value = repeat ? ReadMapArrayValue<T>() : 0;
+				for (uint j = 0; j != count; j++) {
+					if (!repeat) value = ReadMapArrayValue<T>();
+					previous = delta ? static_cast<T>(previous + value) : value;
+					set(Tile(i++), previous);
+				}
+			}
+			break;
+		}
+
+		default:
+			SlErrorCorrupt("Unknown map array encoding");
+	}
+}
+
 struct MAPTChunkHandler : ChunkHandler {
 	MAPTChunkHandler() : ChunkHandler('MAPT', CH_RIFF) {}
 
+	bool CanSaveConcurrently() const override { return true; }
+
 	void Load() const override
 	{
+		if (!IsSavegameVersionBefore(SLV_MAP_ARRAY_ENCODING)) {
+			LoadMapArray<uint8_t>([](Tile t, uint8_t value) { t.type() = value; });
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -82,22 +247,22 @@ struct MAPTChunkHandler : ChunkHandler {
 
 	void Save() const override
 	{
-		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(size);
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).type();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		}
+		SaveMapArray<uint8_t>([](Tile t) { return t.type(); }, MapArrayEncoding::RunLength);
 	}
 };
 
 struct MAPHChunkHandler : ChunkHandler {
 	MAPHChunkHandler() : ChunkHandler('MAPH', CH_RIFF) {}
 
+	bool CanSaveConcurrently() const override { return true; }
+
 	void Load() const override
 	{
+		if (!IsSavegameVersionBefore(SLV_MAP_ARRAY_ENCODING)) {
+			LoadMapArray<uint8_t>([](Tile t, uint8_t value) { t.height() = value; });
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -109,22 +274,22 @@ struct MAPHChunkHandler : ChunkHandler {
 
 	void Save() const override
 	{
-		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(size);
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).height();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		}
+		SaveMapArray<uint8_t>([](Tile t) { return t.height(); }, MapArrayEncoding::DeltaRunLength);
 	}
 };
 
 struct MAPOChunkHandler : ChunkHandler {
 	MAPOChunkHandler() : ChunkHandler('MAPO', CH_RIFF) {}
 
+	bool CanSaveConcurrently() const override { return true; }
+
 	void Load() const override
 	{
+		if (!IsSavegameVersionBefore(SLV_MAP_ARRAY_ENCODING)) {
+			LoadMapArray<uint8_t>([](Tile t, uint8_t value) { t.m1() = value; });
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -136,22 +301,22 @@ struct MAPOChunkHandler : ChunkHandler {
 
 	void Save() const override
 	{
-		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(size);
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).m1();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		}
+		SaveMapArray<uint8_t>([](Tile t) { return t.m1(); }, MapArrayEncoding::RunLength);
 	}
 };
 
 struct MAP2ChunkHandler : ChunkHandler {
 	MAP2ChunkHandler() : ChunkHandler('MAP2', CH_RIFF) {}
 
+	bool CanSaveConcurrently() const override { return true; }
+
 	void Load() const override
 	{
+		if (!IsSavegameVersionBefore(SLV_MAP_ARRAY_ENCODING)) {
+			LoadMapArray<uint16_t>([](Tile t, uint16_t value) { t.m2() = value; });
+			return;
+		}
+
 		std::array<uint16_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -166,22 +331,22 @@ struct MAP2ChunkHandler : ChunkHandler {
 
 	void Save() const override
 	{
-		std::array<uint16_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(static_cast<uint32_t>(size) * sizeof(uint16_t));
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).m2();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT16);
-		}
+		SaveMapArray<uint16_t>([](Tile t) { return t.m2(); }, MapArrayEncoding::RunLength);
 	}
 };
 
 struct M3LOChunkHandler : ChunkHandler {
 	M3LOChunkHandler() : ChunkHandler('M3LO', CH_RIFF) {}
 
+	bool CanSaveConcurrently() const override { return true; }
+
 	void Load() const override
 	{
+		if (!IsSavegameVersionBefore(SLV_MAP_ARRAY_ENCODING)) {
+			LoadMapArray<uint8_t>([](Tile t, uint8_t value) { t.m3() = value; });
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -193,22 +358,22 @@ struct M3LOChunkHandler : ChunkHandler {
 
 	void Save() const override
 	{
-		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(size);
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).m3();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		}
+		SaveMapArray<uint8_t>([](Tile t) { return t.m3(); }, MapArrayEncoding::RunLength);
 	}
 };
 
 struct M3HIChunkHandler : ChunkHandler {
 	M3HIChunkHandler() : ChunkHandler('M3HI', CH_RIFF) {}
 
+	bool CanSaveConcurrently() const override { return true; }
+
 	void Load() const override
 	{
+		if (!IsSavegameVersionBefore(SLV_MAP_ARRAY_ENCODING)) {
+			LoadMapArray<uint8_t>([](Tile t, uint8_t value) { t.m4() = value; });
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -220,22 +385,22 @@ struct M3HIChunkHandler : ChunkHandler {
 
 	void Save() const override
 	{
-		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(size);
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).m4();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		}
+		SaveMapArray<uint8_t>([](Tile t) { return t.m4(); }, MapArrayEncoding::RunLength);
 	}
 };
 
 struct MAP5ChunkHandler : ChunkHandler {
 	MAP5ChunkHandler() : ChunkHandler('MAP5', CH_RIFF) {}
 
+	bool CanSaveConcurrently() const override { return true; }
+
 	void Load() const override
 	{
+		if (!IsSavegameVersionBefore(SLV_MAP_ARRAY_ENCODING)) {
+			LoadMapArray<uint8_t>([](Tile t, uint8_t value) { t.m5() = value; });
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -247,22 +412,22 @@ struct MAP5ChunkHandler : ChunkHandler {
 
 	void Save() const override
 	{
-		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(size);
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).m5();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		}
+		SaveMapArray<uint8_t>([](Tile t) { return t.m5(); }, MapArrayEncoding::RunLength);
 	}
 };
 
 struct MAPEChunkHandler : ChunkHandler {
 	MAPEChunkHandler() : ChunkHandler('MAPE', CH_RIFF) {}
 
+	bool CanSaveConcurrently() const override { return true; }
+
 	void Load() const override
 	{
+		if (!IsSavegameVersionBefore(SLV_MAP_ARRAY_ENCODING)) {
+			LoadMapArray<uint8_t>([](Tile t, uint8_t value) { t.m6() = value; });
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -287,22 +452,22 @@ struct MAPEChunkHandler : ChunkHandler {
 
 	void Save() const override
 	{
-		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(size);
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).m6();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		}
+		SaveMapArray<uint8_t>([](Tile t) { return t.m6(); }, MapArrayEncoding::RunLength);
 	}
 };
 
 struct MAP7ChunkHandler : ChunkHandler {
 	MAP7ChunkHandler() : ChunkHandler('MAP7', CH_RIFF) {}
 
+	bool CanSaveConcurrently() const override { return true; }
+
 	void Load() const override
 	{
+		if (!IsSavegameVersionBefore(SLV_MAP_ARRAY_ENCODING)) {
+			LoadMapArray<uint8_t>([](Tile t, uint8_t value) { t.m7() = value; });
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -314,22 +479,22 @@ struct MAP7ChunkHandler : ChunkHandler {
 
 	void Save() const override
 	{
-		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(size);
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).m7();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		}
+		SaveMapArray<uint8_t>([](Tile t) { return t.m7(); }, MapArrayEncoding::RunLength);
 	}
 };
 
 struct MAP8ChunkHandler : ChunkHandler {
 	MAP8ChunkHandler() : ChunkHandler('MAP8', CH_RIFF) {}
 
+	bool CanSaveConcurrently() const override { return true; }
+
 	void Load() const override
 	{
+		if (!IsSavegameVersionBefore(SLV_MAP_ARRAY_ENCODING)) {
+			LoadMapArray<uint16_t>([](Tile t, uint16_t value) { t.m8() = value; });
+			return;
+		}
+
 		std::array<uint16_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -341,14 +506,7 @@ struct MAP8ChunkHandler : ChunkHandler {
 
 	void Save() const override
 	{
-		std::array<uint16_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(static_cast<uint32_t>(size) * sizeof(uint16_t));
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).m8();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT16);
-		}
+		SaveMapArray<uint16_t>([](Tile t) { return t.m8(); }, MapArrayEncoding::RunLength);
 	}
 };
 
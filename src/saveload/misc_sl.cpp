@@ -139,6 +139,8 @@ struct DATEChunkHandler : ChunkHandler {
 	}
 
 
+	bool HasLoadCheck() const override { return true; }
+
 	void LoadCheck(size_t) const override
 	{
 		this->LoadCommon(_date_check_desc, _date_check_sl_compat);
@@ -119,6 +119,8 @@ struct NGRFChunkHandler : ChunkHandler {
 		}
 	}
 
+	bool HasLoadCheck() const override { return true; }
+
 	void LoadCheck(size_t) const override
 	{
 		this->LoadCommon(_load_check_data.grfconfig);
@@ -42,10 +42,17 @@
 #include "../string_func.h"
 #include "../fios.h"
 #include "../error.h"
+#include "../trace.h"
 #include <atomic>
+#include <condition_variable>
 #ifdef __EMSCRIPTEN__
 #	include <emscripten.h>
 #endif
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+#	include <sys/wait.h>
+#	include <unistd.h>
+#	define WITH_FORKED_SAVE
+#endif
 
 #include "table/strings.h"
 
@@ -64,6 +71,7 @@ SaveLoadVersion _sl_version;  ///< the major savegame version identifier
 uint8_t   _sl_minor_version;     ///< the minor savegame version, DO NOT USE!
 std::string _savegame_format; ///< how to compress savegames
 bool _do_autosave;            ///< are we doing an autosave at the moment?
+bool _forked_autosave = false; ///< Whether autosaves are saved by a forked copy of the game, so the game continues meanwhile.
 
 /** What are we currently doing? */
 enum SaveLoadAction {
@@ -159,7 +167,7 @@ struct MemoryDumper {
 	}
 
 	/**
-	 * Flush this dumper into a writer.
+	 * Flush this dumper into a writer. The writer is not finished, as more dumps may follow.
 	 * @param writer The filter we want to use.
 	 */
 	void Flush(std::shared_ptr<SaveFilter> writer)
@@ -173,8 +181,6 @@ struct MemoryDumper {
 			writer->Write(this->blocks[i++], to_write);
 			t -= to_write;
 		}
-
-		writer->Finish();
 	}
 
 	/**
@@ -199,6 +205,7 @@ struct SaveLoadParams {
 	bool expect_table_header;            ///< In the case of a table, if the header is saved/loaded.
 
 	std::unique_ptr<MemoryDumper> dumper; ///< Memory dumper to write the savegame to.
+	std::vector<std::unique_ptr<MemoryDumper>> dumps; ///< Finished memory dumps of the savegame, in the order they are written.
 	std::shared_ptr<SaveFilter> sf; ///< Filter to write the savegame to.
 
 	std::unique_ptr<ReadBuffer> reader; ///< Savegame reading buffer.
@@ -210,7 +217,9 @@ struct SaveLoadParams {
 	bool saveinprogress;                 ///< Whether there is currently a save in progress.
 };
 
-static SaveLoadParams _sl; ///< Parameters used for/at saveload.
+static SaveLoadParams _sl_main; ///< Parameters used for/at saveload.
+/** Parameters used by the current thread; other than the main parameters only while a chunk is saved concurrently. */
+static thread_local SaveLoadParams *_sl = &_sl_main;
 
 static const std::vector<ChunkHandlerRef> &ChunkHandlers()
 {
@@ -308,7 +317,7 @@ static const std::vector<ChunkHandlerRef> &ChunkHandlers()
 /** Null all pointers (convert index -> nullptr) */
 static void SlNullPointers()
 {
-	_sl.action = SLA_NULL;
+	_sl->action = SLA_NULL;
 
 	/* We don't want any savegame conversion code to run
 	 * during NULLing; especially those that try to get
@@ -320,7 +329,7 @@ static void SlNullPointers()
 		ch.FixPointers();
 	}
 
-	assert(_sl.action == SLA_NULL);
+	assert(_sl->action == SLA_NULL);
 }
 
 /**
@@ -334,19 +343,19 @@ static void SlNullPointers()
 [[noreturn]] void SlError(StringID string, const std::string &extra_msg)
 {
 	/* Distinguish between loading into _load_check_data vs. normal save/load. */
-	if (_sl.action == SLA_LOAD_CHECK) {
+	if (_sl->action == SLA_LOAD_CHECK) {
 		_load_check_data.error = string;
 		_load_check_data.error_msg = extra_msg;
 	} else {
-		_sl.error_str = string;
-		_sl.extra_msg = extra_msg;
+		_sl->error_str = string;
+		_sl->extra_msg = extra_msg;
 	}
 
 	/* We have to nullptr all pointers here; we might be in a state where
 	 * the pointers are actually filled with indices, which means that
 	 * when we access them during cleaning the pool dereferences of
 	 * those indices will be made with segmentation faults as result. */
-	if (_sl.action == SLA_LOAD || _sl.action == SLA_PTRS) SlNullPointers();
+	if (_sl->action == SLA_LOAD || _sl->action == SLA_PTRS) SlNullPointers();
 
 	/* Logging could be active. */
 	_gamelog.StopAnyAction();
@@ -369,7 +378,11 @@ static void SlNullPointers()
 
 typedef void (*AsyncSaveFinishProc)();                      ///< Callback for when the savegame loading is finished.
 static std::atomic<AsyncSaveFinishProc> _async_save_finish; ///< Callback to call when the savegame loading is finished.
-static std::thread _save_thread;                            ///< The thread we're using to compress and write a savegame
+static TaskHandle _save_task;                               ///< The task we're using to compress and write a savegame
+#ifdef WITH_FORKED_SAVE
+static pid_t _forked_save_pid = -1;                         ///< The forked copy of the game that is saving, or -1.
+#endif
+static bool _save_without_workers = false;                  ///< Whether saving must not use the worker threads, as in a forked copy of the game.
 
 /**
  * Called by save thread to tell we finished saving.
@@ -383,18 +396,23 @@ static void SetAsyncSaveFinish(AsyncSaveFinishProc proc)
 	_async_save_finish.store(proc, std::memory_order_release);
 }
 
+static void ProcessForkedSaveFinish();
+
 /**
  * Handle async save finishes.
  */
 void ProcessAsyncSaveFinish()
 {
+	ProcessForkedSaveFinish();
+
 	AsyncSaveFinishProc proc = _async_save_finish.exchange(nullptr, std::memory_order_acq_rel);
 	if (proc == nullptr) return;
 
 	proc();
 
-	if (_save_thread.joinable()) {
-		_save_thread.join();
+	if (_save_task.IsValid()) {
+		_save_task.Wait();
+		_save_task = {};
 	}
 }
 
@@ -404,7 +422,7 @@ void ProcessAsyncSaveFinish()
  */
 uint8_t SlReadByte()
 {
-	return _sl.reader->ReadByte();
+	return _sl->reader->ReadByte();
 }
 
 /**
@@ -413,7 +431,7 @@ uint8_t SlReadByte()
  */
 void SlWriteByte(uint8_t b)
 {
-	_sl.dumper->WriteByte(b);
+	_sl->dumper->WriteByte(b);
 }
 
 static inline int SlReadUint16()
@@ -578,6 +596,7 @@ static uint8_t GetSavegameFileType(const SaveLoad &sld)
 			return IsSavegameVersionBefore(SLV_69) ? SLE_FILE_U16 : SLE_FILE_U32;
 
 		case SL_REFLIST:
+		case SL_REFVECTOR:
 			return (IsSavegameVersionBefore(SLV_69) ? SLE_FILE_U16 : SLE_FILE_U32) | SLE_FILE_HAS_LENGTH_FIELD;
 
 		case SL_SAVEBYTE:
@@ -643,8 +662,8 @@ static inline size_t SlCalcRefLen()
 
 void SlSetArrayIndex(uint index)
 {
-	_sl.need_length = NL_WANTLENGTH;
-	_sl.array_index = index;
+	_sl->need_length = NL_WANTLENGTH;
+	_sl->array_index = index;
 }
 
 static size_t _next_offs;
@@ -657,32 +676,32 @@ int SlIterateArray()
 {
 	/* After reading in the whole array inside the loop
 	 * we must have read in all the data, so we must be at end of current block. */
-	if (_next_offs != 0 && _sl.reader->GetSize() != _next_offs) {
-		SlErrorCorruptFmt("Invalid chunk size iterating array - expected to be at position {}, actually at {}", _next_offs, _sl.reader->GetSize());
+	if (_next_offs != 0 && _sl->reader->GetSize() != _next_offs) {
+		SlErrorCorruptFmt("Invalid chunk size iterating array - expected to be at position {}, actually at {}", _next_offs, _sl->reader->GetSize());
 	}
 
 	for (;;) {
 		uint length = SlReadArrayLength();
 		if (length == 0) {
-			assert(!_sl.expect_table_header);
+			assert(!_sl->expect_table_header);
 			_next_offs = 0;
 			return -1;
 		}
 
-		_sl.obj_len = --length;
-		_next_offs = _sl.reader->GetSize() + length;
+		_sl->obj_len = --length;
+		_next_offs = _sl->reader->GetSize() + length;
 
-		if (_sl.expect_table_header) {
-			_sl.expect_table_header = false;
+		if (_sl->expect_table_header) {
+			_sl->expect_table_header = false;
 			return INT32_MAX;
 		}
 
 		int index;
-		switch (_sl.block_mode) {
+		switch (_sl->block_mode) {
 			case CH_SPARSE_TABLE:
 			case CH_SPARSE_ARRAY: index = (int)SlReadSparseIndex(); break;
 			case CH_TABLE:
-			case CH_ARRAY:        index = _sl.array_index++; break;
+			case CH_ARRAY:        index = _sl->array_index++; break;
 			default:
 				Debug(sl, 0, "SlIterateArray error");
 				return -1; // error
@@ -698,7 +717,7 @@ int SlIterateArray()
 void SlSkipArray()
 {
 	while (SlIterateArray() != -1) {
-		SlSkipBytes(_next_offs - _sl.reader->GetSize());
+		SlSkipBytes(_next_offs - _sl->reader->GetSize());
 	}
 }
 
@@ -709,18 +728,18 @@ void SlSkipArray()
  */
 void SlSetLength(size_t length)
 {
-	assert(_sl.action == SLA_SAVE);
+	assert(_sl->action == SLA_SAVE);
 
-	switch (_sl.need_length) {
+	switch (_sl->need_length) {
 		case NL_WANTLENGTH:
-			_sl.need_length = NL_NONE;
-			if ((_sl.block_mode == CH_TABLE || _sl.block_mode == CH_SPARSE_TABLE) && _sl.expect_table_header) {
-				_sl.expect_table_header = false;
+			_sl->need_length = NL_NONE;
+			if ((_sl->block_mode == CH_TABLE || _sl->block_mode == CH_SPARSE_TABLE) && _sl->expect_table_header) {
+				_sl->expect_table_header = false;
 				SlWriteArrayLength(length + 1);
 				break;
 			}
 
-			switch (_sl.block_mode) {
+			switch (_sl->block_mode) {
 				case CH_RIFF:
 					/* Ugly encoding of >16M RIFF chunks
 					 * The lower 24 bits are normal
@@ -730,23 +749,23 @@ void SlSetLength(size_t length)
 					break;
 				case CH_TABLE:
 				case CH_ARRAY:
-					assert(_sl.last_array_index <= _sl.array_index);
-					while (++_sl.last_array_index <= _sl.array_index) {
+					assert(_sl->last_array_index <= _sl->array_index);
+					while (++_sl->last_array_index <= _sl->array_index) {
 						SlWriteArrayLength(1);
 					}
 					SlWriteArrayLength(length + 1);
 					break;
 				case CH_SPARSE_TABLE:
 				case CH_SPARSE_ARRAY:
-					SlWriteArrayLength(length + 1 + SlGetArrayLength(_sl.array_index)); // Also include length of sparse index.
-					SlWriteSparseIndex(_sl.array_index);
+					SlWriteArrayLength(length + 1 + SlGetArrayLength(_sl->array_index)); // Also include length of sparse index.
+					SlWriteSparseIndex(_sl->array_index);
 					break;
 				default: NOT_REACHED();
 			}
 			break;
 
 		case NL_CALCLENGTH:
-			_sl.obj_len += (int)length;
+			_sl->obj_len += (int)length;
 			break;
 
 		default: NOT_REACHED();
@@ -763,7 +782,7 @@ static void SlCopyBytes(void *ptr, size_t length)
 {
 	uint8_t *p = (uint8_t *)ptr;
 
-	switch (_sl.action) {
+	switch (_sl->action) {
 		case SLA_LOAD_CHECK:
 		case SLA_LOAD:
 			for (; length != 0; length--) *p++ = SlReadByte();
@@ -778,7 +797,7 @@ static void SlCopyBytes(void *ptr, size_t length)
 /** Get the length of the current object */
 size_t SlGetFieldLength()
 {
-	return _sl.obj_len;
+	return _sl->obj_len;
 }
 
 /**
@@ -840,7 +859,7 @@ void WriteValue(void *ptr, VarType conv, int64_t val)
  */
 static void SlSaveLoadConv(void *ptr, VarType conv)
 {
-	switch (_sl.action) {
+	switch (_sl->action) {
 		case SLA_SAVE: {
 			int64_t x = ReadValue(ptr, conv);
 
@@ -931,7 +950,7 @@ static void SlStdString(void *ptr, VarType conv)
 {
 	std::string *str = reinterpret_cast<std::string *>(ptr);
 
-	switch (_sl.action) {
+	switch (_sl->action) {
 		case SLA_SAVE: {
 			size_t len = str->length();
 			SlWriteArrayLength(len);
@@ -978,14 +997,14 @@ static void SlStdString(void *ptr, VarType conv)
 static void SlCopyInternal(void *object, size_t length, VarType conv)
 {
 	if (GetVarMemType(conv) == SLE_VAR_NULL) {
-		assert(_sl.action != SLA_SAVE); // Use SL_NULL if you want to write null-bytes
+		assert(_sl->action != SLA_SAVE); // Use SL_NULL if you want to write null-bytes
 		SlSkipBytes(length * SlCalcConvFileLen(conv));
 		return;
 	}
 
 	/* NOTICE - handle some buggy stuff, in really old versions everything was saved
 	 * as a byte-type. So detect this, and adjust object size accordingly */
-	if (_sl.action != SLA_SAVE && _sl_version == 0) {
+	if (_sl->action != SLA_SAVE && _sl_version == 0) {
 		/* all objects except difficulty settings */
 		if (conv == SLE_INT16 || conv == SLE_UINT16 || conv == SLE_STRINGID ||
 				conv == SLE_INT32 || conv == SLE_UINT32) {
@@ -1026,13 +1045,13 @@ static void SlCopyInternal(void *object, size_t length, VarType conv)
  */
 void SlCopy(void *object, size_t length, VarType conv)
 {
-	if (_sl.action == SLA_PTRS || _sl.action == SLA_NULL) return;
+	if (_sl->action == SLA_PTRS || _sl->action == SLA_NULL) return;
 
 	/* Automatically calculate the length? */
-	if (_sl.need_length != NL_NONE) {
+	if (_sl->need_length != NL_NONE) {
 		SlSetLength(length * SlCalcConvFileLen(conv));
 		/* Determine length only? */
-		if (_sl.need_length == NL_CALCLENGTH) return;
+		if (_sl->need_length == NL_CALCLENGTH) return;
 	}
 
 	SlCopyInternal(object, length, conv);
@@ -1056,7 +1075,7 @@ static inline size_t SlCalcArrayLen(size_t length, VarType conv)
  */
 static void SlArray(void *array, size_t length, VarType conv)
 {
-	switch (_sl.action) {
+	switch (_sl->action) {
 		case SLA_SAVE:
 			SlWriteArrayLength(length);
 			SlCopyInternal(array, length, conv);
@@ -1102,7 +1121,7 @@ static void SlArray(void *array, size_t length, VarType conv)
  */
 static size_t ReferenceToInt(const void *obj, SLRefType rt)
 {
-	assert(_sl.action == SLA_SAVE);
+	assert(_sl->action == SLA_SAVE);
 
 	if (obj == nullptr) return 0;
 
@@ -1137,7 +1156,7 @@ static void *IntToReference(size_t index, SLRefType rt)
 {
 	static_assert(sizeof(size_t) <= sizeof(void *));
 
-	assert(_sl.action == SLA_PTRS);
+	assert(_sl->action == SLA_PTRS);
 
 	/* After version 4.3 REF_VEHICLE_OLD is saved as REF_VEHICLE,
 	 * and should be loaded like that */
@@ -1211,7 +1230,7 @@ static void *IntToReference(size_t index, SLRefType rt)
  */
 void SlSaveLoadRef(void *ptr, VarType conv)
 {
-	switch (_sl.action) {
+	switch (_sl->action) {
 		case SLA_SAVE:
 			SlWriteUint32((uint32_t)ReferenceToInt(*(void **)ptr, (SLRefType)conv));
 			break;
@@ -1275,7 +1294,7 @@ public:
 
 		SlStorageT *list = static_cast<SlStorageT *>(storage);
 
-		switch (_sl.action) {
+		switch (_sl->action) {
 			case SLA_SAVE:
 				SlWriteArrayLength(list->size());
 
@@ -1334,15 +1353,42 @@ static inline size_t SlCalcRefListLen(const void *list, VarType conv)
 static void SlRefList(void *list, VarType conv)
 {
 	/* Automatically calculate the length? */
-	if (_sl.need_length != NL_NONE) {
+	if (_sl->need_length != NL_NONE) {
 		SlSetLength(SlCalcRefListLen(list, conv));
 		/* Determine length only? */
-		if (_sl.need_length == NL_CALCLENGTH) return;
+		if (_sl->need_length == NL_CALCLENGTH) return;
 	}
 
 	SlStorageHelper<std::list, void *>::SlSaveLoad(list, conv, SL_REF);
 }
 
+/**
+ * Return the size in bytes of a vector of references.
+ * @param vector The std::vector to find the size of.
+ * @param conv VarType type of variable that is used for calculating the size.
+ */
+static inline size_t SlCalcRefVectorLen(const void *vector, VarType conv)
+{
+	return SlStorageHelper<std::vector, void *>::SlCalcLen(vector, conv, SL_REF);
+}
+
+/**
+ * Save/Load a vector of references. It is stored the same way as a list.
+ * @param vector The vector being manipulated.
+ * @param conv VarType type of variable that is used for calculating the size.
+ */
+static void SlRefVector(void *vector, VarType conv)
+{
+	/* Automatically calculate the length? */
+	if (_sl->need_length != NL_NONE) {
+		SlSetLength(SlCalcRefVectorLen(vector, conv));
+		/* Determine length only? */
+		if (_sl->need_length == NL_CALCLENGTH) return;
+	}
+
+	SlStorageHelper<std::vector, void *>::SlSaveLoad(vector, conv, SL_REF);
+}
+
 /**
  * Return the size in bytes of a std::deque.
  * @param deque The std::deque to find the size of
@@ -1480,7 +1526,7 @@ size_t SlCalcObjLength(const void *object, const SaveLoadTable &slt)
 
 size_t SlCalcObjMemberLength(const void *object, const SaveLoad &sld)
 {
-	assert(_sl.action == SLA_SAVE);
+	assert(_sl->action == SLA_SAVE);
 
 	if (!SlIsObjectValidInSavegame(sld)) return 0;
 
@@ -1489,6 +1535,7 @@ size_t SlCalcObjMemberLength(const void *object, const SaveLoad &sld)
 		case SL_REF: return SlCalcRefLen();
 		case SL_ARR: return SlCalcArrayLen(sld.length, sld.conv);
 		case SL_REFLIST: return SlCalcRefListLen(GetVariableAddress(object, sld), sld.conv);
+		case SL_REFVECTOR: return SlCalcRefVectorLen(GetVariableAddress(object, sld), sld.conv);
 		case SL_DEQUE: return SlCalcDequeLen(GetVariableAddress(object, sld), sld.conv);
 		case SL_VECTOR: return SlCalcVectorLen(GetVariableAddress(object, sld), sld.conv);
 		case SL_STDSTR: return SlCalcStdStringLen(GetVariableAddress(object, sld));
@@ -1497,20 +1544,20 @@ size_t SlCalcObjMemberLength(const void *object, const SaveLoad &sld)
 
 		case SL_STRUCT:
 		case SL_STRUCTLIST: {
-			NeedLength old_need_length = _sl.need_length;
-			size_t old_obj_len = _sl.obj_len;
+			NeedLength old_need_length = _sl->need_length;
+			size_t old_obj_len = _sl->obj_len;
 
-			_sl.need_length = NL_CALCLENGTH;
-			_sl.obj_len = 0;
+			_sl->need_length = NL_CALCLENGTH;
+			_sl->obj_len = 0;
 
 			/* Pretend that we are saving to collect the object size. Other
 			 * means are difficult, as we don't know the length of the list we
 			 * are about to store. */
 			sld.handler->Save(const_cast<void *>(object));
-			size_t length = _sl.obj_len;
+			size_t length = _sl->obj_len;
 
-			_sl.obj_len = old_obj_len;
-			_sl.need_length = old_need_length;
+			_sl->obj_len = old_obj_len;
+			_sl->need_length = old_need_length;
 
 			if (sld.cmd == SL_STRUCT) {
 				length += SlGetArrayLength(1);
@@ -1534,6 +1581,7 @@ static bool SlObjectMember(void *object, const SaveLoad &sld)
 		case SL_REF:
 		case SL_ARR:
 		case SL_REFLIST:
+		case SL_REFVECTOR:
 		case SL_DEQUE:
 		case SL_VECTOR:
 		case SL_STDSTR: {
@@ -1544,6 +1592,7 @@ static bool SlObjectMember(void *object, const SaveLoad &sld)
 				case SL_REF: SlSaveLoadRef(ptr, conv); break;
 				case SL_ARR: SlArray(ptr, sld.length, conv); break;
 				case SL_REFLIST: SlRefList(ptr, conv); break;
+				case SL_REFVECTOR: SlRefVector(ptr, conv); break;
 				case SL_DEQUE: SlDeque(ptr, conv); break;
 				case SL_VECTOR: SlVector(ptr, conv); break;
 				case SL_STDSTR: SlStdString(ptr, sld.conv); break;
@@ -1558,7 +1607,7 @@ static bool SlObjectMember(void *object, const SaveLoad &sld)
 		case SL_SAVEBYTE: {
 			void *ptr = GetVariableAddress(object, sld);
 
-			switch (_sl.action) {
+			switch (_sl->action) {
 				case SLA_SAVE: SlWriteByte(*(uint8_t *)ptr); break;
 				case SLA_LOAD_CHECK:
 				case SLA_LOAD:
@@ -1572,7 +1621,7 @@ static bool SlObjectMember(void *object, const SaveLoad &sld)
 		case SL_NULL: {
 			assert(GetVarMemType(sld.conv) == SLE_VAR_NULL);
 
-			switch (_sl.action) {
+			switch (_sl->action) {
 				case SLA_LOAD_CHECK:
 				case SLA_LOAD: SlSkipBytes(SlCalcConvFileLen(sld.conv) * sld.length); break;
 				case SLA_SAVE: for (int i = 0; i < SlCalcConvFileLen(sld.conv) * sld.length; i++) SlWriteByte(0); break;
@@ -1585,7 +1634,7 @@ static bool SlObjectMember(void *object, const SaveLoad &sld)
 
 		case SL_STRUCT:
 		case SL_STRUCTLIST:
-			switch (_sl.action) {
+			switch (_sl->action) {
 				case SLA_SAVE: {
 					if (sld.cmd == SL_STRUCT) {
 						/* Store in the savegame if this struct was written or not. */
@@ -1632,9 +1681,9 @@ static bool SlObjectMember(void *object, const SaveLoad &sld)
 void SlSetStructListLength(size_t length)
 {
 	/* Automatically calculate the length? */
-	if (_sl.need_length != NL_NONE) {
+	if (_sl->need_length != NL_NONE) {
 		SlSetLength(SlGetArrayLength(length));
-		if (_sl.need_length == NL_CALCLENGTH) return;
+		if (_sl->need_length == NL_CALCLENGTH) return;
 	}
 
 	SlWriteArrayLength(length);
@@ -1661,9 +1710,9 @@ size_t SlGetStructListLength(size_t limit)
 void SlObject(void *object, const SaveLoadTable &slt)
 {
 	/* Automatically calculate the length? */
-	if (_sl.need_length != NL_NONE) {
+	if (_sl->need_length != NL_NONE) {
 		SlSetLength(SlCalcObjLength(object, slt));
-		if (_sl.need_length == NL_CALCLENGTH) return;
+		if (_sl->need_length == NL_CALCLENGTH) return;
 	}
 
 	for (auto &sld : slt) {
@@ -1714,9 +1763,9 @@ class SlSkipHandler : public SaveLoadHandler {
 std::vector<SaveLoad> SlTableHeader(const SaveLoadTable &slt)
 {
 	/* You can only use SlTableHeader if you are a CH_TABLE. */
-	assert(_sl.block_mode == CH_TABLE || _sl.block_mode == CH_SPARSE_TABLE);
+	assert(_sl->block_mode == CH_TABLE || _sl->block_mode == CH_SPARSE_TABLE);
 
-	switch (_sl.action) {
+	switch (_sl->action) {
 		case SLA_LOAD_CHECK:
 		case SLA_LOAD: {
 			std::vector<SaveLoad> saveloads;
@@ -1742,7 +1791,7 @@ std::vector<SaveLoad> SlTableHeader(const SaveLoadTable &slt)
 				auto sld_it = key_lookup.find(key);
 				if (sld_it == key_lookup.end()) {
 					/* SLA_LOADCHECK triggers this debug statement a lot and is perfectly normal. */
-					Debug(sl, _sl.action == SLA_LOAD ? 2 : 6, "Field '{}' of type 0x{:02x} not found, skipping", key, type);
+					Debug(sl, _sl->action == SLA_LOAD ? 2 : 6, "Field '{}' of type 0x{:02x} not found, skipping", key, type);
 
 					std::shared_ptr<SaveLoadHandler> handler = nullptr;
 					SaveLoadType saveload_type;
@@ -1792,9 +1841,9 @@ std::vector<SaveLoad> SlTableHeader(const SaveLoadTable &slt)
 
 		case SLA_SAVE: {
 			/* Automatically calculate the length? */
-			if (_sl.need_length != NL_NONE) {
+			if (_sl->need_length != NL_NONE) {
 				SlSetLength(SlCalcTableHeader(slt));
-				if (_sl.need_length == NL_CALCLENGTH) break;
+				if (_sl->need_length == NL_CALCLENGTH) break;
 			}
 
 			for (auto &sld : slt) {
@@ -1818,12 +1867,12 @@ std::vector<SaveLoad> SlTableHeader(const SaveLoadTable &slt)
 				if (!SlIsObjectValidInSavegame(sld)) continue;
 				if (sld.cmd == SL_STRUCTLIST || sld.cmd == SL_STRUCT) {
 					/* SlCalcTableHeader already looks in sub-lists, so avoid the length being added twice. */
-					NeedLength old_need_length = _sl.need_length;
-					_sl.need_length = NL_NONE;
+					NeedLength old_need_length = _sl->need_length;
+					_sl->need_length = NL_NONE;
 
 					SlTableHeader(sld.handler->GetDescription());
 
-					_sl.need_length = old_need_length;
+					_sl->need_length = old_need_length;
 				}
 			}
 
@@ -1851,9 +1900,9 @@ std::vector<SaveLoad> SlTableHeader(const SaveLoadTable &slt)
  */
 std::vector<SaveLoad> SlCompatTableHeader(const SaveLoadTable &slt, const SaveLoadCompatTable &slct)
 {
-	assert(_sl.action == SLA_LOAD || _sl.action == SLA_LOAD_CHECK);
+	assert(_sl->action == SLA_LOAD || _sl->action == SLA_LOAD_CHECK);
 	/* CH_TABLE / CH_SPARSE_TABLE always have a header. */
-	if (_sl.block_mode == CH_TABLE || _sl.block_mode == CH_SPARSE_TABLE) return SlTableHeader(slt);
+	if (_sl->block_mode == CH_TABLE || _sl->block_mode == CH_SPARSE_TABLE) return SlTableHeader(slt);
 
 	std::vector<SaveLoad> saveloads;
 
@@ -1915,31 +1964,31 @@ void SlGlobList(const SaveLoadTable &slt)
  */
 void SlAutolength(AutolengthProc *proc, void *arg)
 {
-	assert(_sl.action == SLA_SAVE);
+	assert(_sl->action == SLA_SAVE);
 
 	/* Tell it to calculate the length */
-	_sl.need_length = NL_CALCLENGTH;
-	_sl.obj_len = 0;
+	_sl->need_length = NL_CALCLENGTH;
+	_sl->obj_len = 0;
 	proc(arg);
 
 	/* Setup length */
-	_sl.need_length = NL_WANTLENGTH;
-	SlSetLength(_sl.obj_len);
+	_sl->need_length = NL_WANTLENGTH;
+	SlSetLength(_sl->obj_len);
 
-	size_t start_pos = _sl.dumper->GetSize();
-	size_t expected_offs = start_pos + _sl.obj_len;
+	size_t start_pos = _sl->dumper->GetSize();
+	size_t expected_offs = start_pos + _sl->obj_len;
 
 	/* And write the stuff */
 	proc(arg);
 
-	if (expected_offs != _sl.dumper->GetSize()) {
-		SlErrorCorruptFmt("Invalid chunk size when writing autolength block, expected {}, got {}", _sl.obj_len, _sl.dumper->GetSize() - start_pos);
+	if (expected_offs != _sl->dumper->GetSize()) {
+		SlErrorCorruptFmt("Invalid chunk size when writing autolength block, expected {}, got {}", _sl->obj_len, _sl->dumper->GetSize() - start_pos);
 	}
 }
 
 void ChunkHandler::LoadCheck(size_t len) const
 {
-	switch (_sl.block_mode) {
+	switch (_sl->block_mode) {
 		case CH_TABLE:
 		case CH_SPARSE_TABLE:
 			SlTableHeader({});
@@ -1962,22 +2011,23 @@ void ChunkHandler::LoadCheck(size_t len) const
  */
 static void SlLoadChunk(const ChunkHandler &ch)
 {
+	TraceScope trace("Load chunk", ch.id);
 	uint8_t m = SlReadByte();
 
-	_sl.block_mode = m & CH_TYPE_MASK;
-	_sl.obj_len = 0;
-	_sl.expect_table_header = (_sl.block_mode == CH_TABLE || _sl.block_mode == CH_SPARSE_TABLE);
+	_sl->block_mode = m & CH_TYPE_MASK;
+	_sl->obj_len = 0;
+	_sl->expect_table_header = (_sl->block_mode == CH_TABLE || _sl->block_mode == CH_SPARSE_TABLE);
 
 	/* The header should always be at the start. Read the length; the
 	 * Load() should as first action process the header. */
-	if (_sl.expect_table_header) {
+	if (_sl->expect_table_header) {
 		SlIterateArray();
 	}
 
-	switch (_sl.block_mode) {
+	switch (_sl->block_mode) {
 		case CH_TABLE:
 		case CH_ARRAY:
-			_sl.array_index = 0;
+			_sl->array_index = 0;
 			ch.Load();
 			if (_next_offs != 0) SlErrorCorrupt("Invalid array length");
 			break;
@@ -1990,13 +2040,13 @@ static void SlLoadChunk(const ChunkHandler &ch)
 			/* Read length */
 			size_t len = (SlReadByte() << 16) | ((m >> 4) << 24);
 			len += SlReadUint16();
-			_sl.obj_len = len;
-			size_t start_pos = _sl.reader->GetSize();
+			_sl->obj_len = len;
+			size_t start_pos = _sl->reader->GetSize();
 			size_t endoffs = start_pos + len;
 			ch.Load();
 
-			if (_sl.reader->GetSize() != endoffs) {
-				SlErrorCorruptFmt("Invalid chunk size in RIFF in {} - expected {}, got {}", ch.GetName(), len, _sl.reader->GetSize() - start_pos);
+			if (_sl->reader->GetSize() != endoffs) {
+				SlErrorCorruptFmt("Invalid chunk size in RIFF in {} - expected {}, got {}", ch.GetName(), len, _sl->reader->GetSize() - start_pos);
 			}
 			break;
 		}
@@ -2005,7 +2055,7 @@ static void SlLoadChunk(const ChunkHandler &ch)
 			break;
 	}
 
-	if (_sl.expect_table_header) SlErrorCorrupt("Table chunk without header");
+	if (_sl->expect_table_header) SlErrorCorrupt("Table chunk without header");
 }
 
 /**
@@ -2017,20 +2067,20 @@ static void SlLoadCheckChunk(const ChunkHandler &ch)
 {
 	uint8_t m = SlReadByte();
 
-	_sl.block_mode = m & CH_TYPE_MASK;
-	_sl.obj_len = 0;
-	_sl.expect_table_header = (_sl.block_mode == CH_TABLE || _sl.block_mode == CH_SPARSE_TABLE);
+	_sl->block_mode = m & CH_TYPE_MASK;
+	_sl->obj_len = 0;
+	_sl->expect_table_header = (_sl->block_mode == CH_TABLE || _sl->block_mode == CH_SPARSE_TABLE);
 
 	/* The header should always be at the start. Read the length; the
 	 * LoadCheck() should as first action process the header. */
-	if (_sl.expect_table_header) {
+	if (_sl->expect_table_header) {
 		SlIterateArray();
 	}
 
-	switch (_sl.block_mode) {
+	switch (_sl->block_mode) {
 		case CH_TABLE:
 		case CH_ARRAY:
-			_sl.array_index = 0;
+			_sl->array_index = 0;
 			ch.LoadCheck();
 			break;
 		case CH_SPARSE_TABLE:
@@ -2041,13 +2091,13 @@ static void SlLoadCheckChunk(const ChunkHandler &ch)
 			/* Read length */
 			size_t len = (SlReadByte() << 16) | ((m >> 4) << 24);
 			len += SlReadUint16();
-			_sl.obj_len = len;
-			size_t start_pos = _sl.reader->GetSize();
+			_sl->obj_len = len;
+			size_t start_pos = _sl->reader->GetSize();
 			size_t endoffs = start_pos + len;
 			ch.LoadCheck(len);
 
-			if (_sl.reader->GetSize() != endoffs) {
-				SlErrorCorruptFmt("Invalid chunk size in RIFF in {} - expected {}, got {}", ch.GetName(), len, _sl.reader->GetSize() - start_pos);
+			if (_sl->reader->GetSize() != endoffs) {
+				SlErrorCorruptFmt("Invalid chunk size in RIFF in {} - expected {}, got {}", ch.GetName(), len, _sl->reader->GetSize() - start_pos);
 			}
 			break;
 		}
@@ -2056,7 +2106,7 @@ static void SlLoadCheckChunk(const ChunkHandler &ch)
 			break;
 	}
 
-	if (_sl.expect_table_header) SlErrorCorrupt("Table chunk without header");
+	if (_sl->expect_table_header) SlErrorCorrupt("Table chunk without header");
 }
 
 /**
@@ -2068,46 +2118,112 @@ static void SlSaveChunk(const ChunkHandler &ch)
 {
 	if (ch.type == CH_READONLY) return;
 
+	TraceScope trace("Save chunk", ch.id);
 	SlWriteUint32(ch.id);
 	Debug(sl, 2, "Saving chunk {}", ch.GetName());
 
-	_sl.block_mode = ch.type;
-	_sl.expect_table_header = (_sl.block_mode == CH_TABLE || _sl.block_mode == CH_SPARSE_TABLE);
+	_sl->block_mode = ch.type;
+	_sl->expect_table_header = (_sl->block_mode == CH_TABLE || _sl->block_mode == CH_SPARSE_TABLE);
 
-	_sl.need_length = (_sl.expect_table_header || _sl.block_mode == CH_RIFF) ? NL_WANTLENGTH : NL_NONE;
+	_sl->need_length = (_sl->expect_table_header || _sl->block_mode == CH_RIFF) ? NL_WANTLENGTH : NL_NONE;
 
-	switch (_sl.block_mode) {
+	switch (_sl->block_mode) {
 		case CH_RIFF:
 			ch.Save();
 			break;
 		case CH_TABLE:
 		case CH_ARRAY:
-			_sl.last_array_index = 0;
-			SlWriteByte(_sl.block_mode);
+			_sl->last_array_index = 0;
+			SlWriteByte(_sl->block_mode);
 			ch.Save();
 			SlWriteArrayLength(0); // Terminate arrays
 			break;
 		case CH_SPARSE_TABLE:
 		case CH_SPARSE_ARRAY:
-			SlWriteByte(_sl.block_mode);
+			SlWriteByte(_sl->block_mode);
 			ch.Save();
 			SlWriteArrayLength(0); // Terminate arrays
 			break;
 		default: NOT_REACHED();
 	}
 
-	if (_sl.expect_table_header) SlErrorCorrupt("Table chunk without header");
+	if (_sl->expect_table_header) SlErrorCorrupt("Table chunk without header");
 }
 
-/** Save all chunks */
+/** A chunk that is being saved on another thread. */
+struct ConcurrentChunkSave {
+	const ChunkHandler *ch;                 ///< The chunk.
+	size_t dump_index;                      ///< Index of the chunk's memory dump in #SaveLoadParams::dumps.
+	std::unique_ptr<SaveLoadParams> params; ///< Parameters for saving the chunk, including its own memory dumper.
+	bool error = false;                     ///< Whether saving the chunk failed.
+	TaskHandle task;                        ///< The task saving the chunk.
+};
+
+/**
+ * Save all chunks.
+ * Chunks that can be saved concurrently are saved into memory dumps of their
+ * own by the workers, while the other chunks are saved here into the dumps in
+ * between. The dumps are written one after another in the order of the chunk
+ * handlers, so the savegame is the same as when saving all chunks here.
+ */
 static void SlSaveChunks()
 {
-	for (auto &ch : ChunkHandlers()) {
-		SlSaveChunk(ch);
+	std::vector<std::unique_ptr<ConcurrentChunkSave>> concurrent;
+	bool use_workers = !_save_without_workers && HasTaskWorkers();
+
+	try {
+		for (auto &ch : ChunkHandlers()) {
+			if (ch.get().type != CH_READONLY) ch.get().PrepareSave();
+		}
+
+		for (auto &ch : ChunkHandlers()) {
+			if (!use_workers || ch.get().type == CH_READONLY || !ch.get().CanSaveConcurrently()) {
+				SlSaveChunk(ch);
+				continue;
+			}
+
+			/* Finish the current dump, and leave room for the chunk's dump after it. */
+			_sl->dumps.push_back(std::move(_sl->dumper));
+			_sl->dumper = std::make_unique<MemoryDumper>();
+
+			auto &save = concurrent.emplace_back(std::make_unique<ConcurrentChunkSave>());
+			save->ch = &ch.get();
+			save->dump_index = _sl->dumps.size();
+			save->params = std::make_unique<SaveLoadParams>();
+			save->params->action = SLA_SAVE;
+			save->params->dumper = std::make_unique<MemoryDumper>();
+			_sl->dumps.emplace_back();
+
+			save->task = SubmitTask(TaskCategory::Savegame, [save = save.get()]() {
+				SaveLoadParams *previous = _sl;
+				_sl = save->params.get();
+				try {
+					SlSaveChunk(*save->ch);
+				} catch (...) {
+					save->error = true;
+				}
+				_sl = previous;
+			});
+		}
+
+		/* Terminator */
+		SlWriteUint32(0);
+		_sl->dumps.push_back(std::move(_sl->dumper));
+	} catch (...) {
+		/* The tasks refer to the chunks, so they must finish before these go out of scope. */
+		for (auto &save : concurrent) save->task.Wait();
+		throw;
 	}
 
-	/* Terminator */
-	SlWriteUint32(0);
+	for (auto &save : concurrent) save->task.Wait();
+	for (auto &save : concurrent) {
+		if (save->error) {
+			_sl->error_str = save->params->error_str;
+			_sl->extra_msg = save->params->extra_msg;
+			throw std::exception();
+		}
+		_sl->dumps[save->dump_index] = std::move(save->params->dumper);
+	}
 }
 
 /**
@@ -2143,26 +2259,34 @@ static void SlLoadCheckChunks()
 	uint32_t id;
 	const ChunkHandler *ch;
 
+	/* Chunks for the preview that have not been read yet; the rest of the savegame is not even decompressed after those. */
+	size_t remaining = std::ranges::count_if(ChunkHandlers(), [](const ChunkHandler &ch) { return ch.HasLoadCheck(); });
+
 	for (id = SlReadUint32(); id != 0; id = SlReadUint32()) {
 		Debug(sl, 2, "Loading chunk {:c}{:c}{:c}{:c}", id >> 24, id >> 16, id >> 8, id);
 
 		ch = SlFindChunkHandler(id);
 		if (ch == nullptr) SlErrorCorrupt("Unknown chunk type");
 		SlLoadCheckChunk(*ch);
+
+		if (ch->HasLoadCheck() && --remaining == 0) {
+			Debug(sl, 2, "Read all chunks needed for the preview");
+			break;
+		}
 	}
 }
 
 /** Fix all pointers (convert index -> pointer) */
 static void SlFixPointers()
 {
-	_sl.action = SLA_PTRS;
+	_sl->action = SLA_PTRS;
 
 	for (const ChunkHandler &ch : ChunkHandlers()) {
 		Debug(sl, 3, "Fixing pointers for {}", ch.GetName());
 		ch.FixPointers();
 	}
 
-	assert(_sl.action == SLA_PTRS);
+	assert(_sl->action == SLA_PTRS);
 }
 
 
@@ -2611,6 +2735,263 @@ struct LZMASaveFilter : SaveFilter {
 
 #endif /* WITH_LIBLZMA */
 
+/********************************************
+ ********** START OF ZSTD CODE **************
+ ********************************************/
+
+#if defined(WITH_ZSTD)
+#include <zstd.h>
+
+/** Filter using Zstandard decompression. */
+struct ZstdLoadFilter : LoadFilter {
+	ZSTD_DCtx *zstd;                      ///< Stream state that we are reading from.
+	ZSTD_inBuffer input;                  ///< The part of the read buffer that has not been decompressed yet.
+	uint8_t fread_buf[MEMORY_CHUNK_SIZE]; ///< Buffer for reading from the file.
+
+	/**
+	 * Initialise this filter.
+	 * @param chain The next filter in this chain.
+	 */
+	ZstdLoadFilter(std::shared_ptr<LoadFilter> chain) : LoadFilter(chain), zstd(ZSTD_createDCtx()), input({this->fread_buf, 0, 0})
+	{
+		if (this->zstd == nullptr) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "cannot initialize decompressor");
+	}
+
+	/** Clean everything up. */
+	~ZstdLoadFilter()
+	{
+		ZSTD_freeDCtx(this->zstd);
+	}
+
+	size_t Read(uint8_t *buf, size_t size) override
+	{
+		ZSTD_outBuffer output = { buf, size, 0 };
+
+		do {
+			/* read more bytes from the file? */
+			if (this->input.pos == this->input.size) {
+				this->input.size = this->chain->Read(this->fread_buf, sizeof(this->fread_buf));
+				this->input.pos = 0;
+			}
+
+			/* decompress the data */
+			size_t previous_pos = output.pos;
+			size_t r = ZSTD_decompressStream(this->zstd, &output, &this->input);
+			if (ZSTD_isError(r)) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "libzstd returned error code");
+
+			/* At the end of the file, and nothing buffered anymore. */
+			if (this->input.size == 0 && output.pos == previous_pos) break;
+		} while (output.pos != output.size);
+
+		return output.pos;
+	}
+};
+
+/** Filter using Zstandard compression, with multiple threads when libzstd supports that. */
+struct ZstdSaveFilter : SaveFilter {
+	ZSTD_CCtx *zstd;                       ///< Stream state that we are writing to.
+	uint8_t fwrite_buf[MEMORY_CHUNK_SIZE]; ///< Buffer for writing to the file.
+
+	/**
+	 * Initialise this filter.
+	 * @param chain             The next filter in this chain.
+	 * @param compression_level The requested level of compression.
+	 */
+	ZstdSaveFilter(std::shared_ptr<SaveFilter> chain, uint8_t compression_level) : SaveFilter(chain), zstd(ZSTD_createCCtx())
+	{
+		if (this->zstd == nullptr || ZSTD_isError(ZSTD_CCtx_setParameter(this->zstd, ZSTD_c_compressionLevel, compression_level))) {
+			SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "cannot initialize compressor");
+		}
+
+		/* As many compression threads as worker threads; a libzstd without thread support refuses, and compresses on this thread. */
+		uint threads = _task_pool_threads != 0 ? _task_pool_threads : std::max(1U, std::thread::hardware_concurrency()) - 1;
+		if (threads > 0) ZSTD_CCtx_setParameter(this->zstd, ZSTD_c_nbWorkers, threads);
+	}
+
+	/** Clean up what we allocated. */
+	~ZstdSaveFilter()
+	{
+		ZSTD_freeCCtx(this->zstd);
+	}
+
+	/**
+	 * Helper loop for writing the data.
+	 * @param p    The bytes to write.
+	 * @param len  Amount of bytes to write.
+	 * @param mode Directive for ZSTD_compressStream2.
+	 */
+	void WriteLoop(uint8_t *p, size_t len, ZSTD_EndDirective mode)
+	{
+		ZSTD_inBuffer input = { p, len, 0 };
+		for (;;) {
+			ZSTD_outBuffer output = { this->fwrite_buf, sizeof(this->fwrite_buf), 0 };
+
+			size_t remaining = ZSTD_compressStream2(this->zstd, &output, &input, mode);
+			if (ZSTD_isError(remaining)) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "libzstd returned error code");
+
+			/* bytes were emitted? */
+			if (output.pos != 0) this->chain->Write(this->fwrite_buf, output.pos);
+
+			/* Continue until all input is taken, and when ending until everything is flushed as well. */
+			if (mode == ZSTD_e_end ? remaining == 0 : input.pos == input.size) break;
+		}
+	}
+
+	void Write(uint8_t *buf, size_t size) override
+	{
+		this->WriteLoop(buf, size, ZSTD_e_continue);
+	}
+
+	void Finish() override
+	{
+		this->WriteLoop(nullptr, 0, ZSTD_e_end);
+		this->chain->Finish();
+	}
+};
+
+#endif /* WITH_ZSTD */
+
+/********************************************
+ ******** START OF READ AHEAD CODE **********
+ ********************************************/
+
+/**
+ * Filter that reads, and thus decompresses, the savegame on a worker thread
+ * into a ring of blocks, while the chunks are loaded from the blocks read so
+ * far. The rest of the chain is only ever used by one thread at a time: the
+ * worker, or the loading thread itself when the worker has not started yet,
+ * so loading never has to wait for a free worker.
+ */
+struct ReadAheadLoadFilter : LoadFilter {
+	static const size_t BLOCK_COUNT = 8; ///< Number of blocks to read ahead.
+
+	/** A block of read data. */
+	struct Block {
+		uint8_t data[MEMORY_CHUNK_SIZE]; ///< The data.
+		size_t size;                     ///< Number of bytes of data; 0 at the end of the savegame.
+	};
+
+	std::unique_ptr<Block[]> blocks;      ///< Ring of blocks.
+	size_t first = 0;                     ///< Index of the block to read from; protected by the mutex.
+	size_t filled = 0;                    ///< Number of blocks with data after the first; protected by the mutex.
+	size_t pos = 0;                       ///< Position in the first block; only used by the loading thread.
+	bool reading = false;                 ///< Whether a thread is reading from the chain; protected by the mutex.
+	bool finished = false;                ///< Whether the end of the savegame has been read; protected by the mutex.
+	bool stop = false;                    ///< Whether the worker must stop; protected by the mutex.
+	bool error = false;                   ///< Whether reading on the worker failed; protected by the mutex.
+	StringID error_str = INVALID_STRING_ID; ///< Error message of the failed read.
+	std::string extra_msg;                ///< Extra error message of the failed read.
+	std::mutex mutex;                     ///< Mutex for the state shared with the worker.
+	std::condition_variable changed;      ///< Signalled when a block is filled or emptied.
+	TaskHandle task;                      ///< Task reading ahead.
+
+	/**
+	 * Initialise this filter and start reading ahead.
+	 * @param chain The next filter in this chain.
+	 */
+	ReadAheadLoadFilter(std::shared_ptr<LoadFilter> chain) : LoadFilter(chain), blocks(std::make_unique<Block[]>(BLOCK_COUNT))
+	{
+		this->task = SubmitTask(TaskCategory::Savegame, [this]() { this->ReadAhead(); });
+	}
+
+	/** Stop reading ahead. */
+	~ReadAheadLoadFilter()
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->stop = true;
+		}
+		this->changed.notify_all();
+		this->task.Wait();
+	}
+
+	/**
+	 * Fill the next block from the chain. Must be called with the mutex locked
+	 * and while no other thread reads from the chain; it is unlocked meanwhile.
+	 * @param lock The lock of the mutex.
+	 */
+	void FillBlock(std::unique_lock<std::mutex> &lock)
+	{
+		Block &block = this->blocks[(this->first + this->filled) % BLOCK_COUNT];
+		this->reading = true;
+		lock.unlock();
+
+		block.size = this->chain->Read(block.data, sizeof(block.data));
+
+		lock.lock();
+		this->reading = false;
+		this->filled++;
+		if (block.size == 0) this->finished = true;
+		this->changed.notify_all();
+	}
+
+	/** Read ahead on the worker till the end of the savegame, or till stopped. */
+	void ReadAhead()
+	{
+		/* Errors on this thread must not touch the state of the loading thread. */
+		SaveLoadParams params{};
+		params.action = SLA_NULL;
+		SaveLoadParams *previous = _sl;
+		_sl = &params;
+
+		std::unique_lock<std::mutex> lock(this->mutex);
+		try {
+			for (;;) {
+				this->changed.wait(lock, [this]() { return this->stop || this->finished || (!this->reading && this->filled < BLOCK_COUNT); });
+				if (this->stop || this->finished) break;
+				this->FillBlock(lock);
+			}
+		} catch (...) {
+			if (!lock.owns_lock()) lock.lock();
+			this->reading = false;
+			this->error = true;
+			this->error_str = params.error_str;
+			this->extra_msg = params.extra_msg;
+			this->changed.notify_all();
+		}
+
+		_sl = previous;
+	}
+
+	size_t Read(uint8_t *buf, size_t size) override
+	{
+		size_t done = 0;
+		std::unique_lock<std::mutex> lock(this->mutex);
+		while (done != size) {
+			this->changed.wait(lock, [this]() { return this->filled != 0 || this->error || !this->reading; });
+			if (this->filled == 0) {
+				if (this->error) SlError(this->error_str, this->extra_msg);
+				/* The worker is not reading, so read the block ourselves. */
+				this->FillBlock(lock);
+				continue;
+			}
+
+			Block &block = this->blocks[this->first];
+			if (block.size == 0) break; // End of the savegame; the block stays, so later reads also end.
+
+			lock.unlock();
+			size_t count = std::min(size - done, block.size - this->pos);
+			memcpy(buf + done, block.data + this->pos, count);
+			done += count;
+			this->pos += count;
+			lock.lock();
+
+			if (this->pos == block.size) {
+				this->pos = 0;
+				this->first = (this->first + 1) % BLOCK_COUNT;
+				this->filled--;
+				this->changed.notify_all();
+			}
+		}
+		return done;
+	}
+
+	void Reset() override
+	{
+		NOT_REACHED();
+	}
+};
+
 /*******************************************
  ************* END OF CODE *****************
  *******************************************/
@@ -2646,6 +3027,14 @@ static const SaveLoadFormat _saveload_formats[] = {
 #else
 	{"zlib",   TO_BE32X('OTTZ'), nullptr,                            nullptr,                            0, 0, 0},
 #endif
+#if defined(WITH_ZSTD)
+	/* Compresses much faster than lzma, also because it compresses on multiple threads, for slightly bigger saves.
+	 * Higher levels are slower; levels above 19 need too much memory to decompress.
+	 * It comes before lzma, so lzma stays the default; clients without libzstd can't load maps of servers saving with zstd. */
+	{"zstd",   TO_BE32X('OTTS'), CreateLoadFilter<ZstdLoadFilter>,   CreateSaveFilter<ZstdSaveFilter>,   1, 3, 19},
+#else
+	{"zstd",   TO_BE32X('OTTS'), nullptr,                            nullptr,                            0, 0, 0},
+#endif
 #if defined(WITH_LIBLZMA)
 	/* Level 2 compression is speed wise as fast as zlib level 6 compression (old default), but results in ~10% smaller saves.
 	 * Higher compression levels are possible, and might improve savegame size by up to 25%, but are also up to 10 times slower.
@@ -2726,10 +3115,11 @@ static void ResetSaveloadData()
  */
 static inline void ClearSaveLoadState()
 {
-	_sl.dumper = nullptr;
-	_sl.sf = nullptr;
-	_sl.reader = nullptr;
-	_sl.lf = nullptr;
+	_sl->dumper = nullptr;
+	_sl->dumps.clear();
+	_sl->sf = nullptr;
+	_sl->reader = nullptr;
+	_sl->lf = nullptr;
 }
 
 /** Update the gui accordingly when starting saving and set locks on saveload. */
@@ -2738,7 +3128,7 @@ static void SaveFileStart()
 	SetMouseCursorBusy(true);
 
 	InvalidateWindowData(WC_STATUS_BAR, 0, SBI_SAVELOAD_START);
-	_sl.saveinprogress = true;
+	_sl->saveinprogress = true;
 }
 
 /** Update the gui accordingly when saving is done and release locks on saveload. */
@@ -2747,7 +3137,7 @@ static void SaveFileDone()
 	SetMouseCursorBusy(false);
 
 	InvalidateWindowData(WC_STATUS_BAR, 0, SBI_SAVELOAD_FINISH);
-	_sl.saveinprogress = false;
+	_sl->saveinprogress = false;
 
 #ifdef __EMSCRIPTEN__
 	EM_ASM(if (window["openttd_syncfs"]) openttd_syncfs());
@@ -2757,20 +3147,20 @@ static void SaveFileDone()
 /** Set the error message from outside of the actual loading/saving of the game (AfterLoadGame and friends) */
 void SetSaveLoadError(StringID str)
 {
-	_sl.error_str = str;
+	_sl->error_str = str;
 }
 
 /** Return the appropriate initial string for an error depending on whether we are saving or loading. */
 StringID GetSaveLoadErrorType()
 {
-	return _sl.action == SLA_SAVE ? STR_ERROR_GAME_SAVE_FAILED : STR_ERROR_GAME_LOAD_FAILED;
+	return _sl->action == SLA_SAVE ? STR_ERROR_GAME_SAVE_FAILED : STR_ERROR_GAME_LOAD_FAILED;
 }
 
 /** Return the description of the error. **/
 StringID GetSaveLoadErrorMessage()
 {
-	SetDParamStr(0, _sl.extra_msg);
-	return _sl.error_str;
+	SetDParamStr(0, _sl->extra_msg);
+	return _sl->error_str;
 }
 
 /** Show a gui message when saving has failed */
@@ -2792,10 +3182,11 @@ static SaveOrLoadResult SaveFileToDisk(bool threaded)
 
 		/* We have written our stuff to memory, now write it to file! */
 		uint32_t hdr[2] = { fmt->tag, TO_BE32(SAVEGAME_VERSION << 16) };
-		_sl.sf->Write((uint8_t*)hdr, sizeof(hdr));
+		_sl->sf->Write((uint8_t*)hdr, sizeof(hdr));
 
-		_sl.sf = fmt->init_write(_sl.sf, compression);
-		_sl.dumper->Flush(_sl.sf);
+		_sl->sf = fmt->init_write(_sl->sf, compression);
+		for (auto &dump : _sl->dumps) dump->Flush(_sl->sf);
+		_sl->sf->Finish();
 
 		ClearSaveLoadState();
 
@@ -2809,7 +3200,7 @@ static SaveOrLoadResult SaveFileToDisk(bool threaded)
 
 		/* We don't want to shout when saving is just
 		 * cancelled due to a client disconnecting. */
-		if (_sl.error_str != STR_NETWORK_ERROR_LOSTCONNECTION) {
+		if (_sl->error_str != STR_NETWORK_ERROR_LOSTCONNECTION) {
 			/* Skip the "colour" character */
 			Debug(sl, 0, "{}", GetString(GetSaveLoadErrorType()).substr(3) + GetString(GetSaveLoadErrorMessage()));
 			asfp = SaveFileError;
@@ -2826,9 +3217,10 @@ static SaveOrLoadResult SaveFileToDisk(bool threaded)
 
 void WaitTillSaved()
 {
-	if (!_save_thread.joinable()) return;
+	if (!_save_task.IsValid()) return;
 
-	_save_thread.join();
+	_save_task.Wait();
+	_save_task = {};
 
 	/* Make sure every other state is handled properly as well. */
 	ProcessAsyncSaveFinish();
@@ -2844,10 +3236,10 @@ void WaitTillSaved()
  */
 static SaveOrLoadResult DoSave(std::shared_ptr<SaveFilter> writer, bool threaded)
 {
-	assert(!_sl.saveinprogress);
+	assert(!_sl->saveinprogress);
 
-	_sl.dumper = std::make_unique<MemoryDumper>();
-	_sl.sf = writer;
+	_sl->dumper = std::make_unique<MemoryDumper>();
+	_sl->sf = writer;
 
 	_sl_version = SAVEGAME_VERSION;
 
@@ -2856,8 +3248,8 @@ static SaveOrLoadResult DoSave(std::shared_ptr<SaveFilter> writer, bool threaded
 
 	SaveFileStart();
 
-	if (!threaded || !StartNewThread(&_save_thread, "ottd:savegame", &SaveFileToDisk, true)) {
-		if (threaded) Debug(sl, 1, "Cannot create savegame thread, reverting to single-threaded mode...");
+	if (!threaded || !HasTaskWorkers()) {
+		if (threaded) Debug(sl, 1, "No worker threads for saving, reverting to single-threaded mode...");
 
 		SaveOrLoadResult result = SaveFileToDisk(false);
 		SaveFileDone();
@@ -2865,9 +3257,70 @@ static SaveOrLoadResult DoSave(std::shared_ptr<SaveFilter> writer, bool threaded
 		return result;
 	}
 
+	_save_task = SubmitTask(TaskCategory::Savegame, []() { SaveFileToDisk(true); });
 	return SL_OK;
 }
 
+/**
+ * Save the game from a forked copy of the game. The copy has the state of
+ * the game frozen at the moment of forking, so the game itself continues
+ * while the copy saves it. Only the thread forking is copied, so the copy
+ * saves without the worker threads.
+ * @param fh The file to save to.
+ * @return #SL_OK if the copy has been started, #SL_ERROR if forking failed.
+ */
+static SaveOrLoadResult DoForkedSave([[maybe_unused]] FILE *fh)
+{
+#ifdef WITH_FORKED_SAVE
+	/* Only this thread exists in the forked copy, so it must not use anything another thread might have locked at the
+	 * moment of the fork: no worker threads, and debug output that does not take the locks of the normal output. */
+	pid_t pid = fork();
+	if (pid == 0) {
+		DebugEnterForkedChild();
+		_save_without_workers = true;
+		SaveOrLoadResult result;
+		try {
+			result = DoSave(std::make_shared<FileWriter>(fh), false);
+		} catch (...) {
+			result = SL_ERROR;
+		}
+		_exit(result == SL_OK ? 0 : 1);
+	}
+
+	fclose(fh);
+	if (pid == -1) {
+		Debug(sl, 0, "Unable to fork for saving: {}", strerror(errno));
+		ClearSaveLoadState();
+		return SL_ERROR;
+	}
+
+	Debug(sl, 2, "Saving in forked process {}", pid);
+	_forked_save_pid = pid;
+	SaveFileStart();
+	return SL_OK;
+#else
+	NOT_REACHED();
+#endif
+}
+
+/** Finish saving once the forked copy of the game is done. */
+static void ProcessForkedSaveFinish()
+{
+#ifdef WITH_FORKED_SAVE
+	if (_forked_save_pid == -1) return;
+
+	int status;
+	if (waitpid(_forked_save_pid, &status, WNOHANG) == 0) return;
+
+	_forked_save_pid = -1;
+	SaveFileDone();
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		Debug(sl, 0, "Forked process failed to save");
+		ShowErrorMessage(STR_ERROR_AUTOSAVE_FAILED, INVALID_STRING_ID, WL_ERROR);
+	}
+#endif
+}
+
 /**
  * Save the game using a (writer) filter.
  * @param writer   The filter to write the savegame to.
@@ -2877,7 +3330,7 @@ static SaveOrLoadResult DoSave(std::shared_ptr<SaveFilter> writer, bool threaded
 SaveOrLoadResult SaveWithFilter(std::shared_ptr<SaveFilter> writer, bool threaded)
 {
 	try {
-		_sl.action = SLA_SAVE;
+		_sl->action = SLA_SAVE;
 		return DoSave(writer, threaded);
 	} catch (...) {
 		ClearSaveLoadState();
@@ -2893,7 +3346,7 @@ SaveOrLoadResult SaveWithFilter(std::shared_ptr<SaveFilter> writer, bool threade
  */
 static SaveOrLoadResult DoLoad(std::shared_ptr<LoadFilter> reader, bool load_check)
 {
-	_sl.lf = reader;
+	_sl->lf = reader;
 
 	if (load_check) {
 		/* Clear previous check data */
@@ -2903,7 +3356,7 @@ static SaveOrLoadResult DoLoad(std::shared_ptr<LoadFilter> reader, bool load_che
 	}
 
 	uint32_t hdr[2];
-	if (_sl.lf->Read((uint8_t*)hdr, sizeof(hdr)) != sizeof(hdr)) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
+	if (_sl->lf->Read((uint8_t*)hdr, sizeof(hdr)) != sizeof(hdr)) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
 
 	/* see if we have any loader for this type. */
 	const SaveLoadFormat *fmt = _saveload_formats;
@@ -2911,7 +3364,7 @@ static SaveOrLoadResult DoLoad(std::shared_ptr<LoadFilter> reader, bool load_che
 		/* No loader found, treat as version 0 and use LZO format */
 		if (fmt == endof(_saveload_formats)) {
 			Debug(sl, 0, "Unknown savegame type, trying to load it as the buggy format");
-			_sl.lf->Reset();
+			_sl->lf->Reset();
 			_sl_version = SL_MIN_VERSION;
 			_sl_minor_version = 0;
 
@@ -2952,8 +3405,9 @@ static SaveOrLoadResult DoLoad(std::shared_ptr<LoadFilter> reader, bool load_che
 		SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, fmt::format("Loader for '{}' is not available.", fmt->name));
 	}
 
-	_sl.lf = fmt->init_load(_sl.lf);
-	_sl.reader = std::make_unique<ReadBuffer>(_sl.lf);
+	_sl->lf = fmt->init_load(_sl->lf);
+	if (HasTaskWorkers()) _sl->lf = std::make_shared<ReadAheadLoadFilter>(_sl->lf);
+	_sl->reader = std::make_unique<ReadBuffer>(_sl->lf);
 	_next_offs = 0;
 
 	if (!load_check) {
@@ -3033,7 +3487,7 @@ static SaveOrLoadResult DoLoad(std::shared_ptr<LoadFilter> reader, bool load_che
 SaveOrLoadResult LoadWithFilter(std::shared_ptr<LoadFilter> reader)
 {
 	try {
-		_sl.action = SLA_LOAD;
+		_sl->action = SLA_LOAD;
 		return DoLoad(reader, false);
 	} catch (...) {
 		ClearSaveLoadState();
@@ -3053,7 +3507,7 @@ SaveOrLoadResult LoadWithFilter(std::shared_ptr<LoadFilter> reader)
 SaveOrLoadResult SaveOrLoad(const std::string &filename, SaveLoadOperation fop, DetailedFileType dft, Subdirectory sb, bool threaded)
 {
 	/* An instance of saving is already active, so don't go saving again */
-	if (_sl.saveinprogress && fop == SLO_SAVE && dft == DFT_GAME_FILE && threaded) {
+	if (_sl->saveinprogress && fop == SLO_SAVE && dft == DFT_GAME_FILE && threaded) {
 		/* if not an autosave, but a user action, show error message */
 		if (!_do_autosave) ShowErrorMessage(STR_ERROR_SAVE_STILL_IN_PROGRESS, INVALID_STRING_ID, WL_ERROR);
 		return SL_OK;
@@ -3088,15 +3542,15 @@ SaveOrLoadResult SaveOrLoad(const std::string &filename, SaveLoadOperation fop,
 		assert(dft == DFT_GAME_FILE);
 		switch (fop) {
 			case SLO_CHECK:
-				_sl.action = SLA_LOAD_CHECK;
+				_sl->action = SLA_LOAD_CHECK;
 				break;
 
 			case SLO_LOAD:
-				_sl.action = SLA_LOAD;
+				_sl->action = SLA_LOAD;
 				break;
 
 			case SLO_SAVE:
-				_sl.action = SLA_SAVE;
+				_sl->action = SLA_SAVE;
 				break;
 
 			default: NOT_REACHED();
@@ -3117,6 +3571,9 @@ SaveOrLoadResult SaveOrLoad(const std::string &filename, SaveLoadOperation fop,
 			Debug(desync, 1, "save: {:08x}; {:02x}; {}", TimerGameEconomy::date, TimerGameEconomy::date_fract, filename);
 			if (!_settings_client.gui.threaded_saves) threaded = false;
 
+#ifdef WITH_FORKED_SAVE
+			if (_forked_autosave && _do_autosave && threaded) return DoForkedSave(fh);
+#endif
 			return DoSave(std::make_shared<FileWriter>(fh), threaded);
 		}
 
@@ -378,6 +378,11 @@ enum SaveLoadVersion : uint16_t {
 	SLV_AI_LOCAL_CONFIG,                    ///< 332  PR#12003 Config of running AI is stored inside Company.
 	SLV_SCRIPT_RANDOMIZER,                  ///< 333  PR#12063 v14.0-RC1 Save script randomizers.
 	SLV_VEHICLE_ECONOMY_AGE,                ///< 334  PR#12141 v14.0 Add vehicle age in economy year, for profit stats minimum age
+	SLV_LINKGRAPH_JOB_FINGERPRINT,          ///< 335  Store the fingerprint of the input of the last link graph job.
+	SLV_LINKGRAPH_POSTPONE_JOIN,            ///< 336  Allow postponing the join of overdue link graph jobs.
+	SLV_TOWN_GROWTH_BACKOFF,                ///< 337  Back off retrying failed town growth.
+	SLV_MAP_ARRAY_ENCODING,                 ///< 338  Run length and delta encoding of the map arrays.
+	SLV_AUTOREPLACE_PER_TICK,               ///< 339  Limit on the number of autoreplaces per tick.
 
 	SL_MAX_VERSION,                         ///< Highest possible saveload version
 };
@@ -457,6 +462,13 @@ struct ChunkHandler {
 	 */
 	virtual void Save() const { NOT_REACHED(); }
 
+	/**
+	 * Prepare saving the chunk. This is called for all chunks on the main
+	 * thread, before any chunk is saved. Chunks that are saved concurrently
+	 * can gather here what may not be done on another thread.
+	 */
+	virtual void PrepareSave() const {}
+
 	/**
 	 * Load the chunk.
 	 * Must be overridden.
@@ -478,6 +490,21 @@ struct ChunkHandler {
 	 */
 	virtual void LoadCheck(size_t len = 0) const;
 
+	/**
+	 * Whether LoadCheck() reads anything for the game preview. Once all chunks
+	 * that do have been read, the rest of the savegame is not needed for it.
+	 * @return True iff LoadCheck() is overridden to read the chunk.
+	 */
+	virtual bool HasLoadCheck() const { return false; }
+
+	/**
+	 * Whether the chunk can be saved on a worker thread, concurrently with the
+	 * other chunks. Only chunks whose Save() just reads the game state, without
+	 * using any global temporaries, may return true.
+	 * @return True iff the chunk can be saved concurrently.
+	 */
+	virtual bool CanSaveConcurrently() const { return false; }
+
 	std::string GetName() const
 	{
 		return std::string()
@@ -690,6 +717,7 @@ enum SaveLoadType : uint8_t {
 
 	SL_SAVEBYTE    = 10, ///< Save (but not load) a byte.
 	SL_NULL        = 11, ///< Save null-bytes and load to nowhere.
+	SL_REFVECTOR   = 12, ///< Save/load a vector of #SL_REF elements.
 };
 
 typedef void *SaveLoadAddrProc(void *base, size_t extra);
@@ -799,6 +827,7 @@ inline constexpr bool SlCheckVarSize(SaveLoadType cmd, VarType type, size_t leng
 		case SL_DEQUE: return sizeof(std::deque<void *>) == size;
 		case SL_VECTOR: return sizeof(std::vector<void *>) == size;
 		case SL_REFLIST: return sizeof(std::list<void *>) == size;
+		case SL_REFVECTOR: return sizeof(std::vector<void *>) == size;
 		case SL_SAVEBYTE: return true;
 		default: NOT_REACHED();
 	}
@@ -934,6 +963,16 @@ inline constexpr bool SlCheckVarSize(SaveLoadType cmd, VarType type, size_t leng
  */
 #define SLE_CONDREFLIST(base, variable, type, from, to) SLE_GENERAL(SL_REFLIST, base, variable, type, 0, from, to, 0)
 
+/**
+ * Storage of a vector of #SL_REF elements in some savegame versions.
+ * @param base     Name of the class or struct containing the vector.
+ * @param variable Name of the variable in the class or struct referenced by \a base.
+ * @param type     Storage of the data in memory and in the savegame.
+ * @param from     First savegame version that has the vector.
+ * @param to       Last savegame version that has the vector.
+ */
+#define SLE_CONDREFVECTOR(base, variable, type, from, to) SLE_GENERAL(SL_REFVECTOR, base, variable, type, 0, from, to, 0)
+
 /**
  * Storage of a deque of #SL_VAR elements in some savegame versions.
  * @param base     Name of the class or struct containing the list.
@@ -1013,6 +1052,14 @@ inline constexpr bool SlCheckVarSize(SaveLoadType cmd, VarType type, size_t leng
  */
 #define SLE_REFLIST(base, variable, type) SLE_CONDREFLIST(base, variable, type, SL_MIN_VERSION, SL_MAX_VERSION)
 
+/**
+ * Storage of a vector of #SL_REF elements in every savegame version.
+ * @param base     Name of the class or struct containing the vector.
+ * @param variable Name of the variable in the class or struct referenced by \a base.
+ * @param type     Storage of the data in memory and in the savegame.
+ */
+#define SLE_REFVECTOR(base, variable, type) SLE_CONDREFVECTOR(base, variable, type, SL_MIN_VERSION, SL_MAX_VERSION)
+
 /**
  * Only write byte during saving; never read it during loading.
  * When using SLE_SAVEBYTE you will have to read this byte before the table
@@ -1101,6 +1148,16 @@ inline constexpr bool SlCheckVarSize(SaveLoadType cmd, VarType type, size_t leng
  */
 #define SLEG_CONDREFLIST(name, variable, type, from, to) SLEG_GENERAL(name, SL_REFLIST, variable, type, 0, from, to, 0)
 
+/**
+ * Storage of a global reference vector in some savegame versions.
+ * @param name     The name of the field.
+ * @param variable Name of the global variable.
+ * @param type     Storage of the data in memory and in the savegame.
+ * @param from     First savegame version that has the vector.
+ * @param to       Last savegame version that has the vector.
+ */
+#define SLEG_CONDREFVECTOR(name, variable, type, from, to) SLEG_GENERAL(name, SL_REFVECTOR, variable, type, 0, from, to, 0)
+
 /**
  * Storage of a global vector of #SL_VAR elements in some savegame versions.
  * @param name     The name of the field.
@@ -1302,5 +1359,6 @@ inline void SlSkipBytes(size_t length)
 
 extern std::string _savegame_format;
 extern bool _do_autosave;
+extern bool _forked_autosave;
 
 #endif /* SAVELOAD_H */
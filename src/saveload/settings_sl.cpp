@@ -203,6 +203,8 @@ struct PATSChunkHandler : ChunkHandler {
 		LoadSettings(settings_table, &_settings_game, _settings_sl_compat);
 	}
 
+	bool HasLoadCheck() const override { return true; }
+
 	void LoadCheck(size_t) const override
 	{
 		LoadSettings(this->GetSettingTable(), &_load_check_data.settings, _settings_sl_compat);
@@ -256,6 +256,7 @@ static const SaveLoad _town_desc[] = {
 	SLE_CONDVAR(Town, growth_rate,           SLE_FILE_U8 | SLE_VAR_I16,  SL_MIN_VERSION, SLV_54),
 	SLE_CONDVAR(Town, growth_rate,           SLE_FILE_I16 | SLE_VAR_U16, SLV_54, SLV_165),
 	SLE_CONDVAR(Town, growth_rate,           SLE_UINT16,                 SLV_165, SL_MAX_VERSION),
+	SLE_CONDVAR(Town, growth_failures,       SLE_UINT8,                  SLV_TOWN_GROWTH_BACKOFF, SL_MAX_VERSION),
 
 	    SLE_VAR(Town, fund_buildings_months, SLE_UINT8),
 	    SLE_VAR(Town, road_build_months,     SLE_UINT8),
@@ -283,6 +284,7 @@ struct CITYChunkHandler : ChunkHandler {
 	void Save() const override
 	{
 		SlTableHeader(_town_desc);
+		SyncTownGrowCounters();
 
 		for (Town *t : Town::Iterate()) {
 			SlSetArrayIndex(t->index);
@@ -0,0 +1,228 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file scan_cache.cpp Cache of the checksums of files found while scanning, kept on disk between games. */
+
+#include "stdafx.h"
+#include "scan_cache.h"
+#include "fileio_func.h"
+#include "string_func.h"
+#include "debug.h"
+#include "core/bitmath_func.hpp"
+
+#include <filesystem>
+#include <mutex>
+#include <sys/stat.h>
+
+#include "safeguards.h"
+
+static const uint32_t SCAN_CACHE_MAGIC = 0x43534F53;  ///< Magic at the start of the scan cache file, "SOSC".
+static const uint32_t SCAN_CACHE_VERSION = 2;         ///< Version of the format of the scan cache file; bump it when the format changes.
+static const char * const SCAN_CACHE_FILENAME = "scan.cache"; ///< Name of the scan cache file in the cache directory.
+
+/** What is known about a part of a file, and what the file looked like at that moment. */
+struct ScanCacheEntry {
+	ScanCacheStamp stamp;      ///< What the file looked like.
+	std::vector<uint8_t> data; ///< What is known about it.
+};
+
+static std::mutex _scan_cache_mutex;                          ///< Lock for the scan cache, files are scanned on several threads.
+static std::map<std::string, ScanCacheEntry> _scan_cache;     ///< The cached data, by kind and name of the file.
+static bool _scan_cache_loaded = false;                       ///< Whether the cache file has been read.
+static bool _scan_cache_dirty = false;                        ///< Whether the cache has changed since it was read or written.
+
+/**
+ * Record what an opened file looks like on disk.
+ * @param f      The file, positioned at the start of the data of interest.
+ * @param length Number of bytes of interest.
+ * @return True if the file could be examined.
+ */
+bool ScanCacheStamp::Stamp(FILE *f, size_t length)
+{
+	long offset = ftell(f);
+#if defined(_WIN32)
+	struct _stat64 st;
+	if (offset < 0 || _fstat64(_fileno(f), &st) != 0) return false;
+#else
+	struct stat st;
+	if (offset < 0 || fstat(fileno(f), &st) != 0) return false;
+#endif
+	this->file_size = st.st_size;
+	this->mtime = st.st_mtime;
+	this->offset = offset;
+	this->length = length;
+	return true;
+}
+
+/** Read the cache file, if there is a valid one. */
+static void LoadScanCache()
+{
+	_scan_cache_loaded = true;
+
+	std::string cache_dir = FioFindDirectory(CACHE_DIR);
+	if (cache_dir.empty()) return;
+
+	size_t size;
+	FILE *f = FioFOpenFile(cache_dir + SCAN_CACHE_FILENAME, "rb", NO_DIRECTORY, &size);
+	if (f == nullptr) return;
+
+	std::vector<uint8_t> buf(size);
+	bool read = fread(buf.data(), 1, size, f) == size;
+	fclose(f);
+	if (!read) return;
+
+	const uint8_t *p = buf.data();
+	const uint8_t *end = p + size;
+	auto read_bytes = [&p](uint n) {
+		uint64_t v = 0;
+		for (uint i = 0; i < n; i++) v |= (uint64_t)*p++ << (i * 8);
+		return v;
+	};
+
+	if (size < 12 || read_bytes(4) != SCAN_CACHE_MAGIC || read_bytes(4) != SCAN_CACHE_VERSION) return;
+	uint32_t count = (uint32_t)read_bytes(4);
+
+	std::map<std::string, ScanCacheEntry> entries;
+	for (uint32_t i = 0; i < count; i++) {
+		if (end - p < 2) return;
+		size_t key_length = (size_t)read_bytes(2);
+		if ((size_t)(end - p) < key_length + 4 * 8 + 4) return;
+
+		std::string key(reinterpret_cast<const char *>(p), key_length);
+		p += key_length;
+
+		ScanCacheEntry &entry = entries[key];
+		entry.stamp.file_size = read_bytes(8);
+		entry.stamp.mtime = (int64_t)read_bytes(8);
+		entry.stamp.offset = read_bytes(8);
+		entry.stamp.length = read_bytes(8);
+		size_t data_length = (size_t)read_bytes(4);
+		if ((size_t)(end - p) < data_length) return;
+		entry.data.assign(p, p + data_length);
+		p += data_length;
+	}
+
+	_scan_cache = std::move(entries);
+	Debug(misc, 3, "Loaded {} entries from the scan cache", _scan_cache.size());
+}
+
+/**
+ * Write the scan cache file, when something has been added since it was read.
+ */
+void SaveScanCache()
+{
+	std::lock_guard<std::mutex> lock(_scan_cache_mutex);
+	if (!_scan_cache_dirty) return;
+	_scan_cache_dirty = false;
+
+	std::string cache_dir = FioFindDirectory(CACHE_DIR);
+	if (cache_dir.empty()) return;
+	std::string cache_file = cache_dir + SCAN_CACHE_FILENAME;
+
+	std::vector<uint8_t> buf;
+	auto write_bytes = [&buf](uint64_t v, uint n) {
+		for (uint i = 0; i < n; i++) buf.push_back(GB(v, i * 8, 8));
+	};
+
+	write_bytes(SCAN_CACHE_MAGIC, 4);
+	write_bytes(SCAN_CACHE_VERSION, 4);
+	write_bytes(_scan_cache.size(), 4);
+	for (const auto &[key, entry] : _scan_cache) {
+		write_bytes(key.size(), 2);
+		buf.insert(buf.end(), key.begin(), key.end());
+		write_bytes(entry.stamp.file_size, 8);
+		write_bytes(entry.stamp.mtime, 8);
+		write_bytes(entry.stamp.offset, 8);
+		write_bytes(entry.stamp.length, 8);
+		write_bytes(entry.data.size(), 4);
+		buf.insert(buf.end(), entry.data.begin(), entry.data.end());
+	}
+
+	/* Write to a temporary file first, so a concurrently started game never reads half a cache file. */
+	std::string tmp_file = cache_file + ".tmp";
+	FILE *f = FioFOpenFile(tmp_file, "wb", NO_DIRECTORY);
+	if (f == nullptr) return;
+	bool written = fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+	fclose(f);
+
+	std::error_code error_code;
+	if (written) std::filesystem::rename(OTTD2FS(tmp_file), OTTD2FS(cache_file), error_code);
+	if (!written || error_code) {
+		Debug(misc, 1, "Could not write scan cache file '{}'", cache_file);
+		std::filesystem::remove(OTTD2FS(tmp_file), error_code);
+	}
+}
+
+/**
+ * Look up what is known about a file, as long as the file did not change.
+ * @param key   What is looked up about which file.
+ * @param stamp What the file looks like now.
+ * @param[out] data The cached data.
+ * @return True iff there is cached data for the file as it is now.
+ */
+bool ScanCacheLookup(const std::string &key, const ScanCacheStamp &stamp, std::vector<uint8_t> &data)
+{
+	std::lock_guard<std::mutex> lock(_scan_cache_mutex);
+	if (!_scan_cache_loaded) LoadScanCache();
+
+	auto it = _scan_cache.find(key);
+	if (it == _scan_cache.end() || it->second.stamp != stamp) return false;
+	data = it->second.data;
+	return true;
+}
+
+/**
+ * Remember something about a file, until the file changes.
+ * @param key   What is stored about which file.
+ * @param stamp What the file looked like when the data was determined.
+ * @param data  The data to remember.
+ */
+void ScanCacheStore(const std::string &key, const ScanCacheStamp &stamp, std::vector<uint8_t> &&data)
+{
+	std::lock_guard<std::mutex> lock(_scan_cache_mutex);
+	_scan_cache[key] = { stamp, std::move(data) };
+	_scan_cache_dirty = true;
+}
+
+/**
+ * Calculate the MD5 checksum of the next bytes of an opened file.
+ * The checksum is remembered, also between games, together with the size and
+ * modification time of the file on disk. As long as those do not change, the
+ * remembered checksum is returned without reading the file.
+ * @param f        The file, positioned at the start of the data to checksum. It is left at an unspecified position.
+ * @param size     Number of bytes to checksum.
+ * @param filename Name the file was opened with.
+ * @param subdir   Sub directory the file was opened from.
+ * @return The checksum of the data.
+ */
+MD5Hash CalcFileMD5(FILE *f, size_t size, const std::string &filename, Subdirectory subdir)
+{
+	MD5Hash digest;
+	std::string key = fmt::format("md5:{}:{}", (int)subdir, filename);
+	ScanCacheStamp stamp;
+	bool stamped = stamp.Stamp(f, size);
+
+	std::vector<uint8_t> data;
+	if (stamped && ScanCacheLookup(key, stamp, data) && data.size() == digest.size()) {
+		std::copy(data.begin(), data.end(), digest.begin());
+		return digest;
+	}
+
+	Md5 checksum;
+	uint8_t buffer[1024];
+	size_t len;
+	while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, f)) != 0 && size != 0) {
+		size -= len;
+		checksum.Append(buffer, len);
+	}
+	checksum.Finish(digest);
+
+	/* Only remember checksums of data that has been read completely. */
+	if (stamped && size == 0) ScanCacheStore(key, stamp, std::vector<uint8_t>(digest.begin(), digest.end()));
+
+	return digest;
+}
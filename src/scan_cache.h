@@ -0,0 +1,33 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file scan_cache.h Functions to remember what was learnt about files while scanning them. */
+
+#ifndef SCAN_CACHE_H
+#define SCAN_CACHE_H
+
+#include "fileio_type.h"
+#include "3rdparty/md5/md5.h"
+
+/** What a file on disk looked like when something about it was determined. */
+struct ScanCacheStamp {
+	uint64_t file_size = 0; ///< Size of the file on disk, which is the tar for files in a tar.
+	int64_t mtime = 0;      ///< Modification time of the file on disk.
+	uint64_t offset = 0;    ///< Position in the file on disk the data of interest starts at.
+	uint64_t length = 0;    ///< Number of bytes of interest.
+
+	bool Stamp(FILE *f, size_t length);
+
+	bool operator==(const ScanCacheStamp &other) const = default;
+};
+
+bool ScanCacheLookup(const std::string &key, const ScanCacheStamp &stamp, std::vector<uint8_t> &data);
+void ScanCacheStore(const std::string &key, const ScanCacheStamp &stamp, std::vector<uint8_t> &&data);
+MD5Hash CalcFileMD5(FILE *f, size_t size, const std::string &filename, Subdirectory subdir);
+void SaveScanCache();
+
+#endif /* SCAN_CACHE_H */
@@ -29,6 +29,8 @@
 #include "landscape.h"
 #include "video/video_driver.hpp"
 #include "smallmap_gui.h"
+#include "spritecache.h"
+#include "thread.h"
 
 #include "table/strings.h"
 
@@ -373,30 +375,85 @@ static bool MakePNGImage(const char *name, ScreenshotCallback *callb, void *user
 	/* use by default 64k temp memory */
 	maxlines = Clamp(65536 / w, 16, 128);
 
-	/* now generate the bitmap bits */
-	void *buff = CallocT<uint8_t>(static_cast<size_t>(w) * maxlines * bpp); // by default generate 128 lines at a time.
+	/* Generate the next lines while the previous ones are compressed and written by another thread.
+	 * A buffer holds 'filled' lines that still have to be written, or none when it can be generated into. */
+	std::vector<uint8_t> buffers[2];
+	uint filled[2] = { 0, 0 };
+	bool failed = false;
+	std::mutex lock;
+	std::condition_variable cv;
+	for (auto &buffer : buffers) buffer.resize(static_cast<size_t>(w) * maxlines * bpp);
+
+	auto write_lines = [&]() {
+		/* libpng reports errors by a long jump, which has to end on this thread. */
+		if (setjmp(png_jmpbuf(png_ptr))) {
+			std::lock_guard<std::mutex> guard(lock);
+			failed = true;
+			cv.notify_one();
+			return;
+		}
 
-	y = 0;
-	do {
-		/* determine # lines to write */
-		n = std::min(h - y, maxlines);
+		for (uint written = 0, b = 0; written != h; b ^= 1) {
+			uint lines;
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				cv.wait(guard, [&]() { return filled[b] != 0; });
+				lines = filled[b];
+			}
+			for (uint line = 0; line != lines; line++) {
+				png_write_row(png_ptr, buffers[b].data() + static_cast<size_t>(line) * w * bpp);
+			}
+			written += lines;
 
-		/* render the pixels into the buffer */
-		callb(userdata, buff, y, w, n);
-		y += n;
+			std::lock_guard<std::mutex> guard(lock);
+			filled[b] = 0;
+			cv.notify_one();
+		}
+		png_write_end(png_ptr, info_ptr);
+	};
+
+	std::thread writer;
+	if (StartNewThread(&writer, "ottd:screenshot", std::move(write_lines))) {
+		y = 0;
+		for (uint b = 0; y != h; b ^= 1) {
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				cv.wait(guard, [&]() { return filled[b] == 0 || failed; });
+				if (failed) break;
+			}
 
-		/* write them to png */
-		for (i = 0; i != n; i++) {
-			png_write_row(png_ptr, (png_bytep)buff + i * w * bpp);
+			/* determine # lines to write, and render the pixels into the buffer */
+			n = std::min(h - y, maxlines);
+			callb(userdata, buffers[b].data(), y, w, n);
+			y += n;
+
+			std::lock_guard<std::mutex> guard(lock);
+			filled[b] = n;
+			cv.notify_one();
 		}
-	} while (y != h);
+		writer.join();
+	} else {
+		y = 0;
+		do {
+			/* determine # lines to write */
+			n = std::min(h - y, maxlines);
+
+			/* render the pixels into the buffer */
+			callb(userdata, buffers[0].data(), y, w, n);
+			y += n;
+
+			/* write them to png */
+			for (i = 0; i != n; i++) {
+				png_write_row(png_ptr, buffers[0].data() + static_cast<size_t>(i) * w * bpp);
+			}
+		} while (y != h);
 
-	png_write_end(png_ptr, info_ptr);
-	png_destroy_write_struct(&png_ptr, &info_ptr);
+		png_write_end(png_ptr, info_ptr);
+	}
 
-	free(buff);
+	png_destroy_write_struct(&png_ptr, &info_ptr);
 	fclose(f);
-	return true;
+	return !failed;
 }
 #endif /* WITH_PNG */
 
@@ -908,7 +965,10 @@ static bool RealMakeScreenshot(ScreenshotType t, std::string name, uint32_t widt
 		/* First draw the dirty parts of the screen and only then change the name
 		 * of the screenshot. This way the screenshot will always show the name
 		 * of the previous screenshot in the 'successful' message instead of the
-		 * name of the new screenshot (or an empty name). */
+		 * name of the new screenshot (or an empty name).
+		 * Screenshots never show placeholders of sprites that are still being decoded. */
+		AutoRestoreBackup async_backup(_async_sprite_decoding, false);
+		WaitForAsyncSprites();
 		SetScreenshotWindowVisibility(true);
 		UndrawMouseCursor();
 		DrawDirtyBlocks();
@@ -993,24 +1053,26 @@ bool MakeScreenshot(ScreenshotType t, std::string name, uint32_t width, uint32_t
 }
 
 
+/**
+ * Callback for generating a minimap screenshot.
+ * The small map colours are palette colours, so the image is written palette-indexed;
+ * that way every tile is a single byte, and no palette lookups are needed per pixel.
+ * @param buf   Destination buffer.
+ * @param y     Line number of the first line to write.
+ * @param pitch Number of pixels between the start of two lines (1 byte for each pixel).
+ * @param n     Number of lines to write.
+ * @see ScreenshotCallback
+ */
 static void MinimapScreenCallback(void *, void *buf, uint y, uint pitch, uint n)
 {
-	uint32_t *ubuf = (uint32_t *)buf;
-	uint num = (pitch * n);
-	for (uint i = 0; i < num; i++) {
-		uint row = y + (int)(i / pitch);
-		uint col = (Map::SizeX() - 1) - (i % pitch);
-
-		TileIndex tile = TileXY(col, row);
-		uint8_t val = GetSmallMapOwnerPixels(tile, GetTileType(tile), IncludeHeightmap::Never) & 0xFF;
-
-		uint32_t colour_buf = 0;
-		colour_buf  = (_cur_palette.palette[val].b << 0);
-		colour_buf |= (_cur_palette.palette[val].g << 8);
-		colour_buf |= (_cur_palette.palette[val].r << 16);
-
-		*ubuf = colour_buf;
-		ubuf++;   // Skip alpha
+	uint8_t *ubuf = (uint8_t *)buf;
+	for (uint row = y; row < y + n; row++, ubuf += pitch) {
+		/* The map is drawn mirrored in the x direction, so walk each row backwards. */
+		uint8_t *dst = ubuf;
+		for (uint col = Map::SizeX(); col-- > 0;) {
+			TileIndex tile = TileXY(col, row);
+			*dst++ = GetSmallMapOwnerPixels(tile, GetTileType(tile), IncludeHeightmap::Never) & 0xFF;
+		}
 	}
 }
 
@@ -1020,5 +1082,5 @@ static void MinimapScreenCallback(void *, void *buf, uint y, uint pitch, uint n)
 bool MakeMinimapWorldScreenshot()
 {
 	const ScreenshotFormat *sf = _screenshot_formats + _cur_screenshot_format;
-	return sf->proc(MakeScreenshotName(SCREENSHOT_NAME, sf->extension), MinimapScreenCallback, nullptr, Map::SizeX(), Map::SizeY(), 32, _cur_palette.palette);
+	return sf->proc(MakeScreenshotName(SCREENSHOT_NAME, sf->extension), MinimapScreenCallback, nullptr, Map::SizeX(), Map::SizeY(), 8, _cur_palette.palette);
 }
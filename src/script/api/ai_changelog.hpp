@@ -17,6 +17,16 @@
  *
  * This version is not yet released. The following changes are not set in stone yet.
  *
+ * API additions:
+ * \li AITileList::ValuateBuildable
+ * \li AITileList::ValuateSlope
+ * \li AITileList::ValuateDistanceManhattanToTile
+ * \li AITileList::ValuateDistanceSquareToTile
+ * \li AITileList::ValuateCargoAcceptance
+ * \li AIVehicleList::ValuateProfitThisYear
+ * \li AIVehicleList::ValuateProfitLastYear
+ * \li AIVehicleList::ValuateAge
+ *
  * \b 14.0
  *
  * API additions:
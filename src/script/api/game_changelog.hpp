@@ -17,6 +17,21 @@
  *
  * This version is not yet released. The following changes are not set in stone yet.
  *
+ * API additions:
+ * \li GSTileList::ValuateBuildable
+ * \li GSTileList::ValuateSlope
+ * \li GSTileList::ValuateDistanceManhattanToTile
+ * \li GSTileList::ValuateDistanceSquareToTile
+ * \li GSTileList::ValuateCargoAcceptance
+ * \li GSVehicleList::ValuateProfitThisYear
+ * \li GSVehicleList::ValuateProfitLastYear
+ * \li GSVehicleList::ValuateAge
+ *
+ * Other changes:
+ * \li GSGoal::SetText, GSGoal::SetProgress, GSLeagueTable::UpdateElementData, GSLeagueTable::UpdateElementScore,
+ *     GSStoryPage::SetTitle, GSTown::SetText and GSIndustry::SetText return true without executing a command
+ *     when nothing would change, unless in GSAsyncMode.
+ *
  * \b 14.0
  *
  * API additions:
@@ -87,6 +87,8 @@
 	std::string text = goal->GetEncodedText();
 	EnforcePreconditionEncodedText(false, text);
 
+	if (::Goal::Get(goal_id)->text == text && ScriptObject::SkipUnchangedCommand()) return true;
+
 	return ScriptObject::Command<CMD_SET_GOAL_TEXT>::Do(goal_id, text);
 }
 
@@ -97,7 +99,10 @@
 	EnforcePrecondition(false, IsValidGoal(goal_id));
 	EnforceDeityMode(false);
 
-	return ScriptObject::Command<CMD_SET_GOAL_PROGRESS>::Do(goal_id, progress != nullptr ? progress->GetEncodedText() : std::string{});
+	std::string text = progress != nullptr ? progress->GetEncodedText() : std::string{};
+	if (::Goal::Get(goal_id)->progress == text && ScriptObject::SkipUnchangedCommand()) return true;
+
+	return ScriptObject::Command<CMD_SET_GOAL_PROGRESS>::Do(goal_id, text);
 }
 
 /* static */ bool ScriptGoal::SetCompleted(GoalID goal_id, bool completed)
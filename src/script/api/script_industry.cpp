@@ -63,7 +63,10 @@
 	EnforceDeityMode(false);
 	EnforcePrecondition(false, IsValidIndustry(industry_id));
 
-	return ScriptObject::Command<CMD_INDUSTRY_SET_TEXT>::Do(industry_id, text != nullptr ? text->GetEncodedText() : std::string{});
+	std::string encoded_text = text != nullptr ? text->GetEncodedText() : std::string{};
+	if (::Industry::Get(industry_id)->text == encoded_text && ScriptObject::SkipUnchangedCommand()) return true;
+
+	return ScriptObject::Command<CMD_INDUSTRY_SET_TEXT>::Do(industry_id, encoded_text);
 }
 
 /* static */ ScriptIndustry::CargoAcceptState ScriptIndustry::IsCargoAccepted(IndustryID industry_id, CargoID cargo_id)
@@ -95,6 +95,12 @@
 
 	EnforcePrecondition(false, IsValidLink(Link((::LinkType)link_type, link_target)));
 
+	const ::LeagueTableElement *lte = ::LeagueTableElement::Get(element);
+	if (lte->company == c && lte->text == encoded_text && lte->link.type == (::LinkType)link_type && lte->link.target == (::LinkTargetID)link_target &&
+			ScriptObject::SkipUnchangedCommand()) {
+		return true;
+	}
+
 	return ScriptObject::Command<CMD_UPDATE_LEAGUE_TABLE_ELEMENT_DATA>::Do(element, c, encoded_text, (::LinkType)link_type, (::LinkTargetID)link_target);
 }
 
@@ -109,6 +115,9 @@
 	std::string encoded_score = score->GetEncodedText();
 	EnforcePreconditionEncodedText(false, encoded_score);
 
+	const ::LeagueTableElement *lte = ::LeagueTableElement::Get(element);
+	if (lte->rating == rating && lte->score == encoded_score && ScriptObject::SkipUnchangedCommand()) return true;
+
 	return ScriptObject::Command<CMD_UPDATE_LEAGUE_TABLE_ELEMENT_SCORE>::Do(element, rating, encoded_score);
 }
 
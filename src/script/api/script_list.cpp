@@ -15,412 +15,358 @@
 #include "../../safeguards.h"
 
 /**
- * Base class for any ScriptList sorter.
+ * Iterator over a ScriptList in the order of its sorter. It remembers the next
+ * item and its value instead of a position in the list, and searches for the
+ * item after that when needed. So it stays valid whatever happens to the list.
  */
 class ScriptListSorter {
-protected:
-	ScriptList *list;       ///< The list that's being sorted.
-	bool has_no_more_items; ///< Whether we have more items to iterate over.
-	SQInteger item_next;    ///< The next item we will show.
-
-public:
-	/**
-	 * Virtual dtor, needed to mute warnings.
-	 */
-	virtual ~ScriptListSorter() = default;
-
-	/**
-	 * Get the first item of the sorter.
-	 */
-	virtual SQInteger Begin() = 0;
-
-	/**
-	 * Stop iterating a sorter.
-	 */
-	virtual void End() = 0;
-
-	/**
-	 * Get the next item of the sorter.
-	 */
-	virtual SQInteger Next() = 0;
+private:
+	ScriptList *list;           ///< The list that's being sorted.
+	bool by_value;              ///< Whether we sort by value, otherwise by item.
+	bool ascending;             ///< Whether we sort ascending.
+	bool has_no_more_items;     ///< Whether we have more items to iterate over.
+	bool has_next;              ///< Whether there is a next item.
+	ScriptList::ScriptListValue next; ///< The value and the next item we will show.
 
 	/**
-	 * See if the sorter has reached the end.
+	 * Find the next item, and store that information.
+	 * @param first Whether to find the first item of the list.
 	 */
-	bool IsEnd()
+	void FindNext(bool first = false)
 	{
-		return this->list->buckets.empty() || this->has_no_more_items;
+		if (this->by_value) {
+			this->has_next = this->list->FindByValue(this->next, this->ascending, first);
+		} else {
+			this->has_next = this->list->FindByItem(this->next.second, this->ascending, first);
+		}
 	}
 
 	/**
-	 * Callback from the list if an item gets removed.
-	 */
-	virtual void Remove(SQInteger item) = 0;
-
-	/**
-	 * Attach the sorter to a new list. This assumes the content of the old list has been moved to
-	 * the new list, too, so that we don't have to invalidate any iterators. Note that std::swap
-	 * doesn't invalidate iterators on lists and maps, so that should be safe.
-	 * @param target New list to attach to.
+	 * Go to the next item.
+	 * @return The item that was next.
 	 */
-	virtual void Retarget(ScriptList *new_list)
+	SQInteger Advance()
 	{
-		this->list = new_list;
+		SQInteger item_current = this->next.second;
+		this->FindNext();
+		return item_current;
 	}
-};
-
-/**
- * Sort by value, ascending.
- */
-class ScriptListSorterValueAscending : public ScriptListSorter {
-private:
-	ScriptList::ScriptListBucket::iterator bucket_iter;    ///< The iterator over the list to find the buckets.
-	ScriptList::ScriptItemList *bucket_list;               ///< The current bucket list we're iterator over.
-	ScriptList::ScriptItemList::iterator bucket_list_iter; ///< The iterator over the bucket list.
 
 public:
 	/**
 	 * Create a new sorter.
 	 * @param list The list to sort.
+	 * @param by_value Whether to sort by value, otherwise by item.
+	 * @param ascending Whether to sort ascending.
 	 */
-	ScriptListSorterValueAscending(ScriptList *list)
+	ScriptListSorter(ScriptList *list, bool by_value, bool ascending) : list(list), by_value(by_value), ascending(ascending)
 	{
-		this->list = list;
 		this->End();
 	}
 
-	SQInteger Begin() override
+	/**
+	 * Get the first item of the sorter.
+	 */
+	SQInteger Begin()
 	{
-		if (this->list->buckets.empty()) return 0;
+		this->FindNext(true);
+		if (!this->has_next) return 0;
 		this->has_no_more_items = false;
 
-		this->bucket_iter = this->list->buckets.begin();
-		this->bucket_list = &(*this->bucket_iter).second;
-		this->bucket_list_iter = this->bucket_list->begin();
-		this->item_next = *this->bucket_list_iter;
-
-		SQInteger item_current = this->item_next;
-		FindNext();
-		return item_current;
+		return this->Advance();
 	}
 
-	void End() override
+	/**
+	 * Stop iterating a sorter.
+	 */
+	void End()
 	{
-		this->bucket_list = nullptr;
 		this->has_no_more_items = true;
-		this->item_next = 0;
+		this->has_next = false;
+		this->next = {0, 0};
 	}
 
 	/**
-	 * Find the next item, and store that information.
+	 * Get the next item of the sorter.
 	 */
-	void FindNext()
-	{
-		if (this->bucket_list == nullptr) {
-			this->has_no_more_items = true;
-			return;
-		}
-
-		this->bucket_list_iter++;
-		if (this->bucket_list_iter == this->bucket_list->end()) {
-			this->bucket_iter++;
-			if (this->bucket_iter == this->list->buckets.end()) {
-				this->bucket_list = nullptr;
-				return;
-			}
-			this->bucket_list = &(*this->bucket_iter).second;
-			this->bucket_list_iter = this->bucket_list->begin();
-		}
-		this->item_next = *this->bucket_list_iter;
-	}
-
-	SQInteger Next() override
+	SQInteger Next()
 	{
 		if (this->IsEnd()) return 0;
 
-		SQInteger item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
+		/* Bulk operations do not tell us about removed or changed items. */
+		if (this->has_next && (this->by_value ? !this->list->IsCurrentValue(this->next) : !this->list->HasItem(this->next.second))) this->FindNext();
 
-	void Remove(SQInteger item) override
-	{
-		if (this->IsEnd()) return;
-
-		/* If we remove the 'next' item, skip to the next */
-		if (item == this->item_next) {
-			FindNext();
-			return;
+		if (!this->has_next) {
+			this->has_no_more_items = true;
+			return 0;
 		}
+		return this->Advance();
 	}
-};
-
-/**
- * Sort by value, descending.
- */
-class ScriptListSorterValueDescending : public ScriptListSorter {
-private:
-	/* Note: We cannot use reverse_iterator.
-	 *       The iterators must only be invalidated when the element they are pointing to is removed.
-	 *       This only holds for forward iterators. */
-	ScriptList::ScriptListBucket::iterator bucket_iter;    ///< The iterator over the list to find the buckets.
-	ScriptList::ScriptItemList *bucket_list;               ///< The current bucket list we're iterator over.
-	ScriptList::ScriptItemList::iterator bucket_list_iter; ///< The iterator over the bucket list.
 
-public:
 	/**
-	 * Create a new sorter.
-	 * @param list The list to sort.
+	 * See if the sorter has reached the end.
 	 */
-	ScriptListSorterValueDescending(ScriptList *list)
+	bool IsEnd()
 	{
-		this->list = list;
-		this->End();
+		return this->list->IsEmpty() || this->has_no_more_items;
 	}
 
-	SQInteger Begin() override
+	/**
+	 * Callback from the list if an item gets removed or its value changes.
+	 * @param item The item.
+	 */
+	void Remove(SQInteger item)
 	{
-		if (this->list->buckets.empty()) return 0;
-		this->has_no_more_items = false;
-
-		/* Go to the end of the bucket-list */
-		this->bucket_iter = this->list->buckets.end();
-		--this->bucket_iter;
-		this->bucket_list = &(*this->bucket_iter).second;
-
-		/* Go to the end of the items in the bucket */
-		this->bucket_list_iter = this->bucket_list->end();
-		--this->bucket_list_iter;
-		this->item_next = *this->bucket_list_iter;
-
-		SQInteger item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
+		if (this->IsEnd()) return;
 
-	void End() override
-	{
-		this->bucket_list = nullptr;
-		this->has_no_more_items = true;
-		this->item_next = 0;
+		/* If we remove the 'next' item, skip to the next */
+		if (this->has_next && item == this->next.second) this->FindNext();
 	}
 
 	/**
-	 * Find the next item, and store that information.
+	 * Attach the sorter to a new list. This assumes the content of the old list has been moved to
+	 * the new list, too.
+	 * @param new_list New list to attach to.
 	 */
-	void FindNext()
+	void Retarget(ScriptList *new_list)
 	{
-		if (this->bucket_list == nullptr) {
-			this->has_no_more_items = true;
-			return;
-		}
-
-		if (this->bucket_list_iter == this->bucket_list->begin()) {
-			if (this->bucket_iter == this->list->buckets.begin()) {
-				this->bucket_list = nullptr;
-				return;
-			}
-			this->bucket_iter--;
-			this->bucket_list = &(*this->bucket_iter).second;
-			/* Go to the end of the items in the bucket */
-			this->bucket_list_iter = this->bucket_list->end();
-			--this->bucket_list_iter;
-		} else {
-			this->bucket_list_iter--;
-		}
-		this->item_next = *this->bucket_list_iter;
+		this->list = new_list;
 	}
+};
 
-	SQInteger Next() override
-	{
-		if (this->IsEnd()) return 0;
-
-		SQInteger item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
 
-	void Remove(SQInteger item) override
-	{
-		if (this->IsEnd()) return;
+ScriptList::ScriptList()
+{
+	/* Default sorter */
+	this->sorter         = new ScriptListSorter(this, true, false);
+	this->sorter_type    = SORT_BY_VALUE;
+	this->sort_ascending = false;
+	this->initialized    = false;
+	this->modifications  = 0;
+	this->removed_items  = 0;
+	this->values_changes = 0;
+	this->values_valid   = false;
+}
 
-		/* If we remove the 'next' item, skip to the next */
-		if (item == this->item_next) {
-			FindNext();
-			return;
-		}
-	}
-};
+ScriptList::~ScriptList()
+{
+	delete this->sorter;
+}
 
 /**
- * Sort by item, ascending.
+ * Find an item in the list.
+ * @param item The item.
+ * @return The item, or the end of #items if it is not in the list.
  */
-class ScriptListSorterItemAscending : public ScriptListSorter {
-private:
-	ScriptList::ScriptListMap::iterator item_iter; ///< The iterator over the items in the map.
+ScriptList::ScriptListItems::iterator ScriptList::FindItem(SQInteger item)
+{
+	auto it = std::lower_bound(this->items.begin(), this->items.end(), item, [](const ListItem &a, SQInteger b) { return a.item < b; });
+	if (it == this->items.end() || it->item != item || it->removed) return this->items.end();
+	return it;
+}
 
-public:
-	/**
-	 * Create a new sorter.
-	 * @param list The list to sort.
-	 */
-	ScriptListSorterItemAscending(ScriptList *list)
-	{
-		this->list = list;
-		this->End();
-	}
+/**
+ * Check whether an item still has a value.
+ * @param value The value and the item.
+ * @return True iff the item is in the list with that value.
+ */
+bool ScriptList::IsCurrentValue(const ScriptListValue &value)
+{
+	auto it = this->FindItem(value.second);
+	return it != this->items.end() && it->value == value.first;
+}
 
-	SQInteger Begin() override
-	{
-		if (this->list->items.empty()) return 0;
-		this->has_no_more_items = false;
+/** Erase the removed items from #items. */
+void ScriptList::CompactItems()
+{
+	if (this->removed_items == 0) return;
 
-		this->item_iter = this->list->items.begin();
-		this->item_next = (*this->item_iter).first;
+	std::erase_if(this->items, [](const ListItem &it) { return it.removed; });
+	this->removed_items = 0;
+}
 
-		SQInteger item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
+/**
+ * Build the index of the items by value, if there is none yet or it got
+ * changed a lot since it was built.
+ */
+void ScriptList::BuildValues()
+{
+	if (this->values_valid && this->values_changes <= this->items.size() / 2) return;
 
-	void End() override
-	{
-		this->has_no_more_items = true;
+	this->values.clear();
+	this->values.reserve(this->items.size() - this->removed_items);
+	for (const ListItem &it : this->items) {
+		if (!it.removed) this->values.emplace_back(it.value, it.item);
 	}
+	std::sort(this->values.begin(), this->values.end());
 
-	/**
-	 * Find the next item, and store that information.
-	 */
-	void FindNext()
-	{
-		if (this->item_iter == this->list->items.end()) {
-			this->has_no_more_items = true;
-			return;
-		}
-		this->item_iter++;
-		if (this->item_iter != this->list->items.end()) item_next = (*this->item_iter).first;
-	}
+	this->values_added.clear();
+	this->values_changes = 0;
+	this->values_valid = true;
+}
 
-	SQInteger Next() override
-	{
-		if (this->IsEnd()) return 0;
+/** Forget the index of the items by value, as all values changed or many items got removed. */
+void ScriptList::InvalidateValues()
+{
+	if (!this->values_valid) return;
 
-		SQInteger item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
+	this->values.clear();
+	this->values_added.clear();
+	this->values_valid = false;
+}
 
-	void Remove(SQInteger item) override
-	{
-		if (this->IsEnd()) return;
+/**
+ * Add an item with its (new) value to the index by value, if it is built.
+ * @param item The item.
+ * @param value The value.
+ */
+void ScriptList::AddValue(SQInteger item, SQInteger value)
+{
+	if (!this->values_valid) return;
 
-		/* If we remove the 'next' item, skip to the next */
-		if (item == this->item_next) {
-			FindNext();
-			return;
-		}
-	}
-};
+	this->values_changes++;
+	if (!std::binary_search(this->values.begin(), this->values.end(), ScriptListValue(value, item))) this->values_added.emplace(value, item);
+}
 
 /**
- * Sort by item, descending.
+ * Remove an item with its (old) value from the index by value, if it is built.
+ * @param item The item.
+ * @param value The value.
  */
-class ScriptListSorterItemDescending : public ScriptListSorter {
-private:
-	/* Note: We cannot use reverse_iterator.
-	 *       The iterators must only be invalidated when the element they are pointing to is removed.
-	 *       This only holds for forward iterators. */
-	ScriptList::ScriptListMap::iterator item_iter; ///< The iterator over the items in the map.
-
-public:
-	/**
-	 * Create a new sorter.
-	 * @param list The list to sort.
-	 */
-	ScriptListSorterItemDescending(ScriptList *list)
-	{
-		this->list = list;
-		this->End();
-	}
+void ScriptList::ForgetValue(SQInteger item, SQInteger value)
+{
+	if (!this->values_valid) return;
 
-	SQInteger Begin() override
-	{
-		if (this->list->items.empty()) return 0;
-		this->has_no_more_items = false;
+	this->values_changes++;
+	this->values_added.erase(ScriptListValue(value, item));
+}
 
-		this->item_iter = this->list->items.end();
-		--this->item_iter;
-		this->item_next = (*this->item_iter).first;
+/**
+ * Find the item after an item.
+ * @param[in,out] item The item to start at; the found item.
+ * @param ascending Whether to search ascending.
+ * @param first Whether to find the first item instead.
+ * @return True iff an item was found.
+ */
+bool ScriptList::FindByItem(SQInteger &item, bool ascending, bool first)
+{
+	if (ascending) {
+		auto it = first ? this->items.begin() : std::upper_bound(this->items.begin(), this->items.end(), item, [](SQInteger a, const ListItem &b) { return a < b.item; });
+		while (it != this->items.end() && it->removed) ++it;
+		if (it == this->items.end()) return false;
 
-		SQInteger item_current = this->item_next;
-		FindNext();
-		return item_current;
+		item = it->item;
+		return true;
 	}
 
-	void End() override
-	{
-		this->has_no_more_items = true;
-	}
+	auto it = first ? this->items.end() : std::lower_bound(this->items.begin(), this->items.end(), item, [](const ListItem &a, SQInteger b) { return a.item < b; });
+	while (it != this->items.begin()) {
+		--it;
+		if (it->removed) continue;
 
-	/**
-	 * Find the next item, and store that information.
-	 */
-	void FindNext()
-	{
-		if (this->item_iter == this->list->items.end()) {
-			this->has_no_more_items = true;
-			return;
-		}
-		if (this->item_iter == this->list->items.begin()) {
-			/* Use 'end' as marker for 'beyond begin' */
-			this->item_iter = this->list->items.end();
-		} else {
-			this->item_iter--;
-		}
-		if (this->item_iter != this->list->items.end()) item_next = (*this->item_iter).first;
+		item = it->item;
+		return true;
 	}
+	return false;
+}
 
-	SQInteger Next() override
-	{
-		if (this->IsEnd()) return 0;
+/**
+ * Find the item after an item in the order by value.
+ * @param[in,out] value The value and the item to start at; the found one.
+ * @param ascending Whether to search ascending.
+ * @param first Whether to find the first item instead.
+ * @return True iff an item was found.
+ */
+bool ScriptList::FindByValue(ScriptListValue &value, bool ascending, bool first)
+{
+	this->BuildValues();
 
-		SQInteger item_current = this->item_next;
-		FindNext();
-		return item_current;
-	}
+	/* The current values are the ones in #values that are still current, and the ones in #values_added. */
+	const ScriptListValue *found = nullptr;
+	if (ascending) {
+		auto it = first ? this->values.begin() : std::upper_bound(this->values.begin(), this->values.end(), value);
+		while (it != this->values.end() && !this->IsCurrentValue(*it)) ++it;
+		if (it != this->values.end()) found = &*it;
 
-	void Remove(SQInteger item) override
-	{
-		if (this->IsEnd()) return;
+		auto added = first ? this->values_added.begin() : this->values_added.upper_bound(value);
+		if (added != this->values_added.end() && (found == nullptr || *added < *found)) found = &*added;
+	} else {
+		auto it = first ? this->values.end() : std::lower_bound(this->values.begin(), this->values.end(), value);
+		while (it != this->values.begin()) {
+			--it;
+			if (!this->IsCurrentValue(*it)) continue;
 
-		/* If we remove the 'next' item, skip to the next */
-		if (item == this->item_next) {
-			FindNext();
-			return;
+			found = &*it;
+			break;
 		}
-	}
-};
 
+		auto added = first ? this->values_added.end() : this->values_added.lower_bound(value);
+		if (added != this->values_added.begin() && (found == nullptr || *found < *std::prev(added))) found = &*std::prev(added);
+	}
 
+	if (found == nullptr) return false;
+	value = *found;
+	return true;
+}
 
-ScriptList::ScriptList()
+/**
+ * Remove all items for which the predicate holds, at once.
+ * @param predicate Function called with the item and value, returning whether to remove it.
+ */
+template <class Tpredicate>
+void ScriptList::RemoveItemsIf(Tpredicate predicate)
 {
-	/* Default sorter */
-	this->sorter         = new ScriptListSorterValueDescending(this);
-	this->sorter_type    = SORT_BY_VALUE;
-	this->sort_ascending = false;
-	this->initialized    = false;
-	this->modifications  = 0;
+	size_t count = this->items.size();
+	std::erase_if(this->items, [&predicate](const ListItem &it) { return it.removed || predicate(it.item, it.value); });
+	if (this->items.size() == count) return;
+
+	this->removed_items = 0;
+	this->InvalidateValues();
 }
 
-ScriptList::~ScriptList()
+/**
+ * Remove the first items in an order of the current sorter type.
+ * @param count The number of items to remove.
+ * @param ascending Whether to remove the first items in ascending order, otherwise in descending order.
+ */
+void ScriptList::RemoveFirst(SQInteger count, bool ascending)
 {
-	delete this->sorter;
+	if (count <= 0) return;
+	this->CompactItems();
+	size_t n = std::min<size_t>(count, this->items.size());
+
+	switch (this->sorter_type) {
+		default: NOT_REACHED();
+		case SORT_BY_VALUE: {
+			/* Rebuild the index, so it has no entries that are not current. */
+			this->InvalidateValues();
+			this->BuildValues();
+
+			auto first = ascending ? this->values.begin() : this->values.end() - n;
+			auto last = first + n;
+			for (auto it = first; it != last; ++it) {
+				this->FindItem(it->second)->removed = true;
+			}
+			this->values.erase(first, last);
+			this->removed_items = n;
+			this->CompactItems();
+			break;
+		}
+
+		case SORT_BY_ITEM:
+			if (ascending) {
+				this->items.erase(this->items.begin(), this->items.begin() + n);
+			} else {
+				this->items.erase(this->items.end() - n, this->items.end());
+			}
+			this->InvalidateValues();
+			break;
+	}
 }
 
 bool ScriptList::HasItem(SQInteger item)
 {
-	return this->items.count(item) == 1;
+	return this->FindItem(item) != this->items.end();
 }
 
 void ScriptList::Clear()
@@ -428,7 +374,8 @@ void ScriptList::Clear()
 	this->modifications++;
 
 	this->items.clear();
-	this->buckets.clear();
+	this->removed_items = 0;
+	this->InvalidateValues();
 	this->sorter->End();
 }
 
@@ -436,27 +383,37 @@ void ScriptList::AddItem(SQInteger item, SQInteger value)
 {
 	this->modifications++;
 
-	if (this->HasItem(item)) return;
+	if (this->items.empty() || this->items.back().item < item) {
+		/* Lists are mostly filled in order, so just append. */
+		this->items.push_back({item, value, false});
+	} else {
+		auto it = std::lower_bound(this->items.begin(), this->items.end(), item, [](const ListItem &a, SQInteger b) { return a.item < b; });
+		if (it != this->items.end() && it->item == item) {
+			if (!it->removed) return;
 
-	this->items[item] = value;
-	this->buckets[value].insert(item);
+			*it = {item, value, false};
+			this->removed_items--;
+		} else {
+			this->items.insert(it, {item, value, false});
+		}
+	}
+
+	this->AddValue(item, value);
 }
 
 void ScriptList::RemoveItem(SQInteger item)
 {
 	this->modifications++;
 
-	ScriptListMap::iterator item_iter = this->items.find(item);
+	auto item_iter = this->FindItem(item);
 	if (item_iter == this->items.end()) return;
 
-	SQInteger value = item_iter->second;
-
 	this->sorter->Remove(item);
-	ScriptListBucket::iterator bucket_iter = this->buckets.find(value);
-	assert(bucket_iter != this->buckets.end());
-	bucket_iter->second.erase(item);
-	if (bucket_iter->second.empty()) this->buckets.erase(bucket_iter);
-	this->items.erase(item_iter);
+	item_iter->removed = true;
+	this->removed_items++;
+	this->ForgetValue(item, item_iter->value);
+
+	if (this->removed_items > this->items.size() / 2) this->CompactItems();
 }
 
 SQInteger ScriptList::Begin()
@@ -476,7 +433,7 @@ SQInteger ScriptList::Next()
 
 bool ScriptList::IsEmpty()
 {
-	return this->items.empty();
+	return this->items.size() == this->removed_items;
 }
 
 bool ScriptList::IsEnd()
@@ -490,32 +447,29 @@ bool ScriptList::IsEnd()
 
 SQInteger ScriptList::Count()
 {
-	return this->items.size();
+	return this->items.size() - this->removed_items;
 }
 
 SQInteger ScriptList::GetValue(SQInteger item)
 {
-	ScriptListMap::const_iterator item_iter = this->items.find(item);
-	return item_iter == this->items.end() ? 0 : item_iter->second;
+	auto item_iter = this->FindItem(item);
+	return item_iter == this->items.end() ? 0 : item_iter->value;
 }
 
 bool ScriptList::SetValue(SQInteger item, SQInteger value)
 {
 	this->modifications++;
 
-	ScriptListMap::iterator item_iter = this->items.find(item);
+	auto item_iter = this->FindItem(item);
 	if (item_iter == this->items.end()) return false;
 
-	SQInteger value_old = item_iter->second;
+	SQInteger value_old = item_iter->value;
 	if (value_old == value) return true;
 
 	this->sorter->Remove(item);
-	ScriptListBucket::iterator bucket_iter = this->buckets.find(value_old);
-	assert(bucket_iter != this->buckets.end());
-	bucket_iter->second.erase(item);
-	if (bucket_iter->second.empty()) this->buckets.erase(bucket_iter);
-	item_iter->second = value;
-	this->buckets[value].insert(item);
+	this->ForgetValue(item, value_old);
+	item_iter->value = value;
+	this->AddValue(item, value);
 
 	return true;
 }
@@ -528,25 +482,10 @@ void ScriptList::Sort(SorterType sorter, bool ascending)
 	if (sorter == this->sorter_type && ascending == this->sort_ascending) return;
 
 	delete this->sorter;
-	switch (sorter) {
-		case SORT_BY_ITEM:
-			if (ascending) {
-				this->sorter = new ScriptListSorterItemAscending(this);
-			} else {
-				this->sorter = new ScriptListSorterItemDescending(this);
-			}
-			break;
-
-		case SORT_BY_VALUE:
-			if (ascending) {
-				this->sorter = new ScriptListSorterValueAscending(this);
-			} else {
-				this->sorter = new ScriptListSorterValueDescending(this);
-			}
-			break;
+	this->sorter = new ScriptListSorter(this, sorter == SORT_BY_VALUE, ascending);
+	/* The index by value is only needed when sorting by value. */
+	if (sorter == SORT_BY_ITEM) this->InvalidateValues();
 
-		default: NOT_REACHED();
-	}
 	this->sorter_type    = sorter;
 	this->sort_ascending = ascending;
 	this->initialized    = false;
@@ -556,18 +495,35 @@ void ScriptList::AddList(ScriptList *list)
 {
 	if (list == this) return;
 
+	this->modifications++;
+
 	if (this->IsEmpty()) {
 		/* If this is empty, we can just take the items of the other list as is. */
 		this->items = list->items;
-		this->buckets = list->buckets;
-		this->modifications++;
-	} else {
-		ScriptListMap *list_items = &list->items;
-		for (auto &it : *list_items) {
-			this->AddItem(it.first);
-			this->SetValue(it.first, it.second);
+		this->removed_items = list->removed_items;
+		this->InvalidateValues();
+		return;
+	}
+
+	/* Merge both lists; the values of the other list win. */
+	ScriptListItems merged;
+	merged.reserve(this->items.size() + list->items.size());
+	auto a = this->items.begin();
+	auto b = list->items.begin();
+	while (a != this->items.end() || b != list->items.end()) {
+		if (a != this->items.end() && a->removed) { ++a; continue; }
+		if (b != list->items.end() && b->removed) { ++b; continue; }
+
+		if (b == list->items.end() || (a != this->items.end() && a->item < b->item)) {
+			merged.push_back(*a++);
+		} else {
+			if (a != this->items.end() && a->item == b->item) ++a;
+			merged.push_back(*b++);
 		}
 	}
+	this->items.swap(merged);
+	this->removed_items = 0;
+	this->InvalidateValues();
 }
 
 void ScriptList::SwapList(ScriptList *list)
@@ -575,7 +531,11 @@ void ScriptList::SwapList(ScriptList *list)
 	if (list == this) return;
 
 	this->items.swap(list->items);
-	this->buckets.swap(list->buckets);
+	Swap(this->removed_items, list->removed_items);
+	this->values.swap(list->values);
+	this->values_added.swap(list->values_added);
+	Swap(this->values_changes, list->values_changes);
+	Swap(this->values_valid, list->values_valid);
 	Swap(this->sorter, list->sorter);
 	Swap(this->sorter_type, list->sorter_type);
 	Swap(this->sort_ascending, list->sort_ascending);
@@ -589,114 +549,42 @@ void ScriptList::RemoveAboveValue(SQInteger value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second > value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItemsIf([value](SQInteger, SQInteger v) { return v > value; });
 }
 
 void ScriptList::RemoveBelowValue(SQInteger value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second < value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItemsIf([value](SQInteger, SQInteger v) { return v < value; });
 }
 
 void ScriptList::RemoveBetweenValue(SQInteger start, SQInteger end)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second > start && (*iter).second < end) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItemsIf([start, end](SQInteger, SQInteger v) { return v > start && v < end; });
 }
 
 void ScriptList::RemoveValue(SQInteger value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second == value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItemsIf([value](SQInteger, SQInteger v) { return v == value; });
 }
 
 void ScriptList::RemoveTop(SQInteger count)
 {
 	this->modifications++;
 
-	if (!this->sort_ascending) {
-		this->Sort(this->sorter_type, !this->sort_ascending);
-		this->RemoveBottom(count);
-		this->Sort(this->sorter_type, !this->sort_ascending);
-		return;
-	}
-
-	switch (this->sorter_type) {
-		default: NOT_REACHED();
-		case SORT_BY_VALUE:
-			for (ScriptListBucket::iterator iter = this->buckets.begin(); iter != this->buckets.end(); iter = this->buckets.begin()) {
-				ScriptItemList *items = &(*iter).second;
-				size_t size = items->size();
-				for (ScriptItemList::iterator iter = items->begin(); iter != items->end(); iter = items->begin()) {
-					if (--count < 0) return;
-					this->RemoveItem(*iter);
-					/* When the last item is removed from the bucket, the bucket itself is removed.
-					 * This means that the iterators can be invalid after a call to RemoveItem.
-					 */
-					if (--size == 0) break;
-				}
-			}
-			break;
-
-		case SORT_BY_ITEM:
-			for (ScriptListMap::iterator iter = this->items.begin(); iter != this->items.end(); iter = this->items.begin()) {
-				if (--count < 0) return;
-				this->RemoveItem((*iter).first);
-			}
-			break;
-	}
+	this->RemoveFirst(count, this->sort_ascending);
 }
 
 void ScriptList::RemoveBottom(SQInteger count)
 {
 	this->modifications++;
 
-	if (!this->sort_ascending) {
-		this->Sort(this->sorter_type, !this->sort_ascending);
-		this->RemoveTop(count);
-		this->Sort(this->sorter_type, !this->sort_ascending);
-		return;
-	}
-
-	switch (this->sorter_type) {
-		default: NOT_REACHED();
-		case SORT_BY_VALUE:
-			for (ScriptListBucket::reverse_iterator iter = this->buckets.rbegin(); iter != this->buckets.rend(); iter = this->buckets.rbegin()) {
-				ScriptItemList *items = &(*iter).second;
-				size_t size = items->size();
-				for (ScriptItemList::reverse_iterator iter = items->rbegin(); iter != items->rend(); iter = items->rbegin()) {
-					if (--count < 0) return;
-					this->RemoveItem(*iter);
-					/* When the last item is removed from the bucket, the bucket itself is removed.
-					 * This means that the iterators can be invalid after a call to RemoveItem.
-					 */
-					if (--size == 0) break;
-				}
-			}
-			break;
-
-		case SORT_BY_ITEM:
-			for (ScriptListMap::reverse_iterator iter = this->items.rbegin(); iter != this->items.rend(); iter = this->items.rbegin()) {
-				if (--count < 0) return;
-				this->RemoveItem((*iter).first);
-			}
-			break;
-	}
+	this->RemoveFirst(count, !this->sort_ascending);
 }
 
 void ScriptList::RemoveList(ScriptList *list)
@@ -705,52 +593,53 @@ void ScriptList::RemoveList(ScriptList *list)
 
 	if (list == this) {
 		Clear();
-	} else {
-		ScriptListMap *list_items = &list->items;
-		for (ScriptListMap::iterator iter = list_items->begin(); iter != list_items->end(); iter++) {
-			this->RemoveItem((*iter).first);
-		}
+		return;
 	}
+
+	/* Both lists are sorted by item, so the search can continue from the last found item. */
+	auto it = this->items.begin();
+	for (const ListItem &remove : list->items) {
+		if (remove.removed) continue;
+
+		it = std::lower_bound(it, this->items.end(), remove.item, [](const ListItem &a, SQInteger b) { return a.item < b; });
+		if (it == this->items.end()) break;
+		if (it->item != remove.item || it->removed) continue;
+
+		this->sorter->Remove(it->item);
+		it->removed = true;
+		this->removed_items++;
+		this->ForgetValue(it->item, it->value);
+	}
+
+	if (this->removed_items > this->items.size() / 2) this->CompactItems();
 }
 
 void ScriptList::KeepAboveValue(SQInteger value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second <= value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItemsIf([value](SQInteger, SQInteger v) { return v <= value; });
 }
 
 void ScriptList::KeepBelowValue(SQInteger value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second >= value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItemsIf([value](SQInteger, SQInteger v) { return v >= value; });
 }
 
 void ScriptList::KeepBetweenValue(SQInteger start, SQInteger end)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second <= start || (*iter).second >= end) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItemsIf([start, end](SQInteger, SQInteger v) { return v <= start || v >= end; });
 }
 
 void ScriptList::KeepValue(SQInteger value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second != value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItemsIf([value](SQInteger, SQInteger v) { return v != value; });
 }
 
 void ScriptList::KeepTop(SQInteger count)
@@ -773,10 +662,12 @@ void ScriptList::KeepList(ScriptList *list)
 
 	this->modifications++;
 
-	ScriptList tmp;
-	tmp.AddList(this);
-	tmp.RemoveList(list);
-	this->RemoveList(&tmp);
+	/* Both lists are sorted by item, so the search can continue from the last found item. */
+	auto it = list->items.begin();
+	this->RemoveItemsIf([list, &it](SQInteger item, SQInteger) {
+		it = std::lower_bound(it, list->items.end(), item, [](const ListItem &a, SQInteger b) { return a.item < b; });
+		return it == list->items.end() || it->item != item || it->removed;
+	});
 }
 
 SQInteger ScriptList::_get(HSQUIRRELVM vm)
@@ -786,10 +677,10 @@ SQInteger ScriptList::_get(HSQUIRRELVM vm)
 	SQInteger idx;
 	sq_getinteger(vm, 2, &idx);
 
-	ScriptListMap::const_iterator item_iter = this->items.find(idx);
+	auto item_iter = this->FindItem(idx);
 	if (item_iter == this->items.end()) return SQ_ERROR;
 
-	sq_pushinteger(vm, item_iter->second);
+	sq_pushinteger(vm, item_iter->value);
 	return 1;
 }
 
@@ -871,14 +762,16 @@ SQInteger ScriptList::Valuate(HSQUIRRELVM vm)
 	/* Push the function to call */
 	sq_push(vm, 2);
 
-	for (ScriptListMap::iterator iter = this->items.begin(); iter != this->items.end(); iter++) {
+	for (size_t i = 0; i < this->items.size(); i++) {
+		if (this->items[i].removed) continue;
+
 		/* Check for changing of items. */
 		int previous_modification_count = this->modifications;
 
 		/* Push the root table as instance object, this is what squirrel does for meta-functions. */
 		sq_pushroottable(vm);
 		/* Push all arguments for the valuator function. */
-		sq_pushinteger(vm, (*iter).first);
+		sq_pushinteger(vm, this->items[i].item);
 		for (int i = 0; i < nparam - 1; i++) {
 			sq_push(vm, i + 3);
 		}
@@ -922,7 +815,10 @@ SQInteger ScriptList::Valuate(HSQUIRRELVM vm)
 			return sq_throwerror(vm, "modifying valuated list outside of valuator function");
 		}
 
-		this->SetValue((*iter).first, value);
+		/* Nothing changed the list, so the item is still at the same place. */
+		this->items[i].value = value;
+		/* Valuating changes all values, so the index by value gets rebuilt when it is needed again. */
+		this->InvalidateValues();
 
 		/* Pop the return value. */
 		sq_poptop(vm);
@@ -36,12 +36,43 @@ public:
 	static const bool SORT_DESCENDING = false;
 
 private:
+	friend class ScriptListSorter;
+
+	/** An item of the list with its value. */
+	struct ListItem {
+		SQInteger item;  ///< The item.
+		SQInteger value; ///< The value of the item.
+		bool removed;    ///< Whether the item got removed, but is not erased from #items yet.
+	};
+	typedef std::vector<ListItem> ScriptListItems;                ///< The items, sorted by item.
+	typedef std::pair<SQInteger, SQInteger> ScriptListValue;      ///< A value and its item.
+	typedef std::vector<ScriptListValue> ScriptListValues;        ///< The items sorted by value, and then by item.
+
 	ScriptListSorter *sorter;     ///< Sorting algorithm
 	SorterType sorter_type;       ///< Sorting type
 	bool sort_ascending;          ///< Whether to sort ascending or descending
 	bool initialized;             ///< Whether an iteration has been started
 	int modifications;            ///< Number of modification that has been done. To prevent changing data while valuating.
 
+	ScriptListItems items;                 ///< The items in the list, sorted by item.
+	size_t removed_items;                  ///< Number of removed items that are still in #items.
+	ScriptListValues values;               ///< The items sorted by value when #values_valid; entries whose item got removed or changed value are skipped.
+	std::set<ScriptListValue> values_added; ///< Values that were set after #values got built.
+	size_t values_changes;                 ///< Number of changes since #values got built.
+	bool values_valid;                     ///< Whether #values is built.
+
+	ScriptListItems::iterator FindItem(SQInteger item);
+	bool IsCurrentValue(const ScriptListValue &value);
+	void CompactItems();
+	void BuildValues();
+	void InvalidateValues();
+	void AddValue(SQInteger item, SQInteger value);
+	void ForgetValue(SQInteger item, SQInteger value);
+	bool FindByItem(SQInteger &item, bool ascending, bool first);
+	bool FindByValue(ScriptListValue &value, bool ascending, bool first);
+	void RemoveFirst(SQInteger count, bool ascending);
+	template <class Tpredicate> void RemoveItemsIf(Tpredicate predicate);
+
 protected:
 	template<typename T, class ItemValid, class ItemFilter>
 	static void FillList(ScriptList *list, ItemValid item_valid, ItemFilter item_filter)
@@ -143,14 +174,26 @@ protected:
 		ScriptList::FillList<T>(vm, list, [](const T *) { return true; });
 	}
 
-public:
-	typedef std::set<SQInteger> ScriptItemList;                   ///< The list of items inside the bucket
-	typedef std::map<SQInteger, ScriptItemList> ScriptListBucket; ///< The bucket list per value
-	typedef std::map<SQInteger, SQInteger> ScriptListMap;         ///< List per item
+	/**
+	 * Give all items a value determined in native code, without calling a
+	 * Squirrel valuator for every item. The script is charged one operation
+	 * per item, but at most #MAX_VALUATE_OPS.
+	 * @param valuator Function returning the value of an item.
+	 */
+	template<class Tvaluator>
+	void ValuateNative(Tvaluator valuator)
+	{
+		this->modifications++;
+
+		for (ListItem &it : this->items) {
+			if (!it.removed) it.value = valuator(it.item);
+		}
+		this->InvalidateValues();
 
-	ScriptListMap items;           ///< The items in the list
-	ScriptListBucket buckets;      ///< The items in the list, sorted by value
+		ScriptObject::DecreaseOps(static_cast<int>(std::min<SQInteger>(this->Count(), MAX_VALUATE_OPS)));
+	}
 
+public:
 	ScriptList();
 	~ScriptList();
 
@@ -58,5 +58,6 @@
 
 	/* Also still print to debug window */
 	Debug(script, level, "[{}] [{}] {}", (uint)ScriptObject::GetRootCompany(), logc, line.text);
-	InvalidateWindowClassesData(WC_SCRIPT_DEBUG, ScriptObject::GetRootCompany());
+	/* Immediately, so a break string pauses the script before it continues. */
+	InvalidateWindowClassesDataImmediately(WC_SCRIPT_DEBUG, ScriptObject::GetRootCompany());
 }
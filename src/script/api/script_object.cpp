@@ -224,6 +224,23 @@ ScriptObject::ActiveInstance::~ActiveInstance()
 	return GetStorage()->allow_do_command && squirrel->CanSuspend();
 }
 
+/* static */ bool ScriptObject::SkipUnchangedCommand()
+{
+	/* Do not hide that the command was not allowed here. */
+	if (!ScriptObject::CanSuspend()) return false;
+	/* In asynchronous mode an earlier command might still change the state. */
+	if (GetDoCommandAsyncMode() != nullptr && GetDoCommandAsyncMode()()) return false;
+
+	SetLastError(ScriptError::ERR_NONE);
+	SetLastCost(0);
+	return true;
+}
+
+/* static */ void ScriptObject::DecreaseOps(int ops)
+{
+	Squirrel::DecreaseOps(ScriptObject::GetActiveInstance()->engine->GetVM(), ops);
+}
+
 /* static */ void *&ScriptObject::GetEventPointer()
 {
 	return GetStorage()->event_data;
@@ -290,6 +290,20 @@ protected:
 	 */
 	static bool CanSuspend();
 
+	/**
+	 * Succeed with a command that would not change the game state, without sending it.
+	 * This is only possible when the script waits for its commands, as only then
+	 * the game state contains the effects of all commands the script sent before.
+	 * @return True iff the command is done; else it has to be executed as usual.
+	 */
+	static bool SkipUnchangedCommand();
+
+	/**
+	 * Charge the script for operations done in native code on its behalf.
+	 * @param ops The number of operations to charge.
+	 */
+	static void DecreaseOps(int ops);
+
 	/**
 	 * Get the pointer to store event data in.
 	 */
@@ -10,6 +10,7 @@
 #include "../../stdafx.h"
 #include "script_tilelist.hpp"
 #include "script_industry.hpp"
+#include "script_tile.hpp"
 #include "../../industry.h"
 #include "../../station_base.h"
 
@@ -47,6 +48,31 @@ void ScriptTileList::RemoveTile(TileIndex tile)
 	this->RemoveItem(tile.base());
 }
 
+void ScriptTileList::ValuateBuildable()
+{
+	this->ValuateNative([](SQInteger tile) { return ScriptTile::IsBuildable(tile) ? 1 : 0; });
+}
+
+void ScriptTileList::ValuateSlope()
+{
+	this->ValuateNative([](SQInteger tile) { return ScriptTile::GetSlope(tile); });
+}
+
+void ScriptTileList::ValuateDistanceManhattanToTile(TileIndex tile)
+{
+	this->ValuateNative([tile](SQInteger tile_from) { return ScriptTile::GetDistanceManhattanToTile(tile_from, tile); });
+}
+
+void ScriptTileList::ValuateDistanceSquareToTile(TileIndex tile)
+{
+	this->ValuateNative([tile](SQInteger tile_from) { return ScriptTile::GetDistanceSquareToTile(tile_from, tile); });
+}
+
+void ScriptTileList::ValuateCargoAcceptance(CargoID cargo_type, SQInteger width, SQInteger height, SQInteger radius)
+{
+	this->ValuateNative([=](SQInteger tile) { return ScriptTile::GetCargoAcceptance(tile, cargo_type, width, height, radius); });
+}
+
 /**
  * Helper to get list of tiles that will cover an industry's production or acceptance.
  * @param i Industry in question
@@ -51,6 +51,42 @@ public:
 	 * @pre ScriptMap::IsValidTile(tile).
 	 */
 	void RemoveTile(TileIndex tile);
+
+	/**
+	 * Give all tiles whether they are buildable as value.
+	 * @note This gives the same values as Valuate(ScriptTile.IsBuildable), but much faster.
+	 */
+	void ValuateBuildable();
+
+	/**
+	 * Give all tiles their slope as value.
+	 * @note This gives the same values as Valuate(ScriptTile.GetSlope), but much faster.
+	 */
+	void ValuateSlope();
+
+	/**
+	 * Give all tiles their Manhattan distance to a tile as value.
+	 * @param tile The tile to get the distance to.
+	 * @note This gives the same values as Valuate(ScriptTile.GetDistanceManhattanToTile, tile), but much faster.
+	 */
+	void ValuateDistanceManhattanToTile(TileIndex tile);
+
+	/**
+	 * Give all tiles their square distance to a tile as value.
+	 * @param tile The tile to get the distance to.
+	 * @note This gives the same values as Valuate(ScriptTile.GetDistanceSquareToTile, tile), but much faster.
+	 */
+	void ValuateDistanceSquareToTile(TileIndex tile);
+
+	/**
+	 * Give all tiles the acceptance of a cargo by a station of the given size at the tile as value.
+	 * @param cargo_type The cargo to check the acceptance of.
+	 * @param width The width of the station.
+	 * @param height The height of the station.
+	 * @param radius The radius of the station.
+	 * @note This gives the same values as Valuate(ScriptTile.GetCargoAcceptance, cargo_type, width, height, radius), but much faster.
+	 */
+	void ValuateCargoAcceptance(CargoID cargo_type, SQInteger width, SQInteger height, SQInteger radius);
 };
 
 /**
@@ -62,7 +62,10 @@
 	EnforceDeityMode(false);
 	EnforcePrecondition(false, IsValidTown(town_id));
 
-	return ScriptObject::Command<CMD_TOWN_SET_TEXT>::Do(town_id, text != nullptr ? text->GetEncodedText() : std::string{});
+	std::string encoded_text = text != nullptr ? text->GetEncodedText() : std::string{};
+	if (::Town::Get(town_id)->text == encoded_text && ScriptObject::SkipUnchangedCommand()) return true;
+
+	return ScriptObject::Command<CMD_TOWN_SET_TEXT>::Do(town_id, encoded_text);
 }
 
 /* static */ SQInteger ScriptTown::GetPopulation(TownID town_id)
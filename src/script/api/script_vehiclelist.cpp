@@ -12,6 +12,7 @@
 #include "script_group.hpp"
 #include "script_map.hpp"
 #include "script_station.hpp"
+#include "script_vehicle.hpp"
 #include "../../depot_map.h"
 #include "../../vehicle_base.h"
 #include "../../vehiclelist_func.h"
@@ -33,6 +34,21 @@ ScriptVehicleList::ScriptVehicleList(HSQUIRRELVM vm)
 	);
 }
 
+void ScriptVehicleList::ValuateProfitThisYear()
+{
+	this->ValuateNative([](SQInteger vehicle_id) { return ScriptVehicle::GetProfitThisYear(static_cast<VehicleID>(vehicle_id)); });
+}
+
+void ScriptVehicleList::ValuateProfitLastYear()
+{
+	this->ValuateNative([](SQInteger vehicle_id) { return ScriptVehicle::GetProfitLastYear(static_cast<VehicleID>(vehicle_id)); });
+}
+
+void ScriptVehicleList::ValuateAge()
+{
+	this->ValuateNative([](SQInteger vehicle_id) { return ScriptVehicle::GetAge(static_cast<VehicleID>(vehicle_id)); });
+}
+
 ScriptVehicleList_Station::ScriptVehicleList_Station(StationID station_id)
 {
 	EnforceDeityOrCompanyModeValid_Void();
@@ -46,6 +46,24 @@ public:
 	 */
 	ScriptVehicleList(HSQUIRRELVM vm);
 #endif /* DOXYGEN_API */
+
+	/**
+	 * Give all vehicles their profit of this year as value.
+	 * @note This gives the same values as Valuate(ScriptVehicle.GetProfitThisYear), but much faster.
+	 */
+	void ValuateProfitThisYear();
+
+	/**
+	 * Give all vehicles their profit of last year as value.
+	 * @note This gives the same values as Valuate(ScriptVehicle.GetProfitLastYear), but much faster.
+	 */
+	void ValuateProfitLastYear();
+
+	/**
+	 * Give all vehicles their age as value.
+	 * @note This gives the same values as Valuate(ScriptVehicle.GetAge), but much faster.
+	 */
+	void ValuateAge();
 };
 
 /**
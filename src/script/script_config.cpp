@@ -186,8 +186,8 @@ void ScriptConfig::SetToLoadData(ScriptInstance::ScriptData *data)
 	this->to_load_data.reset(data);
 }
 
-ScriptInstance::ScriptData *ScriptConfig::GetToLoadData()
+std::unique_ptr<ScriptInstance::ScriptData> ScriptConfig::TakeToLoadData()
 {
-	return this->to_load_data.get();
+	return std::move(this->to_load_data);
 }
 
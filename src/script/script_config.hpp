@@ -167,7 +167,7 @@ public:
 	std::optional<std::string> GetTextfile(TextfileType type, CompanyID slot) const;
 
 	void SetToLoadData(ScriptInstance::ScriptData *data);
-	ScriptInstance::ScriptData *GetToLoadData();
+	std::unique_ptr<ScriptInstance::ScriptData> TakeToLoadData();
 
 protected:
 	std::string name;                                         ///< Name of the Script
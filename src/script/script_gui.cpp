@@ -1062,6 +1062,15 @@ struct ScriptDebugWindow : public Window {
 				ShowScriptSettingsWindow(this->filter.script_debug_company);
 				break;
 
+			case WID_SCRD_MEMORY:
+				if (this->filter.script_debug_company == OWNER_DEITY) {
+					Game::GetInstance()->LogAllocations();
+				} else {
+					Company::Get(this->filter.script_debug_company)->ai_instance->LogAllocations();
+				}
+				this->InvalidateData(-1);
+				break;
+
 			case WID_SCRD_BREAK_STR_ON_OFF_BTN:
 				this->filter.break_check_enabled = !this->filter.break_check_enabled;
 				this->InvalidateData(-1);
@@ -1184,6 +1193,7 @@ struct ScriptDebugWindow : public Window {
 				this->filter.script_debug_company == INVALID_COMPANY ||
 				this->filter.script_debug_company == OWNER_DEITY ||
 				this->filter.script_debug_company == _local_company);
+		this->SetWidgetDisabledState(WID_SCRD_MEMORY, this->IsDead());
 		this->SetWidgetDisabledState(WID_SCRD_CONTINUE_BTN, this->filter.script_debug_company == INVALID_COMPANY ||
 			(this->filter.script_debug_company == OWNER_DEITY ? !Game::IsPaused() : !AI::IsPaused(this->filter.script_debug_company)));
 	}
@@ -1257,6 +1267,7 @@ static constexpr NWidgetPart _nested_script_debug_widgets[] = {
 		NWidget(NWID_VERTICAL),
 			NWidget(WWT_PUSHTXTBTN, COLOUR_GREY, WID_SCRD_SETTINGS), SetMinimalSize(100, 20), SetFill(0, 1), SetDataTip(STR_AI_DEBUG_SETTINGS, STR_AI_DEBUG_SETTINGS_TOOLTIP),
 			NWidget(WWT_PUSHTXTBTN, COLOUR_GREY, WID_SCRD_RELOAD_TOGGLE), SetMinimalSize(100, 20), SetFill(0, 1), SetDataTip(STR_AI_DEBUG_RELOAD, STR_AI_DEBUG_RELOAD_TOOLTIP),
+			NWidget(WWT_PUSHTXTBTN, COLOUR_GREY, WID_SCRD_MEMORY), SetMinimalSize(100, 20), SetFill(0, 1), SetDataTip(STR_AI_DEBUG_MEMORY, STR_AI_DEBUG_MEMORY_TOOLTIP),
 		EndContainer(),
 	EndContainer(),
 	NWidget(NWID_HORIZONTAL),
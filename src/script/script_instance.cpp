@@ -207,6 +207,9 @@ void ScriptInstance::GameLoop()
 	this->callback = nullptr;
 
 	if (!this->is_started) {
+		/* The data from the savegame is only put on the stack now, so loading a
+		 * savegame does not have to wait for all scripts to convert their data. */
+		this->LoadOnStack();
 		try {
 			ScriptObject::SetAllowDoCommand(false);
 			/* Run the constructor if it exists. Don't allow any DoCommands in it. */
@@ -351,7 +354,7 @@ static const SaveLoad _script_byte[] = {
 	SLEG_VAR("type", _script_sl_byte, SLE_UINT8),
 };
 
-/* static */ bool ScriptInstance::SaveObject(HSQUIRRELVM vm, SQInteger index, int max_depth, bool test)
+/* static */ bool ScriptInstance::SaveObject(HSQUIRRELVM vm, SQInteger index, int max_depth, ScriptData &data)
 {
 	if (max_depth == 0) {
 		ScriptLog::Error("Savedata can only be nested to 25 deep. No data saved."); // SQUIRREL_MAX_DEPTH = 25
@@ -360,24 +363,13 @@ static const SaveLoad _script_byte[] = {
 
 	switch (sq_gettype(vm, index)) {
 		case OT_INTEGER: {
-			if (!test) {
-				_script_sl_byte = SQSL_INT;
-				SlObject(nullptr, _script_byte);
-			}
 			SQInteger res;
 			sq_getinteger(vm, index, &res);
-			if (!test) {
-				int64_t value = (int64_t)res;
-				SlCopy(&value, 1, SLE_INT64);
-			}
+			data.push_back(res);
 			return true;
 		}
 
 		case OT_STRING: {
-			if (!test) {
-				_script_sl_byte = SQSL_STRING;
-				SlObject(nullptr, _script_byte);
-			}
 			const SQChar *buf;
 			sq_getstring(vm, index, &buf);
 			size_t len = strlen(buf) + 1;
@@ -385,23 +377,16 @@ static const SaveLoad _script_byte[] = {
 				ScriptLog::Error("Maximum string length is 254 chars. No data saved.");
 				return false;
 			}
-			if (!test) {
-				_script_sl_byte = (uint8_t)len;
-				SlObject(nullptr, _script_byte);
-				SlCopy(const_cast<char *>(buf), len, SLE_CHAR);
-			}
+			data.push_back(std::string(buf));
 			return true;
 		}
 
 		case OT_ARRAY: {
-			if (!test) {
-				_script_sl_byte = SQSL_ARRAY;
-				SlObject(nullptr, _script_byte);
-			}
+			data.push_back(SQSL_ARRAY);
 			sq_pushnull(vm);
 			while (SQ_SUCCEEDED(sq_next(vm, index - 1))) {
 				/* Store the value */
-				bool res = SaveObject(vm, -1, max_depth - 1, test);
+				bool res = SaveObject(vm, -1, max_depth - 1, data);
 				sq_pop(vm, 2);
 				if (!res) {
 					sq_pop(vm, 1);
@@ -409,22 +394,16 @@ static const SaveLoad _script_byte[] = {
 				}
 			}
 			sq_pop(vm, 1);
-			if (!test) {
-				_script_sl_byte = SQSL_ARRAY_TABLE_END;
-				SlObject(nullptr, _script_byte);
-			}
+			data.push_back(SQSL_ARRAY_TABLE_END);
 			return true;
 		}
 
 		case OT_TABLE: {
-			if (!test) {
-				_script_sl_byte = SQSL_TABLE;
-				SlObject(nullptr, _script_byte);
-			}
+			data.push_back(SQSL_TABLE);
 			sq_pushnull(vm);
 			while (SQ_SUCCEEDED(sq_next(vm, index - 1))) {
 				/* Store the key + value */
-				bool res = SaveObject(vm, -2, max_depth - 1, test) && SaveObject(vm, -1, max_depth - 1, test);
+				bool res = SaveObject(vm, -2, max_depth - 1, data) && SaveObject(vm, -1, max_depth - 1, data);
 				sq_pop(vm, 2);
 				if (!res) {
 					sq_pop(vm, 1);
@@ -432,32 +411,19 @@ static const SaveLoad _script_byte[] = {
 				}
 			}
 			sq_pop(vm, 1);
-			if (!test) {
-				_script_sl_byte = SQSL_ARRAY_TABLE_END;
-				SlObject(nullptr, _script_byte);
-			}
+			data.push_back(SQSL_ARRAY_TABLE_END);
 			return true;
 		}
 
 		case OT_BOOL: {
-			if (!test) {
-				_script_sl_byte = SQSL_BOOL;
-				SlObject(nullptr, _script_byte);
-			}
 			SQBool res;
 			sq_getbool(vm, index, &res);
-			if (!test) {
-				_script_sl_byte = res ? 1 : 0;
-				SlObject(nullptr, _script_byte);
-			}
+			data.push_back(res);
 			return true;
 		}
 
 		case OT_NULL: {
-			if (!test) {
-				_script_sl_byte = SQSL_NULL;
-				SlObject(nullptr, _script_byte);
-			}
+			data.push_back(SQSL_NULL);
 			return true;
 		}
 
@@ -467,30 +433,59 @@ static const SaveLoad _script_byte[] = {
 	}
 }
 
+/* static */ void ScriptInstance::SaveObjects(const ScriptData &data)
+{
+	/* This runs on the savegame workers, so it does not use _script_sl_byte. */
+	for (const ScriptDataVariant &value : data) {
+		uint8_t type;
+		if (std::holds_alternative<SQInteger>(value)) {
+			type = SQSL_INT;
+			SlCopy(&type, 1, SLE_UINT8);
+			int64_t res = (int64_t)std::get<SQInteger>(value);
+			SlCopy(&res, 1, SLE_INT64);
+		} else if (std::holds_alternative<std::string>(value)) {
+			type = SQSL_STRING;
+			SlCopy(&type, 1, SLE_UINT8);
+			const std::string &res = std::get<std::string>(value);
+			uint8_t len = (uint8_t)(res.size() + 1);
+			SlCopy(&len, 1, SLE_UINT8);
+			SlCopy(const_cast<char *>(res.c_str()), len, SLE_CHAR);
+		} else if (std::holds_alternative<SQBool>(value)) {
+			type = SQSL_BOOL;
+			SlCopy(&type, 1, SLE_UINT8);
+			uint8_t res = std::get<SQBool>(value) ? 1 : 0;
+			SlCopy(&res, 1, SLE_UINT8);
+		} else {
+			type = std::get<SQSaveLoadType>(value);
+			SlCopy(&type, 1, SLE_UINT8);
+		}
+	}
+}
+
 /* static */ void ScriptInstance::SaveEmpty()
 {
-	_script_sl_byte = 0;
-	SlObject(nullptr, _script_byte);
+	uint8_t saved = 0;
+	SlCopy(&saved, 1, SLE_UINT8);
 }
 
-void ScriptInstance::Save()
+void ScriptInstance::PrepareSave()
 {
 	ScriptObject::ActiveInstance active(this);
 
+	this->save_data.reset();
+
 	/* Don't save data if the script didn't start yet or if it crashed. */
-	if (this->engine == nullptr || this->engine->HasScriptCrashed()) {
-		SaveEmpty();
-		return;
-	}
+	if (this->engine == nullptr || this->engine->HasScriptCrashed()) return;
 
 	HSQUIRRELVM vm = this->engine->GetVM();
-	if (this->is_save_data_on_stack) {
-		_script_sl_byte = 1;
-		SlObject(nullptr, _script_byte);
+	if (this->load_data != nullptr) {
+		/* Save the data that was loaded, without the version in front of it. */
+		this->save_data = std::make_unique<ScriptData>(std::next(this->load_data->begin()), this->load_data->end());
+	} else if (this->is_save_data_on_stack) {
 		/* Save the data that was just loaded. */
-		SaveObject(vm, -1, SQUIRREL_MAX_DEPTH, false);
+		auto data = std::make_unique<ScriptData>();
+		if (SaveObject(vm, -1, SQUIRREL_MAX_DEPTH, *data)) this->save_data = std::move(data);
 	} else if (!this->is_started) {
-		SaveEmpty();
 		return;
 	} else if (this->engine->MethodExists(*this->instance, "Save")) {
 		HSQOBJECT savedata;
@@ -501,7 +496,6 @@ void ScriptInstance::Save()
 			if (!this->engine->CallMethod(*this->instance, "Save", &savedata, MAX_SL_OPS)) {
 				/* The script crashed in the Save function. We can't kill
 				 * it here, but do so in the next script tick. */
-				SaveEmpty();
 				this->engine->CrashOccurred();
 				return;
 			}
@@ -511,7 +505,6 @@ void ScriptInstance::Save()
 			this->is_dead = true;
 			this->engine->ThrowError(e.GetErrorMessage());
 			this->engine->ResumeError();
-			SaveEmpty();
 			/* We can't kill the script here, so mark it as crashed (not dead) and
 			 * kill it in the next script tick. */
 			this->is_dead = false;
@@ -522,27 +515,34 @@ void ScriptInstance::Save()
 
 		if (!sq_istable(savedata)) {
 			ScriptLog::Error(this->engine->IsSuspended() ? "This script took too long to Save." : "Save function should return a table.");
-			SaveEmpty();
 			this->engine->CrashOccurred();
 			return;
 		}
 		sq_pushobject(vm, savedata);
-		if (SaveObject(vm, -1, SQUIRREL_MAX_DEPTH, true)) {
-			_script_sl_byte = 1;
-			SlObject(nullptr, _script_byte);
-			SaveObject(vm, -1, SQUIRREL_MAX_DEPTH, false);
+		auto data = std::make_unique<ScriptData>();
+		if (SaveObject(vm, -1, SQUIRREL_MAX_DEPTH, *data)) {
+			this->save_data = std::move(data);
 			this->is_save_data_on_stack = true;
 		} else {
-			SaveEmpty();
 			this->engine->CrashOccurred();
 		}
 	} else {
 		ScriptLog::Warning("Save function is not implemented");
-		_script_sl_byte = 0;
-		SlObject(nullptr, _script_byte);
 	}
 }
 
+void ScriptInstance::Save() const
+{
+	if (this->save_data == nullptr) {
+		SaveEmpty();
+		return;
+	}
+
+	uint8_t saved = 1;
+	SlCopy(&saved, 1, SLE_UINT8);
+	SaveObjects(*this->save_data);
+}
+
 void ScriptInstance::Pause()
 {
 	/* Suspend script. */
@@ -687,10 +687,11 @@ bool ScriptInstance::IsPaused()
 	return data;
 }
 
-void ScriptInstance::LoadOnStack(ScriptData *data)
+void ScriptInstance::LoadOnStack()
 {
 	ScriptObject::ActiveInstance active(this);
 
+	std::unique_ptr<ScriptData> data = std::move(this->load_data);
 	if (this->IsDead() || data == nullptr) return;
 
 	HSQUIRRELVM vm = this->engine->GetVM();
@@ -700,7 +701,7 @@ void ScriptInstance::LoadOnStack(ScriptData *data)
 	SQInteger top = sq_gettop(vm);
 	try {
 		sq_pushinteger(vm, std::get<SQInteger>(version));
-		LoadObjects(vm, data);
+		LoadObjects(vm, data.get());
 		this->is_save_data_on_stack = true;
 	} catch (Script_FatalError &e) {
 		ScriptLog::Warning(fmt::format("Loading failed: {}", e.GetErrorMessage()));
@@ -788,6 +789,43 @@ size_t ScriptInstance::GetAllocatedMemory() const
 	return this->engine->GetAllocatedMemory();
 }
 
+void ScriptInstance::LogAllocations()
+{
+	if (this->engine == nullptr) return;
+
+	ScriptObject::ActiveInstance active(this);
+
+	size_t reserved;
+	std::vector<ScriptAllocationStats> stats = this->engine->GetAllocationStats(reserved);
+	ScriptLog::Info(fmt::format("Memory: {} bytes allocated, {} bytes reserved for small allocations", this->engine->GetAllocatedMemory(), reserved));
+	for (const ScriptAllocationStats &size_class : stats) {
+		if (size_class.count == 0) continue;
+		if (size_class.block_size == 0) {
+			ScriptLog::Info(fmt::format("  Larger: {} allocations, {} bytes", size_class.count, size_class.bytes));
+		} else {
+			ScriptLog::Info(fmt::format("  Up to {} bytes: {} allocations, {} bytes", size_class.block_size, size_class.count, size_class.bytes));
+		}
+	}
+}
+
+void ScriptInstance::SetProfiling(uint interval)
+{
+	if (this->engine == nullptr) return;
+	this->engine->SetProfiling(interval);
+}
+
+std::vector<std::string> ScriptInstance::GetProfile(bool time) const
+{
+	std::vector<std::string> lines;
+	if (this->engine == nullptr) return lines;
+
+	for (const auto &[stack, weights] : this->engine->GetProfile()) {
+		lines.push_back(fmt::format("{} {}", stack, time ? weights.second : weights.first));
+	}
+	std::sort(lines.begin(), lines.end());
+	return lines;
+}
+
 void ScriptInstance::ReleaseSQObject(HSQOBJECT *obj)
 {
 	if (!this->in_shutdown) this->engine->ReleaseObject(obj);
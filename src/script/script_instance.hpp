@@ -158,9 +158,15 @@ public:
 	inline bool IsAlive() const { return !this->IsDead() && !this->in_shutdown; }
 
 	/**
-	 * Call the script Save function and save all data in the savegame.
+	 * Call the script Save function and keep the data it returns, so #Save
+	 * can write it to the savegame later, on another thread.
 	 */
-	void Save();
+	void PrepareSave();
+
+	/**
+	 * Save the data kept by #PrepareSave in the savegame.
+	 */
+	void Save() const;
 
 	/**
 	 * Don't save any data in the savegame.
@@ -176,10 +182,10 @@ public:
 	static ScriptData *Load(int version);
 
 	/**
-	 * Store loaded data on the stack.
-	 * @param data The loaded data to store on the stack.
+	 * Keep loaded data until the first tick of the script stores it on the stack.
+	 * @param data The loaded data.
 	 */
-	void LoadOnStack(ScriptData *data);
+	void SetLoadData(std::unique_ptr<ScriptData> data) { this->load_data = std::move(data); }
 
 	/**
 	 * Load and discard data from a savegame.
@@ -239,6 +245,24 @@ public:
 
 	size_t GetAllocatedMemory() const;
 
+	/**
+	 * Write the allocations of the script by size class to its log.
+	 */
+	void LogAllocations();
+
+	/**
+	 * Start or stop profiling the script.
+	 * @param interval Number of opcodes between two samples of the call stack, or 0 to stop.
+	 */
+	void SetProfiling(uint interval);
+
+	/**
+	 * Get the profile of the script in the folded stack format of flame graph tools.
+	 * @param time Whether to weigh the call stacks by microseconds instead of opcodes.
+	 * @return Per call stack a line with its frames separated by ';' and its weight.
+	 */
+	std::vector<std::string> GetProfile(bool time) const;
+
 	/**
 	 * Indicate whether this instance is currently being destroyed.
 	 */
@@ -295,6 +319,13 @@ private:
 	bool in_shutdown;                     ///< Is this instance currently being destructed?
 	Script_SuspendCallbackProc *callback; ///< Callback that should be called in the next tick the script runs.
 	size_t last_allocated_memory;         ///< Last known allocated memory value (for display for crashed scripts)
+	std::unique_ptr<ScriptData> load_data; ///< Data loaded from the savegame that is not yet on the squirrel stack.
+	std::unique_ptr<ScriptData> save_data; ///< Data to save in the savegame, or nullptr to save nothing.
+
+	/**
+	 * Store the loaded data on the stack.
+	 */
+	void LoadOnStack();
 
 	/**
 	 * Call the script Load function if it exists and data was loaded
@@ -303,16 +334,21 @@ private:
 	bool CallLoad();
 
 	/**
-	 * Save one object (int / string / array / table) to the savegame.
+	 * Convert one object (int / string / array / table) for the savegame.
 	 * @param vm The virtual machine to get all the data from.
 	 * @param index The index on the squirrel stack of the element to save.
 	 * @param max_depth The maximum depth recursive arrays / tables will be stored
 	 *   with before an error is returned.
-	 * @param test If true, don't really store the data but only check if it is
-	 *   valid.
-	 * @return True if the saving was successful.
+	 * @param data The data to append the object to.
+	 * @return True if the object is valid to save.
+	 */
+	static bool SaveObject(HSQUIRRELVM vm, SQInteger index, int max_depth, ScriptData &data);
+
+	/**
+	 * Save all converted objects to the savegame.
+	 * @param data The objects.
 	 */
-	static bool SaveObject(HSQUIRRELVM vm, SQInteger index, int max_depth, bool test);
+	static void SaveObjects(const ScriptData &data);
 
 	/**
 	 * Load all objects from a savegame.
@@ -18,7 +18,7 @@
 #include "script_fatalerror.hpp"
 
 #include "../network/network_content.h"
-#include "../3rdparty/md5/md5.h"
+#include "../scan_cache.h"
 #include "../tar_type.h"
 
 #include "../safeguards.h"
@@ -163,22 +163,14 @@ struct ScriptFileChecksumCreator : FileScanner {
 	/* Add the file and calculate the md5 sum. */
 	bool AddFile(const std::string &filename, size_t, const std::string &) override
 	{
-		Md5 checksum;
-		uint8_t buffer[1024];
-		size_t len, size;
+		size_t size;
 
 		/* Open the file ... */
 		FILE *f = FioFOpenFile(filename, "rb", this->dir, &size);
 		if (f == nullptr) return false;
 
 		/* ... calculate md5sum... */
-		while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, f)) != 0 && size != 0) {
-			size -= len;
-			checksum.Append(buffer, len);
-		}
-
-		MD5Hash tmp_md5sum;
-		checksum.Finish(tmp_md5sum);
+		MD5Hash tmp_md5sum = CalcFileMD5(f, size, filename, this->dir);
 
 		FioFCloseFile(f);
 
@@ -33,9 +33,28 @@
 #define SCRIPT_DEBUG_ALLOCATIONS
  */
 
+/**
+ * Allocator for the memory of one script. Small allocations, which are most of what
+ * Squirrel allocates, are taken from per size class free lists in larger chunks, so
+ * they do not fragment the heap and the chunks are released at once with the script.
+ */
 struct ScriptAllocator {
+	static constexpr size_t SIZE_CLASS_STEP = 16;   ///< Difference between the block sizes of two size classes.
+	static constexpr size_t SIZE_CLASSES = 16;      ///< Number of size classes; larger allocations are taken from the heap.
+	static constexpr size_t CHUNK_SIZE = 64 * 1024; ///< Size of the chunks the blocks of the size classes are taken from.
+
+	/** A free block of a size class. */
+	struct FreeBlock {
+		FreeBlock *next; ///< The next free block of the size class.
+	};
+
 	size_t allocated_size;   ///< Sum of allocated data size
 	size_t allocation_limit; ///< Maximum this allocator may use before allocations fail
+	std::array<FreeBlock *, SIZE_CLASSES> free_blocks{}; ///< The free blocks per size class.
+	std::array<ScriptAllocationStats, SIZE_CLASSES + 1> stats{}; ///< The allocations per size class, and of the larger ones.
+	std::vector<void *> chunks; ///< The chunks the blocks of the size classes are taken from.
+	char *chunk_pos = nullptr;  ///< Start of the unused part of the last chunk.
+	char *chunk_end = nullptr;  ///< End of the last chunk.
 	/**
 	 * Whether the error has already been thrown, so to not throw secondary errors in
 	 * the handling of the allocation error. This as the handling of the error will
@@ -55,6 +74,71 @@ struct ScriptAllocator {
 		if (this->allocated_size > this->allocation_limit) throw Script_FatalError("Maximum memory allocation exceeded");
 	}
 
+	/**
+	 * Get the size class of an allocation.
+	 * @param size The size of the allocation.
+	 * @return The size class, or #SIZE_CLASSES when it is too large for one.
+	 */
+	static size_t GetSizeClass(size_t size)
+	{
+		if (size == 0) return 0;
+		return std::min((size - 1) / SIZE_CLASS_STEP, SIZE_CLASSES);
+	}
+
+	/**
+	 * Allocate memory, without checking the limit.
+	 * @param size The size to allocate.
+	 * @return The memory, or nullptr when the OS did not have enough.
+	 */
+	void *Allocate(size_t size)
+	{
+		size_t size_class = GetSizeClass(size);
+		void *p;
+		if (size_class == SIZE_CLASSES) {
+			p = malloc(size);
+			if (p == nullptr) return nullptr;
+		} else if (this->free_blocks[size_class] != nullptr) {
+			p = this->free_blocks[size_class];
+			this->free_blocks[size_class] = this->free_blocks[size_class]->next;
+		} else {
+			size_t block_size = (size_class + 1) * SIZE_CLASS_STEP;
+			if (static_cast<size_t>(this->chunk_end - this->chunk_pos) < block_size) {
+				char *chunk = static_cast<char *>(malloc(CHUNK_SIZE));
+				if (chunk == nullptr) return nullptr;
+				this->chunks.push_back(chunk);
+				this->chunk_pos = chunk;
+				this->chunk_end = chunk + CHUNK_SIZE;
+			}
+			p = this->chunk_pos;
+			this->chunk_pos += block_size;
+		}
+
+		this->stats[size_class].count++;
+		this->stats[size_class].bytes += size;
+		return p;
+	}
+
+	/**
+	 * Release memory allocated by #Allocate.
+	 * @param p The memory.
+	 * @param size The size it was allocated with.
+	 */
+	void Release(void *p, size_t size)
+	{
+		size_t size_class = GetSizeClass(size);
+		this->stats[size_class].count--;
+		this->stats[size_class].bytes -= size;
+
+		if (size_class == SIZE_CLASSES) {
+			free(p);
+			return;
+		}
+
+		FreeBlock *block = static_cast<FreeBlock *>(p);
+		block->next = this->free_blocks[size_class];
+		this->free_blocks[size_class] = block;
+	}
+
 	/**
 	 * Catch all validation for the allocation; did it allocate too much memory according
 	 * to the allocation limit or did the allocation at the OS level maybe fail? In those
@@ -63,8 +147,9 @@ struct ScriptAllocator {
 	 * clean everything up.
 	 * @param requested_size The requested size that was requested to be allocated.
 	 * @param p              The pointer to the allocated object, or null if allocation failed.
+	 * @param size           The size the object was allocated with.
 	 */
-	void CheckAllocation(size_t requested_size, void *p)
+	void CheckAllocation(size_t requested_size, void *p, size_t size)
 	{
 		if (this->allocated_size + requested_size > this->allocation_limit && !this->error_thrown) {
 			/* Do not allow allocating more than the allocation limit, except when an error is
@@ -74,7 +159,7 @@ struct ScriptAllocator {
 			std::string msg = fmt::format("Maximum memory allocation exceeded by {} bytes when allocating {} bytes",
 				this->allocated_size + requested_size - this->allocation_limit, requested_size);
 			/* Don't leak the rejected allocation. */
-			free(p);
+			if (p != nullptr) this->Release(p, size);
 			throw Script_FatalError(msg);
 		}
 
@@ -96,9 +181,9 @@ struct ScriptAllocator {
 
 	void *Malloc(SQUnsignedInteger size)
 	{
-		void *p = malloc(size);
+		void *p = this->Allocate(size);
 
-		this->CheckAllocation(size, p);
+		this->CheckAllocation(size, p, size);
 
 		this->allocated_size += size;
 
@@ -125,17 +210,30 @@ struct ScriptAllocator {
 		assert(this->allocations[p] == oldsize);
 		this->allocations.erase(p);
 #endif
+		size_t size_class = GetSizeClass(size);
+		if (size_class < SIZE_CLASSES && size_class == GetSizeClass(oldsize) && (size <= oldsize || this->allocated_size + (size - oldsize) <= this->allocation_limit)) {
+			/* The block of the size class is large enough already. */
+			this->stats[size_class].bytes -= oldsize;
+			this->stats[size_class].bytes += size;
+			this->allocated_size -= oldsize;
+			this->allocated_size += size;
+#ifdef SCRIPT_DEBUG_ALLOCATIONS
+			this->allocations[p] = size;
+#endif
+			return p;
+		}
+
 		/* Can't use realloc directly because memory limit check.
 		 * If memory exception is thrown, the old pointer is expected
 		 * to be valid for engine cleanup.
 		 */
-		void *new_p = malloc(size);
+		void *new_p = this->Allocate(size);
 
-		this->CheckAllocation(size - oldsize, new_p);
+		this->CheckAllocation(size - oldsize, new_p, size);
 
 		/* Memory limit test passed, we can copy data and free old pointer. */
 		memcpy(new_p, p, std::min(oldsize, size));
-		free(p);
+		this->Release(p, oldsize);
 
 		this->allocated_size -= oldsize;
 		this->allocated_size += size;
@@ -152,7 +250,7 @@ struct ScriptAllocator {
 	void Free(void *p, SQUnsignedInteger size)
 	{
 		if (p == nullptr) return;
-		free(p);
+		this->Release(p, size);
 		this->allocated_size -= size;
 
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
@@ -174,6 +272,8 @@ struct ScriptAllocator {
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
 		assert(this->allocations.empty());
 #endif
+		/* Whatever was not freed is freed with its chunk. */
+		for (void *chunk : this->chunks) free(chunk);
 	}
 };
 
@@ -200,6 +300,16 @@ size_t Squirrel::GetAllocatedMemory() const noexcept
 	return this->allocator->allocated_size;
 }
 
+std::vector<ScriptAllocationStats> Squirrel::GetAllocationStats(size_t &reserved) const
+{
+	assert(this->allocator != nullptr);
+	reserved = this->allocator->chunks.size() * ScriptAllocator::CHUNK_SIZE;
+
+	std::vector<ScriptAllocationStats> stats(this->allocator->stats.begin(), this->allocator->stats.end());
+	for (size_t i = 0; i < ScriptAllocator::SIZE_CLASSES; i++) stats[i].block_size = (i + 1) * ScriptAllocator::SIZE_CLASS_STEP;
+	return stats;
+}
+
 
 void Squirrel::CompileError(HSQUIRRELVM vm, const SQChar *desc, const SQChar *source, SQInteger line, SQInteger column)
 {
@@ -376,12 +486,47 @@ bool Squirrel::Resume(int suspend)
 		suspend = -this->overdrawn_ops;
 	}
 
+	/* Do not attribute the time between two runs to the script. */
+	if (this->profile_interval != 0) this->profile_last_sample = std::chrono::steady_clock::now();
+
 	this->crashed = !sq_resumecatch(this->vm, suspend);
 	this->overdrawn_ops = -this->vm->_ops_till_suspend;
 	this->allocator->CheckLimit();
 	return this->vm->_suspended != 0;
 }
 
+/* static */ void Squirrel::ProfileSample(HSQUIRRELVM vm)
+{
+	Squirrel *engine = (Squirrel *)sq_getforeignptr(vm);
+
+	/* Collect the frames from the outermost to the innermost one. */
+	std::vector<const char *> frames;
+	SQStackInfos si;
+	for (SQInteger level = 0; SQ_SUCCEEDED(sq_stackinfos(vm, level, &si)); level++) {
+		frames.push_back(si.funcname != nullptr ? si.funcname : "unknown");
+	}
+
+	std::string stack;
+	for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+		if (!stack.empty()) stack += ';';
+		stack += *it;
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	auto &[ops, time] = engine->profile[stack];
+	ops += engine->profile_interval;
+	time += std::chrono::duration_cast<std::chrono::microseconds>(now - engine->profile_last_sample).count();
+	engine->profile_last_sample = now;
+}
+
+void Squirrel::SetProfiling(SQInteger interval)
+{
+	if (interval != 0) this->profile.clear();
+	this->profile_interval = interval;
+	this->profile_last_sample = std::chrono::steady_clock::now();
+	sq_setprofilehook(this->vm, interval != 0 ? &Squirrel::ProfileSample : nullptr, interval);
+}
+
 void Squirrel::ResumeError()
 {
 	assert(!this->crashed);
@@ -538,6 +683,9 @@ void Squirrel::Initialize()
 	/* Set the foreign pointer, so we can always find this instance from within the VM */
 	sq_setforeignptr(this->vm, this);
 
+	/* Keep profiling when the engine is reset. */
+	if (this->profile_interval != 0) sq_setprofilehook(this->vm, &Squirrel::ProfileSample, this->profile_interval);
+
 	sq_pushroottable(this->vm);
 	squirrel_register_global_std(this);
 
@@ -11,6 +11,7 @@
 #define SQUIRREL_HPP
 
 #include <squirrel.h>
+#include <chrono>
 
 /** The type of script we're working with, i.e. for who is it? */
 enum class ScriptType {
@@ -20,6 +21,13 @@ enum class ScriptType {
 
 struct ScriptAllocator;
 
+/** The allocations of a script of one size class. */
+struct ScriptAllocationStats {
+	size_t block_size; ///< Size of the blocks of the size class, or 0 for the allocations too large for a size class.
+	size_t count;      ///< Number of allocations.
+	size_t bytes;      ///< Number of bytes requested by the allocations.
+};
+
 class Squirrel {
 	friend class ScriptAllocatorScope;
 
@@ -33,6 +41,14 @@ private:
 	int overdrawn_ops;       ///< The amount of operations we have overdrawn.
 	const char *APIName;     ///< Name of the API used for this squirrel.
 	std::unique_ptr<ScriptAllocator> allocator; ///< Allocator object used by this script.
+	SQInteger profile_interval = 0; ///< Number of opcodes between two samples of the call stack, or 0 when not profiling.
+	std::chrono::steady_clock::time_point profile_last_sample; ///< Time of the last sample of the call stack.
+	std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> profile; ///< Opcodes and microseconds per call stack, with the frames separated by ';'.
+
+	/**
+	 * Sample the call stack of the script for the profile.
+	 */
+	static void ProfileSample(HSQUIRRELVM vm);
 
 	/**
 	 * The internal RunError handler. It looks up the real error and calls RunError with it.
@@ -280,6 +296,26 @@ public:
 	 * Get number of bytes allocated by this VM.
 	 */
 	size_t GetAllocatedMemory() const noexcept;
+
+	/**
+	 * Get the allocations of this VM by size class.
+	 * @param[out] reserved The memory reserved for the allocations of the size classes.
+	 * @return The allocations per size class, followed by the allocations too large for a size class.
+	 */
+	std::vector<ScriptAllocationStats> GetAllocationStats(size_t &reserved) const;
+
+	/**
+	 * Start or stop sampling the call stack of the script, attributing the opcodes and the
+	 * time since the previous sample to the functions on it. Starting clears the profile.
+	 * @param interval Number of opcodes between two samples, or 0 to stop.
+	 */
+	void SetProfiling(SQInteger interval);
+
+	/**
+	 * Get the profile of the script.
+	 * @return Per call stack, with the frames separated by ';', the opcodes and microseconds spent in it.
+	 */
+	const std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> &GetProfile() const { return this->profile; }
 };
 
 
@@ -1607,6 +1607,7 @@ void IntSettingDesc::ChangeValue(const void *object, int32_t newval) const
 
 	this->Write(object, newval);
 	if (this->post_callback != nullptr) this->post_callback(newval);
+	ClearFormattedStringCache();
 
 	if (this->flags & SF_NO_NETWORK) {
 		_gamelog.StartAction(GLAT_SETTING);
@@ -1628,22 +1629,41 @@ void IntSettingDesc::ChangeValue(const void *object, int32_t newval) const
  */
 static const SettingDesc *GetSettingFromName(const std::string_view name, const SettingTable &settings)
 {
-	/* First check all full names */
-	for (auto &desc : settings) {
-		const SettingDesc *sd = GetSettingDesc(desc);
-		if (!SlIsObjectCurrentlyValid(sd->save.version_from, sd->save.version_to)) continue;
-		if (sd->GetName() == name) return sd;
+	/** The settings of a table by their full name and by the shortcut variants of their name, in table order. */
+	struct SettingNameIndex {
+		std::unordered_map<std::string_view, std::vector<const SettingDesc *>> full_names;
+		std::unordered_map<std::string_view, std::vector<const SettingDesc *>> short_names;
+	};
+	/* The tables are static, so their index can be made once. Which settings exist
+	 * depends on the savegame version being loaded, which is checked afterwards. */
+	static std::map<const SettingVariant *, SettingNameIndex> indices;
+
+	auto [it, inserted] = indices.try_emplace(settings.data());
+	SettingNameIndex &index = it->second;
+	if (inserted) {
+		for (auto &desc : settings) {
+			const SettingDesc *sd = GetSettingDesc(desc);
+			std::string_view full_name = sd->GetName();
+			index.full_names[full_name].push_back(sd);
+			for (size_t dot = full_name.find('.'); dot != std::string_view::npos; dot = full_name.find('.', dot + 1)) {
+				index.short_names[full_name.substr(dot + 1)].push_back(sd);
+			}
+		}
 	}
 
-	/* Then check the shortcut variant of the name. */
-	std::string short_name_suffix = std::string{ "." }.append(name);
-	for (auto &desc : settings) {
-		const SettingDesc *sd = GetSettingDesc(desc);
-		if (!SlIsObjectCurrentlyValid(sd->save.version_from, sd->save.version_to)) continue;
-		if (sd->GetName().ends_with(short_name_suffix)) return sd;
-	}
+	auto find_valid = [name](const auto &names) -> const SettingDesc * {
+		auto found = names.find(name);
+		if (found == names.end()) return nullptr;
+		for (const SettingDesc *sd : found->second) {
+			if (SlIsObjectCurrentlyValid(sd->save.version_from, sd->save.version_to)) return sd;
+		}
+		return nullptr;
+	};
 
-	return nullptr;
+	/* First check all full names, then the shortcut variant of the name. */
+	const SettingDesc *sd = find_valid(index.full_names);
+	if (sd == nullptr) sd = find_valid(index.short_names);
+	return sd;
 }
 
 /**
@@ -1850,6 +1870,7 @@ void StringSettingDesc::ChangeValue(const void *object, std::string &newval) con
 
 	this->Write(object, newval);
 	if (this->post_callback != nullptr) this->post_callback(newval);
+	ClearFormattedStringCache();
 
 	if (_save_config) SaveToConfig();
 }
@@ -2139,6 +2139,7 @@ static SettingsContainer &GetSettingsTree()
 			limitations->Add(new SettingEntry("vehicle.max_roadveh"));
 			limitations->Add(new SettingEntry("vehicle.max_aircraft"));
 			limitations->Add(new SettingEntry("vehicle.max_ships"));
+			limitations->Add(new SettingEntry("vehicle.max_autoreplace_per_tick"));
 			limitations->Add(new SettingEntry("vehicle.max_train_length"));
 			limitations->Add(new SettingEntry("station.station_spread"));
 			limitations->Add(new SettingEntry("station.distant_join_stations"));
@@ -2198,6 +2199,7 @@ static SettingsContainer &GetSettingsTree()
 			{
 				towns->Add(new SettingEntry("economy.town_cargo_scale"));
 				towns->Add(new SettingEntry("economy.town_growth_rate"));
+				towns->Add(new SettingEntry("economy.town_growth_backoff"));
 				towns->Add(new SettingEntry("economy.allow_town_roads"));
 				towns->Add(new SettingEntry("economy.allow_town_level_crossings"));
 				towns->Add(new SettingEntry("economy.found_town"));
@@ -2223,6 +2225,8 @@ static SettingsContainer &GetSettingsTree()
 			{
 				cdist->Add(new SettingEntry("linkgraph.recalc_time"));
 				cdist->Add(new SettingEntry("linkgraph.recalc_interval"));
+				cdist->Add(new SettingEntry("linkgraph.postpone_overdue_jobs"));
+				cdist->Add(new SettingEntry("linkgraph.skip_unchanged_jobs"));
 				cdist->Add(new SettingEntry("linkgraph.distribution_pax"));
 				cdist->Add(new SettingEntry("linkgraph.distribution_mail"));
 				cdist->Add(new SettingEntry("linkgraph.distribution_armoured"));
@@ -3036,12 +3040,14 @@ struct CustomCurrencyWindow : Window {
 				if (GetCustomCurrency().rate > 1) GetCustomCurrency().rate--;
 				if (GetCustomCurrency().rate == 1) this->DisableWidget(WID_CC_RATE_DOWN);
 				this->EnableWidget(WID_CC_RATE_UP);
+				ClearFormattedStringCache();
 				break;
 
 			case WID_CC_RATE_UP:
 				if (GetCustomCurrency().rate < UINT16_MAX) GetCustomCurrency().rate++;
 				if (GetCustomCurrency().rate == UINT16_MAX) this->DisableWidget(WID_CC_RATE_UP);
 				this->EnableWidget(WID_CC_RATE_DOWN);
+				ClearFormattedStringCache();
 				break;
 
 			case WID_CC_RATE:
@@ -3080,12 +3086,14 @@ struct CustomCurrencyWindow : Window {
 				GetCustomCurrency().to_euro = (GetCustomCurrency().to_euro <= MIN_EURO_YEAR) ? CF_NOEURO : GetCustomCurrency().to_euro - 1;
 				if (GetCustomCurrency().to_euro == CF_NOEURO) this->DisableWidget(WID_CC_YEAR_DOWN);
 				this->EnableWidget(WID_CC_YEAR_UP);
+				ClearFormattedStringCache();
 				break;
 
 			case WID_CC_YEAR_UP:
 				GetCustomCurrency().to_euro = Clamp(GetCustomCurrency().to_euro + 1, MIN_EURO_YEAR, CalendarTime::MAX_YEAR);
 				if (GetCustomCurrency().to_euro == CalendarTime::MAX_YEAR) this->DisableWidget(WID_CC_YEAR_UP);
 				this->EnableWidget(WID_CC_YEAR_DOWN);
+				ClearFormattedStringCache();
 				break;
 
 			case WID_CC_YEAR:
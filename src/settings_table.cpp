@@ -45,11 +45,14 @@
 #include "smallmap_gui.h"
 #include "roadveh.h"
 #include "roadveh_cmd.h"
+#include "saveload/saveload.h"
 #include "vehicle_func.h"
 #include "viewport_func.h"
 #include "void_map.h"
 #include "station_func.h"
 #include "station_base.h"
+#include "thread.h"
+#include "framerate_type.h"
 
 #include "table/strings.h"
 #include "table/settings.h"
@@ -293,17 +293,24 @@ struct NewsSettings {
 /** All settings related to the network. */
 struct NetworkSettings {
 	uint16_t      sync_freq;                                ///< how often do we check whether we are still in-sync
+	bool        sync_state_hash;                          ///< send hashes of parts of the game state with the sync checks, to find where a client desynced
 	uint8_t       frame_freq;                               ///< how often do we send commands to the clients
 	uint16_t      commands_per_frame;                       ///< how many commands may be sent each frame_freq frames?
 	uint16_t      commands_per_frame_server;                ///< how many commands may be sent each frame_freq frames? (server-originating commands)
 	uint16_t      max_commands_in_queue;                    ///< how many commands may there be in the incoming queue before dropping the connection?
+	bool        batch_commands;                           ///< send all commands of a frame to a client in as few packets as possible?
+	bool        compress_stream;                          ///< compress the packets sent to clients that support it?
+	uint8_t       spectator_frame_freq;                     ///< how often do we send commands to spectators? 0 for as often as to the other clients
 	uint16_t      bytes_per_frame;                          ///< how many bytes may, over a long period, be received per frame?
 	uint16_t      bytes_per_frame_burst;                    ///< how many bytes may, over a short period, be received?
+	uint32_t      map_bytes_per_frame;                      ///< how many bytes of the map may, over a long period, be sent to each joining client? 0 for no limit
 	uint16_t      max_init_time;                            ///< maximum amount of time, in game ticks, a client may take to initiate joining
 	uint16_t      max_join_time;                            ///< maximum amount of time, in game ticks, a client may take to sync up during joining
 	uint16_t      max_download_time;                        ///< maximum amount of time, in game ticks, a client may take to download the map
+	uint16_t      max_map_snapshot_age;                     ///< maximum age, in game ticks, of the last map snapshot for a joining client to start with instead of making a new one
 	uint16_t      max_password_time;                        ///< maximum amount of time, in game ticks, a client may take to enter the password
 	uint16_t      max_lag_time;                             ///< maximum amount of time, in game ticks, a client may be lagging behind the server
+	uint16_t      admin_performance_interval;               ///< how often, in game ticks, do we send the performance measurements to the admins that want them
 	bool        pause_on_join;                            ///< pause the game when people join
 	uint16_t      server_port;                              ///< port the server listens on
 	uint16_t      server_admin_port;                        ///< port the server listens on for the admin network
@@ -333,6 +340,7 @@ struct NetworkSettings {
 	uint16_t      restart_hours;                          ///< number of hours to run the server before automatic restart
 	uint8_t       min_active_clients;                       ///< minimum amount of active clients to unpause the game
 	bool        reload_cfg;                               ///< reload the config file before restarting
+	uint8_t       content_download_connections;             ///< how many content files may be downloaded over HTTP at the same time?
 	std::string last_joined;                              ///< Last joined server
 	UseRelayService use_relay_service;                    ///< Use relay service?
 	ParticipateSurvey participate_survey;                 ///< Participate in the automated survey
@@ -535,6 +543,7 @@ struct VehicleSettings {
 	uint8_t extend_vehicle_life;              ///< extend vehicle life by this many years
 	uint8_t road_side;                        ///< the side of the road vehicles drive on
 	uint8_t  plane_crashes;                    ///< number of plane crashes, 0 = none, 1 = reduced, 2 = normal
+	uint16_t max_autoreplace_per_tick;         ///< max autoreplaces and autorenews per tick, 0 = no limit
 };
 
 /** Settings related to the economy. */
@@ -551,6 +560,7 @@ struct EconomySettings {
 	bool   mod_road_rebuild;                 ///< roadworks remove unnecessary RoadBits
 	bool   multiple_industry_per_town;       ///< allow many industries of the same type per town
 	uint8_t  town_growth_rate;                 ///< town growth rate
+	bool   town_growth_backoff;              ///< towns that fail to grow wait longer each time before retrying
 	uint8_t  larger_towns;                     ///< the number of cities to build. These start off larger and grow twice as fast
 	uint8_t  initial_city_size;                ///< multiplier for the initial size of the cities compared to towns
 	TownLayout town_layout;                  ///< select town layout, @see TownLayout
@@ -570,6 +580,8 @@ struct EconomySettings {
 struct LinkGraphSettings {
 	uint16_t recalc_time;                     ///< time (in days) for recalculating each link graph component.
 	uint16_t recalc_interval;                 ///< time (in days) between subsequent checks for link graphs to be calculated.
+	bool postpone_overdue_jobs;               ///< postpone the join of jobs that are not finished in time instead of pausing the game.
+	bool skip_unchanged_jobs;                 ///< skip recalculating link graphs that did not change noticeably since their last job.
 	DistributionType distribution_pax;      ///< distribution type for passengers
 	DistributionType distribution_mail;     ///< distribution type for mail
 	DistributionType distribution_armoured; ///< distribution type for armoured cargo class
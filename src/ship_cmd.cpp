@@ -34,9 +34,12 @@
 #include "tunnelbridge_map.h"
 #include "zoom_func.h"
 #include "framerate_type.h"
+#include "trace.h"
 #include "industry.h"
 #include "industry_map.h"
 #include "ship_cmd.h"
+#include "thread.h"
+#include "pathfinder/water_regions.h"
 
 #include "table/strings.h"
 
@@ -169,7 +172,7 @@ static const Depot *FindClosestShipDepot(const Vehicle *v, uint max_distance)
 		patches_to_search.pop_front();
 
 		/* Add neighbors of the current patch to the search queue. */
-		TVisitWaterRegionPatchCallBack visitFunc = [&](const WaterRegionPatchDesc &water_region_patch) {
+		auto visitFunc = [&](const WaterRegionPatchDesc &water_region_patch) {
 			/* Note that we check the max distance per axis, not the total distance. */
 			if (std::abs(water_region_patch.x - start_patch.x) > max_region_distance ||
 					std::abs(water_region_patch.y - start_patch.y) > max_region_distance) return;
@@ -496,6 +499,56 @@ static void ShipArrivesAt(const Vehicle *v, Station *st)
 }
 
 
+static const size_t MIN_SHIP_PATHS_PER_THREAD = 8; ///< Minimum number of queued ship paths worth handing to an extra thread.
+
+/** Ships that used up their cached path during this tick, in the order they did so. */
+static std::vector<VehicleID> _ship_path_requests;
+
+/**
+ * Searches the paths for all ships that used up their cached path during this tick.
+ * This is done after all vehicles have moved, so all searches see the same state of the
+ * game and do not change it; this makes it safe to spread them over multiple threads.
+ * The results are then stored in vehicle order, so the outcome does not depend on the
+ * number of threads. Searches that would need a random choice are left to the ship
+ * itself, which will run the pathfinder as usual when it enters its next tile.
+ */
+void RunQueuedShipPathSearches()
+{
+	if (_ship_path_requests.empty()) return;
+
+	PerformanceAccumulator framerate(PFE_GL_SHIPS);
+
+	struct ShipPathSearch {
+		Ship *v;
+		ShipPathCache path;
+		bool path_found;
+	};
+	static std::vector<ShipPathSearch> searches;
+	searches.clear();
+
+	for (VehicleID index : _ship_path_requests) {
+		Ship *v = Ship::GetIfValid(index);
+		if (v == nullptr || !v->path.empty() || v->dest_tile == 0) continue;
+		if ((v->vehstatus & VS_CRASHED) != 0 || v->state == TRACK_BIT_DEPOT || v->state == TRACK_BIT_WORMHOLE) continue;
+		if (!searches.empty() && searches.back().v == v) continue;
+		searches.push_back({ v, {}, false });
+	}
+	_ship_path_requests.clear();
+
+	/* Water regions are normally updated when they are first used; do that now so the searches only read them. */
+	UpdateInvalidatedWaterRegions();
+
+	RunInChunks(std::span<ShipPathSearch>(searches), MIN_SHIP_PATHS_PER_THREAD, [](std::span<ShipPathSearch> chunk) {
+		for (ShipPathSearch &search : chunk) search.path_found = YapfShipFindPathAhead(search.v, search.path);
+	});
+
+	for (ShipPathSearch &search : searches) {
+		if (!search.path_found) continue;
+		search.v->path = std::move(search.path);
+		search.v->HandlePathfindingResult(true);
+	}
+}
+
 /**
  * Runs the pathfinder to choose a track to continue along.
  *
@@ -522,6 +575,8 @@ static Track ChooseShipTrack(Ship *v, TileIndex tile, TrackBits tracks)
 
 			if (HasBit(tracks, track)) {
 				v->path.pop_front();
+				/* Search the path beyond this one together with the other ships once all vehicles have moved. */
+				if (v->path.empty() && _settings_game.pf.pathfinder_for_ships == VPF_YAPF) _ship_path_requests.push_back(v->index);
 				/* HandlePathfindResult() is not called here because this is not a new pathfinder result. */
 				return track;
 			}
@@ -885,6 +940,8 @@ static void ShipController(Ship *v)
 bool Ship::Tick()
 {
 	PerformanceAccumulator framerate(PFE_GL_SHIPS);
+	TraceScope trace("Ship tick", this->index);
+	CompanyPerformanceMeasurer company_framerate(CPE_VEHICLES, this->owner);
 
 	if (!(this->vehstatus & VS_STOPPED)) this->running_ticks++;
 
@@ -188,11 +188,63 @@ static SmallSet<DiagDirection, SIG_GLOB_SIZE> _globset("_globset"); ///< set of
 
 
 /** Check whether there is a train on rail, not in a depot */
-static Vehicle *TrainOnTileEnum(Vehicle *v, void *)
+static bool IsTrainOnRail(const Vehicle *v)
 {
-	if (v->type != VEH_TRAIN || Train::From(v)->track == TRACK_BIT_DEPOT) return nullptr;
+	return v->type == VEH_TRAIN && Train::From(v)->track != TRACK_BIT_DEPOT;
+}
+
+
+/** Current signal block state flags */
+enum SigFlags {
+	SF_NONE   = 0,
+	SF_TRAIN  = 1 << 0, ///< train found in segment
+	SF_EXIT   = 1 << 1, ///< exitsignal found
+	SF_EXIT2  = 1 << 2, ///< two or more exits found
+	SF_GREEN  = 1 << 3, ///< green exitsignal found
+	SF_GREEN2 = 1 << 4, ///< two or more green exits found
+	SF_FULL   = 1 << 5, ///< some of buffers was full, do not continue
+	SF_PBS    = 1 << 6, ///< pbs signal found
+};
+
+DECLARE_ENUM_AS_BIT_SET(SigFlags)
+
+
+/**
+ * Everything ExploreSegment found out about a signal block that does not change
+ * while trains move. Only the trains and the states of the exit signals have to
+ * be checked again when the signals around the block are updated another time.
+ */
+struct SignalBlock {
+	/** Tile of the block that may be occupied by a train. */
+	struct TrainCheck {
+		TileIndex tile;
+		TrackBits tracks; ///< Tracks to check, or TRACK_BIT_NONE for any train on the tile that is not in a depot.
+	};
+
+	std::vector<TrainCheck> train_checks; ///< Tiles that may be occupied by a train.
+	std::vector<std::pair<TileIndex, Trackdir>> signals; ///< Signals to update, in the order they were found.
+	std::vector<std::pair<TileIndex, Trackdir>> exits; ///< Presignal exits leading out of the block.
+	std::vector<std::pair<TileIndex, DiagDirection>> visited; ///< Tile sides to remove from _globset, in the order they were found.
+	SigFlags flags = SF_NONE; ///< SF_PBS and SF_FULL, when they were found.
+};
+
+/**
+ * Signal blocks that were already explored, by the tile side the update started from
+ * and the owner. Exploring depends only on the map, so using a block from here gives
+ * exactly the same result as exploring it again. The whole index is cleared whenever
+ * rail, signals, or the ownership of tiles change; see #InvalidateSignalBlocks.
+ */
+static std::unordered_map<uint64_t, SignalBlock> _signal_blocks;
 
-	return v;
+/** Limit on the number of blocks in #_signal_blocks before it is cleared. */
+static const size_t SIG_BLOCKS_MAX = 1 << 16;
+
+/**
+ * Forget all explored signal blocks, because the track layout or signals changed.
+ */
+void InvalidateSignalBlocks()
+{
+	if (!_signal_blocks.empty()) _signal_blocks.clear();
 }
 
 
@@ -203,16 +255,17 @@ static Vehicle *TrainOnTileEnum(Vehicle *v, void *)
  * Also, remove reverse direction from _tbdset
  * This is the 'core' part so the graph searching won't enter any tile twice
  *
+ * @param block block being explored, to which the _globset removals are recorded
  * @param t1 tile we are entering
  * @param d1 direction (tile side) we are entering
  * @param t2 tile we are leaving
  * @param d2 direction (tile side) we are leaving
  * @return false iff reverse direction was in Todo set
  */
-static inline bool CheckAddToTodoSet(TileIndex t1, DiagDirection d1, TileIndex t2, DiagDirection d2)
+static inline bool CheckAddToTodoSet(SignalBlock &block, TileIndex t1, DiagDirection d1, TileIndex t2, DiagDirection d2)
 {
-	_globset.Remove(t1, d1); // it can be in Global but not in Todo
-	_globset.Remove(t2, d2); // remove in all cases
+	block.visited.emplace_back(t1, d1); // it can be in Global but not in Todo
+	block.visited.emplace_back(t2, d2); // remove in all cases
 
 	assert(!_tbdset.IsIn(t1, d1)); // it really shouldn't be there already
 
@@ -233,38 +286,23 @@ static inline bool CheckAddToTodoSet(TileIndex t1, DiagDirection d1, TileIndex t
  * @param d2 direction (tile side) we are leaving
  * @return false iff the Todo buffer would be overrun
  */
-static inline bool MaybeAddToTodoSet(TileIndex t1, DiagDirection d1, TileIndex t2, DiagDirection d2)
+static inline bool MaybeAddToTodoSet(SignalBlock &block, TileIndex t1, DiagDirection d1, TileIndex t2, DiagDirection d2)
 {
-	if (!CheckAddToTodoSet(t1, d1, t2, d2)) return true;
+	if (!CheckAddToTodoSet(block, t1, d1, t2, d2)) return true;
 
 	return _tbdset.Add(t1, d1);
 }
 
 
-/** Current signal block state flags */
-enum SigFlags {
-	SF_NONE   = 0,
-	SF_TRAIN  = 1 << 0, ///< train found in segment
-	SF_EXIT   = 1 << 1, ///< exitsignal found
-	SF_EXIT2  = 1 << 2, ///< two or more exits found
-	SF_GREEN  = 1 << 3, ///< green exitsignal found
-	SF_GREEN2 = 1 << 4, ///< two or more green exits found
-	SF_FULL   = 1 << 5, ///< some of buffers was full, do not continue
-	SF_PBS    = 1 << 6, ///< pbs signal found
-};
-
-DECLARE_ENUM_AS_BIT_SET(SigFlags)
-
-
 /**
- * Search signal block
+ * Search signal block, starting from the open nodes in _tbdset
  *
  * @param owner owner whose signals we are updating
- * @return SigFlags
+ * @param block the block to fill with the tiles and signals that are found
  */
-static SigFlags ExploreSegment(Owner owner)
+static void ExploreSegment(Owner owner, SignalBlock &block)
 {
-	SigFlags flags = SF_NONE;
+	SigFlags &flags = block.flags;
 
 	TileIndex tile = INVALID_TILE; // Stop GCC from complaining about a possibly uninitialized variable (issue #8280).
 	DiagDirection enterdir = INVALID_DIAGDIR;
@@ -279,13 +317,13 @@ static SigFlags ExploreSegment(Owner owner)
 
 				if (IsRailDepot(tile)) {
 					if (enterdir == INVALID_DIAGDIR) { // from 'inside' - train just entered or left the depot
-						if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+						block.train_checks.push_back({tile, TRACK_BIT_NONE});
 						exitdir = GetRailDepotDirection(tile);
 						tile += TileOffsByDiagDir(exitdir);
 						enterdir = ReverseDiagDir(exitdir);
 						break;
 					} else if (enterdir == GetRailDepotDirection(tile)) { // entered a depot
-						if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+						block.train_checks.push_back({tile, TRACK_BIT_NONE});
 						continue;
 					} else {
 						continue;
@@ -298,11 +336,10 @@ static SigFlags ExploreSegment(Owner owner)
 
 				if (tracks == TRACK_BIT_HORZ || tracks == TRACK_BIT_VERT) { // there is exactly one incidating track, no need to check
 					tracks = tracks_masked;
-					/* If no train detected yet, and there is not no train -> there is a train -> set the flag */
-					if (!(flags & SF_TRAIN) && EnsureNoTrainOnTrackBits(tile, tracks).Failed()) flags |= SF_TRAIN;
+					block.train_checks.push_back({tile, tracks});
 				} else {
 					if (tracks_masked == TRACK_BIT_NONE) continue; // no incidating track
-					if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+					block.train_checks.push_back({tile, TRACK_BIT_NONE});
 				}
 
 				if (HasSignals(tile)) { // there is exactly one track - not zero, because there is exit from this tile
@@ -317,21 +354,18 @@ static SigFlags ExploreSegment(Owner owner)
 						if (HasSignalOnTrackdir(tile, reversedir)) {
 							if (IsPbsSignal(sig)) {
 								flags |= SF_PBS;
-							} else if (!_tbuset.Add(tile, reversedir)) {
-								return flags | SF_FULL;
+							} else if (block.signals.size() == SIG_TBU_SIZE) {
+								Debug(misc, 0, "SignalSegment too complex. Set {} is full (maximum {})", "_tbuset", SIG_TBU_SIZE);
+								flags |= SF_FULL;
+								return;
+							} else {
+								block.signals.emplace_back(tile, reversedir);
 							}
 						}
 						if (HasSignalOnTrackdir(tile, trackdir) && !IsOnewaySignal(tile, track)) flags |= SF_PBS;
 
-						/* if it is a presignal EXIT in OUR direction and we haven't found 2 green exits yes, do special check */
-						if (!(flags & SF_GREEN2) && IsPresignalExit(tile, track) && HasSignalOnTrackdir(tile, trackdir)) { // found presignal exit
-							if (flags & SF_EXIT) flags |= SF_EXIT2; // found two (or more) exits
-							flags |= SF_EXIT; // found at least one exit - allow for compiler optimizations
-							if (GetSignalStateByTrackdir(tile, trackdir) == SIGNAL_STATE_GREEN) { // found green presignal exit
-								if (flags & SF_GREEN) flags |= SF_GREEN2;
-								flags |= SF_GREEN;
-							}
-						}
+						/* if it is a presignal EXIT in OUR direction, its state is checked every time the block is updated */
+						if (IsPresignalExit(tile, track) && HasSignalOnTrackdir(tile, trackdir)) block.exits.emplace_back(tile, trackdir);
 
 						continue;
 					}
@@ -341,7 +375,10 @@ static SigFlags ExploreSegment(Owner owner)
 					if (dir != enterdir && (tracks & _enterdir_to_trackbits[dir])) { // any track incidating?
 						TileIndex newtile = tile + TileOffsByDiagDir(dir);  // new tile to check
 						DiagDirection newdir = ReverseDiagDir(dir); // direction we are entering from
-						if (!MaybeAddToTodoSet(newtile, newdir, tile, dir)) return flags | SF_FULL;
+						if (!MaybeAddToTodoSet(block, newtile, newdir, tile, dir)) {
+							flags |= SF_FULL;
+							return;
+						}
 					}
 				}
 
@@ -354,7 +391,7 @@ static SigFlags ExploreSegment(Owner owner)
 				if (DiagDirToAxis(enterdir) != GetRailStationAxis(tile)) continue; // different axis
 				if (IsStationTileBlocked(tile)) continue; // 'eye-candy' station tile
 
-				if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+				block.train_checks.push_back({tile, TRACK_BIT_NONE});
 				tile += TileOffsByDiagDir(exitdir);
 				break;
 
@@ -363,7 +400,7 @@ static SigFlags ExploreSegment(Owner owner)
 				if (GetTileOwner(tile) != owner) continue;
 				if (DiagDirToAxis(enterdir) == GetCrossingRoadAxis(tile)) continue; // different axis
 
-				if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+				block.train_checks.push_back({tile, TRACK_BIT_NONE});
 				tile += TileOffsByDiagDir(exitdir);
 				break;
 
@@ -373,13 +410,13 @@ static SigFlags ExploreSegment(Owner owner)
 				DiagDirection dir = GetTunnelBridgeDirection(tile);
 
 				if (enterdir == INVALID_DIAGDIR) { // incoming from the wormhole
-					if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+					block.train_checks.push_back({tile, TRACK_BIT_NONE});
 					enterdir = dir;
 					exitdir = ReverseDiagDir(dir);
 					tile += TileOffsByDiagDir(exitdir); // just skip to next tile
 				} else { // NOT incoming from the wormhole!
 					if (ReverseDiagDir(enterdir) != dir) continue;
-					if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+					block.train_checks.push_back({tile, TRACK_BIT_NONE});
 					tile = GetOtherTunnelBridgeEnd(tile); // just skip to exit tile
 					enterdir = INVALID_DIAGDIR;
 					exitdir = INVALID_DIAGDIR;
@@ -391,9 +428,47 @@ static SigFlags ExploreSegment(Owner owner)
 				continue; // continue the while() loop
 		}
 
-		if (!MaybeAddToTodoSet(tile, enterdir, oldtile, exitdir)) return flags | SF_FULL;
+		if (!MaybeAddToTodoSet(block, tile, enterdir, oldtile, exitdir)) {
+			flags |= SF_FULL;
+			return;
+		}
+	}
+}
+
+
+/**
+ * Determine the state of an explored signal block, and queue its signals for updating
+ *
+ * @param block the explored block
+ * @return SigFlags
+ */
+static SigFlags CheckSignalBlock(const SignalBlock &block)
+{
+	SigFlags flags = block.flags;
+	if (flags & SF_FULL) return flags;
+
+	for (const auto &[tile, dir] : block.visited) _globset.Remove(tile, dir);
+
+	for (const SignalBlock::TrainCheck &check : block.train_checks) {
+		/* If no train detected yet, and there is not no train -> there is a train -> set the flag */
+		if (check.tracks == TRACK_BIT_NONE ? MayHaveTrainOnTile(check.tile) && HasVehicleOnPos(check.tile, IsTrainOnRail) : EnsureNoTrainOnTrackBits(check.tile, check.tracks).Failed()) {
+			flags |= SF_TRAIN;
+			break;
+		}
+	}
+
+	for (const auto &[tile, trackdir] : block.exits) {
+		if (flags & SF_EXIT) flags |= SF_EXIT2; // found two (or more) exits
+		flags |= SF_EXIT; // found at least one exit - allow for compiler optimizations
+		if (GetSignalStateByTrackdir(tile, trackdir) == SIGNAL_STATE_GREEN) { // found green presignal exit
+			if (flags & SF_GREEN) flags |= SF_GREEN2;
+			flags |= SF_GREEN;
+		}
+		if (flags & SF_GREEN2) break; // found 2 green exits, nothing more to know
 	}
 
+	for (const auto &[tile, trackdir] : block.signals) _tbuset.Add(tile, trackdir);
+
 	return flags;
 }
 
@@ -479,6 +554,8 @@ static SigSegState UpdateSignalsInBuffer(Owner owner)
 		assert(_tbuset.IsEmpty());
 		assert(_tbdset.IsEmpty());
 
+		const uint64_t key = static_cast<uint64_t>(tile.base()) << 16 | static_cast<uint64_t>(dir) << 8 | owner;
+
 		/* After updating signal, data stored are always MP_RAILWAY with signals.
 		 * Other situations happen when data are from outside functions -
 		 * modification of railbits (including both rail building and removal),
@@ -527,7 +604,16 @@ static SigSegState UpdateSignalsInBuffer(Owner owner)
 		assert(!_tbdset.Overflowed()); // it really shouldn't overflow by these one or two items
 		assert(!_tbdset.IsEmpty()); // it wouldn't hurt anyone, but shouldn't happen too
 
-		SigFlags flags = ExploreSegment(owner);
+		auto it = _signal_blocks.find(key);
+		if (it != _signal_blocks.end()) {
+			_tbdset.Reset();
+		} else {
+			if (_signal_blocks.size() >= SIG_BLOCKS_MAX) _signal_blocks.clear();
+			it = _signal_blocks.try_emplace(key).first;
+			ExploreSegment(owner, it->second);
+		}
+
+		SigFlags flags = CheckSignalBlock(it->second);
 
 		if (first) {
 			first = false;
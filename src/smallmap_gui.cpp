@@ -29,6 +29,7 @@
 #include "timer/timer.h"
 #include "timer/timer_window.h"
 #include "smallmap_gui.h"
+#include "task_pool.h"
 
 #include "widgets/smallmap_widget.h"
 
@@ -178,6 +179,38 @@ static bool _smallmap_show_heightmap = false;
 static IndustryType _smallmap_industry_highlight = INVALID_INDUSTRYTYPE;
 /** State of highlight blinking */
 static bool _smallmap_industry_highlight_state;
+
+/** Importance of a tile in #_smallmap_tile_importance whose colours are not known. */
+static const uint8_t SMALLMAP_TILE_UNKNOWN = 0xFF;
+/** Importance of a tile in #_smallmap_tile_importance whose colours are shown regardless of the other tiles of a pixel. */
+static const uint8_t SMALLMAP_TILE_OVERRIDE = 0xFE;
+/** Number of refreshes of the smallmap in which all cached tile colours are determined again. */
+static const uint SMALLMAP_RECHECK_REFRESHES = 32;
+
+/** Colours of every tile in the current mode of the smallmap, valid when the importance is known. */
+static std::vector<uint32_t> _smallmap_tile_colours;
+/** Importance of every tile in the current mode of the smallmap, or #SMALLMAP_TILE_UNKNOWN. */
+static std::vector<uint8_t> _smallmap_tile_importance;
+/** Number of columns of pixels of the smallmap drawn by one task. */
+static const uint SMALLMAP_COLUMN_BAND_SIZE = 64;
+/** Refresh of the smallmap within the cycle of #SMALLMAP_RECHECK_REFRESHES. */
+static uint _smallmap_recheck_refresh = 0;
+
+/**
+ * Forget the colours of a tile in the smallmap, as it has changed.
+ * @param tile The tile.
+ */
+void InvalidateSmallMapTile(TileIndex tile)
+{
+	if (tile.base() < _smallmap_tile_importance.size()) _smallmap_tile_importance[tile.base()] = SMALLMAP_TILE_UNKNOWN;
+}
+
+/** Forget the colours of all tiles in the smallmap, e.g. as the mode or the legend changed. */
+static void InvalidateSmallMapTiles()
+{
+	std::fill(_smallmap_tile_importance.begin(), _smallmap_tile_importance.end(), SMALLMAP_TILE_UNKNOWN);
+}
+
 /** For connecting company ID to position in owner list (small map legend) */
 static uint _company_to_list_pos[MAX_COMPANIES];
 
@@ -762,6 +795,7 @@ protected:
 
 		SmallMapWindow::map_height_limit = _settings_game.construction.map_height_limit;
 		BuildLandLegend();
+		InvalidateSmallMapTiles();
 	}
 
 	/**
@@ -814,6 +848,7 @@ protected:
 		}
 
 		if (this->map_type == SMT_INDUSTRY) this->BreakIndustryChainLink();
+		InvalidateSmallMapTiles();
 	}
 
 	/**
@@ -830,6 +865,7 @@ protected:
 
 		if (map_type == SMT_LINKSTATS) this->overlay->SetDirty();
 		if (map_type != SMT_INDUSTRY) this->BreakIndustryChainLink();
+		InvalidateSmallMapTiles();
 		this->SetDirty();
 	}
 
@@ -931,7 +967,7 @@ protected:
 			}
 			ta.ClampToMap(); // Clamp to map boundaries (may contain MP_VOID tiles!).
 
-			uint32_t val = this->GetTileColours(ta);
+			uint32_t val = this->GetCachedTileColours(ta);
 			uint8_t *val8 = (uint8_t *)&val;
 			int idx = std::max(0, -start_pos);
 			for (int pos = std::max(0, start_pos); pos < end_pos; pos++) {
@@ -1034,6 +1070,15 @@ protected:
 		int x = - dx - 4;
 		int y = 0;
 
+		/* The columns do not share any pixels or tiles, so they are drawn in parallel. */
+		struct Column {
+			void *ptr;
+			int tile_x, tile_y;
+			int reps;
+			int x, end_pos;
+		};
+		std::vector<Column> columns;
+
 		for (;;) {
 			/* Distance from left edge */
 			if (x >= -3) {
@@ -1041,9 +1086,7 @@ protected:
 
 				int end_pos = std::min(dpi->width, x + 4);
 				int reps = (dpi->height - y + 1) / 2; // Number of lines.
-				if (reps > 0) {
-					this->DrawSmallMapColumn(ptr, tile_x, tile_y, dpi->pitch * 2, reps, x, end_pos, blitter);
-				}
+				if (reps > 0) columns.push_back({ptr, tile_x, tile_y, reps, x, end_pos});
 			}
 
 			if (y == 0) {
@@ -1059,6 +1102,13 @@ protected:
 			x += 2;
 		}
 
+		RunInBands(TaskCategory::Viewport, static_cast<uint>(columns.size()), SMALLMAP_COLUMN_BAND_SIZE, [&](uint first, uint last) {
+			for (uint i = first; i < last; i++) {
+				const Column &c = columns[i];
+				this->DrawSmallMapColumn(c.ptr, c.tile_x, c.tile_y, dpi->pitch * 2, c.reps, c.x, c.end_pos, blitter);
+			}
+		});
+
 		/* Draw vehicles */
 		if (this->map_type == SMT_CONTOUR || this->map_type == SMT_VEHICLES) this->DrawVehicles(dpi, blitter);
 
@@ -1264,60 +1314,65 @@ protected:
 	}
 
 	/**
-	 * Decide which colours to show to the user for a group of tiles.
-	 * @param ta Tile area to investigate.
-	 * @return Colours to display.
+	 * Get the type a tile is shown as in the current mode.
+	 * @param ti The tile.
+	 * @param[out] ttype The effective tile type.
+	 * @param[out] colour The colours to show regardless of the other tiles of a pixel, when there are any.
+	 * @return Whether \a colour is to be shown.
 	 */
-	uint32_t GetTileColours(const TileArea &ta) const
+	bool GetEffectiveTileType(TileIndex ti, TileType &ttype, uint32_t &colour) const
 	{
-		int importance = 0;
-		TileIndex tile = INVALID_TILE; // Position of the most important tile.
-		TileType et = MP_VOID;         // Effective tile type at that position.
-
-		for (TileIndex ti : ta) {
-			TileType ttype = GetTileType(ti);
+		ttype = GetTileType(ti);
 
-			switch (ttype) {
-				case MP_TUNNELBRIDGE: {
-					TransportType tt = GetTunnelBridgeTransportType(ti);
+		switch (ttype) {
+			case MP_TUNNELBRIDGE: {
+				TransportType tt = GetTunnelBridgeTransportType(ti);
 
-					switch (tt) {
-						case TRANSPORT_RAIL: ttype = MP_RAILWAY; break;
-						case TRANSPORT_ROAD: ttype = MP_ROAD;    break;
-						default:             ttype = MP_WATER;   break;
-					}
-					break;
+				switch (tt) {
+					case TRANSPORT_RAIL: ttype = MP_RAILWAY; break;
+					case TRANSPORT_ROAD: ttype = MP_ROAD;    break;
+					default:             ttype = MP_WATER;   break;
 				}
+				break;
+			}
 
-				case MP_INDUSTRY:
-					/* Special handling of industries while in "Industries" smallmap view. */
-					if (this->map_type == SMT_INDUSTRY) {
-						/* If industry is allowed to be seen, use its colour on the map.
-						 * This has the highest priority above any value in _tiletype_importance. */
-						IndustryType type = Industry::GetByTile(ti)->type;
-						if (_legend_from_industries[_industry_to_list_pos[type]].show_on_map) {
-							if (type == _smallmap_industry_highlight) {
-								if (_smallmap_industry_highlight_state) return MKCOLOUR_XXXX(PC_WHITE);
-							} else {
-								return GetIndustrySpec(type)->map_colour * 0x01010101;
+			case MP_INDUSTRY:
+				/* Special handling of industries while in "Industries" smallmap view. */
+				if (this->map_type == SMT_INDUSTRY) {
+					/* If industry is allowed to be seen, use its colour on the map.
+					 * This has the highest priority above any value in _tiletype_importance. */
+					IndustryType type = Industry::GetByTile(ti)->type;
+					if (_legend_from_industries[_industry_to_list_pos[type]].show_on_map) {
+						if (type == _smallmap_industry_highlight) {
+							if (_smallmap_industry_highlight_state) {
+								colour = MKCOLOUR_XXXX(PC_WHITE);
+								return true;
 							}
+						} else {
+							colour = GetIndustrySpec(type)->map_colour * 0x01010101;
+							return true;
 						}
-						/* Otherwise make it disappear */
-						ttype = IsTileOnWater(ti) ? MP_WATER : MP_CLEAR;
 					}
-					break;
-
-				default:
-					break;
-			}
+					/* Otherwise make it disappear */
+					ttype = IsTileOnWater(ti) ? MP_WATER : MP_CLEAR;
+				}
+				break;
 
-			if (_tiletype_importance[ttype] > importance) {
-				importance = _tiletype_importance[ttype];
-				tile = ti;
-				et = ttype;
-			}
+			default:
+				break;
 		}
 
+		return false;
+	}
+
+	/**
+	 * Get the colours of a tile with a given effective tile type in the current mode.
+	 * @param tile The tile.
+	 * @param et Effective tile type of the tile.
+	 * @return Colours to display.
+	 */
+	uint32_t GetTileTypeColours(TileIndex tile, TileType et) const
+	{
 		switch (this->map_type) {
 			case SMT_CONTOUR:
 				return GetSmallMapContoursPixels(tile, et);
@@ -1344,6 +1399,72 @@ protected:
 		}
 	}
 
+	/**
+	 * Decide which colours to show to the user for a group of tiles.
+	 * @param ta Tile area to investigate.
+	 * @return Colours to display.
+	 */
+	uint32_t GetTileColours(const TileArea &ta) const
+	{
+		int importance = 0;
+		TileIndex tile = INVALID_TILE; // Position of the most important tile.
+		TileType et = MP_VOID;         // Effective tile type at that position.
+
+		for (TileIndex ti : ta) {
+			TileType ttype;
+			uint32_t colour;
+			if (this->GetEffectiveTileType(ti, ttype, colour)) return colour;
+
+			if (_tiletype_importance[ttype] > importance) {
+				importance = _tiletype_importance[ttype];
+				tile = ti;
+				et = ttype;
+			}
+		}
+
+		return this->GetTileTypeColours(tile, et);
+	}
+
+	/**
+	 * Decide which colours to show to the user for a group of tiles, like #GetTileColours,
+	 * but using the colours of the single tiles that are cached while the smallmap is open.
+	 * @param ta Tile area to investigate.
+	 * @return Colours to display.
+	 */
+	uint32_t GetCachedTileColours(const TileArea &ta) const
+	{
+		/* The colour of the highlighted industry blinks, so it is not cached. */
+		if (_smallmap_tile_importance.size() != Map::Size() || (this->map_type == SMT_INDUSTRY && _smallmap_industry_highlight != INVALID_INDUSTRYTYPE)) {
+			return this->GetTileColours(ta);
+		}
+
+		uint8_t importance = 0;
+		uint32_t colours = 0;
+
+		for (TileIndex ti : ta) {
+			uint8_t &tile_importance = _smallmap_tile_importance[ti.base()];
+			uint32_t &tile_colours = _smallmap_tile_colours[ti.base()];
+
+			if (tile_importance == SMALLMAP_TILE_UNKNOWN) {
+				TileType ttype;
+				if (this->GetEffectiveTileType(ti, ttype, tile_colours)) {
+					tile_importance = SMALLMAP_TILE_OVERRIDE;
+				} else {
+					tile_importance = _tiletype_importance[ttype];
+					tile_colours = this->GetTileTypeColours(ti, ttype);
+				}
+			}
+
+			if (tile_importance == SMALLMAP_TILE_OVERRIDE) return tile_colours;
+			if (tile_importance > importance) {
+				importance = tile_importance;
+				colours = tile_colours;
+			}
+		}
+
+		return colours;
+	}
+
 	/**
 	 * Determines the mouse position on the legend.
 	 * @param pt Mouse position.
@@ -1394,6 +1515,15 @@ protected:
 	{
 		if (_smallmap_industry_highlight != INVALID_INDUSTRYTYPE) return;
 
+		/* Not every change of a tile marks the tile dirty, e.g. a change of its owner, so
+		 * the cached colours of a part of the map are determined again with every refresh. */
+		if (!_smallmap_tile_importance.empty()) {
+			size_t part = _smallmap_tile_importance.size() / SMALLMAP_RECHECK_REFRESHES;
+			auto first = _smallmap_tile_importance.begin() + part * _smallmap_recheck_refresh;
+			std::fill(first, first + part, SMALLMAP_TILE_UNKNOWN);
+			_smallmap_recheck_refresh = (_smallmap_recheck_refresh + 1) % SMALLMAP_RECHECK_REFRESHES;
+		}
+
 		this->UpdateLinks();
 		this->SetDirty();
 	}
@@ -1405,6 +1535,8 @@ public:
 	{
 		_smallmap_industry_highlight = INVALID_INDUSTRYTYPE;
 		this->overlay = std::make_unique<LinkGraphOverlay>(this, WID_SM_MAP, 0, this->GetOverlayCompanyMask(), 1);
+		_smallmap_tile_colours.resize(Map::Size());
+		_smallmap_tile_importance.assign(Map::Size(), SMALLMAP_TILE_UNKNOWN);
 		this->InitNested(window_number);
 		this->LowerWidget(WID_SM_CONTOUR + this->map_type);
 
@@ -1458,6 +1590,8 @@ public:
 	void Close([[maybe_unused]] int data) override
 	{
 		this->BreakIndustryChainLink();
+		_smallmap_tile_colours = {};
+		_smallmap_tile_importance = {};
 		this->Window::Close();
 	}
 
@@ -1732,6 +1866,7 @@ public:
 					tbl->show_on_map = (widget == WID_SM_ENABLE_ALL);
 				}
 				if (this->map_type == SMT_LINKSTATS) this->SetOverlayCargoMask();
+				InvalidateSmallMapTiles();
 				this->SetDirty();
 				break;
 			}
@@ -1739,6 +1874,7 @@ public:
 			case WID_SM_SHOW_HEIGHT: // Enable/disable showing of heightmap.
 				_smallmap_show_heightmap = !_smallmap_show_heightmap;
 				this->SetWidgetLoweredState(WID_SM_SHOW_HEIGHT, _smallmap_show_heightmap);
+				InvalidateSmallMapTiles();
 				this->SetDirty();
 				break;
 		}
@@ -1778,6 +1914,7 @@ public:
 
 			default: NOT_REACHED();
 		}
+		InvalidateSmallMapTiles();
 		this->SetDirty();
 	}
 
@@ -22,6 +22,7 @@ void BuildIndustriesLegend();
 void ShowSmallMap();
 void BuildLandLegend();
 void BuildOwnerLegend();
+void InvalidateSmallMapTile(TileIndex tile);
 
 /** Enum for how to include the heightmap pixels/colours in small map related functions */
 enum class IncludeHeightmap {
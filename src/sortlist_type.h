@@ -15,6 +15,8 @@
 #include "core/mem_func.hpp"
 #include "timer/timer_game_tick.h"
 
+#include <unordered_map>
+
 /** Flags of the sort list. */
 enum SortListFlags {
 	VL_NONE       = 0,      ///< no sort
@@ -72,6 +74,23 @@ protected:
 		return std::vector<T>::size() >= 2;
 	}
 
+	/**
+	 * Get the function to order two list items with, taking the sort direction and sort parameters into account.
+	 * @param compare The function to compare two list items.
+	 * @return The function that returns whether the first item goes before the second.
+	 */
+	template <typename Comp>
+	auto GetComparator(Comp compare) const
+	{
+		const bool desc = (this->flags & VL_DESC) != 0;
+
+		if constexpr (std::is_same_v<P, std::nullptr_t>) {
+			return [desc, compare](const T &a, const T &b) { return desc ? compare(b, a) : compare(a, b); };
+		} else {
+			return [desc, compare, this](const T &a, const T &b) { return desc ? compare(b, a, this->params) : compare(a, b, this->params); };
+		}
+	}
+
 	/**
 	 * Reset the resort timer
 	 */
@@ -277,16 +296,138 @@ public:
 		/* Do not sort when the list is not sortable */
 		if (!this->IsSortable()) return false;
 
-		const bool desc = (this->flags & VL_DESC) != 0;
+		const auto comparator = this->GetComparator(compare);
+
+		/* Mostly the list is still in the order of the previous sort, with only a few items that were
+		 * added or whose sort value has changed. Take out the items that are out of order; when an item
+		 * is before its predecessor, but not before the one before that, that predecessor is taken out. */
+		std::vector<T> kept;
+		std::vector<T> moved;
+		kept.reserve(std::vector<T>::size());
+		for (const T &item : *this) {
+			if (kept.empty() || !comparator(item, kept.back())) {
+				kept.push_back(item);
+			} else if (kept.size() >= 2 && !comparator(item, kept[kept.size() - 2])) {
+				moved.push_back(kept.back());
+				kept.back() = item;
+			} else {
+				moved.push_back(item);
+			}
+		}
 
-		if constexpr (std::is_same_v<P, std::nullptr_t>) {
-			std::sort(std::vector<T>::begin(), std::vector<T>::end(), [&](const T &a, const T &b) { return desc ? compare(b, a) : compare(a, b); });
+		if (moved.size() > kept.size()) {
+			/* Hardly anything was in order, e.g. due to a different sort type; sort it all. */
+			std::sort(std::vector<T>::begin(), std::vector<T>::end(), comparator);
 		} else {
-			std::sort(std::vector<T>::begin(), std::vector<T>::end(), [&](const T &a, const T &b) { return desc ? compare(b, a, params) : compare(a, b, params); });
+			/* Sort only the items that were out of order, and merge them back in. */
+			std::sort(moved.begin(), moved.end(), comparator);
+			std::merge(kept.begin(), kept.end(), moved.begin(), moved.end(), std::vector<T>::begin(), comparator);
 		}
 		return true;
 	}
 
+	/**
+	 * Add an item to the list.
+	 * When the list is sorted, the item is put at its sorted position; otherwise it is sorted with the rest of the list in the next #Sort.
+	 * @param item The item to add.
+	 * @param compare The function to compare two list items.
+	 */
+	template <typename Comp>
+	void Insert(const T &item, Comp compare)
+	{
+		if (this->flags & VL_RESORT) {
+			std::vector<T>::push_back(item);
+			return;
+		}
+
+		auto it = std::upper_bound(std::vector<T>::begin(), std::vector<T>::end(), item, this->GetComparator(compare));
+		std::vector<T>::insert(it, item);
+	}
+
+	/**
+	 * Overload of #Insert(const T &item, Comp compare) using the current sort function.
+	 * @param item The item to add.
+	 */
+	void Insert(const T &item)
+	{
+		assert(this->sort_func_list != nullptr);
+		this->Insert(item, this->sort_func_list[this->sort_type]);
+	}
+
+	/**
+	 * Remove an item from the list, keeping the order of the other items.
+	 * @param item The item to remove.
+	 * @return true iff the item was in the list.
+	 */
+	bool Remove(const T &item)
+	{
+		auto it = std::find(std::vector<T>::begin(), std::vector<T>::end(), item);
+		if (it == std::vector<T>::end()) return false;
+
+		std::vector<T>::erase(it);
+		return true;
+	}
+
+	/**
+	 * Move an item of which the sort value has changed to its sorted position.
+	 * @param item The changed item.
+	 * @param compare The function to compare two list items.
+	 * @return true iff the item was in the list.
+	 */
+	template <typename Comp>
+	bool Update(const T &item, Comp compare)
+	{
+		const T changed = item; // The item might be a reference into the list.
+		if (!this->Remove(changed)) return false;
+
+		this->Insert(changed, compare);
+		return true;
+	}
+
+	/**
+	 * Overload of #Update(const T &item, Comp compare) using the current sort function.
+	 * @param item The changed item.
+	 * @return true iff the item was in the list.
+	 */
+	bool Update(const T &item)
+	{
+		assert(this->sort_func_list != nullptr);
+		return this->Update(item, this->sort_func_list[this->sort_type]);
+	}
+
+	/**
+	 * Put the items of a rebuilt list in the order they had before the rebuild, with the items that
+	 * were not in the list before at the end. So the next #Sort only has to sort the new items.
+	 * @param previous_keys Keys of the items of the list before the rebuild, in their order.
+	 * @param get_key Function returning the key of a list item.
+	 */
+	template <typename Key, typename GetKey>
+	void RestoreOrder(const std::vector<Key> &previous_keys, GetKey get_key)
+	{
+		if (previous_keys.empty() || !this->IsSortable()) return;
+
+		std::unordered_map<Key, size_t> previous_position;
+		previous_position.reserve(previous_keys.size());
+		for (size_t i = 0; i < previous_keys.size(); i++) previous_position.emplace(previous_keys[i], i);
+
+		std::vector<std::optional<T>> ordered(previous_keys.size());
+		std::vector<T> added;
+		for (const T &item : *this) {
+			auto found = previous_position.find(get_key(item));
+			if (found == previous_position.end() || ordered[found->second].has_value()) {
+				added.push_back(item);
+			} else {
+				ordered[found->second] = item;
+			}
+		}
+
+		auto out = std::vector<T>::begin();
+		for (const std::optional<T> &item : ordered) {
+			if (item.has_value()) *out++ = *item;
+		}
+		std::copy(added.begin(), added.end(), out);
+	}
+
 	/**
 	 * Hand the array of sort function pointers to the sort list
 	 *
@@ -14,6 +14,8 @@
 #include "random_access_file_type.h"
 #include "window_gui.h"
 #include "vehicle_base.h"
+#include "openttd.h"
+#include "timer/timer_game_tick.h"
 
 /* The type of set we're replacing */
 #define SET_TYPE "sounds"
@@ -31,7 +33,7 @@ static void OpenBankFile(const std::string &filename)
 	 */
 	static std::unique_ptr<RandomAccessFile> original_sound_file;
 
-	memset(_original_sounds, 0, sizeof(_original_sounds));
+	std::fill(std::begin(_original_sounds), std::end(_original_sounds), SoundEntry{});
 
 	/* If there is no sound file (nosound set), don't load anything */
 	if (filename.empty()) return;
@@ -112,18 +114,27 @@ static void OpenBankFile(const std::string &filename)
 	}
 }
 
-static bool SetBankSource(MixerChannel *mc, const SoundEntry *sound)
+/** Number of bytes of converted sample data that is kept for playing the sounds again. */
+static const size_t SOUND_CACHE_SIZE = 16 * 1024 * 1024;
+
+static uint32_t _sound_play_counter = 0; ///< Number of sounds played, the clock for SoundEntry::last_played.
+
+/**
+ * Read the sample data of a sound and convert it to what the mixer plays.
+ * @param sound The sound to read.
+ * @return The sample data, or nullptr when the sound has no valid data.
+ */
+static std::shared_ptr<std::vector<int8_t>> LoadSoundData(const SoundEntry *sound)
 {
 	assert(sound != nullptr);
 
 	/* Check for valid sound size. */
-	if (sound->file_size == 0 || sound->file_size > ((size_t)-1) - 2) return false;
+	if (sound->file_size == 0 || sound->file_size > ((size_t)-1) - 2) return nullptr;
 
-	int8_t *mem = MallocT<int8_t>(sound->file_size + 2);
 	/* Add two extra bytes so rate conversion can read these
 	 * without reading out of its input buffer. */
-	mem[sound->file_size    ] = 0;
-	mem[sound->file_size + 1] = 0;
+	auto data = std::make_shared<std::vector<int8_t>>(sound->file_size + 2);
+	int8_t *mem = data->data();
 
 	RandomAccessFile *file = sound->file;
 	file->SeekTo(sound->file_offset, SEEK_SET);
@@ -146,11 +157,52 @@ static bool SetBankSource(MixerChannel *mc, const SoundEntry *sound)
 	}
 #endif
 
+	return data;
+}
+
+/**
+ * Forget the sample data of the least recently played sounds, until the
+ * remaining data fits in #SOUND_CACHE_SIZE. Sounds that are still playing
+ * keep their data until the mixer is done with it.
+ */
+static void TrimSoundCache()
+{
+	std::vector<SoundEntry *> cached;
+	size_t total = 0;
+	for (uint i = 0; i < GetNumSounds(); i++) {
+		SoundEntry *sound = GetSound(i);
+		if (sound->data == nullptr) continue;
+		cached.push_back(sound);
+		total += sound->data->size();
+	}
+	if (total <= SOUND_CACHE_SIZE) return;
+
+	std::sort(cached.begin(), cached.end(), [](const SoundEntry *a, const SoundEntry *b) { return a->last_played < b->last_played; });
+	for (SoundEntry *sound : cached) {
+		if (total <= SOUND_CACHE_SIZE) break;
+		total -= sound->data->size();
+		sound->data.reset();
+	}
+}
+
+static bool SetBankSource(MixerChannel *mc, SoundEntry *sound)
+{
+	assert(sound != nullptr);
+
+	sound->last_played = ++_sound_play_counter;
+	std::shared_ptr<std::vector<int8_t>> data = sound->data;
+	if (data == nullptr) {
+		data = LoadSoundData(sound);
+		if (data == nullptr) return false;
+		sound->data = data;
+		TrimSoundCache();
+	}
+
 	assert(sound->bits_per_sample == 8 || sound->bits_per_sample == 16);
 	assert(sound->channels == 1);
 	assert(sound->file_size != 0 && sound->rate != 0);
 
-	MxSetChannelRawSrc(mc, mem, sound->file_size, sound->rate, sound->bits_per_sample == 16);
+	MxSetChannelRawSrc(mc, data, sound->file_size, sound->rate, sound->bits_per_sample == 16);
 
 	return true;
 }
@@ -181,14 +233,18 @@ static void StartSound(SoundID sound_id, float pan, uint volume)
 	/* Empty sound? */
 	if (sound->rate == 0) return;
 
+	/* Apply the sound effect's own volume. */
+	volume = sound->volume * volume;
+
 	MixerChannel *mc = MxAllocateChannel();
-	if (mc == nullptr) return;
+	if (mc == nullptr) {
+		/* Let this sound's successors replace a more distant sound. */
+		MxStopQuieterChannel(volume);
+		return;
+	}
 
 	if (!SetBankSource(mc, sound)) return;
 
-	/* Apply the sound effect's own volume. */
-	volume = sound->volume * volume;
-
 	MxSetChannelVolume(mc, volume, pan);
 	MxActivateChannel(mc);
 }
@@ -270,6 +326,50 @@ void ChangeSoundSet(int index)
  * @param top    Top edge of virtual coordinates where the sound is produced
  * @param bottom Bottom edge of virtual coordinates where the sound is produced
  */
+/**
+ * Check cheaply whether a sound at the given virtual coordinates could be heard.
+ * It is tested against the bounding box of all viewports, which is determined
+ * once per tick; while paused, the viewports may move without ticks passing.
+ * @param left   Left edge of the sound source, in virtual coordinates.
+ * @param right  Right edge of the sound source.
+ * @param top    Top edge of the sound source.
+ * @param bottom Bottom edge of the sound source.
+ * @return False if no viewport can show the sound source.
+ */
+static bool IsSoundAudible(int left, int right, int top, int bottom)
+{
+	static Rect audible_area;
+	static TimerGameTick::TickCounter audible_area_tick = 0;
+	static bool audible_area_valid = false;
+
+	if (!audible_area_valid || audible_area_tick != TimerGameTick::counter || _pause_mode != PM_UNPAUSED) {
+		audible_area = { INT_MAX, INT_MAX, INT_MIN, INT_MIN };
+		for (const Window *w : Window::Iterate()) {
+			const Viewport *vp = w->viewport;
+			if (vp == nullptr) continue;
+			audible_area.left = std::min(audible_area.left, vp->virtual_left);
+			audible_area.top = std::min(audible_area.top, vp->virtual_top);
+			audible_area.right = std::max(audible_area.right, vp->virtual_left + vp->virtual_width);
+			audible_area.bottom = std::max(audible_area.bottom, vp->virtual_top + vp->virtual_height);
+		}
+		audible_area_tick = TimerGameTick::counter;
+		audible_area_valid = true;
+	}
+
+	return left < audible_area.right && right > audible_area.left && top < audible_area.bottom && bottom > audible_area.top;
+}
+
+/**
+ * Check cheaply whether the sounds of a vehicle could be heard at all, so
+ * the work of choosing a sound for it can be skipped when they cannot.
+ * @param v The vehicle.
+ * @return False if the vehicle is not in any viewport.
+ */
+bool IsVehicleSoundAudible(const Vehicle *v)
+{
+	return IsSoundAudible(v->coord.left, v->coord.right, v->coord.top, v->coord.bottom);
+}
+
 static void SndPlayScreenCoordFx(SoundID sound, int left, int right, int top, int bottom)
 {
 	/* Iterate from back, so that main viewport is checked first */
@@ -307,6 +407,8 @@ void SndPlayTileFx(SoundID sound, TileIndex tile)
 
 void SndPlayVehicleFx(SoundID sound, const Vehicle *v)
 {
+	if (!IsVehicleSoundAudible(v)) return;
+
 	SndPlayScreenCoordFx(sound,
 		v->coord.left, v->coord.right,
 		v->coord.top, v->coord.bottom
@@ -338,21 +440,9 @@ template <class Tbase_set>
 {
 	if (BaseMedia<Tbase_set>::used_set != nullptr) return true;
 
-	const Tbase_set *best = nullptr;
-	for (const Tbase_set *c = BaseMedia<Tbase_set>::available_sets; c != nullptr; c = c->next) {
-		/* Skip unusable sets */
-		if (c->GetNumMissing() != 0) continue;
-
-		if (best == nullptr ||
-				(best->fallback && !c->fallback) ||
-				best->valid_files < c->valid_files ||
-				(best->valid_files == c->valid_files &&
-					(best->shortname == c->shortname && best->version < c->version))) {
-			best = c;
-		}
-	}
-
-	BaseMedia<Tbase_set>::used_set = best;
+	BaseMedia<Tbase_set>::used_set = BaseMedia<Tbase_set>::FindBestSet([](const Tbase_set *best, const Tbase_set *c) {
+		return best->shortname == c->shortname && best->version < c->version;
+	});
 	return BaseMedia<Tbase_set>::used_set != nullptr;
 }
 
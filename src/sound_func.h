@@ -19,6 +19,7 @@ void ChangeSoundSet(int index);
 void SndPlayTileFx(SoundID sound, TileIndex tile);
 void SndPlayVehicleFx(SoundID sound, const Vehicle *v);
 void SndPlayFx(SoundID sound);
+bool IsVehicleSoundAudible(const Vehicle *v);
 void SndCopyToPool();
 
 #endif /* SOUND_FUNC_H */
@@ -20,6 +20,9 @@ struct SoundEntry {
 	uint8_t volume;
 	uint8_t priority;
 	uint8_t grf_container_ver; ///< NewGRF container version if the sound is from a NewGRF.
+	uint32_t last_played;      ///< When the sound was played last, to find the cached sample data that was used least recently.
+
+	std::shared_ptr<std::vector<int8_t>> data; ///< Sample data converted for the mixer, if it is cached.
 };
 
 /**
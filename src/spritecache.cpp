@@ -21,11 +21,19 @@
 #include "video/video_driver.hpp"
 #include "spritecache.h"
 #include "spritecache_internal.h"
+#include "task_pool.h"
+#include "fileio_func.h"
+#include "string_func.h"
+#include "debug.h"
+#include "3rdparty/md5/md5.h"
 
 #include "table/sprites.h"
 #include "table/strings.h"
 #include "table/palette_convert.h"
 
+#include <filesystem>
+#include <mutex>
+
 #include "safeguards.h"
 
 /* Default of 4MB spritecache */
@@ -92,17 +100,38 @@ SpriteFile &OpenCachedSpriteFile(const std::string &filename, Subdirectory subdi
 	return *file;
 }
 
-struct MemBlock {
-	size_t size;
-	uint8_t data[];
+/**
+ * Header of a block of memory holding the data of a cached sprite. Every
+ * block is in one of two lists: the blocks of sprites that may be evicted,
+ * most recently used first, and the blocks that are never evicted.
+ */
+struct alignas(16) MemBlock {
+	MemBlock *prev; ///< Previous block in its list.
+	MemBlock *next; ///< Next block in its list.
+	size_t size;    ///< Size of the block, including this header.
+	SpriteID owner; ///< Sprite cache entry of the data if the block may be evicted, otherwise #INVALID_OWNER.
+
+	static constexpr SpriteID INVALID_OWNER = UINT32_MAX; ///< Owner of blocks that are not evicted.
+
+	/**
+	 * Get the data in this block.
+	 * @return The data.
+	 */
+	inline void *Data() { return this + 1; }
+
+	/**
+	 * Get the block holding some data.
+	 * @param data The data, as returned by #AllocSprite.
+	 * @return The block.
+	 */
+	static inline MemBlock *FromData(void *data) { return static_cast<MemBlock *>(data) - 1; }
 };
 
-static uint _sprite_lru_counter;
-static MemBlock *_spritecache_ptr;
-static uint _allocated_sprite_cache_size = 0;
-static int _compact_cache_counter;
-
-static void CompactSpriteCache();
+static MemBlock _sprite_lru = { &_sprite_lru, &_sprite_lru, 0, MemBlock::INVALID_OWNER };    ///< List of blocks that may be evicted; most recently used first.
+static MemBlock _sprite_pinned = { &_sprite_pinned, &_sprite_pinned, 0, MemBlock::INVALID_OWNER }; ///< List of blocks that are not evicted, like recolour sprites.
+static size_t _sprite_cache_budget = 0; ///< Number of bytes the cached sprites may use.
+static size_t _sprite_cache_usage = 0;  ///< Number of bytes used by the cached sprites.
+static SpriteCacheStatistics _sprite_cache_stats; ///< Statistics of the use of the sprite cache.
 
 /**
  * Skip the given amount of sprite graphics data.
@@ -447,14 +476,15 @@ static void *ReadRecolourSprite(SpriteFile &file, uint num)
  * @param sprite_type Type of sprite.
  * @param allocator   Allocator function to use.
  * @param encoder     Sprite encoder to use.
+ * @param file        File to read from; a copy of the file of \a sc when reading in the background.
+ * @param background  Whether the sprite is read by a worker thread. Then nullptr is returned instead of a fallback sprite.
  * @return Read sprite data.
  */
-static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_type, AllocatorProc *allocator, SpriteEncoder *encoder)
+static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_type, AllocatorProc *allocator, SpriteEncoder *encoder, SpriteFile &file, bool background = false)
 {
 	/* Use current blitter if no other sprite encoder is given. */
 	if (encoder == nullptr) encoder = BlitterFactory::GetCurrentBlitter();
 
-	SpriteFile &file = *sc->file;
 	size_t file_pos = sc->file_pos;
 
 	assert(sprite_type != SpriteType::Recolour);
@@ -477,7 +507,7 @@ static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_ty
 	}
 
 	if (sprite_avail == 0) {
-		if (sprite_type == SpriteType::MapGen) return nullptr;
+		if (sprite_type == SpriteType::MapGen || background) return nullptr;
 		if (id == SPR_IMG_QUERY) UserError("Okay... something went horribly wrong. I couldn't load the fallback sprite. What should I do?");
 		return (void*)GetRawSprite(SPR_IMG_QUERY, SpriteType::Normal, allocator, encoder);
 	}
@@ -511,6 +541,7 @@ static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_ty
 	}
 
 	if (!ResizeSprites(sprite, sprite_avail, encoder)) {
+		if (background) return nullptr;
 		if (id == SPR_IMG_QUERY) UserError("Okay... something went horribly wrong. I couldn't resize the fallback sprite. What should I do?");
 		return (void*)GetRawSprite(SPR_IMG_QUERY, SpriteType::Normal, allocator, encoder);
 	}
@@ -534,7 +565,17 @@ struct GrfSpriteOffset {
 };
 
 /** Map from sprite numbers to position in the GRF file. */
-static std::map<uint32_t, GrfSpriteOffset> _grf_sprite_offsets;
+using GrfSpriteOffsets = std::map<uint32_t, GrfSpriteOffset>;
+
+/** Sprite section index of a GRF that is read ahead of time by a worker thread. */
+struct GrfSpriteOffsetsPrefetch {
+	TaskHandle task;          ///< Task reading the index.
+	GrfSpriteOffsets offsets; ///< The index; only valid once the task is done.
+};
+
+static GrfSpriteOffsets _grf_sprite_offsets_read; ///< Index of the last GRF whose index was not prefetched.
+static const GrfSpriteOffsets *_grf_sprite_offsets = &_grf_sprite_offsets_read; ///< Index of the GRF currently being processed.
+static std::map<std::string, GrfSpriteOffsetsPrefetch> _grf_sprite_offsets_prefetch; ///< Prefetched indices, by filename.
 
 /**
  * Get the file offset for a specific sprite in the sprite section of a GRF.
@@ -543,16 +584,18 @@ static std::map<uint32_t, GrfSpriteOffset> _grf_sprite_offsets;
  */
 size_t GetGRFSpriteOffset(uint32_t id)
 {
-	return _grf_sprite_offsets.find(id) != _grf_sprite_offsets.end() ? _grf_sprite_offsets[id].file_pos : SIZE_MAX;
+	auto it = _grf_sprite_offsets->find(id);
+	return it != _grf_sprite_offsets->end() ? it->second.file_pos : SIZE_MAX;
 }
 
 /**
- * Parse the sprite section of GRFs.
- * @param container_version Container version of the GRF we're currently processing.
+ * Read the sprite section of a GRF.
+ * @param file The file, positioned at the offset of the sprite section; on return it is positioned just after that offset.
+ * @param[out] offsets The index of the sprite section.
  */
-void ReadGRFSpriteOffsets(SpriteFile &file)
+static void ReadGRFSpriteSection(SpriteFile &file, GrfSpriteOffsets &offsets)
 {
-	_grf_sprite_offsets.clear();
+	offsets.clear();
 
 	if (file.GetContainerVersion() >= 2) {
 		/* Seek to sprite section of the GRF. */
@@ -567,7 +610,7 @@ void ReadGRFSpriteOffsets(SpriteFile &file)
 		uint32_t id, prev_id = 0;
 		while ((id = file.ReadDword()) != 0) {
 			if (id != prev_id) {
-				_grf_sprite_offsets[prev_id] = offset;
+				offsets[prev_id] = offset;
 				offset.file_pos = file.GetPos() - 4;
 				offset.control_flags = 0;
 			}
@@ -590,13 +633,175 @@ void ReadGRFSpriteOffsets(SpriteFile &file)
 			}
 			file.SkipBytes(length);
 		}
-		if (prev_id != 0) _grf_sprite_offsets[prev_id] = offset;
+		if (prev_id != 0) offsets[prev_id] = offset;
 
 		/* Continue processing the data section. */
 		file.SeekTo(old_pos, SEEK_SET);
 	}
 }
 
+static const uint32_t GRF_SPRITE_OFFSETS_CACHE_MAGIC = 0x49535347;  ///< Magic at the start of a sprite section index cache file, "GSSI".
+static const uint32_t GRF_SPRITE_OFFSETS_CACHE_VERSION = 1;          ///< Version of the format of the cache files; bump it when the format or the index changes.
+static const size_t GRF_SPRITE_OFFSETS_CACHE_HEADER_SIZE = 4 + 4 + MD5_HASH_BYTES + 4 + 4; ///< Size of the header of a cache file.
+static const size_t GRF_SPRITE_OFFSETS_CACHE_ENTRY_SIZE = 4 + 8 + 1; ///< Size of one entry of a cache file.
+
+/**
+ * Load the sprite section index of a GRF from its cache file.
+ * The positions in the cache file are relative to the end of the sprite section offset,
+ * so they stay valid when the GRF is moved into or out of a tar file.
+ * @param cache_file Name of the cache file.
+ * @param md5sum MD5 checksum of the GRF.
+ * @param data_offset Offset of the sprite section in the GRF.
+ * @param base Position in the GRF the positions in the cache file are relative to.
+ * @param[out] offsets The index of the sprite section.
+ * @return True if the cache file is valid for the GRF and has been loaded.
+ */
+static bool LoadGRFSpriteOffsetsCache(const std::string &cache_file, const MD5Hash &md5sum, uint32_t data_offset, size_t base, GrfSpriteOffsets &offsets)
+{
+	size_t size;
+	FILE *f = FioFOpenFile(cache_file, "rb", NO_DIRECTORY, &size);
+	if (f == nullptr) return false;
+
+	std::vector<uint8_t> buf(size);
+	bool read = fread(buf.data(), 1, size, f) == size;
+	fclose(f);
+	if (!read || size < GRF_SPRITE_OFFSETS_CACHE_HEADER_SIZE) return false;
+
+	const uint8_t *p = buf.data();
+	auto read_bytes = [&p](uint n) {
+		uint64_t v = 0;
+		for (uint i = 0; i < n; i++) v |= (uint64_t)*p++ << (i * 8);
+		return v;
+	};
+
+	if (read_bytes(4) != GRF_SPRITE_OFFSETS_CACHE_MAGIC || read_bytes(4) != GRF_SPRITE_OFFSETS_CACHE_VERSION) return false;
+	if (!std::equal(md5sum.begin(), md5sum.end(), p)) return false;
+	p += MD5_HASH_BYTES;
+	if (read_bytes(4) != data_offset) return false;
+	uint32_t count = (uint32_t)read_bytes(4);
+	if (size != GRF_SPRITE_OFFSETS_CACHE_HEADER_SIZE + (size_t)count * GRF_SPRITE_OFFSETS_CACHE_ENTRY_SIZE) return false;
+
+	offsets.clear();
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t id = (uint32_t)read_bytes(4);
+		GrfSpriteOffset &offset = offsets[id];
+		offset.file_pos = (size_t)(base + (int64_t)read_bytes(8));
+		offset.control_flags = (uint8_t)read_bytes(1);
+	}
+	return true;
+}
+
+/**
+ * Save the sprite section index of a GRF to its cache file.
+ * @param cache_file Name of the cache file.
+ * @param md5sum MD5 checksum of the GRF.
+ * @param data_offset Offset of the sprite section in the GRF.
+ * @param base Position in the GRF the positions in the cache file are relative to.
+ * @param offsets The index of the sprite section.
+ */
+static void SaveGRFSpriteOffsetsCache(const std::string &cache_file, const MD5Hash &md5sum, uint32_t data_offset, size_t base, const GrfSpriteOffsets &offsets)
+{
+	std::vector<uint8_t> buf;
+	buf.reserve(GRF_SPRITE_OFFSETS_CACHE_HEADER_SIZE + offsets.size() * GRF_SPRITE_OFFSETS_CACHE_ENTRY_SIZE);
+	auto write_bytes = [&buf](uint64_t v, uint n) {
+		for (uint i = 0; i < n; i++) buf.push_back(GB(v, i * 8, 8));
+	};
+
+	write_bytes(GRF_SPRITE_OFFSETS_CACHE_MAGIC, 4);
+	write_bytes(GRF_SPRITE_OFFSETS_CACHE_VERSION, 4);
+	buf.insert(buf.end(), md5sum.begin(), md5sum.end());
+	write_bytes(data_offset, 4);
+	write_bytes(offsets.size(), 4);
+	for (const auto &[id, offset] : offsets) {
+		write_bytes(id, 4);
+		write_bytes((uint64_t)((int64_t)offset.file_pos - (int64_t)base), 8);
+		write_bytes(offset.control_flags, 1);
+	}
+
+	/* Write to a temporary file first, so a concurrently started game never reads half a cache file. */
+	std::string tmp_file = cache_file + ".tmp";
+	FILE *f = FioFOpenFile(tmp_file, "wb", NO_DIRECTORY);
+	if (f == nullptr) return;
+	bool written = fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+	fclose(f);
+
+	std::error_code error_code;
+	if (written) std::filesystem::rename(OTTD2FS(tmp_file), OTTD2FS(cache_file), error_code);
+	if (!written || error_code) {
+		Debug(sprite, 1, "Could not write sprite section cache file '{}'", cache_file);
+		std::filesystem::remove(OTTD2FS(tmp_file), error_code);
+	}
+}
+
+/**
+ * Start reading the sprite section of a GRF on a worker thread, so
+ * ReadGRFSpriteOffsets does not have to wait for it. The worker uses its
+ * own handle to the file, so the file can be processed in the meantime.
+ * The index is taken from, or stored in, a cache file named after the
+ * MD5 checksum of the GRF, so it usually does not have to be read at all.
+ * @param filename Name of the file.
+ * @param subdir Sub directory of the file.
+ * @param md5sum MD5 checksum of the file, or all zeros if it is not known.
+ */
+void PrefetchGRFSpriteOffsets(const std::string &filename, Subdirectory subdir, const MD5Hash &md5sum)
+{
+	auto [it, inserted] = _grf_sprite_offsets_prefetch.try_emplace(filename);
+	if (!inserted) return;
+
+	std::string cache_file;
+	if (md5sum != MD5Hash{}) {
+		std::string cache_dir = FioFindDirectory(CACHE_DIR);
+		if (!cache_dir.empty()) cache_file = cache_dir + FormatArrayAsHex(md5sum) + ".grfidx";
+	}
+
+	GrfSpriteOffsets *offsets = &it->second.offsets;
+	it->second.task = SubmitTask(TaskCategory::NewGRF, [filename, subdir, md5sum, cache_file, offsets]() {
+		SpriteFile file(filename, subdir, false);
+		if (cache_file.empty() || file.GetContainerVersion() < 2) {
+			ReadGRFSpriteSection(file, *offsets);
+			return;
+		}
+
+		size_t pos = file.GetPos();
+		uint32_t data_offset = file.ReadDword();
+		size_t base = file.GetPos();
+		if (LoadGRFSpriteOffsetsCache(cache_file, md5sum, data_offset, base, *offsets)) return;
+
+		file.SeekTo(pos, SEEK_SET);
+		ReadGRFSpriteSection(file, *offsets);
+		SaveGRFSpriteOffsetsCache(cache_file, md5sum, data_offset, base, *offsets);
+	});
+}
+
+/**
+ * Forget the prefetched sprite sections, once all GRFs have been loaded.
+ */
+void ClearGRFSpriteOffsetsPrefetch()
+{
+	for (auto &[filename, prefetch] : _grf_sprite_offsets_prefetch) prefetch.task.Wait();
+	_grf_sprite_offsets_prefetch.clear();
+	_grf_sprite_offsets = &_grf_sprite_offsets_read;
+}
+
+/**
+ * Parse the sprite section of GRFs, or take the prefetched one.
+ * @param file The GRF we're currently processing, positioned at the offset of the sprite section.
+ */
+void ReadGRFSpriteOffsets(SpriteFile &file)
+{
+	auto it = _grf_sprite_offsets_prefetch.find(file.GetFilename());
+	if (it == _grf_sprite_offsets_prefetch.end()) {
+		ReadGRFSpriteSection(file, _grf_sprite_offsets_read);
+		_grf_sprite_offsets = &_grf_sprite_offsets_read;
+		return;
+	}
+
+	it->second.task.Wait();
+	_grf_sprite_offsets = &it->second.offsets;
+	/* Skip sprite section offset if present. */
+	if (file.GetContainerVersion() >= 2) file.ReadDword();
+}
+
 
 /**
  * Load a real or recolour sprite.
@@ -634,8 +839,8 @@ bool LoadNextSprite(int load_index, SpriteFile &file, uint file_sprite_id)
 			return false;
 		}
 		/* It is not an error if no sprite with the provided ID is found in the sprite section. */
-		auto iter = _grf_sprite_offsets.find(file.ReadDword());
-		if (iter != _grf_sprite_offsets.end()) {
+		auto iter = _grf_sprite_offsets->find(file.ReadDword());
+		if (iter != _grf_sprite_offsets->end()) {
 			file_pos = iter->second.file_pos;
 			control_flags = iter->second.control_flags;
 		} else {
@@ -666,7 +871,6 @@ bool LoadNextSprite(int load_index, SpriteFile &file, uint file_sprite_id)
 	sc->file = &file;
 	sc->file_pos = file_pos;
 	sc->ptr = data;
-	sc->lru = 0;
 	sc->id = file_sprite_id;
 	sc->type = type;
 	sc->warned = false;
@@ -690,106 +894,61 @@ void DupSprite(SpriteID old_spr, SpriteID new_spr)
 }
 
 /**
- * S_FREE_MASK is used to mask-out lower bits of MemBlock::size
- * If they are non-zero, the block is free.
- * S_FREE_MASK has to ensure MemBlock is correctly aligned -
- * it means 8B (S_FREE_MASK == 7) on 64bit systems!
+ * Insert a block at the front of a list.
+ * @param list Sentinel of the list.
+ * @param block Block to insert.
  */
-static const size_t S_FREE_MASK = sizeof(size_t) - 1;
-
-/* to make sure nobody adds things to MemBlock without checking S_FREE_MASK first */
-static_assert(sizeof(MemBlock) == sizeof(size_t));
-/* make sure it's a power of two */
-static_assert((sizeof(size_t) & (sizeof(size_t) - 1)) == 0);
-
-static inline MemBlock *NextBlock(MemBlock *block)
+static inline void LinkBlock(MemBlock &list, MemBlock *block)
 {
-	return (MemBlock*)((uint8_t*)block + (block->size & ~S_FREE_MASK));
+	block->prev = &list;
+	block->next = list.next;
+	list.next->prev = block;
+	list.next = block;
 }
 
-static size_t GetSpriteCacheUsage()
+/**
+ * Remove a block from its list.
+ * @param block Block to remove.
+ */
+static inline void UnlinkBlock(MemBlock *block)
 {
-	size_t tot_size = 0;
-	MemBlock *s;
-
-	for (s = _spritecache_ptr; s->size != 0; s = NextBlock(s)) {
-		if (!(s->size & S_FREE_MASK)) tot_size += s->size;
-	}
-
-	return tot_size;
+	block->prev->next = block->next;
+	block->next->prev = block->prev;
 }
 
-
-void IncreaseSpriteLRU()
+/**
+ * Remove a block from its list and release its memory.
+ * @param block Block to free.
+ */
+static void FreeBlock(MemBlock *block)
 {
-	/* Increase all LRU values */
-	if (_sprite_lru_counter > 16384) {
-		SpriteID i;
-
-		Debug(sprite, 5, "Fixing lru {}, inuse={}", _sprite_lru_counter, GetSpriteCacheUsage());
-
-		for (i = 0; i != _spritecache_items; i++) {
-			SpriteCache *sc = GetSpriteCache(i);
-			if (sc->ptr != nullptr) {
-				if (sc->lru >= 0) {
-					sc->lru = -1;
-				} else if (sc->lru != -32768) {
-					sc->lru--;
-				}
-			}
-		}
-		_sprite_lru_counter = 0;
-	}
+	UnlinkBlock(block);
+	_sprite_cache_usage -= block->size;
+	::operator delete(block, std::align_val_t{alignof(MemBlock)});
+}
 
-	/* Compact sprite cache every now and then. */
-	if (++_compact_cache_counter >= 740) {
-		CompactSpriteCache();
-		_compact_cache_counter = 0;
+/**
+ * Release all blocks of a list.
+ * @param list Sentinel of the list.
+ */
+static void FreeBlocks(MemBlock &list)
+{
+	while (list.next != &list) {
+		MemBlock *block = list.next;
+		if (block->owner != MemBlock::INVALID_OWNER) GetSpriteCache(block->owner)->ptr = nullptr;
+		FreeBlock(block);
 	}
 }
 
 /**
- * Called when holes in the sprite cache should be removed.
- * That is accomplished by moving the cached data.
+ * Get the statistics of the use of the sprite cache.
+ * @return The statistics.
  */
-static void CompactSpriteCache()
+const SpriteCacheStatistics &GetSpriteCacheStatistics()
 {
-	MemBlock *s;
-
-	Debug(sprite, 3, "Compacting sprite cache, inuse={}", GetSpriteCacheUsage());
-
-	for (s = _spritecache_ptr; s->size != 0;) {
-		if (s->size & S_FREE_MASK) {
-			MemBlock *next = NextBlock(s);
-			MemBlock temp;
-			SpriteID i;
-
-			/* Since free blocks are automatically coalesced, this should hold true. */
-			assert(!(next->size & S_FREE_MASK));
-
-			/* If the next block is the sentinel block, we can safely return */
-			if (next->size == 0) break;
-
-			/* Locate the sprite belonging to the next pointer. */
-			for (i = 0; GetSpriteCache(i)->ptr != next->data; i++) {
-				assert(i != _spritecache_items);
-			}
-
-			GetSpriteCache(i)->ptr = s->data; // Adjust sprite array entry
-			/* Swap this and the next block */
-			temp = *s;
-			memmove(s, next, next->size);
-			s = NextBlock(s);
-			*s = temp;
-
-			/* Coalesce free blocks */
-			while (NextBlock(s)->size & S_FREE_MASK) {
-				s->size += NextBlock(s)->size & ~S_FREE_MASK;
-			}
-		} else {
-			s = NextBlock(s);
-		}
-	}
+	_sprite_cache_stats.usage = _sprite_cache_usage;
+	_sprite_cache_stats.budget = _sprite_cache_budget;
+	return _sprite_cache_stats;
 }
 
 /**
@@ -798,80 +957,31 @@ static void CompactSpriteCache()
  */
 static void DeleteEntryFromSpriteCache(uint item)
 {
-	/* Mark the block as free (the block must be in use) */
-	MemBlock *s = (MemBlock*)GetSpriteCache(item)->ptr - 1;
-	assert(!(s->size & S_FREE_MASK));
-	s->size |= S_FREE_MASK;
-	GetSpriteCache(item)->ptr = nullptr;
-
-	/* And coalesce adjacent free blocks */
-	for (s = _spritecache_ptr; s->size != 0; s = NextBlock(s)) {
-		if (s->size & S_FREE_MASK) {
-			while (NextBlock(s)->size & S_FREE_MASK) {
-				s->size += NextBlock(s)->size & ~S_FREE_MASK;
-			}
-		}
-	}
-}
-
-static void DeleteEntryFromSpriteCache()
-{
-	uint best = UINT_MAX;
-	int cur_lru;
-
-	Debug(sprite, 3, "DeleteEntryFromSpriteCache, inuse={}", GetSpriteCacheUsage());
-
-	cur_lru = 0xffff;
-	for (SpriteID i = 0; i != _spritecache_items; i++) {
-		SpriteCache *sc = GetSpriteCache(i);
-		if (sc->type != SpriteType::Recolour && sc->ptr != nullptr && sc->lru < cur_lru) {
-			cur_lru = sc->lru;
-			best = i;
-		}
-	}
-
-	/* Display an error message and die, in case we found no sprite at all.
-	 * This shouldn't really happen, unless all sprites are locked. */
-	if (best == UINT_MAX) FatalError("Out of sprite memory");
-
-	DeleteEntryFromSpriteCache(best);
+	SpriteCache *sc = GetSpriteCache(item);
+	FreeBlock(MemBlock::FromData(sc->ptr));
+	sc->ptr = nullptr;
 }
 
 void *AllocSprite(size_t mem_req)
 {
 	mem_req += sizeof(MemBlock);
 
-	/* Align this to correct boundary. This also makes sure at least one
-	 * bit is not used, so we can use it for other things. */
-	mem_req = Align(mem_req, S_FREE_MASK + 1);
-
-	for (;;) {
-		MemBlock *s;
-
-		for (s = _spritecache_ptr; s->size != 0; s = NextBlock(s)) {
-			if (s->size & S_FREE_MASK) {
-				size_t cur_size = s->size & ~S_FREE_MASK;
-
-				/* Is the block exactly the size we need or
-				 * big enough for an additional free block? */
-				if (cur_size == mem_req ||
-						cur_size >= mem_req + sizeof(MemBlock)) {
-					/* Set size and in use */
-					s->size = mem_req;
-
-					/* Do we need to inject a free block too? */
-					if (cur_size != mem_req) {
-						NextBlock(s)->size = (cur_size - mem_req) | S_FREE_MASK;
-					}
+	/* Make room by evicting the least recently used sprites. When nothing
+	 * can be evicted anymore, go over the budget rather than fail. While the
+	 * cache is shared, other threads may still be drawing any of the sprites. */
+	while (!_sprite_cache_shared && _sprite_cache_usage + mem_req > _sprite_cache_budget && _sprite_lru.prev != &_sprite_lru) {
+		DeleteEntryFromSpriteCache(_sprite_lru.prev->owner);
+		_sprite_cache_stats.evictions++;
+	}
 
-					return s->data;
-				}
-			}
-		}
+	/* The block is not evicted until GetRawSprite knows which entry it belongs to. */
+	MemBlock *block = static_cast<MemBlock *>(::operator new(mem_req, std::align_val_t{alignof(MemBlock)}));
+	block->size = mem_req;
+	block->owner = MemBlock::INVALID_OWNER;
+	LinkBlock(_sprite_pinned, block);
+	_sprite_cache_usage += mem_req;
 
-		/* Reached sentinel, but no block found yet. Delete some old entry. */
-		DeleteEntryFromSpriteCache();
-	}
+	return block->Data();
 }
 
 /**
@@ -927,6 +1037,392 @@ static void *HandleInvalidSpriteRequest(SpriteID sprite, SpriteType requested, S
 	}
 }
 
+static const uint32_t ENCODED_SPRITE_CACHE_MAGIC = 0x4553544F;   ///< Magic at the start of an encoded sprite cache file, "OTSE".
+static const uint32_t ENCODED_SPRITE_CACHE_VERSION = 1;          ///< Version of the format of the cache files; bump it when the format or the encoding of any blitter changes.
+static const size_t ENCODED_SPRITE_CACHE_HEADER_SIZE = 4 + 4 + MD5_HASH_BYTES; ///< Size of the header of a cache file.
+static const size_t ENCODED_SPRITE_CACHE_RECORD_SIZE = 8 + 1 + 4; ///< Size of the header of one sprite in a cache file.
+static const size_t ENCODED_SPRITE_CACHE_MAX_SIZE = 1024 * 1024 * 1024; ///< No sprites are added to cache files of this size.
+
+bool _sprite_disk_cache = false; ///< Whether encoded sprites are kept in cache files, so they do not have to be decoded the next time.
+
+/** Sprite in an encoded sprite cache file. */
+struct EncodedSpriteRecord {
+	size_t offset;         ///< Position of the encoded sprite in the cache file; 0 when it was added after the file was opened.
+	uint32_t size;         ///< Size of the encoded sprite.
+	uint8_t control_flags; ///< Control flags of the sprite it was encoded with.
+};
+
+/**
+ * Cache file with the sprites of one sprite file as encoded by the current blitter.
+ * The sprites that were in the file when it was opened are read from it; with a
+ * mapped file that is a copy straight from the page cache, which is shared with
+ * other games using the same cache file. Newly encoded sprites are appended.
+ */
+struct EncodedSpriteCacheFile {
+	std::unique_ptr<RandomAccessFile> file;      ///< The cache file as it was when it was opened, if it was valid.
+	FILE *append = nullptr;                      ///< The cache file for appending sprites, or nullptr if that is not possible.
+	size_t size = 0;                             ///< Size of the cache file.
+	std::map<size_t, EncodedSpriteRecord> index; ///< The sprites in the cache file, by their position in the sprite file.
+
+	~EncodedSpriteCacheFile()
+	{
+		if (this->append != nullptr) fclose(this->append);
+	}
+};
+
+static std::map<const SpriteFile *, std::unique_ptr<EncodedSpriteCacheFile>> _encoded_sprite_caches; ///< Opened encoded sprite cache files, by sprite file.
+
+/**
+ * Determine the name of the encoded sprite cache file of a sprite file. It is named
+ * after a checksum of the contents of the sprite file and everything that
+ * influences the encoding, so the file never has to be checked for being outdated.
+ * @param file The sprite file.
+ * @return Name of the cache file, or an empty string when there is no cache directory.
+ */
+static std::string GetEncodedSpriteCacheFileName(const SpriteFile &file)
+{
+	std::string cache_dir = FioFindDirectory(CACHE_DIR);
+	if (cache_dir.empty()) return {};
+
+	size_t size;
+	FILE *f = FioFOpenFile(file.GetFilename(), "rb", file.GetSubdirectory(), &size);
+	if (f == nullptr) return {};
+
+	Md5 checksum;
+	uint8_t buffer[16 * 1024];
+	while (size != 0) {
+		size_t len = fread(buffer, 1, std::min(size, sizeof(buffer)), f);
+		if (len == 0) break;
+		checksum.Append(buffer, len);
+		size -= len;
+	}
+	fclose(f);
+
+	const char *blitter = BlitterFactory::GetCurrentBlitter()->GetName();
+	const uint8_t settings[] = { file.NeedsPaletteRemap(), (uint8_t)_settings_client.gui.zoom_min, (uint8_t)_settings_client.gui.zoom_max, (uint8_t)_settings_client.gui.sprite_zoom_min };
+	checksum.Append(blitter, strlen(blitter));
+	checksum.Append(settings, sizeof(settings));
+
+	MD5Hash md5sum;
+	checksum.Finish(md5sum);
+	return cache_dir + FormatArrayAsHex(md5sum) + ".sprenc";
+}
+
+/**
+ * Read the index of an encoded sprite cache file.
+ * @param cache The cache file, with its file opened.
+ * @return True if the file is valid.
+ */
+static bool ReadEncodedSpriteCacheIndex(EncodedSpriteCacheFile &cache)
+{
+	RandomAccessFile &file = *cache.file;
+	if (cache.size < ENCODED_SPRITE_CACHE_HEADER_SIZE) return false;
+	if (file.ReadDword() != ENCODED_SPRITE_CACHE_MAGIC || file.ReadDword() != ENCODED_SPRITE_CACHE_VERSION) return false;
+	file.SkipBytes(MD5_HASH_BYTES);
+
+	/* Stop at a half written sprite, which another game might still be writing. */
+	size_t pos = ENCODED_SPRITE_CACHE_HEADER_SIZE;
+	while (pos + ENCODED_SPRITE_CACHE_RECORD_SIZE <= cache.size) {
+		uint64_t file_pos = file.ReadDword();
+		file_pos |= (uint64_t)file.ReadDword() << 32;
+		EncodedSpriteRecord record;
+		record.control_flags = file.ReadByte();
+		record.size = file.ReadDword();
+		record.offset = pos + ENCODED_SPRITE_CACHE_RECORD_SIZE;
+		if (record.size > cache.size - record.offset) break;
+
+		cache.index[(size_t)file_pos] = record;
+		file.SkipBytes(record.size);
+		pos = record.offset + record.size;
+	}
+	return true;
+}
+
+/**
+ * Get the encoded sprite cache file of a sprite file, opening it if needed.
+ * @param file The sprite file.
+ * @return The cache file.
+ */
+static EncodedSpriteCacheFile &GetEncodedSpriteCacheFile(const SpriteFile &file)
+{
+	std::unique_ptr<EncodedSpriteCacheFile> &cache = _encoded_sprite_caches[&file];
+	if (cache != nullptr) return *cache;
+
+	cache = std::make_unique<EncodedSpriteCacheFile>();
+	std::string cache_file = GetEncodedSpriteCacheFileName(file);
+	if (cache_file.empty()) return *cache;
+
+	if (FioCheckFileExists(cache_file, NO_DIRECTORY)) {
+		std::error_code error_code;
+		cache->size = std::filesystem::file_size(OTTD2FS(cache_file), error_code);
+		cache->file = std::make_unique<RandomAccessFile>(cache_file, NO_DIRECTORY);
+		if (error_code || !ReadEncodedSpriteCacheIndex(*cache)) {
+			cache->file.reset();
+			cache->index.clear();
+		}
+	}
+
+	if (cache->file != nullptr) {
+		cache->append = FioFOpenFile(cache_file, "ab", NO_DIRECTORY);
+	} else {
+		/* Start a new file, replacing any invalid one. */
+		cache->append = FioFOpenFile(cache_file, "wb", NO_DIRECTORY);
+		if (cache->append == nullptr) return *cache;
+
+		uint8_t header[ENCODED_SPRITE_CACHE_HEADER_SIZE] = {};
+		for (uint i = 0; i < 4; i++) header[i] = GB(ENCODED_SPRITE_CACHE_MAGIC, i * 8, 8);
+		for (uint i = 0; i < 4; i++) header[4 + i] = GB(ENCODED_SPRITE_CACHE_VERSION, i * 8, 8);
+		if (fwrite(header, 1, sizeof(header), cache->append) != sizeof(header)) {
+			fclose(cache->append);
+			cache->append = nullptr;
+			return *cache;
+		}
+		cache->size = sizeof(header);
+	}
+	return *cache;
+}
+
+/**
+ * Load a sprite from the encoded sprite cache file of its sprite file.
+ * @param sc Entry of the sprite.
+ * @return The sprite, allocated in the sprite cache, or nullptr when it is not in the cache file.
+ */
+static void *LoadEncodedSprite(const SpriteCache *sc)
+{
+	EncodedSpriteCacheFile &cache = GetEncodedSpriteCacheFile(*sc->file);
+	auto it = cache.index.find(sc->file_pos);
+	if (it == cache.index.end() || it->second.offset == 0 || it->second.control_flags != sc->control_flags) return nullptr;
+
+	void *ptr = AllocSprite(it->second.size);
+	cache.file->SeekTo(it->second.offset, SEEK_SET);
+	cache.file->ReadBlock(ptr, it->second.size);
+	return ptr;
+}
+
+/**
+ * Add an encoded sprite to the encoded sprite cache file of its sprite file.
+ * The encoded sprites only contain offsets relative to their data, so they can be stored as they are.
+ * @param sc Entry of the sprite.
+ * @param data The encoded sprite.
+ * @param size Size of the encoded sprite.
+ */
+static void SaveEncodedSprite(const SpriteCache *sc, const void *data, size_t size)
+{
+	EncodedSpriteCacheFile &cache = GetEncodedSpriteCacheFile(*sc->file);
+	if (cache.append == nullptr || cache.size >= ENCODED_SPRITE_CACHE_MAX_SIZE) return;
+	if (!cache.index.try_emplace(sc->file_pos, EncodedSpriteRecord{0, (uint32_t)size, sc->control_flags}).second) return;
+
+	/* Write the sprite in one go, so games appending to the same file do not mix up their sprites. */
+	std::vector<uint8_t> buf;
+	buf.reserve(ENCODED_SPRITE_CACHE_RECORD_SIZE + size);
+	auto write_bytes = [&buf](uint64_t v, uint n) {
+		for (uint i = 0; i < n; i++) buf.push_back(GB(v, i * 8, 8));
+	};
+	write_bytes(sc->file_pos, 8);
+	write_bytes(sc->control_flags, 1);
+	write_bytes(size, 4);
+	buf.insert(buf.end(), static_cast<const uint8_t *>(data), static_cast<const uint8_t *>(data) + size);
+
+	if (fwrite(buf.data(), 1, buf.size(), cache.append) != buf.size() || fflush(cache.append) != 0) {
+		Debug(sprite, 1, "Could not write to encoded sprite cache file of '{}'", sc->file->GetFilename());
+		fclose(cache.append);
+		cache.append = nullptr;
+		return;
+	}
+	cache.size += buf.size();
+}
+
+/** Maximum number of sprites decoded in the background at the same time; further sprites are decoded right away. */
+static const size_t MAX_ASYNC_SPRITES = 512;
+
+bool _async_sprite_decoding = true; ///< Whether sprites that are missing while drawing the viewports may be decoded in the background.
+bool _draw_async_sprites = false;   ///< Whether the sprites being drawn may be decoded in the background, drawing a placeholder until they are ready.
+bool _sprite_cache_shared = false;  ///< Whether several threads get sprites at the same time; the cache is then locked and nothing is evicted.
+
+/** Lock of the sprite cache while it is shared; recursive as getting a sprite may get its fallback sprite. */
+static std::recursive_mutex _sprite_cache_mutex;
+
+/** Sprite that is being decoded by a worker thread. */
+struct AsyncSprite {
+	TaskHandle task;                 ///< Task decoding the sprite.
+	SpriteCache sc;                  ///< Copy of the entry of the sprite at the time it was requested.
+	SpriteEncoder *encoder;          ///< Encoder the sprite is encoded with.
+	std::unique_ptr<uint8_t[]> data; ///< The encoded sprite, or nullptr if it could not be decoded; only valid once the task is done.
+	size_t size = 0;                 ///< Size of the encoded sprite.
+};
+
+/**
+ * The sprites being decoded in the background, by sprite number. On exit the
+ * tasks are waited for, before the files and blitters they use are destroyed.
+ */
+struct AsyncSprites : std::map<SpriteID, std::unique_ptr<AsyncSprite>> {
+	~AsyncSprites()
+	{
+		for (auto &it : *this) it.second->task.Wait();
+	}
+};
+
+static AsyncSprites _async_sprites;
+static Sprite *_async_sprite_placeholder = nullptr; ///< Transparent sprite drawn instead of the sprites being decoded.
+static uint _sprite_files_generation = 0; ///< Changed whenever the sprite files are closed, so the workers drop their copies of them.
+static thread_local AsyncSprite *_async_sprite_target = nullptr; ///< Sprite being decoded by this worker.
+
+/**
+ * Get the copy of this worker of a sprite file. The workers cannot share the file
+ * with the main thread, as that would move the file position under its feet.
+ * @param file The sprite file.
+ * @param generation Value of #_sprite_files_generation when the sprite was requested.
+ * @return The copy of the file.
+ */
+static SpriteFile &GetSpriteFileForWorker(const SpriteFile &file, uint generation)
+{
+	static thread_local std::map<const SpriteFile *, std::unique_ptr<SpriteFile>> files;
+	static thread_local uint files_generation = 0;
+
+	if (files_generation != generation) {
+		files.clear();
+		files_generation = generation;
+	}
+
+	std::unique_ptr<SpriteFile> &copy = files[&file];
+	if (copy == nullptr) copy = std::make_unique<SpriteFile>(file.GetFilename(), file.GetSubdirectory(), file.NeedsPaletteRemap());
+	return *copy;
+}
+
+/**
+ * Sprite allocator of the workers; the encoded sprite is copied into the sprite cache by the main thread.
+ * @param size Size of the sprite.
+ * @return Memory for the sprite.
+ */
+static void *AsyncSpriteAlloc(size_t size)
+{
+	_async_sprite_target->data.reset(new uint8_t[size]);
+	_async_sprite_target->size = size;
+	return _async_sprite_target->data.get();
+}
+
+/**
+ * Get the placeholder that is drawn while a sprite is decoded in the background.
+ * @return The placeholder, encoded for the current blitter.
+ */
+static Sprite *GetAsyncSpritePlaceholder()
+{
+	if (_async_sprite_placeholder == nullptr) {
+		static SpriteLoader::CommonPixel pixel{};
+		SpriteLoader::SpriteCollection sprite;
+		for (ZoomLevel zoom = ZOOM_LVL_BEGIN; zoom != ZOOM_LVL_END; zoom++) {
+			sprite[zoom].width = 1;
+			sprite[zoom].height = 1;
+			sprite[zoom].x_offs = 0;
+			sprite[zoom].y_offs = 0;
+			sprite[zoom].type = SpriteType::Normal;
+			sprite[zoom].colours = SCC_PAL;
+			sprite[zoom].data = &pixel;
+		}
+		_async_sprite_placeholder = BlitterFactory::GetCurrentBlitter()->Encode(sprite, SimpleSpriteAlloc);
+	}
+	return _async_sprite_placeholder;
+}
+
+/**
+ * Request a sprite to be decoded in the background.
+ * @param sprite The sprite.
+ * @param sc Entry of the sprite.
+ * @return True if the sprite is being decoded in the background, false if it has to be decoded right away.
+ */
+static bool RequestAsyncSprite(SpriteID sprite, const SpriteCache *sc)
+{
+	if (_async_sprites.find(sprite) != _async_sprites.end()) return true;
+	if (_async_sprites.size() >= MAX_ASYNC_SPRITES || !HasTaskWorkers()) return false;
+
+	_sprite_cache_stats.misses++;
+
+	std::unique_ptr<AsyncSprite> &request = _async_sprites[sprite];
+	request = std::make_unique<AsyncSprite>();
+	request->sc = *sc;
+	request->encoder = BlitterFactory::GetCurrentBlitter();
+
+	AsyncSprite *target = request.get();
+	uint generation = _sprite_files_generation;
+	target->task = SubmitTask(TaskCategory::Sprite, [target, sprite, generation]() {
+		SpriteFile &file = GetSpriteFileForWorker(*target->sc.file, generation);
+		_async_sprite_target = target;
+		if (ReadSprite(&target->sc, sprite, target->sc.type, AsyncSpriteAlloc, target->encoder, file, true) == nullptr) target->data.reset();
+		_async_sprite_target = nullptr;
+	});
+	return true;
+}
+
+/**
+ * Put a sprite that has been decoded in the background into the sprite cache.
+ * @param sprite The sprite.
+ * @param request The decoded sprite.
+ */
+static void ApplyAsyncSprite(SpriteID sprite, const AsyncSprite &request)
+{
+	/* Skip the sprite when it has been loaded or changed in the meantime. */
+	SpriteCache *sc = GetSpriteCache(sprite);
+	if (sc->ptr != nullptr || sc->type != request.sc.type || sc->file != request.sc.file || sc->file_pos != request.sc.file_pos) return;
+	if (request.encoder != BlitterFactory::GetCurrentBlitter()) return;
+
+	if (request.data == nullptr) {
+		/* Let the usual path deal with it, including the fallback sprite. */
+		GetRawSprite(sprite, sc->type);
+		return;
+	}
+
+	/* The encoded sprites only contain offsets relative to their data, so they can be moved. */
+	sc->ptr = AllocSprite(request.size);
+	memcpy(sc->ptr, request.data.get(), request.size);
+	if (_sprite_disk_cache) SaveEncodedSprite(sc, sc->ptr, request.size);
+	MemBlock *block = MemBlock::FromData(sc->ptr);
+	block->owner = sprite;
+	UnlinkBlock(block);
+	LinkBlock(_sprite_lru, block);
+}
+
+/**
+ * Put the sprites that have been decoded in the background into the sprite cache,
+ * and redraw the screen to replace their placeholders.
+ */
+void ProcessAsyncSprites()
+{
+	bool applied = false;
+	for (auto it = _async_sprites.begin(); it != _async_sprites.end(); /* nothing */) {
+		if (!it->second->task.IsDone()) {
+			++it;
+			continue;
+		}
+		ApplyAsyncSprite(it->first, *it->second);
+		applied = true;
+		it = _async_sprites.erase(it);
+	}
+
+	if (applied) MarkWholeScreenDirty();
+}
+
+/**
+ * Wait for all sprites that are decoded in the background, and put them in the sprite cache.
+ */
+void WaitForAsyncSprites()
+{
+	for (auto &it : _async_sprites) it.second->task.Wait();
+	ProcessAsyncSprites();
+}
+
+/**
+ * Wait for all sprites that are decoded in the background, and throw them away.
+ * Must be called before the sprite files, the sprite cache or the blitter go away.
+ */
+void DiscardAsyncSprites()
+{
+	for (auto &it : _async_sprites) it.second->task.Wait();
+	_async_sprites.clear();
+
+	free(_async_sprite_placeholder);
+	_async_sprite_placeholder = nullptr;
+}
+
 /**
  * Reads a sprite (from disk or sprite cache).
  * If the sprite is not available or of wrong type, a fallback sprite is returned.
@@ -941,6 +1437,9 @@ void *GetRawSprite(SpriteID sprite, SpriteType type, AllocatorProc *allocator, S
 	assert(type != SpriteType::MapGen || IsMapgenSpriteID(sprite));
 	assert(type < SpriteType::Invalid);
 
+	std::unique_lock<std::recursive_mutex> lock(_sprite_cache_mutex, std::defer_lock);
+	if (_sprite_cache_shared) lock.lock();
+
 	if (!SpriteExists(sprite)) {
 		Debug(sprite, 1, "Tried to load non-existing sprite #{}. Probable cause: Wrong/missing NewGRFs", sprite);
 
@@ -955,69 +1454,94 @@ void *GetRawSprite(SpriteID sprite, SpriteType type, AllocatorProc *allocator, S
 	if (allocator == nullptr && encoder == nullptr) {
 		/* Load sprite into/from spritecache */
 
-		/* Update LRU */
-		sc->lru = ++_sprite_lru_counter;
+		if (sc->ptr == nullptr) {
+			/* Copying an encoded sprite from its cache file is cheap enough to always do right away. */
+			bool cached = false;
+			if (_sprite_disk_cache && type == SpriteType::Normal) {
+				sc->ptr = LoadEncodedSprite(sc);
+				cached = sc->ptr != nullptr;
+			}
+
+			/* While drawing the viewports, leave decoding to a worker and draw a placeholder until it is done. */
+			if (!cached && _draw_async_sprites && type == SpriteType::Normal && RequestAsyncSprite(sprite, sc)) return GetAsyncSpritePlaceholder();
 
-		/* Load the sprite, if it is not loaded, yet */
-		if (sc->ptr == nullptr) sc->ptr = ReadSprite(sc, sprite, type, AllocSprite, nullptr);
+			/* Load the sprite, and make it the most recently used one. */
+			_sprite_cache_stats.misses++;
+			if (!cached) sc->ptr = ReadSprite(sc, sprite, type, AllocSprite, nullptr, *sc->file);
+			if (sc->ptr != nullptr) {
+				MemBlock *block = MemBlock::FromData(sc->ptr);
+				/* A fallback sprite is not this sprite, so it does not belong in the cache file. */
+				if (!cached && _sprite_disk_cache && type == SpriteType::Normal && block->owner == MemBlock::INVALID_OWNER && sc->type == type) {
+					SaveEncodedSprite(sc, sc->ptr, block->size - sizeof(MemBlock));
+				}
+				block->owner = sprite;
+				UnlinkBlock(block);
+				LinkBlock(_sprite_lru, block);
+			}
+		} else {
+			/* Move the sprite to the front of the LRU list; blocks that are not evicted are not in that list. */
+			_sprite_cache_stats.hits++;
+			MemBlock *block = MemBlock::FromData(sc->ptr);
+			if (block->owner == sprite) {
+				UnlinkBlock(block);
+				LinkBlock(_sprite_lru, block);
+			}
+		}
 
 		return sc->ptr;
 	} else {
 		/* Do not use the spritecache, but a different allocator. */
-		return ReadSprite(sc, sprite, type, allocator, encoder);
+		return ReadSprite(sc, sprite, type, allocator, encoder, *sc->file);
 	}
 }
 
 
 static void GfxInitSpriteCache()
 {
-	/* initialize sprite cache heap */
+	/* Determine the budget of the sprite cache. */
 	int bpp = BlitterFactory::GetCurrentBlitter()->GetScreenDepth();
 	uint target_size = (bpp > 0 ? _sprite_cache_size * bpp / 8 : 1) * 1024 * 1024;
 
-	/* Remember 'target_size' from the previous allocation attempt, so we do not try to reach the target_size multiple times in case of failure. */
+	/* Remember 'target_size' from the previous attempt, so we do not try to reach the target_size multiple times in case of failure. */
 	static uint last_alloc_attempt = 0;
 
-	if (_spritecache_ptr == nullptr || (_allocated_sprite_cache_size != target_size && target_size != last_alloc_attempt)) {
-		delete[] reinterpret_cast<uint8_t *>(_spritecache_ptr);
-
+	if (_sprite_cache_budget == 0 || (_sprite_cache_budget != target_size && target_size != last_alloc_attempt)) {
 		last_alloc_attempt = target_size;
-		_allocated_sprite_cache_size = target_size;
-
-		do {
-			/* Try to allocate 50% more to make sure we do not allocate almost all available. */
-			_spritecache_ptr = reinterpret_cast<MemBlock *>(new(std::nothrow) uint8_t[_allocated_sprite_cache_size + _allocated_sprite_cache_size / 2]);
-
-			if (_spritecache_ptr != nullptr) {
-				/* Allocation succeeded, but we wanted less. */
-				delete[] reinterpret_cast<uint8_t *>(_spritecache_ptr);
-				_spritecache_ptr = reinterpret_cast<MemBlock *>(new uint8_t[_allocated_sprite_cache_size]);
-			} else if (_allocated_sprite_cache_size < 2 * 1024 * 1024) {
-				UserError("Cannot allocate spritecache");
-			} else {
-				/* Try again to allocate half. */
-				_allocated_sprite_cache_size >>= 1;
+		size_t budget = target_size;
+
+		/* The sprites are allocated when they are loaded, but check that the memory for them is
+		 * there. Try to allocate 50% more to make sure we do not end up using almost all available. */
+		for (;;) {
+			uint8_t *probe = new(std::nothrow) uint8_t[budget + budget / 2];
+			if (probe != nullptr) {
+				delete[] probe;
+				break;
 			}
-		} while (_spritecache_ptr == nullptr);
+			if (budget < 2 * 1024 * 1024) UserError("Cannot allocate spritecache");
+			/* Try again with half. */
+			budget >>= 1;
+		}
+		_sprite_cache_budget = budget;
 
-		if (_allocated_sprite_cache_size != target_size) {
-			Debug(misc, 0, "Not enough memory to allocate {} MiB of spritecache. Spritecache was reduced to {} MiB.", target_size / 1024 / 1024, _allocated_sprite_cache_size / 1024 / 1024);
+		if (_sprite_cache_budget != target_size) {
+			Debug(misc, 0, "Not enough memory to allocate {} MiB of spritecache. Spritecache was reduced to {} MiB.", target_size / 1024 / 1024, _sprite_cache_budget / 1024 / 1024);
 
 			ErrorMessageData msg(STR_CONFIG_ERROR_OUT_OF_MEMORY, STR_CONFIG_ERROR_SPRITECACHE_TOO_BIG);
 			msg.SetDParam(0, target_size);
-			msg.SetDParam(1, _allocated_sprite_cache_size);
+			msg.SetDParam(1, _sprite_cache_budget);
 			ScheduleErrorMessage(msg);
 		}
 	}
 
-	/* A big free block */
-	_spritecache_ptr->size = (_allocated_sprite_cache_size - sizeof(MemBlock)) | S_FREE_MASK;
-	/* Sentinel block (identified by size == 0) */
-	NextBlock(_spritecache_ptr)->size = 0;
+	/* Drop all sprites; the entries referring to them are about to be reset. */
+	FreeBlocks(_sprite_lru);
+	FreeBlocks(_sprite_pinned);
 }
 
 void GfxInitSpriteMem()
 {
+	DiscardAsyncSprites();
+	_encoded_sprite_caches.clear();
 	GfxInitSpriteCache();
 
 	/* Reset the spritecache 'pool' */
@@ -1025,8 +1549,8 @@ void GfxInitSpriteMem()
 	_spritecache_items = 0;
 	_spritecache = nullptr;
 
-	_compact_cache_counter = 0;
 	_sprite_files.clear();
+	_sprite_files_generation++;
 }
 
 /**
@@ -1035,11 +1559,12 @@ void GfxInitSpriteMem()
  */
 void GfxClearSpriteCache()
 {
-	/* Clear sprite ptr for all cached items */
-	for (uint i = 0; i != _spritecache_items; i++) {
-		SpriteCache *sc = GetSpriteCache(i);
-		if (sc->type != SpriteType::Recolour && sc->ptr != nullptr) DeleteEntryFromSpriteCache(i);
-	}
+	DiscardAsyncSprites();
+	/* The blitter or zoom levels changed, so the sprites are encoded differently now. */
+	_encoded_sprite_caches.clear();
+
+	/* Clear sprite ptr for all cached items; recolour sprites are not in the LRU list. */
+	FreeBlocks(_sprite_lru);
 
 	VideoDriver::GetInstance()->ClearSystemSprites();
 }
@@ -1057,4 +1582,4 @@ void GfxClearFontSpriteCache()
 	}
 }
 
-/* static */ ReusableBuffer<SpriteLoader::CommonPixel> SpriteLoader::Sprite::buffer[ZOOM_LVL_END];
+/* static */ thread_local ReusableBuffer<SpriteLoader::CommonPixel> SpriteLoader::Sprite::buffer[ZOOM_LVL_END];
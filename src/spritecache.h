@@ -13,6 +13,8 @@
 #include "gfx_type.h"
 #include "spriteloader/spriteloader.hpp"
 
+struct MD5Hash;
+
 /** Data structure describing a sprite. */
 struct Sprite {
 	uint16_t height; ///< Height of the sprite.
@@ -30,6 +32,10 @@ enum SpriteCacheCtrlFlags {
 };
 
 extern uint _sprite_cache_size;
+extern bool _async_sprite_decoding;
+extern bool _draw_async_sprites;
+extern bool _sprite_cache_shared;
+extern bool _sprite_disk_cache;
 
 typedef void *AllocatorProc(size_t size);
 
@@ -59,10 +65,26 @@ inline const uint8_t *GetNonSprite(SpriteID sprite, SpriteType type)
 void GfxInitSpriteMem();
 void GfxClearSpriteCache();
 void GfxClearFontSpriteCache();
-void IncreaseSpriteLRU();
+
+void ProcessAsyncSprites();
+void WaitForAsyncSprites();
+void DiscardAsyncSprites();
+
+/** Statistics of the use of the sprite cache. */
+struct SpriteCacheStatistics {
+	uint64_t hits = 0;      ///< Number of requested sprites that were in the cache.
+	uint64_t misses = 0;    ///< Number of requested sprites that had to be loaded.
+	uint64_t evictions = 0; ///< Number of sprites removed to make room for others.
+	size_t usage = 0;       ///< Number of bytes used by the cached sprites.
+	size_t budget = 0;      ///< Number of bytes the cached sprites may use.
+};
+
+const SpriteCacheStatistics &GetSpriteCacheStatistics();
 
 SpriteFile &OpenCachedSpriteFile(const std::string &filename, Subdirectory subdir, bool palette_remap);
 
+void PrefetchGRFSpriteOffsets(const std::string &filename, Subdirectory subdir, const MD5Hash &md5sum);
+void ClearGRFSpriteOffsetsPrefetch();
 void ReadGRFSpriteOffsets(SpriteFile &file);
 size_t GetGRFSpriteOffset(uint32_t id);
 bool LoadNextSprite(int load_index, SpriteFile &file, uint file_sprite_id);
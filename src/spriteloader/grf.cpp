@@ -81,10 +81,8 @@ bool DecodeSingleSprite(SpriteLoader::Sprite *sprite, SpriteFile &file, size_t f
 			int size = (code == 0) ? 0x80 : code;
 			num -= size;
 			if (num < 0) return WarnCorruptSprite(file, file_pos, __LINE__);
-			for (; size > 0; size--) {
-				*dest = file.ReadByte();
-				dest++;
-			}
+			file.ReadBlock(dest, size);
+			dest += size;
 		} else {
 			/* Copy bytes from earlier in the sprite */
 			const uint data_offset = ((code & 7) << 8) | file.ReadByte();
@@ -43,7 +43,7 @@ static uint8_t GetGRFContainerVersion(SpriteFile &file)
  * @param palette_remap Whether a palette remap needs to be performed for this file.
  */
 SpriteFile::SpriteFile(const std::string &filename, Subdirectory subdir, bool palette_remap)
-	: RandomAccessFile(filename, subdir), palette_remap(palette_remap)
+	: RandomAccessFile(filename, subdir), palette_remap(palette_remap), subdir(subdir)
 {
 	this->container_version = GetGRFContainerVersion(*this);
 	this->content_begin = this->GetPos();
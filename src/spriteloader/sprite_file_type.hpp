@@ -20,6 +20,7 @@ class SpriteFile : public RandomAccessFile {
 	bool palette_remap;     ///< Whether or not a remap of the palette is required for this file.
 	uint8_t container_version; ///< Container format of the sprite file.
 	size_t content_begin;   ///< The begin of the content of the sprite file, i.e. after the container metadata.
+	Subdirectory subdir;    ///< The sub directory the file was found in.
 public:
 	SpriteFile(const std::string &filename, Subdirectory subdir, bool palette_remap);
 	SpriteFile(const SpriteFile&) = delete;
@@ -37,6 +38,12 @@ public:
 	 */
 	uint8_t GetContainerVersion() const { return this->container_version; }
 
+	/**
+	 * Get the sub directory the file was opened from.
+	 * @return The sub directory.
+	 */
+	Subdirectory GetSubdirectory() const { return this->subdir; }
+
 	/**
 	 * Seek to the begin of the content, i.e. the position just after the container version has been determined.
 	 */
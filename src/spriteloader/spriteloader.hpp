@@ -61,8 +61,8 @@ public:
 		 */
 		void AllocateData(ZoomLevel zoom, size_t size) { this->data = Sprite::buffer[zoom].ZeroAllocate(size); }
 	private:
-		/** Allocated memory to pass sprite data around */
-		static ReusableBuffer<SpriteLoader::CommonPixel> buffer[ZOOM_LVL_END];
+		/** Allocated memory to pass sprite data around; per thread, as sprites are also decoded in the background. */
+		static thread_local ReusableBuffer<SpriteLoader::CommonPixel> buffer[ZOOM_LVL_END];
 	};
 
 	/**
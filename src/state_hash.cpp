@@ -0,0 +1,194 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file state_hash.cpp Hashes of parts of the game state, to find where a client desynced. */
+
+#include "stdafx.h"
+#include "state_hash.h"
+#include "map_func.h"
+#include "vehicle_base.h"
+#include "station_base.h"
+#include "town.h"
+#include "industry.h"
+#include "company_base.h"
+#include "thread.h"
+
+#include "safeguards.h"
+
+/**
+ * Hash of a sequence of values. It only needs to tell apart states that differ,
+ * not to withstand attacks, so a cheap multiply and shift per value suffices.
+ */
+class StateHasher {
+	uint64_t hash = 0xCBF29CE484222325; ///< The hash so far.
+
+public:
+	/**
+	 * Add a value to the hash.
+	 * @param value The value.
+	 */
+	inline void Add(uint64_t value)
+	{
+		this->hash = (this->hash ^ value) * 0x100000001B3;
+		this->hash ^= this->hash >> 29;
+	}
+
+	/**
+	 * Get the hash of the values added so far.
+	 * @return The hash.
+	 */
+	inline uint64_t Get() const
+	{
+		return this->hash;
+	}
+};
+
+/**
+ * Hash a band of rows of the map.
+ * @param band The band, see #STATE_HASH_MAP_BANDS.
+ * @return The hash.
+ */
+static uint64_t HashMapBand(uint band)
+{
+	uint rows = Map::SizeY() / STATE_HASH_MAP_BANDS;
+	TileIndex first = TileXY(0, band * rows);
+	TileIndex end = TileXY(0, (band + 1) * rows);
+
+	StateHasher hasher;
+	for (TileIndex t = first; t < end; t++) {
+		Tile tile(t);
+		hasher.Add(tile.type() | tile.height() << 8 | tile.m2() << 16 | static_cast<uint64_t>(tile.m1()) << 32 |
+				static_cast<uint64_t>(tile.m3()) << 40 | static_cast<uint64_t>(tile.m4()) << 48 | static_cast<uint64_t>(tile.m5()) << 56);
+		hasher.Add(tile.m6() | tile.m7() << 8 | tile.m8() << 16);
+	}
+	return hasher.Get();
+}
+
+/**
+ * Hash the parts of the vehicles that follow from the game state and are not caches.
+ * @return The hash.
+ */
+static uint64_t HashVehicles()
+{
+	StateHasher hasher;
+	for (const Vehicle *v : Vehicle::Iterate()) {
+		hasher.Add(v->index | v->type << 24 | static_cast<uint64_t>(v->owner) << 32 | static_cast<uint64_t>(v->direction) << 40 | static_cast<uint64_t>(v->subtype) << 48);
+		hasher.Add(v->tile.base() | static_cast<uint64_t>(v->progress) << 32 | static_cast<uint64_t>(v->subspeed) << 40);
+		hasher.Add(static_cast<uint32_t>(v->x_pos) | static_cast<uint64_t>(static_cast<uint32_t>(v->y_pos)) << 32);
+		hasher.Add(v->z_pos | v->cur_speed << 8 | static_cast<uint64_t>(v->reliability) << 24 | static_cast<uint64_t>(v->breakdown_ctr) << 40);
+		hasher.Add(v->cargo.TotalCount());
+		hasher.Add(static_cast<int64_t>(v->profit_this_year));
+	}
+	return hasher.Get();
+}
+
+/**
+ * Hash the stations and the cargo waiting at them.
+ * @return The hash.
+ */
+static uint64_t HashStations()
+{
+	StateHasher hasher;
+	for (const Station *st : Station::Iterate()) {
+		hasher.Add(st->index | static_cast<uint64_t>(st->owner) << 32 | static_cast<uint64_t>(st->facilities) << 40);
+		hasher.Add(st->xy.base());
+		for (const GoodsEntry &ge : st->goods) {
+			hasher.Add(ge.cargo.TotalCount() | static_cast<uint64_t>(ge.rating) << 32);
+		}
+	}
+	return hasher.Get();
+}
+
+/**
+ * Hash the towns.
+ * @return The hash.
+ */
+static uint64_t HashTowns()
+{
+	StateHasher hasher;
+	for (const Town *t : Town::Iterate()) {
+		hasher.Add(t->index | static_cast<uint64_t>(t->xy.base()) << 32);
+		hasher.Add(t->cache.population | static_cast<uint64_t>(t->GetGrowCounter()) << 32 | static_cast<uint64_t>(t->growth_rate) << 48);
+	}
+	return hasher.Get();
+}
+
+/**
+ * Hash the industries and the cargo they produce and accept.
+ * @return The hash.
+ */
+static uint64_t HashIndustries()
+{
+	StateHasher hasher;
+	for (const Industry *ind : Industry::Iterate()) {
+		hasher.Add(ind->index | static_cast<uint64_t>(ind->location.tile.base()) << 32);
+		for (const auto &p : ind->produced) hasher.Add(p.cargo | p.waiting << 8 | p.rate << 24);
+		for (const auto &a : ind->accepted) hasher.Add(a.cargo | a.waiting << 8);
+	}
+	return hasher.Get();
+}
+
+/**
+ * Hash the finances of the companies.
+ * @return The hash.
+ */
+static uint64_t HashCompanies()
+{
+	StateHasher hasher;
+	for (const Company *c : Company::Iterate()) {
+		hasher.Add(c->index);
+		hasher.Add(static_cast<int64_t>(c->money));
+		hasher.Add(static_cast<int64_t>(c->current_loan));
+	}
+	return hasher.Get();
+}
+
+/**
+ * Calculate the hashes of all parts of the game state.
+ * The bands of the map are hashed on the game loop threads.
+ * @return The hashes.
+ */
+StateHashes CalculateStateHashes()
+{
+	StateHashes hashes;
+
+	std::array<uint, STATE_HASH_MAP_BANDS> bands;
+	std::iota(bands.begin(), bands.end(), 0);
+	RunInChunks(std::span<const uint>(bands), 1, [&hashes](std::span<const uint> chunk) {
+		for (uint band : chunk) hashes[SHS_MAP_FIRST + band] = HashMapBand(band);
+	});
+
+	hashes[SHS_VEHICLES] = HashVehicles();
+	hashes[SHS_STATIONS] = HashStations();
+	hashes[SHS_TOWNS] = HashTowns();
+	hashes[SHS_INDUSTRIES] = HashIndustries();
+	hashes[SHS_COMPANIES] = HashCompanies();
+	return hashes;
+}
+
+/**
+ * Get a description of a part of the game state, for the desync log.
+ * @param section The part.
+ * @return The description.
+ */
+std::string GetStateHashSectionName(StateHashSection section)
+{
+	if (section <= SHS_MAP_LAST) {
+		uint rows = Map::SizeY() / STATE_HASH_MAP_BANDS;
+		uint band = section - SHS_MAP_FIRST;
+		return fmt::format("map rows {} to {}", band * rows, (band + 1) * rows - 1);
+	}
+
+	switch (section) {
+		case SHS_VEHICLES: return "vehicles";
+		case SHS_STATIONS: return "stations";
+		case SHS_TOWNS: return "towns";
+		case SHS_INDUSTRIES: return "industries";
+		case SHS_COMPANIES: return "companies";
+		default: NOT_REACHED();
+	}
+}
@@ -0,0 +1,34 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file state_hash.h Hashes of parts of the game state, to find where a client desynced. */
+
+#ifndef STATE_HASH_H
+#define STATE_HASH_H
+
+/** Number of bands of rows the map is split into for hashing. */
+static const uint STATE_HASH_MAP_BANDS = 16;
+
+/** Parts of the game state that are hashed separately, so a desync can be narrowed down to one of them. */
+enum StateHashSection : uint8_t {
+	SHS_MAP_FIRST,                                          ///< First band of map rows.
+	SHS_MAP_LAST = SHS_MAP_FIRST + STATE_HASH_MAP_BANDS - 1, ///< Last band of map rows.
+	SHS_VEHICLES,                                           ///< The vehicles.
+	SHS_STATIONS,                                           ///< The stations and their cargo.
+	SHS_TOWNS,                                              ///< The towns.
+	SHS_INDUSTRIES,                                         ///< The industries and their cargo.
+	SHS_COMPANIES,                                          ///< The finances of the companies.
+	SHS_END,                                                ///< End marker.
+};
+
+/** The hashes of all parts of the game state. */
+using StateHashes = std::array<uint64_t, SHS_END>;
+
+StateHashes CalculateStateHashes();
+std::string GetStateHashSectionName(StateHashSection section);
+
+#endif /* STATE_HASH_H */
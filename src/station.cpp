@@ -47,6 +47,100 @@ void RebuildStationKdtree()
 	_station_kdtree.Build(stids.begin(), stids.end());
 }
 
+/** Log2 of the width and height of the blocks of tiles of the catchment index. */
+static const uint CATCHMENT_INDEX_BLOCK_BITS = 4;
+
+/**
+ * NOSAVE: For each block of tiles, the sorted IDs of the stations whose
+ * catchment area overlaps it. Station::TileIsInCatchment() tells which tiles
+ * of the block are actually covered.
+ */
+static std::vector<std::vector<StationID>> _station_catchment_index;
+
+/** Number of blocks of the catchment index in the x direction. */
+static uint _station_catchment_index_width;
+
+/** NOSAVE: Changed whenever the catchment area of any station changes, so lookups of stations around tiles can be reused until then. */
+uint32_t _station_catchment_generation = 0;
+
+/** Clear the catchment index and size it to the current map. */
+void ResetStationCatchmentIndex()
+{
+	_station_catchment_index_width = CeilDiv(Map::SizeX(), 1U << CATCHMENT_INDEX_BLOCK_BITS);
+	_station_catchment_index.clear();
+	_station_catchment_index.resize(static_cast<size_t>(_station_catchment_index_width) * CeilDiv(Map::SizeY(), 1U << CATCHMENT_INDEX_BLOCK_BITS));
+}
+
+/**
+ * Call a function for the blocks of the catchment index that overlap an area.
+ * @param ta The area.
+ * @param func Function to call with the list of stations of each block.
+ */
+template <typename Func>
+static void ForAllCatchmentIndexBlocks(const TileArea &ta, Func func)
+{
+	if (ta.tile == INVALID_TILE || ta.w == 0 || ta.h == 0) return;
+
+	/* The map was reallocated since, e.g. while loading a game. Everything gets
+	 * added again by Station::RecomputeCatchmentForAll() anyway. */
+	uint width = CeilDiv(Map::SizeX(), 1U << CATCHMENT_INDEX_BLOCK_BITS);
+	if (_station_catchment_index_width != width || _station_catchment_index.size() != static_cast<size_t>(width) * CeilDiv(Map::SizeY(), 1U << CATCHMENT_INDEX_BLOCK_BITS)) {
+		ResetStationCatchmentIndex();
+	}
+
+	uint x1 = TileX(ta.tile) >> CATCHMENT_INDEX_BLOCK_BITS;
+	uint y1 = TileY(ta.tile) >> CATCHMENT_INDEX_BLOCK_BITS;
+	uint x2 = (TileX(ta.tile) + ta.w - 1) >> CATCHMENT_INDEX_BLOCK_BITS;
+	uint y2 = (TileY(ta.tile) + ta.h - 1) >> CATCHMENT_INDEX_BLOCK_BITS;
+	for (uint y = y1; y <= y2; y++) {
+		for (uint x = x1; x <= x2; x++) {
+			func(_station_catchment_index[static_cast<size_t>(y) * _station_catchment_index_width + x]);
+		}
+	}
+}
+
+/**
+ * Add a station to the catchment index for its current catchment area.
+ * @param st The station.
+ */
+static void AddToCatchmentIndex(const Station *st)
+{
+	_station_catchment_generation++;
+	ForAllCatchmentIndexBlocks(st->catchment_tiles, [st](std::vector<StationID> &block) {
+		auto it = std::lower_bound(block.begin(), block.end(), st->index);
+		if (it == block.end() || *it != st->index) block.insert(it, st->index);
+	});
+}
+
+/**
+ * Remove a station from the catchment index for its current catchment area.
+ * @param st The station.
+ */
+static void RemoveFromCatchmentIndex(const Station *st)
+{
+	_station_catchment_generation++;
+	ForAllCatchmentIndexBlocks(st->catchment_tiles, [st](std::vector<StationID> &block) {
+		auto it = std::lower_bound(block.begin(), block.end(), st->index);
+		if (it != block.end() && *it == st->index) block.erase(it);
+	});
+}
+
+/**
+ * Get the stations whose catchment area may cover any tile of an area.
+ * The stations still have to be checked with Station::TileIsInCatchment().
+ * @param ta The area.
+ * @param[out] stations The IDs of the stations, sorted and without duplicates.
+ */
+void GetStationsWithCatchmentIn(const TileArea &ta, std::vector<StationID> &stations)
+{
+	stations.clear();
+	ForAllCatchmentIndexBlocks(ta, [&stations](const std::vector<StationID> &block) {
+		stations.insert(stations.end(), block.begin(), block.end());
+	});
+	std::sort(stations.begin(), stations.end());
+	stations.erase(std::unique(stations.begin(), stations.end()), stations.end());
+}
+
 
 BaseStation::~BaseStation()
 {
@@ -129,6 +223,7 @@ Station::~Station()
 
 	/* Remove station from industries and towns that reference it. */
 	this->RemoveFromAllNearbyLists();
+	RemoveFromCatchmentIndex(this);
 
 	/* Clear the persistent storage. */
 	delete this->airport.psa;
@@ -469,6 +564,8 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
 {
 	this->industries_near.clear();
 	if (!no_clear_nearby_lists) this->RemoveFromAllNearbyLists();
+	RemoveFromCatchmentIndex(this);
+	this->acceptance_cache_valid = false;
 
 	if (this->rect.IsEmpty()) {
 		this->catchment_tiles.Reset();
@@ -490,6 +587,7 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
 		this->industry->stations_near.clear();
 		this->industry->stations_near.insert(this);
 		this->industries_near.insert(IndustryListEntry{0, this->industry});
+		AddToCatchmentIndex(this);
 		return;
 	}
 
@@ -507,6 +605,7 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
 		TileArea ta2 = TileArea(tile, 1, 1).Expand(r);
 		for (TileIndex tile2 : ta2) this->catchment_tiles.SetTile(tile2);
 	}
+	AddToCatchmentIndex(this);
 
 	/* Search catchment tiles for towns and industries */
 	BitmapTileIterator it(this->catchment_tiles);
@@ -535,6 +634,7 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
  */
 /* static */ void Station::RecomputeCatchmentForAll()
 {
+	ResetStationCatchmentIndex();
 	for (Town *t : Town::Iterate()) { t->stations_near.clear(); }
 	for (Industry *i : Industry::Iterate()) { i->stations_near.clear(); }
 	for (Station *st : Station::Iterate()) { st->RecomputeCatchment(true); }
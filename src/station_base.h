@@ -11,6 +11,7 @@
 #define STATION_BASE_H
 
 #include "core/random_func.hpp"
+#include "core/flatmap_type.hpp"
 #include "base_station_base.h"
 #include "newgrf_airport.h"
 #include "cargopacket.h"
@@ -24,21 +25,21 @@ static const uint8_t MAX_STATION_RATING = 255;
 
 /**
  * Flow statistics telling how much flow should be sent along a link. This is
- * done by creating "flow shares" and using std::map's upper_bound() method to
+ * done by creating "flow shares" and using the upper_bound() method of a map to
  * look them up with a random number. A flow share is the difference between a
  * key in a map and the previous key. So one key in the map doesn't actually
  * mean anything by itself.
  */
 class FlowStat {
 public:
-	typedef std::map<uint32_t, StationID> SharesMap;
+	typedef FlatMap<uint32_t, StationID> SharesMap;
 
 	static const SharesMap empty_sharesmap;
 
 	/**
 	 * Invalid constructor. This can't be called as a FlowStat must not be
 	 * empty. However, the constructor must be defined and reachable for
-	 * FlowStat to be used in a std::map.
+	 * FlowStat to be used in a map.
 	 */
 	inline FlowStat() {NOT_REACHED();}
 
@@ -145,7 +146,7 @@ private:
 };
 
 /** Flow descriptions by origin stations. */
-class FlowStatMap : public std::map<StationID, FlowStat> {
+class FlowStatMap : public FlatMap<StationID, FlowStat> {
 public:
 	uint GetFlow() const;
 	uint GetFlowVia(StationID via) const;
@@ -461,6 +462,11 @@ public:
 
 	BitmapTileArea catchment_tiles; ///< NOSAVE: Set of individual tiles covered by catchment area
 
+	CargoArray static_acceptance{};                 ///< NOSAVE: Summed acceptance of the catchment tiles whose acceptance only changes with the tile itself.
+	CargoTypes static_always_accepted = 0;          ///< NOSAVE: Cargo always accepted by those tiles.
+	std::vector<TileIndex> dynamic_acceptance_tiles; ///< NOSAVE: Catchment tiles whose acceptance has to be queried every time.
+	bool acceptance_cache_valid = false;            ///< NOSAVE: Whether the above acceptance cache is up to date.
+
 	StationHadVehicleOfType had_vehicle_of_type;
 
 	uint8_t time_since_load;
@@ -555,6 +561,10 @@ public:
 };
 
 void RebuildStationKdtree();
+void ResetStationCatchmentIndex();
+void GetStationsWithCatchmentIn(const TileArea &ta, std::vector<StationID> &stations);
+
+extern uint32_t _station_catchment_generation;
 
 /**
  * Call a function on all stations that have any part of the requested area within their catchment.
@@ -569,16 +579,9 @@ void ForAllStationsAroundTiles(const TileArea &ta, Func func)
 	/* There are no stations, so we will never find anything. */
 	if (Station::GetNumItems() == 0) return;
 
-	/* Not using, or don't have a nearby stations list, so we need to scan. */
-	std::set<StationID> seen_stations;
-
-	/* Scan an area around the building covering the maximum possible station
-	 * to find the possible nearby stations. */
-	uint max_c = _settings_game.station.modified_catchment ? MAX_CATCHMENT : CA_UNMODIFIED;
-	TileArea ta_ext = TileArea(ta).Expand(max_c);
-	for (TileIndex tile : ta_ext) {
-		if (IsTileType(tile, MP_STATION)) seen_stations.insert(GetStationIndex(tile));
-	}
+	/* Look up the stations whose catchment area may cover the area. */
+	std::vector<StationID> seen_stations;
+	GetStationsWithCatchmentIn(ta, seen_stations);
 
 	for (StationID stationid : seen_stations) {
 		Station *st = Station::GetIfValid(stationid);
@@ -38,6 +38,7 @@
 #include "station_base.h"
 #include "station_func.h"
 #include "station_kdtree.h"
+#include "town_kdtree.h"
 #include "roadstop_base.h"
 #include "newgrf_railtype.h"
 #include "newgrf_roadtype.h"
@@ -52,6 +53,7 @@
 #include "newgrf_airporttiles.h"
 #include "order_backup.h"
 #include "newgrf_house.h"
+#include "object_map.h"
 #include "company_gui.h"
 #include "linkgraph/linkgraph_base.h"
 #include "linkgraph/refresh.h"
@@ -66,6 +68,7 @@
 #include "timer/timer_game_economy.h"
 #include "timer/timer_game_tick.h"
 #include "cheat_type.h"
+#include "framerate_type.h"
 
 #include "widgets/station_widget.h"
 
@@ -489,6 +492,7 @@ void ClearAllStationCachedNames()
 	for (BaseStation *st : BaseStation::Iterate()) {
 		st->cached_name.clear();
 	}
+	ClearFormattedStringCache();
 }
 
 /**
@@ -597,24 +601,99 @@ CargoArray GetAcceptanceAroundTiles(TileIndex center_tile, int w, int h, int rad
 	return acceptance;
 }
 
+/** How the acceptance of a tile can change. */
+enum class TileAcceptanceKind : uint8_t {
+	None,    ///< The tile never accepts anything.
+	Static,  ///< The acceptance only changes when the tile is rebuilt.
+	Dynamic, ///< The acceptance may change at any time, e.g. through callbacks.
+};
+
+/**
+ * Determine how the acceptance of a tile can change.
+ * @param tile Tile to check.
+ * @return The kind of acceptance of the tile.
+ */
+static TileAcceptanceKind GetTileAcceptanceKind(TileIndex tile)
+{
+	switch (GetTileType(tile)) {
+		case MP_HOUSE: {
+			const HouseSpec *hs = HouseSpec::Get(GetHouseType(tile));
+			if (HasBit(hs->callback_mask, CBM_HOUSE_ACCEPT_CARGO) || HasBit(hs->callback_mask, CBM_HOUSE_CARGO_ACCEPTANCE)) return TileAcceptanceKind::Dynamic;
+			return TileAcceptanceKind::Static;
+		}
+
+		case MP_OBJECT:
+			/* Only the HQ accepts cargo, depending on its size. */
+			return IsObjectType(tile, OBJECT_HQ) ? TileAcceptanceKind::Dynamic : TileAcceptanceKind::None;
+
+		default:
+			return _tile_type_procs[GetTileType(tile)]->add_accepted_cargo_proc == nullptr ? TileAcceptanceKind::None : TileAcceptanceKind::Dynamic;
+	}
+}
+
 /**
  * Get the acceptance of cargoes around the station in.
+ * The acceptance of tiles that only changes when they are rebuilt is summed
+ * once and kept until a tile in the catchment is rebuilt, so only the other
+ * tiles have to be queried every time.
  * @param st Station to get acceptance of.
  * @param always_accepted bitmask of cargo accepted by houses and headquarters; can be nullptr
  */
-static CargoArray GetAcceptanceAroundStation(const Station *st, CargoTypes *always_accepted)
-{
-	CargoArray acceptance{};
-	if (always_accepted != nullptr) *always_accepted = 0;
+static CargoArray GetAcceptanceAroundStation(Station *st, CargoTypes *always_accepted)
+{
+	if (!st->acceptance_cache_valid) {
+		st->static_acceptance = {};
+		st->static_always_accepted = 0;
+		st->dynamic_acceptance_tiles.clear();
+
+		BitmapTileIterator it(st->catchment_tiles);
+		for (TileIndex tile = it; tile != INVALID_TILE; tile = ++it) {
+			switch (GetTileAcceptanceKind(tile)) {
+				case TileAcceptanceKind::None: break;
+				case TileAcceptanceKind::Static: AddAcceptedCargo(tile, st->static_acceptance, &st->static_always_accepted); break;
+				case TileAcceptanceKind::Dynamic: st->dynamic_acceptance_tiles.push_back(tile); break;
+			}
+		}
+		st->acceptance_cache_valid = true;
+	}
 
-	BitmapTileIterator it(st->catchment_tiles);
-	for (TileIndex tile = it; tile != INVALID_TILE; tile = ++it) {
-		AddAcceptedCargo(tile, acceptance, always_accepted);
+	CargoArray acceptance = st->static_acceptance;
+	CargoTypes accepted = st->static_always_accepted;
+	for (TileIndex tile : st->dynamic_acceptance_tiles) {
+		AddAcceptedCargo(tile, acceptance, &accepted);
 	}
 
+	if (always_accepted != nullptr) *always_accepted = accepted;
 	return acceptance;
 }
 
+/**
+ * Invalidate the acceptance cache of the stations whose catchment covers any
+ * of the given tiles. Must be called whenever tiles that (may) accept cargo
+ * are built or removed.
+ * @param ta The tiles that changed.
+ */
+void InvalidateStationAcceptanceCache(const TileArea &ta)
+{
+	std::vector<StationID> stations;
+	GetStationsWithCatchmentIn(ta, stations);
+	for (StationID id : stations) {
+		Station *st = Station::Get(id);
+		for (TileIndex tile : ta) {
+			if (st->TileIsInCatchment(tile)) {
+				st->acceptance_cache_valid = false;
+				break;
+			}
+		}
+	}
+}
+
+/** Invalidate the acceptance cache of all stations, e.g. when the house specs changed. */
+void InvalidateAllStationAcceptanceCaches()
+{
+	for (Station *st : Station::Iterate()) st->acceptance_cache_valid = false;
+}
+
 /**
  * Update the acceptance for a station.
  * @param st Station to update
@@ -2334,19 +2413,24 @@ Town *AirportGetNearestTown(const AirportSpec *as, Direction rotation, TileIndex
 
 	mindist = UINT_MAX - 1; // prevent overflow
 
+	std::vector<std::pair<uint16_t, uint16_t>> perimeter;
 	for (TileIndex cur_tile = *it; cur_tile != INVALID_TILE; cur_tile = ++it) {
 		assert(IsInsideBS(TileX(cur_tile), perimeter_min_x, width));
 		assert(IsInsideBS(TileY(cur_tile), perimeter_min_y, height));
 		if (TileX(cur_tile) == perimeter_min_x || TileX(cur_tile) == perimeter_max_x || TileY(cur_tile) == perimeter_min_y || TileY(cur_tile) == perimeter_max_y) {
-			Town *t = CalcClosestTownFromTile(cur_tile, mindist + 1);
-			if (t == nullptr) continue;
-
-			uint dist = DistanceManhattan(t->xy, cur_tile);
-			if (dist == mindist && t->index < nearest->index) nearest = t;
-			if (dist < mindist) {
-				nearest = t;
-				mindist = dist;
-			}
+			perimeter.emplace_back(TileX(cur_tile), TileY(cur_tile));
+		}
+	}
+
+	/* Neighbouring perimeter tiles mostly share their nearest town, so search for all of them in one go. */
+	std::vector<TownID> towns = _town_kdtree.FindNearest(perimeter);
+	for (size_t i = 0; i < perimeter.size(); i++) {
+		Town *t = Town::Get(towns[i]);
+		uint dist = DistanceManhattan(t->xy, TileXY(perimeter[i].first, perimeter[i].second));
+		if (dist == mindist && t->index < nearest->index) nearest = t;
+		if (dist < mindist) {
+			nearest = t;
+			mindist = dist;
 		}
 	}
 
@@ -3506,7 +3590,7 @@ static bool ClickTile_Station(TileIndex tile)
 	return true;
 }
 
-static VehicleEnterTileStatus VehicleEnter_Station(Vehicle *v, TileIndex tile, int x, int y)
+VehicleEnterTileStatus VehicleEnter_Station(Vehicle *v, TileIndex tile, int x, int y)
 {
 	if (v->type == VEH_TRAIN) {
 		StationID station_id = GetStationIndex(tile);
@@ -4002,6 +4086,8 @@ void OnTick_Station()
 {
 	if (_game_mode == GM_EDITOR) return;
 
+	PerformanceAccumulator framerate(PFE_GL_STATIONS);
+
 	for (BaseStation *st : BaseStation::Iterate()) {
 		StationHandleSmallTick(st);
 
@@ -4143,13 +4229,6 @@ CommandCost CmdRenameStation(DoCommandFlag flags, StationID station_id, const st
 	return CommandCost();
 }
 
-static void AddNearbyStationsByCatchment(TileIndex tile, StationList *stations, StationList &nearby)
-{
-	for (Station *st : nearby) {
-		if (st->TileIsInCatchment(tile)) stations->insert(st);
-	}
-}
-
 /**
  * Run a tile loop to find stations around a tile, on demand. Cache the result for further requests
  * @return pointer to a StationList containing all stations found
@@ -4157,16 +4236,10 @@ static void AddNearbyStationsByCatchment(TileIndex tile, StationList *stations,
 const StationList *StationFinder::GetStations()
 {
 	if (this->tile != INVALID_TILE) {
-		if (IsTileType(this->tile, MP_HOUSE)) {
-			/* Town nearby stations need to be filtered per tile. */
-			assert(this->w == 1 && this->h == 1);
-			AddNearbyStationsByCatchment(this->tile, &this->stations, Town::GetByTile(this->tile)->stations_near);
-		} else {
-			ForAllStationsAroundTiles(*this, [this](Station *st, TileIndex) {
-				this->stations.insert(st);
-				return true;
-			});
-		}
+		ForAllStationsAroundTiles(*this, [this](Station *st, TileIndex) {
+			this->stations.insert(st);
+			return true;
+		});
 		this->tile = INVALID_TILE;
 	}
 	return &this->stations;
@@ -4854,7 +4927,7 @@ StationIDStack FlowStatMap::DeleteFlows(StationID via)
 		s_flows.ChangeShare(via, INT_MIN);
 		if (s_flows.GetShares()->empty()) {
 			ret.Push(f_it->first);
-			this->erase(f_it++);
+			f_it = this->erase(f_it);
 		} else {
 			++f_it;
 		}
@@ -30,6 +30,8 @@ CargoArray GetProductionAroundTiles(TileIndex tile, int w, int h, int rad);
 CargoArray GetAcceptanceAroundTiles(TileIndex tile, int w, int h, int rad, CargoTypes *always_accepted = nullptr);
 
 void UpdateStationAcceptance(Station *st, bool show_msg);
+void InvalidateStationAcceptanceCache(const TileArea &ta);
+void InvalidateAllStationAcceptanceCaches();
 CargoTypes GetAcceptanceMask(const Station *st);
 CargoTypes GetEmptyMask(const Station *st);
 
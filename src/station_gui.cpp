@@ -264,6 +264,9 @@ protected:
 
 		Debug(misc, 3, "Building station list for company {}", owner);
 
+		/* Remember the sorted order, so only new and changed stations need sorting again. */
+		std::vector<const Station *> previous_order(this->stations.begin(), this->stations.end());
+
 		this->stations.clear();
 		this->stations_per_cargo_type.fill(0);
 		this->stations_per_cargo_type_no_rating = 0;
@@ -295,6 +298,7 @@ protected:
 		}
 
 		this->stations.shrink_to_fit();
+		this->stations.RestoreOrder(previous_order, [](const Station *st) { return st; });
 		this->stations.RebuildDone();
 
 		this->vscroll->SetCount(this->stations.size()); // Update the scrollbar
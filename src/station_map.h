@@ -81,6 +81,7 @@ inline void SetStationGfx(Tile t, StationGfx gfx)
 {
 	assert(IsTileType(t, MP_STATION));
 	t.m5() = gfx;
+	InvalidateSignalBlocks();
 }
 
 /**
@@ -351,6 +352,7 @@ inline void SetStationTileBlocked(Tile t, bool b)
 {
 	assert(HasStationRail(t));
 	SB(t.m6(), 0, 1, b ? 1 : 0);
+	InvalidateSignalBlocks();
 }
 
 /**
@@ -479,6 +481,7 @@ inline void SetRailStationReservation(Tile t, bool b)
 {
 	assert(HasStationRail(t));
 	SB(t.m6(), 2, 1, b ? 1 : 0);
+	_track_reservation_generation++;
 }
 
 /**
@@ -105,6 +105,12 @@ public:
 	 * @param area the area to search from
 	 */
 	StationFinder(const TileArea &area) : TileArea(area) {}
+
+	/**
+	 * Constructs StationFinder for stations that have been found already.
+	 * @param stations the stations nearby
+	 */
+	StationFinder(StationList &&stations) : stations(std::move(stations)) {}
 	const StationList *GetStations();
 };
 
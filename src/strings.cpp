@@ -40,6 +40,14 @@
 #include "gfx_layout.h"
 #include <stack>
 #include <charconv>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+
+#if defined(UNIX)
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#endif
 
 #include "table/strings.h"
 #include "table/control_codes.h"
@@ -60,6 +68,12 @@ std::unique_ptr<icu::Collator> _current_collator;    ///< Collator for the langu
 #endif /* WITH_ICU_I18N */
 
 ArrayStringParameters<20> _global_string_params;
+static size_t _global_string_params_used = 0; ///< Number of global string parameters, from the first, that were used by the current #GetString.
+
+/** Maximum number of formatted strings to cache; when it is reached the cache starts over. */
+static const size_t MAX_FORMATTED_STRINGS = 4096;
+static std::unordered_map<std::string, std::string> _formatted_strings; ///< Strings formatted by #GetString, by their key.
+static std::unordered_map<StringID, size_t> _formatted_string_num_params; ///< Number of parameters that are part of the key of a formatted string.
 
 /**
  * Prepare the string parameters for the next formatting run. This means
@@ -92,6 +106,12 @@ StringParameter *StringParameters::GetNextParameterPointer()
 	}
 	param.type = this->next_type;
 	this->next_type = 0;
+
+	/* Track the used global parameters, as they are part of the key of the formatted string. */
+	const std::span<StringParameter> global = static_cast<StringParameters &>(_global_string_params).parameters;
+	if (!std::less<const StringParameter *>()(&param, global.data()) && std::less<const StringParameter *>()(&param, global.data() + global.size())) {
+		_global_string_params_used = std::max<size_t>(_global_string_params_used, &param - global.data() + 1);
+	}
 	return &param;
 }
 
@@ -218,24 +238,72 @@ struct LanguagePack : public LanguagePackHeader {
 };
 
 struct LanguagePackDeleter {
+	size_t mapped_size = 0; ///< Size of the mapping when the language pack is mapped into memory, 0 when it is read into memory.
+
 	void operator()(LanguagePack *langpack)
 	{
+#if defined(UNIX)
+		if (this->mapped_size != 0) {
+			munmap(langpack, this->mapped_size);
+			return;
+		}
+#endif
 		/* LanguagePack is in fact reinterpreted char[], we need to reinterpret it back to free it properly. */
 		delete[] reinterpret_cast<char*>(langpack);
 	}
 };
 
+/**
+ * The strings of the current language.
+ * The strings of a tab are only found and zero terminated when a string of that tab is used for the first
+ * time, so the pages of the mapped language file holding tabs that are never used stay clean and shared.
+ */
 struct LoadedLanguagePack {
 	std::unique_ptr<LanguagePack, LanguagePackDeleter> langpack;
 
-	std::vector<char *> offsets;
+	std::array<std::vector<char *>, TEXT_TAB_END> offsets; ///< Begin of the strings per tab, empty until the tab is used.
+	std::array<std::atomic<bool>, TEXT_TAB_END> decoded;   ///< Whether the offsets of a tab have been determined.
+	std::array<char *, TEXT_TAB_END> tab_data;             ///< Position of the length of the first string of a tab in the language pack.
+	std::array<uint8_t, TEXT_TAB_END> tab_first_length;    ///< First byte of the length of the first string of a tab, it is overwritten by the terminator of the previous tab.
+	std::array<uint, TEXT_TAB_END> langtab_num;            ///< Number of strings per tab.
+	std::mutex decode_mutex;                               ///< Lock for decoding tabs, strings are also formatted by drawing threads.
 
-	std::array<uint, TEXT_TAB_END> langtab_num;   ///< Offset into langpack offs
-	std::array<uint, TEXT_TAB_END> langtab_start; ///< Offset into langpack offs
+	const std::vector<char *> &GetTab(uint tab);
+	const char *GetString(uint tab, uint index) { return this->GetTab(tab)[index]; }
 };
 
 static LoadedLanguagePack _langpack;
 
+/**
+ * Get the begin of all strings of a tab of the language pack, finding and zero terminating them on first use.
+ * @param tab The tab to get the strings of.
+ * @return The strings of the tab.
+ */
+const std::vector<char *> &LoadedLanguagePack::GetTab(uint tab)
+{
+	if (this->decoded[tab].load(std::memory_order_acquire)) return this->offsets[tab];
+
+	std::lock_guard<std::mutex> lock(this->decode_mutex);
+	if (this->decoded[tab].load(std::memory_order_relaxed)) return this->offsets[tab];
+
+	/* The lengths have been validated when loading the language pack. */
+	std::vector<char *> &offs = this->offsets[tab];
+	offs.resize(this->langtab_num[tab]);
+	char *s = this->tab_data[tab] + 1;
+	size_t len = this->tab_first_length[tab];
+	for (char *&str : offs) {
+		if (len >= 0xC0) len = ((len & 0x3F) << 8) + (uint8_t)*s++;
+		str = s;
+		s += len;
+		len = (uint8_t)*s;
+		*s++ = '\0'; // zero terminate the string
+	}
+
+	this->decoded[tab].store(true, std::memory_order_release);
+	return offs;
+}
+
+
 static bool _scan_for_gender_data = false;  ///< Are we scanning for the gender of the current string? (instead of formatting it)
 
 
@@ -246,7 +314,7 @@ const char *GetStringPtr(StringID string)
 		/* 0xD0xx and 0xD4xx IDs have been converted earlier. */
 		case TEXT_TAB_OLD_NEWGRF: NOT_REACHED();
 		case TEXT_TAB_NEWGRF_START: return GetGRFStringPtr(GetStringIndex(string));
-		default: return _langpack.offsets[_langpack.langtab_start[GetStringTab(string)] + GetStringIndex(string)];
+		default: return _langpack.GetString(GetStringTab(string), GetStringIndex(string));
 	}
 }
 
@@ -318,6 +386,52 @@ void GetStringWithArgs(StringBuilder &builder, StringID string, StringParameters
 }
 
 
+/**
+ * Check whether a string can be formatted from the cache.
+ * Strings of game scripts and NewGRFs can change without their parameters changing, and so can strings using the NewGRF text stack.
+ * @param string The string to format.
+ * @return True iff the formatted string can be cached.
+ */
+static bool IsFormattedStringCacheable(StringID string)
+{
+	if (UsingNewGRFTextStack()) return false;
+
+	switch (GetStringTab(string)) {
+		case TEXT_TAB_OLD_CUSTOM:
+		case TEXT_TAB_OLD_NEWGRF:
+		case TEXT_TAB_NEWGRF_START:
+		case TEXT_TAB_GAMESCRIPT_START:
+			return false;
+
+		default:
+			return true;
+	}
+}
+
+/**
+ * Get the key of a formatted string in the cache, from the string and the global string parameters.
+ * @param string The formatted string.
+ * @param num_params The number of parameters the string uses.
+ * @return The key.
+ */
+static std::string GetFormattedStringKey(StringID string, size_t num_params)
+{
+	std::string key(reinterpret_cast<const char *>(&string), sizeof(string));
+	for (size_t i = 0; i < num_params; i++) {
+		const char *str = _global_string_params.GetParamStr(i);
+		if (str != nullptr) {
+			key.push_back('\1');
+			key.append(str);
+			key.push_back('\0');
+		} else {
+			uint64_t data = _global_string_params.GetParam(i);
+			key.push_back('\0');
+			key.append(reinterpret_cast<const char *>(&data), sizeof(data));
+		}
+	}
+	return key;
+}
+
 /**
  * Resolve the given StringID into a std::string with all the associated
  * DParam lookups and formatting.
@@ -327,7 +441,34 @@ void GetStringWithArgs(StringBuilder &builder, StringID string, StringParameters
 std::string GetString(StringID string)
 {
 	_global_string_params.PrepareForNextRun();
-	return GetStringWithArgs(string, _global_string_params);
+	if (!IsFormattedStringCacheable(string)) return GetStringWithArgs(string, _global_string_params);
+
+	std::string key = GetFormattedStringKey(string, _formatted_string_num_params[string]);
+	auto it = _formatted_strings.find(key);
+	if (it != _formatted_strings.end()) return it->second;
+
+	_global_string_params_used = 0;
+	std::string result = GetStringWithArgs(string, _global_string_params);
+
+	/* Other parameters than before might have been used, e.g. due to a different sub string. Make the key with all of them. */
+	size_t &num_params = _formatted_string_num_params[string];
+	if (_global_string_params_used > num_params) {
+		num_params = _global_string_params_used;
+		key = GetFormattedStringKey(string, num_params);
+	}
+
+	if (_formatted_strings.size() >= MAX_FORMATTED_STRINGS) _formatted_strings.clear();
+	_formatted_strings.emplace(std::move(key), result);
+	return result;
+}
+
+/**
+ * Forget all strings formatted by #GetString, as the names or settings they were formatted with might have changed.
+ */
+void ClearFormattedStringCache()
+{
+	_formatted_strings.clear();
+	_formatted_string_num_params.clear();
 }
 
 /**
@@ -1902,6 +2043,41 @@ bool LanguagePackHeader::IsReasonablyFinished() const
 	return 4 * this->missing < LANGUAGE_TOTAL_STRINGS;
 }
 
+/**
+ * Load a language file into memory, terminated by a zero after its data.
+ * Where possible the file is mapped privately, so only the pages with strings that are used get copied.
+ * @param filename Name of the language file.
+ * @param[out] len Length of the loaded data, without the terminating zero.
+ * @return The language pack, or \c nullptr if loading failed.
+ */
+static std::unique_ptr<LanguagePack, LanguagePackDeleter> LoadLanguagePackFile(const std::string &filename, size_t &len)
+{
+	static const size_t MAX_LANGUAGE_PACK_SIZE = 1U << 20;
+
+#if defined(UNIX)
+	FILE *f = fopen(filename.c_str(), "rb");
+	if (f == nullptr) return nullptr;
+
+	FileCloser fc(f);
+	struct stat st;
+	long page_size = sysconf(_SC_PAGESIZE);
+	if (fstat(fileno(f), &st) != 0 || !S_ISREG(st.st_mode) || static_cast<uintmax_t>(st.st_size) > MAX_LANGUAGE_PACK_SIZE) return nullptr;
+
+	/* The terminating zero is written just past the data, which only fits in the mapping when the last page is not full. */
+	if (st.st_size > 0 && page_size > 0 && st.st_size % page_size != 0) {
+		void *map = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(f), 0);
+		if (map != MAP_FAILED) {
+			len = st.st_size;
+			static_cast<char *>(map)[len] = '\0';
+			return std::unique_ptr<LanguagePack, LanguagePackDeleter>(static_cast<LanguagePack *>(map), LanguagePackDeleter{ static_cast<size_t>(st.st_size) });
+		}
+		Debug(misc, 1, "Mapping {} into memory failed, reading it instead", filename);
+	}
+#endif
+
+	return std::unique_ptr<LanguagePack, LanguagePackDeleter>(reinterpret_cast<LanguagePack *>(ReadFileToMem(filename, len, MAX_LANGUAGE_PACK_SIZE).release()));
+}
+
 /**
  * Read a particular language.
  * @param lang The metadata about the language.
@@ -1911,10 +2087,10 @@ bool ReadLanguagePack(const LanguageMetadata *lang)
 {
 	/* Current language pack */
 	size_t len = 0;
-	std::unique_ptr<LanguagePack, LanguagePackDeleter> lang_pack(reinterpret_cast<LanguagePack *>(ReadFileToMem(lang->file.string(), len, 1U << 20).release()));
+	std::unique_ptr<LanguagePack, LanguagePackDeleter> lang_pack = LoadLanguagePackFile(lang->file.string(), len);
 	if (!lang_pack) return false;
 
-	/* End of read data (+ terminating zero added in ReadFileToMem()) */
+	/* End of read data (+ terminating zero after the data) */
 	const char *end = (char *)lang_pack.get() + len + 1;
 
 	/* We need at least one byte of lang_pack->data */
@@ -1922,44 +2098,43 @@ bool ReadLanguagePack(const LanguageMetadata *lang)
 		return false;
 	}
 
-	std::array<uint, TEXT_TAB_END> tab_start, tab_num;
+	std::array<uint, TEXT_TAB_END> tab_num;
+	std::array<char *, TEXT_TAB_END> tab_data;
+	std::array<uint8_t, TEXT_TAB_END> tab_first_length;
 
-	uint count = 0;
+	/* Validate the lengths of all strings, but leave finding and terminating them until they are used. */
+	char *s = lang_pack->data;
 	for (uint i = 0; i < TEXT_TAB_END; i++) {
 		uint16_t num = FROM_LE16(lang_pack->offsets[i]);
 		if (num > TAB_SIZE) return false;
 
-		tab_start[i] = count;
 		tab_num[i] = num;
-		count += num;
-	}
-
-	/* Allocate offsets */
-	std::vector<char *> offs(count);
-
-	/* Fill offsets */
-	char *s = lang_pack->data;
-	len = (uint8_t)*s++;
-	for (uint i = 0; i < count; i++) {
-		if (s + len >= end) return false;
-
-		if (len >= 0xC0) {
-			len = ((len & 0x3F) << 8) + (uint8_t)*s++;
-			if (s + len >= end) return false;
+		tab_data[i] = s;
+		tab_first_length[i] = (uint8_t)*s;
+		for (uint j = 0; j < num; j++) {
+			size_t length = (uint8_t)*s++;
+			if (s + length >= end) return false;
+
+			if (length >= 0xC0) {
+				length = ((length & 0x3F) << 8) + (uint8_t)*s++;
+				if (s + length >= end) return false;
+			}
+			s += length;
 		}
-		offs[i] = s;
-		s += len;
-		len = (uint8_t)*s;
-		*s++ = '\0'; // zero terminate the string
 	}
 
 	_langpack.langpack = std::move(lang_pack);
-	_langpack.offsets = std::move(offs);
+	for (uint i = 0; i < TEXT_TAB_END; i++) {
+		_langpack.offsets[i].clear();
+		_langpack.decoded[i].store(false, std::memory_order_relaxed);
+	}
 	_langpack.langtab_num = tab_num;
-	_langpack.langtab_start = tab_start;
+	_langpack.tab_data = tab_data;
+	_langpack.tab_first_length = tab_first_length;
 
 	_current_language = lang;
 	_current_text_dir = (TextDirection)_current_language->text_dir;
+	ClearFormattedStringCache();
 	_config_language_file = _current_language->file.filename().string();
 	SetCurrentGrfLangID(_current_language->newgrflangid);
 
@@ -2223,15 +2398,14 @@ class LanguagePackGlyphSearcher : public MissingGlyphSearcher {
 
 	std::optional<std::string_view> NextString() override
 	{
-		if (this->i >= TEXT_TAB_END) return std::nullopt;
-
-		const char *ret = _langpack.offsets[_langpack.langtab_start[this->i] + this->j];
-
-		this->j++;
 		while (this->i < TEXT_TAB_END && this->j >= _langpack.langtab_num[this->i]) {
 			this->i++;
 			this->j = 0;
 		}
+		if (this->i >= TEXT_TAB_END) return std::nullopt;
+
+		const char *ret = _langpack.GetString(this->i, this->j);
+		this->j++;
 
 		return ret;
 	}
@@ -61,6 +61,7 @@ inline StringID MakeStringID(StringTab tab, uint index)
 
 std::string GetString(StringID string);
 const char *GetStringPtr(StringID string);
+void ClearFormattedStringCache();
 
 uint ConvertKmhishSpeedToDisplaySpeed(uint speed, VehicleType type);
 uint ConvertDisplaySpeedToKmhishSpeed(uint speed, VehicleType type);
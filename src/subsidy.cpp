@@ -28,6 +28,10 @@
 #include "subsidy_cmd.h"
 #include "timer/timer.h"
 #include "timer/timer_game_economy.h"
+#include "town_kdtree.h"
+
+#include <optional>
+#include <unordered_map>
 
 #include "table/strings.h"
 
@@ -187,20 +191,54 @@ static bool CheckSubsidyDuplicate(CargoID cargo, SourceType src_type, SourceID s
 	return false;
 }
 
+/** Sources and destinations that may get a subsidy, gathered while trying to create one subsidy. */
+struct SubsidyCandidates {
+	std::array<std::optional<std::vector<TownID>>, NUM_CARGO> passenger_sources; ///< Per passenger cargo, the towns that may send it.
+	std::optional<std::vector<TownID>> cargo_source_towns;                       ///< Towns large enough to send other cargo.
+	std::optional<std::vector<std::pair<IndustryID, CargoID>>> industry_sources; ///< Industries, and the cargo they may send.
+	std::array<std::optional<std::vector<IndustryID>>, NUM_CARGO> accepting_industries; ///< Per cargo, the industries accepting it.
+	std::unordered_map<TownID, CargoArray> town_acceptance;                     ///< Cargo accepted around the centre of towns.
+};
+
 /**
- * Checks if the source and destination of a subsidy are inside the distance limit.
- * @param src_type Type of \a src.
- * @param src      Index of source.
- * @param dst_type Type of \a dst.
- * @param dst      Index of destination.
- * @return True if they are inside the distance limit.
+ * Find the towns within the distance limit of subsidised routes.
+ * @param tile The source of the route.
+ * @return The towns, in order of their index.
  */
-static bool CheckSubsidyDistance(SourceType src_type, SourceID src, SourceType dst_type, SourceID dst)
+static std::vector<TownID> FindTownsInSubsidyRange(TileIndex tile)
 {
-	TileIndex tile_src = (src_type == SourceType::Town) ? Town::Get(src)->xy : Industry::Get(src)->location.tile;
-	TileIndex tile_dst = (dst_type == SourceType::Town) ? Town::Get(dst)->xy : Industry::Get(dst)->location.tile;
+	uint x1 = TileX(tile) > SUBSIDY_MAX_DISTANCE ? TileX(tile) - SUBSIDY_MAX_DISTANCE : 0;
+	uint y1 = TileY(tile) > SUBSIDY_MAX_DISTANCE ? TileY(tile) - SUBSIDY_MAX_DISTANCE : 0;
+	uint x2 = std::min(TileX(tile) + SUBSIDY_MAX_DISTANCE + 1, Map::SizeX());
+	uint y2 = std::min(TileY(tile) + SUBSIDY_MAX_DISTANCE + 1, Map::SizeY());
+
+	std::vector<TownID> towns;
+	_town_kdtree.FindContained(x1, y1, x2, y2, [&towns, tile](TownID tid) {
+		if (DistanceManhattan(tile, Town::Get(tid)->xy) <= SUBSIDY_MAX_DISTANCE) towns.push_back(tid);
+	});
+	/* The shape of the tree differs between clients, the order of the towns may not. */
+	std::sort(towns.begin(), towns.end());
+	return towns;
+}
 
-	return (DistanceManhattan(tile_src, tile_dst) <= SUBSIDY_MAX_DISTANCE);
+/**
+ * Get the cargo accepted by the houses around the centre of a town.
+ * @param candidates The candidates, where the acceptance is remembered.
+ * @param t The town.
+ * @return The acceptance of each cargo.
+ */
+static const CargoArray &GetSubsidyTownAcceptance(SubsidyCandidates &candidates, const Town *t)
+{
+	auto [it, inserted] = candidates.town_acceptance.try_emplace(t->index);
+	if (inserted) {
+		TileArea ta = TileArea(t->xy, 1, 1).Expand(SUBSIDY_TOWN_CARGO_RADIUS);
+		for (TileIndex tile : ta) {
+			if (IsTileType(tile, MP_HOUSE)) {
+				AddAcceptedCargo(tile, it->second, nullptr);
+			}
+		}
+	}
+	return it->second;
 }
 
 /**
@@ -280,9 +318,10 @@ CommandCost CmdCreateSubsidy(DoCommandFlag flags, CargoID cid, SourceType src_ty
 
 /**
  * Tries to create a passenger subsidy between two towns.
+ * @param candidates The sources and destinations found so far.
  * @return True iff the subsidy was created.
  */
-bool FindSubsidyPassengerRoute()
+static bool FindSubsidyPassengerRoute(SubsidyCandidates &candidates)
 {
 	if (!Subsidy::CanAllocateItem()) return false;
 
@@ -290,41 +329,66 @@ bool FindSubsidyPassengerRoute()
 	uint32_t r = RandomRange(static_cast<uint>(CargoSpec::town_production_cargoes[TPE_PASSENGERS].size()));
 	CargoID cid = CargoSpec::town_production_cargoes[TPE_PASSENGERS][r]->Index();
 
-	const Town *src = Town::GetRandom();
-	if (src->cache.population < SUBSIDY_PAX_MIN_POPULATION ||
-			src->GetPercentTransported(cid) > SUBSIDY_MAX_PCT_TRANSPORTED) {
-		return false;
+	std::optional<std::vector<TownID>> &sources = candidates.passenger_sources[cid];
+	if (!sources.has_value()) {
+		sources.emplace();
+		for (const Town *t : Town::Iterate()) {
+			if (t->cache.population >= SUBSIDY_PAX_MIN_POPULATION && t->GetPercentTransported(cid) <= SUBSIDY_MAX_PCT_TRANSPORTED) {
+				sources->push_back(t->index);
+			}
+		}
 	}
+	if (sources->empty()) return false;
 
-	const Town *dst = Town::GetRandom();
-	if (dst->cache.population < SUBSIDY_PAX_MIN_POPULATION || src == dst) {
-		return false;
+	/* Select a random town. */
+	uint32_t src_num = RandomRange(static_cast<uint32_t>(sources->size()));
+	const Town *src = Town::Get((*sources)[src_num]);
+
+	std::vector<TownID> destinations;
+	for (TownID tid : FindTownsInSubsidyRange(src->xy)) {
+		if (tid == src->index || Town::Get(tid)->cache.population < SUBSIDY_PAX_MIN_POPULATION) continue;
+		if (CheckSubsidyDuplicate(cid, SourceType::Town, src->index, SourceType::Town, tid)) continue;
+		destinations.push_back(tid);
 	}
 
-	if (DistanceManhattan(src->xy, dst->xy) > SUBSIDY_MAX_DISTANCE) return false;
-	if (CheckSubsidyDuplicate(cid, SourceType::Town, src->index, SourceType::Town, dst->index)) return false;
+	if (destinations.empty()) {
+		/* Nothing to go to, so do not try this town again. */
+		sources->erase(sources->begin() + src_num);
+		return false;
+	}
 
-	CreateSubsidy(cid, SourceType::Town, src->index, SourceType::Town, dst->index);
+	TownID dst = destinations[RandomRange(static_cast<uint32_t>(destinations.size()))];
+	CreateSubsidy(cid, SourceType::Town, src->index, SourceType::Town, dst);
 
 	return true;
 }
 
-bool FindSubsidyCargoDestination(CargoID cid, SourceType src_type, SourceID src);
+static bool FindSubsidyCargoDestination(SubsidyCandidates &candidates, CargoID cid, SourceType src_type, SourceID src);
 
 
 /**
  * Tries to create a cargo subsidy with a town as source.
+ * @param candidates The sources and destinations found so far.
  * @return True iff the subsidy was created.
  */
-bool FindSubsidyTownCargoRoute()
+static bool FindSubsidyTownCargoRoute(SubsidyCandidates &candidates)
 {
 	if (!Subsidy::CanAllocateItem()) return false;
 
 	SourceType src_type = SourceType::Town;
 
+	std::optional<std::vector<TownID>> &sources = candidates.cargo_source_towns;
+	if (!sources.has_value()) {
+		sources.emplace();
+		for (const Town *t : Town::Iterate()) {
+			if (t->cache.population >= SUBSIDY_CARGO_MIN_POPULATION) sources->push_back(t->index);
+		}
+	}
+	if (sources->empty()) return false;
+
 	/* Select a random town. */
-	const Town *src_town = Town::GetRandom();
-	if (src_town->cache.population < SUBSIDY_CARGO_MIN_POPULATION) return false;
+	uint32_t src_num = RandomRange(static_cast<uint32_t>(sources->size()));
+	const Town *src_town = Town::Get((*sources)[src_num]);
 
 	/* Calculate the produced cargo of houses around town center. */
 	CargoArray town_cargo_produced{};
@@ -342,8 +406,11 @@ bool FindSubsidyTownCargoRoute()
 
 	uint8_t cargo_count = town_cargo_produced.GetCount();
 
-	/* No cargo produced at all? */
-	if (cargo_count == 0) return false;
+	/* No cargo produced at all? Then do not try this town again. */
+	if (cargo_count == 0) {
+		sources->erase(sources->begin() + src_num);
+		return false;
+	}
 
 	/* Choose a random cargo that is produced in the town. */
 	uint8_t cargo_number = RandomRange(cargo_count);
@@ -366,115 +433,92 @@ bool FindSubsidyTownCargoRoute()
 
 	SourceID src = src_town->index;
 
-	return FindSubsidyCargoDestination(cid, src_type, src);
+	return FindSubsidyCargoDestination(candidates, cid, src_type, src);
 }
 
 /**
  * Tries to create a cargo subsidy with an industry as source.
+ * @param candidates The sources and destinations found so far.
  * @return True iff the subsidy was created.
  */
-bool FindSubsidyIndustryCargoRoute()
+static bool FindSubsidyIndustryCargoRoute(SubsidyCandidates &candidates)
 {
 	if (!Subsidy::CanAllocateItem()) return false;
 
 	SourceType src_type = SourceType::Industry;
 
-	/* Select a random industry. */
-	const Industry *src_ind = Industry::GetRandom();
-	if (src_ind == nullptr) return false;
-
-	uint trans, total;
-
-	CargoID cid;
-
-	/* Randomize cargo type */
-	int num_cargos = std::count_if(std::begin(src_ind->produced), std::end(src_ind->produced), [](const auto &p) { return IsValidCargoID(p.cargo); });
-	if (num_cargos == 0) return false; // industry produces nothing
-	int cargo_num = RandomRange(num_cargos) + 1;
-
-	auto it = std::begin(src_ind->produced);
-	for (/* nothing */; it != std::end(src_ind->produced); ++it) {
-		if (IsValidCargoID(it->cargo)) cargo_num--;
-		if (cargo_num == 0) break;
-	}
-	assert(it != std::end(src_ind->produced)); // indicates loop didn't end as intended
-
-	cid = it->cargo;
-	trans = it->history[LAST_MONTH].PctTransported();
-	total = it->history[LAST_MONTH].production;
-
-	/* Quit if no production in this industry
-	 * or if the pct transported is already large enough
-	 * or if the cargo is automatically distributed */
-	if (total == 0 || trans > SUBSIDY_MAX_PCT_TRANSPORTED ||
-			!IsValidCargoID(cid) ||
-			_settings_game.linkgraph.GetDistributionType(cid) != DT_MANUAL) {
-		return false;
+	/* Only cargo that is produced, is not transported enough yet
+	 * and is not automatically distributed can be subsidised. */
+	std::optional<std::vector<std::pair<IndustryID, CargoID>>> &sources = candidates.industry_sources;
+	if (!sources.has_value()) {
+		sources.emplace();
+		for (const Industry *ind : Industry::Iterate()) {
+			for (const auto &p : ind->produced) {
+				if (!IsValidCargoID(p.cargo) || _settings_game.linkgraph.GetDistributionType(p.cargo) != DT_MANUAL) continue;
+				if (p.history[LAST_MONTH].production == 0 || p.history[LAST_MONTH].PctTransported() > SUBSIDY_MAX_PCT_TRANSPORTED) continue;
+				sources->emplace_back(ind->index, p.cargo);
+			}
+		}
 	}
+	if (sources->empty()) return false;
 
-	SourceID src = src_ind->index;
+	/* Select a random industry and cargo. */
+	auto [src, cid] = (*sources)[RandomRange(static_cast<uint32_t>(sources->size()))];
 
-	return FindSubsidyCargoDestination(cid, src_type, src);
+	return FindSubsidyCargoDestination(candidates, cid, src_type, src);
 }
 
 /**
  * Tries to find a suitable destination for the given source and cargo.
+ * @param candidates The sources and destinations found so far.
  * @param cid      Subsidized cargo.
  * @param src_type Type of \a src.
  * @param src      Index of source.
  * @return True iff the subsidy was created.
  */
-bool FindSubsidyCargoDestination(CargoID cid, SourceType src_type, SourceID src)
+static bool FindSubsidyCargoDestination(SubsidyCandidates &candidates, CargoID cid, SourceType src_type, SourceID src)
 {
+	TileIndex src_tile = (src_type == SourceType::Town) ? Town::Get(src)->xy : Industry::Get(src)->location.tile;
+
 	/* Choose a random destination. */
 	SourceType dst_type = Chance16(1, 2) ? SourceType::Town : SourceType::Industry;
 
-	SourceID dst;
+	std::vector<SourceID> destinations;
 	switch (dst_type) {
-		case SourceType::Town: {
-			/* Select a random town. */
-			const Town *dst_town = Town::GetRandom();
-
-			/* Calculate cargo acceptance of houses around town center. */
-			CargoArray town_cargo_accepted{};
-			TileArea ta = TileArea(dst_town->xy, 1, 1).Expand(SUBSIDY_TOWN_CARGO_RADIUS);
-			for (TileIndex tile : ta) {
-				if (IsTileType(tile, MP_HOUSE)) {
-					AddAcceptedCargo(tile, town_cargo_accepted, nullptr);
-				}
+		case SourceType::Town:
+			for (TownID tid : FindTownsInSubsidyRange(src_tile)) {
+				/* Check if the town can accept this cargo. */
+				if (GetSubsidyTownAcceptance(candidates, Town::Get(tid))[cid] < 8) continue;
+				destinations.push_back(tid);
 			}
-
-			/* Check if the town can accept this cargo. */
-			if (town_cargo_accepted[cid] < 8) return false;
-
-			dst = dst_town->index;
 			break;
-		}
 
 		case SourceType::Industry: {
-			/* Select a random industry. */
-			const Industry *dst_ind = Industry::GetRandom();
-			if (dst_ind == nullptr) return false;
-
-			/* The industry must accept the cargo */
-			if (!dst_ind->IsCargoAccepted(cid)) return false;
+			std::optional<std::vector<IndustryID>> &accepting = candidates.accepting_industries[cid];
+			if (!accepting.has_value()) {
+				accepting.emplace();
+				for (const Industry *ind : Industry::Iterate()) {
+					if (ind->IsCargoAccepted(cid)) accepting->push_back(ind->index);
+				}
+			}
 
-			dst = dst_ind->index;
+			for (IndustryID iid : *accepting) {
+				if (DistanceManhattan(src_tile, Industry::Get(iid)->location.tile) <= SUBSIDY_MAX_DISTANCE) destinations.push_back(iid);
+			}
 			break;
 		}
 
 		default: NOT_REACHED();
 	}
 
-	/* Check that the source and the destination are not the same. */
-	if (src_type == dst_type && src == dst) return false;
-
-	/* Check distance between source and destination. */
-	if (!CheckSubsidyDistance(src_type, src, dst_type, dst)) return false;
-
-	/* Avoid duplicate subsidies. */
-	if (CheckSubsidyDuplicate(cid, src_type, src, dst_type, dst)) return false;
+	/* The source and the destination must differ, and duplicate subsidies are avoided. */
+	auto is_unsuitable = [&](SourceID dst) {
+		return (src_type == dst_type && src == dst) || CheckSubsidyDuplicate(cid, src_type, src, dst_type, dst);
+	};
+	destinations.erase(std::remove_if(destinations.begin(), destinations.end(), is_unsuitable), destinations.end());
+	if (destinations.empty()) return false;
 
+	SourceID dst = destinations[RandomRange(static_cast<uint32_t>(destinations.size()))];
 	CreateSubsidy(cid, src_type, src, dst_type, dst);
 
 	return true;
@@ -522,6 +566,7 @@ static IntervalTimer<TimerGameEconomy> _economy_subsidies_monthly({TimerGameEcon
 	bool passenger_subsidy = false;
 	bool town_subsidy = false;
 	bool industry_subsidy = false;
+	SubsidyCandidates candidates;
 
 	int random_chance = RandomRange(16);
 
@@ -530,21 +575,21 @@ static IntervalTimer<TimerGameEconomy> _economy_subsidies_monthly({TimerGameEcon
 		int n = 1000;
 
 		do {
-			passenger_subsidy = FindSubsidyPassengerRoute();
+			passenger_subsidy = FindSubsidyPassengerRoute(candidates);
 		} while (!passenger_subsidy && n--);
 	} else if (random_chance == 2) {
 		/* Cargo subsidies with a town as a source have a 1/16 chance. */
 		int n = 1000;
 
 		do {
-			town_subsidy = FindSubsidyTownCargoRoute();
+			town_subsidy = FindSubsidyTownCargoRoute(candidates);
 		} while (!town_subsidy && n--);
 	} else if (random_chance == 3) {
 		/* Cargo subsidies with an industry as a source have a 1/16 chance. */
 		int n = 1000;
 
 		do {
-			industry_subsidy = FindSubsidyIndustryCargoRoute();
+			industry_subsidy = FindSubsidyIndustryCargoRoute(candidates);
 		} while (!industry_subsidy && n--);
 	}
 
@@ -69,6 +69,9 @@
 #ifdef WITH_ZLIB
 # include <zlib.h>
 #endif
+#ifdef WITH_ZSTD
+# include <zstd.h>
+#endif
 #ifdef WITH_CURL
 # include <curl/curl.h>
 #endif
@@ -454,6 +457,10 @@ void SurveyLibraries(nlohmann::json &survey)
 	survey["zlib"] = zlibVersion();
 #endif
 
+#ifdef WITH_ZSTD
+	survey["zstd"] = ZSTD_versionString();
+#endif
+
 #ifdef WITH_CURL
 	auto *curl_v = curl_version_info(CURLVERSION_NOW);
 	survey["curl"] = curl_v->version;
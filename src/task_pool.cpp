@@ -0,0 +1,250 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file task_pool.cpp Implementation of the pool of worker threads. */
+
+#include "stdafx.h"
+#include "task_pool.h"
+#include "thread.h"
+
+#include <condition_variable>
+#include <deque>
+
+#include "safeguards.h"
+
+uint8_t _task_pool_threads = 0; ///< Number of worker threads in the pool; 0 means one less than the number of cores.
+
+/** Names of the threads while they run a task of a category. */
+static const char * const _task_category_names[] = { "ottd:gameloop", "ottd:linkgraph", "ottd:savegame", "ottd:newgrf", "ottd:sprite", "ottd:viewport", "ottd:worldgen", "ottd:music" };
+static_assert(lengthof(_task_category_names) == static_cast<size_t>(TaskCategory::End));
+
+/** Progress of a task. */
+enum class TaskStatus : uint8_t {
+	Queued,  ///< Nobody has started the task yet.
+	Running, ///< A worker, or a thread waiting for the task, is running it.
+	Done,    ///< The task has finished.
+};
+
+/** State of a task, shared between the pool and the handles to it. */
+struct TaskState {
+	std::function<void()> func; ///< Function to run.
+	TaskCategory category;      ///< Category of the task.
+	TaskStatus status = TaskStatus::Queued; ///< Progress of the task; protected by the mutex of the pool.
+};
+
+/**
+ * The pool itself. The workers are started when the first task is submitted,
+ * so the configured number of threads has been read by then. The pool is
+ * never destroyed, so it stays usable by whatever is destroyed last on exit;
+ * the idle workers simply end with the process.
+ */
+class TaskPool {
+public:
+	void Submit(std::shared_ptr<TaskState> task);
+	bool HasWorkers();
+	void Wait(TaskState &task);
+	bool IsDone(const TaskState &task);
+
+private:
+	void StartWorkers();
+	void WorkerLoop();
+	void Run(std::unique_lock<std::mutex> &lock, TaskState &task);
+
+	std::mutex mutex;                  ///< Protects all members and the status of the tasks.
+	std::condition_variable work;      ///< Signalled when a task is queued.
+	std::condition_variable done;      ///< Signalled when a task is done.
+	std::deque<std::shared_ptr<TaskState>> queue; ///< Queued tasks, possibly already started by a waiting thread.
+	std::vector<std::thread> workers;  ///< The worker threads.
+	bool started = false;              ///< Whether the workers have been started.
+};
+
+/**
+ * Get the pool of worker threads.
+ * @return The pool.
+ */
+static TaskPool &GetTaskPool()
+{
+	static TaskPool *pool = new TaskPool();
+	return *pool;
+}
+
+/**
+ * Start the worker threads. Must be called with the mutex locked.
+ */
+void TaskPool::StartWorkers()
+{
+	this->started = true;
+	uint count = _task_pool_threads;
+	if (count == 0) count = std::max(1U, std::thread::hardware_concurrency()) - 1;
+	count = std::max(1U, count);
+	for (uint i = 0; i < count; i++) {
+		std::thread &t = this->workers.emplace_back();
+		if (!StartNewThread(&t, "ottd:worker", [this]() { this->WorkerLoop(); })) {
+			this->workers.pop_back();
+			break;
+		}
+	}
+	Debug(misc, 1, "Started {} worker threads", this->workers.size());
+}
+
+/** Main loop of a worker thread. */
+void TaskPool::WorkerLoop()
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	for (;;) {
+		this->work.wait(lock, [this]() { return !this->queue.empty(); });
+
+		std::shared_ptr<TaskState> task = std::move(this->queue.front());
+		this->queue.pop_front();
+		if (task->status != TaskStatus::Queued) continue; // Somebody waiting for it got there first.
+
+		SetCurrentThreadName(_task_category_names[static_cast<size_t>(task->category)]);
+		this->Run(lock, *task);
+	}
+}
+
+/**
+ * Run a queued task on the current thread.
+ * @param lock Lock of the mutex, held on entry and on return.
+ * @param task The task to run.
+ */
+void TaskPool::Run(std::unique_lock<std::mutex> &lock, TaskState &task)
+{
+	task.status = TaskStatus::Running;
+	lock.unlock();
+	task.func();
+	task.func = nullptr;
+	lock.lock();
+	task.status = TaskStatus::Done;
+	this->done.notify_all();
+}
+
+/**
+ * Queue a task for the workers.
+ * @param task The task to queue.
+ */
+void TaskPool::Submit(std::shared_ptr<TaskState> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (!this->started) this->StartWorkers();
+		if (task->category == TaskCategory::GameLoop || task->category == TaskCategory::Viewport || task->category == TaskCategory::WorldGen) {
+			this->queue.push_front(std::move(task));
+		} else {
+			this->queue.push_back(std::move(task));
+		}
+	}
+	this->work.notify_one();
+}
+
+/**
+ * Check whether there are worker threads at all.
+ * @return False if no thread could be started, so tasks only run when they are waited for.
+ */
+bool TaskPool::HasWorkers()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	if (!this->started) this->StartWorkers();
+	return !this->workers.empty();
+}
+
+/**
+ * Wait for a task to finish. If no worker has started it yet, it is run on
+ * the current thread instead, so waiting never depends on a free worker.
+ * @param task The task to wait for.
+ */
+void TaskPool::Wait(TaskState &task)
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	if (task.status == TaskStatus::Queued) {
+		/* The task stays in the queue; the worker that pops it sees it has been started. */
+		this->Run(lock, task);
+		return;
+	}
+	this->done.wait(lock, [&task]() { return task.status == TaskStatus::Done; });
+}
+
+/**
+ * Check whether a task has finished.
+ * @param task The task to check.
+ * @return True if the task is done.
+ */
+bool TaskPool::IsDone(const TaskState &task)
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return task.status == TaskStatus::Done;
+}
+
+/**
+ * Check whether the task has finished.
+ * @return True if the task is done.
+ * @pre IsValid()
+ */
+bool TaskHandle::IsDone() const
+{
+	return GetTaskPool().IsDone(*this->state);
+}
+
+/**
+ * Wait for the task to finish, running it on this thread if no worker has started it yet.
+ * @pre IsValid()
+ */
+void TaskHandle::Wait()
+{
+	GetTaskPool().Wait(*this->state);
+}
+
+/**
+ * Submit a task to the pool of worker threads.
+ * @param category Category of the task.
+ * @param func Function to run.
+ * @return Handle to wait for the task.
+ */
+TaskHandle SubmitTask(TaskCategory category, std::function<void()> &&func)
+{
+	TaskHandle handle;
+	handle.state = std::make_shared<TaskState>();
+	handle.state->func = std::move(func);
+	handle.state->category = category;
+	GetTaskPool().Submit(handle.state);
+	return handle;
+}
+
+/**
+ * Check whether the pool has any worker threads. Callers that would rather do
+ * their work right away than when it is waited for can use this.
+ * @return True if tasks are run in the background.
+ */
+bool HasTaskWorkers()
+{
+	return GetTaskPool().HasWorkers();
+}
+
+/**
+ * Run a function over the items from 0 up to \a count in bands, on the workers and
+ * the current thread, and wait until all bands are done. With only one band, or
+ * without workers, all items are processed on the current thread.
+ * @param category Category of the tasks.
+ * @param count Number of items.
+ * @param band_size Number of items per band.
+ * @param func Function processing the items from its first parameter up to, but not including, its second.
+ */
+void RunInBands(TaskCategory category, uint count, uint band_size, const std::function<void(uint, uint)> &func)
+{
+	if (count <= band_size || !HasTaskWorkers()) {
+		func(0, count);
+		return;
+	}
+
+	std::vector<TaskHandle> tasks;
+	for (uint first = band_size; first < count; first += band_size) {
+		uint last = std::min(first + band_size, count);
+		tasks.push_back(SubmitTask(category, [&func, first, last]() { func(first, last); }));
+	}
+	func(0, band_size);
+	for (TaskHandle &task : tasks) task.Wait();
+}
@@ -0,0 +1,57 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file task_pool.h Pool of worker threads shared by all background and parallel tasks. */
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <functional>
+#include <memory>
+
+/** Categories of tasks. They determine the priority of a task and the name of the thread running it. */
+enum class TaskCategory : uint8_t {
+	GameLoop,  ///< Chunk of a parallel phase of the game loop; the game loop is waiting for it, so it goes first.
+	LinkGraph, ///< Calculation of a link graph job.
+	Savegame,  ///< Saving chunks of, compressing and writing a savegame, or rebuilding caches after loading one.
+	NewGRF,    ///< Reading NewGRF files while they are being loaded.
+	Sprite,    ///< Decoding a sprite that is not in the sprite cache yet.
+	Viewport,  ///< Drawing a part of a viewport; the screen is waiting for it, so it goes first.
+	WorldGen,  ///< Chunk of a parallel pass of the world generation; the generation is waiting for it, so it goes first.
+	Music,     ///< Preparing a song of the playlist before it is played.
+	End,       ///< End marker.
+};
+
+struct TaskState;
+
+/** Handle to a task that has been submitted to the pool. */
+class TaskHandle {
+public:
+	TaskHandle() = default;
+
+	/**
+	 * Check whether this handle refers to a task.
+	 * @return True if a task was submitted and the handle has not been reset since.
+	 */
+	inline bool IsValid() const { return this->state != nullptr; }
+
+	bool IsDone() const;
+	void Wait();
+
+private:
+	friend TaskHandle SubmitTask(TaskCategory category, std::function<void()> &&func);
+
+	std::shared_ptr<TaskState> state; ///< State shared with the pool.
+};
+
+TaskHandle SubmitTask(TaskCategory category, std::function<void()> &&func);
+bool HasTaskWorkers();
+void RunInBands(TaskCategory category, uint count, uint band_size, const std::function<void(uint, uint)> &func);
+
+extern uint8_t _task_pool_threads;
+
+#endif /* TASK_POOL_H */
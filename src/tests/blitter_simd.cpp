@@ -0,0 +1,221 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file blitter_simd.cpp Test that the SIMD blitters draw exactly the same as the blitters they are based on. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../blitter/factory.hpp"
+#include "../core/alloc_func.hpp"
+#include "../core/random_func.hpp"
+#include "../settings_type.h"
+#include "../spritecache.h"
+#include "../spriteloader/spriteloader.hpp"
+#include "../zoom_func.h"
+
+#include <chrono>
+
+#include "../safeguards.h"
+
+#if defined(WITH_SSE) || defined(WITH_NEON)
+
+/** Width and height of the test sprite at the normal zoom level; odd to get the odd block types too. */
+static const uint TEST_SPRITE_SIZE = 131;
+
+/** A blitter with the test sprite encoded for it. */
+struct EncodedTestSprite {
+	std::unique_ptr<Blitter> blitter;
+	Sprite *sprite;
+
+	EncodedTestSprite(const char *name, const SpriteLoader::SpriteCollection &collection) :
+		blitter(BlitterFactory::GetBlitterFactory(name)->CreateInstance()),
+		sprite(this->blitter->Encode(collection, SimpleSpriteAlloc))
+	{
+	}
+
+	~EncodedTestSprite()
+	{
+		free(this->sprite);
+	}
+
+	/**
+	 * Draw the sprite into a destination buffer.
+	 * @param dst Destination, TEST_SPRITE_SIZE pixels wide and high.
+	 * @param mode Blitter mode to draw with.
+	 * @param zoom Zoom level to draw at.
+	 * @param skip Number of pixels to skip at the left and top, to take the other read mode.
+	 */
+	void Draw(std::vector<uint32_t> &dst, BlitterMode mode, ZoomLevel zoom, int skip) const
+	{
+		static uint8_t remap[256];
+		for (uint i = 0; i < lengthof(remap); i++) remap[i] = 255 - i;
+
+		int size = UnScaleByZoom(TEST_SPRITE_SIZE, zoom);
+		Blitter::BlitterParams bp;
+		bp.sprite = this->sprite->data;
+		bp.remap = remap;
+		bp.skip_left = skip;
+		bp.skip_top = skip;
+		bp.width = size - skip;
+		bp.height = size - skip;
+		bp.sprite_width = size;
+		bp.sprite_height = size;
+		bp.left = 0;
+		bp.top = 0;
+		bp.dst = dst.data();
+		bp.pitch = TEST_SPRITE_SIZE;
+		this->blitter->Draw(&bp, mode, zoom);
+	}
+};
+
+/**
+ * Fill a sprite collection with random pixels; a mix of transparent, translucent,
+ * opaque and remapped pixels, with longer runs of opaque ones to get the fast paths.
+ * @param[out] collection The collection to fill.
+ * @param translucent Whether to add translucent pixels.
+ * @param remap Whether to add remapped pixels.
+ * @param random Source of the pixels.
+ */
+static void FillTestSprite(SpriteLoader::SpriteCollection &collection, bool translucent, bool remap, Randomizer &random)
+{
+	for (ZoomLevel zoom = ZOOM_LVL_BEGIN; zoom != ZOOM_LVL_END; zoom++) {
+		SpriteLoader::Sprite &sprite = collection[zoom];
+		sprite.width = sprite.height = UnScaleByZoom(TEST_SPRITE_SIZE, zoom);
+		sprite.x_offs = sprite.y_offs = 0;
+		sprite.type = SpriteType::Normal;
+		sprite.colours = SCC_RGB | SCC_ALPHA | SCC_PAL;
+		sprite.AllocateData(zoom, sprite.width * sprite.height);
+
+		for (uint i = 0; i < (uint)sprite.width * sprite.height; i++) {
+			SpriteLoader::CommonPixel &pixel = sprite.data[i];
+			uint32_t r = random.Next();
+			pixel.r = GB(r, 0, 8);
+			pixel.g = GB(r, 8, 8);
+			pixel.b = GB(r, 16, 8);
+			uint32_t kind = random.Next() % 8;
+			pixel.a = kind == 0 ? 0 : ((translucent && kind == 1) ? GB(r, 3, 8) : 255);
+			pixel.m = (remap && kind == 2) ? GB(r, 5, 7) + 1 : 0;
+		}
+	}
+}
+
+/**
+ * Fill a destination buffer with random opaque pixels.
+ * @param[out] dst The buffer to fill.
+ * @param random Source of the pixels.
+ */
+static void FillTestDestination(std::vector<uint32_t> &dst, Randomizer &random)
+{
+	dst.resize(TEST_SPRITE_SIZE * TEST_SPRITE_SIZE);
+	for (uint32_t &pixel : dst) pixel = random.Next() | 0xFF000000;
+}
+
+/**
+ * Check that two blitters draw the test sprites exactly the same in all modes at all zoom levels.
+ * @param reference Name of the blitter with the expected output.
+ * @param tested Name of the blitter to test.
+ */
+static void CheckSameDrawing(const char *reference, const char *tested)
+{
+	_settings_client.gui.zoom_min = ZOOM_LVL_MIN;
+	_settings_client.gui.zoom_max = ZOOM_LVL_MAX;
+
+	Randomizer random;
+	random.SetSeed(12345);
+
+	for (int variant = 0; variant < 3; variant++) {
+		SpriteLoader::SpriteCollection collection;
+		FillTestSprite(collection, variant >= 1, variant == 2, random);
+		EncodedTestSprite expected_sprite(reference, collection);
+		EncodedTestSprite result_sprite(tested, collection);
+
+		for (BlitterMode mode : { BM_NORMAL, BM_COLOUR_REMAP, BM_TRANSPARENT, BM_TRANSPARENT_REMAP, BM_CRASH_REMAP, BM_BLACK_REMAP }) {
+			for (ZoomLevel zoom = ZOOM_LVL_BEGIN; zoom != ZOOM_LVL_END; zoom++) {
+				for (int skip : { 0, 3 }) {
+					if (skip >= UnScaleByZoom(TEST_SPRITE_SIZE, zoom)) continue;
+
+					std::vector<uint32_t> expected, result;
+					FillTestDestination(expected, random);
+					result = expected;
+					expected_sprite.Draw(expected, mode, zoom, skip);
+					result_sprite.Draw(result, mode, zoom, skip);
+
+					INFO(tested << ": variant " << variant << ", mode " << mode << ", zoom " << (int)zoom << ", skip " << skip);
+					CHECK(result == expected);
+				}
+			}
+		}
+	}
+}
+
+#endif /* WITH_SSE || WITH_NEON */
+
+#ifdef WITH_SSE
+
+TEST_CASE("Blitter - AVX2 draws the same as SSE4")
+{
+	if (BlitterFactory::GetBlitterFactory("32bpp-avx2") == nullptr) {
+		WARN("AVX2 is not supported, skipping");
+		return;
+	}
+
+	CheckSameDrawing("32bpp-sse4", "32bpp-avx2");
+}
+
+TEST_CASE("Blitter - AVX2 versus SSE4 speed", "[.benchmark]")
+{
+	if (BlitterFactory::GetBlitterFactory("32bpp-avx2") == nullptr) {
+		WARN("AVX2 is not supported, skipping");
+		return;
+	}
+
+	_settings_client.gui.zoom_min = ZOOM_LVL_MIN;
+	_settings_client.gui.zoom_max = ZOOM_LVL_MAX;
+
+	Randomizer random;
+	random.SetSeed(12345);
+
+	SpriteLoader::SpriteCollection collection;
+	FillTestSprite(collection, true, true, random);
+	EncodedTestSprite sse4("32bpp-sse4", collection);
+	EncodedTestSprite avx2("32bpp-avx2", collection);
+
+	std::vector<uint32_t> dst;
+	FillTestDestination(dst, random);
+
+	auto time = [&dst](const EncodedTestSprite &encoded, BlitterMode mode, ZoomLevel zoom) {
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < 2000; i++) encoded.Draw(dst, mode, zoom, 0);
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	for (BlitterMode mode : { BM_NORMAL, BM_COLOUR_REMAP, BM_TRANSPARENT }) {
+		for (ZoomLevel zoom = ZOOM_LVL_BEGIN; zoom != ZOOM_LVL_END; zoom++) {
+			auto sse4_time = time(sse4, mode, zoom);
+			auto avx2_time = time(avx2, mode, zoom);
+			WARN("mode " << mode << ", zoom " << (int)zoom << ": sse4 " << sse4_time << " us, avx2 " << avx2_time << " us");
+		}
+	}
+}
+
+#endif /* WITH_SSE */
+
+#ifdef WITH_NEON
+
+TEST_CASE("Blitter - NEON draws the same as optimized")
+{
+	if (BlitterFactory::GetBlitterFactory("32bpp-neon") == nullptr) {
+		WARN("No NEON blitter, skipping");
+		return;
+	}
+
+	CheckSameDrawing("32bpp-optimized", "32bpp-neon");
+}
+
+#endif /* WITH_NEON */
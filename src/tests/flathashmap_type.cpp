@@ -0,0 +1,136 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file flathashmap_type.cpp Test functionality of the open addressing hash map. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../core/flathashmap_type.hpp"
+#include "../core/flatmap_type.hpp"
+#include "../core/random_func.hpp"
+
+#include <chrono>
+
+#include "../safeguards.h"
+
+TEST_CASE("FlatHashMap - same items as std::map")
+{
+	FlatHashMap<int, int> hash;
+	std::map<int, int> reference;
+
+	/* Plenty of duplicate keys and erasures. */
+	Randomizer random;
+	random.SetSeed(1234);
+
+	for (int i = 0; i < 20000; i++) {
+		int key = random.Next() % 500;
+		int value = random.Next();
+		switch (random.Next() % 4) {
+			case 0:
+				CHECK(hash.insert({ key, value }).second == reference.insert({ key, value }).second);
+				break;
+			case 1:
+				hash[key] = value;
+				reference[key] = value;
+				break;
+			case 2:
+				CHECK(hash.erase(key) == reference.erase(key));
+				break;
+			case 3: {
+				auto it = hash.find(key);
+				auto ref = reference.find(key);
+				REQUIRE((it == hash.end()) == (ref == reference.end()));
+				if (it != hash.end()) CHECK(it->second == ref->second);
+				break;
+			}
+		}
+		REQUIRE(hash.size() == reference.size());
+	}
+
+	std::map<int, int> contents(hash.begin(), hash.end());
+	CHECK(contents == reference);
+}
+
+TEST_CASE("FlatHashMap - erasing while iterating")
+{
+	FlatHashMap<uint32_t, uint32_t> hash;
+	for (uint32_t i = 0; i < 1000; i++) hash[i * 7919] = i;
+
+	for (auto it = hash.begin(); it != hash.end();) {
+		if (it->second % 3 == 0) {
+			it = hash.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	CHECK(hash.size() == 666);
+	for (uint32_t i = 0; i < 1000; i++) CHECK(hash.contains(i * 7919) == (i % 3 != 0));
+}
+
+TEST_CASE("FlatHashMap - iteration order only depends on the operations")
+{
+	FlatHashMap<uint32_t, int> a;
+	FlatHashMap<uint32_t, int> b;
+	b.reserve(10);
+
+	for (uint32_t i = 0; i < 300; i++) {
+		a[i * 2654435761U] = i;
+		b[i * 2654435761U] = i;
+		if (i % 5 == 0) {
+			a.erase(i / 2 * 2654435761U);
+			b.erase(i / 2 * 2654435761U);
+		}
+	}
+
+	CHECK(std::vector<std::pair<uint32_t, int>>(a.begin(), a.end()) == std::vector<std::pair<uint32_t, int>>(b.begin(), b.end()));
+
+	FlatHashMap<uint32_t, int> copy = a;
+	CHECK(copy.size() == a.size());
+	for (const auto &[key, value] : a) CHECK(copy[key] == value);
+}
+
+TEST_CASE("FlatHashMap - lookup speed versus other containers", "[.benchmark]")
+{
+	static const uint32_t ITEMS = 20000;
+	static const uint32_t ROUNDS = 10;
+
+	std::vector<uint32_t> keys;
+	Randomizer random;
+	random.SetSeed(42);
+	for (uint32_t i = 0; i < ITEMS; i++) keys.push_back(random.Next());
+
+	auto time = [&keys](auto &container, const char *name) {
+		auto start = std::chrono::steady_clock::now();
+		for (uint32_t key : keys) container[key] = key;
+		auto inserted = std::chrono::steady_clock::now();
+
+		uint64_t sum = 0;
+		for (uint32_t round = 0; round < ROUNDS; round++) {
+			for (uint32_t key : keys) sum += container.find(key)->second;
+			for (uint32_t key : keys) sum += container.find(key + 1) == container.end() ? 0 : 1;
+		}
+		auto looked_up = std::chrono::steady_clock::now();
+
+		for (const auto &item : container) sum += item.second;
+		auto iterated = std::chrono::steady_clock::now();
+
+		auto us = [](auto from, auto to) { return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count(); };
+		WARN(name << ": insert " << us(start, inserted) << " us, lookup " << us(inserted, looked_up) << " us, iterate " << us(looked_up, iterated) << " us (" << sum << ")");
+	};
+
+	std::map<uint32_t, uint32_t> map;
+	time(map, "std::map");
+	std::unordered_map<uint32_t, uint32_t> unordered_map;
+	time(unordered_map, "std::unordered_map");
+	FlatMap<uint32_t, uint32_t> flat_map;
+	time(flat_map, "FlatMap");
+	FlatHashMap<uint32_t, uint32_t> flat_hash_map;
+	time(flat_hash_map, "FlatHashMap");
+}
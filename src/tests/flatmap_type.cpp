@@ -0,0 +1,59 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file flatmap_type.cpp Test functionality of the sorted vector map. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../core/flatmap_type.hpp"
+#include "../core/random_func.hpp"
+
+#include "../safeguards.h"
+
+TEST_CASE("FlatMap - same order as std::map")
+{
+	FlatMap<int, int> flat;
+	std::map<int, int> reference;
+
+	/* Plenty of duplicate keys. */
+	Randomizer random;
+	random.SetSeed(4321);
+
+	for (int i = 0; i < 1000; i++) {
+		int key = random.Next() % 200;
+		int value = random.Next();
+		switch (random.Next() % 3) {
+			case 0: CHECK(flat.insert({key, value}).second == reference.insert({key, value}).second); break;
+			case 1: flat[key] = value; reference[key] = value; break;
+			case 2: CHECK(flat.erase(key) == reference.erase(key)); break;
+		}
+	}
+
+	REQUIRE(flat.size() == reference.size());
+	CHECK(std::equal(flat.begin(), flat.end(), reference.begin(), reference.end(),
+			[](const auto &a, const auto &b) { return a.first == b.first && a.second == b.second; }));
+
+	for (int key = -1; key <= 200; key++) {
+		CHECK((flat.find(key) == flat.end()) == (reference.find(key) == reference.end()));
+		CHECK(std::distance(flat.begin(), flat.upper_bound(key)) == std::distance(reference.begin(), reference.upper_bound(key)));
+	}
+}
+
+TEST_CASE("FlatMap - range insert keeps existing items")
+{
+	FlatMap<int, int> flat;
+	flat[1] = 10;
+	flat[5] = 50;
+
+	std::vector<std::pair<int, int>> items = { {7, 70}, {5, 0}, {3, 30}, {3, 0} };
+	flat.insert(items.begin(), items.end());
+
+	std::vector<std::pair<int, int>> expected = { {1, 10}, {3, 30}, {5, 50}, {7, 70} };
+	CHECK(std::equal(flat.begin(), flat.end(), expected.begin(), expected.end()));
+}
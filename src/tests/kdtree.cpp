@@ -0,0 +1,131 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file kdtree.cpp Test functionality of the k-d tree. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#define KDTREE_DEBUG
+#include "../core/kdtree.hpp"
+#include "../core/random_func.hpp"
+
+#include <chrono>
+#include <numeric>
+
+#include "../safeguards.h"
+
+/** Coordinates of the points stored in the test trees, the tree stores indices into this. */
+static std::vector<std::pair<uint16_t, uint16_t>> _kdtree_points;
+
+static uint16_t Kdtree_TestXYFunc(uint32_t index, int dim) { return (dim == 0) ? _kdtree_points[index].first : _kdtree_points[index].second; }
+using TestKdtree = Kdtree<uint32_t, decltype(&Kdtree_TestXYFunc), uint16_t, int>;
+
+/** Find the k nearest points in the given set without using a tree, ordered like the tree orders them. */
+static std::vector<uint32_t> BruteForceKNearest(const std::set<uint32_t> &present, uint16_t x, uint16_t y, size_t k)
+{
+	std::vector<std::pair<int, uint32_t>> all;
+	for (uint32_t index : present) {
+		all.emplace_back(abs(_kdtree_points[index].first - x) + abs(_kdtree_points[index].second - y), index);
+	}
+	std::sort(all.begin(), all.end());
+
+	std::vector<uint32_t> result;
+	for (size_t i = 0; i < std::min(k, all.size()); i++) result.push_back(all[i].second);
+	return result;
+}
+
+/** Check all kinds of nearest element searches against a brute force search. */
+static void CheckNearest(const TestKdtree &tree, const std::set<uint32_t> &present)
+{
+	REQUIRE(tree.Count() == present.size());
+
+	std::vector<std::pair<uint16_t, uint16_t>> points;
+	for (uint16_t x = 0; x < 64; x += 5) {
+		for (uint16_t y = 0; y < 64; y += 3) points.emplace_back(x, y);
+	}
+	std::vector<uint32_t> batch = tree.FindNearest(points);
+	REQUIRE(batch.size() == points.size());
+
+	for (size_t i = 0; i < points.size(); i++) {
+		auto [x, y] = points[i];
+		std::vector<uint32_t> expected = BruteForceKNearest(present, x, y, 5);
+		CHECK(tree.FindNearest(x, y) == expected[0]);
+		CHECK(batch[i] == expected[0]);
+		CHECK(tree.FindKNearest(x, y, 5) == expected);
+	}
+}
+
+TEST_CASE("Kdtree - nearest elements after single inserts and removals")
+{
+	Randomizer random;
+	random.SetSeed(5678);
+
+	_kdtree_points.clear();
+	for (uint32_t i = 0; i < 500; i++) _kdtree_points.emplace_back(random.Next() % 64, random.Next() % 64);
+
+	TestKdtree tree(&Kdtree_TestXYFunc);
+	std::set<uint32_t> present;
+
+	/* Inserting in coordinate order is the worst case for an unbalanced tree. */
+	std::vector<uint32_t> order(_kdtree_points.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [](uint32_t a, uint32_t b) { return _kdtree_points[a] < _kdtree_points[b]; });
+	for (uint32_t index : order) {
+		tree.Insert(index);
+		present.insert(index);
+	}
+	CheckNearest(tree, present);
+
+	for (uint32_t i = 0; i < 300; i++) {
+		uint32_t index = random.Next() % _kdtree_points.size();
+		if (present.erase(index) != 0) {
+			tree.Remove(index);
+		} else {
+			tree.Insert(index);
+			present.insert(index);
+		}
+	}
+	CheckNearest(tree, present);
+
+	CHECK(tree.FindKNearest(0, 0, 0).empty());
+	CHECK(tree.FindKNearest(0, 0, 10000).size() == present.size());
+}
+
+TEST_CASE("Kdtree - query speed", "[.benchmark]")
+{
+	static const uint32_t POINTS = 20000;
+	static const uint32_t QUERIES = 100000;
+
+	Randomizer random;
+	random.SetSeed(1234);
+
+	_kdtree_points.clear();
+	for (uint32_t i = 0; i < POINTS; i++) _kdtree_points.emplace_back(random.Next() % 4096, random.Next() % 4096);
+	std::vector<uint32_t> indices(POINTS);
+	std::iota(indices.begin(), indices.end(), 0);
+
+	auto start = std::chrono::steady_clock::now();
+	TestKdtree tree(&Kdtree_TestXYFunc);
+	tree.Build(indices.begin(), indices.end());
+	auto built = std::chrono::steady_clock::now();
+
+	uint64_t sum = 0;
+	for (uint32_t i = 0; i < QUERIES; i++) sum += tree.FindNearest(random.Next() % 4096, random.Next() % 4096);
+	auto nearest = std::chrono::steady_clock::now();
+
+	for (uint32_t i = 0; i < QUERIES; i++) {
+		uint16_t x = random.Next() % 4000;
+		uint16_t y = random.Next() % 4000;
+		tree.FindContained(x, y, x + 64, y + 64, [&sum](uint32_t index) { sum += index; });
+	}
+	auto contained = std::chrono::steady_clock::now();
+
+	auto us = [](auto from, auto to) { return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count(); };
+	WARN("Kdtree of " << POINTS << " points: build " << us(start, built) << " us, " << QUERIES << " nearest " << us(built, nearest) << " us, " << QUERIES << " contained " << us(nearest, contained) << " us (" << sum << ")");
+}
@@ -0,0 +1,35 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file linkgraphschedule.cpp Test the postponement of overdue link graph jobs. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../linkgraph/linkgraphschedule.h"
+
+TEST_CASE("GetLinkGraphJoinPostponement - estimate")
+{
+	/* Half done after 16 days, so 16 more days are needed. */
+	CHECK(16 == GetLinkGraphJoinPostponement(16, 500, 4, 16));
+	/* Almost done; one interval is the least the join can be postponed by. */
+	CHECK(4 == GetLinkGraphJoinPostponement(10, 800, 4, 16));
+	/* Rounded up to whole intervals. */
+	CHECK(8 == GetLinkGraphJoinPostponement(10, 600, 4, 16));
+}
+
+TEST_CASE("GetLinkGraphJoinPostponement - capped")
+{
+	/* Without any progress the estimate is ~1000 times the elapsed time, which must not pass the cap. */
+	CHECK(16 == GetLinkGraphJoinPostponement(16, 0, 4, 16));
+	CHECK(12 == GetLinkGraphJoinPostponement(16, 0, 4, 15));
+	CHECK(8 == GetLinkGraphJoinPostponement(24, 100, 4, 8));
+	/* With less than an interval left, the join is still postponed by one interval. */
+	CHECK(4 == GetLinkGraphJoinPostponement(30, 0, 4, 2));
+	CHECK(4 == GetLinkGraphJoinPostponement(32, 0, 4, 0));
+}
@@ -0,0 +1,77 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file map_tile_access.cpp Test the speed of accessing the tiles of the map. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../core/random_func.hpp"
+#include "../map_func.h"
+
+#include <chrono>
+
+#include "../safeguards.h"
+
+TEST_CASE("Map - tile access speed", "[.benchmark]")
+{
+	static const uint SIZE = 1024;
+	static const uint SWEEPS = 20;
+	static const uint RANDOM_ACCESSES = 10000000;
+
+	Map::Allocate(SIZE, SIZE);
+
+	for (TileIndex t = 0; t < Map::Size(); t++) {
+		Tile tile(t);
+		tile.type() = t.base() % 7 << 4;
+		tile.height() = t.base() % 16;
+		tile.m5() = t.base() & 0xFF;
+		tile.m6() = t.base() >> 8 & 0xFF;
+	}
+
+	uint64_t sum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (uint i = 0; i < SWEEPS; i++) {
+		for (TileIndex t = 0; t < Map::Size(); t++) {
+			Tile tile(t);
+			sum += tile.type() + tile.height() + tile.m5();
+		}
+	}
+	auto base = std::chrono::steady_clock::now();
+
+	for (uint i = 0; i < SWEEPS; i++) {
+		for (TileIndex t = 0; t < Map::Size(); t++) {
+			Tile tile(t);
+			sum += tile.type() + tile.m6();
+		}
+	}
+	auto combined = std::chrono::steady_clock::now();
+
+	for (uint i = 0; i < SWEEPS; i++) {
+		for (uint y = 1; y < SIZE - 1; y++) {
+			for (uint x = 1; x < SIZE - 1; x++) {
+				TileIndex t = TileXY(x, y);
+				sum += Tile(t + TileDiffXY(1, 0)).height() + Tile(t + TileDiffXY(-1, 0)).height() +
+						Tile(t + TileDiffXY(0, 1)).height() + Tile(t + TileDiffXY(0, -1)).height();
+			}
+		}
+	}
+	auto neighbours = std::chrono::steady_clock::now();
+
+	Randomizer random;
+	random.SetSeed(1234);
+	for (uint i = 0; i < RANDOM_ACCESSES; i++) {
+		Tile tile(Map::WrapToMap(TileIndex{random.Next()}));
+		tile.m5()++;
+		sum += tile.m6();
+	}
+	auto random_writes = std::chrono::steady_clock::now();
+
+	auto us = [](auto from, auto to) { return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count(); };
+	WARN("Map of " << SIZE << "x" << SIZE << ", " << SWEEPS << " sweeps: base " << us(start, base) << " us, base and extended " << us(base, combined) << " us, neighbours " << us(combined, neighbours) << " us, " << RANDOM_ACCESSES << " random writes " << us(neighbours, random_writes) << " us (" << sum << ")");
+}
@@ -0,0 +1,166 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file mixer.cpp Test that the mixer mixes exactly like the plain sample by sample algorithm. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../mixer.h"
+#include "../core/math_func.hpp"
+#include "../core/random_func.hpp"
+
+#include <chrono>
+
+#include "../safeguards.h"
+
+static const uint TEST_PLAY_RATE = 44100;
+static const int TEST_MAX_VOLUME = 32767;
+
+/** A channel mixed sample by sample, like the mixer did before it mixed blocks of samples. */
+struct ReferenceChannel {
+	std::shared_ptr<std::vector<int8_t>> memory;
+	bool is16bit;
+	uint32_t pos = 0;
+	uint32_t frac_pos = 0;
+	uint32_t frac_speed;
+	uint32_t samples_left;
+	int volume_left;
+	int volume_right;
+
+	ReferenceChannel(std::shared_ptr<std::vector<int8_t>> memory, size_t size, uint rate, bool is16bit, uint volume, float pan) : memory(memory), is16bit(is16bit)
+	{
+		this->frac_speed = (rate << 16) / TEST_PLAY_RATE;
+		if (is16bit) size /= 2;
+		while (size >= UINT_MAX / TEST_PLAY_RATE) {
+			size >>= 1;
+			rate = (rate >> 1) + 1;
+		}
+		this->samples_left = (uint)size * TEST_PLAY_RATE / rate;
+		this->volume_left = (uint)(sin((1.0 - pan) * M_PI / 2.0) * volume);
+		this->volume_right = (uint)(sin(pan * M_PI / 2.0) * volume);
+	}
+
+	template <typename T>
+	void Mix(int16_t *buffer, uint samples, uint8_t effect_vol)
+	{
+		const uint SHIFT = sizeof(T) * CHAR_BIT;
+		samples = std::min(samples, this->samples_left);
+		this->samples_left -= samples;
+
+		const T *b = (const T *)this->memory->data() + this->pos;
+		int volume_left = this->volume_left * effect_vol / 255;
+		int volume_right = this->volume_right * effect_vol / 255;
+		for (; samples > 0; samples--) {
+			int data = ((b[0] * ((1 << 16) - (int)this->frac_pos)) + (b[1] * (int)this->frac_pos)) >> 16;
+			buffer[0] = Clamp(buffer[0] + (data * volume_left  >> SHIFT), -TEST_MAX_VOLUME, TEST_MAX_VOLUME);
+			buffer[1] = Clamp(buffer[1] + (data * volume_right >> SHIFT), -TEST_MAX_VOLUME, TEST_MAX_VOLUME);
+			buffer += 2;
+			this->frac_pos += this->frac_speed;
+			b += this->frac_pos >> 16;
+			this->frac_pos &= 0xffff;
+		}
+		this->pos = b - (const T *)this->memory->data();
+	}
+
+	void Mix(int16_t *buffer, uint samples, uint8_t effect_vol)
+	{
+		if (this->is16bit) {
+			this->Mix<int16_t>(buffer, samples, effect_vol);
+		} else {
+			this->Mix<int8_t>(buffer, samples, effect_vol);
+		}
+	}
+};
+
+TEST_CASE("Mixer - same output as mixing sample by sample")
+{
+	MxInitialize(TEST_PLAY_RATE);
+	SetEffectVolume(127);
+	const uint8_t effect_vol = 127;
+
+	Randomizer random;
+	random.SetSeed(4321);
+
+	for (bool is16bit : { false, true }) {
+		for (uint rate : { 44100, 11025, 22050, 48000 }) {
+			/* Two loud channels, so the output is clamped every now and then. */
+			std::vector<ReferenceChannel> reference;
+			for (uint channel = 0; channel < 2; channel++) {
+				size_t size = 3001 + channel * 500;
+				auto memory = std::make_shared<std::vector<int8_t>>(size + 2);
+				for (size_t i = 0; i < size; i++) (*memory)[i] = (int8_t)random.Next();
+				uint volume = 128 * 255;
+				float pan = channel == 0 ? 0.3f : 0.9f;
+
+				MixerChannel *mc = MxAllocateChannel();
+				REQUIRE(mc != nullptr);
+				MxSetChannelRawSrc(mc, memory, size, rate, is16bit);
+				MxSetChannelVolume(mc, volume, pan);
+				MxActivateChannel(mc);
+				reference.emplace_back(memory, size, rate, is16bit, volume, pan);
+			}
+
+			/* Odd buffer sizes, so the blocks do not line up with the samples. */
+			for (uint samples : { 1U, 7U, 333U, 1000U, 4096U, 4096U, 4096U }) {
+				std::vector<int16_t> expected(samples * 2, 0);
+				for (ReferenceChannel &channel : reference) {
+					if (channel.samples_left > 0) channel.Mix(expected.data(), samples, effect_vol);
+				}
+
+				std::vector<int16_t> buffer(samples * 2, 1);
+				MxMixSamples(buffer.data(), samples);
+				CHECK(buffer == expected);
+			}
+			MxCloseAllChannels();
+			std::vector<int16_t> buffer(2);
+			MxMixSamples(buffer.data(), 1);
+		}
+	}
+}
+
+TEST_CASE("Mixer - mixing speed", "[.benchmark]")
+{
+	static const uint SAMPLES = 512;
+	static const uint BUFFERS = 2000;
+
+	MxInitialize(TEST_PLAY_RATE);
+	SetEffectVolume(127);
+
+	for (bool is16bit : { false, true }) {
+		for (uint rate : { 44100, 11025 }) {
+			/* Eight long channels, so all of them keep playing during the whole test. */
+			for (uint channel = 0; channel < 8; channel++) {
+				size_t size = SAMPLES * BUFFERS * 2 * (is16bit ? 2 : 1);
+				auto memory = std::make_shared<std::vector<int8_t>>(size + 2);
+				for (size_t i = 0; i < size; i++) (*memory)[i] = (int8_t)(i * 7 + channel);
+
+				MixerChannel *mc = MxAllocateChannel();
+				REQUIRE(mc != nullptr);
+				MxSetChannelRawSrc(mc, memory, size, rate, is16bit);
+				MxSetChannelVolume(mc, 128 * 255, channel / 8.0f);
+				MxActivateChannel(mc);
+			}
+
+			std::vector<int16_t> buffer(SAMPLES * 2);
+			int64_t sum = 0;
+			auto start = std::chrono::steady_clock::now();
+			for (uint i = 0; i < BUFFERS; i++) {
+				std::fill(buffer.begin(), buffer.end(), 0);
+				MxMixSamples(buffer.data(), SAMPLES);
+				sum += buffer[i % buffer.size()];
+			}
+			auto end = std::chrono::steady_clock::now();
+
+			WARN((is16bit ? "16" : "8") << " bit at " << rate << " Hz, 8 channels: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us for " << BUFFERS << " buffers of " << SAMPLES << " samples (" << sum << ")");
+
+			MxCloseAllChannels();
+			MxMixSamples(buffer.data(), 1);
+		}
+	}
+}
@@ -0,0 +1,111 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file nodelist.cpp Test functionality of the pooled heap node list. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../core/format.hpp"
+#include "../core/random_func.hpp"
+#include "../pathfinder/yapf/nodelist.hpp"
+
+#include "../safeguards.h"
+
+/** Minimal node for testing the node list. */
+struct TestNode {
+	struct Key {
+		int id;
+		inline int CalcHash() const { return id; }
+		inline bool operator==(const Key &other) const { return id == other.id; }
+	};
+
+	Key m_key;
+	int m_estimate;
+
+	inline const Key &GetKey() const { return m_key; }
+	inline int GetCostEstimate() const { return m_estimate; }
+	inline bool operator<(const TestNode &other) const { return m_estimate < other.m_estimate; }
+};
+
+using TestNodeList = CNodeList_PooledHeapT<TestNode, 4, 4>;
+
+static void AddNode(TestNodeList &list, int id, int estimate)
+{
+	TestNode &node = *list.CreateNewNode();
+	node.m_key.id = id;
+	node.m_estimate = estimate;
+
+	TestNode *open = list.FindOpenNode(node.m_key);
+	if (open == nullptr) {
+		list.InsertOpenNode(node);
+	} else if (estimate < open->m_estimate) {
+		/* Same as CYapfBaseT::AddNewNode, reuse the node that is already open. */
+		list.PopOpenNode(node.m_key);
+		*open = node;
+		list.InsertOpenNode(*open);
+	}
+}
+
+TEST_CASE("PooledHeap - best node order")
+{
+	TestNodeList list;
+	std::map<int, int> expected; // id -> estimate of the open nodes
+
+	/* Plenty of duplicate ids to get updates. */
+	Randomizer random;
+	random.SetSeed(12345);
+
+	for (int i = 0; i < 2000; i++) {
+		int id = random.Next() % 500;
+		int estimate = random.Next() % 1000;
+		if (list.FindClosedNode(TestNode::Key{id}) != nullptr) continue;
+		AddNode(list, id, estimate);
+		auto it = expected.find(id);
+		if (it == expected.end()) {
+			expected[id] = estimate;
+		} else {
+			it->second = std::min(it->second, estimate);
+		}
+	}
+	CHECK(list.OpenCount() == static_cast<int>(expected.size()));
+
+	int last = -1;
+	while (TestNode *best = list.GetBestOpenNode()) {
+		int min_estimate = INT_MAX;
+		for (const auto &[id, estimate] : expected) min_estimate = std::min(min_estimate, estimate);
+
+		CHECK(best->m_estimate == min_estimate);
+		CHECK(expected[best->m_key.id] == best->m_estimate);
+		CHECK(best->m_estimate >= last);
+		last = best->m_estimate;
+
+		list.PopOpenNode(best->GetKey());
+		list.InsertClosedNode(*best);
+		expected.erase(best->m_key.id);
+	}
+	CHECK(expected.empty());
+	CHECK(list.OpenCount() == 0);
+}
+
+TEST_CASE("PooledHeap - hash set removal")
+{
+	TestNodeList list;
+	for (int id = 0; id < 1000; id++) AddNode(list, id, id);
+
+	/* Remove every third node from the middle of the open list. */
+	for (int id = 0; id < 1000; id += 3) list.PopOpenNode(TestNode::Key{id});
+
+	for (int id = 0; id < 1000; id++) {
+		CHECK((list.FindOpenNode(TestNode::Key{id}) != nullptr) == (id % 3 != 0));
+	}
+
+	TestNode *best = list.PopBestOpenNode();
+	REQUIRE(best != nullptr);
+	CHECK(best->m_key.id == 1);
+}
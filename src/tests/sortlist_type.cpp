@@ -0,0 +1,126 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file sortlist_type.cpp Test functionality of the incremental sorting of GUIList. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../core/random_func.hpp"
+#include "../sortlist_type.h"
+
+#include "../safeguards.h"
+
+using TestList = GUIList<int>;
+
+static bool TestSorter(const int &a, const int &b)
+{
+	return a < b;
+}
+
+static TestList::SortFunction * const _test_sorter_funcs[] = { &TestSorter };
+
+/**
+ * Make a sorted list of the numbers 0 to \a count - 1, times two.
+ * @param count The number of items.
+ * @param desc Whether to sort descending.
+ * @return The list.
+ */
+static TestList MakeSortedList(int count, bool desc)
+{
+	TestList list;
+	list.SetSortFuncs(_test_sorter_funcs);
+	list.SetListing({ desc, 0 });
+	for (int i = 0; i < count; i++) list.push_back(i * 2);
+	list.ForceResort();
+	list.Sort();
+	return list;
+}
+
+/**
+ * Check whether a list is sorted by its sort direction.
+ * @param list The list to check.
+ * @return true iff the list is sorted.
+ */
+static bool IsTestListSorted(const TestList &list)
+{
+	if (list.IsDescSortOrder()) return std::is_sorted(list.rbegin(), list.rend());
+	return std::is_sorted(list.begin(), list.end());
+}
+
+TEST_CASE("GUIList - resort with changed items")
+{
+	Randomizer random;
+	random.SetSeed(4321);
+
+	for (bool desc : { false, true }) {
+		for (int changes : { 0, 1, 5, 50, 500 }) {
+			TestList list = MakeSortedList(200, desc);
+			for (int i = 0; i < changes; i++) list[random.Next() % list.size()] = random.Next() % 400;
+			std::vector<int> expected(list.begin(), list.end());
+
+			list.ForceResort();
+			CHECK(list.Sort());
+			CHECK(IsTestListSorted(list));
+
+			std::vector<int> sorted(list.begin(), list.end());
+			std::sort(sorted.begin(), sorted.end());
+			std::sort(expected.begin(), expected.end());
+			CHECK(sorted == expected);
+		}
+	}
+}
+
+TEST_CASE("GUIList - insert, remove and update")
+{
+	for (bool desc : { false, true }) {
+		TestList list = MakeSortedList(50, desc);
+
+		list.Insert(31);
+		list.Insert(-1);
+		list.Insert(1000);
+		CHECK(list.size() == 53);
+		CHECK(IsTestListSorted(list));
+
+		CHECK(list.Remove(31));
+		CHECK_FALSE(list.Remove(31));
+		CHECK(list.size() == 52);
+		CHECK(IsTestListSorted(list));
+
+		/* Change an item's value in place, as a changed sort value would. */
+		auto it = std::find(list.begin(), list.end(), 10);
+		*it = 55;
+		CHECK(list.Update(*it));
+		CHECK(IsTestListSorted(list));
+		CHECK_FALSE(list.Update(12345));
+
+		/* With a resort pending items are just added. */
+		list.ForceResort();
+		list.Insert(-5);
+		CHECK(list.back() == -5);
+		list.Sort();
+		CHECK(IsTestListSorted(list));
+	}
+}
+
+TEST_CASE("GUIList - restore order after rebuild")
+{
+	TestList list = MakeSortedList(10, true);
+	std::vector<int> previous(list.begin(), list.end());
+
+	/* Rebuild in another order, without 6 and with 7 and 9. */
+	list.clear();
+	for (int i : { 0, 2, 4, 7, 8, 10, 12, 14, 16, 18, 9 }) list.push_back(i);
+	list.RestoreOrder(previous, [](const int &i) { return i; });
+
+	CHECK(list == std::vector<int>({ 18, 16, 14, 12, 10, 8, 4, 2, 0, 7, 9 }));
+
+	list.ForceResort();
+	list.Sort();
+	CHECK(list == std::vector<int>({ 18, 16, 14, 12, 10, 9, 8, 7, 4, 2, 0 }));
+}
@@ -0,0 +1,113 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file viewport_sprite_sorter.cpp Test that the parent sprite sorters sort exactly the same. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../core/random_func.hpp"
+#include "../viewport_sprite_sorter.h"
+
+#include <chrono>
+
+#include "../safeguards.h"
+
+/**
+ * Make the parent sprites of a dense city, in the order the viewport adds them:
+ * tile by tile along the diagonal rows, with some buildings, foundations,
+ * vehicles crossing the tile edges and odd bounding boxes with min > max.
+ * @param size Number of tiles along both axes.
+ * @param[out] sprites The parent sprites.
+ */
+static void MakeTestScene(int size, std::vector<ParentSpriteToDraw> &sprites)
+{
+	Randomizer random;
+	random.SetSeed(size);
+
+	auto add = [&sprites](int32_t xmin, int32_t ymin, int32_t zmin, int32_t xmax, int32_t ymax, int32_t zmax) {
+		ParentSpriteToDraw &ps = sprites.emplace_back();
+		ps.xmin = xmin;
+		ps.ymin = ymin;
+		ps.zmin = zmin;
+		ps.xmax = xmax;
+		ps.ymax = ymax;
+		ps.zmax = zmax;
+		ps.x = (ymin - xmin) * 2;
+		ps.y = xmin + ymin - zmin;
+		ps.first_child = -1;
+	};
+
+	sprites.clear();
+	for (int sum = 0; sum < size * 2 - 1; sum++) {
+		for (int tx = std::max(0, sum - size + 1); tx <= std::min(sum, size - 1); tx++) {
+			int ty = sum - tx;
+			int32_t x = tx * 16;
+			int32_t y = ty * 16;
+			int32_t z = (random.Next() % 4) * 8;
+
+			if (random.Next() % 4 == 0) add(x, y, z, x + 15, y + 15, z + 7);
+			for (uint buildings = random.Next() % 3; buildings > 0; buildings--) {
+				int32_t ox = random.Next() % 8;
+				int32_t oy = random.Next() % 8;
+				add(x + ox, y + oy, z, x + ox + 1 + random.Next() % (15 - ox), y + oy + 1 + random.Next() % (15 - oy), z + random.Next() % 120);
+			}
+			if (random.Next() % 3 == 0) {
+				int32_t vx = x + random.Next() % 16;
+				int32_t vy = y + random.Next() % 16;
+				add(vx, vy, z, vx + 2 + random.Next() % 12, vy + 2 + random.Next() % 12, z + 6);
+			}
+			if (random.Next() % 50 == 0) add(x + 15, y + 15, z, x, y, z + 10);
+		}
+	}
+}
+
+/**
+ * Sort the sprites of a scene.
+ * @param sprites The parent sprites, in the order they were added.
+ * @param sorter The sorter to use.
+ * @return The indices of the sprites in the sorted order.
+ */
+static std::vector<size_t> SortTestScene(std::vector<ParentSpriteToDraw> &sprites, VpSpriteSorter sorter)
+{
+	ParentSpriteToSortVector to_sort;
+	for (ParentSpriteToDraw &ps : sprites) to_sort.push_back(&ps);
+	sorter(&to_sort);
+
+	std::vector<size_t> order;
+	for (const ParentSpriteToDraw *ps : to_sort) order.push_back(ps - sprites.data());
+	return order;
+}
+
+TEST_CASE("SpriteSorter - bucket sorter sorts the same")
+{
+	std::vector<ParentSpriteToDraw> sprites;
+	for (int size : { 1, 2, 5, 16, 64 }) {
+		MakeTestScene(size, sprites);
+		INFO("scene of " << size << " tiles, " << sprites.size() << " sprites");
+		CHECK(SortTestScene(sprites, &ViewportSortParentSpritesBucket) == SortTestScene(sprites, &ViewportSortParentSprites));
+	}
+}
+
+TEST_CASE("SpriteSorter - bucket sorter speed", "[.benchmark]")
+{
+	std::vector<ParentSpriteToDraw> sprites;
+	for (int size : { 32, 128, 256 }) {
+		MakeTestScene(size, sprites);
+
+		auto time = [&sprites](VpSpriteSorter sorter) {
+			auto start = std::chrono::steady_clock::now();
+			SortTestScene(sprites, sorter);
+			return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+		};
+
+		auto original_time = time(&ViewportSortParentSprites);
+		auto bucket_time = time(&ViewportSortParentSpritesBucket);
+		WARN(sprites.size() << " sprites: original " << original_time << " us, bucket " << bucket_time << " us");
+	}
+}
@@ -0,0 +1,135 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file water_regions.cpp Test the connectivity of the water region patches. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../bridge_map.h"
+#include "../map_func.h"
+#include "../ship.h"
+#include "../water_map.h"
+#include "../pathfinder/follow_track.hpp"
+#include "../pathfinder/water_regions.h"
+
+#include "../safeguards.h"
+
+/**
+ * Check whether a patch is listed as neighbour of another patch.
+ * @param from The patch to look at the neighbours of.
+ * @param to The patch to look for.
+ * @return True iff \a to can be reached from \a from.
+ */
+static bool IsNeighbourPatch(const WaterRegionPatchDesc &from, const WaterRegionPatchDesc &to)
+{
+	bool found = false;
+	VisitWaterRegionPatchNeighbors(from, [&](const WaterRegionPatchDesc &neighbour) { if (neighbour == to) found = true; });
+	return found;
+}
+
+/**
+ * Check that every step the ship track follower can make, which is what the
+ * patches used to be labelled with, stays within a patch or leads to a neighbour.
+ */
+static void CheckPatchesFollowShipTracks()
+{
+	for (TileIndex tile = 0; tile < Map::Size(); tile++) {
+		const TrackdirBits dirs = TrackBitsToTrackdirBits(TrackStatusToTrackBits(GetTileTrackStatus(tile, TRANSPORT_WATER, 0)));
+		for (const Trackdir dir : SetTrackdirBitIterator(dirs)) {
+			CFollowTrackWater ft;
+			if (!ft.Follow(tile, dir)) continue;
+
+			const WaterRegionPatchDesc from = GetWaterRegionPatchInfo(tile);
+			const WaterRegionPatchDesc to = GetWaterRegionPatchInfo(ft.m_new_tile);
+			INFO("from tile " << TileX(tile) << "x" << TileY(tile) << " to " << TileX(ft.m_new_tile) << "x" << TileY(ft.m_new_tile));
+			CHECK(from.label != INVALID_WATER_REGION_PATCH);
+			CHECK(to.label != INVALID_WATER_REGION_PATCH);
+			CHECK((from == to || IsNeighbourPatch(from, to)));
+		}
+	}
+}
+
+/**
+ * Build a ship depot.
+ * @param x The X coordinate of the northern part.
+ * @param y The Y coordinate of the northern part.
+ * @param axis The axis of the depot.
+ */
+static void MakeTestShipDepot(uint x, uint y, Axis axis)
+{
+	const TileIndex north = TileXY(x, y);
+	MakeShipDepot(north, OWNER_NONE, 0, DEPOT_PART_NORTH, axis, WATER_CLASS_SEA);
+	MakeShipDepot(north + (axis == AXIS_X ? TileDiffXY(1, 0) : TileDiffXY(0, 1)), OWNER_NONE, 0, DEPOT_PART_SOUTH, axis, WATER_CLASS_SEA);
+}
+
+TEST_CASE("WaterRegions - ship depots")
+{
+	Map::Allocate(64, 64);
+
+	/* A depot along X in a row of sea within one region; the sea next to its long side is not connected. */
+	for (uint x = 2; x < 8; x++) MakeSea(TileXY(x, 5));
+	MakeTestShipDepot(4, 5, AXIS_X);
+	MakeSea(TileXY(4, 6));
+
+	/* Depots along both axes on the edges between regions. */
+	MakeSea(TileXY(14, 40));
+	MakeTestShipDepot(15, 40, AXIS_X);
+	MakeSea(TileXY(17, 40));
+	MakeSea(TileXY(15, 41));
+
+	MakeSea(TileXY(40, 14));
+	MakeTestShipDepot(40, 15, AXIS_Y);
+	MakeSea(TileXY(40, 17));
+
+	CHECK(GetWaterRegionPatchInfo(TileXY(2, 5)) == GetWaterRegionPatchInfo(TileXY(4, 5)));
+	CHECK(GetWaterRegionPatchInfo(TileXY(2, 5)) == GetWaterRegionPatchInfo(TileXY(5, 5)));
+	CHECK(GetWaterRegionPatchInfo(TileXY(2, 5)) == GetWaterRegionPatchInfo(TileXY(7, 5)));
+	CHECK(GetWaterRegionPatchInfo(TileXY(4, 6)) != GetWaterRegionPatchInfo(TileXY(4, 5)));
+
+	CHECK(GetWaterRegionPatchInfo(TileXY(14, 40)) == GetWaterRegionPatchInfo(TileXY(15, 40)));
+	CHECK(GetWaterRegionPatchInfo(TileXY(15, 41)) != GetWaterRegionPatchInfo(TileXY(15, 40)));
+	CHECK(IsNeighbourPatch(GetWaterRegionPatchInfo(TileXY(14, 40)), GetWaterRegionPatchInfo(TileXY(17, 40))));
+	CHECK(IsNeighbourPatch(GetWaterRegionPatchInfo(TileXY(17, 40)), GetWaterRegionPatchInfo(TileXY(14, 40))));
+	CHECK_FALSE(IsNeighbourPatch(GetWaterRegionPatchInfo(TileXY(15, 41)), GetWaterRegionPatchInfo(TileXY(16, 40))));
+
+	CHECK(IsNeighbourPatch(GetWaterRegionPatchInfo(TileXY(40, 14)), GetWaterRegionPatchInfo(TileXY(40, 17))));
+	CHECK(IsNeighbourPatch(GetWaterRegionPatchInfo(TileXY(40, 17)), GetWaterRegionPatchInfo(TileXY(40, 14))));
+
+	CheckPatchesFollowShipTracks();
+}
+
+TEST_CASE("WaterRegions - aqueducts")
+{
+	Map::Allocate(64, 64);
+
+	/* An aqueduct within one region; the sea below it can't enter the head from the front. */
+	MakeSea(TileXY(18, 5));
+	MakeAqueductBridgeRamp(TileXY(19, 5), OWNER_NONE, DIAGDIR_SW);
+	MakeSea(TileXY(20, 5));
+	MakeAqueductBridgeRamp(TileXY(23, 5), OWNER_NONE, DIAGDIR_NE);
+	MakeSea(TileXY(24, 5));
+
+	/* An aqueduct from one region into another one. */
+	MakeSea(TileXY(29, 10));
+	MakeAqueductBridgeRamp(TileXY(30, 10), OWNER_NONE, DIAGDIR_SW);
+	MakeAqueductBridgeRamp(TileXY(34, 10), OWNER_NONE, DIAGDIR_NE);
+	MakeSea(TileXY(35, 10));
+
+	CHECK(GetWaterRegionPatchInfo(TileXY(18, 5)) == GetWaterRegionPatchInfo(TileXY(19, 5)));
+	CHECK(GetWaterRegionPatchInfo(TileXY(18, 5)) == GetWaterRegionPatchInfo(TileXY(23, 5)));
+	CHECK(GetWaterRegionPatchInfo(TileXY(18, 5)) == GetWaterRegionPatchInfo(TileXY(24, 5)));
+	CHECK(GetWaterRegionPatchInfo(TileXY(20, 5)) != GetWaterRegionPatchInfo(TileXY(19, 5)));
+
+	CHECK(GetWaterRegionPatchInfo(TileXY(29, 10)) == GetWaterRegionPatchInfo(TileXY(30, 10)));
+	CHECK(GetWaterRegionPatchInfo(TileXY(34, 10)) == GetWaterRegionPatchInfo(TileXY(35, 10)));
+	CHECK(IsNeighbourPatch(GetWaterRegionPatchInfo(TileXY(29, 10)), GetWaterRegionPatchInfo(TileXY(35, 10))));
+	CHECK(IsNeighbourPatch(GetWaterRegionPatchInfo(TileXY(35, 10)), GetWaterRegionPatchInfo(TileXY(29, 10))));
+
+	CheckPatchesFollowShipTracks();
+}
@@ -13,6 +13,7 @@
 #include "genworld.h"
 #include "core/random_func.hpp"
 #include "landscape_type.h"
+#include "task_pool.h"
 
 #include "safeguards.h"
 
@@ -227,12 +228,12 @@ static Height TGPGetMaxHeight()
 	 * around the mountain to build on. On a 4096x4096 map, it won't cover any major part of the map.
 	 */
 	static const int max_height[5][MAX_MAP_SIZE_BITS - MIN_MAP_SIZE_BITS + 1] = {
-		/* 64  128  256  512 1024 2048 4096 */
-		{   3,   3,   3,   3,   4,   5,   7 }, ///< Very flat
-		{   5,   7,   8,   9,  14,  19,  31 }, ///< Flat
-		{   8,   9,  10,  15,  23,  37,  61 }, ///< Hilly
-		{  10,  11,  17,  19,  49,  63,  73 }, ///< Mountainous
-		{  12,  19,  25,  31,  67,  75,  87 }, ///< Alpinist
+		/* 64  128  256  512 1024 2048 4096 8192 */
+		{   3,   3,   3,   3,   4,   5,   7,   9 }, ///< Very flat
+		{   5,   7,   8,   9,  14,  19,  31,  41 }, ///< Flat
+		{   8,   9,  10,  15,  23,  37,  61,  79 }, ///< Hilly
+		{  10,  11,  17,  19,  49,  63,  73,  89 }, ///< Mountainous
+		{  12,  19,  25,  31,  67,  75,  87, 103 }, ///< Alpinist
 	};
 
 	int map_size_bucket = std::min(Map::LogX(), Map::LogY()) - MIN_MAP_SIZE_BITS;
@@ -338,6 +339,21 @@ static inline void FreeHeightMap()
 	_height_map.h.clear();
 }
 
+/** Number of rows (or columns) of the height map a task of a parallel pass processes. */
+static const int HEIGHT_MAP_BAND_SIZE = 64;
+
+/**
+ * Run a pass over the height map in bands of rows on the task workers. The
+ * pass may only change the cells of its own rows and may not draw random
+ * numbers, so the result is the same as running it over all rows at once.
+ * @param count Number of rows; the pass decides what a row is.
+ * @param pass Function processing the rows from its first parameter up to, but not including, its second.
+ */
+static void HeightMapForRows(int count, const std::function<void(uint, uint)> &pass)
+{
+	RunInBands(TaskCategory::WorldGen, count, HEIGHT_MAP_BAND_SIZE, pass);
+}
+
 /**
  * Generates new random height in given amplitude (generated numbers will range from - amplitude to + amplitude)
  * @param rMax Limit of result
@@ -387,26 +403,31 @@ static void HeightMapGenerate()
 
 		/* It is regular iteration round.
 		 * Interpolate height values at odd x, even y tiles */
-		for (int y = 0; y <= _height_map.size_y; y += 2 * step) {
-			for (int x = 0; x <= _height_map.size_x - 2 * step; x += 2 * step) {
-				Height h00 = _height_map.height(x + 0 * step, y);
-				Height h02 = _height_map.height(x + 2 * step, y);
-				Height h01 = (h00 + h02) / 2;
-				_height_map.height(x + 1 * step, y) = h01;
+		HeightMapForRows(_height_map.size_y / (2 * step) + 1, [step](int first, int last) {
+			for (int y = first * 2 * step; y < last * 2 * step; y += 2 * step) {
+				for (int x = 0; x <= _height_map.size_x - 2 * step; x += 2 * step) {
+					Height h00 = _height_map.height(x + 0 * step, y);
+					Height h02 = _height_map.height(x + 2 * step, y);
+					Height h01 = (h00 + h02) / 2;
+					_height_map.height(x + 1 * step, y) = h01;
+				}
 			}
-		}
+		});
 
-		/* Interpolate height values at odd y tiles */
-		for (int y = 0; y <= _height_map.size_y - 2 * step; y += 2 * step) {
-			for (int x = 0; x <= _height_map.size_x; x += step) {
-				Height h00 = _height_map.height(x, y + 0 * step);
-				Height h20 = _height_map.height(x, y + 2 * step);
-				Height h10 = (h00 + h20) / 2;
-				_height_map.height(x, y + 1 * step) = h10;
+		/* Interpolate height values at odd y tiles; these only read the even y tiles. */
+		HeightMapForRows((_height_map.size_y - 2 * step) / (2 * step) + 1, [step](int first, int last) {
+			for (int y = first * 2 * step; y < last * 2 * step; y += 2 * step) {
+				for (int x = 0; x <= _height_map.size_x; x += step) {
+					Height h00 = _height_map.height(x, y + 0 * step);
+					Height h20 = _height_map.height(x, y + 2 * step);
+					Height h10 = (h00 + h20) / 2;
+					_height_map.height(x, y + 1 * step) = h10;
+				}
 			}
-		}
+		});
 
-		/* Add noise for next higher frequency (smaller steps) */
+		/* Add noise for next higher frequency (smaller steps); this draws
+		 * random numbers in a fixed order, so it is not done in parallel. */
 		for (int y = 0; y <= _height_map.size_y; y += step) {
 			for (int x = 0; x <= _height_map.size_x; x += step) {
 				_height_map.height(x, y) += RandomHeight(amplitude);
@@ -452,79 +473,97 @@ static int *HeightMapMakeHistogram(Height h_min, [[maybe_unused]] Height h_max,
 	return hist;
 }
 
-/** Applies sine wave redistribution onto height map */
-static void HeightMapSineTransform(Height h_min, Height h_max)
+/**
+ * Apply the sine wave redistribution to a single height.
+ * @param h The height, at least \a h_min.
+ * @param h_min The lowest height to redistribute.
+ * @param h_max The highest height.
+ * @return The redistributed height.
+ */
+static Height SineTransformHeight(Height h, Height h_min, Height h_max)
 {
-	for (Height &h : _height_map.h) {
-		double fheight;
-
-		if (h < h_min) continue;
-
-		/* Transform height into 0..1 space */
-		fheight = (double)(h - h_min) / (double)(h_max - h_min);
-		/* Apply sine transform depending on landscape type */
-		switch (_settings_game.game_creation.landscape) {
-			case LT_TOYLAND:
-			case LT_TEMPERATE:
-				/* Move and scale 0..1 into -1..+1 */
-				fheight = 2 * fheight - 1;
-				/* Sine transform */
-				fheight = sin(fheight * M_PI_2);
-				/* Transform it back from -1..1 into 0..1 space */
-				fheight = 0.5 * (fheight + 1);
-				break;
-
-			case LT_ARCTIC:
-				{
-					/* Arctic terrain needs special height distribution.
-					 * Redistribute heights to have more tiles at highest (75%..100%) range */
-					double sine_upper_limit = 0.75;
-					double linear_compression = 2;
-					if (fheight >= sine_upper_limit) {
-						/* Over the limit we do linear compression up */
-						fheight = 1.0 - (1.0 - fheight) / linear_compression;
-					} else {
-						double m = 1.0 - (1.0 - sine_upper_limit) / linear_compression;
-						/* Get 0..sine_upper_limit into -1..1 */
-						fheight = 2.0 * fheight / sine_upper_limit - 1.0;
-						/* Sine wave transform */
-						fheight = sin(fheight * M_PI_2);
-						/* Get -1..1 back to 0..(1 - (1 - sine_upper_limit) / linear_compression) == 0.0..m */
-						fheight = 0.5 * (fheight + 1.0) * m;
-					}
+	double fheight;
+
+	/* Transform height into 0..1 space */
+	fheight = (double)(h - h_min) / (double)(h_max - h_min);
+	/* Apply sine transform depending on landscape type */
+	switch (_settings_game.game_creation.landscape) {
+		case LT_TOYLAND:
+		case LT_TEMPERATE:
+			/* Move and scale 0..1 into -1..+1 */
+			fheight = 2 * fheight - 1;
+			/* Sine transform */
+			fheight = sin(fheight * M_PI_2);
+			/* Transform it back from -1..1 into 0..1 space */
+			fheight = 0.5 * (fheight + 1);
+			break;
+
+		case LT_ARCTIC:
+			{
+				/* Arctic terrain needs special height distribution.
+				 * Redistribute heights to have more tiles at highest (75%..100%) range */
+				double sine_upper_limit = 0.75;
+				double linear_compression = 2;
+				if (fheight >= sine_upper_limit) {
+					/* Over the limit we do linear compression up */
+					fheight = 1.0 - (1.0 - fheight) / linear_compression;
+				} else {
+					double m = 1.0 - (1.0 - sine_upper_limit) / linear_compression;
+					/* Get 0..sine_upper_limit into -1..1 */
+					fheight = 2.0 * fheight / sine_upper_limit - 1.0;
+					/* Sine wave transform */
+					fheight = sin(fheight * M_PI_2);
+					/* Get -1..1 back to 0..(1 - (1 - sine_upper_limit) / linear_compression) == 0.0..m */
+					fheight = 0.5 * (fheight + 1.0) * m;
 				}
-				break;
-
-			case LT_TROPIC:
-				{
-					/* Desert terrain needs special height distribution.
-					 * Half of tiles should be at lowest (0..25%) heights */
-					double sine_lower_limit = 0.5;
-					double linear_compression = 2;
-					if (fheight <= sine_lower_limit) {
-						/* Under the limit we do linear compression down */
-						fheight = fheight / linear_compression;
-					} else {
-						double m = sine_lower_limit / linear_compression;
-						/* Get sine_lower_limit..1 into -1..1 */
-						fheight = 2.0 * ((fheight - sine_lower_limit) / (1.0 - sine_lower_limit)) - 1.0;
-						/* Sine wave transform */
-						fheight = sin(fheight * M_PI_2);
-						/* Get -1..1 back to (sine_lower_limit / linear_compression)..1.0 */
-						fheight = 0.5 * ((1.0 - m) * fheight + (1.0 + m));
-					}
+			}
+			break;
+
+		case LT_TROPIC:
+			{
+				/* Desert terrain needs special height distribution.
+				 * Half of tiles should be at lowest (0..25%) heights */
+				double sine_lower_limit = 0.5;
+				double linear_compression = 2;
+				if (fheight <= sine_lower_limit) {
+					/* Under the limit we do linear compression down */
+					fheight = fheight / linear_compression;
+				} else {
+					double m = sine_lower_limit / linear_compression;
+					/* Get sine_lower_limit..1 into -1..1 */
+					fheight = 2.0 * ((fheight - sine_lower_limit) / (1.0 - sine_lower_limit)) - 1.0;
+					/* Sine wave transform */
+					fheight = sin(fheight * M_PI_2);
+					/* Get -1..1 back to (sine_lower_limit / linear_compression)..1.0 */
+					fheight = 0.5 * ((1.0 - m) * fheight + (1.0 + m));
 				}
-				break;
+			}
+			break;
 
-			default:
-				NOT_REACHED();
-				break;
-		}
-		/* Transform it back into h_min..h_max space */
-		h = (Height)(fheight * (h_max - h_min) + h_min);
-		if (h < 0) h = I2H(0);
-		if (h >= h_max) h = h_max - 1;
+		default:
+			NOT_REACHED();
+			break;
 	}
+	/* Transform it back into h_min..h_max space */
+	h = (Height)(fheight * (h_max - h_min) + h_min);
+	if (h < 0) h = I2H(0);
+	if (h >= h_max) h = h_max - 1;
+	return h;
+}
+
+/** Applies sine wave redistribution onto height map */
+static void HeightMapSineTransform(Height h_min, Height h_max)
+{
+	/* The heights only take a few thousand values, so transform every value once. */
+	std::vector<Height> table(std::max(h_max - h_min + 1, 0));
+	for (int i = 0; i < (int)table.size(); i++) table[i] = SineTransformHeight(h_min + i, h_min, h_max);
+
+	HeightMapForRows(_height_map.size_y + 1, [h_min, h_max, &table](int first, int last) {
+		for (Height &h : std::span(_height_map.h).subspan(first * _height_map.dim_x, (last - first) * _height_map.dim_x)) {
+			if (h < h_min) continue;
+			h = (h <= h_max) ? table[h - h_min] : SineTransformHeight(h, h_min, h_max);
+		}
+	});
 }
 
 /**
@@ -572,9 +611,6 @@ static void HeightMapCurves(uint level)
 		{ lengthof(curve_map_4), curve_map_4 },
 	};
 
-	Height ht[lengthof(curve_maps)];
-	MemSetT(ht, 0, lengthof(ht));
-
 	/* Set up a grid to choose curve maps based on location; attempt to get a somewhat square grid */
 	float factor = sqrt((float)_height_map.size_x / (float)_height_map.size_y);
 	uint sx = Clamp((int)(((1 << level) * factor) + 0.5), 1, 128);
@@ -585,90 +621,101 @@ static void HeightMapCurves(uint level)
 		c[i] = Random() % lengthof(curve_maps);
 	}
 
-	/* Apply curves */
-	for (int x = 0; x < _height_map.size_x; x++) {
-
-		/* Get our X grid positions and bi-linear ratio */
-		float fx = (float)(sx * x) / _height_map.size_x + 1.0f;
-		uint x1 = (uint)fx;
-		uint x2 = x1;
-		float xr = 2.0f * (fx - x1) - 1.0f;
-		xr = sin(xr * M_PI_2);
-		xr = sin(xr * M_PI_2);
-		xr = 0.5f * (xr + 1.0f);
-		float xri = 1.0f - xr;
-
-		if (x1 > 0) {
-			x1--;
-			if (x2 >= sx) x2--;
+	/* Every curve map applied to every height above sea level it is defined for. */
+	std::vector<Height> curve_tables[lengthof(curve_maps)];
+	for (uint t = 0; t < lengthof(curve_maps); t++) {
+		const ControlPoint *cm = curve_maps[t].list;
+		curve_tables[t].resize(std::max<int>(cm[curve_maps[t].length - 1].x, 0));
+		for (Height h = 0; h < (int)curve_tables[t].size(); h++) {
+			for (uint i = 0; i < curve_maps[t].length - 1; i++) {
+				const ControlPoint &p1 = cm[i];
+				const ControlPoint &p2 = cm[i + 1];
+
+				if (h >= p1.x && h < p2.x) {
+					curve_tables[t][h] = p1.y + (h - p1.x) * (p2.y - p1.y) / (p2.x - p1.x);
+					break;
+				}
+			}
 		}
+	}
 
-		for (int y = 0; y < _height_map.size_y; y++) {
-
-			/* Get our Y grid position and bi-linear ratio */
-			float fy = (float)(sy * y) / _height_map.size_y + 1.0f;
-			uint y1 = (uint)fy;
-			uint y2 = y1;
-			float yr = 2.0f * (fy - y1) - 1.0f;
-			yr = sin(yr * M_PI_2);
-			yr = sin(yr * M_PI_2);
-			yr = 0.5f * (yr + 1.0f);
-			float yri = 1.0f - yr;
-
-			if (y1 > 0) {
-				y1--;
-				if (y2 >= sy) y2--;
-			}
+	/** Position in the grid and bi-linear ratio of a row or column. */
+	struct GridPosition {
+		uint p1;  ///< First grid position.
+		uint p2;  ///< Second grid position.
+		float r;  ///< Ratio of the second grid position.
+		float ri; ///< Ratio of the first grid position.
+	};
+	auto get_grid_position = [](uint s, int i, int size) {
+		float f = (float)(s * i) / size + 1.0f;
+		GridPosition pos;
+		pos.p1 = (uint)f;
+		pos.p2 = pos.p1;
+		pos.r = 2.0f * (f - pos.p1) - 1.0f;
+		pos.r = sin(pos.r * M_PI_2);
+		pos.r = sin(pos.r * M_PI_2);
+		pos.r = 0.5f * (pos.r + 1.0f);
+		pos.ri = 1.0f - pos.r;
+
+		if (pos.p1 > 0) {
+			pos.p1--;
+			if (pos.p2 >= s) pos.p2--;
+		}
+		return pos;
+	};
+
+	/* The Y grid positions are the same for all columns. */
+	std::vector<GridPosition> rows(_height_map.size_y);
+	for (int y = 0; y < _height_map.size_y; y++) rows[y] = get_grid_position(sy, y, _height_map.size_y);
+
+	/* Apply curves; every tile only depends on its own height and location. */
+	HeightMapForRows(_height_map.size_x, [&](int first, int last) {
+		Height ht[lengthof(curve_maps)];
+		MemSetT(ht, 0, lengthof(ht));
+
+		for (int x = first; x < last; x++) {
+			const GridPosition col = get_grid_position(sx, x, _height_map.size_x);
 
-			uint corner_a = c[x1 + sx * y1];
-			uint corner_b = c[x1 + sx * y2];
-			uint corner_c = c[x2 + sx * y1];
-			uint corner_d = c[x2 + sx * y2];
-
-			/* Bitmask of which curve maps are chosen, so that we do not bother
-			 * calculating a curve which won't be used. */
-			uint corner_bits = 0;
-			corner_bits |= 1 << corner_a;
-			corner_bits |= 1 << corner_b;
-			corner_bits |= 1 << corner_c;
-			corner_bits |= 1 << corner_d;
-
-			Height *h = &_height_map.height(x, y);
-
-			/* Do not touch sea level */
-			if (*h < I2H(1)) continue;
-
-			/* Only scale above sea level */
-			*h -= I2H(1);
-
-			/* Apply all curve maps that are used on this tile. */
-			for (uint t = 0; t < lengthof(curve_maps); t++) {
-				if (!HasBit(corner_bits, t)) continue;
-
-				[[maybe_unused]] bool found = false;
-				const ControlPoint *cm = curve_maps[t].list;
-				for (uint i = 0; i < curve_maps[t].length - 1; i++) {
-					const ControlPoint &p1 = cm[i];
-					const ControlPoint &p2 = cm[i + 1];
-
-					if (*h >= p1.x && *h < p2.x) {
-						ht[t] = p1.y + (*h - p1.x) * (p2.y - p1.y) / (p2.x - p1.x);
-#ifdef WITH_ASSERT
-						found = true;
-#endif
-						break;
-					}
+			for (int y = 0; y < _height_map.size_y; y++) {
+				const GridPosition &row = rows[y];
+
+				uint corner_a = c[col.p1 + sx * row.p1];
+				uint corner_b = c[col.p1 + sx * row.p2];
+				uint corner_c = c[col.p2 + sx * row.p1];
+				uint corner_d = c[col.p2 + sx * row.p2];
+
+				/* Bitmask of which curve maps are chosen, so that we do not bother
+				 * calculating a curve which won't be used. */
+				uint corner_bits = 0;
+				corner_bits |= 1 << corner_a;
+				corner_bits |= 1 << corner_b;
+				corner_bits |= 1 << corner_c;
+				corner_bits |= 1 << corner_d;
+
+				Height *h = &_height_map.height(x, y);
+
+				/* Do not touch sea level */
+				if (*h < I2H(1)) continue;
+
+				/* Only scale above sea level */
+				*h -= I2H(1);
+
+				/* Apply all curve maps that are used on this tile. */
+				for (uint t = 0; t < lengthof(curve_maps); t++) {
+					if (!HasBit(corner_bits, t)) continue;
+
+					assert(*h < (int)curve_tables[t].size());
+					if (*h < (int)curve_tables[t].size()) ht[t] = curve_tables[t][*h];
 				}
-				assert(found);
-			}
 
-			/* Apply interpolation of curve map results. */
-			*h = (Height)((ht[corner_a] * yri + ht[corner_b] * yr) * xri + (ht[corner_c] * yri + ht[corner_d] * yr) * xr);
+				/* Apply interpolation of curve map results. */
+				*h = (Height)((ht[corner_a] * row.ri + ht[corner_b] * row.r) * col.ri + (ht[corner_c] * row.ri + ht[corner_d] * row.r) * col.r);
 
-			/* Readd sea level */
-			*h += I2H(1);
+				/* Readd sea level */
+				*h += I2H(1);
+			}
 		}
-	}
+	});
 }
 
 /** Adjusts heights in height map to contain required amount of water tiles */
@@ -700,13 +747,15 @@ static void HeightMapAdjustWaterLevel(Amplitude water_percent, Height h_max_new)
 	 *   values from range: h_water_level..h_max are transformed into 0..h_max_new
 	 *   where h_max_new is depending on terrain type and map size.
 	 */
-	for (Height &h : _height_map.h) {
-		/* Transform height from range h_water_level..h_max into 0..h_max_new range */
-		h = (Height)(((int)h_max_new) * (h - h_water_level) / (h_max - h_water_level)) + I2H(1);
-		/* Make sure all values are in the proper range (0..h_max_new) */
-		if (h < 0) h = I2H(0);
-		if (h >= h_max_new) h = h_max_new - 1;
-	}
+	HeightMapForRows(_height_map.size_y + 1, [h_water_level, h_max, h_max_new](int first, int last) {
+		for (Height &h : std::span(_height_map.h).subspan(first * _height_map.dim_x, (last - first) * _height_map.dim_x)) {
+			/* Transform height from range h_water_level..h_max into 0..h_max_new range */
+			h = (Height)(((int)h_max_new) * (h - h_water_level) / (h_max - h_water_level)) + I2H(1);
+			/* Make sure all values are in the proper range (0..h_max_new) */
+			if (h < 0) h = I2H(0);
+			if (h >= h_max_new) h = h_max_new - 1;
+		}
+	});
 
 	free(hist_buf);
 }
@@ -13,9 +13,12 @@
 #include "debug.h"
 #include "crashlog.h"
 #include "error_func.h"
+#include "core/math_func.hpp"
+#include "task_pool.h"
 #include <system_error>
 #include <thread>
 #include <mutex>
+#include <span>
 
 /**
  * Sleep on the current thread for a defined time.
@@ -85,4 +88,36 @@ inline bool StartNewThread(std::thread *thr, const char *name, TFn&& _Fx, TArgs&
 	return false;
 }
 
+extern uint8_t _game_loop_threads;
+
+/**
+ * Run a function over a span of items split into consecutive chunks, using up to #_game_loop_threads threads.
+ * The other chunks are handed to the worker pool and the calling thread processes the first chunk itself.
+ * It returns once all chunks are done, running any chunk no worker picked up yet on its own.
+ * The function must only touch state owned by the items of its chunk.
+ * @tparam T Type of the items.
+ * @tparam TFn Type of the function; it is called with a std::span<T> of one chunk.
+ * @param items The items to process.
+ * @param min_chunk_size Minimum number of items worth handing to an extra thread.
+ * @param fn Function to call for each chunk.
+ */
+template <class T, class TFn>
+inline void RunInChunks(std::span<T> items, size_t min_chunk_size, TFn &&fn)
+{
+	size_t chunks = std::min<size_t>(_game_loop_threads, items.size() / min_chunk_size);
+	if (chunks <= 1) {
+		fn(items);
+		return;
+	}
+
+	size_t chunk_size = CeilDiv(items.size(), chunks);
+	std::vector<TaskHandle> tasks;
+	for (size_t start = chunk_size; start < items.size(); start += chunk_size) {
+		std::span<T> chunk = items.subspan(start, std::min(chunk_size, items.size() - start));
+		tasks.push_back(SubmitTask(TaskCategory::GameLoop, [&fn, chunk]() { fn(chunk); }));
+	}
+	fn(items.first(chunk_size));
+	for (TaskHandle &task : tasks) task.Wait();
+}
+
 #endif /* THREAD_H */
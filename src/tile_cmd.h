@@ -174,6 +174,13 @@ struct TileTypeProcs {
 
 extern const TileTypeProcs * const _tile_type_procs[16];
 
+/* The vehicle enter tile procs are called directly, instead of via #_tile_type_procs. */
+VehicleEnterTileProc VehicleEnter_Track;
+VehicleEnterTileProc VehicleEnter_Road;
+VehicleEnterTileProc VehicleEnter_Station;
+VehicleEnterTileProc VehicleEnter_TunnelBridge;
+VehicleEnterTileProc VehicleEnter_Water;
+
 TrackStatus GetTileTrackStatus(TileIndex tile, TransportType mode, uint sub_mode, DiagDirection side = INVALID_DIAGDIR);
 VehicleEnterTileStatus VehicleEnterTile(Vehicle *v, TileIndex tile, int x, int y);
 void ChangeTileOwner(TileIndex tile, Owner old_owner, Owner new_owner);
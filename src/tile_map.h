@@ -44,6 +44,24 @@ inline uint TileHeightOutsideMap(int x, int y)
 	return TileHeight(TileXY(Clamp(x, 0, Map::MaxX()), Clamp(y, 0, Map::MaxY())));
 }
 
+extern uint _tile_loop_sleeping_regions;
+void WakeTileLoopRegions(TileIndex tile);
+extern uint _flood_interior_tiles;
+void ForgetFloodInterior(TileIndex tile);
+void InvalidateRoadRegion(TileIndex tile);
+void InvalidateRailRegion(TileIndex tile);
+void InvalidateSignalBlocks();
+
+/**
+ * Check whether a tile of the given type can be part of a signal block.
+ * @param type The type of the tile.
+ * @return True iff tiles of this type can have rail.
+ */
+inline bool MayHaveRailTrack(TileType type)
+{
+	return type == MP_RAILWAY || type == MP_ROAD || type == MP_STATION || type == MP_TUNNELBRIDGE;
+}
+
 /**
  * Sets the height of a tile.
  *
@@ -59,6 +77,7 @@ inline void SetTileHeight(Tile tile, uint height)
 	assert(tile < Map::Size());
 	assert(height <= MAX_TILE_HEIGHT);
 	tile.height() = height;
+	if (_tile_loop_sleeping_regions != 0) WakeTileLoopRegions(tile);
 }
 
 /**
@@ -135,7 +154,12 @@ inline void SetTileType(Tile tile, TileType type)
 	 * edges of the map. If _settings_game.construction.freeform_edges is true,
 	 * the upper edges of the map are also VOID tiles. */
 	assert(IsInnerTile(tile) == (type != MP_VOID));
+	if (MayHaveRailTrack(type) || MayHaveRailTrack(static_cast<TileType>(GB(tile.type(), 4, 4)))) InvalidateSignalBlocks();
 	SB(tile.type(), 4, 4, type);
+	if (_tile_loop_sleeping_regions != 0) WakeTileLoopRegions(tile);
+	if (_flood_interior_tiles != 0) ForgetFloodInterior(tile);
+	InvalidateRoadRegion(tile);
+	InvalidateRailRegion(tile);
 }
 
 /**
@@ -202,6 +226,7 @@ inline void SetTileOwner(Tile tile, Owner owner)
 	assert(!IsTileType(tile, MP_INDUSTRY));
 
 	SB(tile.m1(), 0, 5, owner);
+	if (MayHaveRailTrack(GetTileType(tile))) InvalidateSignalBlocks();
 }
 
 /**
@@ -31,7 +31,8 @@ public:
 	 * @param period The period of the timer.
 	 */
 	[[nodiscard]] BaseTimer(const TPeriod period) :
-		period(period)
+		period(period),
+		sorted_period(period)
 	{
 		TimerManager<TTimerType>::RegisterTimer(*this);
 	}
@@ -50,6 +51,18 @@ public:
 	TStorage storage = {}; ///< The storage of the timer.
 
 protected:
+	/**
+	 * Change the period of the timer, keeping the timers of the timer manager sorted on their period.
+	 *
+	 * @param period The new period of the timer.
+	 */
+	void ChangePeriod(const TPeriod period)
+	{
+		TimerManager<TTimerType>::UnregisterTimer(*this);
+		this->period = period;
+		TimerManager<TTimerType>::RegisterTimer(*this);
+	}
+
 	/**
 	 * Called by the timer manager to notify the timer that the given amount of time has elapsed.
 	 *
@@ -59,6 +72,9 @@ protected:
 
 	/* To ensure only TimerManager can access Elapsed. */
 	friend class TimerManager<TTimerType>;
+
+private:
+	TPeriod sorted_period; ///< The period the timer manager sorted the timer on; #period may be changed by saveload meanwhile.
 };
 
 /**
@@ -98,7 +114,7 @@ public:
 	 */
 	void SetInterval(const TPeriod interval, bool reset = true)
 	{
-		this->period = interval;
+		this->ChangePeriod(interval);
 		if (reset) this->storage = {};
 	}
 
@@ -150,7 +166,7 @@ public:
 	 */
 	void Reset(const TPeriod timeout)
 	{
-		this->period = timeout;
+		this->ChangePeriod(timeout);
 		this->fired = false;
 		this->storage = {};
 	}
@@ -43,6 +43,7 @@ public:
 #ifdef WITH_ASSERT
 		Validate(timer.period);
 #endif /* WITH_ASSERT */
+		timer.sorted_period = timer.period;
 		GetTimers().insert(&timer);
 	}
 
@@ -87,13 +88,14 @@ private:
 	 * Sorter for timers.
 	 *
 	 * It will sort based on the period, smaller first. If the period is the
-	 * same, it will sort based on the pointer value.
+	 * same, it will sort based on the pointer value. The period the timer had
+	 * when it was registered is used, so a timer can always be found again.
 	 */
 	struct base_timer_sorter {
 		bool operator() (BaseTimer<TTimerType> *a, BaseTimer<TTimerType> *b) const
 		{
-			if (a->period == b->period) return a < b;
-			return a->period < b->period;
+			if (a->sorted_period == b->sorted_period) return a < b;
+			return a->sorted_period < b->sorted_period;
 		}
 	};
 
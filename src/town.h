@@ -31,6 +31,7 @@ static const TownID INVALID_TOWN = 0xFFFF;
 static const uint TOWN_GROWTH_WINTER = 0xFFFFFFFE; ///< The town only needs this cargo in the winter (any amount)
 static const uint TOWN_GROWTH_DESERT = 0xFFFFFFFF; ///< The town needs the cargo for growth when on desert (any amount)
 static const uint16_t TOWN_GROWTH_RATE_NONE = 0xFFFF; ///< Special value for Town::growth_rate to disable town growth.
+static const uint8_t MAX_TOWN_GROWTH_BACKOFF = 4; ///< Max number of times the wait before retrying a failed town growth is doubled.
 static const uint16_t MAX_TOWN_GROWTH_TICKS = 930; ///< Max amount of original town ticks that still fit into uint16_t, about equal to UINT16_MAX / TOWN_GROWTH_TICKS but slightly less to simplify calculations
 
 typedef Pool<Town, TownID, 64, 64000> TownPool;
@@ -88,8 +89,10 @@ struct Town : TownPool::PoolItem<&_town_pool> {
 
 	uint16_t time_until_rebuild;       ///< time until we rebuild a house
 
-	uint16_t grow_counter;             ///< counter to count when to grow, value is smaller than or equal to growth_rate
+	uint16_t grow_counter;             ///< counter to count when to grow, value is smaller than or equal to growth_rate; only up to date while not scheduled, use GetGrowCounter()
+	uint64_t grow_due_tick = 0;        ///< NOSAVE: Tick of the town growth schedule at which the town grows next, or 0 if it is not scheduled.
 	uint16_t growth_rate;              ///< town growth rate
+	uint8_t growth_failures = 0;       ///< number of consecutive failed attempts to grow, to wait longer before retrying
 
 	uint8_t fund_buildings_months;      ///< fund buildings program in action?
 	uint8_t road_build_months;          ///< fund road reconstruction in action?
@@ -127,6 +130,7 @@ struct Town : TownPool::PoolItem<&_town_pool> {
 	}
 
 	void UpdateVirtCoord();
+	uint16_t GetGrowCounter() const;
 
 	inline const std::string &GetCachedName() const
 	{
@@ -155,6 +159,8 @@ void ShowTownViewWindow(TownID town);
 void ExpandTown(Town *t);
 
 void RebuildTownKdtree();
+void RebuildTownGrowthSchedule();
+void SyncTownGrowCounters();
 
 /** Settings for town council attitudes. */
 enum TownCouncilAttitudes {
@@ -201,6 +207,7 @@ CommandCost CheckforTownRating(DoCommandFlag flags, Town *t, TownRatingCheckType
 TileIndexDiff GetHouseNorthPart(HouseID &house);
 
 Town *CalcClosestTownFromTile(TileIndex tile, uint threshold = UINT_MAX);
+void ResetTownGrowthBackoff(TileIndex tile);
 
 void ResetHouses();
 
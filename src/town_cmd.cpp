@@ -18,6 +18,7 @@
 #include "company_func.h"
 #include "industry.h"
 #include "station_base.h"
+#include "thread.h"
 #include "waypoint_base.h"
 #include "station_kdtree.h"
 #include "company_base.h"
@@ -61,6 +62,8 @@
 #include "table/strings.h"
 #include "table/town_land.h"
 
+#include <set>
+
 #include "safeguards.h"
 
 /* Initialize the town-pool */
@@ -79,6 +82,65 @@ void RebuildTownKdtree()
 	_town_kdtree.Build(townids.begin(), townids.end());
 }
 
+/**
+ * Towns that are growing, ordered by the tick at which they grow next and
+ * then by their index, so the towns that grow in the same tick do so in the
+ * same order as when all towns were ticked.
+ */
+static std::set<std::pair<uint64_t, TownID>> _town_growth_schedule;
+static uint64_t _town_growth_tick = 0; ///< Number of town ticks since the game was started or loaded.
+
+/**
+ * Get the counter until the town grows.
+ * @return The number of town ticks until the town tries to grow, minus one.
+ */
+uint16_t Town::GetGrowCounter() const
+{
+	if (this->grow_due_tick == 0) return this->grow_counter;
+	/* Towns that are due but not handled yet in the current tick are still at 0. */
+	return this->grow_due_tick > _town_growth_tick ? static_cast<uint16_t>(this->grow_due_tick - _town_growth_tick - 1) : 0;
+}
+
+/**
+ * Take the town out of the growth schedule, bringing its grow counter up to date.
+ * Must be called before changing the grow counter, growth rate or whether the town is growing.
+ * @param t The town.
+ */
+static void UnscheduleTownGrowth(Town *t)
+{
+	if (t->grow_due_tick == 0) return;
+	t->grow_counter = t->GetGrowCounter();
+	_town_growth_schedule.erase({t->grow_due_tick, t->index});
+	t->grow_due_tick = 0;
+}
+
+/**
+ * Put the town in the growth schedule, if it is growing, based on its current grow counter.
+ * @param t The town.
+ */
+static void ScheduleTownGrowth(Town *t)
+{
+	UnscheduleTownGrowth(t);
+	if (!HasBit(t->flags, TOWN_IS_GROWING)) return;
+
+	t->grow_due_tick = _town_growth_tick + t->grow_counter + 1;
+	_town_growth_schedule.insert({t->grow_due_tick, t->index});
+}
+
+/** Rebuild the growth schedule from the grow counters of all towns, e.g. after loading. */
+void RebuildTownGrowthSchedule()
+{
+	for (Town *t : Town::Iterate()) UnscheduleTownGrowth(t);
+	_town_growth_schedule.clear();
+	for (Town *t : Town::Iterate()) ScheduleTownGrowth(t);
+}
+
+/** Bring the grow counters of all towns up to date, so they can be saved. */
+void SyncTownGrowCounters()
+{
+	for (Town *t : Town::Iterate()) t->grow_counter = t->GetGrowCounter();
+}
+
 
 /**
  * Check if a town 'owns' a bridge.
@@ -109,6 +171,8 @@ Town::~Town()
 {
 	if (CleaningPool()) return;
 
+	UnscheduleTownGrowth(this);
+
 	/* Delete town authority window
 	 * and remove from list of sorted towns */
 	CloseWindowById(WC_TOWN_VIEW, this->index);
@@ -545,6 +609,67 @@ static void TownGenerateCargo(Town *t, CargoID ct, uint amount, StationFinder &s
 	t->supplied[ct].new_act += MoveGoodsToStation(ct, amount, SourceType::Town, t->index, stations.GetStations());;
 }
 
+/** Minimum number of houses worth looking up the stations around on an extra thread. */
+static const size_t MIN_HOUSES_PER_TILE_LOOP_THREAD = 256;
+
+/** The stations around the completed houses of the current tile loop batch, sorted by tile. */
+static std::vector<std::pair<TileIndex, StationList>> _tile_loop_house_stations;
+/** The catchment generation for which #_tile_loop_house_stations were looked up. */
+static uint32_t _tile_loop_house_stations_generation;
+
+/**
+ * Look up the stations around the completed houses of a tile loop batch in
+ * parallel, before the tile loop procs run in order. Unlike the cargo that is
+ * generated, which depends on the random generator and the order of the
+ * tiles, the stations only depend on the catchment areas. If any catchment
+ * changes while the batch is processed, the stations are looked up again.
+ * @param tiles The tiles of the batch.
+ */
+void FindStationsAroundHousesInTileLoop(std::span<const TileIndex> tiles)
+{
+	_tile_loop_house_stations.clear();
+	if (Station::GetNumItems() == 0) return;
+
+	for (TileIndex tile : tiles) {
+		if (IsTileType(tile, MP_HOUSE) && IsHouseCompleted(tile)) _tile_loop_house_stations.emplace_back(tile, StationList{});
+	}
+	if (_tile_loop_house_stations.size() < MIN_HOUSES_PER_TILE_LOOP_THREAD) {
+		_tile_loop_house_stations.clear();
+		return;
+	}
+
+	std::sort(_tile_loop_house_stations.begin(), _tile_loop_house_stations.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+	/* Let a pending reset of the catchment index happen on this thread, not on the workers. */
+	std::vector<StationID> unused;
+	GetStationsWithCatchmentIn(TileArea(_tile_loop_house_stations.front().first, 1, 1), unused);
+
+	RunInChunks(std::span(_tile_loop_house_stations), MIN_HOUSES_PER_TILE_LOOP_THREAD, [](std::span<std::pair<TileIndex, StationList>> chunk) {
+		for (auto &[tile, stations] : chunk) {
+			ForAllStationsAroundTiles(TileArea(tile, 1, 1), [&stations](Station *st, TileIndex) {
+				stations.insert(st);
+				return true;
+			});
+		}
+	});
+	_tile_loop_house_stations_generation = _station_catchment_generation;
+}
+
+/**
+ * Get the station finder for a house in the tile loop, reusing the stations
+ * found by FindStationsAroundHousesInTileLoop() while they are still valid.
+ * @param tile The house tile.
+ * @return The station finder.
+ */
+static StationFinder GetTileLoopHouseStationFinder(TileIndex tile)
+{
+	if (_tile_loop_house_stations_generation == _station_catchment_generation) {
+		auto it = std::lower_bound(_tile_loop_house_stations.begin(), _tile_loop_house_stations.end(), tile, [](const auto &item, TileIndex tile) { return item.first < tile; });
+		if (it != _tile_loop_house_stations.end() && it->first == tile) return StationFinder(std::move(it->second));
+	}
+	return StationFinder(TileArea(tile, 1, 1));
+}
+
 /**
  * Generate cargo for a house using the original algorithm.
  * @param t The current town.
@@ -622,7 +747,7 @@ static void TileLoop_Town(TileIndex tile)
 	Town *t = Town::GetByTile(tile);
 	uint32_t r = Random();
 
-	StationFinder stations(TileArea(tile, 1, 1));
+	StationFinder stations = GetTileLoopHouseStationFinder(tile);
 
 	if (HasBit(hs->callback_mask, CBM_HOUSE_PRODUCE_CARGO)) {
 		for (uint i = 0; i < 256; i++) {
@@ -864,31 +989,58 @@ static void ChangeTileOwner_Town(TileIndex, Owner, Owner)
 static bool GrowTown(Town *t);
 
 /**
- * Handle the town tick for a single town, by growing the town if desired.
- * @param t The town to try growing.
+ * Let the town closest to a tile retry growing at the normal pace, as a road or
+ * house that was built or removed there may have made room for it to grow again.
+ * @param tile The tile that changed.
+ */
+void ResetTownGrowthBackoff(TileIndex tile)
+{
+	Town *t = CalcClosestTownFromTile(tile);
+	if (t != nullptr) t->growth_failures = 0;
+}
+
+/**
+ * Handle the town tick for a single town whose grow counter ran out, by growing the town.
+ * @param t The town to grow.
  */
 static void TownTickHandler(Town *t)
 {
-	if (HasBit(t->flags, TOWN_IS_GROWING)) {
-		int i = (int)t->grow_counter - 1;
-		if (i < 0) {
-			if (GrowTown(t)) {
-				i = t->growth_rate;
-			} else {
-				/* If growth failed wait a bit before retrying */
-				i = std::min<uint16_t>(t->growth_rate, Ticks::TOWN_GROWTH_TICKS - 1);
-			}
+	uint16_t counter;
+	if (GrowTown(t)) {
+		counter = t->growth_rate;
+		t->growth_failures = 0;
+	} else {
+		/* If growth failed wait a bit before retrying */
+		uint wait = Ticks::TOWN_GROWTH_TICKS;
+		if (_settings_game.economy.town_growth_backoff) {
+			/* Towns that keep failing, usually because they are built up completely, wait
+			 * longer each time so they do not keep searching for a place to build in vain. */
+			wait <<= t->growth_failures;
+			if (t->growth_failures < MAX_TOWN_GROWTH_BACKOFF) t->growth_failures++;
 		}
-		t->grow_counter = i;
+		counter = std::min<uint>(t->growth_rate, wait - 1);
 	}
+
+	UnscheduleTownGrowth(t);
+	t->grow_counter = counter;
+	ScheduleTownGrowth(t);
 }
 
-/** Iterate through all towns and call their tick handler. */
+/**
+ * Call the tick handler of the towns that are due to grow. Instead of counting
+ * down the grow counter of every town each tick, the towns are kept in a
+ * schedule ordered by the tick at which their counter runs out.
+ */
 void OnTick_Town()
 {
 	if (_game_mode == GM_EDITOR) return;
 
-	for (Town *t : Town::Iterate()) {
+	_town_growth_tick++;
+	while (!_town_growth_schedule.empty() && _town_growth_schedule.begin()->first <= _town_growth_tick) {
+		Town *t = Town::Get(_town_growth_schedule.begin()->second);
+		_town_growth_schedule.erase(_town_growth_schedule.begin());
+		t->grow_due_tick = 0;
+		t->grow_counter = 0;
 		TownTickHandler(t);
 	}
 }
@@ -2357,9 +2509,6 @@ bool GenerateTowns(TownLayout layout)
 
 	town_names.clear();
 
-	/* Build the town k-d tree again to make sure it's well balanced */
-	RebuildTownKdtree();
-
 	if (current_number != 0) return true;
 
 	/* If current_number is still zero at this point, it means that not a single town has been created.
@@ -2416,6 +2565,7 @@ static inline void ClearMakeHouseTile(TileIndex tile, Town *t, uint8_t counter,
 	IncreaseBuildingCount(t, type);
 	MakeHouseTile(tile, t->index, counter, stage, type, random_bits);
 	if (HouseSpec::Get(type)->building_flags & BUILDING_IS_ANIMATED) AddAnimatedTile(tile);
+	InvalidateStationAcceptanceCache(TileArea(tile, 1, 1));
 
 	MarkTileDirtyByTile(tile);
 }
@@ -2790,6 +2940,10 @@ static void DoClearTownHouseHelper(TileIndex tile, Town *t, HouseID house)
 	DecreaseBuildingCount(t, house);
 	DoClearSquare(tile);
 	DeleteAnimatedTile(tile);
+	InvalidateStationAcceptanceCache(TileArea(tile, 1, 1));
+
+	/* There is room to build again, so retry growing quickly. */
+	t->growth_failures = 0;
 
 	DeleteNewGRFInspectWindow(GSF_HOUSES, tile.base());
 }
@@ -2978,6 +3132,7 @@ CommandCost CmdTownGrowthRate(DoCommandFlag flags, TownID town_id, uint16_t grow
 	if (t == nullptr) return CMD_ERROR;
 
 	if (flags & DC_EXEC) {
+		UnscheduleTownGrowth(t);
 		if (growth_rate == 0) {
 			/* Just clear the flag, UpdateTownGrowth will determine a proper growth rate */
 			ClrBit(t->flags, TOWN_CUSTOM_GROWTH);
@@ -3343,6 +3498,7 @@ static CommandCost TownActionFundBuildings(Town *t, DoCommandFlag flags)
 	if (flags & DC_EXEC) {
 		/* And grow for 3 months */
 		t->fund_buildings_months = 3;
+		t->growth_failures = 0;
 
 		/* Enable growth (also checking GameScript's opinion) */
 		UpdateTownGrowth(t);
@@ -3355,7 +3511,9 @@ static CommandCost TownActionFundBuildings(Town *t, DoCommandFlag flags)
 		 * tick-perfect and gives player some time window where they can
 		 * spam funding with the exact same efficiency.
 		 */
+		UnscheduleTownGrowth(t);
 		t->grow_counter = std::min<uint16_t>(t->grow_counter, 2 * Ticks::TOWN_GROWTH_TICKS - (t->growth_rate - t->grow_counter) % Ticks::TOWN_GROWTH_TICKS);
+		ScheduleTownGrowth(t);
 
 		SetWindowDirty(WC_TOWN_VIEW, t->index);
 	}
@@ -3642,9 +3800,11 @@ static uint GetNormalGrowthRate(Town *t)
 static void UpdateTownGrowthRate(Town *t)
 {
 	if (HasBit(t->flags, TOWN_CUSTOM_GROWTH)) return;
+	UnscheduleTownGrowth(t);
 	uint old_rate = t->growth_rate;
 	t->growth_rate = GetNormalGrowthRate(t);
 	UpdateTownGrowCounter(t, old_rate);
+	ScheduleTownGrowth(t);
 	SetWindowDirty(WC_TOWN_VIEW, t->index);
 }
 
@@ -3652,7 +3812,7 @@ static void UpdateTownGrowthRate(Town *t)
  * Updates town growth state (whether it is growing or not).
  * @param t The town to update growth for
  */
-static void UpdateTownGrowth(Town *t)
+static void UpdateTownGrowthState(Town *t)
 {
 	UpdateTownGrowthRate(t);
 
@@ -3690,6 +3850,17 @@ static void UpdateTownGrowth(Town *t)
 	SetWindowDirty(WC_TOWN_VIEW, t->index);
 }
 
+/**
+ * Updates town growth rate and state, and reschedules its growth accordingly.
+ * @param t The town to update growth for
+ */
+static void UpdateTownGrowth(Town *t)
+{
+	UnscheduleTownGrowth(t);
+	UpdateTownGrowthState(t);
+	ScheduleTownGrowth(t);
+}
+
 /**
  * Checks whether the local authority allows construction of a new station (rail, road, airport, dock) on the given tile
  * @param tile The tile where the station shall be constructed.
@@ -0,0 +1,158 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file trace.cpp Recording of timed events, for viewing in the trace viewers of Chrome or Perfetto. */
+
+#include "stdafx.h"
+#include "trace.h"
+#include "fileio_func.h"
+#include "3rdparty/fmt/chrono.h"
+
+#include <chrono>
+#include <mutex>
+
+#include "safeguards.h"
+
+std::atomic<bool> _trace_active; ///< Whether trace events are recorded.
+
+/** A recorded trace event. */
+struct TraceEvent {
+	const char *name; ///< Name of the event.
+	int64_t arg;      ///< Detail of the event, or -1 when there is none.
+	uint64_t start;   ///< Start time, see #GetTraceTime.
+	uint64_t end;     ///< End time, see #GetTraceTime.
+};
+
+/** Number of events each thread keeps; the older ones get overwritten. */
+static const size_t TRACE_BUFFER_SIZE = 1 << 16;
+
+/** The ring buffer with the most recent events of a thread. */
+struct TraceBuffer {
+	std::array<TraceEvent, TRACE_BUFFER_SIZE> events; ///< The events; event n is at n modulo the size.
+	std::atomic<size_t> count = 0; ///< Number of events recorded since the trace started.
+	std::atomic<bool> in_use = true; ///< Whether a thread records into this buffer.
+	uint thread_id; ///< Number of the thread in the trace.
+};
+
+static std::mutex _trace_buffers_mutex; ///< Lock for creating, reusing and reading the buffers.
+static std::vector<std::unique_ptr<TraceBuffer>> _trace_buffers; ///< The buffers of all threads that recorded events.
+static uint64_t _trace_start; ///< When the trace was started.
+
+/** Hands the buffer of a thread to another thread when the thread ends. */
+struct TraceBufferOwner {
+	TraceBuffer *buffer = nullptr; ///< The buffer of the thread, if it has recorded anything yet.
+
+	~TraceBufferOwner()
+	{
+		if (this->buffer != nullptr) this->buffer->in_use.store(false, std::memory_order_release);
+	}
+};
+
+static thread_local TraceBufferOwner _trace_buffer_owner; ///< The buffer of this thread.
+
+/**
+ * Get the buffer to record the events of this thread into.
+ * @return The buffer.
+ */
+static TraceBuffer &GetThreadTraceBuffer()
+{
+	if (_trace_buffer_owner.buffer != nullptr) return *_trace_buffer_owner.buffer;
+
+	std::lock_guard<std::mutex> lock(_trace_buffers_mutex);
+	for (auto &buffer : _trace_buffers) {
+		bool in_use = false;
+		if (buffer->in_use.compare_exchange_strong(in_use, true)) {
+			_trace_buffer_owner.buffer = buffer.get();
+			return *buffer;
+		}
+	}
+
+	TraceBuffer &buffer = *_trace_buffers.emplace_back(std::make_unique<TraceBuffer>());
+	buffer.thread_id = static_cast<uint>(_trace_buffers.size());
+	_trace_buffer_owner.buffer = &buffer;
+	return buffer;
+}
+
+/**
+ * Get the current time for trace events.
+ * @return The time in nanoseconds.
+ */
+uint64_t GetTraceTime()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Record a trace event for this thread.
+ * @param name Name of the event; has to stay valid until the trace is written.
+ * @param arg Detail of the event, or -1 when there is none.
+ * @param start Start time, see #GetTraceTime.
+ * @param end End time, see #GetTraceTime.
+ */
+void AddTraceEvent(const char *name, int64_t arg, uint64_t start, uint64_t end)
+{
+	TraceBuffer &buffer = GetThreadTraceBuffer();
+	size_t count = buffer.count.load(std::memory_order_relaxed);
+	buffer.events[count % TRACE_BUFFER_SIZE] = { name, arg, start, end };
+	buffer.count.store(count + 1, std::memory_order_release);
+}
+
+/** Start recording trace events, forgetting all earlier ones. */
+void StartTrace()
+{
+	_trace_active.store(false);
+
+	std::lock_guard<std::mutex> lock(_trace_buffers_mutex);
+	for (auto &buffer : _trace_buffers) buffer->count.store(0);
+	_trace_start = GetTraceTime();
+
+	_trace_active.store(true);
+}
+
+/** Stop recording trace events, and forget them. */
+void AbortTrace()
+{
+	_trace_active.store(false);
+}
+
+/**
+ * Stop recording trace events, and write the most recent ones of each thread
+ * to a file in the Trace Event Format understood by Chrome and Perfetto.
+ * @return The name of the written file, or an empty string when it could not be written.
+ */
+std::string StopTrace()
+{
+	_trace_active.store(false);
+
+	std::string filename = fmt::format("{}trace-{:%Y%m%d-%H%M%S}.json", FiosGetScreenshotDir(), fmt::localtime(time(nullptr)));
+	FILE *f = FioFOpenFile(filename, "wt", Subdirectory::NO_DIRECTORY);
+	if (f == nullptr) return {};
+	FileCloser fcloser(f);
+
+	/* Timestamps and durations are in microseconds, relative to the start of the trace. */
+	auto to_us = [](uint64_t time) { return (time - _trace_start) / 1000.0; };
+
+	fmt::print(f, "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first = true;
+
+	std::lock_guard<std::mutex> lock(_trace_buffers_mutex);
+	for (auto &buffer : _trace_buffers) {
+		size_t count = buffer->count.load(std::memory_order_acquire);
+		for (size_t i = count - std::min(count, TRACE_BUFFER_SIZE); i < count; i++) {
+			const TraceEvent &e = buffer->events[i % TRACE_BUFFER_SIZE];
+			if (e.start < _trace_start) continue;
+
+			fmt::print(f, "{}{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}", first ? "" : ",\n", e.name, buffer->thread_id, to_us(e.start), (e.end - e.start) / 1000.0);
+			if (e.arg != -1) fmt::print(f, ",\"args\":{{\"id\":{}}}", e.arg);
+			fmt::print(f, "}}");
+			first = false;
+		}
+	}
+
+	fmt::print(f, "\n]}}\n");
+	return filename;
+}
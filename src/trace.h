@@ -0,0 +1,49 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file trace.h Recording of timed events, for viewing in the trace viewers of Chrome or Perfetto. */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+
+extern std::atomic<bool> _trace_active;
+
+uint64_t GetTraceTime();
+void AddTraceEvent(const char *name, int64_t arg, uint64_t start, uint64_t end);
+
+/**
+ * RAII class recording the time spent in a block as a trace event, when tracing.
+ * Every thread records into its own ring buffer holding its most recent events,
+ * so recording does not take any locks.
+ */
+class TraceScope {
+	const char *name; ///< Name of the event; has to stay valid until the trace is written, so use a string literal.
+	int64_t arg;      ///< Detail of the event, e.g. a vehicle or chunk id, or -1 when there is none.
+	uint64_t start;   ///< When the block was entered, or 0 when not tracing at the time.
+
+public:
+	/**
+	 * Start recording the time spent in a block.
+	 * @param name Name of the event, a string literal.
+	 * @param arg Detail of the event, or -1 when there is none.
+	 */
+	TraceScope(const char *name, int64_t arg = -1) : name(name), arg(arg), start(_trace_active.load(std::memory_order_relaxed) ? GetTraceTime() : 0) {}
+
+	/** Finish recording the time spent in the block. */
+	~TraceScope()
+	{
+		if (this->start != 0) AddTraceEvent(this->name, this->arg, this->start, GetTraceTime());
+	}
+};
+
+void StartTrace();
+std::string StopTrace();
+void AbortTrace();
+
+#endif /* TRACE_H */
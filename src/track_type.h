@@ -117,4 +117,6 @@ DECLARE_ENUM_AS_BIT_SET(TrackdirBits)
 
 typedef uint32_t TrackStatus;
 
+extern uint64_t _track_reservation_generation;
+
 #endif /* TRACK_TYPE_H */
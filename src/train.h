@@ -79,6 +79,17 @@ struct TrainCache {
 
 	int16_t cached_curve_speed_mod; ///< curve speed modifier of the entire train
 	uint16_t cached_max_curve_speed; ///< max consist speed limited by curves
+	bool cached_position_speed_limit; ///< part of the consist may be in a depot or on a bridge, so its speed may be limited by its position
+};
+
+/** The end of the reservation of a train, as last found by #FollowTrainReservation. */
+struct TrainReservationEndCache {
+	uint64_t generation;     ///< Value of #_track_reservation_generation when the end was found; 0 when nothing is cached.
+	TileIndex start_tile;    ///< Tile the reservation was followed from.
+	Trackdir start_trackdir; ///< Trackdir the reservation was followed from.
+	RailTypes railtypes;     ///< Rail types the reservation was followed over.
+	TileIndex end_tile;      ///< Last tile of the reservation.
+	Trackdir end_trackdir;   ///< Trackdir on the last tile of the reservation.
 };
 
 /**
@@ -90,6 +101,7 @@ struct Train final : public GroundVehicle<Train, VEH_TRAIN> {
 	uint16_t wait_counter; ///< Ticks waiting in front of a signal, ticks being stuck or a counter for forced proceeding through signals.
 
 	TrainCache tcache;
+	mutable TrainReservationEndCache reservation_end_cache; ///< Cached end of the reservation of this train.
 
 	/* Link between the two ends of a multiheaded engine */
 	Train *other_multiheaded_part;
@@ -108,6 +120,7 @@ struct Train final : public GroundVehicle<Train, VEH_TRAIN> {
 	friend struct GroundVehicle<Train, VEH_TRAIN>; // GroundVehicle needs to use the acceleration functions defined at Train.
 
 	void MarkDirty() override;
+	void MarkCargoAmountDirty() override;
 	void UpdateDeltaXY() override;
 	ExpensesType GetExpenseType(bool income) const override { return income ? EXPENSES_TRAIN_REVENUE : EXPENSES_TRAIN_RUN; }
 	void PlayLeaveStationSound(bool force = false) const override;
@@ -130,6 +143,7 @@ struct Train final : public GroundVehicle<Train, VEH_TRAIN> {
 	void ReserveTrackUnderConsist() const;
 
 	uint16_t GetCurveSpeedLimit() const;
+	bool HasPositionSpeedLimit() const;
 
 	void ConsistChanged(ConsistChangeFlags allowed_changes);
 
@@ -35,6 +35,7 @@
 #include "zoom_func.h"
 #include "newgrf_debug.h"
 #include "framerate_type.h"
+#include "trace.h"
 #include "train_cmd.h"
 #include "misc_cmd.h"
 #include "timer/timer_game_calendar.h"
@@ -238,6 +239,7 @@ void Train::ConsistChanged(ConsistChangeFlags allowed_changes)
 	this->tcache.cached_tilt = train_can_tilt;
 	this->tcache.cached_curve_speed_mod = min_curve_speed_mod;
 	this->tcache.cached_max_curve_speed = this->GetCurveSpeedLimit();
+	this->tcache.cached_position_speed_limit = this->HasPositionSpeedLimit();
 
 	/* recalculate cached weights and power too (we do this *after* the rest, so it is known which wagons are powered and need extra weight added) */
 	this->CargoChanged();
@@ -375,6 +377,20 @@ uint16_t Train::GetCurveSpeedLimit() const
 	return static_cast<uint16_t>(max_speed);
 }
 
+/**
+ * Checks whether a part of the train is in a depot or on the middle part of a bridge,
+ * so the speed of the train may be limited by its position.
+ * @return True iff the speed of the train may be limited by the position of its parts.
+ */
+bool Train::HasPositionSpeedLimit() const
+{
+	for (const Train *u = this; u != nullptr; u = u->Next()) {
+		if (u->track == TRACK_BIT_DEPOT) return true;
+		if (u->track == TRACK_BIT_WORMHOLE && !(u->vehstatus & VS_HIDDEN)) return true;
+	}
+	return false;
+}
+
 /**
  * Calculates the maximum speed of the vehicle under its current conditions.
  * @return Maximum speed of the vehicle.
@@ -410,7 +426,8 @@ int Train::GetCurrentMaxSpeed() const
 		}
 	}
 
-	for (const Train *u = this; u != nullptr; u = u->Next()) {
+	/* Only walk the consist when a part has moved into a depot or onto a bridge. */
+	for (const Train *u = this->tcache.cached_position_speed_limit ? this : nullptr; u != nullptr; u = u->Next()) {
 		if (_settings_game.vehicle.train_acceleration_model == AM_REALISTIC && u->track == TRACK_BIT_DEPOT) {
 			max_speed = std::min(max_speed, 61);
 			break;
@@ -1663,16 +1680,6 @@ void ReverseTrainSwapVeh(Train *v, int l, int r)
 }
 
 
-/**
- * Check if the vehicle is a train
- * @param v vehicle on tile
- * @return v if it is a train, nullptr otherwise
- */
-static Vehicle *TrainOnTileEnum(Vehicle *v, void *)
-{
-	return (v->type == VEH_TRAIN) ? v : nullptr;
-}
-
 /**
  * Check if a level crossing tile has a train on it
  * @param tile tile to test
@@ -1683,28 +1690,24 @@ bool TrainOnCrossing(TileIndex tile)
 {
 	assert(IsLevelCrossingTile(tile));
 
-	return HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum);
+	return HasVehicleOnPos(tile, [](const Vehicle *v) { return v->type == VEH_TRAIN; });
 }
 
 
 /**
  * Checks if a train is approaching a rail-road crossing
  * @param v vehicle on tile
- * @param data tile with crossing we are testing
- * @return v if it is approaching a crossing, nullptr otherwise
+ * @param tile tile with crossing we are testing
+ * @return true if it is approaching the crossing
  */
-static Vehicle *TrainApproachingCrossingEnum(Vehicle *v, void *data)
+static bool IsTrainApproachingCrossing(const Vehicle *v, TileIndex tile)
 {
-	if (v->type != VEH_TRAIN || (v->vehstatus & VS_CRASHED)) return nullptr;
+	if (v->type != VEH_TRAIN || (v->vehstatus & VS_CRASHED)) return false;
 
-	Train *t = Train::From(v);
-	if (!t->IsFrontEngine()) return nullptr;
+	const Train *t = Train::From(v);
+	if (!t->IsFrontEngine()) return false;
 
-	TileIndex tile = *(TileIndex *)data;
-
-	if (TrainApproachingCrossingTile(t) != tile) return nullptr;
-
-	return t;
+	return TrainApproachingCrossingTile(t) == tile;
 }
 
 
@@ -1721,12 +1724,13 @@ static bool TrainApproachingCrossing(TileIndex tile)
 	DiagDirection dir = AxisToDiagDir(GetCrossingRailAxis(tile));
 	TileIndex tile_from = tile + TileOffsByDiagDir(dir);
 
-	if (HasVehicleOnPos(tile_from, &tile, &TrainApproachingCrossingEnum)) return true;
+	auto is_approaching = [tile](const Vehicle *v) { return IsTrainApproachingCrossing(v, tile); };
+	if (HasVehicleOnPos(tile_from, is_approaching)) return true;
 
 	dir = ReverseDiagDir(dir);
 	tile_from = tile + TileOffsByDiagDir(dir);
 
-	return HasVehicleOnPos(tile_from, &tile, &TrainApproachingCrossingEnum);
+	return HasVehicleOnPos(tile_from, is_approaching);
 }
 
 /**
@@ -1740,6 +1744,9 @@ static inline bool CheckLevelCrossing(TileIndex tile)
 	return HasCrossingReservation(tile) || TrainOnCrossing(tile) || TrainApproachingCrossing(tile);
 }
 
+static bool _postpone_level_crossing_opening = false; ///< Whether opening level crossings waits for #OpenPostponedLevelCrossings.
+static std::vector<TileIndex> _level_crossings_to_open; ///< Barred level crossings that might have to be opened, possibly more than once.
+
 /**
  * Sets a level crossing tile to the correct state.
  * @param tile Tile to update.
@@ -1773,6 +1780,12 @@ void UpdateLevelCrossing(TileIndex tile, bool sound, bool force_bar)
 {
 	if (!IsLevelCrossingTile(tile)) return;
 
+	/* A barred crossing can only be opened, which can wait until all vehicles have moved. */
+	if (_postpone_level_crossing_opening && !force_bar && IsCrossingBarred(tile)) {
+		_level_crossings_to_open.push_back(tile);
+		return;
+	}
+
 	bool forced_state = force_bar;
 
 	const Axis axis = GetCrossingRoadAxis(tile);
@@ -1796,6 +1809,30 @@ void UpdateLevelCrossing(TileIndex tile, bool sound, bool force_bar)
 	}
 }
 
+/**
+ * Postpone opening level crossings until #OpenPostponedLevelCrossings is called.
+ * A crossing is often updated several times while the vehicles move, e.g. when the
+ * reservation over it is lifted and when the last wagon leaves it. Collecting those
+ * updates means the crossing is only checked once. Barring a crossing is never postponed.
+ */
+void PostponeLevelCrossingOpening()
+{
+	_postpone_level_crossing_opening = true;
+}
+
+/**
+ * Update all level crossings that might have to be opened since #PostponeLevelCrossingOpening was called.
+ */
+void OpenPostponedLevelCrossings()
+{
+	_postpone_level_crossing_opening = false;
+
+	std::sort(_level_crossings_to_open.begin(), _level_crossings_to_open.end());
+	_level_crossings_to_open.erase(std::unique(_level_crossings_to_open.begin(), _level_crossings_to_open.end()), _level_crossings_to_open.end());
+	for (TileIndex tile : _level_crossings_to_open) UpdateLevelCrossing(tile);
+	_level_crossings_to_open.clear();
+}
+
 /**
  * Find adjacent level crossing tiles in this multi-track crossing and mark them dirty.
  * @param tile The tile which causes the update.
@@ -2335,6 +2372,7 @@ static bool CheckTrainStayInDepot(Train *v)
 
 	v->vehstatus &= ~VS_HIDDEN;
 	v->cur_speed = 0;
+	v->tcache.cached_position_speed_limit = v->HasPositionSpeedLimit();
 
 	v->UpdateViewport(true, true);
 	v->UpdatePosition();
@@ -2975,6 +3013,18 @@ void Train::MarkDirty()
 	this->UpdateAcceleration();
 }
 
+/** The amount of goods in the consist has changed, update the graphics and acceleration. */
+void Train::MarkCargoAmountDirty()
+{
+	for (Train *v = this; v != nullptr; v = v->Next()) {
+		v->colourmap = PAL_NONE;
+		v->UpdateViewport(true, false);
+	}
+
+	this->CargoAmountChanged();
+	this->UpdateAcceleration();
+}
+
 /**
  * This function looks at the vehicle and updates its speed (cur_speed
  * and subspeed) variables. Furthermore, it returns the distance that
@@ -3252,19 +3302,22 @@ static bool CheckTrainCollision(Train *v)
 	return true;
 }
 
-static Vehicle *CheckTrainAtSignal(Vehicle *v, void *data)
+/**
+ * Check whether a vehicle is a train waiting at a signal.
+ * @param v vehicle on the tile behind the signal
+ * @param exitdir direction in which the train should leave the tile
+ * @return true if it is a train that waits to leave in \a exitdir
+ */
+static bool IsTrainWaitingAtSignal(const Vehicle *v, DiagDirection exitdir)
 {
-	if (v->type != VEH_TRAIN || (v->vehstatus & VS_CRASHED)) return nullptr;
+	if (v->type != VEH_TRAIN || (v->vehstatus & VS_CRASHED)) return false;
 
-	Train *t = Train::From(v);
-	DiagDirection exitdir = *(DiagDirection *)data;
+	const Train *t = Train::From(v);
 
 	/* not front engine of a train, inside wormhole or depot, crashed */
-	if (!t->IsFrontEngine() || !(t->track & TRACK_BIT_MASK)) return nullptr;
+	if (!t->IsFrontEngine() || !(t->track & TRACK_BIT_MASK)) return false;
 
-	if (t->cur_speed > 5 || VehicleExitDir(t->direction, t->track) != exitdir) return nullptr;
-
-	return t;
+	return t->cur_speed <= 5 && VehicleExitDir(t->direction, t->track) == exitdir;
 }
 
 /**
@@ -3279,11 +3332,14 @@ bool TrainController(Train *v, Vehicle *nomove, bool reverse)
 	Train *first = v->First();
 	Train *prev;
 	bool direction_changed = false; // has direction of any part changed?
+	bool position_changed = false; // has any part moved into or out of a depot or wormhole?
 
 	/* For every vehicle after and including the given vehicle */
 	for (prev = v->Previous(); v != nomove; prev = v, v = v->Next()) {
 		DiagDirection enterdir = DIAGDIR_BEGIN;
 		bool update_signals_crossing = false; // will we update signals or crossing state?
+		TrackBits old_track = v->track;
+		bool old_hidden = (v->vehstatus & VS_HIDDEN) != 0;
 
 		GetNewVehiclePosResult gp = GetNewVehiclePos(v);
 		if (v->track != TRACK_BIT_WORMHOLE) {
@@ -3384,7 +3440,7 @@ bool TrainController(Train *v, Vehicle *nomove, bool reverse)
 								exitdir = ReverseDiagDir(exitdir);
 
 								/* check if a train is waiting on the other side */
-								if (!HasVehicleOnPos(o_tile, &exitdir, &CheckTrainAtSignal)) return false;
+								if (!HasVehicleOnPos(o_tile, [exitdir](const Vehicle *u) { return IsTrainWaitingAtSignal(u, exitdir); })) return false;
 							}
 						}
 
@@ -3568,9 +3624,12 @@ bool TrainController(Train *v, Vehicle *nomove, bool reverse)
 
 		/* Do not check on every tick to save some computing time. */
 		if (v->IsFrontEngine() && v->tick_counter % _settings_game.pf.path_backoff_interval == 0) CheckNextTrainTile(v);
+
+		if (v->track != old_track || ((v->vehstatus & VS_HIDDEN) != 0) != old_hidden) position_changed = true;
 	}
 
 	if (direction_changed) first->tcache.cached_max_curve_speed = first->GetCurveSpeedLimit();
+	if (position_changed) first->tcache.cached_position_speed_limit = first->HasPositionSpeedLimit();
 
 	return true;
 
@@ -3591,36 +3650,38 @@ reverse_train_direction:
 
 /**
  * Collect trackbits of all crashed train vehicles on a tile
- * @param v Vehicle passed from Find/HasVehicleOnPos()
- * @param data trackdirbits for the result
- * @return nullptr to iterate over all vehicles on the tile.
+ * @param tile The tile to look at.
+ * @return The tracks that are occupied by crashed trains.
  */
-static Vehicle *CollectTrackbitsFromCrashedVehiclesEnum(Vehicle *v, void *data)
+static TrackBits CollectTrackbitsFromCrashedVehicles(TileIndex tile)
 {
-	TrackBits *trackbits = (TrackBits *)data;
+	TrackBits trackbits = TRACK_BIT_NONE;
+
+	FindVehicleOnPos(tile, [&trackbits](const Vehicle *v) {
+		if (v->type != VEH_TRAIN || (v->vehstatus & VS_CRASHED) == 0) return;
 
-	if (v->type == VEH_TRAIN && (v->vehstatus & VS_CRASHED) != 0) {
 		TrackBits train_tbits = Train::From(v)->track;
 		if (train_tbits == TRACK_BIT_WORMHOLE) {
 			/* Vehicle is inside a wormhole, v->track contains no useful value then. */
-			*trackbits |= DiagDirToDiagTrackBits(GetTunnelBridgeDirection(v->tile));
+			trackbits |= DiagDirToDiagTrackBits(GetTunnelBridgeDirection(v->tile));
 		} else if (train_tbits != TRACK_BIT_DEPOT) {
-			*trackbits |= train_tbits;
+			trackbits |= train_tbits;
 		}
-	}
+	});
 
-	return nullptr;
+	return trackbits;
 }
 
 static bool IsRailStationPlatformOccupied(TileIndex tile)
 {
 	TileIndexDiff delta = (GetRailStationAxis(tile) == AXIS_X ? TileDiffXY(1, 0) : TileDiffXY(0, 1));
+	auto is_train = [](const Vehicle *v) { return v->type == VEH_TRAIN; };
 
 	for (TileIndex t = tile; IsCompatibleTrainStationTile(t, tile); t -= delta) {
-		if (HasVehicleOnPos(t, nullptr, &TrainOnTileEnum)) return true;
+		if (HasVehicleOnPos(t, is_train)) return true;
 	}
 	for (TileIndex t = tile + delta; IsCompatibleTrainStationTile(t, tile); t += delta) {
-		if (HasVehicleOnPos(t, nullptr, &TrainOnTileEnum)) return true;
+		if (HasVehicleOnPos(t, is_train)) return true;
 	}
 
 	return false;
@@ -3673,8 +3734,7 @@ static void DeleteLastWagon(Train *v)
 		UnreserveRailTrack(tile, track);
 
 		/* If there are still crashed vehicles on the tile, give the track reservation to them */
-		TrackBits remaining_trackbits = TRACK_BIT_NONE;
-		FindVehicleOnPos(tile, &remaining_trackbits, CollectTrackbitsFromCrashedVehiclesEnum);
+		TrackBits remaining_trackbits = CollectTrackbitsFromCrashedVehicles(tile);
 
 		/* It is important that these two are the first in the loop, as reservation cannot deal with every trackbit combination */
 		assert(TRACK_BEGIN == TRACK_X && TRACK_Y == TRACK_BEGIN + 1);
@@ -4111,6 +4171,8 @@ bool Train::Tick()
 
 	if (this->IsFrontEngine()) {
 		PerformanceAccumulator framerate(PFE_GL_TRAINS);
+		TraceScope trace("Train tick", this->index);
+		CompanyPerformanceMeasurer company_framerate(CPE_VEHICLES, this->owner);
 
 		if (!(this->vehstatus & VS_STOPPED) || this->cur_speed > 0) this->running_ticks++;
 
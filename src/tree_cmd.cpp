@@ -43,14 +43,6 @@ enum TreePlacer {
 	TP_IMPROVED, ///< A 'improved' algorithm
 };
 
-/** Where to place trees while in-game? */
-enum ExtraTreePlacement {
-	ETP_NO_SPREAD,           ///< Grow trees on tiles that have them but don't spread to new ones
-	ETP_SPREAD_RAINFOREST,   ///< Grow trees on tiles that have them, only spread to new ones in rainforests
-	ETP_SPREAD_ALL,          ///< Grow trees and spread them without restrictions
-	ETP_NO_GROWTH_NO_SPREAD, ///< Don't grow trees and don't spread them at all
-};
-
 /** Determines when to consider building more trees. */
 uint8_t _trees_tick_ctr;
 
@@ -693,19 +685,25 @@ static bool CanPlantExtraTrees(TileIndex tile)
 		_settings_game.construction.extra_tree_placement == ETP_SPREAD_ALL);
 }
 
-static void TileLoop_Trees(TileIndex tile)
+/**
+ * Update the ground of a tree tile that is not on a shore to the climate.
+ * @param tile The tree tile.
+ */
+void TileLoopTreesClimate(TileIndex tile)
 {
-	if (GetTreeGround(tile) == TREE_GROUND_SHORE) {
-		TileLoop_Water(tile);
-	} else {
-		switch (_settings_game.game_creation.landscape) {
-			case LT_TROPIC: TileLoopTreesDesert(tile); break;
-			case LT_ARCTIC: TileLoopTreesAlps(tile);   break;
-		}
+	switch (_settings_game.game_creation.landscape) {
+		case LT_TROPIC: TileLoopTreesDesert(tile); break;
+		case LT_ARCTIC: TileLoopTreesAlps(tile);   break;
 	}
+}
 
-	AmbientSoundEffect(tile);
-
+/**
+ * Grow the grass under the trees of a tree tile, and grow, spread and destruct its trees.
+ * This is the part of the tile loop of a tree tile after the ground is updated to the climate.
+ * @param tile The tree tile.
+ */
+void TileLoopTreesGrowth(TileIndex tile)
+{
 	/* TimerGameTick::counter is incremented by 256 between each call, so ignore lower 8 bits.
 	 * Also, we use a simple hash to spread the updates evenly over the map.
 	 * 11 and 9 are just some co-prime numbers for better spread.
@@ -810,21 +808,33 @@ static void TileLoop_Trees(TileIndex tile)
 	MarkTileDirtyByTile(tile);
 }
 
+static void TileLoop_Trees(TileIndex tile)
+{
+	if (GetTreeGround(tile) == TREE_GROUND_SHORE) {
+		TileLoop_Water(tile);
+	} else {
+		TileLoopTreesClimate(tile);
+	}
+
+	AmbientSoundEffect(tile);
+
+	TileLoopTreesGrowth(tile);
+}
+
 /**
  * Decrement the tree tick counter.
  * The interval is scaled by map size to allow for the same density regardless of size.
  * Adjustment for map sizes below the standard 256 * 256 are handled earlier.
- * @return true if the counter was decremented past zero
+ * @return The number of times the counter was decremented past zero; on maps larger than 4096 * 4096 this can be more than once.
  */
-bool DecrementTreeCounter()
+uint DecrementTreeCounter()
 {
-	/* Ensure _trees_tick_ctr can be decremented past zero only once for the largest map size. */
-	static_assert(2 * (MAX_MAP_SIZE_BITS - MIN_MAP_SIZE_BITS) - 4 <= std::numeric_limits<uint8_t>::digits);
+	uint decrement = Map::ScaleBySize(1);
+	uint first_underflow = _trees_tick_ctr + 1;
 
 	/* byte underflow */
-	uint8_t old_trees_tick_ctr = _trees_tick_ctr;
-	_trees_tick_ctr -= Map::ScaleBySize(1);
-	return old_trees_tick_ctr <= _trees_tick_ctr;
+	_trees_tick_ctr -= decrement;
+	return decrement < first_underflow ? 0 : (decrement - first_underflow) / 256 + 1;
 }
 
 void OnTick_Trees()
@@ -853,13 +863,16 @@ void OnTick_Trees()
 		}
 	}
 
-	if (!DecrementTreeCounter() || _settings_game.construction.extra_tree_placement == ETP_SPREAD_RAINFOREST) return;
+	uint count = DecrementTreeCounter();
+	if (_settings_game.construction.extra_tree_placement == ETP_SPREAD_RAINFOREST) return;
 
 	/* place a tree at a random spot */
-	r = Random();
-	tile = RandomTileSeed(r);
-	if (CanPlantTreesOnTile(tile, false) && (tree = GetRandomTreeType(tile, GB(r, 24, 8))) != TREE_INVALID) {
-		PlantTreesOnTile(tile, tree, 0, 0);
+	for (; count > 0; count--) {
+		r = Random();
+		tile = RandomTileSeed(r);
+		if (CanPlantTreesOnTile(tile, false) && (tree = GetRandomTreeType(tile, GB(r, 24, 8))) != TREE_INVALID) {
+			PlantTreesOnTile(tile, tree, 0, 0);
+		}
 	}
 }
 
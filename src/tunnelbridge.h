@@ -15,6 +15,7 @@
 
 void MarkBridgeDirty(TileIndex begin, TileIndex end, DiagDirection direction, uint bridge_height);
 void MarkBridgeDirty(TileIndex tile);
+bool UpdateTunnelBridgeSnowOrDesert(TileIndex tile);
 
 /**
  * Calculates the length of a tunnel or a bridge (without end tiles)
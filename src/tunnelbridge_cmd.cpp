@@ -1763,7 +1763,13 @@ static void GetTileDesc_TunnelBridge(TileIndex tile, TileDesc *td)
 }
 
 
-static void TileLoop_TunnelBridge(TileIndex tile)
+/**
+ * Update the snow or desert state of a tunnel or bridge head.
+ * This only reads and writes the given tile, so it is safe to call for several tiles concurrently.
+ * @param tile The tunnel or bridge head.
+ * @return Whether the state changed and the tile needs to be redrawn.
+ */
+bool UpdateTunnelBridgeSnowOrDesert(TileIndex tile)
 {
 	bool snow_or_desert = HasTunnelBridgeSnowOrDesert(tile);
 	switch (_settings_game.game_creation.landscape) {
@@ -1774,7 +1780,7 @@ static void TileLoop_TunnelBridge(TileIndex tile)
 			int z = IsBridge(tile) ? GetTileMaxZ(tile) : GetTileZ(tile);
 			if (snow_or_desert != (z > GetSnowLine())) {
 				SetTunnelBridgeSnowOrDesert(tile, !snow_or_desert);
-				MarkTileDirtyByTile(tile);
+				return true;
 			}
 			break;
 		}
@@ -1782,13 +1788,20 @@ static void TileLoop_TunnelBridge(TileIndex tile)
 		case LT_TROPIC:
 			if (GetTropicZone(tile) == TROPICZONE_DESERT && !snow_or_desert) {
 				SetTunnelBridgeSnowOrDesert(tile, true);
-				MarkTileDirtyByTile(tile);
+				return true;
 			}
 			break;
 
 		default:
 			break;
 	}
+
+	return false;
+}
+
+static void TileLoop_TunnelBridge(TileIndex tile)
+{
+	if (UpdateTunnelBridgeSnowOrDesert(tile)) MarkTileDirtyByTile(tile);
 }
 
 static TrackStatus GetTileTrackStatus_TunnelBridge(TileIndex tile, TransportType mode, uint sub_mode, DiagDirection side)
@@ -1892,7 +1905,7 @@ static const uint8_t TUNNEL_SOUND_FRAME = 1;
  */
 extern const uint8_t _tunnel_visibility_frame[DIAGDIR_END] = {12, 8, 8, 12};
 
-static VehicleEnterTileStatus VehicleEnter_TunnelBridge(Vehicle *v, TileIndex tile, int x, int y)
+VehicleEnterTileStatus VehicleEnter_TunnelBridge(Vehicle *v, TileIndex tile, int x, int y)
 {
 	int z = GetSlopePixelZ(x, y, true) - v->z_pos;
 
@@ -60,11 +60,17 @@
 #include "timer/timer_game_calendar.h"
 #include "timer/timer_game_economy.h"
 #include "timer/timer_game_tick.h"
+#include "thread.h"
 
 #include "table/strings.h"
 
 #include "safeguards.h"
 
+/** Company vehicles of each type, in pool order. */
+static std::array<std::vector<VehicleID>, VEH_COMPANY_END> _vehicles_by_type;
+/** Whether a company vehicle was created or deleted since #_vehicles_by_type was built. */
+static bool _vehicles_by_type_dirty = true;
+
 /* Number of bits in the hash to use from each vehicle coord */
 static const uint GEN_HASHX_BITS = 6;
 static const uint GEN_HASHY_BITS = 6;
@@ -362,6 +368,7 @@ Vehicle::Vehicle(VehicleType type)
 {
 	this->type               = type;
 	this->coord.left         = INVALID_COORD;
+	this->tick_start_x_pos   = INVALID_COORD;
 	this->sprite_cache.old_coord.left = INVALID_COORD;
 	this->group_id           = DEFAULT_GROUP;
 	this->fill_percent_te_id = INVALID_TE_ID;
@@ -370,34 +377,67 @@ Vehicle::Vehicle(VehicleType type)
 	this->cargo_age_counter  = 1;
 	this->last_station_visited = INVALID_STATION;
 	this->last_loading_station = INVALID_STATION;
+	this->hash_tile_counted  = INVALID_TILE;
+	if (IsCompanyBuildableVehicleType(type)) _vehicles_by_type_dirty = true;
 }
 
-/* Size of the hash, 6 = 64 x 64, 7 = 128 x 128. Larger sizes will (in theory) reduce hash
- * lookup times at the expense of memory usage. */
-const int HASH_BITS = 7;
-const int HASH_SIZE = 1 << HASH_BITS;
-const int HASH_MASK = HASH_SIZE - 1;
-const int TOTAL_HASH_SIZE = 1 << (HASH_BITS * 2);
-const int TOTAL_HASH_MASK = TOTAL_HASH_SIZE - 1;
+/* Minimum and maximum size of the hash, 6 = 64 x 64, 7 = 128 x 128. Larger sizes reduce hash
+ * lookup times at the expense of memory usage, so the size grows with the number of vehicles. */
+const uint MIN_HASH_BITS = 7;
+const uint MAX_HASH_BITS = 12;
 
 /* Resolution of the hash, 0 = 1*1 tile, 1 = 2*2 tiles, 2 = 4*4 tiles, etc.
  * Profiling results show that 0 is fastest. */
 const int HASH_RES = 0;
 
-static Vehicle *_vehicle_tile_hash[TOTAL_HASH_SIZE];
+static std::vector<Vehicle *> _vehicle_tile_hash(1 << (MIN_HASH_BITS * 2)); ///< The buckets of the tile hash, (1 << _vehicle_tile_hash_bits) squared.
+static std::vector<Vehicle *> _road_vehicle_tile_hash(1 << (MIN_HASH_BITS * 2)); ///< The buckets of the tile hash of road vehicles, which are kept apart so looking for road vehicles only walks road vehicles.
+static uint _vehicle_tile_hash_bits = MIN_HASH_BITS; ///< Size of the tile hash along each axis.
+static size_t _vehicle_tile_hash_count = 0; ///< Number of vehicles in the tile hash.
+
+/**
+ * Get the index of the bucket of the tile hash for a tile.
+ * @param x The X coordinate of the tile.
+ * @param y The Y coordinate of the tile.
+ * @return The index into #_vehicle_tile_hash.
+ */
+static inline size_t GetVehicleTileHashIndex(uint x, uint y)
+{
+	return GB(x, HASH_RES, _vehicle_tile_hash_bits) | GB(y, HASH_RES, _vehicle_tile_hash_bits) << _vehicle_tile_hash_bits;
+}
+
+/**
+ * Get the tile hash a vehicle is kept in.
+ * @param v The vehicle.
+ * @return The hash with road vehicles for road vehicles, otherwise the hash with all other vehicles.
+ */
+static inline std::vector<Vehicle *> &GetVehicleTileHashFor(const Vehicle *v)
+{
+	return v->type == VEH_ROAD ? _road_vehicle_tile_hash : _vehicle_tile_hash;
+}
+
+/**
+ * Number of train vehicles in the tile hash per tile. A count that reaches UINT16_MAX stays there,
+ * so it never wrongly drops to zero. This makes the common check whether there is any train on
+ * a tile a single load, see #MayHaveTrainOnTile.
+ */
+std::vector<uint16_t> _train_tile_occupancy;
 
 static Vehicle *VehicleFromTileHash(int xl, int yl, int xu, int yu, void *data, VehicleFromPosProc *proc, bool find_first)
 {
-	for (int y = yl; ; y = (y + (1 << HASH_BITS)) & (HASH_MASK << HASH_BITS)) {
-		for (int x = xl; ; x = (x + 1) & HASH_MASK) {
-			Vehicle *v = _vehicle_tile_hash[(x + y) & TOTAL_HASH_MASK];
-			for (; v != nullptr; v = v->hash_tile_next) {
-				Vehicle *a = proc(v, data);
-				if (find_first && a != nullptr) return a;
+	const int hash_mask = (1 << _vehicle_tile_hash_bits) - 1;
+	for (const std::vector<Vehicle *> *hash : { &_vehicle_tile_hash, &_road_vehicle_tile_hash }) {
+		for (int y = yl; ; y = (y + (1 << _vehicle_tile_hash_bits)) & (hash_mask << _vehicle_tile_hash_bits)) {
+			for (int x = xl; ; x = (x + 1) & hash_mask) {
+				Vehicle *v = (*hash)[x + y];
+				for (; v != nullptr; v = v->hash_tile_next) {
+					Vehicle *a = proc(v, data);
+					if (find_first && a != nullptr) return a;
+				}
+				if (x == xu) break;
 			}
-			if (x == xu) break;
+			if (y == yu) break;
 		}
-		if (y == yu) break;
 	}
 
 	return nullptr;
@@ -420,10 +460,10 @@ static Vehicle *VehicleFromPosXY(int x, int y, void *data, VehicleFromPosProc *p
 	const int COLL_DIST = 6;
 
 	/* Hash area to scan is from xl,yl to xu,yu */
-	int xl = GB((x - COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS);
-	int xu = GB((x + COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS);
-	int yl = GB((y - COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS) << HASH_BITS;
-	int yu = GB((y + COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS) << HASH_BITS;
+	int xl = GB((x - COLL_DIST) / TILE_SIZE, HASH_RES, _vehicle_tile_hash_bits);
+	int xu = GB((x + COLL_DIST) / TILE_SIZE, HASH_RES, _vehicle_tile_hash_bits);
+	int yl = GB((y - COLL_DIST) / TILE_SIZE, HASH_RES, _vehicle_tile_hash_bits) << _vehicle_tile_hash_bits;
+	int yu = GB((y + COLL_DIST) / TILE_SIZE, HASH_RES, _vehicle_tile_hash_bits) << _vehicle_tile_hash_bits;
 
 	return VehicleFromTileHash(xl, yl, xu, yu, data, proc, find_first);
 }
@@ -463,6 +503,29 @@ bool HasVehicleOnPosXY(int x, int y, void *data, VehicleFromPosProc *proc)
 	return VehicleFromPosXY(x, y, data, proc, true) != nullptr;
 }
 
+/**
+ * Get the start of the tile hash chain that contains the vehicles, except road vehicles, of a tile.
+ * The chain also contains vehicles of other tiles, so check Vehicle::tile.
+ * @param tile The location on the map.
+ * @return The first vehicle in the chain, or nullptr if it is empty.
+ * @see GetFirstRoadVehicleInTileHash
+ */
+Vehicle *GetFirstVehicleInTileHash(TileIndex tile)
+{
+	return _vehicle_tile_hash[GetVehicleTileHashIndex(TileX(tile), TileY(tile))];
+}
+
+/**
+ * Get the start of the tile hash chain that contains the road vehicles of a tile.
+ * The chain also contains road vehicles of other tiles, so check Vehicle::tile.
+ * @param tile The location on the map.
+ * @return The first road vehicle in the chain, or nullptr if it is empty.
+ */
+Vehicle *GetFirstRoadVehicleInTileHash(TileIndex tile)
+{
+	return _road_vehicle_tile_hash[GetVehicleTileHashIndex(TileX(tile), TileY(tile))];
+}
+
 /**
  * Helper function for FindVehicleOnPos/HasVehicleOnPos.
  * @note Do not call this function directly!
@@ -475,15 +538,13 @@ bool HasVehicleOnPosXY(int x, int y, void *data, VehicleFromPosProc *proc)
  */
 static Vehicle *VehicleFromPos(TileIndex tile, void *data, VehicleFromPosProc *proc, bool find_first)
 {
-	int x = GB(TileX(tile), HASH_RES, HASH_BITS);
-	int y = GB(TileY(tile), HASH_RES, HASH_BITS) << HASH_BITS;
-
-	Vehicle *v = _vehicle_tile_hash[(x + y) & TOTAL_HASH_MASK];
-	for (; v != nullptr; v = v->hash_tile_next) {
-		if (v->tile != tile) continue;
+	for (Vehicle *first : { GetFirstVehicleInTileHash(tile), GetFirstRoadVehicleInTileHash(tile) }) {
+		for (Vehicle *v = first; v != nullptr; v = v->hash_tile_next) {
+			if (v->tile != tile) continue;
 
-		Vehicle *a = proc(v, data);
-		if (find_first && a != nullptr) return a;
+			Vehicle *a = proc(v, data);
+			if (find_first && a != nullptr) return a;
+		}
 	}
 
 	return nullptr;
@@ -607,6 +668,8 @@ static Vehicle *EnsureNoTrainOnTrackProc(Vehicle *v, void *data)
  */
 CommandCost EnsureNoTrainOnTrackBits(TileIndex tile, TrackBits track_bits)
 {
+	if (!MayHaveTrainOnTile(tile)) return CommandCost();
+
 	/* Value v is not safe in MP games, however, it is used to generate a local
 	 * error message only (which may be different for different machines).
 	 * Such a message does not affect MP synchronisation.
@@ -616,17 +679,91 @@ CommandCost EnsureNoTrainOnTrackBits(TileIndex tile, TrackBits track_bits)
 	return CommandCost();
 }
 
+/**
+ * Move the count of a train vehicle in #_train_tile_occupancy to its current tile.
+ * @param v The vehicle.
+ * @param remove Whether the vehicle is removed from the tile hash.
+ */
+static void UpdateTrainTileOccupancy(Vehicle *v, bool remove)
+{
+	if (v->type != VEH_TRAIN) return;
+
+	TileIndex new_tile = remove ? INVALID_TILE : v->tile;
+	if (new_tile == v->hash_tile_counted) return;
+
+	/* The map has been reallocated, without any vehicle being counted since. */
+	if (_train_tile_occupancy.size() != Map::Size()) _train_tile_occupancy.assign(Map::Size(), 0);
+
+	if (v->hash_tile_counted != INVALID_TILE) {
+		uint16_t &count = _train_tile_occupancy[v->hash_tile_counted.base()];
+		if (count != 0 && count != UINT16_MAX) count--;
+	}
+	if (new_tile != INVALID_TILE) {
+		uint16_t &count = _train_tile_occupancy[new_tile.base()];
+		if (count != UINT16_MAX) count++;
+	}
+	v->hash_tile_counted = new_tile;
+}
+
+/**
+ * Insert a vehicle at the beginning of a chain of the tile hash.
+ * @param v The vehicle, which must not be in the hash.
+ * @param new_hash The chain to insert into.
+ */
+static inline void InsertIntoVehicleTileHash(Vehicle *v, Vehicle **new_hash)
+{
+	v->hash_tile_next = *new_hash;
+	if (v->hash_tile_next != nullptr) v->hash_tile_next->hash_tile_prev = &v->hash_tile_next;
+	v->hash_tile_prev = new_hash;
+	*new_hash = v;
+	v->hash_tile_current = new_hash;
+}
+
+/**
+ * Change the size of the tile hash, and put all vehicles that were in it into the new buckets.
+ * @param bits The new size along each axis.
+ */
+static void ResizeVehicleTileHash(uint bits)
+{
+	std::vector<Vehicle *> hashed;
+	hashed.reserve(_vehicle_tile_hash_count);
+	for (Vehicle *v : Vehicle::Iterate()) {
+		if (v->hash_tile_current != nullptr) hashed.push_back(v);
+	}
+
+	Debug(misc, 3, "Resizing vehicle tile hash from {0} x {0} to {1} x {1} for {2} vehicles", 1 << _vehicle_tile_hash_bits, 1 << bits, hashed.size());
+	_vehicle_tile_hash_bits = bits;
+	_vehicle_tile_hash.assign(static_cast<size_t>(1) << (bits * 2), nullptr);
+	_road_vehicle_tile_hash.assign(static_cast<size_t>(1) << (bits * 2), nullptr);
+
+	for (Vehicle *v : hashed) InsertIntoVehicleTileHash(v, &GetVehicleTileHashFor(v)[GetVehicleTileHashIndex(TileX(v->tile), TileY(v->tile))]);
+}
+
+/**
+ * Get the size of the tile hash that fits a number of vehicles, so there
+ * is about one bucket per vehicle.
+ * @param count The number of vehicles.
+ * @return The size along each axis.
+ */
+static uint GetVehicleTileHashBitsFor(size_t count)
+{
+	uint bits = MIN_HASH_BITS;
+	while (bits < MAX_HASH_BITS && (static_cast<size_t>(1) << (bits * 2)) < count) bits++;
+	return bits;
+}
+
 static void UpdateVehicleTileHash(Vehicle *v, bool remove)
 {
+	UpdateTrainTileOccupancy(v, remove);
+
 	Vehicle **old_hash = v->hash_tile_current;
 	Vehicle **new_hash;
 
-	if (remove) {
+	/* Effect vehicles are not on a tile; they all have tile 0 and would otherwise pile up in one bucket. */
+	if (remove || v->type == VEH_EFFECT) {
 		new_hash = nullptr;
 	} else {
-		int x = GB(TileX(v->tile), HASH_RES, HASH_BITS);
-		int y = GB(TileY(v->tile), HASH_RES, HASH_BITS) << HASH_BITS;
-		new_hash = &_vehicle_tile_hash[(x + y) & TOTAL_HASH_MASK];
+		new_hash = &GetVehicleTileHashFor(v)[GetVehicleTileHashIndex(TileX(v->tile), TileY(v->tile))];
 	}
 
 	if (old_hash == new_hash) return;
@@ -635,18 +772,49 @@ static void UpdateVehicleTileHash(Vehicle *v, bool remove)
 	if (old_hash != nullptr) {
 		if (v->hash_tile_next != nullptr) v->hash_tile_next->hash_tile_prev = v->hash_tile_prev;
 		*v->hash_tile_prev = v->hash_tile_next;
+		_vehicle_tile_hash_count--;
 	}
 
 	/* Insert vehicle at beginning of the new position in the hash table */
 	if (new_hash != nullptr) {
-		v->hash_tile_next = *new_hash;
-		if (v->hash_tile_next != nullptr) v->hash_tile_next->hash_tile_prev = &v->hash_tile_next;
-		v->hash_tile_prev = new_hash;
-		*new_hash = v;
+		InsertIntoVehicleTileHash(v, new_hash);
+		_vehicle_tile_hash_count++;
+	} else {
+		/* Remember current hash position */
+		v->hash_tile_current = nullptr;
 	}
+}
 
-	/* Remember current hash position */
-	v->hash_tile_current = new_hash;
+/**
+ * Grow the tile hash when there are on average more than two vehicles in a bucket.
+ * This must not happen while walking the hash, so it is only done between the moves
+ * of the vehicles.
+ */
+static void GrowVehicleTileHashIfNeeded()
+{
+	if (_vehicle_tile_hash_count <= _vehicle_tile_hash.size() * 2 || _vehicle_tile_hash_bits == MAX_HASH_BITS) return;
+
+	ResizeVehicleTileHash(GetVehicleTileHashBitsFor(_vehicle_tile_hash_count));
+}
+
+/**
+ * Get the distribution of the lengths of the chains of the vehicle tile hash.
+ * @param[out] bits The size of the hash along each axis.
+ * @return For each chain length, the number of buckets with a chain of that length.
+ */
+std::vector<size_t> GetVehicleTileHashChainLengths(uint &bits)
+{
+	bits = _vehicle_tile_hash_bits;
+
+	std::vector<size_t> lengths;
+	for (size_t i = 0; i < _vehicle_tile_hash.size(); i++) {
+		size_t length = 0;
+		for (const Vehicle *v = _vehicle_tile_hash[i]; v != nullptr; v = v->hash_tile_next) length++;
+		for (const Vehicle *v = _road_vehicle_tile_hash[i]; v != nullptr; v = v->hash_tile_next) length++;
+		if (length >= lengths.size()) lengths.resize(length + 1);
+		lengths[length]++;
+	}
+	return lengths;
 }
 
 static Vehicle *_vehicle_viewport_hash[1 << (GEN_HASHX_BITS + GEN_HASHY_BITS)];
@@ -677,9 +845,16 @@ static void UpdateVehicleViewportHash(Vehicle *v, int x, int y, int old_x, int o
 
 void ResetVehicleHash()
 {
-	for (Vehicle *v : Vehicle::Iterate()) { v->hash_tile_current = nullptr; }
+	for (Vehicle *v : Vehicle::Iterate()) {
+		v->hash_tile_current = nullptr;
+		v->hash_tile_counted = INVALID_TILE;
+	}
 	memset(_vehicle_viewport_hash, 0, sizeof(_vehicle_viewport_hash));
-	memset(_vehicle_tile_hash, 0, sizeof(_vehicle_tile_hash));
+	_vehicle_tile_hash_bits = GetVehicleTileHashBitsFor(Vehicle::GetNumItems());
+	_vehicle_tile_hash.assign(static_cast<size_t>(1) << (_vehicle_tile_hash_bits * 2), nullptr);
+	_road_vehicle_tile_hash.assign(static_cast<size_t>(1) << (_vehicle_tile_hash_bits * 2), nullptr);
+	_vehicle_tile_hash_count = 0;
+	_train_tile_occupancy.assign(Map::Size(), 0);
 }
 
 void ResetVehicleColourMap()
@@ -690,14 +865,16 @@ void ResetVehicleColourMap()
 /**
  * List of vehicles that should check for autoreplace this tick.
  * Mapping of vehicle -> leave depot immediately after autoreplace.
+ * Keyed by index so every client handles them in the same order.
  */
-using AutoreplaceMap = std::map<Vehicle *, bool>;
+using AutoreplaceMap = std::map<VehicleID, bool>;
 static AutoreplaceMap _vehicles_to_autoreplace;
 
 void InitializeVehicles()
 {
 	_vehicles_to_autoreplace.clear();
 	ResetVehicleHash();
+	ResetCompanyVehicleLists();
 }
 
 uint CountVehiclesInChain(const Vehicle *v)
@@ -827,6 +1004,9 @@ void Vehicle::PreDestructor()
 {
 	if (CleaningPool()) return;
 
+	/* Vehicles are also removed outside of commands, so a new vehicle could get the name of this one from the cache. */
+	if (this->IsPrimaryVehicle()) ClearFormattedStringCache();
+
 	if (Station::IsValidID(this->last_station_visited)) {
 		Station *st = Station::Get(this->last_station_visited);
 		st->loading_vehicles.remove(this);
@@ -892,6 +1072,8 @@ void Vehicle::PreDestructor()
 
 Vehicle::~Vehicle()
 {
+	if (IsCompanyBuildableVehicleType(this)) _vehicles_by_type_dirty = true;
+
 	if (CleaningPool()) {
 		this->cargo.OnCleanPool();
 		return;
@@ -921,7 +1103,7 @@ Vehicle::~Vehicle()
 void VehicleEnteredDepotThisTick(Vehicle *v)
 {
 	/* Vehicle should stop in the depot if it was in 'stopping' state */
-	_vehicles_to_autoreplace[v] = !(v->vehstatus & VS_STOPPED);
+	_vehicles_to_autoreplace[v->index] = !(v->vehstatus & VS_STOPPED);
 
 	/* We ALWAYS set the stopped state. Even when the vehicle does not plan on
 	 * stopping in the depot, so we stop it to ensure that it will not reserve
@@ -981,95 +1163,204 @@ static void RunEconomyVehicleDayProc()
 	}
 }
 
-void CallVehicleTicks()
+/**
+ * Get all vehicles of a company buildable type, including every articulated part and wagon.
+ * The lists are rebuilt lazily when vehicles of these types have been created or deleted.
+ * @param type The vehicle type.
+ * @return The indices of the vehicles of the type, in pool order.
+ */
+static const std::vector<VehicleID> &GetVehiclesOfType(VehicleType type)
 {
-	_vehicles_to_autoreplace.clear();
-
-	RunEconomyVehicleDayProc();
+	assert(IsCompanyBuildableVehicleType(type));
 
-	{
-		PerformanceMeasurer framerate(PFE_GL_ECONOMY);
-		for (Station *st : Station::Iterate()) LoadUnloadStation(st);
+	if (_vehicles_by_type_dirty) {
+		for (auto &list : _vehicles_by_type) list.clear();
+		for (const Vehicle *v : Vehicle::Iterate()) {
+			if (IsCompanyBuildableVehicleType(v)) _vehicles_by_type[v->type].push_back(v->index);
+		}
+		_vehicles_by_type_dirty = false;
 	}
-	PerformanceAccumulator::Reset(PFE_GL_TRAINS);
-	PerformanceAccumulator::Reset(PFE_GL_ROADVEHS);
-	PerformanceAccumulator::Reset(PFE_GL_SHIPS);
-	PerformanceAccumulator::Reset(PFE_GL_AIRCRAFT);
 
-	for (Vehicle *v : Vehicle::Iterate()) {
-		[[maybe_unused]] size_t vehicle_index = v->index;
+	return _vehicles_by_type[type];
+}
 
-		/* Vehicle could be deleted in this tick */
-		if (!v->Tick()) {
-			assert(Vehicle::Get(vehicle_index) == nullptr);
-			continue;
+/* Which parts of each vehicle type play the motion sounds. */
+static bool HasMotionSound(const Train *t) { return t->IsEngine(); }
+static bool HasMotionSound(const RoadVehicle *rv) { return rv->IsFrontEngine(); }
+static bool HasMotionSound(const Ship *) { return true; }
+static bool HasMotionSound(const Aircraft *a) { return a->IsNormalAircraft(); }
+
+/**
+ * Motion sound phase of the vehicle tick for one vehicle type.
+ * @tparam T The vehicle type to play the sounds for.
+ */
+template <class T>
+static void RunVehicleMotionSounds()
+{
+	for (VehicleID index : GetVehiclesOfType(T::EXPECTED_TYPE)) {
+		T *v = T::Get(index);
+
+		/* Do not play any sound when in depot or tunnel */
+		if (v->vehstatus & VS_HIDDEN) continue;
+
+		if (!HasMotionSound(v)) continue;
+
+		Vehicle *front = v->First();
+
+		/* Do not play any sound when crashed */
+		if (front->vehstatus & VS_CRASHED) continue;
+
+		/* Do not play any sound when stopped */
+		if ((front->vehstatus & VS_STOPPED) && (front->type != VEH_TRAIN || front->cur_speed == 0)) continue;
+
+		v->motion_counter += front->cur_speed;
+		/* Play a running sound if the motion counter passes 256 (Do we not skip sounds?) */
+		if (GB(v->motion_counter, 0, 8) < front->cur_speed) PlayVehicleSound(v, VSE_RUNNING);
+
+		/* Play an alternating running sound every 16 ticks */
+		if (GB(v->tick_counter, 0, 4) == 0) {
+			/* Play running sound when speed > 0 and not braking */
+			bool running = (front->cur_speed > 0) && !(front->vehstatus & (VS_STOPPED | VS_TRAIN_SLOWING));
+			PlayVehicleSound(v, running ? VSE_RUNNING_16 : VSE_STOPPED_16);
 		}
+	}
+}
 
-		assert(Vehicle::Get(vehicle_index) == v);
+/**
+ * Age the cargo of a set of vehicles.
+ * Each vehicle only touches its own cargo list, so disjoint sets may be processed concurrently.
+ * @param vehicles The vehicles to age the cargo of.
+ */
+static void AgeVehicleCargo(std::span<Vehicle * const> vehicles)
+{
+	for (Vehicle *v : vehicles) {
+		v->cargo_age_counter = std::min(v->cargo_age_counter, v->vcache.cached_cargo_age_period);
+		if (--v->cargo_age_counter == 0) {
+			v->cargo.AgeCargo();
+			v->cargo_age_counter = v->vcache.cached_cargo_age_period;
+		}
+	}
+}
 
-		switch (v->type) {
-			default: break;
+bool _interpolate_vehicles; ///< Whether to draw vehicles in between their positions of two ticks.
+static std::vector<VehicleID> _moved_vehicles; ///< The vehicles that moved during the last tick, and are interpolated.
+static uint _vehicle_interpolation = VEHICLE_INTERPOLATION_STEPS; ///< How far the moved vehicles are drawn towards their current position.
 
-			case VEH_TRAIN:
-			case VEH_ROAD:
-			case VEH_AIRCRAFT:
-			case VEH_SHIP: {
-				Vehicle *front = v->First();
+/**
+ * Remember where all vehicles are at the start of a tick, so they can be drawn in between
+ * there and where they are at the end of the tick.
+ */
+static void RecordVehicleTickStartPositions()
+{
+	for (Vehicle *v : Vehicle::Iterate()) {
+		v->tick_start_x_pos = v->x_pos;
+		v->tick_start_y_pos = v->y_pos;
+		v->tick_start_z_pos = v->z_pos;
+	}
+}
 
-				if (v->vcache.cached_cargo_age_period != 0) {
-					v->cargo_age_counter = std::min(v->cargo_age_counter, v->vcache.cached_cargo_age_period);
-					if (--v->cargo_age_counter == 0) {
-						v->cargo.AgeCargo();
-						v->cargo_age_counter = v->vcache.cached_cargo_age_period;
-					}
-				}
+/**
+ * Find the vehicles that moved during the tick, so they are redrawn while they are interpolated.
+ * All other vehicles, including new ones and the ones that jumped rather than moved, are drawn
+ * at their current position until the next tick.
+ */
+static void FindMovedVehicles()
+{
+	_moved_vehicles.clear();
+	_vehicle_interpolation = VEHICLE_INTERPOLATION_STEPS;
 
-				/* Do not play any sound when crashed */
-				if (front->vehstatus & VS_CRASHED) continue;
+	for (Vehicle *v : Vehicle::Iterate()) {
+		if (v->tick_start_x_pos == INVALID_COORD) continue;
 
-				/* Do not play any sound when in depot or tunnel */
-				if (v->vehstatus & VS_HIDDEN) continue;
+		bool still = v->tick_start_x_pos == v->x_pos && v->tick_start_y_pos == v->y_pos && v->tick_start_z_pos == v->z_pos;
+		bool jumped = std::abs(v->x_pos - v->tick_start_x_pos) + std::abs(v->y_pos - v->tick_start_y_pos) > (int)TILE_SIZE;
+		if (still || jumped) {
+			v->tick_start_x_pos = INVALID_COORD;
+			continue;
+		}
 
-				/* Do not play any sound when stopped */
-				if ((front->vehstatus & VS_STOPPED) && (front->type != VEH_TRAIN || front->cur_speed == 0)) continue;
+		_moved_vehicles.push_back(v->index);
+	}
+}
 
-				/* Check vehicle type specifics */
-				switch (v->type) {
-					case VEH_TRAIN:
-						if (!Train::From(v)->IsEngine()) continue;
-						break;
+/**
+ * Cargo aging phase of the vehicle tick.
+ * This runs after all vehicles have been ticked in pool order, so the outcome does not depend
+ * on the number of threads used. When #_game_loop_threads allows it, the vehicles of each
+ * type are split into chunks that are aged concurrently; the time is accounted to the
+ * framerate element of the vehicle type.
+ */
+static void RunVehicleCargoAging()
+{
+	static const PerformanceElement type_elements[VEH_COMPANY_END] = { PFE_GL_TRAINS, PFE_GL_ROADVEHS, PFE_GL_SHIPS, PFE_GL_AIRCRAFT };
+	static std::vector<Vehicle *> vehicles[VEH_COMPANY_END];
 
-					case VEH_ROAD:
-						if (!RoadVehicle::From(v)->IsFrontEngine()) continue;
-						break;
+	for (VehicleType type = VEH_BEGIN; type < VEH_COMPANY_END; type++) {
+		PerformanceAccumulator framerate(type_elements[type]);
 
-					case VEH_AIRCRAFT:
-						if (!Aircraft::From(v)->IsNormalAircraft()) continue;
-						break;
+		vehicles[type].clear();
+		for (VehicleID index : GetVehiclesOfType(type)) {
+			Vehicle *v = Vehicle::Get(index);
+			if (v->vcache.cached_cargo_age_period != 0) vehicles[type].push_back(v);
+		}
 
-					default:
-						break;
-				}
+		RunInChunks(std::span<Vehicle * const>(vehicles[type]), MIN_VEHICLES_PER_TICK_THREAD, AgeVehicleCargo);
+	}
+}
 
-				v->motion_counter += front->cur_speed;
-				/* Play a running sound if the motion counter passes 256 (Do we not skip sounds?) */
-				if (GB(v->motion_counter, 0, 8) < front->cur_speed) PlayVehicleSound(v, VSE_RUNNING);
+void CallVehicleTicks()
+{
+	_vehicles_to_autoreplace.clear();
+	GrowVehicleTileHashIfNeeded();
 
-				/* Play an alternating running sound every 16 ticks */
-				if (GB(v->tick_counter, 0, 4) == 0) {
-					/* Play running sound when speed > 0 and not braking */
-					bool running = (front->cur_speed > 0) && !(front->vehstatus & (VS_STOPPED | VS_TRAIN_SLOWING));
-					PlayVehicleSound(v, running ? VSE_RUNNING_16 : VSE_STOPPED_16);
-				}
+	RunEconomyVehicleDayProc();
 
-				break;
+	{
+		PerformanceMeasurer framerate(PFE_GL_ECONOMY);
+		LoadUnloadStations();
+	}
+	PerformanceAccumulator::Reset(PFE_GL_TRAINS);
+	PerformanceAccumulator::Reset(PFE_GL_ROADVEHS);
+	PerformanceAccumulator::Reset(PFE_GL_SHIPS);
+	PerformanceAccumulator::Reset(PFE_GL_AIRCRAFT);
+
+	if (_interpolate_vehicles) RecordVehicleTickStartPositions();
+
+	PostponeLevelCrossingOpening();
+	{
+		/* Thousands of vehicle parts are marked dirty while moving, and the viewports do not change meanwhile. */
+		ViewportSnapshot viewport_snapshot;
+		for (Vehicle *v : Vehicle::Iterate()) {
+			[[maybe_unused]] size_t vehicle_index = v->index;
+
+			/* Vehicle could be deleted in this tick */
+			if (!v->Tick()) {
+				assert(Vehicle::Get(vehicle_index) == nullptr);
+				continue;
 			}
+
+			assert(Vehicle::Get(vehicle_index) == v);
 		}
 	}
+	OpenPostponedLevelCrossings();
+
+	RunQueuedShipPathSearches();
+
+	if (_interpolate_vehicles) FindMovedVehicles();
+
+	RunVehicleMotionSounds<Train>();
+	RunVehicleMotionSounds<RoadVehicle>();
+	RunVehicleMotionSounds<Ship>();
+	RunVehicleMotionSounds<Aircraft>();
+	RunVehicleCargoAging();
+
+	/* Number of vehicles that may still be replaced this tick; the others try again at their next depot visit. */
+	uint budget = _settings_game.vehicle.max_autoreplace_per_tick;
+	if (budget == 0) budget = UINT_MAX;
 
 	Backup<CompanyID> cur_company(_current_company);
 	for (auto &it : _vehicles_to_autoreplace) {
-		Vehicle *v = it.first;
+		Vehicle *v = Vehicle::Get(it.first);
 		/* Autoreplace needs the current company set as the vehicle owner */
 		cur_company.Change(v->owner);
 
@@ -1078,6 +1369,8 @@ void CallVehicleTicks()
 		 * they are already leaving the depot again before being replaced. */
 		if (it.second) v->vehstatus &= ~VS_STOPPED;
 
+		if (budget == 0) continue;
+
 		/* Store the position of the effect as the vehicle pointer will become invalid later */
 		int x = v->x_pos;
 		int y = v->y_pos;
@@ -1088,6 +1381,8 @@ void CallVehicleTicks()
 		CommandCost res = Command<CMD_AUTOREPLACE_VEHICLE>::Do(DC_EXEC, v->index);
 		SubtractMoneyFromCompany(CommandCost(EXPENSES_NEW_VEHICLES, -(Money)c->settings.engine_renew_money));
 
+		if (res.Succeeded() || res.GetErrorMessage() != STR_ERROR_AUTOREPLACE_NOTHING_TO_DO) budget--;
+
 		if (!IsLocalCompany()) continue;
 
 		if (res.Succeeded()) {
@@ -1115,6 +1410,55 @@ void CallVehicleTicks()
 	cur_company.Restore();
 }
 
+/**
+ * Get the position to draw a vehicle at, in between its positions at the start and at the end of the last tick.
+ * @param v The vehicle.
+ * @param[out] x The x coordinate.
+ * @param[out] y The y coordinate.
+ * @param[out] z The z coordinate.
+ */
+static void GetVehicleDrawPosition(const Vehicle *v, int32_t &x, int32_t &y, int32_t &z)
+{
+	x = v->x_pos;
+	y = v->y_pos;
+	z = v->z_pos;
+	if (_vehicle_interpolation == VEHICLE_INTERPOLATION_STEPS || v->tick_start_x_pos == INVALID_COORD) return;
+
+	int remaining = VEHICLE_INTERPOLATION_STEPS - _vehicle_interpolation;
+	x -= (v->x_pos - v->tick_start_x_pos) * remaining / (int)VEHICLE_INTERPOLATION_STEPS;
+	y -= (v->y_pos - v->tick_start_y_pos) * remaining / (int)VEHICLE_INTERPOLATION_STEPS;
+	z -= (v->z_pos - v->tick_start_z_pos) * remaining / (int)VEHICLE_INTERPOLATION_STEPS;
+}
+
+/**
+ * Set how far the vehicles that moved in the last tick are drawn towards their new position,
+ * and mark them dirty when that changed. This way vehicles move smoothly when the screen is
+ * drawn more often than the game ticks.
+ * @param progress The time since the last tick, in #VEHICLE_INTERPOLATION_STEPS of the time between ticks.
+ */
+void InterpolateVehicles(uint progress)
+{
+	if (!_interpolate_vehicles || _pause_mode != PM_UNPAUSED) progress = VEHICLE_INTERPOLATION_STEPS;
+	progress = std::min(progress, VEHICLE_INTERPOLATION_STEPS);
+	if (progress == _vehicle_interpolation) return;
+
+	_vehicle_interpolation = progress;
+	ViewportSnapshot viewport_snapshot;
+	for (VehicleID index : _moved_vehicles) {
+		const Vehicle *v = Vehicle::GetIfValid(index);
+		if (v == nullptr || (v->vehstatus & VS_HIDDEN) != 0 || v->coord.left == INVALID_COORD || v->tick_start_x_pos == INVALID_COORD) continue;
+
+		/* The vehicle is drawn somewhere between its bounding box at the start of the tick and the current one. */
+		Point start = RemapCoords(v->tick_start_x_pos, v->tick_start_y_pos, v->tick_start_z_pos);
+		Point end = RemapCoords(v->x_pos, v->y_pos, v->z_pos);
+		int dx = start.x - end.x;
+		int dy = start.y - end.y;
+		::MarkAllViewportsDirty(
+				v->coord.left + std::min(dx, 0), v->coord.top + std::min(dy, 0),
+				v->coord.right + std::max(dx, 0), v->coord.bottom + std::max(dy, 0));
+	}
+}
+
 /**
  * Add vehicle sprite for drawing to the screen.
  * @param v Vehicle to draw.
@@ -1135,12 +1479,15 @@ static void DoDrawVehicle(const Vehicle *v)
 		if (to != TO_INVALID && (IsTransparencySet(to) || IsInvisibilitySet(to))) return;
 	}
 
+	int32_t x, y, z;
+	GetVehicleDrawPosition(v, x, y, z);
+
 	StartSpriteCombine();
 	for (uint i = 0; i < v->sprite_cache.sprite_seq.count; ++i) {
 		PaletteID pal2 = v->sprite_cache.sprite_seq.seq[i].pal;
 		if (!pal2 || (v->vehstatus & VS_CRASHED)) pal2 = pal;
-		AddSortableSpriteToDraw(v->sprite_cache.sprite_seq.seq[i].sprite, pal2, v->x_pos + v->x_offs, v->y_pos + v->y_offs,
-			v->x_extent, v->y_extent, v->z_extent, v->z_pos, shadowed, v->x_bb_offs, v->y_bb_offs);
+		AddSortableSpriteToDraw(v->sprite_cache.sprite_seq.seq[i].sprite, pal2, x + v->x_offs, y + v->y_offs,
+			v->x_extent, v->y_extent, v->z_extent, z, shadowed, v->x_bb_offs, v->y_bb_offs);
 	}
 	EndSpriteCombine();
 }
@@ -1625,7 +1972,7 @@ void VehicleEnterDepot(Vehicle *v)
 			cur_company.Restore();
 
 			if (cost.Failed()) {
-				_vehicles_to_autoreplace[v] = false;
+				_vehicles_to_autoreplace[v->index] = false;
 				if (v->owner == _local_company) {
 					/* Notify the user that we stopped the vehicle */
 					SetDParam(0, v->index);
@@ -1647,7 +1994,7 @@ void VehicleEnterDepot(Vehicle *v)
 		}
 		if (v->current_order.GetDepotActionType() & ODATFB_HALT) {
 			/* Vehicles are always stopped on entering depots. Do not restart this one. */
-			_vehicles_to_autoreplace[v] = false;
+			_vehicles_to_autoreplace[v->index] = false;
 			/* Invalidate last_loading_station. As the link from the station
 			 * before the stop to the station after the stop can't be predicted
 			 * we shouldn't construct it when the vehicle visits the next stop. */
@@ -1825,7 +2172,15 @@ Direction GetDirectionTowards(const Vehicle *v, int x, int y)
  */
 VehicleEnterTileStatus VehicleEnterTile(Vehicle *v, TileIndex tile, int x, int y)
 {
-	return _tile_type_procs[GetTileType(tile)]->vehicle_enter_tile_proc(v, tile, x, y);
+	/* This is called for every step of many vehicles, so avoid the indirect call via the tile type procs. */
+	switch (GetTileType(tile)) {
+		case MP_RAILWAY:      return VehicleEnter_Track(v, tile, x, y);
+		case MP_ROAD:         return VehicleEnter_Road(v, tile, x, y);
+		case MP_STATION:      return VehicleEnter_Station(v, tile, x, y);
+		case MP_TUNNELBRIDGE: return VehicleEnter_TunnelBridge(v, tile, x, y);
+		case MP_WATER:        return VehicleEnter_Water(v, tile, x, y);
+		default:              return _tile_type_procs[GetTileType(tile)]->vehicle_enter_tile_proc(v, tile, x, y);
+	}
 }
 
 /**
@@ -2997,7 +3352,7 @@ void Vehicle::RemoveFromShared()
 	} else if (were_first) {
 		/* If we were the first one, update to the new first one.
 		 * Note: FirstShared() is already the new first */
-		InvalidateWindowData(GetWindowClassForVehicleType(this->type), vli.Pack(), this->FirstShared()->index | (1U << 31));
+		InvalidateWindowDataImmediately(GetWindowClassForVehicleType(this->type), vli.Pack(), this->FirstShared()->index | (1U << 31));
 	}
 
 	this->next_shared     = nullptr;
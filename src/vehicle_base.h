@@ -196,6 +196,20 @@ struct MutableSpriteCache {
 	VehicleSpriteSeq sprite_seq;  ///< Vehicle appearance.
 };
 
+/**
+ * The last NewGRF sprite resolved for a vehicle, without the direction applied.
+ * It is only kept when the resolve read nothing but the variables of the
+ * vehicle that only change together with Vehicle::InvalidateNewGRFCache().
+ */
+struct NewGRFSpriteCache {
+	bool valid = false;                ///< Whether the cached sprites are valid.
+	EngineID engine;                   ///< Engine the sprites were resolved for.
+	EngineImageType image_type;        ///< Image type the sprites were resolved for.
+	uint count;                        ///< Number of sprites in the sprite stack.
+	PalSpriteID sprites[lengthof(VehicleSpriteSeq::seq)]; ///< First sprite of each sprite set of the stack, and its recolouring.
+	uint num_results[lengthof(VehicleSpriteSeq::seq)];    ///< Number of sprites in each sprite set of the stack.
+};
+
 /** A vehicle pool for a little over 1 million vehicles. */
 typedef Pool<Vehicle, VehicleID, 512, 0xFF000> VehiclePool;
 extern VehiclePool _vehicle_pool;
@@ -273,6 +287,9 @@ public:
 	CargoPayment *cargo_payment;        ///< The cargo payment we're currently in
 
 	mutable Rect coord;                 ///< NOSAVE: Graphical bounding box of the vehicle, i.e. what to redraw on moves.
+	int32_t tick_start_x_pos;           ///< NOSAVE: x coordinate at the start of the last tick, or #INVALID_COORD when the vehicle is not interpolated; see #InterpolateVehicles.
+	int32_t tick_start_y_pos;           ///< NOSAVE: y coordinate at the start of the last tick.
+	int32_t tick_start_z_pos;           ///< NOSAVE: z coordinate at the start of the last tick.
 
 	Vehicle *hash_viewport_next;        ///< NOSAVE: Next vehicle in the visual location hash.
 	Vehicle **hash_viewport_prev;       ///< NOSAVE: Previous vehicle in the visual location hash.
@@ -280,6 +297,7 @@ public:
 	Vehicle *hash_tile_next;            ///< NOSAVE: Next vehicle in the tile location hash.
 	Vehicle **hash_tile_prev;           ///< NOSAVE: Previous vehicle in the tile location hash.
 	Vehicle **hash_tile_current;        ///< NOSAVE: Cache of the current hash chain.
+	TileIndex hash_tile_counted;        ///< NOSAVE: Tile at which this train is counted in the train occupancy, or INVALID_TILE.
 
 	SpriteID colourmap;                 ///< NOSAVE: cached colour mapping
 
@@ -362,6 +380,7 @@ public:
 	GroupID group_id;                   ///< Index of group Pool array
 
 	mutable MutableSpriteCache sprite_cache; ///< Cache of sprites and values related to recalculating them, see #MutableSpriteCache
+	mutable NewGRFSpriteCache grf_sprite_cache; ///< Cache of the last resolved NewGRF sprite, see #NewGRFSpriteCache
 
 	/**
 	 * Calculates the weight value that this vehicle will have when fully loaded with its current cargo.
@@ -402,6 +421,14 @@ public:
 	 */
 	virtual void MarkDirty() {}
 
+	/**
+	 * Marks the vehicles to be redrawn and updates cached variables after
+	 * only the amount of cargo in some of its parts changed.
+	 *
+	 * @ingroup dirty
+	 */
+	virtual void MarkCargoAmountDirty() { this->MarkDirty(); }
+
 	/**
 	 * Updates the x and y offsets and the size of the sprite used
 	 * for this vehicle.
@@ -491,6 +518,7 @@ public:
 	inline void InvalidateNewGRFCache()
 	{
 		this->grf_cache.cache_valid = 0;
+		this->grf_sprite_cache.valid = false;
 	}
 
 	/**
@@ -1281,4 +1309,70 @@ struct SpecializedVehicle : public Vehicle {
 /** Sentinel for an invalid coordinate. */
 static const int32_t INVALID_COORD = 0x7fffffff;
 
+Vehicle *GetFirstVehicleInTileHash(TileIndex tile);
+Vehicle *GetFirstRoadVehicleInTileHash(TileIndex tile);
+
+/**
+ * Call \a func for ALL road vehicles on a tile. Like the callback based FindVehicleOnPos,
+ * YOU must make SURE that the result does not depend on the order of the vehicles!
+ * Road vehicles are kept in a tile hash of their own, so other vehicles are not walked.
+ * @param tile The location on the map.
+ * @param func The callable, taking a Vehicle pointer.
+ */
+template <class Tfunc>
+inline void FindRoadVehicleOnPos(TileIndex tile, Tfunc &&func)
+{
+	for (Vehicle *v = GetFirstRoadVehicleInTileHash(tile); v != nullptr; v = v->hash_tile_next) {
+		if (v->tile == tile) func(v);
+	}
+}
+
+/**
+ * Checks whether a road vehicle on a tile matches a predicate. The search stops
+ * at the first road vehicle for which \a predicate returns true.
+ * @param tile The location on the map.
+ * @param predicate The callable, taking a Vehicle pointer and returning a bool.
+ * @return True iff \a predicate returned true for a road vehicle on the tile.
+ */
+template <class Tpredicate>
+inline bool HasRoadVehicleOnPos(TileIndex tile, Tpredicate &&predicate)
+{
+	for (Vehicle *v = GetFirstRoadVehicleInTileHash(tile); v != nullptr; v = v->hash_tile_next) {
+		if (v->tile == tile && predicate(v)) return true;
+	}
+	return false;
+}
+
+/**
+ * Call \a func for ALL vehicles on a tile. Like the callback based FindVehicleOnPos,
+ * YOU must make SURE that the result does not depend on the order of the vehicles!
+ * As \a func is a template parameter, it can be inlined into the hash walk.
+ * @param tile The location on the map.
+ * @param func The callable, taking a Vehicle pointer.
+ */
+template <class Tfunc>
+inline void FindVehicleOnPos(TileIndex tile, Tfunc &&func)
+{
+	for (Vehicle *v = GetFirstVehicleInTileHash(tile); v != nullptr; v = v->hash_tile_next) {
+		if (v->tile == tile) func(v);
+	}
+	FindRoadVehicleOnPos(tile, func);
+}
+
+/**
+ * Checks whether a vehicle on a tile matches a predicate. The search stops
+ * at the first vehicle for which \a predicate returns true.
+ * @param tile The location on the map.
+ * @param predicate The callable, taking a Vehicle pointer and returning a bool.
+ * @return True iff \a predicate returned true for a vehicle on the tile.
+ */
+template <class Tpredicate>
+inline bool HasVehicleOnPos(TileIndex tile, Tpredicate &&predicate)
+{
+	for (Vehicle *v = GetFirstVehicleInTileHash(tile); v != nullptr; v = v->hash_tile_next) {
+		if (v->tile == tile && predicate(v)) return true;
+	}
+	return HasRoadVehicleOnPos(tile, predicate);
+}
+
 #endif /* VEHICLE_BASE_H */
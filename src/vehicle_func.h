@@ -45,7 +45,26 @@ void FindVehicleOnPos(TileIndex tile, void *data, VehicleFromPosProc *proc);
 void FindVehicleOnPosXY(int x, int y, void *data, VehicleFromPosProc *proc);
 bool HasVehicleOnPos(TileIndex tile, void *data, VehicleFromPosProc *proc);
 bool HasVehicleOnPosXY(int x, int y, void *data, VehicleFromPosProc *proc);
+std::vector<size_t> GetVehicleTileHashChainLengths(uint &bits);
+
+/**
+ * Check whether there may be a train on a tile, without walking the vehicle tile hash.
+ * @param tile The tile to check.
+ * @return False if there definitely is no train vehicle (crashed, in depot or otherwise) on the tile.
+ */
+inline bool MayHaveTrainOnTile(TileIndex tile)
+{
+	extern std::vector<uint16_t> _train_tile_occupancy;
+	return tile.base() >= _train_tile_occupancy.size() || _train_tile_occupancy[tile.base()] != 0;
+}
 void CallVehicleTicks();
+void InterpolateVehicles(uint progress);
+
+static const uint VEHICLE_INTERPOLATION_STEPS = 256; ///< Number of steps in which a vehicle is drawn between its positions of two ticks.
+extern bool _interpolate_vehicles;
+
+static const size_t MIN_VEHICLES_PER_TICK_THREAD = 512; ///< Minimum number of vehicles worth handing to an extra thread in the parallel tick phases.
+
 uint8_t CalcPercentVehicleFilled(const Vehicle *v, StringID *colour);
 
 void VehicleLengthChanged(const Vehicle *u);
@@ -225,6 +225,11 @@ void BaseVehicleListWindow::BuildVehicleList()
 
 	Debug(misc, 3, "Building vehicle list type {} for company {} given index {}", this->vli.type, this->vli.company, this->vli.index);
 
+	/* Remember the sorted order by the first vehicle of each group, so only new and changed groups need sorting again. */
+	std::vector<const Vehicle *> previous_order;
+	previous_order.reserve(this->vehgroups.size());
+	for (const GUIVehicleGroup &vg : this->vehgroups) previous_order.push_back(*vg.vehicles_begin);
+
 	this->vehgroups.clear();
 
 	GenerateVehicleSortList(&this->vehicles, this->vli);
@@ -268,6 +273,7 @@ void BaseVehicleListWindow::BuildVehicleList()
 
 		this->unitnumber_digits = CountDigitsForAllocatingSpace(max_num_vehicles);
 	}
+	this->vehgroups.RestoreOrder(previous_order, [](const GUIVehicleGroup &vg) { return *vg.vehicles_begin; });
 	this->FilterVehicleList();
 
 	this->vehgroups.RebuildDone();
@@ -60,6 +60,37 @@ bool VehicleListIdentifier::UnpackIfValid(uint32_t data)
 	return result;
 }
 
+/** The primary vehicles of every company and vehicle type, sorted by index like the vehicle pool. */
+static std::set<VehicleID> _company_vehicles[MAX_COMPANIES][VEH_COMPANY_END];
+
+/**
+ * Add or remove a primary vehicle in the vehicle list of its company.
+ * This is called whenever the group statistics count a primary vehicle, as they need the very same.
+ * @param v The primary vehicle.
+ * @param delta +1 to add, -1 to remove.
+ */
+void UpdateCompanyVehicleList(const Vehicle *v, int delta)
+{
+	assert(v->owner < MAX_COMPANIES && v->type < VEH_COMPANY_END);
+
+	std::set<VehicleID> &list = _company_vehicles[v->owner][v->type];
+	if (delta > 0) {
+		list.insert(v->index);
+	} else {
+		list.erase(v->index);
+	}
+}
+
+/**
+ * Forget all primary vehicles, before the vehicles are counted again or the vehicle pool is cleaned.
+ */
+void ResetCompanyVehicleLists()
+{
+	for (auto &lists : _company_vehicles) {
+		for (std::set<VehicleID> &list : lists) list.clear();
+	}
+}
+
 /** Data for building a depot vehicle list. */
 struct BuildDepotVehicleListData
 {
@@ -147,21 +178,21 @@ bool GenerateVehicleSortList(VehicleList *list, const VehicleListIdentifier &vli
 
 		case VL_GROUP_LIST:
 			if (vli.index != ALL_GROUP) {
-				for (const Vehicle *v : Vehicle::Iterate()) {
-					if (v->type == vli.vtype && v->IsPrimaryVehicle() &&
-							v->owner == vli.company && GroupIsInGroup(v->group_id, vli.index)) {
-						list->push_back(v);
-					}
+				if (vli.company >= MAX_COMPANIES || vli.vtype >= VEH_COMPANY_END) return false;
+
+				for (VehicleID index : _company_vehicles[vli.company][vli.vtype]) {
+					const Vehicle *v = Vehicle::Get(index);
+					if (GroupIsInGroup(v->group_id, vli.index)) list->push_back(v);
 				}
 				break;
 			}
 			[[fallthrough]];
 
 		case VL_STANDARD:
-			for (const Vehicle *v : Vehicle::Iterate()) {
-				if (v->type == vli.vtype && v->owner == vli.company && v->IsPrimaryVehicle()) {
-					list->push_back(v);
-				}
+			if (vli.company >= MAX_COMPANIES || vli.vtype >= VEH_COMPANY_END) return false;
+
+			for (VehicleID index : _company_vehicles[vli.company][vli.vtype]) {
+				list->push_back(Vehicle::Get(index));
 			}
 			break;
 
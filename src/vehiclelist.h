@@ -54,6 +54,8 @@ struct VehicleListIdentifier {
 typedef std::vector<const Vehicle *> VehicleList;
 
 bool GenerateVehicleSortList(VehicleList *list, const VehicleListIdentifier &identifier);
+void UpdateCompanyVehicleList(const Vehicle *v, int delta);
+void ResetCompanyVehicleLists();
 void BuildDepotVehicleList(VehicleType type, TileIndex tile, VehicleList *engine_list, VehicleList *wagon_list, bool individual_wagons = false);
 uint GetUnitNumberDigits(VehicleList &vehicles);
 
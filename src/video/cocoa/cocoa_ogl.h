@@ -28,6 +28,8 @@ public:
 	const char *Start(const StringList &param) override;
 	void Stop() override;
 
+	void MakeDirty(int left, int top, int width, int height) override;
+
 	bool HasEfficient8Bpp() const override { return true; }
 
 	bool UseSystemCursor() override { return true; }
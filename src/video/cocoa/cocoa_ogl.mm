@@ -291,6 +291,12 @@ void VideoDriver_CocoaOpenGL::AllocateBackingStore(bool force)
 	this->GameSizeChanged();
 }
 
+void VideoDriver_CocoaOpenGL::MakeDirty(int left, int top, int width, int height)
+{
+	this->VideoDriver_Cocoa::MakeDirty(left, top, width, height);
+	OpenGLBackend::Get()->AddDirtyRect({left, top, left + width, top + height});
+}
+
 void *VideoDriver_CocoaOpenGL::GetVideoPointer()
 {
 	CGLSetCurrentContext(this->gl_context);
@@ -13,6 +13,7 @@
 #include "../error_func.h"
 #include "../network/network.h"
 #include "../network/network_internal.h"
+#include "../network/network_func.h"
 #include "../console_func.h"
 #include "../genworld.h"
 #include "../fileio_type.h"
@@ -95,6 +96,9 @@ static void CloseWindowsConsoleThread()
 
 static void *_dedicated_video_mem;
 
+/** How long to sleep at most when the server is idle, i.e. paused and empty. */
+static const std::chrono::milliseconds DEDICATED_IDLE_TIMEOUT(500);
+
 /* Whether a fork has been done. */
 bool _dedicated_forks;
 
@@ -221,6 +225,14 @@ void VideoDriver_Dedicated::MainLoop()
 
 		ChangeGameSpeed(_ddc_fastforward);
 		this->Tick();
-		this->SleepTillNextTick();
+
+		if (NetworkServerIsIdle()) {
+			/* Nothing changes until someone connects, so sleep a lot longer than a
+			 * tick; a connecting client wakes us right away. Admins, the coordinator
+			 * and the console are handled within the timeout. */
+			NetworkServerWaitForActivity(DEDICATED_IDLE_TIMEOUT);
+		} else {
+			this->SleepTillNextTick();
+		}
 	}
 }
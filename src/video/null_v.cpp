@@ -10,6 +10,7 @@
 #include "../stdafx.h"
 #include "../gfx_func.h"
 #include "../blitter/factory.hpp"
+#include "../framerate_type.h"
 #include "../saveload/saveload.h"
 #include "../window_func.h"
 #include "null_v.h"
@@ -48,12 +49,26 @@ void VideoDriver_Null::MakeDirty(int, int, int, int) {}
 
 void VideoDriver_Null::MainLoop()
 {
-	uint i;
+	bool benchmark = !_framerate_benchmark_file.empty();
+	auto benchmark_start = std::chrono::steady_clock::now();
 
-	for (i = 0; i < this->ticks; i++) {
+	for (uint i = 0; i < this->ticks; i++) {
 		::GameLoop();
 		::InputLoop();
 		::UpdateWindows();
+
+		/* The first tick loads the game; the benchmark measures the ones after it. */
+		if (benchmark && i == 0) {
+			StartFramerateBenchmark();
+			benchmark_start = std::chrono::steady_clock::now();
+		}
+	}
+
+	if (benchmark) {
+		uint ticks = std::max(this->ticks, 1U) - 1;
+		if (!WriteFramerateBenchmark(_framerate_benchmark_file, ticks, std::chrono::steady_clock::now() - benchmark_start)) {
+			Debug(misc, 0, "Could not write the benchmark results to {}", _framerate_benchmark_file);
+		}
 	}
 
 	/* If requested, make a save just before exit. The normal exit-flow is
@@ -920,6 +920,9 @@ bool OpenGLBackend::Resize(int w, int h, bool force)
 
 	_glViewport(0, 0, w, h);
 
+	this->dirty_rects.clear();
+	this->paint_needed = true;
+
 	_glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch);
 
 	this->vid_buffer = nullptr;
@@ -1026,6 +1029,8 @@ void OpenGLBackend::UpdatePalette(const Colour *pal, uint first, uint length)
 {
 	assert(first + length <= 256);
 
+	this->paint_needed = true;
+
 	_glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 	_glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 	_glActiveTexture(GL_TEXTURE1);
@@ -1038,6 +1043,8 @@ void OpenGLBackend::UpdatePalette(const Colour *pal, uint first, uint length)
  */
 void OpenGLBackend::Paint()
 {
+	this->paint_needed = false;
+
 	_glClear(GL_COLOR_BUFFER_BIT);
 
 	_glDisable(GL_BLEND);
@@ -1100,6 +1107,17 @@ void OpenGLBackend::PopulateCursorCache()
 		this->last_sprite_pal = (PaletteID)-1;
 
 		this->InternalClearCursorCache();
+		this->paint_needed = true;
+	}
+
+	if (this->cursor_pos.x != _cursor.pos.x || this->cursor_pos.y != _cursor.pos.y || this->cursor_sprite_count != _cursor.sprite_count || this->cursor_in_window != _cursor.in_window) {
+		this->paint_needed = true;
+	}
+	for (uint i = 0; i < _cursor.sprite_count && !this->paint_needed; ++i) {
+		if (this->cursor_sprite_seq[i].sprite != _cursor.sprite_seq[i].sprite || this->cursor_sprite_seq[i].pal != _cursor.sprite_seq[i].pal ||
+				this->cursor_sprite_pos[i].x != _cursor.sprite_pos[i].x || this->cursor_sprite_pos[i].y != _cursor.sprite_pos[i].y) {
+			this->paint_needed = true;
+		}
 	}
 
 	this->cursor_pos = _cursor.pos;
@@ -1192,6 +1210,63 @@ uint8_t *OpenGLBackend::GetAnimBuffer()
 	return (uint8_t *)this->anim_buffer;
 }
 
+/**
+ * Note a changed part of the video buffer. The separate changed parts are uploaded
+ * to the textures one by one, so two small changes far apart do not cause an upload
+ * of the whole screen in between, which matters with large screen resolutions.
+ * @param r The changed rectangle.
+ */
+void OpenGLBackend::AddDirtyRect(const Rect &r)
+{
+	/* Beyond this many separate parts, uploading them all costs more than uploading some pixels twice. */
+	static const size_t MAX_DIRTY_RECTS = 16;
+
+	if (IsEmptyRect(r)) return;
+
+	/* Merge the rectangle with all rectangles it overlaps or touches, also after it grew by merging. */
+	Rect add = r;
+	for (bool merged = true; merged; ) {
+		merged = false;
+		for (auto it = this->dirty_rects.begin(); it != this->dirty_rects.end(); ++it) {
+			if (it->left <= add.right && add.left <= it->right && it->top <= add.bottom && add.top <= it->bottom) {
+				add = BoundingRect(add, *it);
+				this->dirty_rects.erase(it);
+				merged = true;
+				break;
+			}
+		}
+	}
+
+	if (this->dirty_rects.size() >= MAX_DIRTY_RECTS) {
+		/* Merge with the rectangle that grows least by it. */
+		auto area = [](const Rect &r) { return static_cast<int64_t>(r.right - r.left) * (r.bottom - r.top); };
+		auto best = std::min_element(this->dirty_rects.begin(), this->dirty_rects.end(), [&](const Rect &a, const Rect &b) {
+			return area(BoundingRect(a, add)) - area(a) < area(BoundingRect(b, add)) - area(b);
+		});
+		add = BoundingRect(add, *best);
+		this->dirty_rects.erase(best);
+	}
+
+	this->dirty_rects.push_back(add);
+}
+
+/**
+ * Get the parts of the video and animation buffers to upload. These are the separate
+ * changed parts from #AddDirtyRect, unless the video driver knows of other changes.
+ * @param update_rect Rectangle encompassing the dirty region of the buffers.
+ * @return The rectangles to upload.
+ */
+std::vector<Rect> OpenGLBackend::GetUploadRects(const Rect &update_rect) const
+{
+	if (IsEmptyRect(update_rect)) return {};
+
+	Rect bounds = {};
+	for (const Rect &r : this->dirty_rects) bounds = BoundingRect(bounds, r);
+	if (bounds.left != update_rect.left || bounds.top != update_rect.top || bounds.right != update_rect.right || bounds.bottom != update_rect.bottom) return { update_rect };
+
+	return this->dirty_rects;
+}
+
 /**
  * Update video buffer texture after the video buffer was filled.
  * @param update_rect Rectangle encompassing the dirty region of the video buffer.
@@ -1213,16 +1288,21 @@ void OpenGLBackend::ReleaseVideoBuffer(const Rect &update_rect)
 	}
 #endif
 
-	/* Update changed rect of the video buffer texture. */
-	if (!IsEmptyRect(update_rect)) {
+	/* Update changed rects of the video buffer texture. */
+	std::vector<Rect> upload_rects = this->GetUploadRects(update_rect);
+	this->dirty_rects.clear();
+	if (!upload_rects.empty()) {
 		_glActiveTexture(GL_TEXTURE0);
 		_glBindTexture(GL_TEXTURE_2D, this->vid_texture);
 		_glPixelStorei(GL_UNPACK_ROW_LENGTH, _screen.pitch);
-		if (BlitterFactory::GetCurrentBlitter()->GetScreenDepth() == 8) {
-			_glTexSubImage2D(GL_TEXTURE_2D, 0, update_rect.left, update_rect.top, update_rect.right - update_rect.left, update_rect.bottom - update_rect.top, GL_RED, GL_UNSIGNED_BYTE, (GLvoid*)(size_t)(update_rect.top * _screen.pitch + update_rect.left));
-		} else {
-			_glTexSubImage2D(GL_TEXTURE_2D, 0, update_rect.left, update_rect.top, update_rect.right - update_rect.left, update_rect.bottom - update_rect.top, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, (GLvoid*)(size_t)(update_rect.top * _screen.pitch * 4 + update_rect.left * 4));
+		for (const Rect &r : upload_rects) {
+			if (BlitterFactory::GetCurrentBlitter()->GetScreenDepth() == 8) {
+				_glTexSubImage2D(GL_TEXTURE_2D, 0, r.left, r.top, r.right - r.left, r.bottom - r.top, GL_RED, GL_UNSIGNED_BYTE, (GLvoid*)(size_t)(r.top * _screen.pitch + r.left));
+			} else {
+				_glTexSubImage2D(GL_TEXTURE_2D, 0, r.left, r.top, r.right - r.left, r.bottom - r.top, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, (GLvoid*)(size_t)(r.top * _screen.pitch * 4 + r.left * 4));
+			}
 		}
+		this->paint_needed = true;
 
 #ifndef NO_GL_BUFFER_SYNC
 		if (this->persistent_mapping_supported) this->sync_vid_mapping = _glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
@@ -1251,12 +1331,16 @@ void OpenGLBackend::ReleaseAnimBuffer(const Rect &update_rect)
 	}
 #endif
 
-	/* Update changed rect of the video buffer texture. */
-	if (update_rect.left != update_rect.right) {
+	/* Update changed rects of the animation buffer texture; the video buffer is released later and forgets them. */
+	std::vector<Rect> upload_rects = this->GetUploadRects(update_rect);
+	if (!upload_rects.empty()) {
 		_glActiveTexture(GL_TEXTURE0);
 		_glBindTexture(GL_TEXTURE_2D, this->anim_texture);
 		_glPixelStorei(GL_UNPACK_ROW_LENGTH, _screen.pitch);
-		_glTexSubImage2D(GL_TEXTURE_2D, 0, update_rect.left, update_rect.top, update_rect.right - update_rect.left, update_rect.bottom - update_rect.top, GL_RED, GL_UNSIGNED_BYTE, (GLvoid *)(size_t)(update_rect.top * _screen.pitch + update_rect.left));
+		for (const Rect &r : upload_rects) {
+			_glTexSubImage2D(GL_TEXTURE_2D, 0, r.left, r.top, r.right - r.left, r.bottom - r.top, GL_RED, GL_UNSIGNED_BYTE, (GLvoid *)(size_t)(r.top * _screen.pitch + r.left));
+		}
+		this->paint_needed = true;
 
 #ifndef NO_GL_BUFFER_SYNC
 		if (this->persistent_mapping_supported) this->sync_anim_mapping = _glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
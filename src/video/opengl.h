@@ -46,6 +46,9 @@ private:
 	GLuint anim_pbo;     ///< Pixel buffer object storing the memory used for the animation buffer.
 	GLuint anim_texture; ///< Texture handle for the animation buffer texture.
 
+	std::vector<Rect> dirty_rects; ///< Separate changed parts of the video and animation buffers since the last upload.
+	bool paint_needed;             ///< Whether anything on the screen changed since the last paint.
+
 	GLuint remap_program;    ///< Shader program for blending and rendering a RGBA + remap texture.
 	GLint  remap_sprite_loc; ///< Uniform location for sprite parameters.
 	GLint  remap_screen_loc; ///< Uniform location for screen size.
@@ -79,6 +82,8 @@ private:
 
 	void RenderOglSprite(OpenGLSprite *gl_sprite, PaletteID pal, int x, int y, ZoomLevel zoom);
 
+	std::vector<Rect> GetUploadRects(const Rect &update_rect) const;
+
 public:
 	/** Get singleton instance of this class. */
 	static inline OpenGLBackend *Get()
@@ -96,12 +101,19 @@ public:
 	bool Resize(int w, int h, bool force = false);
 	void Paint();
 
+	/**
+	 * Check whether the screen has to be painted again, as the textures, the palette or the cursor changed.
+	 * @return True iff painting would show anything new.
+	 */
+	inline bool NeedsPaint() const { return this->paint_needed; }
+
 	void DrawMouseCursor();
 	void PopulateCursorCache();
 	void ClearCursorCache();
 
 	void *GetVideoBuffer();
 	uint8_t *GetAnimBuffer();
+	void AddDirtyRect(const Rect &r);
 	void ReleaseVideoBuffer(const Rect &update_rect);
 	void ReleaseAnimBuffer(const Rect &update_rect);
 
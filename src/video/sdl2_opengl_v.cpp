@@ -155,6 +155,12 @@ bool VideoDriver_SDL_OpenGL::AllocateBackingStore(int w, int h, bool force)
 	return res;
 }
 
+void VideoDriver_SDL_OpenGL::MakeDirty(int left, int top, int width, int height)
+{
+	this->VideoDriver_SDL_Base::MakeDirty(left, top, width, height);
+	OpenGLBackend::Get()->AddDirtyRect({left, top, left + width, top + height});
+}
+
 void *VideoDriver_SDL_OpenGL::GetVideoPointer()
 {
 	if (BlitterFactory::GetCurrentBlitter()->NeedsAnimationBuffer()) {
@@ -187,6 +193,9 @@ void VideoDriver_SDL_OpenGL::Paint()
 		this->local_palette.count_dirty = 0;
 	}
 
+	/* Nothing changed, so presenting the frame again is a waste. Without vsync nothing waits for a swap of buffers. */
+	if (!_video_vsync && !OpenGLBackend::Get()->NeedsPaint()) return;
+
 	OpenGLBackend::Get()->Paint();
 	OpenGLBackend::Get()->DrawMouseCursor();
 
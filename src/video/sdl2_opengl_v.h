@@ -18,6 +18,8 @@ public:
 
 	void Stop() override;
 
+	void MakeDirty(int left, int top, int width, int height) override;
+
 	bool HasEfficient8Bpp() const override { return true; }
 
 	bool UseSystemCursor() override { return true; }
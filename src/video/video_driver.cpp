@@ -14,12 +14,14 @@
 #include "../debug.h"
 #include "../driver.h"
 #include "../fontcache.h"
+#include "../framerate_type.h"
 #include "../gfx_func.h"
 #include "../gfxinit.h"
 #include "../progress.h"
 #include "../rev.h"
 #include "../thread.h"
 #include "../window_func.h"
+#include "../vehicle_func.h"
 #include "video_driver.hpp"
 
 bool _video_hw_accel; ///< Whether to consider hardware accelerated video drivers on startup.
@@ -27,10 +29,19 @@ bool _video_vsync; ///< Whether we should use vsync (only if active video driver
 
 void VideoDriver::GameLoop()
 {
+	auto now = std::chrono::steady_clock::now();
+
+	/* How late this tick starts is only of interest when ticks are meant to run back to back. */
+	if (_pause_mode != PM_UNPAUSED) {
+		PerformanceMeasurer::Paused(PFE_GL_LATENESS);
+	} else {
+		PerformanceAccumulator::Reset(PFE_GL_LATENESS);
+		PerformanceAccumulator::Add(PFE_GL_LATENESS, std::chrono::duration_cast<std::chrono::microseconds>(now - this->next_game_tick));
+	}
+
 	this->next_game_tick += this->GetGameInterval();
 
 	/* Avoid next_game_tick getting behind more and more if it cannot keep up. */
-	auto now = std::chrono::steady_clock::now();
 	if (this->next_game_tick < now - ALLOWED_DRIFT * this->GetGameInterval()) this->next_game_tick = now;
 
 	{
@@ -146,6 +157,11 @@ void VideoDriver::Tick()
 
 			::InputLoop();
 
+			/* Draw the vehicles that moved in between their positions of the last two ticks, by the time since the last tick. */
+			auto game_interval = this->GetGameInterval();
+			auto since_tick = std::chrono::steady_clock::now() - (this->next_game_tick - game_interval);
+			::InterpolateVehicles(game_interval.count() <= 0 || since_tick >= game_interval ? VEHICLE_INTERPOLATION_STEPS : static_cast<uint>(std::max<int64_t>(0, since_tick * VEHICLE_INTERPOLATION_STEPS / game_interval)));
+
 			/* Prevent drawing when switching mode, as windows can be removed when they should still appear. */
 			if (_game_mode == GM_BOOTSTRAP || _switch_mode == SM_NONE || HasModalProgress()) {
 				::UpdateWindows();
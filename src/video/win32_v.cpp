@@ -1480,6 +1480,12 @@ bool VideoDriver_Win32OpenGL::AllocateBackingStore(int w, int h, bool force)
 	return res;
 }
 
+void VideoDriver_Win32OpenGL::MakeDirty(int left, int top, int width, int height)
+{
+	this->VideoDriver_Win32Base::MakeDirty(left, top, width, height);
+	OpenGLBackend::Get()->AddDirtyRect({left, top, left + width, top + height});
+}
+
 void *VideoDriver_Win32OpenGL::GetVideoPointer()
 {
 	if (BlitterFactory::GetCurrentBlitter()->NeedsAnimationBuffer()) {
@@ -1513,6 +1519,9 @@ void VideoDriver_Win32OpenGL::Paint()
 		_local_palette.count_dirty = 0;
 	}
 
+	/* Nothing changed, so presenting the frame again is a waste. Without vsync nothing waits for a swap of buffers. */
+	if (!_video_vsync && !OpenGLBackend::Get()->NeedsPaint()) return;
+
 	OpenGLBackend::Get()->Paint();
 	OpenGLBackend::Get()->DrawMouseCursor();
 
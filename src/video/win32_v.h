@@ -124,6 +124,8 @@ public:
 
 	void Stop() override;
 
+	void MakeDirty(int left, int top, int width, int height) override;
+
 	bool ToggleFullscreen(bool fullscreen) override;
 
 	bool AfterBlitterChange() override;
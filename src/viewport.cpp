@@ -85,14 +85,19 @@
 #include "town_kdtree.h"
 #include "viewport_sprite_sorter.h"
 #include "bridge_map.h"
+#include "water_map.h"
 #include "company_base.h"
 #include "command_func.h"
 #include "network/network_func.h"
 #include "framerate_type.h"
 #include "viewport_cmd.h"
+#include "spritecache.h"
+#include "task_pool.h"
+#include "smallmap_gui.h"
 
 #include <forward_list>
 #include <stack>
+#include <unordered_map>
 
 #include "table/strings.h"
 #include "table/string_colours.h"
@@ -181,10 +186,65 @@ struct ViewportDrawer {
 	Point foundation_offset[FOUNDATION_PART_END];    ///< Pixel offset for ground sprites on the foundations.
 };
 
+/** What is drawn of a viewport. */
+enum ViewportDrawLayers : uint8_t {
+	VDL_LANDSCAPE = 1 << 0, ///< The tiles, with their buildings, foundations and selections.
+	VDL_OBJECTS   = 1 << 1, ///< The vehicles, signs and text effects, which move over the landscape.
+	VDL_ALL       = VDL_LANDSCAPE | VDL_OBJECTS, ///< Everything, sorted together.
+};
+
+/** Kinds of calls to the viewport drawing functions that are recorded for a tile. */
+enum ViewportTileCallType : uint8_t {
+	VTC_GROUND_SPRITE,   ///< #DrawGroundSpriteAt
+	VTC_OFFSET_GROUND,   ///< #OffsetGroundSprite
+	VTC_SORTABLE_SPRITE, ///< #AddSortableSpriteToDraw
+	VTC_CHILD_SPRITE,    ///< #AddChildSpriteScreen
+	VTC_START_COMBINE,   ///< #StartSpriteCombine
+	VTC_END_COMBINE,     ///< #EndSpriteCombine
+};
+
+/** A call to the viewport drawing functions made while drawing a tile, replayed when the unchanged tile is drawn again. */
+struct ViewportTileCall {
+	ViewportTileCallType type;
+	SpriteID image;
+	PaletteID pal;
+	const SubSprite *sub;
+	std::array<int32_t, 10> args; ///< The other arguments, in the order of the function.
+};
+
+/** The calls made by the draw proc of a tile, and what they depend on. */
+struct ViewportTileCacheEntry {
+	std::array<uint64_t, 2> map;               ///< The map bits of the tile when the calls were recorded.
+	TileInfo ti;                               ///< The slope and height of the tile when the calls were recorded.
+	std::vector<ViewportTileCall> calls;       ///< The recorded calls.
+};
+
 static bool MarkViewportDirty(const Viewport *vp, int left, int top, int right, int bottom);
 
 static ViewportDrawer _vd;
 
+bool _cache_viewport_tiles = true; ///< Whether the drawing of unchanged scenery tiles is recorded and replayed.
+static const size_t MAX_VIEWPORT_TILE_CACHE_ENTRIES = 1 << 18; ///< Number of tiles at a zoom level after which the cache of tile drawing is cleared.
+static std::unordered_map<uint64_t, ViewportTileCacheEntry> _viewport_tile_cache; ///< Recorded calls of tiles, by tile index and zoom level.
+static std::vector<ViewportTileCall> *_viewport_tile_recording = nullptr; ///< Where the calls of the tile being drawn are recorded, if anywhere.
+static std::array<uint32_t, 3> _viewport_tile_cache_options; ///< Transparency and display options the cached tiles were drawn with.
+
+bool _viewport_chunk_cache = false; ///< Whether zoomed out viewports copy the landscape from drawn chunks, drawing only vehicles and signs over it.
+static const uint VIEWPORT_CHUNK_SHIFT = 8; ///< Width and height of a chunk of landscape, as shift of pixels.
+static const ZoomLevel VIEWPORT_CHUNK_MIN_ZOOM = ZOOM_LVL_OUT_8X; ///< Zoom level from which the landscape is drawn in chunks.
+static const size_t MAX_VIEWPORT_CHUNK_CACHE_BYTES = 64 << 20; ///< Size of the drawn chunks after which they are all forgotten.
+static std::unordered_map<uint64_t, std::unique_ptr<uint8_t[]>> _viewport_chunks; ///< Drawn chunks in the format of Blitter::CopyToBuffer, by zoom level and position.
+static Blitter *_viewport_chunk_blitter = nullptr; ///< Blitter the chunks were drawn with.
+
+uint8_t _viewport_draw_threads = 0; ///< Maximum number of threads drawing a part of a viewport; 0 or 1 means serial.
+static const int MIN_VIEWPORT_BAND_HEIGHT = 64; ///< Minimum height in pixels of the bands a viewport is split into for drawing by several threads.
+
+static uint _dirty_batch_depth = 0; ///< Number of nested #ViewportDirtyBatch instances.
+static Rect _dirty_batch_rect;      ///< Bounding box, in viewport coordinates, of the tiles marked dirty during the current #ViewportDirtyBatch.
+static uint _viewport_snapshot_depth = 0;  ///< Number of nested #ViewportSnapshot instances.
+static std::vector<Viewport> _viewport_snapshot; ///< Copies of all viewports, made by the outermost #ViewportSnapshot.
+static Rect _viewport_snapshot_bounds;     ///< Bounding box, in viewport coordinates, of the area that can be marked dirty in the viewports of the snapshot.
+
 TileHighlightData _thd;
 static TileInfo _cur_ti;
 bool _draw_bounding_boxes = false;
@@ -540,6 +600,9 @@ static void AddChildSpriteToFoundation(SpriteID image, PaletteID pal, const SubS
 	assert(_vd.foundation[foundation_part] != -1);
 	Point offs = _vd.foundation_offset[foundation_part];
 
+	/* The caller is recorded, not this child sprite. */
+	AutoRestoreBackup<std::vector<ViewportTileCall> *> recording_backup(_viewport_tile_recording, nullptr);
+
 	/* Change the active ChildSprite list to the one of the foundation */
 	int *old_child = _vd.last_child;
 	_vd.last_child = _vd.last_foundation_child[foundation_part];
@@ -565,6 +628,8 @@ static void AddChildSpriteToFoundation(SpriteID image, PaletteID pal, const SubS
  */
 void DrawGroundSpriteAt(SpriteID image, PaletteID pal, int32_t x, int32_t y, int z, const SubSprite *sub, int extra_offs_x, int extra_offs_y)
 {
+	if (_viewport_tile_recording != nullptr) _viewport_tile_recording->push_back({ VTC_GROUND_SPRITE, image, pal, sub, { x, y, z, extra_offs_x, extra_offs_y } });
+
 	/* Switch to first foundation part, if no foundation was drawn */
 	if (_vd.foundation_part == FOUNDATION_PART_NONE) _vd.foundation_part = FOUNDATION_PART_NORMAL;
 
@@ -600,6 +665,8 @@ void DrawGroundSprite(SpriteID image, PaletteID pal, const SubSprite *sub, int e
  */
 void OffsetGroundSprite(int x, int y)
 {
+	if (_viewport_tile_recording != nullptr) _viewport_tile_recording->push_back({ VTC_OFFSET_GROUND, 0, 0, nullptr, { x, y } });
+
 	/* Switch to next foundation part */
 	switch (_vd.foundation_part) {
 		case FOUNDATION_PART_NONE:
@@ -635,6 +702,9 @@ static void AddCombinedSprite(SpriteID image, PaletteID pal, int x, int y, int z
 	Point pt = RemapCoords(x, y, z);
 	const Sprite *spr = GetSprite(image & SPRITE_MASK, SpriteType::Normal);
 
+	/* The caller is recorded, not this child sprite. */
+	AutoRestoreBackup<std::vector<ViewportTileCall> *> recording_backup(_viewport_tile_recording, nullptr);
+
 	if (pt.x + spr->x_offs >= _vd.dpi.left + _vd.dpi.width ||
 			pt.x + spr->x_offs + spr->width <= _vd.dpi.left ||
 			pt.y + spr->y_offs >= _vd.dpi.top + _vd.dpi.height ||
@@ -676,6 +746,8 @@ void AddSortableSpriteToDraw(SpriteID image, PaletteID pal, int x, int y, int w,
 
 	assert((image & SPRITE_MASK) < MAX_SPRITES);
 
+	if (_viewport_tile_recording != nullptr) _viewport_tile_recording->push_back({ VTC_SORTABLE_SPRITE, image, pal, sub, { x, y, w, h, dz, z, transparent, bb_offset_x, bb_offset_y, bb_offset_z } });
+
 	/* make the sprites transparent with the right palette */
 	if (transparent) {
 		SetBit(image, PALETTE_MODIFIER_TRANSPARENT);
@@ -768,6 +840,8 @@ void AddSortableSpriteToDraw(SpriteID image, PaletteID pal, int x, int y, int w,
  */
 void StartSpriteCombine()
 {
+	if (_viewport_tile_recording != nullptr) _viewport_tile_recording->push_back({ VTC_START_COMBINE, 0, 0, nullptr, {} });
+
 	assert(_vd.combine_sprites == SPRITE_COMBINE_NONE);
 	_vd.combine_sprites = SPRITE_COMBINE_PENDING;
 }
@@ -778,6 +852,8 @@ void StartSpriteCombine()
  */
 void EndSpriteCombine()
 {
+	if (_viewport_tile_recording != nullptr) _viewport_tile_recording->push_back({ VTC_END_COMBINE, 0, 0, nullptr, {} });
+
 	assert(_vd.combine_sprites != SPRITE_COMBINE_NONE);
 	_vd.combine_sprites = SPRITE_COMBINE_NONE;
 }
@@ -830,6 +906,8 @@ void AddChildSpriteScreen(SpriteID image, PaletteID pal, int x, int y, bool tran
 {
 	assert((image & SPRITE_MASK) < MAX_SPRITES);
 
+	if (_viewport_tile_recording != nullptr) _viewport_tile_recording->push_back({ VTC_CHILD_SPRITE, image, pal, sub, { x, y, transparent, scale, relative } });
+
 	/* If the ParentSprite was clipped by the viewport bounds, do not draw the ChildSprites either */
 	if (_vd.last_child == nullptr) return;
 
@@ -1180,11 +1258,191 @@ static int GetViewportY(Point tile)
 	return (tile.y * (int)(TILE_PIXELS / 2) + tile.x * (int)(TILE_PIXELS / 2) - TilePixelHeightOutsideMap(tile.x, tile.y)) << ZOOM_LVL_SHIFT;
 }
 
+/**
+ * Get the map bits of a tile, to notice that it changed since its drawing was recorded.
+ * @param tile The tile.
+ * @return The map bits.
+ */
+static std::array<uint64_t, 2> GetViewportTileCacheMapBits(TileIndex tile)
+{
+	Tile t(tile);
+	return {
+		(uint64_t)t.type() | (uint64_t)t.height() << 8 | (uint64_t)t.m1() << 16 | (uint64_t)t.m2() << 24 | (uint64_t)t.m3() << 40 | (uint64_t)t.m4() << 48 | (uint64_t)t.m5() << 56,
+		(uint64_t)t.m6() | (uint64_t)t.m7() << 8 | (uint64_t)t.m8() << 16
+	};
+}
+
+/**
+ * Whether the drawing of a tile only depends on the tile and its neighbours, so it may be recorded and replayed.
+ * Tiles that are animated or use NewGRF callbacks that depend on the date are not.
+ * @param tile_type The type of the tile.
+ * @param tile The tile.
+ * @return True iff the drawing may be cached.
+ */
+static bool IsViewportTileCacheable(TileType tile_type, TileIndex tile)
+{
+	switch (tile_type) {
+		case MP_CLEAR:
+		case MP_TREES:
+			break;
+
+		case MP_WATER:
+			/* Depots are drawn in the colour of their company, which may change. */
+			if (IsShipDepot(tile)) return false;
+			break;
+
+		default:
+			return false;
+	}
+
+	/* The middle of a bridge is drawn from the bridge heads. */
+	return !IsBridgeAbove(tile);
+}
+
+/**
+ * Replay the calls to the drawing functions recorded for the current tile.
+ * @param calls The recorded calls.
+ */
+static void ViewportReplayTileCalls(const std::vector<ViewportTileCall> &calls)
+{
+	for (const ViewportTileCall &c : calls) {
+		const auto &a = c.args;
+		switch (c.type) {
+			case VTC_GROUND_SPRITE: DrawGroundSpriteAt(c.image, c.pal, a[0], a[1], a[2], c.sub, a[3], a[4]); break;
+			case VTC_OFFSET_GROUND: OffsetGroundSprite(a[0], a[1]); break;
+			case VTC_SORTABLE_SPRITE: AddSortableSpriteToDraw(c.image, c.pal, a[0], a[1], a[2], a[3], a[4], a[5], a[6] != 0, a[7], a[8], a[9], c.sub); break;
+			case VTC_CHILD_SPRITE: AddChildSpriteScreen(c.image, c.pal, a[0], a[1], a[2] != 0, c.sub, a[3] != 0, a[4] != 0); break;
+			case VTC_START_COMBINE: StartSpriteCombine(); break;
+			case VTC_END_COMBINE: EndSpriteCombine(); break;
+			default: NOT_REACHED();
+		}
+	}
+}
+
+/**
+ * Draw the current tile with its draw proc, or replay the recorded drawing of the unchanged tile.
+ * @param tile_type The type of the tile.
+ */
+static void ViewportDrawTile(TileType tile_type)
+{
+	if (!_cache_viewport_tiles || _cur_ti.tile == INVALID_TILE || !IsViewportTileCacheable(tile_type, _cur_ti.tile)) {
+		_tile_type_procs[tile_type]->draw_tile_proc(&_cur_ti);
+		return;
+	}
+
+	uint64_t key = (uint64_t)_cur_ti.tile.base() * ZOOM_LVL_END + _vd.dpi.zoom;
+	std::array<uint64_t, 2> map = GetViewportTileCacheMapBits(_cur_ti.tile);
+
+	auto it = _viewport_tile_cache.find(key);
+	if (it != _viewport_tile_cache.end()) {
+		const ViewportTileCacheEntry &entry = it->second;
+		if (entry.map == map && entry.ti.tileh == _cur_ti.tileh && entry.ti.z == _cur_ti.z) {
+			ViewportReplayTileCalls(entry.calls);
+			return;
+		}
+	}
+
+	if (_viewport_tile_cache.size() >= MAX_VIEWPORT_TILE_CACHE_ENTRIES) _viewport_tile_cache.clear();
+
+	ViewportTileCacheEntry &entry = _viewport_tile_cache[key];
+	entry.map = map;
+	entry.ti = _cur_ti;
+	entry.calls.clear();
+
+	AutoRestoreBackup recording_backup(_viewport_tile_recording, &entry.calls);
+	_tile_type_procs[tile_type]->draw_tile_proc(&_cur_ti);
+}
+
+/**
+ * Forget the recorded drawing of a tile and its neighbours, at all zoom levels.
+ * The neighbours are included, as for example the edges of water depend on them.
+ * @param tile The tile.
+ */
+static void InvalidateViewportTileCache(TileIndex tile)
+{
+	if (_viewport_tile_cache.empty()) return;
+
+	for (int dx = -1; dx <= 1; dx++) {
+		for (int dy = -1; dy <= 1; dy++) {
+			TileIndex t = TileAddWrap(tile, dx, dy);
+			if (t == INVALID_TILE) continue;
+			for (ZoomLevel zoom = ZOOM_LVL_BEGIN; zoom != ZOOM_LVL_END; zoom++) {
+				_viewport_tile_cache.erase((uint64_t)t.base() * ZOOM_LVL_END + zoom);
+			}
+		}
+	}
+}
+
+/**
+ * Forget all recorded drawing of tiles, e.g. as the map or the sprites changed.
+ */
+void ClearViewportTileCache()
+{
+	_viewport_tile_cache.clear();
+}
+
+/**
+ * Forget all drawn chunks of landscape, e.g. as the whole screen is redrawn.
+ */
+void ClearViewportChunkCache()
+{
+	_viewport_chunks.clear();
+}
+
+/**
+ * Get the key of a drawn chunk of landscape.
+ * @param zoom The zoom level it is drawn at.
+ * @param cx Column of the chunk.
+ * @param cy Row of the chunk.
+ * @return The key in #_viewport_chunks.
+ */
+static uint64_t GetViewportChunkKey(ZoomLevel zoom, int cx, int cy)
+{
+	return (uint64_t)zoom << 56 | (uint64_t)(cx & 0xFFFFFFF) << 28 | (uint64_t)(cy & 0xFFFFFFF);
+}
+
+/**
+ * Forget the drawn chunks of landscape that overlap an area, at all zoom levels.
+ * @param left Left edge of the area, in viewport coordinates.
+ * @param top Top edge of the area, in viewport coordinates.
+ * @param right Right edge of the area, in viewport coordinates.
+ * @param bottom Bottom edge of the area, in viewport coordinates.
+ */
+static void InvalidateViewportChunks(int left, int top, int right, int bottom)
+{
+	if (_viewport_chunks.empty()) return;
+
+	for (ZoomLevel zoom = VIEWPORT_CHUNK_MIN_ZOOM; zoom != ZOOM_LVL_END; zoom++) {
+		uint shift = VIEWPORT_CHUNK_SHIFT + zoom;
+		for (int cy = top >> shift; cy <= bottom >> shift; cy++) {
+			for (int cx = left >> shift; cx <= right >> shift; cx++) {
+				_viewport_chunks.erase(GetViewportChunkKey(zoom, cx, cy));
+			}
+		}
+	}
+}
+
+/**
+ * Forget the recorded drawing of tiles and the drawn chunks when the transparency or display options changed,
+ * as tiles are drawn differently with other options.
+ */
+static void CheckViewportCacheOptions()
+{
+	std::array<uint32_t, 3> options = { _transparency_opt, _invisibility_opt, _display_opt };
+	if (options != _viewport_tile_cache_options) {
+		ClearViewportTileCache();
+		ClearViewportChunkCache();
+		_viewport_tile_cache_options = options;
+	}
+}
+
 /**
  * Add the landscape to the viewport, i.e. all ground tiles and buildings.
  */
 static void ViewportAddLandscape()
 {
+	CheckViewportCacheOptions();
+
 	assert(_vd.dpi.top <= _vd.dpi.top + _vd.dpi.height);
 	assert(_vd.dpi.left <= _vd.dpi.left + _vd.dpi.width);
 
@@ -1288,7 +1546,7 @@ static void ViewportAddLandscape()
 				_vd.last_foundation_child[0] = nullptr;
 				_vd.last_foundation_child[1] = nullptr;
 
-				_tile_type_procs[tile_type]->draw_tile_proc(&_cur_ti);
+				ViewportDrawTile(tile_type);
 				if (_cur_ti.tile != INVALID_TILE) DrawTileSelection(&_cur_ti);
 			}
 		}
@@ -1522,7 +1780,7 @@ static bool ViewportSortParentSpritesChecker()
 }
 
 /** Sort parent sprites pointer array replicating the way original sorter did it. */
-static void ViewportSortParentSprites(ParentSpriteToSortVector *psdv)
+void ViewportSortParentSprites(ParentSpriteToSortVector *psdv)
 {
 	if (psdv->size() < 2) return;
 
@@ -1731,7 +1989,18 @@ static void ViewportDrawStrings(ZoomLevel zoom, const StringSpriteToDrawVector *
 	}
 }
 
-void ViewportDoDraw(const Viewport *vp, int left, int top, int right, int bottom)
+/**
+ * Collect the sprites of a part of a viewport in #_vd.
+ * This runs the drawing callbacks of the tiles, vehicles and such, so it is done by the main thread.
+ * @param vp The viewport to draw.
+ * @param left Left edge of the part, in viewport coordinates.
+ * @param top Top edge of the part, in viewport coordinates.
+ * @param right Right edge of the part, in viewport coordinates.
+ * @param bottom Bottom edge of the part, in viewport coordinates.
+ * @param layers What to collect the sprites of.
+ * @return Position of the part on the screen.
+ */
+static Point ViewportCollectSprites(const Viewport *vp, int left, int top, int right, int bottom, ViewportDrawLayers layers = VDL_ALL)
 {
 	_vd.dpi.zoom = vp->zoom;
 	int mask = ScaleByZoom(-1, vp->zoom);
@@ -1751,51 +2020,228 @@ void ViewportDoDraw(const Viewport *vp, int left, int top, int right, int bottom
 	_vd.dpi.dst_ptr = BlitterFactory::GetCurrentBlitter()->MoveTo(_cur_dpi->dst_ptr, x - _cur_dpi->left, y - _cur_dpi->top);
 	AutoRestoreBackup dpi_backup(_cur_dpi, &_vd.dpi);
 
-	ViewportAddLandscape();
-	ViewportAddVehicles(&_vd.dpi);
+	if ((layers & VDL_LANDSCAPE) != 0) ViewportAddLandscape();
+
+	if ((layers & VDL_OBJECTS) != 0) {
+		ViewportAddVehicles(&_vd.dpi);
+
+		ViewportAddKdtreeSigns(&_vd.dpi);
 
-	ViewportAddKdtreeSigns(&_vd.dpi);
+		DrawTextEffects(&_vd.dpi);
+	}
 
-	DrawTextEffects(&_vd.dpi);
+	return { x, y };
+}
 
-	if (!_vd.tile_sprites_to_draw.empty()) ViewportDrawTileSprites(&_vd.tile_sprites_to_draw);
+/**
+ * Sort and draw the collected sprites of a part of a viewport.
+ * This only touches the screen within the part, so it may be done by a worker.
+ * @param vd The collected sprites.
+ */
+static void ViewportDrawSprites(ViewportDrawer &vd)
+{
+	AutoRestoreBackup dpi_backup(_cur_dpi, &vd.dpi);
+
+	if (!vd.tile_sprites_to_draw.empty()) ViewportDrawTileSprites(&vd.tile_sprites_to_draw);
 
-	for (auto &psd : _vd.parent_sprites_to_draw) {
-		_vd.parent_sprites_to_sort.push_back(&psd);
+	for (auto &psd : vd.parent_sprites_to_draw) {
+		vd.parent_sprites_to_sort.push_back(&psd);
 	}
 
-	_vp_sprite_sorter(&_vd.parent_sprites_to_sort);
-	ViewportDrawParentSprites(&_vd.parent_sprites_to_sort, &_vd.child_screen_sprites_to_draw);
+	_vp_sprite_sorter(&vd.parent_sprites_to_sort);
+	ViewportDrawParentSprites(&vd.parent_sprites_to_sort, &vd.child_screen_sprites_to_draw);
 
-	if (_draw_bounding_boxes) ViewportDrawBoundingBoxes(&_vd.parent_sprites_to_sort);
+	if (_draw_bounding_boxes) ViewportDrawBoundingBoxes(&vd.parent_sprites_to_sort);
 	if (_draw_dirty_blocks) ViewportDrawDirtyBlocks();
+}
 
-	DrawPixelInfo dp = _vd.dpi;
-	ZoomLevel zoom = _vd.dpi.zoom;
+/**
+ * Clear the collected sprites of a part of a viewport, keeping the allocations.
+ * @param vd The collected sprites.
+ */
+static void ViewportClearSprites(ViewportDrawer &vd)
+{
+	vd.string_sprites_to_draw.clear();
+	vd.tile_sprites_to_draw.clear();
+	vd.parent_sprites_to_draw.clear();
+	vd.parent_sprites_to_sort.clear();
+	vd.child_screen_sprites_to_draw.clear();
+}
+
+/**
+ * Draw the link graph overlay and the strings over a part of a viewport, and clear its collected sprites.
+ * Strings use the font cache, so this is done by the main thread.
+ * @param vp The viewport to draw.
+ * @param vd The collected sprites.
+ * @param pt Position of the part on the screen.
+ */
+static void ViewportDrawOverlays(const Viewport *vp, ViewportDrawer &vd, Point pt)
+{
+	DrawPixelInfo dp = vd.dpi;
+	ZoomLevel zoom = vd.dpi.zoom;
 	dp.zoom = ZOOM_LVL_NORMAL;
 	dp.width = UnScaleByZoom(dp.width, zoom);
 	dp.height = UnScaleByZoom(dp.height, zoom);
-	_cur_dpi = &dp;
+	AutoRestoreBackup dpi_backup(_cur_dpi, &dp);
 
 	if (vp->overlay != nullptr && vp->overlay->GetCargoMask() != 0 && vp->overlay->GetCompanyMask() != 0) {
 		/* translate to window coordinates */
-		dp.left = x;
-		dp.top = y;
+		dp.left = pt.x;
+		dp.top = pt.y;
 		vp->overlay->Draw(&dp);
 	}
 
-	if (!_vd.string_sprites_to_draw.empty()) {
+	if (!vd.string_sprites_to_draw.empty()) {
 		/* translate to world coordinates */
-		dp.left = UnScaleByZoom(_vd.dpi.left, zoom);
-		dp.top = UnScaleByZoom(_vd.dpi.top, zoom);
-		ViewportDrawStrings(zoom, &_vd.string_sprites_to_draw);
+		dp.left = UnScaleByZoom(vd.dpi.left, zoom);
+		dp.top = UnScaleByZoom(vd.dpi.top, zoom);
+		ViewportDrawStrings(zoom, &vd.string_sprites_to_draw);
+	}
+
+	ViewportClearSprites(vd);
+}
+
+void ViewportDoDraw(const Viewport *vp, int left, int top, int right, int bottom)
+{
+	Point pt = ViewportCollectSprites(vp, left, top, right, bottom);
+	ViewportDrawSprites(_vd);
+	ViewportDrawOverlays(vp, _vd, pt);
+}
+
+/**
+ * Draw a part of a viewport split into horizontal bands, which are sorted and
+ * drawn by the workers while the main thread collects the sprites of the next band.
+ * All bands are done before returning, as windows may be drawn over the viewport.
+ * @param vp The viewport to draw.
+ * @param left Left edge of the part, in screen coordinates.
+ * @param top Top edge of the part, in screen coordinates.
+ * @param right Right edge of the part, in screen coordinates.
+ * @param bottom Bottom edge of the part, in screen coordinates.
+ * @param bands The number of bands.
+ */
+static void ViewportDoDrawInBands(const Viewport *vp, int left, int top, int right, int bottom, uint bands)
+{
+	/** A band of the viewport that is being drawn. */
+	struct ViewportBand {
+		ViewportDrawer vd; ///< The collected sprites of the band.
+		Point pt;          ///< Position of the band on the screen.
+		TaskHandle task;   ///< Task sorting and drawing the sprites.
+	};
+	/* Kept, so the vectors of sprites keep their allocations between draws. */
+	static std::vector<ViewportBand> drawing_bands;
+	if (drawing_bands.size() < bands) drawing_bands.resize(bands);
+
+	{
+		/* Sprites must stay in the cache until all bands are drawn. */
+		AutoRestoreBackup shared_backup(_sprite_cache_shared, true);
+
+		for (uint i = 0; i < bands; i++) {
+			ViewportBand &band = drawing_bands[i];
+			int band_top = top + (bottom - top) * i / bands;
+			int band_bottom = top + (bottom - top) * (i + 1) / bands;
+			band.pt = ViewportCollectSprites(vp,
+				ScaleByZoom(left - vp->left, vp->zoom) + vp->virtual_left,
+				ScaleByZoom(band_top - vp->top, vp->zoom) + vp->virtual_top,
+				ScaleByZoom(right - vp->left, vp->zoom) + vp->virtual_left,
+				ScaleByZoom(band_bottom - vp->top, vp->zoom) + vp->virtual_top
+			);
+			std::swap(band.vd, _vd);
+			band.task = SubmitTask(TaskCategory::Viewport, [&band]() { ViewportDrawSprites(band.vd); });
+		}
+
+		for (uint i = 0; i < bands; i++) drawing_bands[i].task.Wait();
+	}
+
+	for (uint i = 0; i < bands; i++) ViewportDrawOverlays(vp, drawing_bands[i].vd, drawing_bands[i].pt);
+}
+
+/**
+ * Draw only the landscape of a part of a viewport.
+ * @param vp The viewport to draw.
+ * @param left Left edge of the part, in viewport coordinates.
+ * @param top Top edge of the part, in viewport coordinates.
+ * @param right Right edge of the part, in viewport coordinates.
+ * @param bottom Bottom edge of the part, in viewport coordinates.
+ */
+static void ViewportDrawLandscape(const Viewport *vp, int left, int top, int right, int bottom)
+{
+	ViewportCollectSprites(vp, left, top, right, bottom, VDL_LANDSCAPE);
+	ViewportDrawSprites(_vd);
+	ViewportClearSprites(_vd);
+}
+
+/**
+ * Draw a part of a zoomed out viewport by copying its landscape from chunks that were drawn before,
+ * and drawing the vehicles, signs and text effects over it. Chunks are aligned to the viewport
+ * coordinates, so all viewports at a zoom level share them. Chunks wholly in the part that are
+ * not drawn yet are drawn and kept; the edges of the part are drawn as usual.
+ * @param vp The viewport to draw.
+ * @param left Left edge of the part, in screen coordinates.
+ * @param top Top edge of the part, in screen coordinates.
+ * @param right Right edge of the part, in screen coordinates.
+ * @param bottom Bottom edge of the part, in screen coordinates.
+ */
+static void ViewportDrawWithChunks(const Viewport *vp, int left, int top, int right, int bottom)
+{
+	Blitter *blitter = BlitterFactory::GetCurrentBlitter();
+	if (blitter != _viewport_chunk_blitter) {
+		ClearViewportChunkCache();
+		_viewport_chunk_blitter = blitter;
+	}
+	CheckViewportCacheOptions();
+
+	int mask = ScaleByZoom(-1, vp->zoom);
+	int origin_x = vp->virtual_left & mask;
+	int origin_y = vp->virtual_top & mask;
+	int vleft = ScaleByZoom(left - vp->left, vp->zoom) + origin_x;
+	int vtop = ScaleByZoom(top - vp->top, vp->zoom) + origin_y;
+	int vright = ScaleByZoom(right - vp->left, vp->zoom) + origin_x;
+	int vbottom = ScaleByZoom(bottom - vp->top, vp->zoom) + origin_y;
+
+	const uint shift = VIEWPORT_CHUNK_SHIFT + vp->zoom;
+	const int chunk_pixels = 1 << VIEWPORT_CHUNK_SHIFT;
+	const size_t chunk_bytes = blitter->BufferSize(chunk_pixels, chunk_pixels);
+	const size_t max_chunks = std::max<size_t>(1, MAX_VIEWPORT_CHUNK_CACHE_BYTES / chunk_bytes);
+
+	{
+		/* Placeholders of sprites that are not decoded yet must not be kept. */
+		AutoRestoreBackup async_backup(_draw_async_sprites, false);
+
+		for (int cy = vtop >> shift; (cy << shift) < vbottom; cy++) {
+			for (int cx = vleft >> shift; (cx << shift) < vright; cx++) {
+				int l = std::max(vleft, cx << shift);
+				int t = std::max(vtop, cy << shift);
+				int r = std::min(vright, (cx + 1) << shift);
+				int b = std::min(vbottom, (cy + 1) << shift);
+				if (r - l != 1 << shift || b - t != 1 << shift) {
+					ViewportDrawLandscape(vp, l, t, r, b);
+					continue;
+				}
+
+				void *dst = blitter->MoveTo(_cur_dpi->dst_ptr,
+						UnScaleByZoom(l - origin_x, vp->zoom) + vp->left - _cur_dpi->left,
+						UnScaleByZoom(t - origin_y, vp->zoom) + vp->top - _cur_dpi->top);
+
+				uint64_t key = GetViewportChunkKey(vp->zoom, cx, cy);
+				auto it = _viewport_chunks.find(key);
+				if (it != _viewport_chunks.end()) {
+					blitter->CopyFromBuffer(dst, it->second.get(), chunk_pixels, chunk_pixels);
+					continue;
+				}
+
+				ViewportDrawLandscape(vp, l, t, r, b);
+
+				if (_viewport_chunks.size() >= max_chunks) ClearViewportChunkCache();
+				std::unique_ptr<uint8_t[]> &pixels = _viewport_chunks[key];
+				pixels = std::make_unique<uint8_t[]>(chunk_bytes);
+				blitter->CopyToBuffer(dst, pixels.get(), chunk_pixels, chunk_pixels);
+			}
+		}
 	}
 
-	_vd.string_sprites_to_draw.clear();
-	_vd.tile_sprites_to_draw.clear();
-	_vd.parent_sprites_to_draw.clear();
-	_vd.parent_sprites_to_sort.clear();
-	_vd.child_screen_sprites_to_draw.clear();
+	Point pt = ViewportCollectSprites(vp, vleft, vtop, vright, vbottom, VDL_OBJECTS);
+	ViewportDrawSprites(_vd);
+	ViewportDrawOverlays(vp, _vd, pt);
 }
 
 static inline void ViewportDraw(const Viewport *vp, int left, int top, int right, int bottom)
@@ -1812,6 +2258,20 @@ static inline void ViewportDraw(const Viewport *vp, int left, int top, int right
 	if (top < vp->top) top = vp->top;
 	if (bottom > vp->top + vp->height) bottom = vp->top + vp->height;
 
+	/* Do not stall on sprites that are not in the cache yet; they are drawn once decoded. */
+	AutoRestoreBackup async_backup(_draw_async_sprites, _async_sprite_decoding);
+
+	if (_viewport_chunk_cache && vp->zoom >= VIEWPORT_CHUNK_MIN_ZOOM && !_screen_disable_anim && !_draw_bounding_boxes && !_draw_dirty_blocks) {
+		ViewportDrawWithChunks(vp, left, top, right, bottom);
+		return;
+	}
+
+	uint bands = std::min<uint>(_viewport_draw_threads, (bottom - top) / MIN_VIEWPORT_BAND_HEIGHT);
+	if (bands > 1 && HasTaskWorkers()) {
+		ViewportDoDrawInBands(vp, left, top, right, bottom, bands);
+		return;
+	}
+
 	ViewportDoDraw(vp,
 		ScaleByZoom(left - vp->left, vp->zoom) + vp->virtual_left,
 		ScaleByZoom(top - vp->top, vp->zoom) + vp->virtual_top,
@@ -2017,6 +2477,17 @@ bool MarkAllViewportsDirty(int left, int top, int right, int bottom)
 {
 	bool dirty = false;
 
+	if (_viewport_snapshot_depth > 0) {
+		if (right <= _viewport_snapshot_bounds.left || left >= _viewport_snapshot_bounds.right ||
+				bottom <= _viewport_snapshot_bounds.top || top >= _viewport_snapshot_bounds.bottom) {
+			return false;
+		}
+		for (const Viewport &vp : _viewport_snapshot) {
+			if (MarkViewportDirty(&vp, left, top, right, bottom)) dirty = true;
+		}
+		return dirty;
+	}
+
 	for (const Window *w : Window::Iterate()) {
 		Viewport *vp = w->viewport;
 		if (vp != nullptr) {
@@ -2050,12 +2521,66 @@ void ConstrainAllViewportsZoom()
  */
 void MarkTileDirtyByTile(TileIndex tile, int bridge_level_offset, int tile_height_override)
 {
+	InvalidateViewportTileCache(tile);
+	InvalidateSmallMapTile(tile);
+
 	Point pt = RemapCoords(TileX(tile) * TILE_SIZE, TileY(tile) * TILE_SIZE, tile_height_override * TILE_HEIGHT);
-	MarkAllViewportsDirty(
-			pt.x - MAX_TILE_EXTENT_LEFT,
-			pt.y - MAX_TILE_EXTENT_TOP - ZOOM_LVL_BASE * TILE_HEIGHT * bridge_level_offset,
-			pt.x + MAX_TILE_EXTENT_RIGHT,
-			pt.y + MAX_TILE_EXTENT_BOTTOM);
+	int left = pt.x - MAX_TILE_EXTENT_LEFT;
+	int top = pt.y - MAX_TILE_EXTENT_TOP - ZOOM_LVL_BASE * TILE_HEIGHT * bridge_level_offset;
+	int right = pt.x + MAX_TILE_EXTENT_RIGHT;
+	int bottom = pt.y + MAX_TILE_EXTENT_BOTTOM;
+
+	if (_dirty_batch_depth > 0) {
+		_dirty_batch_rect.left = std::min(_dirty_batch_rect.left, left);
+		_dirty_batch_rect.top = std::min(_dirty_batch_rect.top, top);
+		_dirty_batch_rect.right = std::max(_dirty_batch_rect.right, right);
+		_dirty_batch_rect.bottom = std::max(_dirty_batch_rect.bottom, bottom);
+		return;
+	}
+
+	InvalidateViewportChunks(left, top, right, bottom);
+	MarkAllViewportsDirty(left, top, right, bottom);
+}
+
+/** Start collecting the tiles marked dirty, unless an outer batch already does. */
+ViewportDirtyBatch::ViewportDirtyBatch()
+{
+	if (_dirty_batch_depth++ == 0) _dirty_batch_rect = { INT_MAX, INT_MAX, INT_MIN, INT_MIN };
+}
+
+/** Mark the bounding box of the collected tiles dirty, when this is the outermost batch. */
+ViewportDirtyBatch::~ViewportDirtyBatch()
+{
+	if (--_dirty_batch_depth > 0 || _dirty_batch_rect.left > _dirty_batch_rect.right) return;
+
+	InvalidateViewportChunks(_dirty_batch_rect.left, _dirty_batch_rect.top, _dirty_batch_rect.right, _dirty_batch_rect.bottom);
+	MarkAllViewportsDirty(_dirty_batch_rect.left, _dirty_batch_rect.top, _dirty_batch_rect.right, _dirty_batch_rect.bottom);
+}
+
+/** Copy all viewports and the area they show, unless an outer snapshot already did. */
+ViewportSnapshot::ViewportSnapshot()
+{
+	if (_viewport_snapshot_depth++ > 0) return;
+
+	_viewport_snapshot.clear();
+	_viewport_snapshot_bounds = { INT_MAX, INT_MAX, INT_MIN, INT_MIN };
+	for (const Window *w : Window::Iterate()) {
+		const Viewport *vp = w->viewport;
+		if (vp == nullptr) continue;
+
+		_viewport_snapshot.push_back(*vp);
+		/* Mirror the rejections of MarkViewportDirty, including its rounding wrt. the zoom level. */
+		_viewport_snapshot_bounds.left = std::min(_viewport_snapshot_bounds.left, vp->virtual_left - ((1 << vp->zoom) - 1));
+		_viewport_snapshot_bounds.top = std::min(_viewport_snapshot_bounds.top, vp->virtual_top - ((1 << vp->zoom) - 1));
+		_viewport_snapshot_bounds.right = std::max(_viewport_snapshot_bounds.right, vp->virtual_left + vp->virtual_width);
+		_viewport_snapshot_bounds.bottom = std::max(_viewport_snapshot_bounds.bottom, vp->virtual_top + vp->virtual_height);
+	}
+}
+
+/** Forget the copied viewports, when this is the outermost snapshot. */
+ViewportSnapshot::~ViewportSnapshot()
+{
+	if (--_viewport_snapshot_depth == 0) _viewport_snapshot.clear();
 }
 
 /**
@@ -2139,6 +2664,7 @@ static void SetSelectionTilesDirty()
 			static const int OVERLAY_WIDTH = 4 * ZOOM_LVL_BASE; // part of selection sprites is drawn outside the selected area (in particular: terraforming)
 
 			/* For halftile foundations on SLOPE_STEEP_S the sprite extents some more towards the top */
+			InvalidateViewportChunks(l - OVERLAY_WIDTH, t - OVERLAY_WIDTH - TILE_HEIGHT * ZOOM_LVL_BASE, r + OVERLAY_WIDTH, b + OVERLAY_WIDTH);
 			MarkAllViewportsDirty(l - OVERLAY_WIDTH, t - OVERLAY_WIDTH - TILE_HEIGHT * ZOOM_LVL_BASE, r + OVERLAY_WIDTH, b + OVERLAY_WIDTH);
 
 			/* haven't we reached the topmost tile yet? */
@@ -3485,16 +4011,36 @@ void ResetObjectToPlace()
 	SetObjectToPlace(SPR_CURSOR_MOUSE, PAL_NONE, HT_NONE, WC_MAIN_WINDOW, 0);
 }
 
-Point GetViewportStationMiddle(const Viewport *vp, const Station *st)
+/**
+ * Get the middle of a station in virtual coordinates, i.e. independent of where a viewport is scrolled to and its zoom level.
+ * @param st The station.
+ * @return The virtual coordinates of the station.
+ */
+Point GetStationVirtualMiddle(const Station *st)
 {
 	int x = TileX(st->xy) * TILE_SIZE;
 	int y = TileY(st->xy) * TILE_SIZE;
 	int z = GetSlopePixelZ(Clamp(x, 0, Map::SizeX() * TILE_SIZE - 1), Clamp(y, 0, Map::SizeY() * TILE_SIZE - 1));
 
-	Point p = RemapCoords(x, y, z);
-	p.x = UnScaleByZoom(p.x - vp->virtual_left, vp->zoom) + vp->left;
-	p.y = UnScaleByZoom(p.y - vp->virtual_top, vp->zoom) + vp->top;
-	return p;
+	return RemapCoords(x, y, z);
+}
+
+/**
+ * Convert virtual coordinates to the coordinates within the window of a viewport.
+ * @param vp The viewport.
+ * @param pt The virtual coordinates.
+ * @return The coordinates within the window.
+ */
+Point VirtualToViewportPoint(const Viewport *vp, Point pt)
+{
+	pt.x = UnScaleByZoom(pt.x - vp->virtual_left, vp->zoom) + vp->left;
+	pt.y = UnScaleByZoom(pt.y - vp->virtual_top, vp->zoom) + vp->top;
+	return pt;
+}
+
+Point GetViewportStationMiddle(const Viewport *vp, const Station *st)
+{
+	return VirtualToViewportPoint(vp, GetStationVirtualMiddle(st));
 }
 
 /** Helper class for getting the best sprite sorter. */
@@ -3505,6 +4051,7 @@ struct ViewportSSCSS {
 
 /** List of sorters ordered from best to worst. */
 static ViewportSSCSS _vp_sprite_sorters[] = {
+	{ &ViewportSortParentSpritesChecker, &ViewportSortParentSpritesBucket },
 #ifdef WITH_SSE
 	{ &ViewportSortParentSpritesSSE41Checker, &ViewportSortParentSpritesSSE41 },
 #endif
@@ -14,11 +14,16 @@
 #include "viewport_type.h"
 #include "window_type.h"
 #include "tile_map.h"
+#include "tilearea_type.h"
 #include "station_type.h"
 #include "vehicle_type.h"
 
 static const int TILE_HEIGHT_STEP = 50; ///< One Z unit tile height difference is displayed as 50m.
 
+extern uint8_t _viewport_draw_threads;
+extern bool _cache_viewport_tiles;
+extern bool _viewport_chunk_cache;
+
 void SetSelectionRed(bool);
 
 void DeleteWindowViewport(Window *w);
@@ -75,6 +80,9 @@ void RebuildViewportOverlay(Window *w);
 bool ScrollMainWindowToTile(TileIndex tile, bool instant = false);
 bool ScrollMainWindowTo(int x, int y, int z = -1, bool instant = false);
 
+void ClearViewportTileCache();
+void ClearViewportChunkCache();
+
 void UpdateAllVirtCoords();
 void ClearAllCachedNames();
 
@@ -82,6 +90,66 @@ extern Point _tile_fract_coords;
 
 void MarkTileDirtyByTile(TileIndex tile, int bridge_level_offset, int tile_height_override);
 
+/**
+ * While an instance exists, tiles marked dirty only forget their cached drawing;
+ * the bounding box of all of them is marked dirty at once when the instance is destroyed.
+ * This saves marking thousands of single tiles when a large area changes.
+ * @ingroup dirty
+ */
+struct ViewportDirtyBatch {
+	ViewportDirtyBatch();
+	~ViewportDirtyBatch();
+};
+
+/**
+ * Iterator over the tiles of a command that changes a whole area, like clearing or levelling it.
+ * Redraw the changed area in one go instead of tile by tile, as the commands
+ * may change thousands of tiles, some of them many times.
+ * @ingroup dirty
+ */
+class BatchedRedrawTileIterator {
+	ViewportDirtyBatch dirty_batch; ///< Batch of the tiles marked dirty while iterating.
+	std::unique_ptr<TileIterator> iter; ///< The actual iterator over the area.
+
+public:
+	/**
+	 * Create the iterator over the area of a command.
+	 * @param tile The end tile of the area.
+	 * @param start_tile The start tile of the area.
+	 * @param diagonal Whether the area is a diagonal one.
+	 */
+	BatchedRedrawTileIterator(TileIndex tile, TileIndex start_tile, bool diagonal) : iter(TileIterator::Create(tile, start_tile, diagonal)) {}
+
+	/**
+	 * Get the tile we are currently at.
+	 * @return The tile we are at, or INVALID_TILE when we're done.
+	 */
+	inline TileIndex operator *() const
+	{
+		return **this->iter;
+	}
+
+	/**
+	 * Move ourselves to the next tile in the area.
+	 */
+	inline BatchedRedrawTileIterator &operator ++()
+	{
+		++(*this->iter);
+		return *this;
+	}
+};
+
+/**
+ * While an instance exists, areas are marked dirty in copies of the viewports made when it was
+ * created, instead of going through all windows each time; areas no viewport shows are skipped
+ * at once. Only use it while the viewports cannot scroll or zoom, like while the vehicles move.
+ * @ingroup dirty
+ */
+struct ViewportSnapshot {
+	ViewportSnapshot();
+	~ViewportSnapshot();
+};
+
 /**
  * Mark a tile given by its index dirty for repaint.
  * @param tile The tile to mark dirty.
@@ -93,6 +161,8 @@ inline void MarkTileDirtyByTile(TileIndex tile, int bridge_level_offset = 0)
 	MarkTileDirtyByTile(tile, bridge_level_offset, TileHeight(tile));
 }
 
+Point GetStationVirtualMiddle(const Station *st);
+Point VirtualToViewportPoint(const Viewport *vp, Point pt);
 Point GetViewportStationMiddle(const Viewport *vp, const Station *st);
 
 struct Station;
@@ -45,6 +45,9 @@ typedef bool (*VpSorterChecker)();
 /** Type for the actual viewport sprite sorter. */
 typedef void (*VpSpriteSorter)(ParentSpriteToSortVector *psd);
 
+void ViewportSortParentSprites(ParentSpriteToSortVector *psdv);
+void ViewportSortParentSpritesBucket(ParentSpriteToSortVector *psdv);
+
 #ifdef WITH_SSE
 bool ViewportSortParentSpritesSSE41Checker();
 void ViewportSortParentSpritesSSE41(ParentSpriteToSortVector *psdv);
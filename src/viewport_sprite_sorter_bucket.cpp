@@ -0,0 +1,168 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file viewport_sprite_sorter_bucket.cpp Sprite sorter that only compares sprites from nearby buckets. */
+
+#include "stdafx.h"
+#include "viewport_sprite_sorter.h"
+#include <stack>
+
+#include "safeguards.h"
+
+/** Shift of the world X coordinate to get its bucket; at least a tile wide. */
+static const uint MIN_BUCKET_SHIFT = 4;
+
+/**
+ * Sort parent sprites pointer array exactly like #ViewportSortParentSprites does.
+ *
+ * That sorter goes through all unsorted sprites with a smaller xmin + ymin for
+ * every sprite, which for wide zoomed out viewports is a whole diagonal row of
+ * the screen. Only sprites with xmin <= s->xmax and ymin <= s->ymax may precede
+ * a sprite s, and as sprites are mostly sorted in the order of xmin + ymin the
+ * unsorted ones of those are near s. So the sprites are bucketed by xmin, and
+ * only the buckets between the smallest unsorted xmin + ymin minus s->ymax and
+ * s->xmax are searched. The sprites that precede each sprite are the same, so
+ * the result is identical.
+ * @param psdv The sprites to sort.
+ */
+void ViewportSortParentSpritesBucket(ParentSpriteToSortVector *psdv)
+{
+	if (psdv->size() < 2) return;
+
+	const uint32_t ORDER_COMPARED = UINT32_MAX; // Sprite was compared but we still need to compare the ones preceding it
+	const uint32_t ORDER_RETURNED = UINT32_MAX - 1; // Mark sorted sprite in case there are other occurrences of it in the stack; sprites with an order below this are unsorted
+	std::stack<ParentSpriteToDraw *> sprite_order;
+	uint32_t next_order = 0;
+
+	/* Initialize order and find the range of xmin. */
+	int64_t min_x = INT64_MAX;
+	int64_t max_x = INT64_MIN;
+	for (auto p = psdv->rbegin(); p != psdv->rend(); p++) {
+		sprite_order.push(*p);
+		(*p)->order = next_order++;
+		min_x = std::min<int64_t>(min_x, (*p)->xmin);
+		max_x = std::max<int64_t>(max_x, (*p)->xmin);
+	}
+
+	/* Make the buckets a tile or wider, and not more of them than sprites. */
+	uint shift = MIN_BUCKET_SHIFT;
+	while (((max_x - min_x) >> shift) >= (int64_t)psdv->size()) shift++;
+	size_t num_buckets = (size_t)((max_x - min_x) >> shift) + 1;
+	auto bucket_of = [min_x, shift](int64_t x) { return (x - min_x) >> shift; };
+
+	/* All sprites sorted by bucket and then by xmin + ymin. */
+	std::vector<std::pair<int64_t, ParentSpriteToDraw *>> sprite_list;
+	sprite_list.reserve(psdv->size());
+	for (ParentSpriteToDraw *p : *psdv) sprite_list.emplace_back((int64_t)p->xmin + p->ymin, p);
+	std::sort(sprite_list.begin(), sprite_list.end(), [&bucket_of](const auto &a, const auto &b) {
+		int64_t bucket_a = bucket_of(a.second->xmin);
+		int64_t bucket_b = bucket_of(b.second->xmin);
+		if (bucket_a != bucket_b) return bucket_a < bucket_b;
+		return a.first < b.first;
+	});
+
+	/* First sprite of every bucket that is not known to be sorted, and the end of every bucket. */
+	std::vector<size_t> bucket_first(num_buckets, sprite_list.size());
+	std::vector<size_t> bucket_end(num_buckets, 0);
+	for (size_t i = sprite_list.size(); i-- > 0;) {
+		size_t bucket = (size_t)bucket_of(sprite_list[i].second->xmin);
+		bucket_first[bucket] = i;
+		if (bucket_end[bucket] == 0) bucket_end[bucket] = i + 1;
+	}
+
+	/* All sprites sorted by xmin + ymin, to find the smallest xmin + ymin of the unsorted sprites. */
+	std::vector<std::pair<int64_t, ParentSpriteToDraw *>> sums = sprite_list;
+	std::sort(sums.begin(), sums.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+	size_t first_unsorted = 0;
+
+	std::vector<ParentSpriteToDraw *> preceding;  // Temporarily stores sprites that precede current
+	auto out = psdv->begin();  // Iterator to output sorted sprites
+
+	while (!sprite_order.empty()) {
+
+		auto s = sprite_order.top();
+		sprite_order.pop();
+
+		/* Sprite is already sorted, ignore it. */
+		if (s->order == ORDER_RETURNED) continue;
+
+		/* Sprite was already compared, just need to output it. */
+		if (s->order == ORDER_COMPARED) {
+			*(out++) = s;
+			s->order = ORDER_RETURNED;
+			continue;
+		}
+
+		preceding.clear();
+
+		/* The current sprite is unsorted, so there is at least one. */
+		while (sums[first_unsorted].second->order >= ORDER_RETURNED) first_unsorted++;
+
+		/* p->ymin <= s->ymax and p->xmin + p->ymin >= the smallest unsorted sum, so p->xmin can't be below this. */
+		int64_t low_x = std::max(sums[first_unsorted].first - s->ymax, min_x);
+		int64_t high_x = s->xmax;
+		if (high_x >= low_x) {
+			int64_t last_bucket = std::min<int64_t>(bucket_of(high_x), num_buckets - 1);
+			for (int64_t bucket = bucket_of(low_x); bucket <= last_bucket; bucket++) {
+				size_t &first = bucket_first[bucket];
+				const size_t end = bucket_end[bucket];
+				while (first < end && sprite_list[first].second->order >= ORDER_RETURNED) first++;
+
+				/* p->xmin + p->ymin <= s->xmax + s->ymax, and <= the largest xmin in the bucket + s->ymax. */
+				int64_t max_sum = std::min<int64_t>(high_x, min_x + ((bucket + 1) << shift) - 1) + s->ymax;
+				for (size_t i = first; i < end && sprite_list[i].first <= max_sum; i++) {
+					auto p = sprite_list[i].second;
+					if (p == s || p->order >= ORDER_RETURNED) continue;
+
+					if (s->xmax < p->xmin || s->ymax < p->ymin || s->zmax < p->zmin) continue;
+					if (s->xmin <= p->xmax && // overlap in X?
+							s->ymin <= p->ymax && // overlap in Y?
+							s->zmin <= p->zmax) { // overlap in Z?
+						if (s->xmin + s->xmax + s->ymin + s->ymax + s->zmin + s->zmax <=
+								p->xmin + p->xmax + p->ymin + p->ymax + p->zmin + p->zmax) {
+							continue;
+						}
+					}
+					preceding.push_back(p);
+				}
+			}
+		}
+
+		if (preceding.empty()) {
+			/* No preceding sprites, add current one to the output */
+			*(out++) = s;
+			s->order = ORDER_RETURNED;
+			continue;
+		}
+
+		/* Optimization for the case when we only have 1 sprite to move. */
+		if (preceding.size() == 1) {
+			auto p = preceding[0];
+			/* We can only output the preceding sprite if there can't be any other sprites preceding it. */
+			if (p->xmax <= s->xmax && p->ymax <= s->ymax && p->zmax <= s->zmax) {
+				p->order = ORDER_RETURNED;
+				s->order = ORDER_RETURNED;
+				*(out++) = p;
+				*(out++) = s;
+				continue;
+			}
+		}
+
+		/* Sort all preceding sprites by order and assign new orders in reverse (as original sorter did). */
+		std::sort(preceding.begin(), preceding.end(), [](const ParentSpriteToDraw *a, const ParentSpriteToDraw *b) {
+			return a->order > b->order;
+		});
+
+		s->order = ORDER_COMPARED;
+		sprite_order.push(s);  // Still need to output so push it back for now
+
+		for (auto p: preceding) {
+			p->order = next_order++;
+			sprite_order.push(p);
+		}
+	}
+}
@@ -1111,6 +1111,35 @@ FloodingBehaviour GetFloodingBehaviour(TileIndex tile)
 	}
 }
 
+static std::vector<bool> _flood_interior; ///< For each tile whether all its neighbours were water when it tried to flood them.
+uint _flood_interior_tiles = 0;           ///< Number of tiles marked in #_flood_interior.
+
+/** Forget all tiles that cannot flood, and size the state to the current map. */
+void AllocateFloodInterior()
+{
+	_flood_interior.assign(Map::Size(), false);
+	_flood_interior_tiles = 0;
+}
+
+/**
+ * Forget that the tiles around a tile cannot flood, as the type of the tile changes.
+ * The offsets of #TileLoop_Water are followed backwards, so also neighbours across the map edge are found.
+ * @param tile The changed tile.
+ */
+void ForgetFloodInterior(TileIndex tile)
+{
+	if (_flood_interior[tile.base()]) {
+		_flood_interior[tile.base()] = false;
+		_flood_interior_tiles--;
+	}
+	for (Direction dir = DIR_BEGIN; dir < DIR_END; dir++) {
+		uint src = tile.base() - TileOffsByDir(dir);
+		if (src >= Map::Size() || !_flood_interior[src]) continue;
+		_flood_interior[src] = false;
+		_flood_interior_tiles--;
+	}
+}
+
 /**
  * Floods a tile.
  */
@@ -1118,6 +1147,9 @@ void DoFloodTile(TileIndex target)
 {
 	assert(!IsTileType(target, MP_WATER));
 
+	/* Flooding may change a tile without changing its type; make sure the tile loop visits it again. */
+	WakeTileLoopRegions(target);
+
 	bool flooded = false; // Will be set to true if something is changed.
 
 	Backup<CompanyID> cur_company(_current_company, OWNER_WATER);
@@ -1233,12 +1265,17 @@ void TileLoop_Water(TileIndex tile)
 	if (IsTileType(tile, MP_WATER)) AmbientSoundEffect(tile);
 
 	switch (GetFloodingBehaviour(tile)) {
-		case FLOOD_ACTIVE:
+		case FLOOD_ACTIVE: {
+			/* Most sea tiles only have water around them; skip those until a neighbour changes. */
+			if (_flood_interior[tile.base()]) break;
+
+			bool interior = true;
 			for (Direction dir = DIR_BEGIN; dir < DIR_END; dir++) {
 				TileIndex dest = tile + TileOffsByDir(dir);
 				if (!IsValidTile(dest)) continue;
 				/* do not try to flood water tiles - increases performance a lot */
 				if (IsTileType(dest, MP_WATER)) continue;
+				interior = false;
 
 				/* TREE_GROUND_SHORE is the sign of a previous flood. */
 				if (IsTileType(dest, MP_TREES) && GetTreeGround(dest) == TREE_GROUND_SHORE) continue;
@@ -1250,7 +1287,12 @@ void TileLoop_Water(TileIndex tile)
 
 				DoFloodTile(dest);
 			}
+			if (interior) {
+				_flood_interior[tile.base()] = true;
+				_flood_interior_tiles++;
+			}
 			break;
+		}
 
 		case FLOOD_DRYUP: {
 			Slope slope_here = std::get<0>(GetFoundationSlope(tile)) & ~SLOPE_HALFTILE_MASK & ~SLOPE_STEEP;
@@ -1376,7 +1418,7 @@ static void ChangeTileOwner_Water(TileIndex tile, Owner old_owner, Owner new_own
 	}
 }
 
-static VehicleEnterTileStatus VehicleEnter_Water(Vehicle *, TileIndex, int, int)
+VehicleEnterTileStatus VehicleEnter_Water(Vehicle *, TileIndex, int, int)
 {
 	return VETSB_CONTINUE;
 }
@@ -2461,6 +2461,7 @@ Dimension NWidgetScrollbar::horizontal_dimension = {0, 0};
 	resizebox_dimension.width  = resizebox_dimension.height  = 0;
 	closebox_dimension.width   = closebox_dimension.height   = 0;
 	dropdown_dimension.width   = dropdown_dimension.height   = 0;
+	text_dimension_generation++;
 }
 
 Dimension NWidgetLeaf::shadebox_dimension   = {0, 0};
@@ -2470,6 +2471,7 @@ Dimension NWidgetLeaf::stickybox_dimension  = {0, 0};
 Dimension NWidgetLeaf::resizebox_dimension  = {0, 0};
 Dimension NWidgetLeaf::closebox_dimension   = {0, 0};
 Dimension NWidgetLeaf::dropdown_dimension   = {0, 0};
+uint NWidgetLeaf::text_dimension_generation  = 1;
 
 /**
  * Nested leaf widget.
@@ -2570,6 +2572,31 @@ NWidgetLeaf::NWidgetLeaf(WidgetType tp, Colours colour, WidgetID index, uint32_t
 	}
 }
 
+/**
+ * Get the size of the text of the widget.
+ * Widgets with an index get their string parameters from the window, so their text is measured every time.
+ * The text of other widgets only changes when the string or the font size of the widget changes, or when
+ * all windows are reinitialised because of a change in language, fonts or interface scale, so its size is
+ * remembered for the next time the window is reinitialised.
+ * @param w Window the widget belongs to.
+ * @return Size of the text.
+ */
+Dimension NWidgetLeaf::GetTextDimension(Window *w)
+{
+	if (this->index >= 0) {
+		w->SetStringParameters(this->index);
+		return GetStringBoundingBox(this->widget_data, this->text_size);
+	}
+
+	if (this->text_dimension_valid != NWidgetLeaf::text_dimension_generation || this->text_dimension_string != this->widget_data || this->text_dimension_font != this->text_size) {
+		this->text_dimension = GetStringBoundingBox(this->widget_data, this->text_size);
+		this->text_dimension_string = this->widget_data;
+		this->text_dimension_font = this->text_size;
+		this->text_dimension_valid = NWidgetLeaf::text_dimension_generation;
+	}
+	return this->text_dimension;
+}
+
 void NWidgetLeaf::SetupSmallestSize(Window *w)
 {
 	Dimension padding = {0, 0};
@@ -2688,8 +2715,7 @@ void NWidgetLeaf::SetupSmallestSize(Window *w)
 		case WWT_PUSHTXTBTN:
 		case WWT_TEXTBTN_2: {
 			padding = {WidgetDimensions::scaled.framerect.Horizontal(), WidgetDimensions::scaled.framerect.Vertical()};
-			if (this->index >= 0) w->SetStringParameters(this->index);
-			Dimension d2 = GetStringBoundingBox(this->widget_data, this->text_size);
+			Dimension d2 = this->GetTextDimension(w);
 			d2.width += padding.width;
 			d2.height += padding.height;
 			size = maxdim(size, d2);
@@ -2697,14 +2723,12 @@ void NWidgetLeaf::SetupSmallestSize(Window *w)
 		}
 		case WWT_LABEL:
 		case WWT_TEXT: {
-			if (this->index >= 0) w->SetStringParameters(this->index);
-			size = maxdim(size, GetStringBoundingBox(this->widget_data, this->text_size));
+			size = maxdim(size, this->GetTextDimension(w));
 			break;
 		}
 		case WWT_CAPTION: {
 			padding = {WidgetDimensions::scaled.captiontext.Horizontal(), WidgetDimensions::scaled.captiontext.Vertical()};
-			if (this->index >= 0) w->SetStringParameters(this->index);
-			Dimension d2 = GetStringBoundingBox(this->widget_data, this->text_size);
+			Dimension d2 = this->GetTextDimension(w);
 			d2.width += padding.width;
 			d2.height += padding.height;
 			size = maxdim(size, d2);
@@ -2719,8 +2743,7 @@ void NWidgetLeaf::SetupSmallestSize(Window *w)
 				NWidgetLeaf::dropdown_dimension.height += WidgetDimensions::scaled.vscrollbar.Vertical();
 			}
 			padding = {WidgetDimensions::scaled.dropdowntext.Horizontal() + NWidgetLeaf::dropdown_dimension.width + WidgetDimensions::scaled.fullbevel.Horizontal(), WidgetDimensions::scaled.dropdowntext.Vertical()};
-			if (this->index >= 0) w->SetStringParameters(this->index);
-			Dimension d2 = GetStringBoundingBox(this->widget_data, this->text_size);
+			Dimension d2 = this->GetTextDimension(w);
 			d2.width += padding.width;
 			d2.height = std::max(d2.height + padding.height, NWidgetLeaf::dropdown_dimension.height);
 			size = maxdim(size, d2);
@@ -920,6 +920,14 @@ private:
 	static Dimension debugbox_dimension;  ///< Cached size of a debugbox widget.
 	static Dimension defsizebox_dimension; ///< Cached size of a defsizebox widget.
 	static Dimension stickybox_dimension; ///< Cached size of a stickybox widget.
+	static uint text_dimension_generation; ///< Changed whenever the sizes of texts may change, which invalidates #text_dimension.
+
+	StringID text_dimension_string = INVALID_STRING_ID; ///< String #text_dimension is the size of.
+	FontSize text_dimension_font = FS_END;               ///< Font size #text_dimension was measured with.
+	uint text_dimension_valid = 0;                       ///< Value of #text_dimension_generation when #text_dimension was measured.
+	Dimension text_dimension = {0, 0};                   ///< Cached size of the text of a widget without string parameters.
+
+	Dimension GetTextDimension(Window *w);
 };
 
 /**
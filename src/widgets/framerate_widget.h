@@ -16,12 +16,15 @@ enum FramerateWindowWidgets : WidgetID {
 	WID_FRW_RATE_GAMELOOP,
 	WID_FRW_RATE_DRAWING,
 	WID_FRW_RATE_FACTOR,
+	WID_FRW_SPRITE_CACHE,
 	WID_FRW_INFO_DATA_POINTS,
 	WID_FRW_TIMES_NAMES,
 	WID_FRW_TIMES_CURRENT,
 	WID_FRW_TIMES_AVERAGE,
 	WID_FRW_ALLOCSIZE,
 	WID_FRW_SEL_MEMORY,
+	WID_FRW_SEL_COMPANIES,
+	WID_FRW_COMPANY_TIMES,
 	WID_FRW_SCROLLBAR,
 };
 
@@ -40,6 +40,7 @@ enum ScriptDebugWidgets : WidgetID {
 	WID_SCRD_SETTINGS,             ///< Settings button.
 	WID_SCRD_SCRIPT_GAME,          ///< Game Script button.
 	WID_SCRD_RELOAD_TOGGLE,        ///< Reload button.
+	WID_SCRD_MEMORY,               ///< Memory button.
 	WID_SCRD_LOG_PANEL,            ///< Panel where the log is in.
 	WID_SCRD_VSCROLLBAR,           ///< Vertical scrollbar of the log panel.
 	WID_SCRD_COMPANY_BUTTON_START, ///< Buttons in the VIEW.
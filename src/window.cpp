@@ -10,6 +10,7 @@
 #include "stdafx.h"
 #include "company_func.h"
 #include "gfx_func.h"
+#include "gfx_layout.h"
 #include "console_func.h"
 #include "console_gui.h"
 #include "viewport_func.h"
@@ -34,10 +35,12 @@
 #include "game/game.hpp"
 #include "video/video_driver.hpp"
 #include "framerate_type.h"
+#include "trace.h"
 #include "network/network_func.h"
 #include "news_func.h"
 #include "timer/timer.h"
 #include "timer/timer_window.h"
+#include "spritecache.h"
 
 #include "safeguards.h"
 
@@ -56,6 +59,19 @@ static Window *_last_scroll_window = nullptr; ///< Window of the last scroll eve
 /** List of windows opened at the screen sorted from the front to back. */
 WindowList _z_windows;
 
+/** A command-scope window invalidation waiting for #ProcessPendingWindowInvalidations. */
+struct PendingWindowInvalidation {
+	WindowClass cls;     ///< Window class.
+	WindowNumber number; ///< Window number within the class; ignored when \c all_of_class is set.
+	int data;            ///< The data to invalidate with.
+	bool all_of_class;   ///< Whether to invalidate all windows of the class.
+
+	auto operator<=>(const PendingWindowInvalidation &) const = default;
+};
+
+static std::vector<PendingWindowInvalidation> _pending_window_invalidations; ///< Pending invalidations, in the order they were queued.
+static std::set<PendingWindowInvalidation> _pending_window_invalidations_lookup; ///< The same invalidations, to find duplicates.
+
 /** List of closed windows to delete. */
 /* static */ std::vector<Window *> Window::closed_windows;
 
@@ -843,11 +859,51 @@ static bool MayBeShown(const Window *w)
 	}
 }
 
+/** A part of the screen to repaint; unlike #Rect the right and bottom edges are exclusive. */
+struct PaintArea {
+	int left;   ///< Left edge.
+	int top;    ///< Top edge.
+	int right;  ///< Right edge, exclusive.
+	int bottom; ///< Bottom edge, exclusive.
+};
+
+/**
+ * Merge areas that line up to form a rectangle, so they are painted at once.
+ * @param[in,out] areas The areas, which do not overlap each other.
+ */
+static void MergePaintAreas(std::vector<PaintArea> &areas)
+{
+	bool merged;
+	do {
+		merged = false;
+		for (size_t i = 0; i < areas.size(); i++) {
+			for (size_t j = i + 1; j < areas.size(); j++) {
+				PaintArea &a = areas[i];
+				const PaintArea &b = areas[j];
+				if (a.top == b.top && a.bottom == b.bottom && (a.right == b.left || b.right == a.left)) {
+					a.left = std::min(a.left, b.left);
+					a.right = std::max(a.right, b.right);
+				} else if (a.left == b.left && a.right == b.right && (a.bottom == b.top || b.bottom == a.top)) {
+					a.top = std::min(a.top, b.top);
+					a.bottom = std::max(a.bottom, b.bottom);
+				} else {
+					continue;
+				}
+				areas.erase(areas.begin() + j);
+				merged = true;
+				break;
+			}
+		}
+	} while (merged);
+}
+
 /**
  * Generate repaint events for the visible part of window w within the rectangle.
  *
- * The function goes recursively upwards in the window stack, and splits the rectangle
- * into multiple pieces at the window edges, so obscured parts are not redrawn.
+ * The rectangle is split at the edges of the windows in front of window w,
+ * so obscured parts are not redrawn. The visible parts that line up again
+ * after splitting around several windows are merged, so the window is
+ * repainted as few times as possible.
  *
  * @param w Window that needs to be repainted
  * @param left Left edge of the rectangle that should be repainted
@@ -857,56 +913,50 @@ static bool MayBeShown(const Window *w)
  */
 static void DrawOverlappedWindow(Window *w, int left, int top, int right, int bottom)
 {
+	std::vector<PaintArea> visible = { { left, top, right, bottom } };
+	std::vector<PaintArea> next;
+
 	Window::IteratorToFront it(w);
 	++it;
-	for (; !it.IsEnd(); ++it) {
+	for (; !it.IsEnd() && !visible.empty(); ++it) {
 		const Window *v = *it;
-		if (MayBeShown(v) &&
-				right > v->left &&
-				bottom > v->top &&
-				left < v->left + v->width &&
-				top < v->top + v->height) {
-			/* v and rectangle intersect with each other */
-			int x;
-
-			if (left < (x = v->left)) {
-				DrawOverlappedWindow(w, left, top, x, bottom);
-				DrawOverlappedWindow(w, x, top, right, bottom);
-				return;
-			}
-
-			if (right > (x = v->left + v->width)) {
-				DrawOverlappedWindow(w, left, top, x, bottom);
-				DrawOverlappedWindow(w, x, top, right, bottom);
-				return;
-			}
-
-			if (top < (x = v->top)) {
-				DrawOverlappedWindow(w, left, top, right, x);
-				DrawOverlappedWindow(w, left, x, right, bottom);
-				return;
-			}
-
-			if (bottom > (x = v->top + v->height)) {
-				DrawOverlappedWindow(w, left, top, right, x);
-				DrawOverlappedWindow(w, left, x, right, bottom);
-				return;
+		if (!MayBeShown(v)) continue;
+
+		const int v_right = v->left + v->width;
+		const int v_bottom = v->top + v->height;
+		next.clear();
+		for (const PaintArea &a : visible) {
+			if (a.right <= v->left || a.bottom <= v->top || a.left >= v_right || a.top >= v_bottom) {
+				next.push_back(a);
+				continue;
 			}
 
-			return;
+			/* v and the area intersect with each other; keep the full height left and right of v, and the rest above and below it. */
+			if (a.left < v->left) next.push_back({ a.left, a.top, v->left, a.bottom });
+			if (a.right > v_right) next.push_back({ v_right, a.top, a.right, a.bottom });
+			int middle_left = std::max(a.left, v->left);
+			int middle_right = std::min(a.right, v_right);
+			if (a.top < v->top) next.push_back({ middle_left, a.top, middle_right, v->top });
+			if (a.bottom > v_bottom) next.push_back({ middle_left, v_bottom, middle_right, a.bottom });
 		}
+		std::swap(visible, next);
 	}
 
+	if (visible.size() > 1) MergePaintAreas(visible);
+
 	/* Setup blitter, and dispatch a repaint event to window *wz */
 	DrawPixelInfo *dp = _cur_dpi;
-	dp->width = right - left;
-	dp->height = bottom - top;
-	dp->left = left - w->left;
-	dp->top = top - w->top;
-	dp->pitch = _screen.pitch;
-	dp->dst_ptr = BlitterFactory::GetCurrentBlitter()->MoveTo(_screen.dst_ptr, left, top);
-	dp->zoom = ZOOM_LVL_NORMAL;
-	w->OnPaint();
+	TraceScope trace("Window draw", w->window_class);
+	for (const PaintArea &a : visible) {
+		dp->width = a.right - a.left;
+		dp->height = a.bottom - a.top;
+		dp->left = a.left - w->left;
+		dp->top = a.top - w->top;
+		dp->pitch = _screen.pitch;
+		dp->dst_ptr = BlitterFactory::GetCurrentBlitter()->MoveTo(_screen.dst_ptr, a.left, a.top);
+		dp->zoom = ZOOM_LVL_NORMAL;
+		w->OnPaint();
+	}
 }
 
 /**
@@ -1809,6 +1859,8 @@ void UnInitWindowSystem()
 	for (Window *w : Window::Iterate()) w->Close();
 
 	Window::DeleteClosedWindows();
+	_pending_window_invalidations.clear();
+	_pending_window_invalidations_lookup.clear();
 
 	assert(_z_windows.empty());
 }
@@ -3053,6 +3105,7 @@ void UpdateWindows()
 	CallWindowRealtimeTickEvent(delta_ms.count());
 
 	/* Process invalidations before anything else. */
+	ProcessPendingWindowInvalidations();
 	for (Window *w : Window::Iterate()) {
 		w->ProcessScheduledResize();
 		w->ProcessScheduledInvalidations();
@@ -3063,6 +3116,10 @@ void UpdateWindows()
 	 * But still empty the invalidation queues above. */
 	if (_network_dedicated) return;
 
+	/* Keep the text layouts within their memory budget, also while paused. */
+	Layouter::ReduceLineCache();
+
+	ProcessAsyncSprites();
 	DrawDirtyBlocks();
 
 	for (Window *w : Window::Iterate()) {
@@ -3141,8 +3198,9 @@ void Window::InvalidateData(int data, bool gui_scope)
 {
 	this->SetDirty();
 	if (!gui_scope) {
-		/* Schedule GUI-scope invalidation for next redraw. */
-		this->scheduled_invalidation_data.push_back(data);
+		/* Schedule GUI-scope invalidation for next redraw; GUI-scope calls cannot assume any state, so once per data is enough. */
+		auto &scheduled = this->scheduled_invalidation_data;
+		if (std::find(scheduled.begin(), scheduled.end(), data) == scheduled.end()) scheduled.push_back(data);
 	}
 	this->OnInvalidateData(data, gui_scope);
 }
@@ -3171,6 +3229,40 @@ void Window::ProcessHighlightedInvalidations()
 	}
 }
 
+/**
+ * Queue a command-scope invalidation, unless the same one is queued already.
+ * @param pending The invalidation.
+ */
+static void QueueWindowInvalidation(const PendingWindowInvalidation &pending)
+{
+	if (!_pending_window_invalidations_lookup.insert(pending).second) return;
+	_pending_window_invalidations.push_back(pending);
+}
+
+/**
+ * Invalidate the windows for all queued command-scope invalidations.
+ * This is done at the end of every command and game loop, and before any
+ * window gets its game tick, input or redraw, so windows never act on
+ * data that is out of date with the invalidations.
+ */
+void ProcessPendingWindowInvalidations()
+{
+	/* Invalidating might queue more invalidations, those are processed in the next round. */
+	while (!_pending_window_invalidations.empty()) {
+		std::vector<PendingWindowInvalidation> pending;
+		pending.swap(_pending_window_invalidations);
+		_pending_window_invalidations_lookup.clear();
+
+		for (const PendingWindowInvalidation &p : pending) {
+			for (Window *w : Window::Iterate()) {
+				if (w->window_class == p.cls && (p.all_of_class || w->window_number == p.number)) {
+					w->InvalidateData(p.data, false);
+				}
+			}
+		}
+	}
+}
+
 /**
  * Mark window data of the window of a given class and specific window number as invalid (in need of re-computing)
  *
@@ -3189,6 +3281,10 @@ void Window::ProcessHighlightedInvalidations()
  * scope. While GUI-scope calls have no restrictions on what they may do, they cannot assume the game to still be in the state
  * when the invalidation was scheduled; passed IDs may have got invalid in the mean time.
  *
+ * The command-scope part is queued too, with duplicate invalidations dropped, and done at the end of the command or game loop
+ * by #ProcessPendingWindowInvalidations. So it may not assume the game state either; invalidations whose data describes a
+ * differential change, or that must take effect before the game continues, use #InvalidateWindowDataImmediately instead.
+ *
  * Finally, note that invalidations triggered from commands or the game loop result in OnInvalidateData() being called twice.
  * Once in command-scope, once in GUI-scope. So make sure to not process differential-changes twice.
  *
@@ -3199,6 +3295,11 @@ void Window::ProcessHighlightedInvalidations()
  */
 void InvalidateWindowData(WindowClass cls, WindowNumber number, int data, bool gui_scope)
 {
+	if (!gui_scope) {
+		QueueWindowInvalidation({ cls, number, data, false });
+		return;
+	}
+
 	for (Window *w : Window::Iterate()) {
 		if (w->window_class == cls && w->window_number == number) {
 			w->InvalidateData(data, gui_scope);
@@ -3216,6 +3317,11 @@ void InvalidateWindowData(WindowClass cls, WindowNumber number, int data, bool g
  */
 void InvalidateWindowClassesData(WindowClass cls, int data, bool gui_scope)
 {
+	if (!gui_scope) {
+		QueueWindowInvalidation({ cls, 0, data, true });
+		return;
+	}
+
 	for (Window *w : Window::Iterate()) {
 		if (w->window_class == cls) {
 			w->InvalidateData(data, gui_scope);
@@ -3223,11 +3329,46 @@ void InvalidateWindowClassesData(WindowClass cls, int data, bool gui_scope)
 	}
 }
 
+/**
+ * Mark window data of the window of a given class and specific window number as invalid, doing the command-scope
+ * part right away instead of queueing it. For data that describes a differential change, which is only valid in the
+ * state it was made in, or changes that the window must act upon before the game continues.
+ * See InvalidateWindowData() for details on GUI-scope vs. command-scope.
+ * @param cls Window class
+ * @param number Window number within the class
+ * @param data The data to invalidate with
+ */
+void InvalidateWindowDataImmediately(WindowClass cls, WindowNumber number, int data)
+{
+	for (Window *w : Window::Iterate()) {
+		if (w->window_class == cls && w->window_number == number) {
+			w->InvalidateData(data, false);
+		}
+	}
+}
+
+/**
+ * Mark window data of all windows of a given class as invalid, doing the command-scope part right away.
+ * See InvalidateWindowDataImmediately() for when to use this.
+ * @param cls Window class
+ * @param data The data to invalidate with
+ */
+void InvalidateWindowClassesDataImmediately(WindowClass cls, int data)
+{
+	for (Window *w : Window::Iterate()) {
+		if (w->window_class == cls) {
+			w->InvalidateData(data, false);
+		}
+	}
+}
+
 /**
  * Dispatch OnGameTick event over all windows
  */
 void CallWindowGameTickEvent()
 {
+	ProcessPendingWindowInvalidations();
+
 	for (Window *w : Window::Iterate()) {
 		w->OnGameTick();
 	}
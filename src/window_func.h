@@ -43,6 +43,9 @@ void InputLoop();
 
 void InvalidateWindowData(WindowClass cls, WindowNumber number, int data = 0, bool gui_scope = false);
 void InvalidateWindowClassesData(WindowClass cls, int data = 0, bool gui_scope = false);
+void InvalidateWindowDataImmediately(WindowClass cls, WindowNumber number, int data = 0);
+void InvalidateWindowClassesDataImmediately(WindowClass cls, int data = 0);
+void ProcessPendingWindowInvalidations();
 
 template<typename T, std::enable_if_t<std::is_base_of<StrongTypedefBase, T>::value, int> = 0>
 void InvalidateWindowData(WindowClass cls, T number, int data = 0, bool gui_scope = false)